@@ -0,0 +1,5 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#include "ocSkeleton.cpp"
+#include "ocAnimationClip.cpp"
+#include "ocAnimationWorld.cpp"
\ No newline at end of file
@@ -0,0 +1,5 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#include "ocSkeleton.hpp"
+#include "ocAnimationClip.hpp"
+#include "ocAnimationWorld.hpp"
\ No newline at end of file
@@ -0,0 +1,431 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Maps a set of tracks. ANM1 files store the bone indices, ranges and keys of each set in separate blocks. Rotations don't have ranges.
+OC_PRIVATE ocBool32 ocAnimationClipMapTrackSet(ocUInt8* pPayload, ocUInt64 payloadSize, ocUInt32 trackCount, ocUInt32 boneCount, ocUInt32 frameCount, ocUInt32 componentCount, ocUInt64 bonesOffset, ocUInt64 rangesOffset, ocUInt64 keysOffset, ocAnimationTrackSet* pTracks)
+{
+    ocAssert(pPayload != NULL);
+    ocAssert(pTracks != NULL);
+
+    pTracks->trackCount       = trackCount;
+    pTracks->paddedTrackCount = ocAlign(trackCount, OC_ANIMATION_LANE_COUNT);
+
+    if (trackCount > boneCount) {
+        return OC_FALSE;
+    }
+
+    ocBool32 hasRanges = componentCount == 3;
+    if (!ocAnimationIsBlockInPayload(bonesOffset, sizeof(ocUInt32) * trackCount, payloadSize) ||
+        !ocAnimationIsBlockInPayload(keysOffset,  sizeof(ocUInt16) * pTracks->paddedTrackCount * componentCount * frameCount, payloadSize) ||
+        (hasRanges && !ocAnimationIsBlockInPayload(rangesOffset, sizeof(float) * pTracks->paddedTrackCount * 6, payloadSize))) {
+        return OC_FALSE;
+    }
+
+    pTracks->pBoneIndices = (const ocUInt32*)(pPayload + bonesOffset);
+    pTracks->pRanges      = (hasRanges) ? (const float*)(pPayload + rangesOffset) : NULL;
+    pTracks->pKeys        = pPayload + keysOffset;
+
+    // Tracks are scattered into the pose by their bone index.
+    for (ocUInt32 iTrack = 0; iTrack < trackCount; ++iTrack) {
+        if (pTracks->pBoneIndices[iTrack] >= boneCount) {
+            return OC_FALSE;
+        }
+    }
+
+    return OC_TRUE;
+}
+
+ocResult ocAnimationClipInit(void* pOCDData, ocSizeT ocdDataSize, ocAnimationClip* pClip)
+{
+    if (pClip == NULL) {
+        ocFree(pOCDData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pClip);
+
+    if (pOCDData == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    // The ANM1 header is 104 bytes.
+    ocUInt8* pPayload = (ocUInt8*)pOCDData;
+    if (ocdDataSize < OC_OCD_HEADER_SIZE + 104 || ((ocUInt32*)pPayload)[0] != OC_OCD_FOURCC || ((ocUInt32*)pPayload)[1] != OC_OCD_TYPE_ID_ANIMATION) {
+        ocFree(pOCDData);
+        return OC_CORRUPT_FILE;
+    }
+
+    ocUInt32 boneCount          = *(ocUInt32*)(pPayload + OC_OCD_HEADER_SIZE + 0);
+    ocUInt32 frameCount         = *(ocUInt32*)(pPayload + OC_OCD_HEADER_SIZE + 4);
+    float    sampleRate         = *(float*   )(pPayload + OC_OCD_HEADER_SIZE + 8);
+    ocUInt32 rotationTrackCount = *(ocUInt32*)(pPayload + OC_OCD_HEADER_SIZE + 12);
+    ocUInt32 positionTrackCount = *(ocUInt32*)(pPayload + OC_OCD_HEADER_SIZE + 16);
+    ocUInt32 scaleTrackCount    = *(ocUInt32*)(pPayload + OC_OCD_HEADER_SIZE + 20);
+    ocUInt64 constantPoseOffset = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 24);
+    ocUInt64 rotationBones      = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 32);
+    ocUInt64 rotationKeys       = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 40);
+    ocUInt64 positionBones      = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 48);
+    ocUInt64 positionRanges     = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 56);
+    ocUInt64 positionKeys       = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 64);
+    ocUInt64 scaleBones         = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 72);
+    ocUInt64 scaleRanges        = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 80);
+    ocUInt64 scaleKeys          = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 88);
+    ocUInt32 paddedBoneCount    = ocAlign(boneCount, OC_ANIMATION_LANE_COUNT);
+
+    ocBool32 isValid =
+        boneCount > 0 && boneCount <= OC_SKELETON_MAX_BONES && frameCount > 0 && sampleRate > 0 &&
+        ocAnimationIsBlockInPayload(constantPoseOffset, sizeof(float) * paddedBoneCount * 10, ocdDataSize) &&
+        ocAnimationClipMapTrackSet(pPayload, ocdDataSize, rotationTrackCount, boneCount, frameCount, 4, rotationBones, 0,              rotationKeys, &pClip->rotations) &&
+        ocAnimationClipMapTrackSet(pPayload, ocdDataSize, positionTrackCount, boneCount, frameCount, 3, positionBones, positionRanges, positionKeys, &pClip->positions) &&
+        ocAnimationClipMapTrackSet(pPayload, ocdDataSize, scaleTrackCount,    boneCount, frameCount, 3, scaleBones,    scaleRanges,    scaleKeys,    &pClip->scales);
+    if (!isValid) {
+        ocFree(pOCDData);
+        ocZeroObject(pClip);
+        return OC_CORRUPT_FILE;
+    }
+
+    pClip->boneCount       = boneCount;
+    pClip->paddedBoneCount = paddedBoneCount;
+    pClip->frameCount      = frameCount;
+    pClip->sampleRate      = sampleRate;
+    pClip->duration        = (frameCount - 1) / sampleRate;
+    pClip->constantPose    = ocAnimationMapTransformArray((float*)(pPayload + constantPoseOffset), paddedBoneCount);
+    pClip->pPayload        = pPayload;
+    pClip->payloadSize     = ocdDataSize;
+
+    return OC_SUCCESS;
+}
+
+void ocAnimationClipUninit(ocAnimationClip* pClip)
+{
+    if (pClip == NULL) {
+        return;
+    }
+
+    ocFree(pClip->pPayload);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Sampling
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Keys are decoded and interpolated 4 or 8 tracks at a time into a temporary array for each component, and are then scattered into the
+// pose by their bone index. The scalar path does the same operations in the same order as the SIMD paths so that every path gives the
+// same results. It's also used for the remainder, although the track arrays are padded so there normally isn't one.
+
+#define OC_ANIMATION_ROTATION_KEY_SCALE  (1.0f / 32767)
+
+//// Rotation Keys ////
+
+OC_PRIVATE void ocAnimationDecodeRotationKeys_Scalar(const ocInt16* pKeys0, const ocInt16* pKeys1, float alpha, ocUInt32 iBegin, ocUInt32 iEnd, float* pOut)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        float a = (float)pKeys0[i] * OC_ANIMATION_ROTATION_KEY_SCALE;
+        float b = (float)pKeys1[i] * OC_ANIMATION_ROTATION_KEY_SCALE;
+        pOut[i] = a + (b - a)*alpha;
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE void ocAnimationDecodeRotationKeys_SSE2(const ocInt16* pKeys0, const ocInt16* pKeys1, float alpha, ocUInt32 count, float* pOut)
+{
+    const __m128 scale  = _mm_set1_ps(OC_ANIMATION_ROTATION_KEY_SCALE);
+    const __m128 alpha4 = _mm_set1_ps(alpha);
+
+    ocUInt32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // Sign extended by unpacking each key into the top half of a 32-bit lane and shifting it back down.
+        __m128i q0 = _mm_loadl_epi64((const __m128i*)(pKeys0 + i));
+        __m128i q1 = _mm_loadl_epi64((const __m128i*)(pKeys1 + i));
+        __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(q0, q0), 16)), scale);
+        __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(q1, q1), 16)), scale);
+        _mm_storeu_ps(pOut + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), alpha4)));
+    }
+
+    ocAnimationDecodeRotationKeys_Scalar(pKeys0, pKeys1, alpha, i, count, pOut);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE void ocAnimationDecodeRotationKeys_AVX2(const ocInt16* pKeys0, const ocInt16* pKeys1, float alpha, ocUInt32 count, float* pOut)
+{
+    const __m256 scale  = _mm256_set1_ps(OC_ANIMATION_ROTATION_KEY_SCALE);
+    const __m256 alpha8 = _mm256_set1_ps(alpha);
+
+    ocUInt32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(pKeys0 + i)))), scale);
+        __m256 b = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(pKeys1 + i)))), scale);
+        _mm256_storeu_ps(pOut + i, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), alpha8)));
+    }
+
+    ocAnimationDecodeRotationKeys_Scalar(pKeys0, pKeys1, alpha, i, count, pOut);
+}
+#endif
+
+OC_PRIVATE void ocAnimationDecodeRotationKeys(const ocInt16* pKeys0, const ocInt16* pKeys1, float alpha, ocUInt32 count, float* pOut)
+{
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocAnimationDecodeRotationKeys_AVX2(pKeys0, pKeys1, alpha, count, pOut);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocAnimationDecodeRotationKeys_SSE2(pKeys0, pKeys1, alpha, count, pOut);
+        return;
+    }
+#endif
+
+    ocAnimationDecodeRotationKeys_Scalar(pKeys0, pKeys1, alpha, 0, count, pOut);
+}
+
+
+//// Position and Scale Keys ////
+
+OC_PRIVATE void ocAnimationDecodeRangeKeys_Scalar(const ocUInt16* pKeys0, const ocUInt16* pKeys1, const float* pMin, const float* pStep, float alpha, ocUInt32 iBegin, ocUInt32 iEnd, float* pOut)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        float a = pMin[i] + (float)pKeys0[i] * pStep[i];
+        float b = pMin[i] + (float)pKeys1[i] * pStep[i];
+        pOut[i] = a + (b - a)*alpha;
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE void ocAnimationDecodeRangeKeys_SSE2(const ocUInt16* pKeys0, const ocUInt16* pKeys1, const float* pMin, const float* pStep, float alpha, ocUInt32 count, float* pOut)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128 alpha4 = _mm_set1_ps(alpha);
+
+    ocUInt32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 min  = _mm_loadu_ps(pMin  + i);
+        __m128 step = _mm_loadu_ps(pStep + i);
+        __m128 a = _mm_add_ps(min, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(pKeys0 + i)), zero)), step));
+        __m128 b = _mm_add_ps(min, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(pKeys1 + i)), zero)), step));
+        _mm_storeu_ps(pOut + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), alpha4)));
+    }
+
+    ocAnimationDecodeRangeKeys_Scalar(pKeys0, pKeys1, pMin, pStep, alpha, i, count, pOut);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE void ocAnimationDecodeRangeKeys_AVX2(const ocUInt16* pKeys0, const ocUInt16* pKeys1, const float* pMin, const float* pStep, float alpha, ocUInt32 count, float* pOut)
+{
+    const __m256 alpha8 = _mm256_set1_ps(alpha);
+
+    ocUInt32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 min  = _mm256_loadu_ps(pMin  + i);
+        __m256 step = _mm256_loadu_ps(pStep + i);
+        __m256 a = _mm256_add_ps(min, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(pKeys0 + i)))), step));
+        __m256 b = _mm256_add_ps(min, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(pKeys1 + i)))), step));
+        _mm256_storeu_ps(pOut + i, _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), alpha8)));
+    }
+
+    ocAnimationDecodeRangeKeys_Scalar(pKeys0, pKeys1, pMin, pStep, alpha, i, count, pOut);
+}
+#endif
+
+OC_PRIVATE void ocAnimationDecodeRangeKeys(const ocUInt16* pKeys0, const ocUInt16* pKeys1, const float* pMin, const float* pStep, float alpha, ocUInt32 count, float* pOut)
+{
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocAnimationDecodeRangeKeys_AVX2(pKeys0, pKeys1, pMin, pStep, alpha, count, pOut);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocAnimationDecodeRangeKeys_SSE2(pKeys0, pKeys1, pMin, pStep, alpha, count, pOut);
+        return;
+    }
+#endif
+
+    ocAnimationDecodeRangeKeys_Scalar(pKeys0, pKeys1, pMin, pStep, alpha, 0, count, pOut);
+}
+
+
+//// Quaternion Normalization ////
+
+// Interpolated and blended rotations need to be normalized. This is also used by the animation world after blending layers.
+
+OC_PRIVATE void ocAnimationNormalizeQuats_Scalar(ocQuatArray* pQuats, ocUInt32 iBegin, ocUInt32 iEnd)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        float x = pQuats->pX[i];
+        float y = pQuats->pY[i];
+        float z = pQuats->pZ[i];
+        float w = pQuats->pW[i];
+        float invLength = 1.0f / sqrtf(x*x + y*y + z*z + w*w);
+        pQuats->pX[i] = x * invLength;
+        pQuats->pY[i] = y * invLength;
+        pQuats->pZ[i] = z * invLength;
+        pQuats->pW[i] = w * invLength;
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE void ocAnimationNormalizeQuats_SSE2(ocQuatArray* pQuats, ocUInt32 count)
+{
+    const __m128 one = _mm_set1_ps(1);
+
+    ocUInt32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(pQuats->pX + i);
+        __m128 y = _mm_loadu_ps(pQuats->pY + i);
+        __m128 z = _mm_loadu_ps(pQuats->pZ + i);
+        __m128 w = _mm_loadu_ps(pQuats->pW + i);
+        __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)), _mm_mul_ps(w, w));
+        __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+        _mm_storeu_ps(pQuats->pX + i, _mm_mul_ps(x, invLength));
+        _mm_storeu_ps(pQuats->pY + i, _mm_mul_ps(y, invLength));
+        _mm_storeu_ps(pQuats->pZ + i, _mm_mul_ps(z, invLength));
+        _mm_storeu_ps(pQuats->pW + i, _mm_mul_ps(w, invLength));
+    }
+
+    ocAnimationNormalizeQuats_Scalar(pQuats, i, count);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE void ocAnimationNormalizeQuats_AVX2(ocQuatArray* pQuats, ocUInt32 count)
+{
+    const __m256 one = _mm256_set1_ps(1);
+
+    ocUInt32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(pQuats->pX + i);
+        __m256 y = _mm256_loadu_ps(pQuats->pY + i);
+        __m256 z = _mm256_loadu_ps(pQuats->pZ + i);
+        __m256 w = _mm256_loadu_ps(pQuats->pW + i);
+        __m256 lengthSquared = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)), _mm256_mul_ps(w, w));
+        __m256 invLength = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared));
+        _mm256_storeu_ps(pQuats->pX + i, _mm256_mul_ps(x, invLength));
+        _mm256_storeu_ps(pQuats->pY + i, _mm256_mul_ps(y, invLength));
+        _mm256_storeu_ps(pQuats->pZ + i, _mm256_mul_ps(z, invLength));
+        _mm256_storeu_ps(pQuats->pW + i, _mm256_mul_ps(w, invLength));
+    }
+
+    ocAnimationNormalizeQuats_Scalar(pQuats, i, count);
+}
+#endif
+
+OC_PRIVATE void ocAnimationNormalizeQuats(ocQuatArray* pQuats, ocUInt32 count)
+{
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocAnimationNormalizeQuats_AVX2(pQuats, count);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocAnimationNormalizeQuats_SSE2(pQuats, count);
+        return;
+    }
+#endif
+
+    ocAnimationNormalizeQuats_Scalar(pQuats, 0, count);
+}
+
+
+OC_PRIVATE void ocAnimationCopyTransformArray(const ocTransformArray* pSrc, ocUInt32 count, ocTransformArray* pDst)
+{
+    ocCopyMemory(pDst->position.pX, pSrc->position.pX, sizeof(float) * count);
+    ocCopyMemory(pDst->position.pY, pSrc->position.pY, sizeof(float) * count);
+    ocCopyMemory(pDst->position.pZ, pSrc->position.pZ, sizeof(float) * count);
+    ocCopyMemory(pDst->rotation.pX, pSrc->rotation.pX, sizeof(float) * count);
+    ocCopyMemory(pDst->rotation.pY, pSrc->rotation.pY, sizeof(float) * count);
+    ocCopyMemory(pDst->rotation.pZ, pSrc->rotation.pZ, sizeof(float) * count);
+    ocCopyMemory(pDst->rotation.pW, pSrc->rotation.pW, sizeof(float) * count);
+    ocCopyMemory(pDst->scale.pX,    pSrc->scale.pX,    sizeof(float) * count);
+    ocCopyMemory(pDst->scale.pY,    pSrc->scale.pY,    sizeof(float) * count);
+    ocCopyMemory(pDst->scale.pZ,    pSrc->scale.pZ,    sizeof(float) * count);
+}
+
+// Decodes a frame of a set of position or scale tracks and scatters them into the pose.
+OC_PRIVATE void ocAnimationClipSampleRangeTracks(const ocAnimationTrackSet* pTracks, ocUInt32 frame0, ocUInt32 frame1, float alpha, ocVec3Array* pPose, float* pScratch)
+{
+    ocUInt32 paddedTrackCount = pTracks->paddedTrackCount;
+    const ocUInt16* pKeys0 = (const ocUInt16*)pTracks->pKeys + (frame0 * 3 * paddedTrackCount);
+    const ocUInt16* pKeys1 = (const ocUInt16*)pTracks->pKeys + (frame1 * 3 * paddedTrackCount);
+
+    float* pX = pScratch + paddedTrackCount*0;
+    float* pY = pScratch + paddedTrackCount*1;
+    float* pZ = pScratch + paddedTrackCount*2;
+    ocAnimationDecodeRangeKeys(pKeys0 + paddedTrackCount*0, pKeys1 + paddedTrackCount*0, pTracks->pRanges + paddedTrackCount*0, pTracks->pRanges + paddedTrackCount*3, alpha, paddedTrackCount, pX);
+    ocAnimationDecodeRangeKeys(pKeys0 + paddedTrackCount*1, pKeys1 + paddedTrackCount*1, pTracks->pRanges + paddedTrackCount*1, pTracks->pRanges + paddedTrackCount*4, alpha, paddedTrackCount, pY);
+    ocAnimationDecodeRangeKeys(pKeys0 + paddedTrackCount*2, pKeys1 + paddedTrackCount*2, pTracks->pRanges + paddedTrackCount*2, pTracks->pRanges + paddedTrackCount*5, alpha, paddedTrackCount, pZ);
+
+    for (ocUInt32 iTrack = 0; iTrack < pTracks->trackCount; ++iTrack) {
+        ocUInt32 iBone = pTracks->pBoneIndices[iTrack];
+        pPose->pX[iBone] = pX[iTrack];
+        pPose->pY[iBone] = pY[iTrack];
+        pPose->pZ[iBone] = pZ[iTrack];
+    }
+}
+
+void ocAnimationClipSample(const ocAnimationClip* pClip, float time, ocTransformArray* pPose, float* pScratch)
+{
+    ocAssert(pClip != NULL);
+    ocAssert(pPose != NULL);
+    ocAssert(pScratch != NULL);
+
+    ocAnimationCopyTransformArray(&pClip->constantPose, pClip->paddedBoneCount, pPose);
+
+    // The two frames either side of the time. The last frame is held.
+    float frame = ocClamp(time, 0.0f, pClip->duration) * pClip->sampleRate;
+    ocUInt32 frame0 = (ocUInt32)frame;
+    ocUInt32 frame1;
+    float alpha;
+    if (frame0 + 1 >= pClip->frameCount) {
+        frame0 = pClip->frameCount - 1;
+        frame1 = frame0;
+        alpha  = 0;
+    } else {
+        frame1 = frame0 + 1;
+        alpha  = frame - (float)frame0;
+    }
+
+    // Rotations. Keys are interpolated linearly and then normalized, which is close enough to a slerp for keys that are a frame apart.
+    // The builder makes sure neighbouring keys are in the same hemisphere.
+    const ocAnimationTrackSet* pRotations = &pClip->rotations;
+    if (pRotations->trackCount > 0) {
+        ocUInt32 paddedTrackCount = pRotations->paddedTrackCount;
+        const ocInt16* pKeys0 = (const ocInt16*)pRotations->pKeys + (frame0 * 4 * paddedTrackCount);
+        const ocInt16* pKeys1 = (const ocInt16*)pRotations->pKeys + (frame1 * 4 * paddedTrackCount);
+
+        ocQuatArray rotations;
+        rotations.pX = pScratch + paddedTrackCount*0;
+        rotations.pY = pScratch + paddedTrackCount*1;
+        rotations.pZ = pScratch + paddedTrackCount*2;
+        rotations.pW = pScratch + paddedTrackCount*3;
+        ocAnimationDecodeRotationKeys(pKeys0 + paddedTrackCount*0, pKeys1 + paddedTrackCount*0, alpha, paddedTrackCount, rotations.pX);
+        ocAnimationDecodeRotationKeys(pKeys0 + paddedTrackCount*1, pKeys1 + paddedTrackCount*1, alpha, paddedTrackCount, rotations.pY);
+        ocAnimationDecodeRotationKeys(pKeys0 + paddedTrackCount*2, pKeys1 + paddedTrackCount*2, alpha, paddedTrackCount, rotations.pZ);
+        ocAnimationDecodeRotationKeys(pKeys0 + paddedTrackCount*3, pKeys1 + paddedTrackCount*3, alpha, paddedTrackCount, rotations.pW);
+        ocAnimationNormalizeQuats(&rotations, paddedTrackCount);
+
+        for (ocUInt32 iTrack = 0; iTrack < pRotations->trackCount; ++iTrack) {
+            ocUInt32 iBone = pRotations->pBoneIndices[iTrack];
+            pPose->rotation.pX[iBone] = rotations.pX[iTrack];
+            pPose->rotation.pY[iBone] = rotations.pY[iTrack];
+            pPose->rotation.pZ[iBone] = rotations.pZ[iTrack];
+            pPose->rotation.pW[iBone] = rotations.pW[iTrack];
+        }
+    }
+
+    if (pClip->positions.trackCount > 0) {
+        ocAnimationClipSampleRangeTracks(&pClip->positions, frame0, frame1, alpha, &pPose->position, pScratch);
+    }
+    if (pClip->scales.trackCount > 0) {
+        ocAnimationClipSampleRangeTracks(&pClip->scales, frame0, frame1, alpha, &pPose->scale, pScratch);
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Animation clips are sampled at a fixed rate. Each channel of each bone (position, rotation or scale) is either constant, in which case
+// it's stored once in constantPose, or it's a track with a key for every frame. Most channels of most clips are constant so this is where
+// the bulk of the compression comes from.
+//
+// Keys are quantized to 16 bits per component. Rotations are stored as signed, normalized quaternions. Positions and scales are stored
+// as unsigned offsets from the minimum of their track in steps of (max - min) / 65535. Keys are stored frame by frame, with each
+// component of every track in it's own array so that a frame of 4 or 8 tracks can be decoded and interpolated with SIMD. The track
+// arrays are padded to a multiple of OC_ANIMATION_LANE_COUNT.
+
+// The tracks of one type of channel. Each frame has paddedTrackCount keys for each component, one component after the other.
+struct ocAnimationTrackSet
+{
+    ocUInt32 trackCount;
+    ocUInt32 paddedTrackCount;      // <-- trackCount rounded up to a multiple of OC_ANIMATION_LANE_COUNT.
+    const ocUInt32* pBoneIndices;   // <-- The bone of each track. Only trackCount long.
+    const float* pRanges;           // <-- Positions and scales only. The minimum of X, Y and Z and then the step of X, Y and Z, each paddedTrackCount long.
+    const void* pKeys;              // <-- ocInt16 for rotations, ocUInt16 for positions and scales.
+};
+
+// NOTES:
+// - A clip is loaded from an ANM1 file, which is mapped in place. See ocOCDAnimationBuilder.
+// - A clip can only be played on skeletons with the same number of bones.
+struct ocAnimationClip
+{
+    ocUInt32 boneCount;
+    ocUInt32 paddedBoneCount;       // <-- boneCount rounded up to a multiple of OC_ANIMATION_LANE_COUNT.
+    ocUInt32 frameCount;
+    float sampleRate;               // <-- In frames per second.
+    float duration;                 // <-- In seconds. The first frame is at time 0 and the last frame is at the duration.
+    ocTransformArray constantPose;  // <-- The value of every channel. Animated channels are overwritten by their track when sampled.
+    ocAnimationTrackSet rotations;
+    ocAnimationTrackSet positions;
+    ocAnimationTrackSet scales;
+
+    // Dynamically allocated data as a single allocation. This is the entire raw OCD file data verbatim.
+    ocUInt8* pPayload;
+    ocUInt64 payloadSize;
+};
+
+// Initializes a clip from the data of an uncompressed ANM1 file.
+//
+// The clip takes ownership of pOCDData, which must have been allocated with ocMalloc(). It is freed with ocFree() if this fails.
+ocResult ocAnimationClipInit(void* pOCDData, ocSizeT ocdDataSize, ocAnimationClip* pClip);
+
+// Uninitializes a clip.
+void ocAnimationClipUninit(ocAnimationClip* pClip);
+
+// Samples the local transform of every bone at the given time, which is clamped to the duration of the clip.
+//
+// pPose must have room for paddedBoneCount transforms. The transforms of the padding bones are undefined. pScratch must have room for
+// 4*paddedBoneCount floats.
+void ocAnimationClipSample(const ocAnimationClip* pClip, float time, ocTransformArray* pPose, float* pScratch);
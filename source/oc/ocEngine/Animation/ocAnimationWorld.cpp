@@ -0,0 +1,551 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// The scratch memory of each job, in units of the padded bone count: a sampled pose (10), a blended pose (10), scratch for sampling (4),
+// local matrices (16) and model space matrices (16).
+#define OC_ANIMATION_SCRATCH_PER_BONE   56
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Blending
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Layers are blended by accumulating the weighted sample of each layer. The weight of each rotation is negated if it's in the opposite
+// hemisphere to what has been accumulated so far, so that q and -q, which are the same rotation, don't cancel each other out.
+
+OC_PRIVATE void ocAnimationAccumulatePose_Scalar(const ocTransformArray* pSample, float weight, ocUInt32 iBegin, ocUInt32 iEnd, ocTransformArray* pPose)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        pPose->position.pX[i] = pPose->position.pX[i] + pSample->position.pX[i]*weight;
+        pPose->position.pY[i] = pPose->position.pY[i] + pSample->position.pY[i]*weight;
+        pPose->position.pZ[i] = pPose->position.pZ[i] + pSample->position.pZ[i]*weight;
+        pPose->scale.pX[i]    = pPose->scale.pX[i]    + pSample->scale.pX[i]*weight;
+        pPose->scale.pY[i]    = pPose->scale.pY[i]    + pSample->scale.pY[i]*weight;
+        pPose->scale.pZ[i]    = pPose->scale.pZ[i]    + pSample->scale.pZ[i]*weight;
+
+        float ax = pPose->rotation.pX[i], ay = pPose->rotation.pY[i], az = pPose->rotation.pZ[i], aw = pPose->rotation.pW[i];
+        float sx = pSample->rotation.pX[i], sy = pSample->rotation.pY[i], sz = pSample->rotation.pZ[i], sw = pSample->rotation.pW[i];
+        float rotationWeight = (ax*sx + ay*sy + az*sz + aw*sw < 0) ? -weight : weight;
+        pPose->rotation.pX[i] = ax + sx*rotationWeight;
+        pPose->rotation.pY[i] = ay + sy*rotationWeight;
+        pPose->rotation.pZ[i] = az + sz*rotationWeight;
+        pPose->rotation.pW[i] = aw + sw*rotationWeight;
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE void ocAnimationAccumulatePose_SSE2(const ocTransformArray* pSample, float weight, ocUInt32 count, ocTransformArray* pPose)
+{
+    const __m128 weight4  = _mm_set1_ps(weight);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero     = _mm_setzero_ps();
+
+    ocUInt32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(pPose->position.pX + i, _mm_add_ps(_mm_loadu_ps(pPose->position.pX + i), _mm_mul_ps(_mm_loadu_ps(pSample->position.pX + i), weight4)));
+        _mm_storeu_ps(pPose->position.pY + i, _mm_add_ps(_mm_loadu_ps(pPose->position.pY + i), _mm_mul_ps(_mm_loadu_ps(pSample->position.pY + i), weight4)));
+        _mm_storeu_ps(pPose->position.pZ + i, _mm_add_ps(_mm_loadu_ps(pPose->position.pZ + i), _mm_mul_ps(_mm_loadu_ps(pSample->position.pZ + i), weight4)));
+        _mm_storeu_ps(pPose->scale.pX + i,    _mm_add_ps(_mm_loadu_ps(pPose->scale.pX + i),    _mm_mul_ps(_mm_loadu_ps(pSample->scale.pX + i),    weight4)));
+        _mm_storeu_ps(pPose->scale.pY + i,    _mm_add_ps(_mm_loadu_ps(pPose->scale.pY + i),    _mm_mul_ps(_mm_loadu_ps(pSample->scale.pY + i),    weight4)));
+        _mm_storeu_ps(pPose->scale.pZ + i,    _mm_add_ps(_mm_loadu_ps(pPose->scale.pZ + i),    _mm_mul_ps(_mm_loadu_ps(pSample->scale.pZ + i),    weight4)));
+
+        __m128 ax = _mm_loadu_ps(pPose->rotation.pX + i);
+        __m128 ay = _mm_loadu_ps(pPose->rotation.pY + i);
+        __m128 az = _mm_loadu_ps(pPose->rotation.pZ + i);
+        __m128 aw = _mm_loadu_ps(pPose->rotation.pW + i);
+        __m128 sx = _mm_loadu_ps(pSample->rotation.pX + i);
+        __m128 sy = _mm_loadu_ps(pSample->rotation.pY + i);
+        __m128 sz = _mm_loadu_ps(pSample->rotation.pZ + i);
+        __m128 sw = _mm_loadu_ps(pSample->rotation.pW + i);
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, sx), _mm_mul_ps(ay, sy)), _mm_mul_ps(az, sz)), _mm_mul_ps(aw, sw));
+        __m128 rotationWeight = _mm_xor_ps(weight4, _mm_and_ps(_mm_cmplt_ps(dot, zero), signMask));
+        _mm_storeu_ps(pPose->rotation.pX + i, _mm_add_ps(ax, _mm_mul_ps(sx, rotationWeight)));
+        _mm_storeu_ps(pPose->rotation.pY + i, _mm_add_ps(ay, _mm_mul_ps(sy, rotationWeight)));
+        _mm_storeu_ps(pPose->rotation.pZ + i, _mm_add_ps(az, _mm_mul_ps(sz, rotationWeight)));
+        _mm_storeu_ps(pPose->rotation.pW + i, _mm_add_ps(aw, _mm_mul_ps(sw, rotationWeight)));
+    }
+
+    ocAnimationAccumulatePose_Scalar(pSample, weight, i, count, pPose);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE void ocAnimationAccumulatePose_AVX2(const ocTransformArray* pSample, float weight, ocUInt32 count, ocTransformArray* pPose)
+{
+    const __m256 weight8  = _mm256_set1_ps(weight);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 zero     = _mm256_setzero_ps();
+
+    ocUInt32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(pPose->position.pX + i, _mm256_add_ps(_mm256_loadu_ps(pPose->position.pX + i), _mm256_mul_ps(_mm256_loadu_ps(pSample->position.pX + i), weight8)));
+        _mm256_storeu_ps(pPose->position.pY + i, _mm256_add_ps(_mm256_loadu_ps(pPose->position.pY + i), _mm256_mul_ps(_mm256_loadu_ps(pSample->position.pY + i), weight8)));
+        _mm256_storeu_ps(pPose->position.pZ + i, _mm256_add_ps(_mm256_loadu_ps(pPose->position.pZ + i), _mm256_mul_ps(_mm256_loadu_ps(pSample->position.pZ + i), weight8)));
+        _mm256_storeu_ps(pPose->scale.pX + i,    _mm256_add_ps(_mm256_loadu_ps(pPose->scale.pX + i),    _mm256_mul_ps(_mm256_loadu_ps(pSample->scale.pX + i),    weight8)));
+        _mm256_storeu_ps(pPose->scale.pY + i,    _mm256_add_ps(_mm256_loadu_ps(pPose->scale.pY + i),    _mm256_mul_ps(_mm256_loadu_ps(pSample->scale.pY + i),    weight8)));
+        _mm256_storeu_ps(pPose->scale.pZ + i,    _mm256_add_ps(_mm256_loadu_ps(pPose->scale.pZ + i),    _mm256_mul_ps(_mm256_loadu_ps(pSample->scale.pZ + i),    weight8)));
+
+        __m256 ax = _mm256_loadu_ps(pPose->rotation.pX + i);
+        __m256 ay = _mm256_loadu_ps(pPose->rotation.pY + i);
+        __m256 az = _mm256_loadu_ps(pPose->rotation.pZ + i);
+        __m256 aw = _mm256_loadu_ps(pPose->rotation.pW + i);
+        __m256 sx = _mm256_loadu_ps(pSample->rotation.pX + i);
+        __m256 sy = _mm256_loadu_ps(pSample->rotation.pY + i);
+        __m256 sz = _mm256_loadu_ps(pSample->rotation.pZ + i);
+        __m256 sw = _mm256_loadu_ps(pSample->rotation.pW + i);
+        __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, sx), _mm256_mul_ps(ay, sy)), _mm256_mul_ps(az, sz)), _mm256_mul_ps(aw, sw));
+        __m256 rotationWeight = _mm256_xor_ps(weight8, _mm256_and_ps(_mm256_cmp_ps(dot, zero, _CMP_LT_OQ), signMask));
+        _mm256_storeu_ps(pPose->rotation.pX + i, _mm256_add_ps(ax, _mm256_mul_ps(sx, rotationWeight)));
+        _mm256_storeu_ps(pPose->rotation.pY + i, _mm256_add_ps(ay, _mm256_mul_ps(sy, rotationWeight)));
+        _mm256_storeu_ps(pPose->rotation.pZ + i, _mm256_add_ps(az, _mm256_mul_ps(sz, rotationWeight)));
+        _mm256_storeu_ps(pPose->rotation.pW + i, _mm256_add_ps(aw, _mm256_mul_ps(sw, rotationWeight)));
+    }
+
+    ocAnimationAccumulatePose_Scalar(pSample, weight, i, count, pPose);
+}
+#endif
+
+OC_PRIVATE void ocAnimationAccumulatePose(const ocTransformArray* pSample, float weight, ocUInt32 count, ocTransformArray* pPose)
+{
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocAnimationAccumulatePose_AVX2(pSample, weight, count, pPose);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocAnimationAccumulatePose_SSE2(pSample, weight, count, pPose);
+        return;
+    }
+#endif
+
+    ocAnimationAccumulatePose_Scalar(pSample, weight, 0, count, pPose);
+}
+
+// Divides the accumulated positions and scales by the total weight and normalizes the rotations.
+OC_PRIVATE void ocAnimationFinishPose(float totalWeight, ocUInt32 count, ocTransformArray* pPose)
+{
+    float invTotalWeight = 1.0f / totalWeight;
+    for (ocUInt32 i = 0; i < count; ++i) {
+        pPose->position.pX[i] *= invTotalWeight;
+        pPose->position.pY[i] *= invTotalWeight;
+        pPose->position.pZ[i] *= invTotalWeight;
+        pPose->scale.pX[i]    *= invTotalWeight;
+        pPose->scale.pY[i]    *= invTotalWeight;
+        pPose->scale.pZ[i]    *= invTotalWeight;
+    }
+
+    ocAnimationNormalizeQuats(&pPose->rotation, count);
+}
+
+OC_PRIVATE void ocAnimationZeroTransformArray(ocUInt32 count, ocTransformArray* pTransforms)
+{
+    ocZeroMemory(pTransforms->position.pX, sizeof(float) * count);
+    ocZeroMemory(pTransforms->position.pY, sizeof(float) * count);
+    ocZeroMemory(pTransforms->position.pZ, sizeof(float) * count);
+    ocZeroMemory(pTransforms->rotation.pX, sizeof(float) * count);
+    ocZeroMemory(pTransforms->rotation.pY, sizeof(float) * count);
+    ocZeroMemory(pTransforms->rotation.pZ, sizeof(float) * count);
+    ocZeroMemory(pTransforms->rotation.pW, sizeof(float) * count);
+    ocZeroMemory(pTransforms->scale.pX,    sizeof(float) * count);
+    ocZeroMemory(pTransforms->scale.pY,    sizeof(float) * count);
+    ocZeroMemory(pTransforms->scale.pZ,    sizeof(float) * count);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Hierarchy
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Each bone depends on it's parent so the hierarchy can't be done several bones at a time. Instead, each matrix multiply is done a column
+// at a time with SIMD. The scalar path does the same operations in the same order.
+
+OC_PRIVATE void ocAnimationResolveHierarchy_Scalar(const ocSkeleton* pSkeleton, const float* pLocal, float* pModel, float* pPalette)
+{
+    const float* pInverseBind = (const float*)pSkeleton->pInverseBindMatrices;
+
+    for (ocUInt32 iBone = 0; iBone < pSkeleton->boneCount; ++iBone) {
+        float* pBoneModel = pModel + iBone*16;
+
+        ocUInt32 iParent = pSkeleton->pParentIndices[iBone];
+        if (iParent == OC_SKELETON_BONE_NONE) {
+            ocCopyMemory(pBoneModel, pLocal + iBone*16, sizeof(float)*16);
+        } else {
+            const float* a = pModel + iParent*16;
+            const float* b = pLocal + iBone*16;
+            for (ocUInt32 iColumn = 0; iColumn < 4; ++iColumn) {
+                for (ocUInt32 iRow = 0; iRow < 4; ++iRow) {
+                    pBoneModel[iColumn*4 + iRow] = a[0*4 + iRow]*b[iColumn*4 + 0] + a[1*4 + iRow]*b[iColumn*4 + 1] + a[2*4 + iRow]*b[iColumn*4 + 2] + a[3*4 + iRow]*b[iColumn*4 + 3];
+                }
+            }
+        }
+
+        const float* b = pInverseBind + iBone*16;
+        for (ocUInt32 iColumn = 0; iColumn < 4; ++iColumn) {
+            for (ocUInt32 iRow = 0; iRow < 4; ++iRow) {
+                pPalette[iBone*16 + iColumn*4 + iRow] = pBoneModel[0*4 + iRow]*b[iColumn*4 + 0] + pBoneModel[1*4 + iRow]*b[iColumn*4 + 1] + pBoneModel[2*4 + iRow]*b[iColumn*4 + 2] + pBoneModel[3*4 + iRow]*b[iColumn*4 + 3];
+            }
+        }
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_INLINE void ocAnimationMultiplyMat4_SSE2(const float* a, const float* b, float* pResult)
+{
+    __m128 a0 = _mm_loadu_ps(a +  0);
+    __m128 a1 = _mm_loadu_ps(a +  4);
+    __m128 a2 = _mm_loadu_ps(a +  8);
+    __m128 a3 = _mm_loadu_ps(a + 12);
+
+    for (ocUInt32 iColumn = 0; iColumn < 4; ++iColumn) {
+        __m128 column = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(a0, _mm_set1_ps(b[iColumn*4 + 0])),
+            _mm_mul_ps(a1, _mm_set1_ps(b[iColumn*4 + 1]))),
+            _mm_mul_ps(a2, _mm_set1_ps(b[iColumn*4 + 2]))),
+            _mm_mul_ps(a3, _mm_set1_ps(b[iColumn*4 + 3])));
+        _mm_storeu_ps(pResult + iColumn*4, column);
+    }
+}
+
+OC_PRIVATE void ocAnimationResolveHierarchy_SSE2(const ocSkeleton* pSkeleton, const float* pLocal, float* pModel, float* pPalette)
+{
+    const float* pInverseBind = (const float*)pSkeleton->pInverseBindMatrices;
+
+    for (ocUInt32 iBone = 0; iBone < pSkeleton->boneCount; ++iBone) {
+        ocUInt32 iParent = pSkeleton->pParentIndices[iBone];
+        if (iParent == OC_SKELETON_BONE_NONE) {
+            ocCopyMemory(pModel + iBone*16, pLocal + iBone*16, sizeof(float)*16);
+        } else {
+            ocAnimationMultiplyMat4_SSE2(pModel + iParent*16, pLocal + iBone*16, pModel + iBone*16);
+        }
+
+        ocAnimationMultiplyMat4_SSE2(pModel + iBone*16, pInverseBind + iBone*16, pPalette + iBone*16);
+    }
+}
+#endif
+
+OC_PRIVATE void ocAnimationResolveHierarchy(const ocSkeleton* pSkeleton, const glm::mat4* pLocal, glm::mat4* pModel, glm::mat4* pPalette)
+{
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() != ocSIMDLevel_None) {
+        ocAnimationResolveHierarchy_SSE2(pSkeleton, &pLocal[0][0][0], &pModel[0][0][0], &pPalette[0][0][0]);
+        return;
+    }
+#endif
+
+    ocAnimationResolveHierarchy_Scalar(pSkeleton, &pLocal[0][0][0], &pModel[0][0][0], &pPalette[0][0][0]);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Evaluation
+//
+///////////////////////////////////////////////////////////////////////////////
+
+OC_PRIVATE void ocAnimationLayerAdvance(ocAnimationLayer* pLayer, float dt)
+{
+    float duration = pLayer->pClip->duration;
+    float time = pLayer->time + dt*pLayer->speed;
+
+    if (pLayer->isLooping && duration > 0) {
+        time = fmodf(time, duration);
+        if (time < 0) {
+            time += duration;
+        }
+    } else {
+        time = ocClamp(time, 0.0f, duration);
+    }
+
+    pLayer->time = time;
+}
+
+OC_PRIVATE void ocAnimationWorldEvaluateCharacter(ocAnimationCharacter* pCharacter, float dt, float* pScratch, ocUInt32 scratchStride, glm::mat4* pPalettes)
+{
+    ocAssert(pCharacter != NULL);
+
+    const ocSkeleton* pSkeleton = pCharacter->pSkeleton;
+    ocUInt32 paddedBoneCount = pSkeleton->paddedBoneCount;
+
+    ocTransformArray sample = ocAnimationMapTransformArray(pScratch + scratchStride*0,  scratchStride);
+    ocTransformArray pose   = ocAnimationMapTransformArray(pScratch + scratchStride*10, scratchStride);
+    float*     pSampleScratch = pScratch + scratchStride*20;
+    glm::mat4* pLocal         = (glm::mat4*)(pScratch + scratchStride*24);
+    glm::mat4* pModel         = (glm::mat4*)(pScratch + scratchStride*40);
+
+    ocUInt32 layerCount = 0;
+    float totalWeight = 0;
+    for (ocUInt32 iLayer = 0; iLayer < OC_ANIMATION_MAX_LAYERS; ++iLayer) {
+        ocAnimationLayer* pLayer = &pCharacter->layers[iLayer];
+        if (pLayer->pClip == NULL) {
+            continue;
+        }
+
+        ocAnimationLayerAdvance(pLayer, dt);
+        if (pLayer->weight <= 0) {
+            continue;
+        }
+
+        // The first layer is sampled straight into the pose in case it's the only one, which is the most common case.
+        if (layerCount == 0) {
+            ocAnimationClipSample(pLayer->pClip, pLayer->time, &pose, pSampleScratch);
+        } else {
+            if (layerCount == 1) {
+                ocAnimationCopyTransformArray(&pose, paddedBoneCount, &sample);
+                ocAnimationZeroTransformArray(paddedBoneCount, &pose);
+                ocAnimationAccumulatePose(&sample, totalWeight, paddedBoneCount, &pose);
+            }
+
+            ocAnimationClipSample(pLayer->pClip, pLayer->time, &sample, pSampleScratch);
+            ocAnimationAccumulatePose(&sample, pLayer->weight, paddedBoneCount, &pose);
+        }
+
+        layerCount  += 1;
+        totalWeight += pLayer->weight;
+    }
+
+    if (layerCount == 0) {
+        ocAnimationCopyTransformArray(&pSkeleton->bindPose, paddedBoneCount, &pose);
+    } else if (layerCount > 1) {
+        ocAnimationFinishPose(totalWeight, paddedBoneCount, &pose);
+    }
+
+    ocMakeMat4Array(&pose, paddedBoneCount, pLocal);
+    ocAnimationResolveHierarchy(pSkeleton, pLocal, pModel, pPalettes + pCharacter->paletteOffset);
+}
+
+OC_PRIVATE void ocAnimationWorldJobProc(void* pUserData)
+{
+    ocAnimationJob* pJob = (ocAnimationJob*)pUserData;
+    ocAssert(pJob != NULL);
+
+    ocAnimationWorld* pWorld = pJob->pWorld;
+    for (ocUInt32 iCharacter = pJob->begin; iCharacter < pJob->end; ++iCharacter) {
+        ocAnimationWorldEvaluateCharacter(pWorld->characters.pItems[iCharacter], pJob->dt, pJob->pScratch, pWorld->maxPaddedBoneCount, pJob->pPalettes);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Animation World
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocResult ocAnimationWorldInit(ocJobQueue* pJobQueue, ocAnimationWorld* pWorld)
+{
+    if (pWorld == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pWorld);
+
+    pWorld->pJobQueue = pJobQueue;
+    ocStackInit(&pWorld->characters);
+    ocStackInit(&pWorld->freePaletteRanges);
+    ocStackInit(&pWorld->scratch);
+    ocStackInit(&pWorld->jobs);
+
+    return OC_SUCCESS;
+}
+
+void ocAnimationWorldUninit(ocAnimationWorld* pWorld)
+{
+    if (pWorld == NULL) {
+        return;
+    }
+
+    for (size_t iCharacter = 0; iCharacter < pWorld->characters.count; ++iCharacter) {
+        ocFree(pWorld->characters.pItems[iCharacter]);
+    }
+
+    ocStackUninit(&pWorld->characters);
+    ocStackUninit(&pWorld->freePaletteRanges);
+    ocStackUninit(&pWorld->scratch);
+    ocStackUninit(&pWorld->jobs);
+}
+
+// Finds room for a palette, reusing the first free range that's big enough.
+OC_PRIVATE ocUInt32 ocAnimationWorldAllocatePalette(ocAnimationWorld* pWorld, ocUInt32 count)
+{
+    for (size_t iRange = 0; iRange < pWorld->freePaletteRanges.count; ++iRange) {
+        ocAnimationPaletteRange* pRange = &pWorld->freePaletteRanges.pItems[iRange];
+        if (pRange->count >= count) {
+            ocUInt32 offset = pRange->offset;
+            pRange->offset += count;
+            pRange->count  -= count;
+            if (pRange->count == 0) {
+                *pRange = pWorld->freePaletteRanges.pItems[pWorld->freePaletteRanges.count-1];
+                ocStackPop(&pWorld->freePaletteRanges);
+            }
+
+            return offset;
+        }
+    }
+
+    ocUInt32 offset = pWorld->paletteSize;
+    pWorld->paletteSize += count;
+    return offset;
+}
+
+ocResult ocAnimationWorldCreateCharacter(ocAnimationWorld* pWorld, const ocSkeleton* pSkeleton, ocAnimationCharacter** ppCharacter)
+{
+    if (ppCharacter == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppCharacter = NULL;
+
+    if (pWorld == NULL || pSkeleton == NULL || pSkeleton->boneCount == 0) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocAnimationCharacter* pCharacter = ocCallocObject(ocAnimationCharacter);
+    if (pCharacter == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocResult result = ocStackPush(&pWorld->characters, pCharacter);
+    if (result != OC_SUCCESS) {
+        ocFree(pCharacter);
+        return result;
+    }
+
+    pCharacter->pWorld        = pWorld;
+    pCharacter->pSkeleton     = pSkeleton;
+    pCharacter->paletteOffset = ocAnimationWorldAllocatePalette(pWorld, pSkeleton->boneCount);
+
+    pWorld->maxPaddedBoneCount = ocMax(pWorld->maxPaddedBoneCount, pSkeleton->paddedBoneCount);
+
+    *ppCharacter = pCharacter;
+    return OC_SUCCESS;
+}
+
+void ocAnimationWorldDeleteCharacter(ocAnimationWorld* pWorld, ocAnimationCharacter* pCharacter)
+{
+    if (pWorld == NULL || pCharacter == NULL) {
+        return;
+    }
+
+    ocAssert(pCharacter->pWorld == pWorld);
+
+    for (size_t iCharacter = 0; iCharacter < pWorld->characters.count; ++iCharacter) {
+        if (pWorld->characters.pItems[iCharacter] == pCharacter) {
+            pWorld->characters.pItems[iCharacter] = pWorld->characters.pItems[pWorld->characters.count-1];
+            ocStackPop(&pWorld->characters);
+            break;
+        }
+    }
+
+    ocAnimationPaletteRange range;
+    range.offset = pCharacter->paletteOffset;
+    range.count  = pCharacter->pSkeleton->boneCount;
+    ocStackPush(&pWorld->freePaletteRanges, range);    // <-- If this fails the range is just never reused.
+
+    ocFree(pCharacter);
+}
+
+ocUInt32 ocAnimationWorldGetPaletteSize(const ocAnimationWorld* pWorld)
+{
+    if (pWorld == NULL) {
+        return 0;
+    }
+
+    return pWorld->paletteSize;
+}
+
+void ocAnimationWorldStep(ocAnimationWorld* pWorld, float dt, glm::mat4* pPalettes)
+{
+    if (pWorld == NULL || pPalettes == NULL) {
+        return;
+    }
+
+    ocUInt32 characterCount = (ocUInt32)pWorld->characters.count;
+    if (characterCount == 0) {
+        return;
+    }
+
+    ocUInt32 jobCount = (characterCount + OC_ANIMATION_CHARACTER_BATCH_SIZE - 1) / OC_ANIMATION_CHARACTER_BATCH_SIZE;
+    ocUInt32 scratchPerJob = pWorld->maxPaddedBoneCount * OC_ANIMATION_SCRATCH_PER_BONE;
+    if (ocStackResize(&pWorld->scratch, (size_t)jobCount * scratchPerJob) != OC_SUCCESS ||
+        ocStackResize(&pWorld->jobs, jobCount) != OC_SUCCESS) {
+        return;
+    }
+
+    for (ocUInt32 iJob = 0; iJob < jobCount; ++iJob) {
+        ocAnimationJob* pJob = &pWorld->jobs.pItems[iJob];
+        pJob->pWorld    = pWorld;
+        pJob->begin     = iJob * OC_ANIMATION_CHARACTER_BATCH_SIZE;
+        pJob->end       = ocMin(pJob->begin + OC_ANIMATION_CHARACTER_BATCH_SIZE, characterCount);
+        pJob->dt        = dt;
+        pJob->pScratch  = pWorld->scratch.pItems + (size_t)iJob * scratchPerJob;
+        pJob->pPalettes = pPalettes;
+    }
+
+    if (pWorld->pJobQueue != NULL && jobCount > 1) {
+        ocUInt32 counter = 0;
+        for (ocUInt32 iJob = 0; iJob < jobCount; ++iJob) {
+            if (ocJobQueueSubmit(pWorld->pJobQueue, ocAnimationWorldJobProc, &pWorld->jobs.pItems[iJob], &counter) != OC_SUCCESS) {
+                ocAnimationWorldJobProc(&pWorld->jobs.pItems[iJob]);
+            }
+        }
+
+        ocJobQueueWaitForCounter(pWorld->pJobQueue, &counter);
+    } else {
+        for (ocUInt32 iJob = 0; iJob < jobCount; ++iJob) {
+            ocAnimationWorldJobProc(&pWorld->jobs.pItems[iJob]);
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Characters
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocResult ocAnimationCharacterSetLayer(ocAnimationCharacter* pCharacter, ocUInt32 layerIndex, const ocAnimationClip* pClip, float weight, float speed, ocBool32 isLooping)
+{
+    if (pCharacter == NULL || layerIndex >= OC_ANIMATION_MAX_LAYERS) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (pClip != NULL && pClip->boneCount != pCharacter->pSkeleton->boneCount) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocAnimationLayer* pLayer = &pCharacter->layers[layerIndex];
+    pLayer->pClip     = pClip;
+    pLayer->time      = (pClip != NULL && speed < 0) ? pClip->duration : 0;
+    pLayer->speed     = speed;
+    pLayer->weight    = weight;
+    pLayer->isLooping = isLooping;
+
+    return OC_SUCCESS;
+}
+
+void ocAnimationCharacterSetLayerWeight(ocAnimationCharacter* pCharacter, ocUInt32 layerIndex, float weight)
+{
+    if (pCharacter == NULL || layerIndex >= OC_ANIMATION_MAX_LAYERS) {
+        return;
+    }
+
+    pCharacter->layers[layerIndex].weight = weight;
+}
+
+void ocAnimationCharacterSetLayerTime(ocAnimationCharacter* pCharacter, ocUInt32 layerIndex, float time)
+{
+    if (pCharacter == NULL || layerIndex >= OC_ANIMATION_MAX_LAYERS) {
+        return;
+    }
+
+    pCharacter->layers[layerIndex].time = time;
+}
@@ -0,0 +1,109 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// The animation world evaluates the bone palettes of every animated character.
+//
+// Each character has a skeleton and up to OC_ANIMATION_MAX_LAYERS layers, each playing a clip with a weight. A step goes through these
+// stages for each character:
+//   1) The time of each layer is advanced.
+//   2) Each layer with a weight is sampled and the samples are blended. Positions and scales are averaged by weight. Rotations are
+//      averaged by weight, flipped into the hemisphere of the first layer, and then normalized. A character with no layers is left in
+//      it's bind pose.
+//   3) The local transforms are converted to matrices and multiplied down the hierarchy.
+//   4) The model space matrix of each bone is multiplied by it's inverse bind matrix and written to the palette.
+//
+// All of this works on the structure of arrays layout of the clips and skeletons, so everything but the hierarchy is done 4 or 8 bones
+// at a time with SIMD. Characters don't share any state, so they're split into batches of OC_ANIMATION_CHARACTER_BATCH_SIZE which are
+// run in parallel on the job queue.
+//
+// The palettes of every character are packed together into a single array of ocAnimationWorldGetPaletteSize() matrices, with each
+// character at it's paletteOffset. This array is provided by the caller of ocAnimationWorldStep() so that it can be written straight to
+// a buffer that's visible to the GPU. The palettes are only written, never read.
+
+#define OC_ANIMATION_MAX_LAYERS             4
+#define OC_ANIMATION_CHARACTER_BATCH_SIZE   16      // <-- The number of characters handled by each job.
+
+struct ocAnimationWorld;
+
+struct ocAnimationLayer
+{
+    const ocAnimationClip* pClip;   // <-- NULL if the layer is not being used.
+    float time;                     // <-- In seconds.
+    float speed;                    // <-- 1 for normal speed. Can be negative.
+    float weight;
+    ocBool32 isLooping;             // <-- When false, the layer holds the first or last frame once it gets to either end of the clip.
+};
+
+struct ocAnimationCharacter
+{
+    ocAnimationWorld* pWorld;
+    const ocSkeleton* pSkeleton;
+    ocUInt32 paletteOffset;         // <-- The index of the matrix of the first bone in the palette array.
+    ocAnimationLayer layers[OC_ANIMATION_MAX_LAYERS];
+    void* pUserData;
+};
+
+struct ocAnimationPaletteRange
+{
+    ocUInt32 offset;
+    ocUInt32 count;
+};
+
+struct ocAnimationJob
+{
+    ocAnimationWorld* pWorld;
+    ocUInt32 begin;
+    ocUInt32 end;
+    float dt;
+    float* pScratch;
+    glm::mat4* pPalettes;
+};
+
+struct ocAnimationWorld
+{
+    ocJobQueue* pJobQueue;          // <-- Can be NULL, in which case everything is run on the calling thread.
+    ocStack<ocAnimationCharacter*> characters;
+
+    // The palettes of deleted characters are reused by new characters that fit. Palettes are never moved so the size only grows.
+    ocUInt32 paletteSize;
+    ocStack<ocAnimationPaletteRange> freePaletteRanges;
+
+    // Each job gets it's own scratch memory, sized for the largest skeleton.
+    ocUInt32 maxPaddedBoneCount;
+    ocStack<float> scratch;
+    ocStack<ocAnimationJob> jobs;
+};
+
+// Initializes an animation world. pJobQueue is optional.
+ocResult ocAnimationWorldInit(ocJobQueue* pJobQueue, ocAnimationWorld* pWorld);
+
+// Uninitializes an animation world. Any characters that have not been deleted are deleted.
+void ocAnimationWorldUninit(ocAnimationWorld* pWorld);
+
+// Creates an animated character. The character starts in the bind pose of the skeleton, which must remain valid while the character
+// exists.
+ocResult ocAnimationWorldCreateCharacter(ocAnimationWorld* pWorld, const ocSkeleton* pSkeleton, ocAnimationCharacter** ppCharacter);
+
+// Deletes an animated character. It's palette is reused by later characters.
+void ocAnimationWorldDeleteCharacter(ocAnimationWorld* pWorld, ocAnimationCharacter* pCharacter);
+
+// Retrieves the number of matrices needed for the palettes of every character.
+ocUInt32 ocAnimationWorldGetPaletteSize(const ocAnimationWorld* pWorld);
+
+// Advances every character by dt seconds and writes their palettes to pPalettes, which must have room for ocAnimationWorldGetPaletteSize()
+// matrices.
+//
+// This must not be called at the same time as anything that creates or deletes a character or changes a layer.
+void ocAnimationWorldStep(ocAnimationWorld* pWorld, float dt, glm::mat4* pPalettes);
+
+
+// Plays a clip on a layer of a character. Set pClip to NULL to stop the layer. The time of the layer is reset to the start of the clip,
+// or the end if speed is negative.
+//
+// The clip must have the same number of bones as the skeleton of the character, and must remain valid while it's being played.
+ocResult ocAnimationCharacterSetLayer(ocAnimationCharacter* pCharacter, ocUInt32 layerIndex, const ocAnimationClip* pClip, float weight, float speed, ocBool32 isLooping);
+
+// Sets the weight of a layer. Use this for fading layers in and out.
+void ocAnimationCharacterSetLayerWeight(ocAnimationCharacter* pCharacter, ocUInt32 layerIndex, float weight);
+
+// Sets the time of a layer, in seconds.
+void ocAnimationCharacterSetLayerTime(ocAnimationCharacter* pCharacter, ocUInt32 layerIndex, float time);
@@ -0,0 +1,128 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Checks that a block of an animation file lies within the file.
+OC_PRIVATE ocBool32 ocAnimationIsBlockInPayload(ocUInt64 offset, ocUInt64 size, ocUInt64 payloadSize)
+{
+    return offset <= payloadSize && size <= payloadSize - offset;
+}
+
+// Retrieves the arrays of a transform array that's stored as 10 consecutive arrays of floats: position, rotation and scale.
+OC_PRIVATE ocTransformArray ocAnimationMapTransformArray(float* pData, ocUInt32 paddedCount)
+{
+    ocTransformArray transforms;
+    transforms.position.pX = pData + paddedCount*0;
+    transforms.position.pY = pData + paddedCount*1;
+    transforms.position.pZ = pData + paddedCount*2;
+    transforms.rotation.pX = pData + paddedCount*3;
+    transforms.rotation.pY = pData + paddedCount*4;
+    transforms.rotation.pZ = pData + paddedCount*5;
+    transforms.rotation.pW = pData + paddedCount*6;
+    transforms.scale.pX    = pData + paddedCount*7;
+    transforms.scale.pY    = pData + paddedCount*8;
+    transforms.scale.pZ    = pData + paddedCount*9;
+
+    return transforms;
+}
+
+ocResult ocSkeletonInit(void* pOCDData, ocSizeT ocdDataSize, ocSkeleton* pSkeleton)
+{
+    if (pSkeleton == NULL) {
+        ocFree(pOCDData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pSkeleton);
+
+    if (pOCDData == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    // The SKL1 header is 48 bytes.
+    ocUInt8* pPayload = (ocUInt8*)pOCDData;
+    if (ocdDataSize < OC_OCD_HEADER_SIZE + 48 || ((ocUInt32*)pPayload)[0] != OC_OCD_FOURCC || ((ocUInt32*)pPayload)[1] != OC_OCD_TYPE_ID_SKELETON) {
+        ocFree(pOCDData);
+        return OC_CORRUPT_FILE;
+    }
+
+    ocUInt32 boneCount           = *(ocUInt32*)(pPayload + OC_OCD_HEADER_SIZE + 0);
+    ocUInt64 parentsOffset       = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 8);
+    ocUInt64 nameOffsetsOffset   = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 16);
+    ocUInt64 bindPoseOffset      = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 24);
+    ocUInt64 inverseBindOffset   = *(ocUInt64*)(pPayload + OC_OCD_HEADER_SIZE + 32);
+    ocUInt32 paddedBoneCount     = ocAlign(boneCount, OC_ANIMATION_LANE_COUNT);
+
+    ocBool32 isValid =
+        boneCount > 0 && boneCount <= OC_SKELETON_MAX_BONES &&
+        ocAnimationIsBlockInPayload(parentsOffset,     sizeof(ocUInt32)  * boneCount,            ocdDataSize) &&
+        ocAnimationIsBlockInPayload(nameOffsetsOffset, sizeof(ocUInt64)  * boneCount,            ocdDataSize) &&
+        ocAnimationIsBlockInPayload(bindPoseOffset,    sizeof(float)     * paddedBoneCount * 10, ocdDataSize) &&
+        ocAnimationIsBlockInPayload(inverseBindOffset, sizeof(glm::mat4) * boneCount,            ocdDataSize);
+
+    // Everything else assumes parents come before their children, so that needs to be checked here rather than trusting the file. Names
+    // are returned straight out of the payload, so each one needs to be terminated before the end of it.
+    if (isValid) {
+        const ocUInt32* pParentIndices = (const ocUInt32*)(pPayload + parentsOffset);
+        const ocUInt64* pNameOffsets   = (const ocUInt64*)(pPayload + nameOffsetsOffset);
+        for (ocUInt32 iBone = 0; iBone < boneCount; ++iBone) {
+            if (pParentIndices[iBone] != OC_SKELETON_BONE_NONE && pParentIndices[iBone] >= iBone) {
+                isValid = OC_FALSE;
+                break;
+            }
+
+            if (pNameOffsets[iBone] >= ocdDataSize || memchr(pPayload + pNameOffsets[iBone], '\0', (size_t)(ocdDataSize - pNameOffsets[iBone])) == NULL) {
+                isValid = OC_FALSE;
+                break;
+            }
+        }
+    }
+
+    if (!isValid) {
+        ocFree(pOCDData);
+        return OC_CORRUPT_FILE;
+    }
+
+    pSkeleton->boneCount            = boneCount;
+    pSkeleton->paddedBoneCount      = paddedBoneCount;
+    pSkeleton->pParentIndices       = (const ocUInt32*)(pPayload + parentsOffset);
+    pSkeleton->pNameOffsets         = (const ocUInt64*)(pPayload + nameOffsetsOffset);
+    pSkeleton->bindPose             = ocAnimationMapTransformArray((float*)(pPayload + bindPoseOffset), paddedBoneCount);
+    pSkeleton->pInverseBindMatrices = (const glm::mat4*)(pPayload + inverseBindOffset);
+    pSkeleton->pPayload             = pPayload;
+    pSkeleton->payloadSize          = ocdDataSize;
+
+    return OC_SUCCESS;
+}
+
+void ocSkeletonUninit(ocSkeleton* pSkeleton)
+{
+    if (pSkeleton == NULL) {
+        return;
+    }
+
+    ocFree(pSkeleton->pPayload);
+}
+
+const char* ocSkeletonGetBoneName(const ocSkeleton* pSkeleton, ocUInt32 boneIndex)
+{
+    if (pSkeleton == NULL || boneIndex >= pSkeleton->boneCount) {
+        return NULL;
+    }
+
+    // The offset and terminator of every name were checked by ocSkeletonInit().
+    return (const char*)(pSkeleton->pPayload + pSkeleton->pNameOffsets[boneIndex]);
+}
+
+ocUInt32 ocSkeletonFindBone(const ocSkeleton* pSkeleton, const char* name)
+{
+    if (pSkeleton == NULL || name == NULL) {
+        return OC_SKELETON_BONE_NONE;
+    }
+
+    for (ocUInt32 iBone = 0; iBone < pSkeleton->boneCount; ++iBone) {
+        if (strcmp(ocSkeletonGetBoneName(pSkeleton, iBone), name) == 0) {
+            return iBone;
+        }
+    }
+
+    return OC_SKELETON_BONE_NONE;
+}
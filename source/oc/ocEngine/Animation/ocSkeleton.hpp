@@ -0,0 +1,41 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Skeletons and animation clips are stored as a structure of arrays with one element per bone. The arrays are padded with unused bones
+// up to a multiple of OC_ANIMATION_LANE_COUNT so that every SIMD loop over them can run to the end without a remainder.
+#define OC_ANIMATION_LANE_COUNT     8
+
+// The most bones a skeleton can have. Skinned vertices refer to bones with 8-bit indices.
+#define OC_SKELETON_MAX_BONES       256
+
+#define OC_SKELETON_BONE_NONE       (~0U)
+
+// NOTES:
+// - A skeleton is loaded from a SKL1 file, which is mapped in place. See ocOCDSkeletonBuilder.
+// - Parents always come before their children so the bones can be transformed in order.
+struct ocSkeleton
+{
+    ocUInt32 boneCount;
+    ocUInt32 paddedBoneCount;                   // <-- boneCount rounded up to a multiple of OC_ANIMATION_LANE_COUNT.
+    const ocUInt32* pParentIndices;             // <-- OC_SKELETON_BONE_NONE for root bones.
+    const ocUInt64* pNameOffsets;               // <-- Offsets of the name of each bone in pPayload.
+    ocTransformArray bindPose;                  // <-- Relative to the parent. Each array is paddedBoneCount long.
+    const glm::mat4* pInverseBindMatrices;      // <-- Transforms from model space to the space of each bone in the bind pose.
+
+    // Dynamically allocated data as a single allocation. This is the entire raw OCD file data verbatim.
+    ocUInt8* pPayload;
+    ocUInt64 payloadSize;
+};
+
+// Initializes a skeleton from the data of an uncompressed SKL1 file.
+//
+// The skeleton takes ownership of pOCDData, which must have been allocated with ocMalloc(). It is freed with ocFree() if this fails.
+ocResult ocSkeletonInit(void* pOCDData, ocSizeT ocdDataSize, ocSkeleton* pSkeleton);
+
+// Uninitializes a skeleton.
+void ocSkeletonUninit(ocSkeleton* pSkeleton);
+
+// Retrieves the name of a bone.
+const char* ocSkeletonGetBoneName(const ocSkeleton* pSkeleton, ocUInt32 boneIndex);
+
+// Finds a bone by it's name. Returns OC_SKELETON_BONE_NONE if the skeleton does not have a bone with the given name.
+ocUInt32 ocSkeletonFindBone(const ocSkeleton* pSkeleton, const char* name);
@@ -1,4 +1,7 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+#include "ocAudioDecoder.cpp"
+#include "ocAudioStreamer.cpp"
+#include "ocAudioMixer.cpp"
 #include "ocAudioContext.cpp"
 #include "ocAudioWorld.cpp"
\ No newline at end of file
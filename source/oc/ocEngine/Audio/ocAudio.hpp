@@ -1,4 +1,7 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+#include "ocAudioDecoder.hpp"
+#include "ocAudioStreamer.hpp"
+#include "ocAudioMixer.hpp"
 #include "ocAudioContext.hpp"
 #include "ocAudioWorld.hpp"
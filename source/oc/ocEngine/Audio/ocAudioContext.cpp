@@ -14,11 +14,13 @@ OC_INLINE ocResult ocToResultFromMAL(ma_result resultMAL)
 
 void ocOnSendSamplesMAL(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount)
 {
-    // TODO: Implement me.
-    (void)pDevice;
-    (void)pOutput;
     (void)pInput;
-    (void)frameCount;
+
+    ocAudioContext* pAudio = (ocAudioContext*)pDevice->pUserData;
+    ocAssert(pAudio != NULL);
+
+    // This is the audio thread. The device is always opened as stereo f32, which is what the mixer outputs.
+    ocAudioMixerRead(&pAudio->mixer, (float*)pOutput, frameCount);
 }
 
 void ocOnLogMAL(ma_context* pContext, ma_device* pDevice, ma_uint32 logLevel, const char* pMessage)
@@ -39,18 +41,29 @@ ocResult ocAudioInit(ocEngineContext* pEngine, ocAudioContext* pAudio)
     if (pEngine == NULL) return OC_INVALID_ARGS;
 
     pAudio->pEngine = pEngine;
+    pAudio->pResourceLibrary = &pEngine->resourceLibrary;
+    ocStackInit(&pAudio->soundVoices);
 
     ma_context_config contextConfig = ma_context_config_init();
     contextConfig.logCallback = ocOnLogMAL;
 
-    ma_result resultMAL = ma_context_init(NULL, 0, &contextConfig, &pAudio->internalContext);
+    // The null backend is used for running without a sound card, such as on build machines.
+    ma_backend nullBackend[] = {ma_backend_null};
+    ma_backend* pBackends = NULL;
+    ma_uint32 backendCount = 0;
+    if (ocCmdLineIsSet(pEngine->argc, pEngine->argv, "--audio-null")) {
+        pBackends    = nullBackend;
+        backendCount = ocCountOf(nullBackend);
+    }
+
+    ma_result resultMAL = ma_context_init(pBackends, backendCount, &contextConfig, &pAudio->internalContext);
     if (resultMAL != MA_SUCCESS) {
         return ocToResultFromMAL(resultMAL);
     }
 
     ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
     deviceConfig.playback.format   = ma_format_f32;
-    deviceConfig.playback.channels = 0;  // <-- Prefer device's native channel count.
+    deviceConfig.playback.channels = OC_AUDIO_MIXER_CHANNELS;   // <-- miniaudio converts to the device's native channel count.
     deviceConfig.sampleRate        = 48000;
     deviceConfig.dataCallback      = ocOnSendSamplesMAL;
     deviceConfig.pUserData         = pAudio;
@@ -61,6 +74,57 @@ ocResult ocAudioInit(ocEngineContext* pEngine, ocAudioContext* pAudio)
         return ocToResultFromMAL(resultMAL);
     }
 
+    ocUInt32 maxRealVoices = OC_AUDIO_DEFAULT_MAX_REAL_VOICES;
+    if (ocCmdLineGetValue(pEngine->argc, pEngine->argv, "--audio-real-voices") != NULL) {
+        maxRealVoices = (ocUInt32)atoi(ocCmdLineGetValue(pEngine->argc, pEngine->argv, "--audio-real-voices"));
+    }
+
+    ocResult result = ocAudioStreamerInit(&pAudio->streamer);
+    if (result != OC_SUCCESS) {
+        ma_device_uninit(&pAudio->playbackDevice);
+        ma_context_uninit(&pAudio->internalContext);
+        return result;
+    }
+
+    // The mixer must be initialized before the device is started because the callback will start reading from it straight away.
+    result = ocAudioMixerInit(pAudio->playbackDevice.sampleRate, OC_AUDIO_DEFAULT_MAX_VOICES, maxRealVoices, &pAudio->mixer);
+    if (result != OC_SUCCESS) {
+        ocAudioStreamerUninit(&pAudio->streamer);
+        ma_device_uninit(&pAudio->playbackDevice);
+        ma_context_uninit(&pAudio->internalContext);
+        return result;
+    }
+
+    resultMAL = ma_device_start(&pAudio->playbackDevice);
+    if (resultMAL != MA_SUCCESS) {
+        ocAudioMixerUninit(&pAudio->mixer);
+        ocAudioStreamerUninit(&pAudio->streamer);
+        ma_device_uninit(&pAudio->playbackDevice);
+        ma_context_uninit(&pAudio->internalContext);
+        return ocToResultFromMAL(resultMAL);
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocAudioInitOffline(ocUInt32 sampleRate, ocUInt32 maxVoices, ocUInt32 maxRealVoices, ocAudioContext* pAudio)
+{
+    if (pAudio == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pAudio);
+
+    pAudio->isOffline = OC_TRUE;
+
+    ocResult result = ocAudioStreamerInit(&pAudio->streamer);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocAudioMixerInit(sampleRate, maxVoices, maxRealVoices, &pAudio->mixer);
+    if (result != OC_SUCCESS) {
+        ocAudioStreamerUninit(&pAudio->streamer);
+        return result;
+    }
+
     return OC_SUCCESS;
 }
 
@@ -70,6 +134,107 @@ void ocAudioUninit(ocAudioContext* pAudio)
         return;
     }
 
-    ma_device_uninit(&pAudio->playbackDevice);
-    ma_context_uninit(&pAudio->internalContext);
-}
\ No newline at end of file
+    if (!pAudio->isOffline) {
+        ma_device_uninit(&pAudio->playbackDevice);  // <-- Stops the device, after which the mixer is no longer being read.
+    }
+
+    ocAudioMixerUninit(&pAudio->mixer);             // <-- Closes any streams that are still playing.
+    ocAudioStreamerUninit(&pAudio->streamer);
+
+    // Nothing is reading from the sounds now.
+    for (size_t iVoice = 0; iVoice < pAudio->soundVoices.count; ++iVoice) {
+        ocResourceLibraryUnload(pAudio->pResourceLibrary, pAudio->soundVoices.pItems[iVoice].pSound);
+    }
+    ocStackUninit(&pAudio->soundVoices);
+
+    if (!pAudio->isOffline) {
+        ma_context_uninit(&pAudio->internalContext);
+    }
+}
+
+void ocAudioRenderOffline(ocAudioContext* pAudio, float* pFramesOut, ocUInt32 frameCount)
+{
+    ocAssert(pAudio != NULL);
+    ocAssert(pAudio->isOffline);
+
+    ocAudioMixerRead(&pAudio->mixer, pFramesOut, frameCount);
+}
+
+void ocAudioUpdate(ocAudioContext* pAudio)
+{
+    if (pAudio == NULL) return;
+
+    // Recycles the voices that have finished since the last update. This is also where their streams are closed.
+    ocAudioMixerUpdate(&pAudio->mixer);
+
+    // A voice is only retired once the audio thread and the streamer are done with it so the sound can be released.
+    size_t iVoice = 0;
+    while (iVoice < pAudio->soundVoices.count) {
+        ocAudioSoundVoice* pVoice = &pAudio->soundVoices.pItems[iVoice];
+        if (ocAudioMixerIsPlaying(&pAudio->mixer, pVoice->voiceID)) {
+            iVoice += 1;
+            continue;
+        }
+
+        ocResourceLibraryUnload(pAudio->pResourceLibrary, pVoice->pSound);
+
+        *pVoice = pAudio->soundVoices.pItems[pAudio->soundVoices.count - 1];    // <-- Order doesn't matter.
+        ocStackPop(&pAudio->soundVoices);
+    }
+}
+
+OC_PRIVATE ocResult ocAudioPlaySoundData(ocAudioContext* pAudio, ocSoundData* pData, const ocAudioVoiceParams* pParams, ocAudioVoiceID* pVoiceID)
+{
+    ocAssert(pAudio != NULL);
+    ocAssert(pData != NULL);
+
+    if (pData->pEncodedData == NULL) {
+        return ocAudioMixerPlay(&pAudio->mixer, &pData->buffer, pParams, pVoiceID);
+    }
+
+    ocAudioStream* pStream;
+    ocResult result = ocAudioStreamOpen(&pAudio->streamer, pData->encoding, pData->pEncodedData, pData->encodedDataSize, (pParams != NULL) ? pParams->looping : OC_FALSE, &pStream);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocAudioMixerPlayStream(&pAudio->mixer, pStream, pParams, pVoiceID);
+    if (result != OC_SUCCESS) {
+        ocAudioStreamClose(pStream);    // <-- The mixer never saw it so it's safe to close straight away.
+        return result;
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocAudioPlaySound(ocAudioContext* pAudio, ocResource* pSound, const ocAudioVoiceParams* pParams, ocAudioVoiceID* pVoiceID)
+{
+    if (pVoiceID == NULL) return OC_INVALID_ARGS;
+    *pVoiceID = OC_AUDIO_VOICE_NONE;
+
+    if (pAudio == NULL || pSound == NULL || pSound->type != ocResourceType_Sound) return OC_INVALID_ARGS;
+
+    if (pAudio->pResourceLibrary == NULL) {
+        return ocAudioPlaySoundData(pAudio, &pSound->sound, pParams, pVoiceID);
+    }
+
+    // The entry is pushed first so that nothing can fail once the voice has started.
+    ocAudioSoundVoice soundVoice;
+    soundVoice.voiceID = OC_AUDIO_VOICE_NONE;
+    soundVoice.pSound  = pSound;
+    ocResult result = ocStackPush(&pAudio->soundVoices, soundVoice);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocAudioPlaySoundData(pAudio, &pSound->sound, pParams, pVoiceID);
+    if (result != OC_SUCCESS) {
+        ocStackPop(&pAudio->soundVoices);
+        return result;
+    }
+
+    ocResourceLibraryAddReference(pAudio->pResourceLibrary, pSound);
+    pAudio->soundVoices.pItems[pAudio->soundVoices.count - 1].voiceID = *pVoiceID;
+
+    return OC_SUCCESS;
+}
@@ -1,14 +1,55 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+struct ocResource;
+struct ocResourceLibrary;
+
+// A voice that's playing a sound resource, and therefore holding a reference to it.
+struct ocAudioSoundVoice
+{
+    ocAudioVoiceID voiceID;
+    ocResource* pSound;
+};
+
 struct ocAudioContext
 {
     ocEngineContext* pEngine;
     ma_context internalContext;
     ma_device playbackDevice;
+    ocAudioMixer mixer;                         // <-- Read from the device's data callback. See ocAudioMixer.hpp for the threading rules.
+    ocAudioStreamer streamer;                   // <-- Decodes streamed sounds in the background.
+    ocBool32 isOffline;                         // <-- Set when there is no device. See ocAudioInitOffline().
+    ocResourceLibrary* pResourceLibrary;        // <-- The library sound references are released to. NULL for offline contexts.
+    ocStack<ocAudioSoundVoice> soundVoices;     // <-- Game thread. Released by ocAudioUpdate() once the mixer has retired the voice.
 };
 
+// Initializes the audio system and starts the playback device.
 //
+// Pass --audio-null on the command line to use miniaudio's null backend, which runs the mixer on a timer without a sound card.
+// Pass --audio-real-voices <count> to change the number of voices that are mixed at the same time. The rest are virtualized.
 ocResult ocAudioInit(ocEngineContext* pEngine, ocAudioContext* pAudio);
 
+// Initializes the audio system without a device, for rendering faster than real time.
+//
+// Nothing reads from the mixer on it's own. Instead ocAudioRenderOffline() is called in place of the device's callback, on whichever
+// thread owns the context. This is used by benchmarks and tests on machines without a sound card. Even miniaudio's null backend can't
+// be used for that since it runs in real time. Streamed sounds are still decoded in the background, so they will underrun when rendering
+// faster than the streamer can keep up.
+ocResult ocAudioInitOffline(ocUInt32 sampleRate, ocUInt32 maxVoices, ocUInt32 maxRealVoices, ocAudioContext* pAudio);
+
 //
 void ocAudioUninit(ocAudioContext* pAudio);
+
+// Renders the next frameCount frames of interleaved stereo f32. This does exactly what the device's callback does. Offline contexts only.
+void ocAudioRenderOffline(ocAudioContext* pAudio, float* pFramesOut, ocUInt32 frameCount);
+
+// Retires the voices that have finished since the last update and releases the sounds they were playing. Game thread only.
+//
+// This is done by ocStep() so you should not normally need to call this directly. Offline contexts must call it themselves.
+void ocAudioUpdate(ocAudioContext* pAudio);
+
+// Plays a sound resource. Short sounds are played straight from their decoded data, and long sounds are streamed. Game thread only.
+//
+// The voice holds a reference to the resource until it has finished, either by reaching the end or by being stopped, and has then been
+// retired by ocAudioUpdate(). The caller's reference can therefore be released while the sound is still playing. Offline contexts don't
+// have a resource library so the resource must stay loaded until the voice has finished.
+ocResult ocAudioPlaySound(ocAudioContext* pAudio, ocResource* pSound, const ocAudioVoiceParams* pParams, ocAudioVoiceID* pVoiceID);
@@ -0,0 +1,186 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+ocAudioEncoding ocAudioEncodingFromPath(const char* filePath)
+{
+    if (filePath == NULL) {
+        return ocAudioEncoding_Unknown;
+    }
+
+    const char* ext = ocPathExtension(filePath);
+    if (_stricmp(ext, "ogg") == 0) {
+        return ocAudioEncoding_Vorbis;
+    }
+    if (_stricmp(ext, "flac") == 0) {
+        return ocAudioEncoding_FLAC;
+    }
+    if (_stricmp(ext, "wav") == 0) {
+        return ocAudioEncoding_WAV;
+    }
+
+    return ocAudioEncoding_Unknown;
+}
+
+ocResult ocAudioDecoderInit(ocAudioEncoding encoding, const void* pData, ocSizeT dataSize, ocAudioDecoder* pDecoder)
+{
+    if (pDecoder == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pDecoder);
+
+    if (pData == NULL || dataSize == 0) return OC_INVALID_ARGS;
+
+    switch (encoding)
+    {
+        case ocAudioEncoding_Vorbis:
+        {
+            if (dataSize > INT_MAX) {
+                return OC_TOO_LARGE;
+            }
+
+            int error;
+            pDecoder->pVorbis = stb_vorbis_open_memory((const unsigned char*)pData, (int)dataSize, &error, NULL);
+            if (pDecoder->pVorbis == NULL) {
+                return OC_CORRUPT_FILE;
+            }
+
+            stb_vorbis_info info = stb_vorbis_get_info(pDecoder->pVorbis);
+            pDecoder->channels   = (ocUInt32)info.channels;
+            pDecoder->sampleRate = (ocUInt32)info.sample_rate;
+            pDecoder->frameCount = stb_vorbis_stream_length_in_samples(pDecoder->pVorbis);
+        } break;
+
+        case ocAudioEncoding_FLAC:
+        {
+            pDecoder->pFLAC = drflac_open_memory(pData, dataSize);
+            if (pDecoder->pFLAC == NULL) {
+                return OC_CORRUPT_FILE;
+            }
+
+            pDecoder->channels   = pDecoder->pFLAC->channels;
+            pDecoder->sampleRate = pDecoder->pFLAC->sampleRate;
+            pDecoder->frameCount = pDecoder->pFLAC->totalPCMFrameCount;
+        } break;
+
+        case ocAudioEncoding_WAV:
+        {
+            pDecoder->pWAV = drwav_open_memory(pData, dataSize);
+            if (pDecoder->pWAV == NULL) {
+                return OC_CORRUPT_FILE;
+            }
+
+            pDecoder->channels   = pDecoder->pWAV->channels;
+            pDecoder->sampleRate = pDecoder->pWAV->sampleRate;
+            pDecoder->frameCount = pDecoder->pWAV->totalPCMFrameCount;
+        } break;
+
+        case ocAudioEncoding_Unknown:
+        default: return OC_INVALID_ARGS;
+    }
+
+    pDecoder->encoding = encoding;
+
+    if (pDecoder->channels == 0 || pDecoder->sampleRate == 0) {
+        ocAudioDecoderUninit(pDecoder);
+        return OC_CORRUPT_FILE;
+    }
+
+    return OC_SUCCESS;
+}
+
+void ocAudioDecoderUninit(ocAudioDecoder* pDecoder)
+{
+    if (pDecoder == NULL) return;
+
+    switch (pDecoder->encoding)
+    {
+        case ocAudioEncoding_Vorbis: stb_vorbis_close(pDecoder->pVorbis); break;
+        case ocAudioEncoding_FLAC:   drflac_close(pDecoder->pFLAC);       break;
+        case ocAudioEncoding_WAV:    drwav_close(pDecoder->pWAV);         break;
+        default: break;
+    }
+
+    ocZeroObject(pDecoder);
+}
+
+ocUInt64 ocAudioDecoderRead(ocAudioDecoder* pDecoder, float* pFramesOut, ocUInt64 frameCount)
+{
+    ocAssert(pDecoder != NULL);
+    ocAssert(pFramesOut != NULL);
+
+    switch (pDecoder->encoding)
+    {
+        case ocAudioEncoding_Vorbis:
+        {
+            // stb_vorbis takes the buffer size as an int so large reads need to be split up.
+            ocUInt64 framesRead = 0;
+            while (framesRead < frameCount) {
+                int floatsToRead = (int)ocMin((frameCount - framesRead) * pDecoder->channels, (ocUInt64)(INT_MAX - (INT_MAX % pDecoder->channels)));
+                int framesJustRead = stb_vorbis_get_samples_float_interleaved(pDecoder->pVorbis, (int)pDecoder->channels, pFramesOut + framesRead*pDecoder->channels, floatsToRead);
+                if (framesJustRead <= 0) {
+                    break;
+                }
+
+                framesRead += (ocUInt64)framesJustRead;
+            }
+
+            return framesRead;
+        }
+
+        case ocAudioEncoding_FLAC: return drflac_read_pcm_frames_f32(pDecoder->pFLAC, frameCount, pFramesOut);
+        case ocAudioEncoding_WAV:  return drwav_read_pcm_frames_f32(pDecoder->pWAV, frameCount, pFramesOut);
+        default: return 0;
+    }
+}
+
+ocResult ocAudioDecoderRewind(ocAudioDecoder* pDecoder)
+{
+    if (pDecoder == NULL) return OC_INVALID_ARGS;
+
+    ocBool32 success;
+    switch (pDecoder->encoding)
+    {
+        case ocAudioEncoding_Vorbis: success = stb_vorbis_seek_start(pDecoder->pVorbis) != 0;  break;
+        case ocAudioEncoding_FLAC:   success = drflac_seek_to_pcm_frame(pDecoder->pFLAC, 0);    break;
+        case ocAudioEncoding_WAV:    success = drwav_seek_to_pcm_frame(pDecoder->pWAV, 0);      break;
+        default: return OC_INVALID_OPERATION;
+    }
+
+    return (success) ? OC_SUCCESS : OC_ERROR;
+}
+
+ocResult ocAudioDecodeAll(ocAudioEncoding encoding, const void* pData, ocSizeT dataSize, float** ppFrames, ocUInt64* pFrameCount, ocUInt32* pChannels, ocUInt32* pSampleRate)
+{
+    if (ppFrames == NULL || pFrameCount == NULL || pChannels == NULL || pSampleRate == NULL) return OC_INVALID_ARGS;
+
+    *ppFrames = NULL;
+    *pFrameCount = 0;
+    *pChannels = 0;
+    *pSampleRate = 0;
+
+    ocAudioDecoder decoder;
+    ocResult result = ocAudioDecoderInit(encoding, pData, dataSize, &decoder);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // The length is known up front for all supported formats, but it comes from the file's header so it's not trusted blindly. The
+    // actual number of frames decoded is what's returned.
+    ocUInt64 dataSizeInBytes = decoder.frameCount * decoder.channels * sizeof(float);
+    if (decoder.frameCount == 0 || dataSizeInBytes > SIZE_MAX) {
+        result = (decoder.frameCount == 0) ? OC_CORRUPT_FILE : OC_TOO_LARGE;
+        ocAudioDecoderUninit(&decoder);
+        return result;
+    }
+
+    float* pFrames = (float*)ocMalloc((ocSizeT)dataSizeInBytes);
+    if (pFrames == NULL) {
+        ocAudioDecoderUninit(&decoder);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    *pFrameCount = ocAudioDecoderRead(&decoder, pFrames, decoder.frameCount);
+    *pChannels   = decoder.channels;
+    *pSampleRate = decoder.sampleRate;
+    *ppFrames    = pFrames;
+
+    ocAudioDecoderUninit(&decoder);
+    return OC_SUCCESS;
+}
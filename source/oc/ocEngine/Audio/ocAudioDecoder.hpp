@@ -0,0 +1,45 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// A common interface over stb_vorbis, dr_flac and dr_wav. Decoders always read from memory and always output interleaved f32. They are
+// not thread-safe, but separate decoders can be used on separate threads, including decoders reading the same data.
+
+enum ocAudioEncoding
+{
+    ocAudioEncoding_Unknown,
+    ocAudioEncoding_Vorbis,
+    ocAudioEncoding_FLAC,
+    ocAudioEncoding_WAV
+};
+
+struct ocAudioDecoder
+{
+    ocAudioEncoding encoding;
+    ocUInt32 channels;
+    ocUInt32 sampleRate;
+    ocUInt64 frameCount;        // <-- The total length in frames.
+
+    union
+    {
+        stb_vorbis* pVorbis;
+        drflac* pFLAC;
+        drwav* pWAV;
+    };
+};
+
+// Retrieves the encoding of an audio file based on it's extension. Returns ocAudioEncoding_Unknown if it's not a supported format.
+ocAudioEncoding ocAudioEncodingFromPath(const char* filePath);
+
+// Initializes a decoder. pData is not copied and must remain valid until the decoder is uninitialized.
+ocResult ocAudioDecoderInit(ocAudioEncoding encoding, const void* pData, ocSizeT dataSize, ocAudioDecoder* pDecoder);
+
+//
+void ocAudioDecoderUninit(ocAudioDecoder* pDecoder);
+
+// Reads up to frameCount frames. Returns the number of frames actually read, which is only less than frameCount at the end.
+ocUInt64 ocAudioDecoderRead(ocAudioDecoder* pDecoder, float* pFramesOut, ocUInt64 frameCount);
+
+// Seeks back to the first frame.
+ocResult ocAudioDecoderRewind(ocAudioDecoder* pDecoder);
+
+// Decodes an entire file into memory. Free the returned frames with ocFree().
+ocResult ocAudioDecodeAll(ocAudioEncoding encoding, const void* pData, ocSizeT dataSize, float** ppFrames, ocUInt64* pFrameCount, ocUInt32* pChannels, ocUInt32* pSampleRate);
@@ -0,0 +1,767 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+OC_INLINE ocUInt32 ocAudioVoiceIDGetSlot(ocAudioVoiceID voiceID)
+{
+    return voiceID & 0xFFFF;
+}
+
+OC_INLINE ocUInt16 ocAudioVoiceIDGetGeneration(ocAudioVoiceID voiceID)
+{
+    return (ocUInt16)(voiceID >> 16);
+}
+
+OC_INLINE ocAudioVoiceID ocAudioMakeVoiceID(ocUInt32 slot, ocUInt16 generation)
+{
+    ocAssert(generation != 0);  // <-- Generation 0 is never used so that an ID can never equal OC_AUDIO_VOICE_NONE.
+    return ((ocUInt32)generation << 16) | slot;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Kernels
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Adds mono frames to stereo frames, ramping the gains linearly from gainL0/gainR0 to gainL1/gainR1 across the frames.
+OC_PRIVATE void ocAudioMix_MonoToStereo(float* pMix, const float* pSrc, ocUInt32 frameCount, float gainL0, float gainR0, float gainL1, float gainR1)
+{
+    float deltaL = (gainL1 - gainL0) / frameCount;
+    float deltaR = (gainR1 - gainR0) / frameCount;
+
+    ocUInt32 iFrame = 0;
+
+#ifdef OC_SUPPORT_SSE2
+    // 4 frames at a time. Each mono sample is duplicated into a left/right pair with unpacklo/unpackhi.
+    __m128 gain0 = _mm_set_ps(gainR0 + deltaR, gainL0 + deltaL, gainR0, gainL0);
+    __m128 gain1 = _mm_add_ps(gain0, _mm_set_ps(deltaR*2, deltaL*2, deltaR*2, deltaL*2));
+    __m128 gainStep = _mm_set_ps(deltaR*4, deltaL*4, deltaR*4, deltaL*4);
+
+    for (; iFrame + 4 <= frameCount; iFrame += 4) {
+        __m128 x   = _mm_loadu_ps(pSrc + iFrame);
+        __m128 xlo = _mm_unpacklo_ps(x, x);
+        __m128 xhi = _mm_unpackhi_ps(x, x);
+
+        float* pOut = pMix + iFrame*2;
+        _mm_storeu_ps(pOut + 0, _mm_add_ps(_mm_loadu_ps(pOut + 0), _mm_mul_ps(xlo, gain0)));
+        _mm_storeu_ps(pOut + 4, _mm_add_ps(_mm_loadu_ps(pOut + 4), _mm_mul_ps(xhi, gain1)));
+
+        gain0 = _mm_add_ps(gain0, gainStep);
+        gain1 = _mm_add_ps(gain1, gainStep);
+    }
+#endif
+
+    for (; iFrame < frameCount; ++iFrame) {
+        float x = pSrc[iFrame];
+        pMix[iFrame*2 + 0] += x * (gainL0 + deltaL*iFrame);
+        pMix[iFrame*2 + 1] += x * (gainR0 + deltaR*iFrame);
+    }
+}
+
+// Adds stereo frames to stereo frames, ramping the gains linearly from gainL0/gainR0 to gainL1/gainR1 across the frames.
+OC_PRIVATE void ocAudioMix_StereoToStereo(float* pMix, const float* pSrc, ocUInt32 frameCount, float gainL0, float gainR0, float gainL1, float gainR1)
+{
+    float deltaL = (gainL1 - gainL0) / frameCount;
+    float deltaR = (gainR1 - gainR0) / frameCount;
+
+    ocUInt32 iFrame = 0;
+
+#ifdef OC_SUPPORT_SSE2
+    // 4 frames at a time. The samples are already in left/right pairs so they line up with the gains as-is.
+    __m128 gain0 = _mm_set_ps(gainR0 + deltaR, gainL0 + deltaL, gainR0, gainL0);
+    __m128 gain1 = _mm_add_ps(gain0, _mm_set_ps(deltaR*2, deltaL*2, deltaR*2, deltaL*2));
+    __m128 gainStep = _mm_set_ps(deltaR*4, deltaL*4, deltaR*4, deltaL*4);
+
+    for (; iFrame + 4 <= frameCount; iFrame += 4) {
+        const float* pIn = pSrc + iFrame*2;
+        float* pOut = pMix + iFrame*2;
+        _mm_storeu_ps(pOut + 0, _mm_add_ps(_mm_loadu_ps(pOut + 0), _mm_mul_ps(_mm_loadu_ps(pIn + 0), gain0)));
+        _mm_storeu_ps(pOut + 4, _mm_add_ps(_mm_loadu_ps(pOut + 4), _mm_mul_ps(_mm_loadu_ps(pIn + 4), gain1)));
+
+        gain0 = _mm_add_ps(gain0, gainStep);
+        gain1 = _mm_add_ps(gain1, gainStep);
+    }
+#endif
+
+    for (; iFrame < frameCount; ++iFrame) {
+        pMix[iFrame*2 + 0] += pSrc[iFrame*2 + 0] * (gainL0 + deltaL*iFrame);
+        pMix[iFrame*2 + 1] += pSrc[iFrame*2 + 1] * (gainR0 + deltaR*iFrame);
+    }
+}
+
+// Copies samples, clamping them to [-1, 1].
+OC_PRIVATE void ocAudioCopyClamped(float* pDst, const float* pSrc, ocUInt32 sampleCount)
+{
+    ocUInt32 iSample = 0;
+
+#ifdef OC_SUPPORT_SSE2
+    __m128 lo = _mm_set1_ps(-1);
+    __m128 hi = _mm_set1_ps(+1);
+    for (; iSample + 4 <= sampleCount; iSample += 4) {
+        _mm_storeu_ps(pDst + iSample, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pSrc + iSample), lo), hi));
+    }
+#endif
+
+    for (; iSample < sampleCount; ++iSample) {
+        pDst[iSample] = ocClamp(pSrc[iSample], -1.0f, 1.0f);
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Voices
+//
+///////////////////////////////////////////////////////////////////////////////
+
+OC_PRIVATE void ocAudioVoiceCalculateGains(const ocAudioVoice* pVoice, float* pGainL, float* pGainR)
+{
+    float gain = pVoice->params.gain;
+    float pan  = ocClamp(pVoice->params.pan, -1.0f, 1.0f);
+
+    if (pVoice->buffer.channels == 1) {
+        float angle = (pan + 1) * 0.785398163f;    // <-- pi/4. 0 is hard left, pi/2 is hard right.
+        *pGainL = gain * cosf(angle);
+        *pGainR = gain * sinf(angle);
+    } else {
+        *pGainL = gain * ocMin(1.0f, 1 - pan);
+        *pGainR = gain * ocMin(1.0f, 1 + pan);
+    }
+}
+
+OC_INLINE double ocAudioVoiceGetStep(const ocAudioMixer* pMixer, const ocAudioVoice* pVoice)
+{
+    return ((double)ocMax(pVoice->params.pitch, 0.0f) * pVoice->buffer.sampleRate) / pMixer->sampleRate;    // <-- Playing backwards is not supported.
+}
+
+// Retrieves the next frameCount frames of a voice, advancing the cursor. When the voice is playing at the mixer's rate and the frames
+// are contiguous in the buffer, a pointer to the buffer itself is returned. Otherwise the frames are read into pScratch. Returns the
+// number of frames that were available in pFramesRead, which is only less than frameCount when a non-looping voice reaches the end.
+OC_PRIVATE const float* ocAudioVoiceAcquireFrames(ocAudioVoice* pVoice, double step, float* pScratch, ocUInt32 frameCount, ocUInt32* pFramesRead)
+{
+    const ocUInt32 channels = pVoice->buffer.channels;
+    const ocUInt64 srcFrameCount = pVoice->buffer.frameCount;
+    const float* pSrc = pVoice->buffer.pFrames;
+
+    ocUInt32 framesRead = 0;
+
+    if (step == 1.0 && pVoice->cursor == (double)(ocUInt64)pVoice->cursor) {
+        // Fast path. No resampling.
+        ocUInt64 srcIndex = (ocUInt64)pVoice->cursor;
+        if (srcIndex + frameCount <= srcFrameCount) {
+            pVoice->cursor += frameCount;
+            if (pVoice->cursor == (double)srcFrameCount && pVoice->params.looping) {
+                pVoice->cursor = 0;
+            }
+
+            *pFramesRead = frameCount;
+            return pSrc + srcIndex*channels;
+        }
+
+        // Crosses the end of the buffer.
+        while (framesRead < frameCount && srcIndex < srcFrameCount) {
+            ocUInt32 framesToCopy = (ocUInt32)ocMin((ocUInt64)(frameCount - framesRead), srcFrameCount - srcIndex);
+            ocCopyMemory(pScratch + framesRead*channels, pSrc + srcIndex*channels, framesToCopy*channels*sizeof(float));
+            framesRead += framesToCopy;
+            srcIndex   += framesToCopy;
+
+            if (srcIndex == srcFrameCount && pVoice->params.looping) {
+                srcIndex = 0;
+            }
+        }
+
+        pVoice->cursor = (double)srcIndex;
+    } else {
+        // Linear interpolation. The last frame is held when interpolating past the end of a non-looping buffer.
+        double cursor = pVoice->cursor;
+        for (; framesRead < frameCount; ++framesRead) {
+            if (cursor >= srcFrameCount) {
+                if (!pVoice->params.looping) {
+                    break;
+                }
+                cursor = fmod(cursor, (double)srcFrameCount);
+            }
+
+            ocUInt64 srcIndex0 = (ocUInt64)cursor;
+            ocUInt64 srcIndex1 = srcIndex0 + 1;
+            if (srcIndex1 == srcFrameCount) {
+                srcIndex1 = (pVoice->params.looping) ? 0 : srcIndex0;
+            }
+
+            float t = (float)(cursor - srcIndex0);
+            for (ocUInt32 iChannel = 0; iChannel < channels; ++iChannel) {
+                float s0 = pSrc[srcIndex0*channels + iChannel];
+                float s1 = pSrc[srcIndex1*channels + iChannel];
+                pScratch[framesRead*channels + iChannel] = s0 + (s1 - s0)*t;
+            }
+
+            cursor += step;
+        }
+
+        pVoice->cursor = cursor;
+    }
+
+    *pFramesRead = framesRead;
+    return pScratch;
+}
+
+// Gives every frame before the cursor back to the stream. Frames are only consumed once they've become available, so the cursor can
+// end up ahead of the stream when it underruns. It catches up once the streamer does.
+OC_PRIVATE void ocAudioVoiceConsumeStreamFrames(ocAudioVoice* pVoice, ocUInt32 framesAvailable)
+{
+    ocUInt32 framesConsumed = (ocUInt32)ocMin(pVoice->cursor, (double)framesAvailable);
+    pVoice->cursor -= framesConsumed;
+    ocAudioStreamConsume(pVoice->pStream, framesConsumed);
+}
+
+// The streamed equivalent of ocAudioVoiceAcquireFrames(). Frames are read from the stream's ring buffer, which means they're always
+// copied. *pIsAtEnd is set when the stream has ended and every frame has been read. Running out of frames before then is an underrun.
+OC_PRIVATE const float* ocAudioVoiceAcquireStreamFrames(ocAudioVoice* pVoice, double step, float* pScratch, ocUInt32 frameCount, ocUInt32* pFramesRead, ocBool32* pIsAtEnd)
+{
+    ocAudioStream* pStream = pVoice->pStream;
+    const ocUInt32 channels = pStream->channels;
+    const ocUInt32 mask = OC_AUDIO_STREAM_BUFFER_SIZE - 1;
+
+    // The end flag must be loaded before the write index. If it's set, every frame is guaranteed to be visible.
+    ocBool32 isAtEnd = ocAtomicLoad(&pStream->isAtEnd);
+    ocUInt32 framesAvailable = ocAudioStreamGetAvailableFrames(pStream);
+    ocUInt32 readIndex = pStream->readIndex;
+
+    ocUInt32 framesRead = 0;
+
+    if (step == 1.0 && pVoice->cursor == 0) {
+        // Fast path. No resampling, but the ring buffer may wrap around so it's done in up to two pieces.
+        while (framesRead < frameCount && framesRead < framesAvailable) {
+            ocUInt32 offset = (readIndex + framesRead) & mask;
+            ocUInt32 framesToCopy = ocMin(ocMin(frameCount, framesAvailable) - framesRead, OC_AUDIO_STREAM_BUFFER_SIZE - offset);
+            ocCopyMemory(pScratch + framesRead*channels, pStream->pFrames + offset*channels, framesToCopy*channels*sizeof(float));
+            framesRead += framesToCopy;
+        }
+
+        pVoice->cursor = framesRead;
+    } else {
+        // Linear interpolation. The next frame needs to be available too, unless it's the last frame of the stream in which case it's held.
+        double cursor = pVoice->cursor;
+        for (; framesRead < frameCount; ++framesRead) {
+            ocUInt32 srcIndex0 = (ocUInt32)cursor;
+            ocUInt32 srcIndex1 = srcIndex0 + 1;
+            if (srcIndex1 >= framesAvailable) {
+                if (!isAtEnd || srcIndex0 >= framesAvailable) {
+                    break;
+                }
+                srcIndex1 = srcIndex0;
+            }
+
+            const float* pSrc0 = pStream->pFrames + ((readIndex + srcIndex0) & mask)*channels;
+            const float* pSrc1 = pStream->pFrames + ((readIndex + srcIndex1) & mask)*channels;
+
+            float t = (float)(cursor - srcIndex0);
+            for (ocUInt32 iChannel = 0; iChannel < channels; ++iChannel) {
+                pScratch[framesRead*channels + iChannel] = pSrc0[iChannel] + (pSrc1[iChannel] - pSrc0[iChannel])*t;
+            }
+
+            cursor += step;
+        }
+
+        pVoice->cursor = cursor;
+    }
+
+    ocAudioVoiceConsumeStreamFrames(pVoice, framesAvailable);
+
+    *pFramesRead = framesRead;
+    *pIsAtEnd = isAtEnd && framesRead < frameCount;
+    return pScratch;
+}
+
+// Advances a virtual voice without reading any of it's data. Returns OC_FALSE if a non-looping voice reaches the end.
+OC_PRIVATE ocBool32 ocAudioVoiceSkipFrames(ocAudioVoice* pVoice, double step, ocUInt32 frameCount)
+{
+    if (pVoice->pStream != NULL) {
+        // The frames still need to be consumed so the streamer keeps going.
+        ocBool32 isAtEnd = ocAtomicLoad(&pVoice->pStream->isAtEnd);
+        ocUInt32 framesAvailable = ocAudioStreamGetAvailableFrames(pVoice->pStream);
+
+        pVoice->cursor += step * frameCount;
+        if (isAtEnd && pVoice->cursor >= framesAvailable) {
+            return OC_FALSE;
+        }
+
+        ocAudioVoiceConsumeStreamFrames(pVoice, framesAvailable);
+        return OC_TRUE;
+    }
+
+    pVoice->cursor += step * frameCount;
+    if (pVoice->cursor >= pVoice->buffer.frameCount) {
+        if (!pVoice->params.looping) {
+            return OC_FALSE;
+        }
+        pVoice->cursor = fmod(pVoice->cursor, (double)pVoice->buffer.frameCount);
+    }
+
+    return OC_TRUE;
+}
+
+OC_PRIVATE ocUInt64 ocAudioVoiceGetRankKey(const ocAudioVoice* pVoice)
+{
+    // Gains are positive so their bit patterns sort in the same order as their values.
+    float gain = ocMax(pVoice->params.gain, 0.0f);
+    ocUInt32 gainBits;
+    ocCopyMemory(&gainBits, &gain, sizeof(gainBits));
+
+    ocUInt32 priorityBits = (ocUInt32)pVoice->params.priority ^ 0x80000000;    // <-- Signed to unsigned, preserving order.
+    return ((ocUInt64)priorityBits << 32) | gainBits;
+}
+
+OC_PRIVATE bool ocAudioVoiceRankGreater(const ocAudioVoiceRank &a, const ocAudioVoiceRank &b)
+{
+    return a.key > b.key;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Mixer
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocAudioVoiceParams ocAudioVoiceParamsInit()
+{
+    ocAudioVoiceParams params;
+    params.gain     = 1;
+    params.pan      = 0;
+    params.pitch    = 1;
+    params.priority = 0;
+    params.looping  = OC_FALSE;
+
+    return params;
+}
+
+ocResult ocAudioMixerInit(ocUInt32 sampleRate, ocUInt32 maxVoices, ocUInt32 maxRealVoices, ocAudioMixer* pMixer)
+{
+    if (pMixer == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pMixer);
+
+    if (sampleRate == 0 || maxVoices == 0 || maxVoices > OC_AUDIO_MAX_VOICES) return OC_INVALID_ARGS;
+
+    pMixer->sampleRate    = sampleRate;
+    pMixer->maxVoices     = maxVoices;
+    pMixer->maxRealVoices = ocMin(ocMax(maxRealVoices, 1U), maxVoices);
+
+    // The event queue is big enough for every voice to finish at once. A slot can't finish again until it's been reused, which only
+    // happens after it's event has been processed, so the audio thread never has to drop an event.
+    ocUInt32 eventCapacity = 1;
+    while (eventCapacity < maxVoices) {
+        eventCapacity *= 2;
+    }
+
+    ocResult result = ocSPSCQueueInit(OC_AUDIO_COMMAND_QUEUE_CAPACITY, &pMixer->commands);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocSPSCQueueInit(eventCapacity, &pMixer->events);
+    if (result != OC_SUCCESS) {
+        goto done;
+    }
+
+    ocStackInit(&pMixer->freeSlots);
+
+    pMixer->pVoices       = (ocAudioVoice*)ocCalloc(maxVoices, sizeof(*pMixer->pVoices));
+    pMixer->pGenerations  = (ocUInt16*)ocCalloc(maxVoices, sizeof(*pMixer->pGenerations));
+    pMixer->ppStreams     = (ocAudioStream**)ocCalloc(maxVoices, sizeof(*pMixer->ppStreams));
+    pMixer->pActiveSlots  = (ocUInt32*)ocCalloc(maxVoices, sizeof(*pMixer->pActiveSlots));
+    pMixer->pRanks        = (ocAudioVoiceRank*)ocCalloc(maxVoices, sizeof(*pMixer->pRanks));
+    pMixer->pMixBuffer    = (float*)ocCalloc(OC_AUDIO_MIXER_BLOCK_SIZE * OC_AUDIO_MIXER_CHANNELS, sizeof(float));
+    pMixer->pSourceBuffer = (float*)ocCalloc(OC_AUDIO_MIXER_BLOCK_SIZE * 2, sizeof(float));
+    if (pMixer->pVoices == NULL || pMixer->pGenerations == NULL || pMixer->ppStreams == NULL || pMixer->pActiveSlots == NULL || pMixer->pRanks == NULL || pMixer->pMixBuffer == NULL || pMixer->pSourceBuffer == NULL) {
+        result = OC_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    // Slots are pushed in reverse so that the lowest ones are used first.
+    for (ocUInt32 iSlot = maxVoices; iSlot > 0; --iSlot) {
+        pMixer->pGenerations[iSlot-1] = 1;
+        result = ocStackPush(&pMixer->freeSlots, iSlot-1);
+        if (result != OC_SUCCESS) {
+            goto done;
+        }
+    }
+
+done:
+    if (result != OC_SUCCESS) {
+        ocAudioMixerUninit(pMixer);
+    }
+
+    return result;
+}
+
+void ocAudioMixerUninit(ocAudioMixer* pMixer)
+{
+    if (pMixer == NULL) return;
+
+    if (pMixer->ppStreams != NULL) {
+        for (ocUInt32 iSlot = 0; iSlot < pMixer->maxVoices; ++iSlot) {
+            ocAudioStreamClose(pMixer->ppStreams[iSlot]);
+        }
+    }
+
+    ocFree(pMixer->pSourceBuffer);
+    ocFree(pMixer->pMixBuffer);
+    ocFree(pMixer->pRanks);
+    ocFree(pMixer->pActiveSlots);
+    ocFree(pMixer->ppStreams);
+    ocFree(pMixer->pGenerations);
+    ocFree(pMixer->pVoices);
+    ocStackUninit(&pMixer->freeSlots);
+    ocSPSCQueueUninit(&pMixer->events);
+    ocSPSCQueueUninit(&pMixer->commands);
+    ocZeroObject(pMixer);
+}
+
+
+OC_PRIVATE ocResult ocAudioMixerPostCommand(ocAudioMixer* pMixer, ocAudioCommandType type, ocAudioVoiceID voiceID, float value)
+{
+    if (pMixer == NULL) return OC_INVALID_ARGS;
+
+    if (voiceID == OC_AUDIO_VOICE_NONE) {
+        return OC_SUCCESS;
+    }
+
+    ocAudioCommand command;
+    ocZeroObject(&command);
+    command.type       = type;
+    command.voiceID    = voiceID;
+    command.data.value = value;
+
+    return ocSPSCQueuePush(&pMixer->commands, command);
+}
+
+OC_PRIVATE ocResult ocAudioMixerPostPlay(ocAudioMixer* pMixer, const ocAudioBuffer* pBuffer, ocAudioStream* pStream, const ocAudioVoiceParams* pParams, ocAudioVoiceID* pVoiceID)
+{
+    ocUInt32 slot;
+    if (ocStackTop(&pMixer->freeSlots, &slot) != OC_SUCCESS) {
+        return OC_TOO_MANY_VOICES;
+    }
+
+    ocAudioCommand command;
+    ocZeroObject(&command);
+    command.type              = ocAudioCommandType_Play;
+    command.voiceID           = ocAudioMakeVoiceID(slot, pMixer->pGenerations[slot]);
+    command.data.play.buffer  = *pBuffer;
+    command.data.play.pStream = pStream;
+    command.data.play.params  = (pParams != NULL) ? *pParams : ocAudioVoiceParamsInit();
+
+    // The slot is only taken once the command has been posted. If the queue is full the audio thread never knows about the voice.
+    ocResult result = ocSPSCQueuePush(&pMixer->commands, command);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocStackPop(&pMixer->freeSlots);
+    pMixer->ppStreams[slot] = pStream;
+
+    *pVoiceID = command.voiceID;
+    return OC_SUCCESS;
+}
+
+ocResult ocAudioMixerPlay(ocAudioMixer* pMixer, const ocAudioBuffer* pBuffer, const ocAudioVoiceParams* pParams, ocAudioVoiceID* pVoiceID)
+{
+    if (pVoiceID == NULL) return OC_INVALID_ARGS;
+    *pVoiceID = OC_AUDIO_VOICE_NONE;
+
+    if (pMixer == NULL || pBuffer == NULL || pBuffer->pFrames == NULL || pBuffer->frameCount == 0 || pBuffer->sampleRate == 0) return OC_INVALID_ARGS;
+    if (pBuffer->channels != 1 && pBuffer->channels != 2) return OC_INVALID_ARGS;
+
+    return ocAudioMixerPostPlay(pMixer, pBuffer, NULL, pParams, pVoiceID);
+}
+
+ocResult ocAudioMixerPlayStream(ocAudioMixer* pMixer, ocAudioStream* pStream, const ocAudioVoiceParams* pParams, ocAudioVoiceID* pVoiceID)
+{
+    if (pVoiceID == NULL) return OC_INVALID_ARGS;
+    *pVoiceID = OC_AUDIO_VOICE_NONE;
+
+    if (pMixer == NULL || pStream == NULL) return OC_INVALID_ARGS;
+
+    // Only the format of the buffer is used. The frames come from the stream.
+    ocAudioBuffer buffer;
+    buffer.pFrames    = NULL;
+    buffer.frameCount = 0;
+    buffer.channels   = pStream->channels;
+    buffer.sampleRate = pStream->sampleRate;
+
+    ocAudioVoiceParams params = (pParams != NULL) ? *pParams : ocAudioVoiceParamsInit();
+    params.looping = pStream->isLooping;
+
+    return ocAudioMixerPostPlay(pMixer, &buffer, pStream, &params, pVoiceID);
+}
+
+ocResult ocAudioMixerStop(ocAudioMixer* pMixer, ocAudioVoiceID voiceID)
+{
+    return ocAudioMixerPostCommand(pMixer, ocAudioCommandType_Stop, voiceID, 0);
+}
+
+ocResult ocAudioMixerSetGain(ocAudioMixer* pMixer, ocAudioVoiceID voiceID, float gain)
+{
+    return ocAudioMixerPostCommand(pMixer, ocAudioCommandType_SetGain, voiceID, gain);
+}
+
+ocResult ocAudioMixerSetPan(ocAudioMixer* pMixer, ocAudioVoiceID voiceID, float pan)
+{
+    return ocAudioMixerPostCommand(pMixer, ocAudioCommandType_SetPan, voiceID, pan);
+}
+
+ocResult ocAudioMixerSetPitch(ocAudioMixer* pMixer, ocAudioVoiceID voiceID, float pitch)
+{
+    return ocAudioMixerPostCommand(pMixer, ocAudioCommandType_SetPitch, voiceID, pitch);
+}
+
+ocResult ocAudioMixerSetSpatial(ocAudioMixer* pMixer, ocAudioVoiceID voiceID, float gain, float pan, float pitch)
+{
+    if (pMixer == NULL) return OC_INVALID_ARGS;
+
+    if (voiceID == OC_AUDIO_VOICE_NONE) {
+        return OC_SUCCESS;
+    }
+
+    ocAudioCommand command;
+    ocZeroObject(&command);
+    command.type               = ocAudioCommandType_SetSpatial;
+    command.voiceID            = voiceID;
+    command.data.spatial.gain  = gain;
+    command.data.spatial.pan   = pan;
+    command.data.spatial.pitch = pitch;
+
+    return ocSPSCQueuePush(&pMixer->commands, command);
+}
+
+ocBool32 ocAudioMixerIsPlaying(ocAudioMixer* pMixer, ocAudioVoiceID voiceID)
+{
+    if (pMixer == NULL || voiceID == OC_AUDIO_VOICE_NONE) return OC_FALSE;
+
+    ocUInt32 slot = ocAudioVoiceIDGetSlot(voiceID);
+    if (slot >= pMixer->maxVoices) {
+        return OC_FALSE;
+    }
+
+    return pMixer->pGenerations[slot] == ocAudioVoiceIDGetGeneration(voiceID);
+}
+
+void ocAudioMixerUpdate(ocAudioMixer* pMixer)
+{
+    if (pMixer == NULL) return;
+
+    ocAudioEvent e;
+    while (ocSPSCQueuePop(&pMixer->events, &e)) {
+        if (e.type == ocAudioEventType_VoiceFinished) {
+            ocUInt32 slot = ocAudioVoiceIDGetSlot(e.voiceID);
+
+            // Retire the ID before the slot can be reused. Generation 0 is skipped when wrapping.
+            pMixer->pGenerations[slot] += 1;
+            if (pMixer->pGenerations[slot] == 0) {
+                pMixer->pGenerations[slot] = 1;
+            }
+
+            // The audio thread is done with the stream now so it's safe to close.
+            if (pMixer->ppStreams[slot] != NULL) {
+                ocAudioStreamClose(pMixer->ppStreams[slot]);
+                pMixer->ppStreams[slot] = NULL;
+            }
+
+            ocStackPush(&pMixer->freeSlots, slot);  // <-- Can't fail. The stack's capacity was reserved for every slot at initialization time.
+        }
+    }
+}
+
+
+OC_PRIVATE ocAudioVoice* ocAudioMixerFindVoice(ocAudioMixer* pMixer, ocAudioVoiceID voiceID)
+{
+    ocAudioVoice* pVoice = &pMixer->pVoices[ocAudioVoiceIDGetSlot(voiceID)];
+    if (pVoice->id != voiceID || pVoice->isFinished) {
+        return NULL;    // <-- Stale ID.
+    }
+
+    return pVoice;
+}
+
+OC_PRIVATE void ocAudioMixerProcessCommands(ocAudioMixer* pMixer)
+{
+    ocAudioCommand command;
+    while (ocSPSCQueuePop(&pMixer->commands, &command)) {
+        if (command.type == ocAudioCommandType_Play) {
+            ocUInt32 slot = ocAudioVoiceIDGetSlot(command.voiceID);
+
+            ocAudioVoice* pVoice = &pMixer->pVoices[slot];
+            ocZeroObject(pVoice);
+            pVoice->id      = command.voiceID;
+            pVoice->buffer  = command.data.play.buffer;
+            pVoice->pStream = command.data.play.pStream;
+            pVoice->params  = command.data.play.params;
+            pVoice->isReal = OC_TRUE;   // <-- New voices start at their full gain rather than ramping in.
+            ocAudioVoiceCalculateGains(pVoice, &pVoice->currentGainL, &pVoice->currentGainR);
+
+            pMixer->pActiveSlots[pMixer->activeSlotCount] = slot;
+            pMixer->activeSlotCount += 1;
+            continue;
+        }
+
+        ocAudioVoice* pVoice = ocAudioMixerFindVoice(pMixer, command.voiceID);
+        if (pVoice == NULL) {
+            continue;
+        }
+
+        switch (command.type)
+        {
+            case ocAudioCommandType_Stop:     pVoice->isFinished   = OC_TRUE;            break;
+            case ocAudioCommandType_SetGain:  pVoice->params.gain  = command.data.value; break;
+            case ocAudioCommandType_SetPan:   pVoice->params.pan   = command.data.value; break;
+            case ocAudioCommandType_SetPitch: pVoice->params.pitch = command.data.value; break;
+            case ocAudioCommandType_SetSpatial:
+            {
+                pVoice->params.gain  = command.data.spatial.gain;
+                pVoice->params.pan   = command.data.spatial.pan;
+                pVoice->params.pitch = command.data.spatial.pitch;
+            } break;
+            default: break;
+        }
+    }
+}
+
+// Marks the maxRealVoices most important voices as real and the rest as virtual.
+OC_PRIVATE void ocAudioMixerSelectRealVoices(ocAudioMixer* pMixer)
+{
+    ocUInt32 activeSlotCount = pMixer->activeSlotCount;
+
+    if (activeSlotCount <= pMixer->maxRealVoices) {
+        for (ocUInt32 iActive = 0; iActive < activeSlotCount; ++iActive) {
+            ocAudioVoice* pVoice = &pMixer->pVoices[pMixer->pActiveSlots[iActive]];
+            if (!pVoice->isReal) {
+                pVoice->currentGainL = 0;   // <-- Ramp in from silence when coming back from being virtual.
+                pVoice->currentGainR = 0;
+                pVoice->isReal = OC_TRUE;
+            }
+        }
+
+        pMixer->realVoiceCount    = activeSlotCount;
+        pMixer->virtualVoiceCount = 0;
+        return;
+    }
+
+    for (ocUInt32 iActive = 0; iActive < activeSlotCount; ++iActive) {
+        ocUInt32 slot = pMixer->pActiveSlots[iActive];
+        pMixer->pRanks[iActive].key  = ocAudioVoiceGetRankKey(&pMixer->pVoices[slot]);
+        pMixer->pRanks[iActive].slot = slot;
+    }
+
+    // Only a partition is needed, not a full sort. This doesn't allocate.
+    std::nth_element(pMixer->pRanks, pMixer->pRanks + pMixer->maxRealVoices, pMixer->pRanks + activeSlotCount, ocAudioVoiceRankGreater);
+
+    for (ocUInt32 iRank = 0; iRank < activeSlotCount; ++iRank) {
+        ocAudioVoice* pVoice = &pMixer->pVoices[pMixer->pRanks[iRank].slot];
+        if (iRank < pMixer->maxRealVoices) {
+            if (!pVoice->isReal) {
+                pVoice->currentGainL = 0;
+                pVoice->currentGainR = 0;
+                pVoice->isReal = OC_TRUE;
+            }
+        } else {
+            pVoice->isReal = OC_FALSE;
+        }
+    }
+
+    pMixer->realVoiceCount    = pMixer->maxRealVoices;
+    pMixer->virtualVoiceCount = activeSlotCount - pMixer->maxRealVoices;
+}
+
+OC_PRIVATE void ocAudioMixerMixBlock(ocAudioMixer* pMixer, float* pFramesOut, ocUInt32 frameCount)
+{
+    ocAssert(frameCount <= OC_AUDIO_MIXER_BLOCK_SIZE);
+
+    ocAudioMixerSelectRealVoices(pMixer);
+
+    ocZeroMemory(pMixer->pMixBuffer, frameCount * OC_AUDIO_MIXER_CHANNELS * sizeof(float));
+
+    for (ocUInt32 iActive = 0; iActive < pMixer->activeSlotCount; ++iActive) {
+        ocAudioVoice* pVoice = &pMixer->pVoices[pMixer->pActiveSlots[iActive]];
+        if (pVoice->isFinished) {
+            continue;   // <-- Stopped by a command.
+        }
+
+        double step = ocAudioVoiceGetStep(pMixer, pVoice);
+
+        if (!pVoice->isReal) {
+            if (!ocAudioVoiceSkipFrames(pVoice, step, frameCount)) {
+                pVoice->isFinished = OC_TRUE;
+            }
+            continue;
+        }
+
+        ocUInt32 framesRead;
+        ocBool32 isAtEnd;
+        const float* pSrc;
+        if (pVoice->pStream != NULL) {
+            pSrc = ocAudioVoiceAcquireStreamFrames(pVoice, step, pMixer->pSourceBuffer, frameCount, &framesRead, &isAtEnd);
+
+            // A stream that hasn't received it's first frames yet is still starting up, which isn't counted as an underrun.
+            if (!isAtEnd && framesRead < frameCount && ocAtomicLoad(&pVoice->pStream->writeIndex) > 0) {
+                pMixer->underrunCount += 1;
+            }
+        } else {
+            pSrc = ocAudioVoiceAcquireFrames(pVoice, step, pMixer->pSourceBuffer, frameCount, &framesRead);
+            isAtEnd = framesRead < frameCount;
+        }
+
+        float gainL;
+        float gainR;
+        ocAudioVoiceCalculateGains(pVoice, &gainL, &gainR);
+
+        if (framesRead > 0) {
+            if (pVoice->buffer.channels == 1) {
+                ocAudioMix_MonoToStereo(pMixer->pMixBuffer, pSrc, framesRead, pVoice->currentGainL, pVoice->currentGainR, gainL, gainR);
+            } else {
+                ocAudioMix_StereoToStereo(pMixer->pMixBuffer, pSrc, framesRead, pVoice->currentGainL, pVoice->currentGainR, gainL, gainR);
+            }
+        }
+
+        pVoice->currentGainL = gainL;
+        pVoice->currentGainR = gainR;
+
+        if (isAtEnd) {
+            pVoice->isFinished = OC_TRUE;
+        }
+    }
+
+    ocAudioCopyClamped(pFramesOut, pMixer->pMixBuffer, frameCount * OC_AUDIO_MIXER_CHANNELS);
+
+    // Finished voices are removed from the active list and handed back to the game thread.
+    for (ocUInt32 iActive = 0; iActive < pMixer->activeSlotCount; /* Incremented in the loop. */) {
+        ocAudioVoice* pVoice = &pMixer->pVoices[pMixer->pActiveSlots[iActive]];
+        if (!pVoice->isFinished) {
+            iActive += 1;
+            continue;
+        }
+
+        ocAudioEvent e;
+        e.type    = ocAudioEventType_VoiceFinished;
+        e.voiceID = pVoice->id;
+        ocSPSCQueuePush(&pMixer->events, e);    // <-- Can't fail. See ocAudioMixerInit().
+
+        pVoice->id = OC_AUDIO_VOICE_NONE;
+        pMixer->pActiveSlots[iActive] = pMixer->pActiveSlots[pMixer->activeSlotCount-1];
+        pMixer->activeSlotCount -= 1;
+    }
+}
+
+void ocAudioMixerRead(ocAudioMixer* pMixer, float* pFramesOut, ocUInt32 frameCount)
+{
+    ocAssert(pMixer != NULL);
+    ocAssert(pFramesOut != NULL);
+
+    ocAudioMixerProcessCommands(pMixer);
+
+    ocUInt32 framesMixed = 0;
+    while (framesMixed < frameCount) {
+        ocUInt32 framesToMix = ocMin(frameCount - framesMixed, (ocUInt32)OC_AUDIO_MIXER_BLOCK_SIZE);
+        ocAudioMixerMixBlock(pMixer, pFramesOut + framesMixed*OC_AUDIO_MIXER_CHANNELS, framesToMix);
+        framesMixed += framesToMix;
+    }
+}
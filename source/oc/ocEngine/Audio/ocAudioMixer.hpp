@@ -0,0 +1,185 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// The mixer runs on the audio thread, inside the device's data callback. The game thread never touches the voices directly. Instead it
+// posts commands to a lock-free queue which the audio thread drains at the start of each callback, and the audio thread posts events
+// back the other way when a voice finishes. Nothing on the audio thread allocates, locks or waits.
+//
+// Voices are identified by an ocAudioVoiceID which is made up of a slot index and a generation. The game thread owns the allocation of
+// slots, and a slot is only reused once the audio thread has reported that the voice in it has finished. IDs of finished voices are
+// therefore never confused with new ones, and commands referring to them are just ignored.
+//
+// Only the maxRealVoices most important voices are actually mixed. The rest are virtual - they keep their position up to date so they
+// can be brought back seamlessly, but cost next to nothing. Importance is determined by priority, and then by gain.
+//
+// A voice either plays an ocAudioBuffer that's entirely in memory, or an ocAudioStream that's decoded in the background. See
+// ocAudioStreamer.hpp.
+
+#define OC_AUDIO_MIXER_CHANNELS             2       // <-- The mixer always outputs interleaved stereo.
+#define OC_AUDIO_MIXER_BLOCK_SIZE           256     // <-- In frames. Callbacks are processed in blocks of this size. Gain changes are ramped across a block.
+#define OC_AUDIO_DEFAULT_MAX_VOICES         1024
+#define OC_AUDIO_DEFAULT_MAX_REAL_VOICES    64
+#define OC_AUDIO_COMMAND_QUEUE_CAPACITY     1024    // <-- Must be a power of 2.
+#define OC_AUDIO_MAX_VOICES                 65536   // <-- The slot index is stored in the low 16 bits of an ocAudioVoiceID.
+
+typedef ocUInt32 ocAudioVoiceID;
+#define OC_AUDIO_VOICE_NONE                 0
+
+// A block of decoded sample data. This is not copied by the mixer, so it must remain valid until every voice that's playing it has finished.
+struct ocAudioBuffer
+{
+    const float* pFrames;       // <-- Interleaved f32.
+    ocUInt64 frameCount;
+    ocUInt32 channels;          // <-- 1 or 2.
+    ocUInt32 sampleRate;
+};
+
+struct ocAudioVoiceParams
+{
+    float gain;                 // <-- Linear.
+    float pan;                  // <-- -1 (left) to 1 (right). Equal power for mono buffers, balance for stereo buffers.
+    float pitch;                // <-- Playback rate. 1 is normal speed.
+    ocInt32 priority;           // <-- Higher priority voices are made real before lower priority voices, regardless of gain.
+    ocBool32 looping;
+};
+
+enum ocAudioCommandType
+{
+    ocAudioCommandType_Play,
+    ocAudioCommandType_Stop,
+    ocAudioCommandType_SetGain,
+    ocAudioCommandType_SetPan,
+    ocAudioCommandType_SetPitch,
+    ocAudioCommandType_SetSpatial
+};
+
+struct ocAudioCommand
+{
+    ocAudioCommandType type;
+    ocAudioVoiceID voiceID;
+
+    union
+    {
+        struct
+        {
+            ocAudioBuffer buffer;       // <-- Only the format is used when playing a stream.
+            ocAudioStream* pStream;     // <-- NULL when playing a buffer.
+            ocAudioVoiceParams params;
+        } play;
+
+        struct
+        {
+            float gain;
+            float pan;
+            float pitch;
+        } spatial;
+
+        float value;            // <-- For the SetGain, SetPan and SetPitch commands.
+    } data;
+};
+
+enum ocAudioEventType
+{
+    ocAudioEventType_VoiceFinished
+};
+
+struct ocAudioEvent
+{
+    ocAudioEventType type;
+    ocAudioVoiceID voiceID;
+};
+
+// Used by the audio thread to choose which voices are real.
+struct ocAudioVoiceRank
+{
+    ocUInt64 key;               // <-- Priority in the high 32 bits, gain in the low 32 bits. Higher is more important.
+    ocUInt32 slot;
+};
+
+// Audio thread only.
+struct ocAudioVoice
+{
+    ocAudioVoiceID id;          // <-- OC_AUDIO_VOICE_NONE if the slot is not in use.
+    ocAudioBuffer buffer;
+    ocAudioStream* pStream;
+    ocAudioVoiceParams params;
+    double cursor;              // <-- In frames of the buffer. Fractional when resampling. For streams, this is relative to the stream's read index.
+    float currentGainL;         // <-- The gains at the end of the last block. The next block ramps from these to the new gains.
+    float currentGainR;
+    ocBool32 isReal;
+    ocBool32 isFinished;
+};
+
+struct ocAudioMixer
+{
+    ocUInt32 sampleRate;
+    ocUInt32 maxVoices;
+    ocUInt32 maxRealVoices;
+    ocAudioVoice* pVoices;                      // <-- maxVoices items, indexed by slot.
+    ocSPSCQueue<ocAudioCommand> commands;       // <-- Game thread -> audio thread.
+    ocSPSCQueue<ocAudioEvent> events;           // <-- Audio thread -> game thread.
+
+    // Game thread.
+    ocUInt16* pGenerations;                     // <-- The current generation of each slot. Incremented when the voice in the slot finishes.
+    ocStack<ocUInt32> freeSlots;
+    ocAudioStream** ppStreams;                  // <-- The stream being played in each slot, if any. Closed when the voice finishes.
+
+    // Audio thread.
+    ocUInt32* pActiveSlots;
+    ocUInt32 activeSlotCount;
+    ocAudioVoiceRank* pRanks;                   // <-- Scratch space for choosing the real voices.
+    float* pMixBuffer;                          // <-- OC_AUDIO_MIXER_BLOCK_SIZE stereo frames.
+    float* pSourceBuffer;                       // <-- OC_AUDIO_MIXER_BLOCK_SIZE frames of up to 2 channels. Resampled voices are read into this.
+
+    // Written by the audio thread for debugging and profiling. Only approximate when read from another thread.
+    volatile ocUInt32 realVoiceCount;
+    volatile ocUInt32 virtualVoiceCount;
+    volatile ocUInt32 underrunCount;            // <-- The number of blocks in which a stream didn't have enough frames ready.
+};
+
+// Returns the default voice parameters. Full gain, centered, normal pitch, priority 0, not looping.
+ocAudioVoiceParams ocAudioVoiceParamsInit();
+
+//
+ocResult ocAudioMixerInit(ocUInt32 sampleRate, ocUInt32 maxVoices, ocUInt32 maxRealVoices, ocAudioMixer* pMixer);
+
+// The audio thread must no longer be calling ocAudioMixerRead() when this is called. Streams that are still playing are closed.
+void ocAudioMixerUninit(ocAudioMixer* pMixer);
+
+
+// Game Thread
+//
+// These must all be called from the same thread.
+
+// Starts playing a buffer. On success, pVoiceID receives the ID of the new voice. Fails with OC_TOO_MANY_VOICES if every slot is in use.
+ocResult ocAudioMixerPlay(ocAudioMixer* pMixer, const ocAudioBuffer* pBuffer, const ocAudioVoiceParams* pParams, ocAudioVoiceID* pVoiceID);
+
+// Starts playing a stream. The mixer takes ownership of the stream on success, and closes it when the voice finishes. On failure the
+// stream is left open. Looping is determined by the stream, so pParams->looping is ignored.
+ocResult ocAudioMixerPlayStream(ocAudioMixer* pMixer, ocAudioStream* pStream, const ocAudioVoiceParams* pParams, ocAudioVoiceID* pVoiceID);
+
+// Stops a voice. Does nothing if it has already finished.
+ocResult ocAudioMixerStop(ocAudioMixer* pMixer, ocAudioVoiceID voiceID);
+
+//
+ocResult ocAudioMixerSetGain(ocAudioMixer* pMixer, ocAudioVoiceID voiceID, float gain);
+
+//
+ocResult ocAudioMixerSetPan(ocAudioMixer* pMixer, ocAudioVoiceID voiceID, float pan);
+
+//
+ocResult ocAudioMixerSetPitch(ocAudioMixer* pMixer, ocAudioVoiceID voiceID, float pitch);
+
+// Sets the gain, pan and pitch of a voice with a single command. Used for spatialized voices which update all three every step.
+ocResult ocAudioMixerSetSpatial(ocAudioMixer* pMixer, ocAudioVoiceID voiceID, float gain, float pan, float pitch);
+
+// Determines whether or not a voice is still playing, as of the last call to ocAudioMixerUpdate().
+ocBool32 ocAudioMixerIsPlaying(ocAudioMixer* pMixer, ocAudioVoiceID voiceID);
+
+// Processes the events posted by the audio thread. This is what frees the slots of finished voices, so it needs to be called regularly.
+void ocAudioMixerUpdate(ocAudioMixer* pMixer);
+
+
+// Audio Thread
+
+// Mixes every voice into pFramesOut, which receives frameCount frames of interleaved stereo f32. Never allocates or blocks.
+void ocAudioMixerRead(ocAudioMixer* pMixer, float* pFramesOut, ocUInt32 frameCount);
@@ -0,0 +1,244 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Decodes as much as will fit in the ring buffer. Streamer thread only.
+OC_PRIVATE void ocAudioStreamFill(ocAudioStream* pStream)
+{
+    ocAssert(pStream != NULL);
+
+    const ocUInt32 mask = OC_AUDIO_STREAM_BUFFER_SIZE - 1;
+    ocUInt32 writeIndex = pStream->writeIndex;
+    ocBool32 isRewound = OC_FALSE;  // <-- Used to detect looping streams that have nothing to decode so they don't spin forever.
+
+    while (!pStream->isAtEnd) {
+        ocUInt32 framesFree = OC_AUDIO_STREAM_BUFFER_SIZE - (writeIndex - ocAtomicLoad(&pStream->readIndex));
+        if (framesFree == 0) {
+            break;
+        }
+
+        // Decoding goes straight into the ring buffer, which means reads need to be split where it wraps around.
+        ocUInt32 offset = writeIndex & mask;
+        ocUInt32 framesToRead = ocMin(framesFree, OC_AUDIO_STREAM_BUFFER_SIZE - offset);
+        ocUInt32 framesRead = (ocUInt32)ocAudioDecoderRead(&pStream->decoder, pStream->pFrames + offset*pStream->channels, framesToRead);
+        if (framesRead > 0) {
+            writeIndex += framesRead;
+            ocAtomicStore(&pStream->writeIndex, writeIndex);   // <-- Publishes the frames to the audio thread.
+            isRewound = OC_FALSE;
+        }
+
+        if (framesRead < framesToRead) {
+            if (pStream->isLooping && !isRewound && ocAudioDecoderRewind(&pStream->decoder) == OC_SUCCESS) {
+                isRewound = OC_TRUE;
+                continue;
+            }
+
+            ocAtomicStore(&pStream->isAtEnd, OC_TRUE);  // <-- After the write index so the audio thread sees the last frames first.
+        }
+    }
+
+    ocAtomicStore(&pStream->isRefillPending, OC_FALSE);
+}
+
+// Streamer thread only.
+OC_PRIVATE void ocAudioStreamFree(ocAudioStream* pStream)
+{
+    ocAssert(pStream != NULL);
+
+    ocAudioStreamer* pStreamer = pStream->pStreamer;
+
+    ocAudioDecoderUninit(&pStream->decoder);
+    ocFree(pStream->pFrames);
+    ocFree(pStream);
+
+    ocAtomicDecrement(&pStreamer->streamCount);
+}
+
+OC_PRIVATE void ocAudioStreamerProcessAudioRequests(ocAudioStreamer* pStreamer)
+{
+    ocAudioStreamRequest request;
+    while (ocSPSCQueuePop(&pStreamer->audioRequests, &request)) {
+        ocAssert(request.type == ocAudioStreamRequestType_Fill);
+        ocAudioStreamFill(request.pStream);
+    }
+}
+
+OC_PRIVATE void ocAudioStreamerProcessRequests(ocAudioStreamer* pStreamer)
+{
+    // Refills are done first since the audio thread is waiting on them.
+    ocAudioStreamerProcessAudioRequests(pStreamer);
+
+    ocAudioStreamRequest request;
+    while (ocSPSCQueuePop(&pStreamer->gameRequests, &request)) {
+        if (request.type == ocAudioStreamRequestType_Fill) {
+            ocAudioStreamFill(request.pStream);
+        } else {
+            // Any refill for this stream was posted before the voice finished, which was before the game thread closed it. It's therefore
+            // visible now, and needs to be handled before the stream is freed.
+            ocAudioStreamerProcessAudioRequests(pStreamer);
+            ocAudioStreamFree(request.pStream);
+        }
+    }
+}
+
+OC_PRIVATE ocThreadResult OC_THREADCALL ocAudioStreamerThread(void* pData)
+{
+    ocAudioStreamer* pStreamer = (ocAudioStreamer*)pData;
+    ocAssert(pStreamer != NULL);
+
+    for (;;) {
+        ocSemaphoreWait(&pStreamer->wakeSemaphore);
+
+        // The flag is checked before processing so that requests posted before terminating are always handled.
+        ocBool32 isTerminating = ocAtomicLoad(&pStreamer->isTerminating);
+        ocAudioStreamerProcessRequests(pStreamer);
+
+        if (isTerminating) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+ocResult ocAudioStreamerInit(ocAudioStreamer* pStreamer)
+{
+    if (pStreamer == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pStreamer);
+
+    // Neither queue can overflow. Each stream posts at most one fill and one close from the game thread, and the audio thread only ever
+    // has one refill outstanding for each stream.
+    ocResult result = ocSPSCQueueInit(OC_AUDIO_MAX_STREAMS*2, &pStreamer->gameRequests);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocSPSCQueueInit(OC_AUDIO_MAX_STREAMS, &pStreamer->audioRequests);
+    if (result != OC_SUCCESS) {
+        ocSPSCQueueUninit(&pStreamer->gameRequests);
+        return result;
+    }
+
+    if (!ocSemaphoreInit(0, &pStreamer->wakeSemaphore)) {
+        result = OC_ERROR;
+        goto on_error1;
+    }
+
+    if (!ocThreadCreate(ocAudioStreamerThread, pStreamer, &pStreamer->thread)) {
+        result = OC_ERROR;
+        goto on_error2;
+    }
+
+    return OC_SUCCESS;
+
+on_error2: ocSemaphoreUninit(&pStreamer->wakeSemaphore);
+on_error1: ocSPSCQueueUninit(&pStreamer->audioRequests);
+           ocSPSCQueueUninit(&pStreamer->gameRequests);
+    return result;
+}
+
+void ocAudioStreamerUninit(ocAudioStreamer* pStreamer)
+{
+    if (pStreamer == NULL) return;
+
+    ocAtomicStore(&pStreamer->isTerminating, OC_TRUE);
+    ocSemaphoreRelease(&pStreamer->wakeSemaphore);
+    ocThreadWait(&pStreamer->thread);
+
+    ocAssert(pStreamer->streamCount == 0);  // <-- A stream was never closed.
+
+    ocSemaphoreUninit(&pStreamer->wakeSemaphore);
+    ocSPSCQueueUninit(&pStreamer->audioRequests);
+    ocSPSCQueueUninit(&pStreamer->gameRequests);
+}
+
+
+ocResult ocAudioStreamOpen(ocAudioStreamer* pStreamer, ocAudioEncoding encoding, const void* pData, ocSizeT dataSize, ocBool32 isLooping, ocAudioStream** ppStream)
+{
+    if (ppStream == NULL) return OC_INVALID_ARGS;
+    *ppStream = NULL;
+
+    if (pStreamer == NULL || pData == NULL) return OC_INVALID_ARGS;
+
+    if (ocAtomicLoad(&pStreamer->streamCount) >= OC_AUDIO_MAX_STREAMS) {
+        return OC_TOO_MANY_STREAMS;
+    }
+
+    ocAudioStream* pStream = ocCallocObject(ocAudioStream);
+    if (pStream == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // Only the headers are parsed here. The actual decoding is done by the streamer.
+    ocResult result = ocAudioDecoderInit(encoding, pData, dataSize, &pStream->decoder);
+    if (result != OC_SUCCESS) {
+        ocFree(pStream);
+        return result;
+    }
+
+    if (pStream->decoder.channels > 2) {
+        ocAudioDecoderUninit(&pStream->decoder);
+        ocFree(pStream);
+        return OC_FEATURE_NOT_SUPPORTED;    // <-- The mixer only supports mono and stereo.
+    }
+
+    pStream->pStreamer  = pStreamer;
+    pStream->isLooping  = isLooping;
+    pStream->channels   = pStream->decoder.channels;
+    pStream->sampleRate = pStream->decoder.sampleRate;
+    pStream->pFrames    = (float*)ocMalloc(OC_AUDIO_STREAM_BUFFER_SIZE * pStream->channels * sizeof(float));
+    if (pStream->pFrames == NULL) {
+        ocAudioDecoderUninit(&pStream->decoder);
+        ocFree(pStream);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocAtomicIncrement(&pStreamer->streamCount);
+
+    ocAudioStreamRequest request;
+    request.type    = ocAudioStreamRequestType_Fill;
+    request.pStream = pStream;
+    ocSPSCQueuePush(&pStreamer->gameRequests, request);     // <-- Can't fail. See ocAudioStreamerInit().
+    ocSemaphoreRelease(&pStreamer->wakeSemaphore);
+
+    *ppStream = pStream;
+    return OC_SUCCESS;
+}
+
+void ocAudioStreamClose(ocAudioStream* pStream)
+{
+    if (pStream == NULL) return;
+
+    ocAudioStreamer* pStreamer = pStream->pStreamer;
+
+    ocAudioStreamRequest request;
+    request.type    = ocAudioStreamRequestType_Close;
+    request.pStream = pStream;
+    ocSPSCQueuePush(&pStreamer->gameRequests, request);
+    ocSemaphoreRelease(&pStreamer->wakeSemaphore);
+}
+
+void ocAudioStreamConsume(ocAudioStream* pStream, ocUInt32 frameCount)
+{
+    ocAssert(pStream != NULL);
+
+    ocAtomicStore(&pStream->readIndex, pStream->readIndex + frameCount);  // <-- Gives the space back to the streamer.
+
+    if (ocAtomicLoad(&pStream->isAtEnd) || ocAtomicLoad(&pStream->isRefillPending)) {
+        return;
+    }
+
+    if (ocAudioStreamGetAvailableFrames(pStream) >= OC_AUDIO_STREAM_BUFFER_SIZE/2) {
+        return;
+    }
+
+    ocAtomicStore(&pStream->isRefillPending, OC_TRUE);
+
+    ocAudioStreamRequest request;
+    request.type    = ocAudioStreamRequestType_Fill;
+    request.pStream = pStream;
+    if (ocSPSCQueuePush(&pStream->pStreamer->audioRequests, request) != OC_SUCCESS) {
+        ocAtomicStore(&pStream->isRefillPending, OC_FALSE);    // <-- Try again next time.
+        return;
+    }
+
+    ocSemaphoreRelease(&pStream->pStreamer->wakeSemaphore);    // <-- Never blocks.
+}
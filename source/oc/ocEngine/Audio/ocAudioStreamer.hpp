@@ -0,0 +1,81 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Long sounds like music and ambience are not decoded up front. Instead each voice playing one has a stream, which is a ring buffer that's
+// kept a few hundred milliseconds ahead of the mixer by the streamer's worker thread. Only the encoded data is kept in memory.
+//
+// Three threads are involved with a stream:
+//   - The game thread opens it and hands it to the mixer, which closes it again when the voice finishes.
+//   - The streamer's thread is the only thread that decodes. It fills the ring buffer, and is also what frees the stream.
+//   - The audio thread reads from the ring buffer, and posts a refill request when it's running low.
+//
+// Requests from the game thread and the audio thread go through separate lock-free queues since each can only have a single producer.
+// The audio thread wakes up the streamer with a semaphore, which never blocks when releasing. Streams are never freed while a refill is
+// outstanding because a stream is only closed after the audio thread has finished with it, and the streamer drains every refill that
+// was posted before the close before freeing it.
+
+#define OC_AUDIO_STREAM_BUFFER_SIZE     16384   // <-- In frames. Must be a power of 2. About 340ms at 48kHz.
+#define OC_AUDIO_MAX_STREAMS            64
+
+struct ocAudioStreamer;
+
+struct ocAudioStream
+{
+    ocAudioStreamer* pStreamer;
+    ocAudioDecoder decoder;                 // <-- Streamer thread only, once opened.
+    ocBool32 isLooping;
+    ocUInt32 channels;
+    ocUInt32 sampleRate;
+    float* pFrames;                         // <-- The ring buffer. OC_AUDIO_STREAM_BUFFER_SIZE frames.
+    volatile ocUInt32 writeIndex;           // <-- Only written by the streamer. Wrapped with a mask, like ocSPSCQueue.
+    volatile ocUInt32 readIndex;            // <-- Only written by the audio thread.
+    volatile ocUInt32 isAtEnd;              // <-- Set by the streamer once the last frame has been written. Never set for looping streams.
+    volatile ocUInt32 isRefillPending;      // <-- Set by the audio thread when it posts a refill, and cleared by the streamer once it's done.
+};
+
+enum ocAudioStreamRequestType
+{
+    ocAudioStreamRequestType_Fill,
+    ocAudioStreamRequestType_Close
+};
+
+struct ocAudioStreamRequest
+{
+    ocAudioStreamRequestType type;
+    ocAudioStream* pStream;
+};
+
+struct ocAudioStreamer
+{
+    ocThread thread;
+    ocSemaphore wakeSemaphore;
+    ocSPSCQueue<ocAudioStreamRequest> gameRequests;     // <-- Game thread -> streamer. Fills for new streams, and closes.
+    ocSPSCQueue<ocAudioStreamRequest> audioRequests;    // <-- Audio thread -> streamer. Refills.
+    volatile ocUInt32 streamCount;                      // <-- The number of streams that have been opened and not yet freed.
+    volatile ocUInt32 isTerminating;
+};
+
+//
+ocResult ocAudioStreamerInit(ocAudioStreamer* pStreamer);
+
+// Frees every stream that has been closed and waits for the thread to finish. Every stream must have been closed beforehand.
+void ocAudioStreamerUninit(ocAudioStreamer* pStreamer);
+
+
+// Opens a stream of encoded audio data and starts filling it in the background. Game thread only.
+//
+// pData is not copied and must remain valid until the stream is freed by the streamer, which happens some time after it's closed.
+// For data owned by a resource this means the resource must not be unloaded while it's being played.
+ocResult ocAudioStreamOpen(ocAudioStreamer* pStreamer, ocAudioEncoding encoding, const void* pData, ocSizeT dataSize, ocBool32 isLooping, ocAudioStream** ppStream);
+
+// Closes a stream. Game thread only. The audio thread must no longer be reading from it, which is why streams played through the mixer
+// are closed by ocAudioMixerUpdate().
+void ocAudioStreamClose(ocAudioStream* pStream);
+
+// Retrieves the number of frames that can be read from the stream. Audio thread only.
+OC_INLINE ocUInt32 ocAudioStreamGetAvailableFrames(ocAudioStream* pStream)
+{
+    return ocAtomicLoad(&pStream->writeIndex) - pStream->readIndex;
+}
+
+// Marks frames as read, and posts a refill request if the stream is running low. Audio thread only. Never blocks.
+void ocAudioStreamConsume(ocAudioStream* pStream, ocUInt32 frameCount);
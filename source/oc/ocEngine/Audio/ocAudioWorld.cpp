@@ -1,5 +1,224 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+#define OC_AUDIO_WORLD_EMITTER_ARRAY_COUNT  18
+
+// Retrieves a pointer to each of the emitter arrays along with the size of their elements. The float arrays come first so they stay
+// 16 byte aligned, since the capacity is always a multiple of 4.
+OC_PRIVATE void ocAudioWorldGetEmitterArrays(ocAudioWorld* pWorld, void** ppArrays[OC_AUDIO_WORLD_EMITTER_ARRAY_COUNT], ocSizeT elementSizes[OC_AUDIO_WORLD_EMITTER_ARRAY_COUNT])
+{
+    void** ppFloatArrays[] = {
+        (void**)&pWorld->pPositionX,     (void**)&pWorld->pPositionY,     (void**)&pWorld->pPositionZ,
+        (void**)&pWorld->pPrevPositionX, (void**)&pWorld->pPrevPositionY, (void**)&pWorld->pPrevPositionZ,
+        (void**)&pWorld->pMinDistance,   (void**)&pWorld->pMaxDistance,
+        (void**)&pWorld->pBaseGain,      (void**)&pWorld->pBasePitch,
+        (void**)&pWorld->pGain,          (void**)&pWorld->pPan,           (void**)&pWorld->pPitch
+    };
+
+    ocUInt32 iArray = 0;
+    for (; iArray < ocCountOf(ppFloatArrays); ++iArray) {
+        ppArrays[iArray] = ppFloatArrays[iArray];
+        elementSizes[iArray] = sizeof(float);
+    }
+
+    ppArrays[iArray] = (void**)&pWorld->pDescs;      elementSizes[iArray] = sizeof(*pWorld->pDescs);      iArray += 1;
+    ppArrays[iArray] = (void**)&pWorld->pVoiceIDs;   elementSizes[iArray] = sizeof(*pWorld->pVoiceIDs);   iArray += 1;
+    ppArrays[iArray] = (void**)&pWorld->pIsFinished; elementSizes[iArray] = sizeof(*pWorld->pIsFinished); iArray += 1;
+    ppArrays[iArray] = (void**)&pWorld->pEmitterIDs; elementSizes[iArray] = sizeof(*pWorld->pEmitterIDs); iArray += 1;
+    ppArrays[iArray] = NULL;                         elementSizes[iArray] = 0;
+
+    ocAssert(iArray == OC_AUDIO_WORLD_EMITTER_ARRAY_COUNT-1);
+}
+
+OC_PRIVATE ocResult ocAudioWorldGrowEmitters(ocAudioWorld* pWorld)
+{
+    ocAssert(pWorld != NULL);
+
+    ocUInt32 newCapacity = ocMax(pWorld->emitterCapacity * 2, 64U);
+
+    void** ppArrays[OC_AUDIO_WORLD_EMITTER_ARRAY_COUNT];
+    ocSizeT elementSizes[OC_AUDIO_WORLD_EMITTER_ARRAY_COUNT];
+    ocAudioWorldGetEmitterArrays(pWorld, ppArrays, elementSizes);
+
+    ocSizeT dataSize = 0;
+    for (ocUInt32 iArray = 0; ppArrays[iArray] != NULL; ++iArray) {
+        dataSize += newCapacity * elementSizes[iArray];
+    }
+
+    ocUInt8* pNewData = (ocUInt8*)ocMalloc(dataSize);
+    if (pNewData == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // Every array is moved to it's new location in a single pass.
+    ocUInt8* pCursor = pNewData;
+    for (ocUInt32 iArray = 0; ppArrays[iArray] != NULL; ++iArray) {
+        if (pWorld->emitterCount > 0) {
+            ocCopyMemory(pCursor, *ppArrays[iArray], pWorld->emitterCount * elementSizes[iArray]);
+        }
+
+        *ppArrays[iArray] = pCursor;
+        pCursor += newCapacity * elementSizes[iArray];
+    }
+
+    ocFree(pWorld->pEmitterData);
+    pWorld->pEmitterData    = pNewData;
+    pWorld->emitterCapacity = newCapacity;
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocAudioWorldAllocEmitterID(ocAudioWorld* pWorld, ocAudioEmitterID* pEmitterID)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(pEmitterID != NULL);
+
+    if (ocStackTop(&pWorld->freeEmitterIDs, pEmitterID) == OC_SUCCESS) {
+        ocStackPop(&pWorld->freeEmitterIDs);
+        return OC_SUCCESS;
+    }
+
+    ocUInt32 newCapacity = ocMax(pWorld->emitterIDCapacity * 2, 64U);
+    ocUInt32* pNewIndices = (ocUInt32*)ocRealloc(pWorld->pEmitterIndices, newCapacity * sizeof(*pNewIndices));
+    if (pNewIndices == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // The new IDs are pushed in reverse so the lowest ones are used first.
+    ocUInt32 oldCapacity = pWorld->emitterIDCapacity;
+    pWorld->pEmitterIndices   = pNewIndices;
+    pWorld->emitterIDCapacity = newCapacity;
+    for (ocUInt32 iID = newCapacity-1; iID > oldCapacity; --iID) {
+        ocResult result = ocStackPush(&pWorld->freeEmitterIDs, iID);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    *pEmitterID = oldCapacity;
+    return OC_SUCCESS;
+}
+
+
+// Calculates the gain, pan and pitch of every emitter, relative to the listener.
+//
+// Attenuation uses the inverse distance model, clamped to the emitter's min and max distance. Panning is the sine of the angle between
+// the listener's forward direction and the emitter. Doppler uses the velocities of the listener and the emitter along the line between
+// them, which are derived from the change in position since the last step. invDt is 0 when there are no previous positions.
+OC_PRIVATE void ocAudioWorldSpatialize(ocAudioWorld* pWorld, float invDt)
+{
+    ocAssert(pWorld != NULL);
+
+    const float listenerX = pWorld->listenerPosition.x;
+    const float listenerY = pWorld->listenerPosition.y;
+    const float listenerZ = pWorld->listenerPosition.z;
+
+    glm::vec3 right = pWorld->listenerRotation * glm::vec3(1, 0, 0);
+    glm::vec3 listenerVelocity = (pWorld->listenerPosition - pWorld->prevListenerPosition) * invDt;
+
+    // Velocities are clamped to half the speed of sound which keeps the Doppler ratio positive and finite.
+    const float c = OC_AUDIO_SPEED_OF_SOUND;
+    const float maxVelocity = c * 0.5f;
+    const float minDoppler  = 1 / OC_AUDIO_MAX_DOPPLER_SHIFT;
+    const float maxDoppler  = OC_AUDIO_MAX_DOPPLER_SHIFT;
+
+    const ocUInt32 count = pWorld->emitterCount;
+    ocUInt32 i = 0;
+
+#ifdef OC_SUPPORT_SSE2
+    // 4 emitters at a time, one per lane.
+    const __m128 vListenerX = _mm_set1_ps(listenerX);
+    const __m128 vListenerY = _mm_set1_ps(listenerY);
+    const __m128 vListenerZ = _mm_set1_ps(listenerZ);
+    const __m128 vRightX    = _mm_set1_ps(right.x);
+    const __m128 vRightY    = _mm_set1_ps(right.y);
+    const __m128 vRightZ    = _mm_set1_ps(right.z);
+    const __m128 vListenerVelocityX = _mm_set1_ps(listenerVelocity.x);
+    const __m128 vListenerVelocityY = _mm_set1_ps(listenerVelocity.y);
+    const __m128 vListenerVelocityZ = _mm_set1_ps(listenerVelocity.z);
+    const __m128 vInvDt       = _mm_set1_ps(invDt);
+    const __m128 vC           = _mm_set1_ps(c);
+    const __m128 vMaxVelocity = _mm_set1_ps(maxVelocity);
+    const __m128 vMinVelocity = _mm_set1_ps(-maxVelocity);
+    const __m128 vMinDoppler  = _mm_set1_ps(minDoppler);
+    const __m128 vMaxDoppler  = _mm_set1_ps(maxDoppler);
+    const __m128 vThreshold   = _mm_set1_ps(OC_AUDIO_AUDIBILITY_THRESHOLD);
+    const __m128 vEpsilon     = _mm_set1_ps(1e-6f);
+    const __m128 vOne         = _mm_set1_ps(1);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(pWorld->pPositionX + i);
+        __m128 py = _mm_loadu_ps(pWorld->pPositionY + i);
+        __m128 pz = _mm_loadu_ps(pWorld->pPositionZ + i);
+        __m128 dx = _mm_sub_ps(px, vListenerX);
+        __m128 dy = _mm_sub_ps(py, vListenerY);
+        __m128 dz = _mm_sub_ps(pz, vListenerZ);
+
+        // Direction from the listener to the emitter. An emitter right on top of the listener has no direction.
+        __m128 dist    = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        __m128 invDist = _mm_and_ps(_mm_cmpgt_ps(dist, vEpsilon), _mm_div_ps(vOne, _mm_max_ps(dist, vEpsilon)));
+        __m128 nx = _mm_mul_ps(dx, invDist);
+        __m128 ny = _mm_mul_ps(dy, invDist);
+        __m128 nz = _mm_mul_ps(dz, invDist);
+
+        // Attenuation and culling.
+        __m128 minDistance = _mm_loadu_ps(pWorld->pMinDistance + i);
+        __m128 maxDistance = _mm_loadu_ps(pWorld->pMaxDistance + i);
+        __m128 gain = _mm_mul_ps(_mm_loadu_ps(pWorld->pBaseGain + i), _mm_div_ps(minDistance, _mm_max_ps(_mm_min_ps(dist, maxDistance), minDistance)));
+        __m128 isAudible = _mm_and_ps(_mm_cmplt_ps(dist, maxDistance), _mm_cmpge_ps(gain, vThreshold));
+        _mm_storeu_ps(pWorld->pGain + i, _mm_and_ps(isAudible, gain));
+
+        // Panning.
+        __m128 pan = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, vRightX), _mm_mul_ps(ny, vRightY)), _mm_mul_ps(nz, vRightZ));
+        _mm_storeu_ps(pWorld->pPan + i, pan);
+
+        // Doppler. The emitter's velocity is positive when it's moving away from the listener, and the listener's is positive when it's
+        // moving towards the emitter.
+        __m128 vx = _mm_mul_ps(_mm_sub_ps(px, _mm_loadu_ps(pWorld->pPrevPositionX + i)), vInvDt);
+        __m128 vy = _mm_mul_ps(_mm_sub_ps(py, _mm_loadu_ps(pWorld->pPrevPositionY + i)), vInvDt);
+        __m128 vz = _mm_mul_ps(_mm_sub_ps(pz, _mm_loadu_ps(pWorld->pPrevPositionZ + i)), vInvDt);
+        __m128 emitterVelocity  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, nx), _mm_mul_ps(vy, ny)), _mm_mul_ps(vz, nz));
+        __m128 listenerVelocity = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vListenerVelocityX, nx), _mm_mul_ps(vListenerVelocityY, ny)), _mm_mul_ps(vListenerVelocityZ, nz));
+        emitterVelocity  = _mm_min_ps(_mm_max_ps(emitterVelocity,  vMinVelocity), vMaxVelocity);
+        listenerVelocity = _mm_min_ps(_mm_max_ps(listenerVelocity, vMinVelocity), vMaxVelocity);
+
+        __m128 doppler = _mm_div_ps(_mm_add_ps(vC, listenerVelocity), _mm_add_ps(vC, emitterVelocity));
+        doppler = _mm_min_ps(_mm_max_ps(doppler, vMinDoppler), vMaxDoppler);
+        _mm_storeu_ps(pWorld->pPitch + i, _mm_mul_ps(_mm_loadu_ps(pWorld->pBasePitch + i), doppler));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        float px = pWorld->pPositionX[i];
+        float py = pWorld->pPositionY[i];
+        float pz = pWorld->pPositionZ[i];
+        float dx = px - listenerX;
+        float dy = py - listenerY;
+        float dz = pz - listenerZ;
+
+        float dist    = sqrtf(dx*dx + dy*dy + dz*dz);
+        float invDist = (dist > 1e-6f) ? 1 / dist : 0;
+        float nx = dx*invDist;
+        float ny = dy*invDist;
+        float nz = dz*invDist;
+
+        float minDistance = pWorld->pMinDistance[i];
+        float maxDistance = pWorld->pMaxDistance[i];
+        float gain = pWorld->pBaseGain[i] * (minDistance / ocMax(ocMin(dist, maxDistance), minDistance));
+        pWorld->pGain[i] = (dist < maxDistance && gain >= OC_AUDIO_AUDIBILITY_THRESHOLD) ? gain : 0;
+
+        pWorld->pPan[i] = nx*right.x + ny*right.y + nz*right.z;
+
+        float emitterVelocity  = ((px - pWorld->pPrevPositionX[i])*nx + (py - pWorld->pPrevPositionY[i])*ny + (pz - pWorld->pPrevPositionZ[i])*nz) * invDt;
+        float listenerVelocityAlongLine = listenerVelocity.x*nx + listenerVelocity.y*ny + listenerVelocity.z*nz;
+        emitterVelocity           = ocClamp(emitterVelocity,           -maxVelocity, maxVelocity);
+        listenerVelocityAlongLine = ocClamp(listenerVelocityAlongLine, -maxVelocity, maxVelocity);
+
+        float doppler = ocClamp((c + listenerVelocityAlongLine) / (c + emitterVelocity), minDoppler, maxDoppler);
+        pWorld->pPitch[i] = pWorld->pBasePitch[i] * doppler;
+    }
+}
+
+
 ocResult ocAudioWorldInit(ocAudioContext* pAudio, ocAudioWorld* pWorld)
 {
     if (pWorld == NULL) return OC_INVALID_ARGS;
@@ -8,6 +227,12 @@ ocResult ocAudioWorldInit(ocAudioContext* pAudio, ocAudioWorld* pWorld)
     if (pAudio == NULL) return OC_INVALID_ARGS;
 
     pWorld->pAudio = pAudio;
+    pWorld->listenerRotation = glm::quat(1, 0, 0, 0);
+
+    ocResult result = ocStackInit(&pWorld->freeEmitterIDs);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
 
     return OC_SUCCESS;
 }
@@ -15,11 +240,174 @@ ocResult ocAudioWorldInit(ocAudioContext* pAudio, ocAudioWorld* pWorld)
 void ocAudioWorldUninit(ocAudioWorld* pWorld)
 {
     if (pWorld == NULL) return;
+
+    for (ocUInt32 iEmitter = 0; iEmitter < pWorld->emitterCount; ++iEmitter) {
+        ocAudioMixerStop(&pWorld->pAudio->mixer, pWorld->pVoiceIDs[iEmitter]);
+    }
+
+    ocStackUninit(&pWorld->freeEmitterIDs);
+    ocFree(pWorld->pEmitterIndices);
+    ocFree(pWorld->pEmitterData);
 }
 
 void ocAudioWorldStep(ocAudioWorld* pWorld, double dt)
 {
     if (pWorld == NULL) return;
 
-    (void)dt;
-}
\ No newline at end of file
+    ocAudioMixer* pMixer = &pWorld->pAudio->mixer;
+
+    float invDt = (pWorld->hasStepped && dt > 0) ? (float)(1 / dt) : 0;
+    ocAudioWorldSpatialize(pWorld, invDt);
+
+    for (ocUInt32 iEmitter = 0; iEmitter < pWorld->emitterCount; ++iEmitter) {
+        if (pWorld->pIsFinished[iEmitter]) {
+            continue;
+        }
+
+        ocAudioVoiceID voiceID = pWorld->pVoiceIDs[iEmitter];
+        ocBool32 isLooping = pWorld->pDescs[iEmitter].params.looping;
+
+        // A voice can finish on it's own, or be stopped by the mixer if it runs out of something.
+        if (voiceID != OC_AUDIO_VOICE_NONE && !ocAudioMixerIsPlaying(pMixer, voiceID)) {
+            voiceID = OC_AUDIO_VOICE_NONE;
+            pWorld->pIsFinished[iEmitter] = !isLooping;
+        }
+
+        float gain  = pWorld->pGain[iEmitter];
+        float pan   = pWorld->pPan[iEmitter];
+        float pitch = pWorld->pPitch[iEmitter];
+
+        if (gain == 0) {
+            // Culled. The gain has already dropped below the audibility threshold so stopping straight away won't be heard.
+            ocAudioMixerStop(pMixer, voiceID);
+            voiceID = OC_AUDIO_VOICE_NONE;
+            pWorld->pIsFinished[iEmitter] = !isLooping;
+        } else if (voiceID == OC_AUDIO_VOICE_NONE) {
+            if (!pWorld->pIsFinished[iEmitter]) {
+                ocAudioVoiceParams params = pWorld->pDescs[iEmitter].params;
+                params.gain  = gain;
+                params.pan   = pan;
+                params.pitch = pitch;
+
+                // A one-shot that can't be played now is dropped rather than being played late. Looping emitters try again next step.
+                if (ocAudioPlaySound(pWorld->pAudio, pWorld->pDescs[iEmitter].pSound, &params, &voiceID) != OC_SUCCESS) {
+                    pWorld->pIsFinished[iEmitter] = !isLooping;
+                }
+            }
+        } else {
+            // If the command queue is full the voice just keeps it's previous values until the next step.
+            ocAudioMixerSetSpatial(pMixer, voiceID, gain, pan, pitch);
+        }
+
+        pWorld->pVoiceIDs[iEmitter] = voiceID;
+    }
+
+    if (pWorld->emitterCount > 0) {
+        ocCopyMemory(pWorld->pPrevPositionX, pWorld->pPositionX, pWorld->emitterCount * sizeof(float));
+        ocCopyMemory(pWorld->pPrevPositionY, pWorld->pPositionY, pWorld->emitterCount * sizeof(float));
+        ocCopyMemory(pWorld->pPrevPositionZ, pWorld->pPositionZ, pWorld->emitterCount * sizeof(float));
+    }
+
+    pWorld->prevListenerPosition = pWorld->listenerPosition;
+    pWorld->hasStepped = OC_TRUE;
+}
+
+void ocAudioWorldSetListener(ocAudioWorld* pWorld, const glm::vec3 &position, const glm::quat &rotation)
+{
+    if (pWorld == NULL) return;
+
+    pWorld->listenerPosition = position;
+    pWorld->listenerRotation = rotation;
+}
+
+
+ocResult ocAudioWorldCreateEmitter(ocAudioWorld* pWorld, const ocAudioEmitterDesc* pDesc, const glm::vec3 &position, ocAudioEmitterID* pEmitterID)
+{
+    if (pEmitterID == NULL) return OC_INVALID_ARGS;
+    *pEmitterID = OC_AUDIO_EMITTER_NONE;
+
+    if (pWorld == NULL || pDesc == NULL || pDesc->pSound == NULL || pDesc->pSound->type != ocResourceType_Sound) return OC_INVALID_ARGS;
+    if (!(pDesc->minDistance > 0) || !(pDesc->maxDistance >= pDesc->minDistance)) return OC_INVALID_ARGS;
+
+    if (pWorld->emitterCount == pWorld->emitterCapacity) {
+        ocResult result = ocAudioWorldGrowEmitters(pWorld);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    ocAudioEmitterID emitterID;
+    ocResult result = ocAudioWorldAllocEmitterID(pWorld, &emitterID);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocUInt32 index = pWorld->emitterCount;
+    pWorld->pPositionX[index]     = position.x;
+    pWorld->pPositionY[index]     = position.y;
+    pWorld->pPositionZ[index]     = position.z;
+    pWorld->pPrevPositionX[index] = position.x;     // <-- No velocity until it's moved.
+    pWorld->pPrevPositionY[index] = position.y;
+    pWorld->pPrevPositionZ[index] = position.z;
+    pWorld->pMinDistance[index]   = pDesc->minDistance;
+    pWorld->pMaxDistance[index]   = pDesc->maxDistance;
+    pWorld->pBaseGain[index]      = pDesc->params.gain;
+    pWorld->pBasePitch[index]     = pDesc->params.pitch;
+    pWorld->pGain[index]          = 0;
+    pWorld->pPan[index]           = 0;
+    pWorld->pPitch[index]         = 0;
+    pWorld->pDescs[index]         = *pDesc;
+    pWorld->pVoiceIDs[index]      = OC_AUDIO_VOICE_NONE;
+    pWorld->pIsFinished[index]    = OC_FALSE;
+    pWorld->pEmitterIDs[index]    = emitterID;
+    pWorld->pEmitterIndices[emitterID] = index;
+    pWorld->emitterCount += 1;
+
+    *pEmitterID = emitterID;
+    return OC_SUCCESS;
+}
+
+void ocAudioWorldDeleteEmitter(ocAudioWorld* pWorld, ocAudioEmitterID emitterID)
+{
+    if (pWorld == NULL || emitterID >= pWorld->emitterIDCapacity) return;
+
+    ocUInt32 index = pWorld->pEmitterIndices[emitterID];
+    ocAssert(index < pWorld->emitterCount && pWorld->pEmitterIDs[index] == emitterID);
+
+    ocAudioMixerStop(&pWorld->pAudio->mixer, pWorld->pVoiceIDs[index]);
+
+    // The last emitter is moved into the hole to keep the arrays packed.
+    ocUInt32 lastIndex = pWorld->emitterCount-1;
+    if (index != lastIndex) {
+        void** ppArrays[OC_AUDIO_WORLD_EMITTER_ARRAY_COUNT];
+        ocSizeT elementSizes[OC_AUDIO_WORLD_EMITTER_ARRAY_COUNT];
+        ocAudioWorldGetEmitterArrays(pWorld, ppArrays, elementSizes);
+
+        for (ocUInt32 iArray = 0; ppArrays[iArray] != NULL; ++iArray) {
+            ocUInt8* pArray = (ocUInt8*)*ppArrays[iArray];
+            ocCopyMemory(pArray + index*elementSizes[iArray], pArray + lastIndex*elementSizes[iArray], elementSizes[iArray]);
+        }
+
+        pWorld->pEmitterIndices[pWorld->pEmitterIDs[index]] = index;
+    }
+
+    pWorld->emitterCount -= 1;
+    ocStackPush(&pWorld->freeEmitterIDs, emitterID);  // <-- If this fails the ID is just never reused.
+}
+
+void ocAudioWorldSetEmitterPosition(ocAudioWorld* pWorld, ocAudioEmitterID emitterID, const glm::vec3 &position)
+{
+    if (pWorld == NULL || emitterID >= pWorld->emitterIDCapacity) return;
+
+    ocUInt32 index = pWorld->pEmitterIndices[emitterID];
+    pWorld->pPositionX[index] = position.x;
+    pWorld->pPositionY[index] = position.y;
+    pWorld->pPositionZ[index] = position.z;
+}
+
+ocBool32 ocAudioWorldIsEmitterPlaying(ocAudioWorld* pWorld, ocAudioEmitterID emitterID)
+{
+    if (pWorld == NULL || emitterID >= pWorld->emitterIDCapacity) return OC_FALSE;
+
+    return pWorld->pVoiceIDs[pWorld->pEmitterIndices[emitterID]] != OC_AUDIO_VOICE_NONE;
+}
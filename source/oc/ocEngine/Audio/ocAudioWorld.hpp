@@ -1,15 +1,91 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+// Emitters are sounds with a position in the world, heard from the point of view of a listener which is normally the world's active
+// camera. Emitter data is stored as a structure of arrays so that attenuation, panning and Doppler can be calculated for every emitter
+// in a single SIMD pass on the game thread each step. The results are sent to the mixer with one command per voice and the mixer ramps
+// to them across it's next block, so the audio thread never does any spatial math.
+//
+// Emitters that are too far away or too quiet to be heard are culled before they reach the mixer. A looping emitter that's culled has
+// it's voice stopped, and starts again from the beginning of the sound when it comes back into range. A one-shot emitter that's culled
+// is finished. Either way, inaudible emitters don't use any voices.
+
+#define OC_AUDIO_SPEED_OF_SOUND         343.0f  // <-- In world units per second. World units are assumed to be meters.
+#define OC_AUDIO_AUDIBILITY_THRESHOLD   0.001f  // <-- -60dB. Emitters with a lower gain after attenuation are culled.
+#define OC_AUDIO_MAX_DOPPLER_SHIFT      2.0f    // <-- The pitch change caused by Doppler is clamped to [1/x, x].
+
+typedef ocUInt32 ocAudioEmitterID;
+#define OC_AUDIO_EMITTER_NONE           (~0U)
+
+struct ocAudioEmitterDesc
+{
+    ocResource* pSound;             // <-- Must be a sound resource, and must stay loaded while the emitter exists.
+    ocAudioVoiceParams params;      // <-- The gain and pitch are before attenuation and Doppler. The pan is ignored.
+    float minDistance;              // <-- The gain is not attenuated any closer than this.
+    float maxDistance;              // <-- The emitter is culled beyond this distance.
+};
+
 struct ocAudioWorld
 {
     ocAudioContext* pAudio;
+
+    // The listener. The velocity is derived from the change in position between steps.
+    glm::vec3 listenerPosition;
+    glm::quat listenerRotation;
+    glm::vec3 prevListenerPosition;
+    ocBool32 hasStepped;            // <-- False until the first step, which has no velocities because there's no previous position.
+
+    // Emitters, tightly packed. Deleting an emitter moves the last one into it's place. Every array is emitterCapacity long, and they're
+    // all carved out of pEmitterData.
+    ocUInt32 emitterCount;
+    ocUInt32 emitterCapacity;
+    void* pEmitterData;
+    float* pPositionX;
+    float* pPositionY;
+    float* pPositionZ;
+    float* pPrevPositionX;
+    float* pPrevPositionY;
+    float* pPrevPositionZ;
+    float* pMinDistance;
+    float* pMaxDistance;
+    float* pBaseGain;
+    float* pBasePitch;
+    float* pGain;                   // <-- Output of the spatialization pass. 0 when the emitter is culled.
+    float* pPan;                    // <-- Output of the spatialization pass.
+    float* pPitch;                  // <-- Output of the spatialization pass.
+    ocAudioEmitterDesc* pDescs;
+    ocAudioVoiceID* pVoiceIDs;      // <-- OC_AUDIO_VOICE_NONE when the emitter is not playing.
+    ocBool32* pIsFinished;          // <-- Set when a one-shot emitter has finished or been culled. It's never played again.
+    ocAudioEmitterID* pEmitterIDs;  // <-- The ID of the emitter at each index.
+
+    // Maps an emitter ID to it's index in the arrays above. IDs are reused once the emitter has been deleted.
+    ocUInt32* pEmitterIndices;
+    ocUInt32 emitterIDCapacity;
+    ocStack<ocAudioEmitterID> freeEmitterIDs;
 };
 
 //
 ocResult ocAudioWorldInit(ocAudioContext* pAudio, ocAudioWorld* pWorld);
 
-//
+// Stops every emitter that's still playing.
 void ocAudioWorldUninit(ocAudioWorld* pWorld);
 
-//
-void ocAudioWorldStep(ocAudioWorld* pWorld, double dt);
\ No newline at end of file
+// Called from ocWorldStep() on the game thread. This spatializes every emitter and updates the mixer. Voices that have finished are
+// recycled by ocAudioUpdate() which is called once per step by ocStep(), regardless of how many worlds there are.
+void ocAudioWorldStep(ocAudioWorld* pWorld, double dt);
+
+// Sets the position and orientation of the listener. This is done by ocWorldStep() using the world's active camera.
+void ocAudioWorldSetListener(ocAudioWorld* pWorld, const glm::vec3 &position, const glm::quat &rotation);
+
+
+// Creates an emitter. It starts playing on the next step, if it's audible.
+ocResult ocAudioWorldCreateEmitter(ocAudioWorld* pWorld, const ocAudioEmitterDesc* pDesc, const glm::vec3 &position, ocAudioEmitterID* pEmitterID);
+
+// Deletes an emitter, stopping it's voice.
+void ocAudioWorldDeleteEmitter(ocAudioWorld* pWorld, ocAudioEmitterID emitterID);
+
+// Moves an emitter. The velocity used for Doppler is derived from the change in position between steps, so objects that are teleported
+// will have a pitch glitch for a single step.
+void ocAudioWorldSetEmitterPosition(ocAudioWorld* pWorld, ocAudioEmitterID emitterID, const glm::vec3 &position);
+
+// Determines whether or not an emitter is currently using a voice. Emitters that have been culled are not playing.
+ocBool32 ocAudioWorldIsEmitterPlaying(ocAudioWorld* pWorld, ocAudioEmitterID emitterID);
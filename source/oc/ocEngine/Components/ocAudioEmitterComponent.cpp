@@ -0,0 +1,35 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+ocResult ocComponentAudioEmitterInit(ocWorldObject* pObject, ocAudioEmitterComponent* pComponent)
+{
+    ocResult result = ocComponentInit(pObject, OC_COMPONENT_TYPE_AUDIO_EMITTER, pComponent);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    pComponent->desc.pSound      = NULL;
+    pComponent->desc.params      = ocAudioVoiceParamsInit();
+    pComponent->desc.minDistance = 1;
+    pComponent->desc.maxDistance = 1000;    // <-- Where the inverse distance model reaches the audibility threshold.
+    pComponent->emitterID        = OC_AUDIO_EMITTER_NONE;
+
+    return OC_SUCCESS;
+}
+
+void ocComponentAudioEmitterUninit(ocAudioEmitterComponent* pComponent)
+{
+    ocComponentUninit(pComponent);
+}
+
+ocResult ocComponentAudioEmitterSetSound(ocAudioEmitterComponent* pComponent, const ocAudioEmitterDesc* pDesc)
+{
+    if (pComponent == NULL || pDesc == NULL) return OC_INVALID_ARGS;
+
+    if (ocWorldObjectIsInWorld(pComponent->pObject)) {
+        return OC_INVALID_OPERATION;
+    }
+
+    pComponent->desc = *pDesc;
+
+    return OC_SUCCESS;
+}
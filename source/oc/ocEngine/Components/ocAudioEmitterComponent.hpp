@@ -0,0 +1,20 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_AUDIO_EMITTER_COMPONENT(pComponent) ((ocAudioEmitterComponent*)pComponent)
+struct ocAudioEmitterComponent : public ocComponent
+{
+    ocAudioEmitterDesc desc;        // Used to create the emitter when the object is added to the world.
+    ocAudioEmitterID emitterID;     // Initially set to OC_AUDIO_EMITTER_NONE, and then set when the object is added to the world.
+};
+
+//
+ocResult ocComponentAudioEmitterInit(ocWorldObject* pObject, ocAudioEmitterComponent* pComponent);
+
+//
+void ocComponentAudioEmitterUninit(ocAudioEmitterComponent* pComponent);
+
+// Sets the sound to play and how it's attenuated. The sound starts playing when the object is added to the world.
+//
+// This will fail if the object is already in the world. To change the sound of an object dynamically, you'll need to first remove the
+// object from the world, call this function, and then re-add the object.
+ocResult ocComponentAudioEmitterSetSound(ocAudioEmitterComponent* pComponent, const ocAudioEmitterDesc* pDesc);
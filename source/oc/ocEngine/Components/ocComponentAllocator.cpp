@@ -60,6 +60,96 @@ OC_PRIVATE void ocDeleteComponent_Light(ocComponent* pComponent, void* pUserData
     ocComponentLightUninit(reinterpret_cast<ocLightComponent*>(pComponent));
     ocFree(pComponent);
 }
+
+
+OC_PRIVATE ocComponent* ocCreateComponent_ParticleSystem(ocEngineContext* pEngine, ocComponentType type, ocWorldObject* pObject, void* pUserData)
+{
+    (void)pEngine;
+    (void)type;
+    (void)pUserData;
+
+    ocAssert(type == OC_COMPONENT_TYPE_PARTICLE_SYSTEM);
+
+    ocParticleSystemComponent* pComponent = (ocParticleSystemComponent*)ocCalloc(1, sizeof(*pComponent));
+    if (pComponent == NULL) {
+        return NULL;
+    }
+
+    if (ocComponentParticleSystemInit(pObject, pComponent)) {
+        ocFree(pComponent);
+        return NULL;
+    }
+
+    return pComponent;
+}
+
+OC_PRIVATE void ocDeleteComponent_ParticleSystem(ocComponent* pComponent, void* pUserData)
+{
+    (void)pUserData;
+
+    ocComponentParticleSystemUninit(reinterpret_cast<ocParticleSystemComponent*>(pComponent));
+    ocFree(pComponent);
+}
+
+
+OC_PRIVATE ocComponent* ocCreateComponent_DynamicsBody(ocEngineContext* pEngine, ocComponentType type, ocWorldObject* pObject, void* pUserData)
+{
+    (void)pEngine;
+    (void)type;
+    (void)pUserData;
+
+    ocAssert(type == OC_COMPONENT_TYPE_DYNAMICS_BODY);
+
+    ocDynamicsBodyComponent* pComponent = (ocDynamicsBodyComponent*)ocCalloc(1, sizeof(*pComponent));
+    if (pComponent == NULL) {
+        return NULL;
+    }
+
+    if (ocComponentDynamicsBodyInit(pObject, pComponent)) {
+        ocFree(pComponent);
+        return NULL;
+    }
+
+    return pComponent;
+}
+
+OC_PRIVATE void ocDeleteComponent_DynamicsBody(ocComponent* pComponent, void* pUserData)
+{
+    (void)pUserData;
+
+    ocComponentDynamicsBodyUninit(reinterpret_cast<ocDynamicsBodyComponent*>(pComponent));
+    ocFree(pComponent);
+}
+
+
+OC_PRIVATE ocComponent* ocCreateComponent_AudioEmitter(ocEngineContext* pEngine, ocComponentType type, ocWorldObject* pObject, void* pUserData)
+{
+    (void)pEngine;
+    (void)type;
+    (void)pUserData;
+
+    ocAssert(type == OC_COMPONENT_TYPE_AUDIO_EMITTER);
+
+    ocAudioEmitterComponent* pComponent = (ocAudioEmitterComponent*)ocCalloc(1, sizeof(*pComponent));
+    if (pComponent == NULL) {
+        return NULL;
+    }
+
+    if (ocComponentAudioEmitterInit(pObject, pComponent)) {
+        ocFree(pComponent);
+        return NULL;
+    }
+
+    return pComponent;
+}
+
+OC_PRIVATE void ocDeleteComponent_AudioEmitter(ocComponent* pComponent, void* pUserData)
+{
+    (void)pUserData;
+
+    ocComponentAudioEmitterUninit(reinterpret_cast<ocAudioEmitterComponent*>(pComponent));
+    ocFree(pComponent);
+}
 ///////////////////////////////////////////////////////////////////////////////
 
 
@@ -75,7 +165,10 @@ ocResult ocComponentAllocatorInit(ocEngineContext* pEngine, ocComponentAllocator
 
     // Default allocators.
     ocComponentAllocatorRegister(pAllocator, OC_COMPONENT_TYPE_MESH, ocCreateComponent_Mesh, ocDeleteComponent_Mesh, NULL);
+    ocComponentAllocatorRegister(pAllocator, OC_COMPONENT_TYPE_PARTICLE_SYSTEM, ocCreateComponent_ParticleSystem, ocDeleteComponent_ParticleSystem, NULL);
     ocComponentAllocatorRegister(pAllocator, OC_COMPONENT_TYPE_LIGHT, ocCreateComponent_Light, ocDeleteComponent_Light, NULL);
+    ocComponentAllocatorRegister(pAllocator, OC_COMPONENT_TYPE_DYNAMICS_BODY, ocCreateComponent_DynamicsBody, ocDeleteComponent_DynamicsBody, NULL);
+    ocComponentAllocatorRegister(pAllocator, OC_COMPONENT_TYPE_AUDIO_EMITTER, ocCreateComponent_AudioEmitter, ocDeleteComponent_AudioEmitter, NULL);
     
     return OC_SUCCESS;
 }
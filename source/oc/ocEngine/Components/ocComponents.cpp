@@ -2,5 +2,8 @@
 
 #include "ocComponent.cpp"
 #include "ocMeshComponent.cpp"
+#include "ocParticleSystemComponent.cpp"
 #include "ocLightComponent.cpp"
+#include "ocDynamicsBodyComponent.cpp"
+#include "ocAudioEmitterComponent.cpp"
 #include "ocComponentAllocator.cpp"
\ No newline at end of file
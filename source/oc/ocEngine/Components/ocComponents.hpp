@@ -7,8 +7,12 @@ typedef ocUInt32 ocComponentType;
 #define OC_COMPONENT_TYPE_PARTICLE_SYSTEM   3
 #define OC_COMPONENT_TYPE_LIGHT             4
 #define OC_COMPONENT_TYPE_DYNAMICS_BODY     5
+#define OC_COMPONENT_TYPE_AUDIO_EMITTER     6
 
 #include "ocComponent.hpp"
 #include "ocMeshComponent.hpp"
+#include "ocParticleSystemComponent.hpp"
 #include "ocLightComponent.hpp"
+#include "ocDynamicsBodyComponent.hpp"
+#include "ocAudioEmitterComponent.hpp"
 #include "ocComponentAllocator.hpp"
\ No newline at end of file
@@ -0,0 +1,32 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+ocResult ocComponentDynamicsBodyInit(ocWorldObject* pObject, ocDynamicsBodyComponent* pComponent)
+{
+    ocResult result = ocComponentInit(pObject, OC_COMPONENT_TYPE_DYNAMICS_BODY, pComponent);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    pComponent->desc   = ocDynamicsBodyDescInit();
+    pComponent->bodyID = OC_DYNAMICS_BODY_NONE;
+
+    return OC_SUCCESS;
+}
+
+void ocComponentDynamicsBodyUninit(ocDynamicsBodyComponent* pComponent)
+{
+    ocComponentUninit(pComponent);
+}
+
+ocResult ocComponentDynamicsBodySetDesc(ocDynamicsBodyComponent* pComponent, const ocDynamicsBodyDesc* pDesc)
+{
+    if (pComponent == NULL || pDesc == NULL) return OC_INVALID_ARGS;
+
+    if (ocWorldObjectIsInWorld(pComponent->pObject)) {
+        return OC_INVALID_OPERATION;
+    }
+
+    pComponent->desc = *pDesc;
+
+    return OC_SUCCESS;
+}
@@ -0,0 +1,21 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_DYNAMICS_BODY_COMPONENT(pComponent) ((ocDynamicsBodyComponent*)pComponent)
+struct ocDynamicsBodyComponent : public ocComponent
+{
+    ocDynamicsBodyDesc desc;        // Used to create the body when the object is added to the world.
+    ocDynamicsBodyID bodyID;        // Initially set to OC_DYNAMICS_BODY_NONE, and then set when the object is added to the world.
+};
+
+//
+ocResult ocComponentDynamicsBodyInit(ocWorldObject* pObject, ocDynamicsBodyComponent* pComponent);
+
+//
+void ocComponentDynamicsBodyUninit(ocDynamicsBodyComponent* pComponent);
+
+// Sets the shape and physical properties of the body. The body takes the object's absolute position and rotation when the object is
+// added to the world, and from then on the object follows the body.
+//
+// This will fail if the object is already in the world. To change the body of an object dynamically, you'll need to first remove the
+// object from the world, call this function, and then re-add the object.
+ocResult ocComponentDynamicsBodySetDesc(ocDynamicsBodyComponent* pComponent, const ocDynamicsBodyDesc* pDesc);
@@ -7,10 +7,8 @@ ocResult ocComponentLightInit(ocWorldObject* pObject, ocLightComponent* pCompone
         return result;
     }
 
-    pComponent->color.r = 1;
-    pComponent->color.g = 1;
-    pComponent->color.b = 1;
-    pComponent->color.a = 1;
+    pComponent->desc         = ocGraphicsLightDescInit(ocGraphicsObjectType_PointLight);
+    pComponent->pLightObject = NULL;
 
     return OC_SUCCESS;
 }
@@ -18,4 +16,17 @@ ocResult ocComponentLightInit(ocWorldObject* pObject, ocLightComponent* pCompone
 void ocComponentLightUninit(ocLightComponent* pComponent)
 {
     ocComponentUninit(pComponent);
+}
+
+ocResult ocComponentLightSetDesc(ocLightComponent* pComponent, const ocGraphicsLightDesc* pDesc)
+{
+    if (pComponent == NULL || pDesc == NULL) return OC_INVALID_ARGS;
+
+    if (ocWorldObjectIsInWorld(pComponent->pObject)) {
+        return OC_INVALID_OPERATION;
+    }
+
+    pComponent->desc = *pDesc;
+
+    return OC_SUCCESS;
 }
\ No newline at end of file
@@ -3,11 +3,19 @@
 #define OC_LIGHT_COMPONENT(pComponent) ((ocLightComponent*)pComponent)
 struct ocLightComponent : public ocComponent
 {
-    ocColorF color;
+    ocGraphicsLightDesc desc;           // Used to create the light object when the object is added to the world.
+    ocGraphicsObject* pLightObject;     // Initially set to NULL, and then initialized when the object is added to the world.
 };
 
 //
 ocResult ocComponentLightInit(ocWorldObject* pObject, ocLightComponent* pComponent);
 
 //
-void ocComponentLightUninit(ocLightComponent* pComponent);
\ No newline at end of file
+void ocComponentLightUninit(ocLightComponent* pComponent);
+
+// Sets the type, color and shape of the light. Lights are white point lights by default.
+//
+// This will fail if the object is already in the world. To change the light of an object dynamically, you'll need to first remove the
+// object from the world, call this function, and then re-add the object. Point and spot lights are placed at the object's position, and
+// directional and spot lights shine down the object's forward axis.
+ocResult ocComponentLightSetDesc(ocLightComponent* pComponent, const ocGraphicsLightDesc* pDesc);
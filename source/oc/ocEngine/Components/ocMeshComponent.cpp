@@ -25,5 +25,18 @@ ocResult ocComponentMeshSetMesh(ocMeshComponent* pComponent, ocGraphicsMesh* pMe
 
     pComponent->pMesh = pMesh;
 
+    return OC_SUCCESS;
+}
+
+ocResult ocComponentMeshSetSkeleton(ocMeshComponent* pComponent, const ocSkeleton* pSkeleton)
+{
+    if (pComponent == NULL) return OC_INVALID_ARGS;
+
+    if (ocWorldObjectIsInWorld(pComponent->pObject)) {
+        return OC_INVALID_OPERATION;
+    }
+
+    pComponent->pSkeleton = pSkeleton;
+
     return OC_SUCCESS;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 struct ocMeshComponent : public ocComponent
 {
     ocGraphicsMesh* pMesh;          // Used as the source for the mesh object.
+    const ocSkeleton* pSkeleton;    // Optional. When set, the mesh object is skinned and gets it's own animation character.
     ocGraphicsObject* pMeshObject;  // Initially set to NULL, and then initialized when the object is added to the world.
 };
 
@@ -17,4 +18,10 @@ void ocComponentMeshUninit(ocMeshComponent* pComponent);
 //
 // This will fail if the object is already in the world. To change the mesh of an object dynamically,
 // you'll need to first remove the object from the world, call this function, and then re-add the object.
-ocResult ocComponentMeshSetMesh(ocMeshComponent* pComponent, ocGraphicsMesh* pMesh);
\ No newline at end of file
+ocResult ocComponentMeshSetMesh(ocMeshComponent* pComponent, ocGraphicsMesh* pMesh);
+
+// Sets the skeleton the mesh is skinned to. The mesh must use the P3T2N3J4W4 vertex format. Set to NULL for a rigid mesh.
+//
+// Like ocComponentMeshSetMesh(), this will fail if the object is already in the world. The animation character of the mesh object can
+// be retrieved with ocGraphicsWorldGetObjectAnimationCharacter() once the object has been added to the world.
+ocResult ocComponentMeshSetSkeleton(ocMeshComponent* pComponent, const ocSkeleton* pSkeleton);
\ No newline at end of file
@@ -0,0 +1,32 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+ocResult ocComponentParticleSystemInit(ocWorldObject* pObject, ocParticleSystemComponent* pComponent)
+{
+    ocResult result = ocComponentInit(pObject, OC_COMPONENT_TYPE_PARTICLE_SYSTEM, pComponent);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    pComponent->desc            = ocParticleEmitterDescInit();
+    pComponent->pParticleObject = NULL;
+
+    return OC_SUCCESS;
+}
+
+void ocComponentParticleSystemUninit(ocParticleSystemComponent* pComponent)
+{
+    ocComponentUninit(pComponent);
+}
+
+ocResult ocComponentParticleSystemSetDesc(ocParticleSystemComponent* pComponent, const ocParticleEmitterDesc* pDesc)
+{
+    if (pComponent == NULL || pDesc == NULL) return OC_INVALID_ARGS;
+
+    if (ocWorldObjectIsInWorld(pComponent->pObject)) {
+        return OC_INVALID_OPERATION;
+    }
+
+    pComponent->desc = *pDesc;
+
+    return OC_SUCCESS;
+}
@@ -0,0 +1,21 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_PARTICLE_SYSTEM_COMPONENT(pComponent) ((ocParticleSystemComponent*)pComponent)
+struct ocParticleSystemComponent : public ocComponent
+{
+    ocParticleEmitterDesc desc;         // Used to create the particle system object when the object is added to the world.
+    ocGraphicsObject* pParticleObject;  // Initially set to NULL, and then initialized when the object is added to the world.
+};
+
+//
+ocResult ocComponentParticleSystemInit(ocWorldObject* pObject, ocParticleSystemComponent* pComponent);
+
+//
+void ocComponentParticleSystemUninit(ocParticleSystemComponent* pComponent);
+
+// Sets how particles are spawned, moved and drawn. The particle system starts emitting when the object is added to the world.
+//
+// This will fail if the object is already in the world. To change the effect of an object dynamically, you'll need to first remove the
+// object from the world, call this function, and then re-add the object. To start and stop emitting or to fire bursts, use the particle
+// emitter of the particle object instead.
+ocResult ocComponentParticleSystemSetDesc(ocParticleSystemComponent* pComponent, const ocParticleEmitterDesc* pDesc);
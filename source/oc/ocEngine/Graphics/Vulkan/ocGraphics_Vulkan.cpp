@@ -26,7 +26,6 @@ OC_PRIVATE VkFormat ocToVulkanImageFormat(ocImageFormat format)
     }
 }
 
-#if 0
 OC_PRIVATE VkPrimitiveTopology ocToVulkanPrimitiveType(ocGraphicsPrimitiveType primitiveType)
 {
     switch (primitiveType) {
@@ -36,7 +35,6 @@ OC_PRIVATE VkPrimitiveTopology ocToVulkanPrimitiveType(ocGraphicsPrimitiveType p
         default: return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     }
 }
-#endif
 
 OC_PRIVATE VkIndexType ocToVulkanIndexFormat(ocGraphicsIndexFormat indexFormat)
 {
@@ -774,6 +772,13 @@ OC_PRIVATE ocResult ocGraphicsInit_VulkanDevices(ocGraphicsContext* pGraphics, u
     VkPhysicalDeviceFeatures physicalDeviceFeatures;
     vkGetPhysicalDeviceFeatures(pGraphics->physicalDevice, &physicalDeviceFeatures);
 
+    // The fragment shader indexes into the image array with the object's image index which is not a constant expression.
+    if (!physicalDeviceFeatures.shaderSampledImageArrayDynamicIndexing) {
+        return OC_FAILED_TO_INIT_GRAPHICS;
+    }
+
+    physicalDeviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+
     const char* ppEnabledDeviceExtensionNames[] =  {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
 #if 0
@@ -829,6 +834,13 @@ OC_PRIVATE ocResult ocGraphicsInit_VulkanDevices(ocGraphicsContext* pGraphics, u
     pGraphics->maxMSAA = ocMin(maxMSAAColor, ocMin(maxMSAADepth, maxMSAAStencil));
     pGraphics->msaaSamples = (VkSampleCountFlagBits)ocClamp(desiredMSAASamples, pGraphics->minMSAA, pGraphics->maxMSAA);
 
+    // Clamp the size of the image array to the device's limits. Combined image samplers count against both the sampler and sampled
+    // image limits.
+    const VkPhysicalDeviceLimits* pLimits = &pGraphics->deviceProps.limits;
+    pGraphics->maxImages = OC_VK_MAX_IMAGES;
+    pGraphics->maxImages = ocMin(pGraphics->maxImages, ocMin(pLimits->maxPerStageDescriptorSamplers, pLimits->maxPerStageDescriptorSampledImages));
+    pGraphics->maxImages = ocMin(pGraphics->maxImages, ocMin(pLimits->maxDescriptorSetSamplers,      pLimits->maxDescriptorSetSampledImages));
+
     return OC_SUCCESS;
 }
 
@@ -976,187 +988,639 @@ OC_PRIVATE ocResult ocGraphicsInit_VulkanRenderPasses(ocGraphicsContext* pGraphi
     return OC_SUCCESS;
 }
 
-OC_PRIVATE ocResult ocGraphicsInit_VulkanPipelines(ocGraphicsContext* pGraphics)
+// The pipeline cache is saved to disk so pipelines don't need to be compiled from scratch each time the engine starts. The data is only
+// valid for the device and driver that created it so it's prefixed with a header identifying them. Drivers validate the data themselves,
+// but not all of them do it reliably so we discard anything that doesn't match before giving it to the driver.
+#define OC_VK_PIPELINE_CACHE_FILE_NAME      "vulkan_pipelines.cache"
+#define OC_VK_PIPELINE_CACHE_MAGIC          0x48435056  // 'VPCH'
+#define OC_VK_PIPELINE_CACHE_VERSION        1
+
+struct ocvkPipelineCacheHeader
 {
-    VkResult vkresult = VK_SUCCESS;
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint32_t padding0;
+    uint64_t dataSize;
+    uint64_t dataHash;      // <-- ocHashFNV1a64() of the data that follows the header.
+};
+
+OC_PRIVATE void ocvkGetPipelineCacheFilePath(ocGraphicsContext* pGraphics, char* pathOut, size_t pathOutSize)
+{
+    ocGetCacheFolderPath(&pGraphics->pEngine->fs, pathOut, pathOutSize);
+    ocPathAppend(pathOut, pathOutSize, pathOut, OC_VK_PIPELINE_CACHE_FILE_NAME);
+}
+
+OC_PRIVATE void ocvkInitPipelineCacheHeader(ocGraphicsContext* pGraphics, const void* pData, size_t dataSize, ocvkPipelineCacheHeader* pHeader)
+{
+    ocZeroObject(pHeader);
+    pHeader->magic         = OC_VK_PIPELINE_CACHE_MAGIC;
+    pHeader->version       = OC_VK_PIPELINE_CACHE_VERSION;
+    pHeader->vendorID      = pGraphics->deviceProps.vendorID;
+    pHeader->deviceID      = pGraphics->deviceProps.deviceID;
+    pHeader->driverVersion = pGraphics->deviceProps.driverVersion;
+    memcpy(pHeader->pipelineCacheUUID, pGraphics->deviceProps.pipelineCacheUUID, VK_UUID_SIZE);
+    pHeader->dataSize      = dataSize;
+    pHeader->dataHash      = ocHashFNV1a64(pData, dataSize);
+}
+
+OC_PRIVATE ocResult ocGraphicsInit_VulkanPipelineCache(ocGraphicsContext* pGraphics)
+{
+    ocAssert(pGraphics != NULL);
+
+    char cachePath[4096];
+    ocvkGetPipelineCacheFilePath(pGraphics, cachePath, sizeof(cachePath));
+
+    // A missing or stale cache is not an error. It just means pipelines will take longer to create.
+    void* pFileData = NULL;
+    size_t fileSize = 0;
+    const void* pInitialData = NULL;
+    size_t initialDataSize = 0;
+    if (ocOpenAndReadFile(cachePath, &pFileData, &fileSize) == OC_SUCCESS) {
+        if (fileSize >= sizeof(ocvkPipelineCacheHeader)) {
+            const void* pData = (const ocUInt8*)pFileData + sizeof(ocvkPipelineCacheHeader);
+            size_t dataSize = fileSize - sizeof(ocvkPipelineCacheHeader);
+
+            ocvkPipelineCacheHeader expectedHeader;
+            ocvkInitPipelineCacheHeader(pGraphics, pData, dataSize, &expectedHeader);
+            if (memcmp(pFileData, &expectedHeader, sizeof(expectedHeader)) == 0) {
+                pInitialData = pData;
+                initialDataSize = dataSize;
+            }
+        }
+
+        if (pInitialData == NULL) {
+            ocLogf(pGraphics->pEngine, "Discarding pipeline cache. It was created by a different device or driver, or is corrupt.");
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo;
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.pNext = NULL;
+    cacheInfo.flags = 0;
+    cacheInfo.initialDataSize = initialDataSize;
+    cacheInfo.pInitialData = pInitialData;
+    VkResult vkresult = vkCreatePipelineCache(pGraphics->device, &cacheInfo, NULL, &pGraphics->pipelineCache);
+    if (vkresult != VK_SUCCESS && pInitialData != NULL) {
+        // The driver rejected the data. Start again with an empty cache.
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = NULL;
+        vkresult = vkCreatePipelineCache(pGraphics->device, &cacheInfo, NULL, &pGraphics->pipelineCache);
+    }
+
+    ocFree(pFileData);
 
-    // Shaders.
-    vkresult = ocvkCreateShaderModule(pGraphics->device, sizeof(g_ocShader_Default_VERTEX), (const uint32_t*)g_ocShader_Default_VERTEX, NULL, &pGraphics->mainPipeline_VS);
     if (vkresult != VK_SUCCESS) {
-        return ocToResultFromVulkan(vkresult);
+        pGraphics->pipelineCache = NULL;    // <-- Pipelines are still created, just without a cache.
+        ocWarningf(pGraphics->pEngine, "Failed to create pipeline cache. Pipelines will be compiled from scratch.");
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocGraphicsSave_VulkanPipelineCache(ocGraphicsContext* pGraphics)
+{
+    ocAssert(pGraphics != NULL);
+
+    if (pGraphics->pipelineCache == NULL) {
+        return;
+    }
+
+    size_t dataSize = 0;
+    VkResult vkresult = vkGetPipelineCacheData(pGraphics->device, pGraphics->pipelineCache, &dataSize, NULL);
+    if (vkresult != VK_SUCCESS || dataSize == 0) {
+        return;
+    }
+
+    ocUInt8* pFileData = (ocUInt8*)ocMalloc(sizeof(ocvkPipelineCacheHeader) + dataSize);
+    if (pFileData == NULL) {
+        return;
     }
 
-    vkresult = ocvkCreateShaderModule(pGraphics->device, sizeof(g_ocShader_Default_FRAGMENT), (const uint32_t*)g_ocShader_Default_FRAGMENT, NULL, &pGraphics->mainPipeline_FS);
+    char cachePath[4096];
+    char tempPath[4096];
+
+    vkresult = vkGetPipelineCacheData(pGraphics->device, pGraphics->pipelineCache, &dataSize, pFileData + sizeof(ocvkPipelineCacheHeader));
     if (vkresult != VK_SUCCESS) {
-        vkDestroyShaderModule(pGraphics->device, pGraphics->mainPipeline_VS, NULL);
-        return ocToResultFromVulkan(vkresult);
+        goto done;
     }
-    
-    VkPipelineShaderStageCreateInfo pStages[2];
-    pStages[0] = ocvkPipelineShaderStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT, pGraphics->mainPipeline_VS, "main", NULL);
-    pStages[1] = ocvkPipelineShaderStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, pGraphics->mainPipeline_FS, "main", NULL);
 
+    ocvkInitPipelineCacheHeader(pGraphics, pFileData + sizeof(ocvkPipelineCacheHeader), dataSize, (ocvkPipelineCacheHeader*)pFileData);
 
-    // Vertex Input.
-    VkVertexInputBindingDescription pVertexBindingDescriptions[1];
-    pVertexBindingDescriptions[0].binding = 0;
-    pVertexBindingDescriptions[0].stride = sizeof(float) * (3+2+3);
-    pVertexBindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    VkVertexInputAttributeDescription pVertexAttributeDescriptions[3];
-    pVertexAttributeDescriptions[0].location = 0;
-    pVertexAttributeDescriptions[0].binding = 0;
-    pVertexAttributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    pVertexAttributeDescriptions[0].offset = 0;
-    pVertexAttributeDescriptions[1].location = 1;
-    pVertexAttributeDescriptions[1].binding = 0;
-    pVertexAttributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
-    pVertexAttributeDescriptions[1].offset = sizeof(float) * (3);
-    pVertexAttributeDescriptions[2].location = 2;
-    pVertexAttributeDescriptions[2].binding = 0;
-    pVertexAttributeDescriptions[2].format = VK_FORMAT_R32G32B32_SFLOAT;
-    pVertexAttributeDescriptions[2].offset = sizeof(float) * (3+2);
+    // The cache is written to a temporary file first and then moved into place so that a crash part way through can't leave a truncated
+    // cache behind.
+    ocGetCacheFolderPath(&pGraphics->pEngine->fs, cachePath, sizeof(cachePath));
+    ocCreateDirectoryRecursive(cachePath);
 
-    VkPipelineVertexInputStateCreateInfo vertexInputStateInfo;
-    vertexInputStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputStateInfo.pNext = NULL;
-    vertexInputStateInfo.flags = 0;
-    vertexInputStateInfo.vertexBindingDescriptionCount = ocCountOf(pVertexBindingDescriptions);
-    vertexInputStateInfo.pVertexBindingDescriptions = pVertexBindingDescriptions;
-    vertexInputStateInfo.vertexAttributeDescriptionCount = ocCountOf(pVertexAttributeDescriptions);
-    vertexInputStateInfo.pVertexAttributeDescriptions = pVertexAttributeDescriptions;
+    ocvkGetPipelineCacheFilePath(pGraphics, cachePath, sizeof(cachePath));
+    oc_strcpy_s(tempPath, sizeof(tempPath), cachePath);
+    oc_strcat_s(tempPath, sizeof(tempPath), ".tmp");
+
+    if (ocOpenAndWriteFile(tempPath, pFileData, sizeof(ocvkPipelineCacheHeader) + dataSize) != OC_SUCCESS || ocMoveFile(tempPath, cachePath) != OC_SUCCESS) {
+        ocWarningf(pGraphics->pEngine, "Failed to save pipeline cache to %s", cachePath);
+    }
+
+done:
+    ocFree(pFileData);
+}
 
 
-    // Input Assembly
+// Everything needed to create one of the main pipelines. The create info points to the other members so this must not be copied.
+struct ocvkMainPipelineCreateInfo
+{
+    VkPipelineShaderStageCreateInfo stages[2];
+    VkSpecializationMapEntry specializationMapEntries[2];
+    VkSpecializationInfo specializationInfo;
+    uint32_t specializationData[2];
+    VkVertexInputBindingDescription vertexBindingDescriptions[1];
+    VkVertexInputAttributeDescription vertexAttributeDescriptions[5];
+    VkPipelineVertexInputStateCreateInfo vertexInputStateInfo;
     VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateInfo;
-    inputAssemblyStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssemblyStateInfo.pNext = NULL;
-    inputAssemblyStateInfo.flags = 0;
-    inputAssemblyStateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssemblyStateInfo.primitiveRestartEnable = VK_FALSE;
+    VkPipelineViewportStateCreateInfo viewportStateInfo;
+    VkPipelineRasterizationStateCreateInfo rasterizationStateInfo;
+    VkPipelineMultisampleStateCreateInfo multisampleStateInfo;
+    VkPipelineDepthStencilStateCreateInfo depthStencilStateInfo;
+    VkPipelineColorBlendAttachmentState colorBlendStateAttachments[1];
+    VkPipelineColorBlendStateCreateInfo colorBlendStateInfo;
+    VkDynamicState dynamicStates[2];
+    VkPipelineDynamicStateCreateInfo dynamicStateInfo;
+    VkGraphicsPipelineCreateInfo pipelineInfo;
+};
+
+OC_PRIVATE void ocvkInitMainPipelineCreateInfo(ocGraphicsContext* pGraphics, ocGraphicsVertexFormat vertexFormat, ocGraphicsPrimitiveType primitiveType, ocvkMainPipelineCreateInfo* pInfo)
+{
+    ocAssert(pGraphics != NULL);
+    ocAssert(pInfo != NULL);
+
+    memset(pInfo, 0, sizeof(*pInfo));
+
+    // Shaders. The primitive type is a specialization constant rather than a separate variant because it only changes a constant. The size
+    // of the image array depends on the device so it must also be a specialization constant.
+    pInfo->specializationData[0] = (uint32_t)primitiveType;
+    pInfo->specializationMapEntries[0].constantID = OC_VK_SPEC_CONSTANT_PRIMITIVE_TYPE;
+    pInfo->specializationMapEntries[0].offset = 0;
+    pInfo->specializationMapEntries[0].size = sizeof(uint32_t);
+    pInfo->specializationData[1] = pGraphics->maxImages;
+    pInfo->specializationMapEntries[1].constantID = OC_VK_SPEC_CONSTANT_MAX_IMAGES;
+    pInfo->specializationMapEntries[1].offset = sizeof(uint32_t);
+    pInfo->specializationMapEntries[1].size = sizeof(uint32_t);
+    pInfo->specializationInfo.mapEntryCount = ocCountOf(pInfo->specializationMapEntries);
+    pInfo->specializationInfo.pMapEntries = pInfo->specializationMapEntries;
+    pInfo->specializationInfo.dataSize = sizeof(pInfo->specializationData);
+    pInfo->specializationInfo.pData = pInfo->specializationData;
+
+    pInfo->stages[0] = ocvkPipelineShaderStageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT,   pGraphics->mainPipeline_VS[vertexFormat], "main", &pInfo->specializationInfo);
+    pInfo->stages[1] = ocvkPipelineShaderStageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT, pGraphics->mainPipeline_FS[vertexFormat], "main", &pInfo->specializationInfo);
+
+
+    // Vertex Input.
+    VkVertexInputAttributeDescription* pAttributes = pInfo->vertexAttributeDescriptions;
+    uint32_t attributeCount = 0;
+    pAttributes[attributeCount].location = attributeCount;
+    pAttributes[attributeCount].binding = 0;
+    pAttributes[attributeCount].format = VK_FORMAT_R32G32B32_SFLOAT;
+    pAttributes[attributeCount].offset = 0;
+    attributeCount += 1;
+    pAttributes[attributeCount].location = attributeCount;
+    pAttributes[attributeCount].binding = 0;
+    pAttributes[attributeCount].format = VK_FORMAT_R32G32_SFLOAT;
+    pAttributes[attributeCount].offset = sizeof(float) * (3);
+    attributeCount += 1;
+    pAttributes[attributeCount].location = attributeCount;
+    pAttributes[attributeCount].binding = 0;
+    pAttributes[attributeCount].format = VK_FORMAT_R32G32B32_SFLOAT;
+    pAttributes[attributeCount].offset = sizeof(float) * (3+2);
+    attributeCount += 1;
+    if (vertexFormat == ocGraphicsVertexFormat_P3T2N3T3B3) {
+        pAttributes[attributeCount].location = attributeCount;
+        pAttributes[attributeCount].binding = 0;
+        pAttributes[attributeCount].format = VK_FORMAT_R32G32B32_SFLOAT;
+        pAttributes[attributeCount].offset = sizeof(float) * (3+2+3);
+        attributeCount += 1;
+        pAttributes[attributeCount].location = attributeCount;
+        pAttributes[attributeCount].binding = 0;
+        pAttributes[attributeCount].format = VK_FORMAT_R32G32B32_SFLOAT;
+        pAttributes[attributeCount].offset = sizeof(float) * (3+2+3+3);
+        attributeCount += 1;
+    }
+    if (vertexFormat == ocGraphicsVertexFormat_P3T2N3J4W4) {
+        pAttributes[attributeCount].location = attributeCount;
+        pAttributes[attributeCount].binding = 0;
+        pAttributes[attributeCount].format = VK_FORMAT_R8G8B8A8_UINT;      // <-- Bone indices.
+        pAttributes[attributeCount].offset = sizeof(float) * (3+2+3);
+        attributeCount += 1;
+        pAttributes[attributeCount].location = attributeCount;
+        pAttributes[attributeCount].binding = 0;
+        pAttributes[attributeCount].format = VK_FORMAT_R8G8B8A8_UNORM;     // <-- Bone weights.
+        pAttributes[attributeCount].offset = sizeof(float) * (3+2+3) + 4;
+        attributeCount += 1;
+    }
+
+    pInfo->vertexBindingDescriptions[0].binding = 0;
+    pInfo->vertexBindingDescriptions[0].stride = (uint32_t)ocGetVertexSizeFromFormat(vertexFormat);
+    pInfo->vertexBindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    pInfo->vertexInputStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    pInfo->vertexInputStateInfo.pNext = NULL;
+    pInfo->vertexInputStateInfo.flags = 0;
+    pInfo->vertexInputStateInfo.vertexBindingDescriptionCount = ocCountOf(pInfo->vertexBindingDescriptions);
+    pInfo->vertexInputStateInfo.pVertexBindingDescriptions = pInfo->vertexBindingDescriptions;
+    pInfo->vertexInputStateInfo.vertexAttributeDescriptionCount = attributeCount;
+    pInfo->vertexInputStateInfo.pVertexAttributeDescriptions = pAttributes;
+
+
+    // Input assembly.
+    pInfo->inputAssemblyStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    pInfo->inputAssemblyStateInfo.pNext = NULL;
+    pInfo->inputAssemblyStateInfo.flags = 0;
+    pInfo->inputAssemblyStateInfo.topology = ocToVulkanPrimitiveType(primitiveType);
+    pInfo->inputAssemblyStateInfo.primitiveRestartEnable = VK_FALSE;
 
 
     // Viewport state.
-    VkPipelineViewportStateCreateInfo viewportStateInfo;
-    viewportStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportStateInfo.pNext = NULL;
-    viewportStateInfo.flags = 0;
-    viewportStateInfo.viewportCount = 1;
-    viewportStateInfo.pViewports = NULL;    // <-- This pipeline uses dynamic viewports.
-    viewportStateInfo.scissorCount = 1;
-    viewportStateInfo.pScissors = NULL;     // <-- This pipeline uses dynamic scissor rectangles.
+    pInfo->viewportStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    pInfo->viewportStateInfo.pNext = NULL;
+    pInfo->viewportStateInfo.flags = 0;
+    pInfo->viewportStateInfo.viewportCount = 1;
+    pInfo->viewportStateInfo.pViewports = NULL;    // <-- This pipeline uses dynamic viewports.
+    pInfo->viewportStateInfo.scissorCount = 1;
+    pInfo->viewportStateInfo.pScissors = NULL;     // <-- This pipeline uses dynamic scissor rectangles.
 
 
     // Rasterization state.
-    VkPipelineRasterizationStateCreateInfo rasterizationStateInfo;
-    rasterizationStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizationStateInfo.pNext = NULL;
-    rasterizationStateInfo.flags = 0;
-    rasterizationStateInfo.depthClampEnable = VK_FALSE;
-    rasterizationStateInfo.rasterizerDiscardEnable = VK_FALSE;      // <-- TODO: Research this. Don't know what this one means...
-    rasterizationStateInfo.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizationStateInfo.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizationStateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizationStateInfo.depthBiasEnable = VK_FALSE;
-    rasterizationStateInfo.depthBiasConstantFactor = 1;
-    rasterizationStateInfo.depthBiasClamp = 0;
-    rasterizationStateInfo.depthBiasSlopeFactor = 1;
-    rasterizationStateInfo.lineWidth = 1;
+    pInfo->rasterizationStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    pInfo->rasterizationStateInfo.pNext = NULL;
+    pInfo->rasterizationStateInfo.flags = 0;
+    pInfo->rasterizationStateInfo.depthClampEnable = VK_FALSE;
+    pInfo->rasterizationStateInfo.rasterizerDiscardEnable = VK_FALSE;      // <-- TODO: Research this. Don't know what this one means...
+    pInfo->rasterizationStateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+    pInfo->rasterizationStateInfo.cullMode = VK_CULL_MODE_BACK_BIT;
+    pInfo->rasterizationStateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    pInfo->rasterizationStateInfo.depthBiasEnable = VK_FALSE;
+    pInfo->rasterizationStateInfo.depthBiasConstantFactor = 1;
+    pInfo->rasterizationStateInfo.depthBiasClamp = 0;
+    pInfo->rasterizationStateInfo.depthBiasSlopeFactor = 1;
+    pInfo->rasterizationStateInfo.lineWidth = 1;
 
 
     // Multisample state.
-    VkPipelineMultisampleStateCreateInfo multisampleStateInfo;
-    multisampleStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampleStateInfo.pNext = NULL;
-    multisampleStateInfo.flags = 0;
-    multisampleStateInfo.rasterizationSamples = pGraphics->msaaSamples;
-    multisampleStateInfo.sampleShadingEnable = VK_FALSE;    // TODO: Research these sampling properties.
-    multisampleStateInfo.minSampleShading = VK_FALSE;
-    multisampleStateInfo.pSampleMask = NULL;
-    multisampleStateInfo.alphaToCoverageEnable = VK_FALSE;
-    multisampleStateInfo.alphaToOneEnable = VK_FALSE;
+    pInfo->multisampleStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    pInfo->multisampleStateInfo.pNext = NULL;
+    pInfo->multisampleStateInfo.flags = 0;
+    pInfo->multisampleStateInfo.rasterizationSamples = pGraphics->msaaSamples;
+    pInfo->multisampleStateInfo.sampleShadingEnable = VK_FALSE;    // TODO: Research these sampling properties.
+    pInfo->multisampleStateInfo.minSampleShading = VK_FALSE;
+    pInfo->multisampleStateInfo.pSampleMask = NULL;
+    pInfo->multisampleStateInfo.alphaToCoverageEnable = VK_FALSE;
+    pInfo->multisampleStateInfo.alphaToOneEnable = VK_FALSE;
 
 
     // Depth/Stencil state.
-    VkPipelineDepthStencilStateCreateInfo depthStencilStateInfo;
-    memset(&depthStencilStateInfo, 0, sizeof(depthStencilStateInfo));
-    depthStencilStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencilStateInfo.pNext = NULL;
-    depthStencilStateInfo.flags = 0;
-    depthStencilStateInfo.depthTestEnable = VK_FALSE;       // TODO: Change this to true. Just setting to false for now to try and get something showing on the screen ASAP.
-    depthStencilStateInfo.depthWriteEnable = VK_TRUE;
-    depthStencilStateInfo.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
-    depthStencilStateInfo.depthBoundsTestEnable = VK_FALSE;
-    depthStencilStateInfo.stencilTestEnable = VK_FALSE;
-    depthStencilStateInfo.front;
-    depthStencilStateInfo.back;
-    depthStencilStateInfo.minDepthBounds = 0;
-    depthStencilStateInfo.maxDepthBounds = 1;
+    pInfo->depthStencilStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    pInfo->depthStencilStateInfo.pNext = NULL;
+    pInfo->depthStencilStateInfo.flags = 0;
+    pInfo->depthStencilStateInfo.depthTestEnable = VK_FALSE;       // TODO: Change this to true. Just setting to false for now to try and get something showing on the screen ASAP.
+    pInfo->depthStencilStateInfo.depthWriteEnable = VK_TRUE;
+    pInfo->depthStencilStateInfo.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    pInfo->depthStencilStateInfo.depthBoundsTestEnable = VK_FALSE;
+    pInfo->depthStencilStateInfo.stencilTestEnable = VK_FALSE;
+    pInfo->depthStencilStateInfo.minDepthBounds = 0;
+    pInfo->depthStencilStateInfo.maxDepthBounds = 1;
 
 
     // Color blend state.
-    VkPipelineColorBlendAttachmentState pColorBlendStateAttachments[1];
-    memset(pColorBlendStateAttachments, 0, sizeof(pColorBlendStateAttachments));
-    pColorBlendStateAttachments[0].blendEnable = VK_FALSE;
-    pColorBlendStateAttachments[0].srcColorBlendFactor;
-    pColorBlendStateAttachments[0].dstColorBlendFactor;
-    pColorBlendStateAttachments[0].colorBlendOp;
-    pColorBlendStateAttachments[0].srcAlphaBlendFactor;
-    pColorBlendStateAttachments[0].dstAlphaBlendFactor;
-    pColorBlendStateAttachments[0].alphaBlendOp;
-    pColorBlendStateAttachments[0].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    pInfo->colorBlendStateAttachments[0].blendEnable = VK_FALSE;
+    pInfo->colorBlendStateAttachments[0].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
 
-    VkPipelineColorBlendStateCreateInfo colorBlendStateInfo;
-    memset(&colorBlendStateInfo, 0, sizeof(colorBlendStateInfo));
-    colorBlendStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlendStateInfo.pNext = NULL;
-    colorBlendStateInfo.flags = 0;
-    colorBlendStateInfo.logicOpEnable = VK_FALSE;
-    colorBlendStateInfo.logicOp = VK_LOGIC_OP_CLEAR;
-    colorBlendStateInfo.attachmentCount = ocCountOf(pColorBlendStateAttachments);
-    colorBlendStateInfo.pAttachments = pColorBlendStateAttachments;
-    //colorBlendStateInfo.blendConstants;
+    pInfo->colorBlendStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    pInfo->colorBlendStateInfo.pNext = NULL;
+    pInfo->colorBlendStateInfo.flags = 0;
+    pInfo->colorBlendStateInfo.logicOpEnable = VK_FALSE;
+    pInfo->colorBlendStateInfo.logicOp = VK_LOGIC_OP_CLEAR;
+    pInfo->colorBlendStateInfo.attachmentCount = ocCountOf(pInfo->colorBlendStateAttachments);
+    pInfo->colorBlendStateInfo.pAttachments = pInfo->colorBlendStateAttachments;
 
 
     // Dynamic state.
-    VkDynamicState pDynamicStates[2];
-    pDynamicStates[0] = VK_DYNAMIC_STATE_VIEWPORT;
-    pDynamicStates[1] = VK_DYNAMIC_STATE_SCISSOR;
+    pInfo->dynamicStates[0] = VK_DYNAMIC_STATE_VIEWPORT;
+    pInfo->dynamicStates[1] = VK_DYNAMIC_STATE_SCISSOR;
+
+    pInfo->dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    pInfo->dynamicStateInfo.pNext = NULL;
+    pInfo->dynamicStateInfo.flags = 0;
+    pInfo->dynamicStateInfo.dynamicStateCount = ocCountOf(pInfo->dynamicStates);
+    pInfo->dynamicStateInfo.pDynamicStates = pInfo->dynamicStates;
+
+
+    pInfo->pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pInfo->pipelineInfo.pNext = NULL;
+    pInfo->pipelineInfo.flags = 0;
+    pInfo->pipelineInfo.stageCount = ocCountOf(pInfo->stages);
+    pInfo->pipelineInfo.pStages = pInfo->stages;
+    pInfo->pipelineInfo.pVertexInputState = &pInfo->vertexInputStateInfo;
+    pInfo->pipelineInfo.pInputAssemblyState = &pInfo->inputAssemblyStateInfo;
+    pInfo->pipelineInfo.pTessellationState = NULL; // <-- No tessellation at the moment.
+    pInfo->pipelineInfo.pViewportState = &pInfo->viewportStateInfo;
+    pInfo->pipelineInfo.pRasterizationState = &pInfo->rasterizationStateInfo;
+    pInfo->pipelineInfo.pMultisampleState = &pInfo->multisampleStateInfo;
+    pInfo->pipelineInfo.pDepthStencilState = &pInfo->depthStencilStateInfo;
+    pInfo->pipelineInfo.pColorBlendState = &pInfo->colorBlendStateInfo;
+    pInfo->pipelineInfo.pDynamicState = &pInfo->dynamicStateInfo;
+    pInfo->pipelineInfo.layout = pGraphics->mainPipeline_Layout;
+    pInfo->pipelineInfo.renderPass = pGraphics->renderPass0;
+    pInfo->pipelineInfo.subpass = 0;
+    pInfo->pipelineInfo.basePipelineHandle = NULL;
+    pInfo->pipelineInfo.basePipelineIndex = 0;
+}
+
+// Creates one of the main pipelines and stores it in the context. This is thread safe so long as no two threads create the same pipeline.
+OC_PRIVATE ocResult ocvkCreateMainPipeline(ocGraphicsContext* pGraphics, ocGraphicsVertexFormat vertexFormat, ocGraphicsPrimitiveType primitiveType)
+{
+    ocAssert(pGraphics != NULL);
+    ocAssert((pGraphics->mainPipelinesSupported[vertexFormat] & (1 << primitiveType)) != 0);
 
-    VkPipelineDynamicStateCreateInfo dynamicStateInfo;
-    dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicStateInfo.pNext = NULL;
-    dynamicStateInfo.flags = 0;
-    dynamicStateInfo.dynamicStateCount = ocCountOf(pDynamicStates);
-    dynamicStateInfo.pDynamicStates = pDynamicStates;
-
-
-    // Layout.
-    // TODO: Move the descriptor set creation stuff to the top with the shaders. Can also move this out of the pipeline creation routine.
-    VkDescriptorSetLayoutBinding pBindings[3];
-    pBindings[0].binding = 0;
-    pBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    pBindings[0].descriptorCount = 1;
-    pBindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    pBindings[0].pImmutableSamplers = NULL;
-    pBindings[1].binding = 1;
-    pBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    pBindings[1].descriptorCount = 1;
-    pBindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    pBindings[1].pImmutableSamplers = NULL;
-    pBindings[2].binding = 2;
-    pBindings[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    pBindings[2].descriptorCount = 1;
-    pBindings[2].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-    pBindings[2].pImmutableSamplers = NULL;
+    ocvkMainPipelineCreateInfo info;
+    ocvkInitMainPipelineCreateInfo(pGraphics, vertexFormat, primitiveType, &info);
+
+    VkPipeline pipeline;
+    VkResult vkresult = vkCreateGraphicsPipelines(pGraphics->device, pGraphics->pipelineCache, 1, &info.pipelineInfo, NULL, &pipeline);
+    if (vkresult != VK_SUCCESS) {
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    pGraphics->mainPipelines[vertexFormat][primitiveType] = pipeline;
+    return OC_SUCCESS;
+}
+
+struct ocvkMainPipelineJob
+{
+    ocGraphicsContext* pGraphics;
+    ocGraphicsVertexFormat vertexFormat;
+    ocGraphicsPrimitiveType primitiveType;
+    ocResult result;
+};
+
+OC_PRIVATE void ocvkMainPipelineJobProc(void* pUserData)
+{
+    ocvkMainPipelineJob* pJob = (ocvkMainPipelineJob*)pUserData;
+    ocAssert(pJob != NULL);
+
+    pJob->result = ocvkCreateMainPipeline(pJob->pGraphics, pJob->vertexFormat, pJob->primitiveType);
+}
+
+// Retrieves the main pipeline for the given vertex format and primitive type, creating it if it's not on the warm-up list and this is the
+// first time it's been used. Returns NULL if the combination is not supported or the pipeline failed to be created.
+OC_PRIVATE VkPipeline ocvkGetMainPipeline(ocGraphicsContext* pGraphics, ocGraphicsVertexFormat vertexFormat, ocGraphicsPrimitiveType primitiveType)
+{
+    ocAssert(pGraphics != NULL);
+
+    VkPipeline pipeline = pGraphics->mainPipelines[vertexFormat][primitiveType];
+    if (pipeline != NULL) {
+        return pipeline;
+    }
+
+    uint32_t primitiveBit = (1 << primitiveType);
+    if ((pGraphics->mainPipelinesSupported[vertexFormat] & primitiveBit) == 0 || (pGraphics->mainPipelinesFailed[vertexFormat] & primitiveBit) != 0) {
+        return NULL;
+    }
+
+    ocResult result = ocvkCreateMainPipeline(pGraphics, vertexFormat, primitiveType);
+    if (result != OC_SUCCESS) {
+        pGraphics->mainPipelinesFailed[vertexFormat] |= primitiveBit;   // <-- Don't keep trying every frame.
+        ocWarningf(pGraphics->pEngine, "Failed to create pipeline for vertex format %d and primitive type %d.", vertexFormat, primitiveType);
+        return NULL;
+    }
+
+    return pGraphics->mainPipelines[vertexFormat][primitiveType];
+}
+
+// Creates the pipeline for particles from the base variant of the Particle pipeline. Particles are camera facing quads that are expanded
+// in the vertex shader, so the only vertex input is the instance data. They're blended with premultiplied alpha and tested against the
+// depth buffer without writing to it. Everything else is the same as the main pipelines, including the layout.
+OC_PRIVATE ocResult ocvkCreateParticlePipeline(ocGraphicsContext* pGraphics)
+{
+    ocAssert(pGraphics != NULL);
+
+    const ocvkPipelineVariant* pVariant = NULL;
+    for (size_t iVariant = 0; iVariant < ocCountOf(g_ocPipelineVariants); ++iVariant) {
+        if (strcmp(g_ocPipelineVariants[iVariant].pipelineName, "Particle") == 0 && g_ocPipelineVariants[iVariant].keywords[0] == '\0') {
+            pVariant = &g_ocPipelineVariants[iVariant];
+            break;
+        }
+    }
+
+    if (pVariant == NULL) {
+        return OC_DOES_NOT_EXIST;   // <-- The generated code is out of date. Run oc_build.
+    }
+
+    VkResult vkresult = ocvkCreateShaderModule(pGraphics->device, pVariant->vertexShaderCodeSize, (const uint32_t*)pVariant->pVertexShaderCode, NULL, &pGraphics->particlePipeline_VS);
+    if (vkresult != VK_SUCCESS) {
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    vkresult = ocvkCreateShaderModule(pGraphics->device, pVariant->fragmentShaderCodeSize, (const uint32_t*)pVariant->pFragmentShaderCode, NULL, &pGraphics->particlePipeline_FS);
+    if (vkresult != VK_SUCCESS) {
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    ocvkMainPipelineCreateInfo info;
+    ocvkInitMainPipelineCreateInfo(pGraphics, pVariant->vertexFormat, ocGraphicsPrimitiveType_Triangle, &info);
+
+    info.stages[0].module = pGraphics->particlePipeline_VS;
+    info.stages[1].module = pGraphics->particlePipeline_FS;
+
+    // Vertex Input. Must match ocParticleInstance.
+    info.vertexAttributeDescriptions[0].location = 0;
+    info.vertexAttributeDescriptions[0].binding = 0;
+    info.vertexAttributeDescriptions[0].format = VK_FORMAT_R32G32B32A32_SFLOAT;     // <-- Position and size.
+    info.vertexAttributeDescriptions[0].offset = 0;
+    info.vertexAttributeDescriptions[1].location = 1;
+    info.vertexAttributeDescriptions[1].binding = 0;
+    info.vertexAttributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;     // <-- Color.
+    info.vertexAttributeDescriptions[1].offset = sizeof(float) * 4;
+    info.vertexInputStateInfo.vertexAttributeDescriptionCount = 2;
+
+    info.vertexBindingDescriptions[0].binding = 0;
+    info.vertexBindingDescriptions[0].stride = sizeof(ocParticleInstance);
+    info.vertexBindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    // Quads always face the camera so there's nothing to cull.
+    info.rasterizationStateInfo.cullMode = VK_CULL_MODE_NONE;
+
+    // Particles aren't sorted, so they must not write depth or they'd hide each other depending on the draw order.
+    info.depthStencilStateInfo.depthWriteEnable = VK_FALSE;
+
+    // Premultiplied alpha.
+    info.colorBlendStateAttachments[0].blendEnable = VK_TRUE;
+    info.colorBlendStateAttachments[0].srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    info.colorBlendStateAttachments[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    info.colorBlendStateAttachments[0].colorBlendOp = VK_BLEND_OP_ADD;
+    info.colorBlendStateAttachments[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    info.colorBlendStateAttachments[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    info.colorBlendStateAttachments[0].alphaBlendOp = VK_BLEND_OP_ADD;
+
+    vkresult = vkCreateGraphicsPipelines(pGraphics->device, pGraphics->pipelineCache, 1, &info.pipelineInfo, NULL, &pGraphics->particlePipeline);
+    if (vkresult != VK_SUCCESS) {
+        pGraphics->particlePipeline = NULL;
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    return OC_SUCCESS;
+}
+
+// Destroys the shader modules of the main pipelines. Modules can be shared between vertex formats so make sure each one is only
+// destroyed once.
+OC_PRIVATE void ocvkDestroyMainPipelineModules(ocGraphicsContext* pGraphics)
+{
+    ocAssert(pGraphics != NULL);
+
+    for (uint32_t iVertexFormat = 0; iVertexFormat < ocGraphicsVertexFormat_Count; ++iVertexFormat) {
+        ocBool32 isVSShared = OC_FALSE;
+        ocBool32 isFSShared = OC_FALSE;
+        for (uint32_t iOtherVertexFormat = 0; iOtherVertexFormat < iVertexFormat; ++iOtherVertexFormat) {
+            isVSShared = isVSShared || pGraphics->mainPipeline_VS[iOtherVertexFormat] == pGraphics->mainPipeline_VS[iVertexFormat];
+            isFSShared = isFSShared || pGraphics->mainPipeline_FS[iOtherVertexFormat] == pGraphics->mainPipeline_FS[iVertexFormat];
+        }
+
+        if (pGraphics->mainPipeline_VS[iVertexFormat] != NULL && !isVSShared) {
+            vkDestroyShaderModule(pGraphics->device, pGraphics->mainPipeline_VS[iVertexFormat], NULL);
+        }
+        if (pGraphics->mainPipeline_FS[iVertexFormat] != NULL && !isFSShared) {
+            vkDestroyShaderModule(pGraphics->device, pGraphics->mainPipeline_FS[iVertexFormat], NULL);
+        }
+    }
+
+    ocZeroObject(&pGraphics->mainPipeline_VS);
+    ocZeroObject(&pGraphics->mainPipeline_FS);
+    ocZeroObject(&pGraphics->mainPipelinesSupported);
+}
+
+// Creates the shader modules of the main pipelines. There's a pair for each vertex format supported by the base variant of the default
+// pipeline. If any of them fail, the ones that were already created are destroyed.
+OC_PRIVATE ocResult ocvkCreateMainPipelineModules(ocGraphicsContext* pGraphics, uint32_t* pWarmUpPrimitiveTypes)
+{
+    ocAssert(pGraphics != NULL);
+    ocAssert(pWarmUpPrimitiveTypes != NULL);
+
+    VkResult vkresult = VK_SUCCESS;
+    ocZeroObject(&pGraphics->mainPipeline_VS);
+    ocZeroObject(&pGraphics->mainPipeline_FS);
+    ocZeroObject(&pGraphics->mainPipelinesSupported);
+    for (uint32_t iVertexFormat = 0; iVertexFormat < ocGraphicsVertexFormat_Count; ++iVertexFormat) {
+        pWarmUpPrimitiveTypes[iVertexFormat] = 0;
+    }
+
+    for (size_t iVariant = 0; iVariant < ocCountOf(g_ocPipelineVariants); ++iVariant) {
+        const ocvkPipelineVariant* pVariant = &g_ocPipelineVariants[iVariant];
+        if (strcmp(pVariant->pipelineName, "Default") != 0 || pVariant->keywords[0] != '\0') {
+            continue;
+        }
+
+        ocGraphicsVertexFormat vertexFormat = pVariant->vertexFormat;
+        if (pGraphics->mainPipeline_VS[vertexFormat] != NULL) {
+            continue;   // <-- Already created.
+        }
+
+        // Variants with identical code point to the same array which means they can share the same module.
+        for (size_t iOtherVariant = 0; iOtherVariant < iVariant; ++iOtherVariant) {
+            const ocvkPipelineVariant* pOtherVariant = &g_ocPipelineVariants[iOtherVariant];
+            if (strcmp(pOtherVariant->pipelineName, "Default") != 0 || pOtherVariant->keywords[0] != '\0') {
+                continue;
+            }
+
+            if (pGraphics->mainPipeline_VS[pOtherVariant->vertexFormat] != NULL) {
+                if (pOtherVariant->pVertexShaderCode == pVariant->pVertexShaderCode) {
+                    pGraphics->mainPipeline_VS[vertexFormat] = pGraphics->mainPipeline_VS[pOtherVariant->vertexFormat];
+                }
+                if (pOtherVariant->pFragmentShaderCode == pVariant->pFragmentShaderCode) {
+                    pGraphics->mainPipeline_FS[vertexFormat] = pGraphics->mainPipeline_FS[pOtherVariant->vertexFormat];
+                }
+            }
+        }
+
+        if (pGraphics->mainPipeline_VS[vertexFormat] == NULL) {
+            vkresult = ocvkCreateShaderModule(pGraphics->device, pVariant->vertexShaderCodeSize, (const uint32_t*)pVariant->pVertexShaderCode, NULL, &pGraphics->mainPipeline_VS[vertexFormat]);
+            if (vkresult != VK_SUCCESS) {
+                pGraphics->mainPipeline_VS[vertexFormat] = NULL;
+                goto on_error;
+            }
+        }
+
+        if (pGraphics->mainPipeline_FS[vertexFormat] == NULL) {
+            vkresult = ocvkCreateShaderModule(pGraphics->device, pVariant->fragmentShaderCodeSize, (const uint32_t*)pVariant->pFragmentShaderCode, NULL, &pGraphics->mainPipeline_FS[vertexFormat]);
+            if (vkresult != VK_SUCCESS) {
+                pGraphics->mainPipeline_FS[vertexFormat] = NULL;
+                goto on_error;
+            }
+        }
+
+        pGraphics->mainPipelinesSupported[vertexFormat] |= pVariant->primitiveTypes;
+        pWarmUpPrimitiveTypes[vertexFormat] |= (pVariant->warmUpPrimitiveTypes & pVariant->primitiveTypes);
+    }
+
+    return OC_SUCCESS;
+
+on_error:
+    ocvkDestroyMainPipelineModules(pGraphics);
+    return ocToResultFromVulkan(vkresult);
+}
+
+OC_PRIVATE ocResult ocGraphicsInit_VulkanPipelines(ocGraphicsContext* pGraphics)
+{
+    VkResult vkresult = VK_SUCCESS;
+
+    // Layout. See OC_VK_DESCRIPTOR_SET_FRAME and OC_VK_DESCRIPTOR_SET_IMAGES.
+    VkDescriptorSetLayoutBinding pFrameBindings[5];
+    pFrameBindings[0].binding = 0;
+    pFrameBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;    // <-- Camera.
+    pFrameBindings[0].descriptorCount = 1;
+    pFrameBindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pFrameBindings[0].pImmutableSamplers = NULL;
+    pFrameBindings[1].binding = 1;
+    pFrameBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;    // <-- Objects.
+    pFrameBindings[1].descriptorCount = 1;
+    pFrameBindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pFrameBindings[1].pImmutableSamplers = NULL;
+    pFrameBindings[2].binding = 2;
+    pFrameBindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;    // <-- Bones.
+    pFrameBindings[2].descriptorCount = 1;
+    pFrameBindings[2].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pFrameBindings[2].pImmutableSamplers = NULL;
+    pFrameBindings[3].binding = 3;
+    pFrameBindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;    // <-- Lights.
+    pFrameBindings[3].descriptorCount = 1;
+    pFrameBindings[3].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pFrameBindings[3].pImmutableSamplers = NULL;
+    pFrameBindings[4].binding = 4;
+    pFrameBindings[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;    // <-- Light clusters.
+    pFrameBindings[4].descriptorCount = 1;
+    pFrameBindings[4].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pFrameBindings[4].pImmutableSamplers = NULL;
+
+    VkDescriptorSetLayoutBinding pImageBindings[1];
+    pImageBindings[0].binding = 0;
+    pImageBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pImageBindings[0].descriptorCount = pGraphics->maxImages;
+    pImageBindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pImageBindings[0].pImmutableSamplers = NULL;
 
     VkDescriptorSetLayoutCreateInfo setLayoutInfo;
     setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     setLayoutInfo.pNext = NULL;
     setLayoutInfo.flags = 0;
-    setLayoutInfo.bindingCount = ocCountOf(pBindings);
-    setLayoutInfo.pBindings = pBindings;
-    vkresult = vkCreateDescriptorSetLayout(pGraphics->device, &setLayoutInfo, NULL, &pGraphics->mainPipeline_DescriptorSetLayouts[0]);
+    setLayoutInfo.bindingCount = ocCountOf(pFrameBindings);
+    setLayoutInfo.pBindings = pFrameBindings;
+    vkresult = vkCreateDescriptorSetLayout(pGraphics->device, &setLayoutInfo, NULL, &pGraphics->mainPipeline_DescriptorSetLayouts[OC_VK_DESCRIPTOR_SET_FRAME]);
+    if (vkresult != VK_SUCCESS) {
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    setLayoutInfo.bindingCount = ocCountOf(pImageBindings);
+    setLayoutInfo.pBindings = pImageBindings;
+    vkresult = vkCreateDescriptorSetLayout(pGraphics->device, &setLayoutInfo, NULL, &pGraphics->mainPipeline_DescriptorSetLayouts[OC_VK_DESCRIPTOR_SET_IMAGES]);
     if (vkresult != VK_SUCCESS) {
         return ocToResultFromVulkan(vkresult);
     }
@@ -1176,33 +1640,119 @@ OC_PRIVATE ocResult ocGraphicsInit_VulkanPipelines(ocGraphicsContext* pGraphics)
     }
 
 
-    // Pipeline
-    VkGraphicsPipelineCreateInfo pipelineInfo;
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.pNext = NULL;
-    pipelineInfo.flags = 0;
-    pipelineInfo.stageCount = ocCountOf(pStages);
-    pipelineInfo.pStages = pStages;
-    pipelineInfo.pVertexInputState = &vertexInputStateInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssemblyStateInfo;
-    pipelineInfo.pTessellationState = NULL; // <-- No tessellation at the moment.
-    pipelineInfo.pViewportState = &viewportStateInfo;
-    pipelineInfo.pRasterizationState = &rasterizationStateInfo;
-    pipelineInfo.pMultisampleState = &multisampleStateInfo;
-    pipelineInfo.pDepthStencilState = &depthStencilStateInfo;
-    pipelineInfo.pColorBlendState = &colorBlendStateInfo;
-    pipelineInfo.pDynamicState = &dynamicStateInfo;
-    pipelineInfo.layout = pGraphics->mainPipeline_Layout;
-    pipelineInfo.renderPass = pGraphics->renderPass0;
-    pipelineInfo.subpass = 0;
-    pipelineInfo.basePipelineHandle = NULL;
-    pipelineInfo.basePipelineIndex = 0;
-    vkresult = vkCreateGraphicsPipelines(pGraphics->device, NULL, 1, &pipelineInfo, NULL, &pGraphics->mainPipeline);
-    if (vkresult != VK_SUCCESS) {
-        return ocToResultFromVulkan(vkresult);
+    // Shader modules. Pipelines are created from these below, or the first time they're used.
+    ocZeroObject(&pGraphics->mainPipelines);
+    ocZeroObject(&pGraphics->mainPipelinesFailed);
+    pGraphics->particlePipeline_VS = NULL;
+    pGraphics->particlePipeline_FS = NULL;
+    pGraphics->particlePipeline = NULL;
+
+    uint32_t pWarmUpPrimitiveTypes[ocGraphicsVertexFormat_Count];
+    ocResult result = ocvkCreateMainPipelineModules(pGraphics, pWarmUpPrimitiveTypes);
+    if (result != OC_SUCCESS) {
+        return result;
     }
 
-    return OC_SUCCESS;
+
+    // Pipelines. Only those on the warm-up list generated by oc_build are created here. The rest are created the first time they're used.
+    // Drivers can take a long time to compile a pipeline, even with a warm cache, so each one is created on the job queue in parallel.
+    const uint32_t maxPipelineCount = ocGraphicsVertexFormat_Count * ocGraphicsPrimitiveType_Count;
+    ocvkMainPipelineJob pJobs[maxPipelineCount];
+    uint32_t jobCount = 0;
+    uint32_t supportedCount = 0;
+    for (uint32_t iVertexFormat = 0; iVertexFormat < ocGraphicsVertexFormat_Count; ++iVertexFormat) {
+        for (uint32_t iPrimitiveType = 0; iPrimitiveType < ocGraphicsPrimitiveType_Count; ++iPrimitiveType) {
+            if ((pGraphics->mainPipelinesSupported[iVertexFormat] & (1 << iPrimitiveType)) == 0) {
+                continue;
+            }
+
+            supportedCount += 1;
+
+            if ((pWarmUpPrimitiveTypes[iVertexFormat] & (1 << iPrimitiveType)) != 0) {
+                pJobs[jobCount].pGraphics = pGraphics;
+                pJobs[jobCount].vertexFormat = (ocGraphicsVertexFormat)iVertexFormat;
+                pJobs[jobCount].primitiveType = (ocGraphicsPrimitiveType)iPrimitiveType;
+                pJobs[jobCount].result = OC_ERROR;
+                jobCount += 1;
+            }
+        }
+    }
+
+    if (supportedCount == 0) {
+        ocvkDestroyMainPipelineModules(pGraphics);
+        return OC_ERROR;    // <-- The generated code is out of date. Run oc_build.
+    }
+
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    ocJobQueue* pJobQueue = &pGraphics->pEngine->jobQueue;
+    ocUInt32 jobCounter = 0;
+    for (uint32_t iJob = 0; iJob < jobCount; ++iJob) {
+        if (ocJobQueueSubmit(pJobQueue, ocvkMainPipelineJobProc, &pJobs[iJob], &jobCounter) != OC_SUCCESS) {
+            ocvkMainPipelineJobProc(&pJobs[iJob]);
+        }
+    }
+
+    ocJobQueueWaitForCounter(pJobQueue, &jobCounter);
+
+    for (uint32_t iJob = 0; iJob < jobCount; ++iJob) {
+        if (pJobs[iJob].result != OC_SUCCESS) {
+            pGraphics->mainPipelinesFailed[pJobs[iJob].vertexFormat] |= (1 << pJobs[iJob].primitiveType);
+            if (result == OC_SUCCESS) {
+                result = pJobs[iJob].result;
+            }
+        }
+    }
+
+    ocLogf(pGraphics->pEngine, "Created %u of %u pipelines in %f seconds. The rest will be created on first use.", jobCount, supportedCount, ocTimerTick(&timer));
+
+    // Particles are not drawn without their pipeline, but that's not worth failing over.
+    if (ocvkCreateParticlePipeline(pGraphics) != OC_SUCCESS) {
+        ocWarningf(pGraphics->pEngine, "Failed to create the particle pipeline. Particles will not be drawn.");
+    }
+
+    return result;
+}
+
+OC_PRIVATE void ocGraphicsUninit_VulkanPipelines(ocGraphicsContext* pGraphics)
+{
+    ocAssert(pGraphics != NULL);
+
+    for (uint32_t iVertexFormat = 0; iVertexFormat < ocGraphicsVertexFormat_Count; ++iVertexFormat) {
+        for (uint32_t iPrimitiveType = 0; iPrimitiveType < ocGraphicsPrimitiveType_Count; ++iPrimitiveType) {
+            if (pGraphics->mainPipelines[iVertexFormat][iPrimitiveType] != NULL) {
+                vkDestroyPipeline(pGraphics->device, pGraphics->mainPipelines[iVertexFormat][iPrimitiveType], NULL);
+            }
+        }
+    }
+
+    if (pGraphics->particlePipeline != NULL) {
+        vkDestroyPipeline(pGraphics->device, pGraphics->particlePipeline, NULL);
+    }
+    if (pGraphics->particlePipeline_VS != NULL) {
+        vkDestroyShaderModule(pGraphics->device, pGraphics->particlePipeline_VS, NULL);
+    }
+    if (pGraphics->particlePipeline_FS != NULL) {
+        vkDestroyShaderModule(pGraphics->device, pGraphics->particlePipeline_FS, NULL);
+    }
+
+    ocvkDestroyMainPipelineModules(pGraphics);
+
+    if (pGraphics->mainPipeline_Layout != NULL) {
+        vkDestroyPipelineLayout(pGraphics->device, pGraphics->mainPipeline_Layout, NULL);
+    }
+    for (uint32_t iSet = 0; iSet < OC_VK_DESCRIPTOR_SET_COUNT; ++iSet) {
+        if (pGraphics->mainPipeline_DescriptorSetLayouts[iSet] != NULL) {
+            vkDestroyDescriptorSetLayout(pGraphics->device, pGraphics->mainPipeline_DescriptorSetLayouts[iSet], NULL);
+        }
+    }
+
+    // The cache is saved last so it includes every pipeline that was created on first use.
+    if (pGraphics->pipelineCache != NULL) {
+        ocGraphicsSave_VulkanPipelineCache(pGraphics);
+        vkDestroyPipelineCache(pGraphics->device, pGraphics->pipelineCache, NULL);
+    }
 }
 
 OC_PRIVATE ocResult ocGraphicsInit_VulkanSamplers(ocGraphicsContext* pGraphics)
@@ -1245,51 +1795,90 @@ OC_PRIVATE ocResult ocGraphicsInit_VulkanSamplers(ocGraphicsContext* pGraphics)
     return OC_SUCCESS;
 }
 
-OC_PRIVATE ocResult ocGraphicsInit_Vulkan(ocGraphicsContext* pGraphics, uint32_t desiredMSAASamples)
+OC_PRIVATE void ocvkWriteImageDescriptor(ocGraphicsContext* pGraphics, uint32_t imageIndex, const VkDescriptorImageInfo* pDescriptor)
 {
-    ocResult result = ocGraphicsInit_VulkanInstance(pGraphics);
-    if (result != OC_SUCCESS) {
-        return result;
+    ocAssert(pGraphics != NULL);
+    ocAssert(imageIndex < pGraphics->maxImages);
+
+    VkWriteDescriptorSet descriptorWrite;
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.pNext = NULL;
+    descriptorWrite.dstSet = pGraphics->imageDescriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = imageIndex;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.pImageInfo = pDescriptor;
+    descriptorWrite.pBufferInfo = NULL;
+    descriptorWrite.pTexelBufferView = NULL;
+    vkUpdateDescriptorSets(pGraphics->device, 1, &descriptorWrite, 0, NULL);
+}
+
+// Allocates an index in the image array. Indices released by deleted images are reused first.
+OC_PRIVATE ocResult ocvkAllocateImageIndex(ocGraphicsContext* pGraphics, uint32_t* pImageIndex)
+{
+    ocAssert(pGraphics != NULL);
+    ocAssert(pImageIndex != NULL);
+
+    if (ocStackTop(&pGraphics->freeImageIndices, pImageIndex) == OC_SUCCESS) {
+        ocStackPop(&pGraphics->freeImageIndices);
+        return OC_SUCCESS;
     }
 
-    result = ocGraphicsInit_VulkanDevices(pGraphics, desiredMSAASamples);
-    if (result != OC_SUCCESS) {
-        return result;
+    if (pGraphics->nextImageIndex == pGraphics->maxImages) {
+        return OC_TOO_MANY_IMAGES;
     }
 
-    result = ocGraphicsInit_VulkanRenderPasses(pGraphics);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
+    *pImageIndex = pGraphics->nextImageIndex;
+    pGraphics->nextImageIndex += 1;
+    return OC_SUCCESS;
+}
 
-    result = ocGraphicsInit_VulkanPipelines(pGraphics);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
+// Releases an index in the image array. The index is pointed back at the default image so that anything still referring to it is valid.
+OC_PRIVATE void ocvkReleaseImageIndex(ocGraphicsContext* pGraphics, uint32_t imageIndex)
+{
+    ocAssert(pGraphics != NULL);
 
-    result = ocGraphicsInit_VulkanSamplers(pGraphics);
-    if (result != OC_SUCCESS) {
-        return result;
+    if (pGraphics->pDefaultImage != NULL) {
+        ocvkWriteImageDescriptor(pGraphics, imageIndex, &pGraphics->pDefaultImage->descriptor);
     }
 
+    ocStackPush(&pGraphics->freeImageIndices, imageIndex);
+}
 
-    // TODO: Re-asses how we manage descriptor pools. Currently thinking we have one pool for known pipelines like the final composition and
-    // then a bunch of other pools for different material types.
-    VkDescriptorPoolSize pPoolSizes[2];
-    pPoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    pPoolSizes[0].descriptorCount = 1024;
-    pPoolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    pPoolSizes[1].descriptorCount = 1024;
+OC_PRIVATE ocResult ocGraphicsInit_VulkanDescriptors(ocGraphicsContext* pGraphics)
+{
+    ocAssert(pGraphics != NULL);
+
+    // The persistent pool only needs to hold the image set. Per-material sets will come from here once materials are implemented.
+    VkDescriptorPoolSize pPoolSizes[1];
+    pPoolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pPoolSizes[0].descriptorCount = pGraphics->maxImages;
 
     VkDescriptorPoolCreateInfo descriptorPoolInfo;
     descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     descriptorPoolInfo.pNext = NULL;
     descriptorPoolInfo.flags = 0;
-    descriptorPoolInfo.maxSets = 1024;
+    descriptorPoolInfo.maxSets = 1;
     descriptorPoolInfo.poolSizeCount = ocCountOf(pPoolSizes);
     descriptorPoolInfo.pPoolSizes = pPoolSizes;
     VkResult vkresult = vkCreateDescriptorPool(pGraphics->device, &descriptorPoolInfo, NULL, &pGraphics->descriptorPool);
-    if (vkresult != NULL) {
+    if (vkresult != VK_SUCCESS) {
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    // The frame pool is never freed from. It's reset as a whole at the start of each draw.
+    VkDescriptorPoolSize pFramePoolSizes[2];
+    pFramePoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    pFramePoolSizes[0].descriptorCount = OC_VK_MAX_FRAME_DESCRIPTOR_SETS;
+    pFramePoolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pFramePoolSizes[1].descriptorCount = OC_VK_MAX_FRAME_DESCRIPTOR_SETS * 4;   // <-- Objects, bones, lights and light clusters.
+
+    descriptorPoolInfo.maxSets = OC_VK_MAX_FRAME_DESCRIPTOR_SETS;
+    descriptorPoolInfo.poolSizeCount = ocCountOf(pFramePoolSizes);
+    descriptorPoolInfo.pPoolSizes = pFramePoolSizes;
+    vkresult = vkCreateDescriptorPool(pGraphics->device, &descriptorPoolInfo, NULL, &pGraphics->frameDescriptorPool);
+    if (vkresult != VK_SUCCESS) {
         return ocToResultFromVulkan(vkresult);
     }
 
@@ -1298,12 +1887,125 @@ OC_PRIVATE ocResult ocGraphicsInit_Vulkan(ocGraphicsContext* pGraphics, uint32_t
     descriptorSetAllocInfo.pNext = NULL;
     descriptorSetAllocInfo.descriptorPool = pGraphics->descriptorPool;
     descriptorSetAllocInfo.descriptorSetCount = 1;
-    descriptorSetAllocInfo.pSetLayouts = pGraphics->mainPipeline_DescriptorSetLayouts;
-    vkresult = vkAllocateDescriptorSets(pGraphics->device, &descriptorSetAllocInfo, &pGraphics->mainPipeline_DescriptorSets[0]);
+    descriptorSetAllocInfo.pSetLayouts = &pGraphics->mainPipeline_DescriptorSetLayouts[OC_VK_DESCRIPTOR_SET_IMAGES];
+    vkresult = vkAllocateDescriptorSets(pGraphics->device, &descriptorSetAllocInfo, &pGraphics->imageDescriptorSet);
     if (vkresult != VK_SUCCESS) {
         return ocToResultFromVulkan(vkresult);
     }
 
+    ocStackInit(&pGraphics->freeImageIndices);
+    pGraphics->nextImageIndex = 0;
+
+
+    // The default image. This is the first image to be created so it always gets index 0.
+    ocUInt8 pWhitePixel[4] = {255, 255, 255, 255};
+
+    ocMipmapInfo mipmap;
+    mipmap.dataOffset = 0;
+    mipmap.dataSize   = sizeof(pWhitePixel);
+    mipmap.width      = 1;
+    mipmap.height     = 1;
+
+    ocGraphicsImageDesc desc;
+    desc.format        = ocImageFormat_R8G8B8A8;
+    desc.usage         = OC_GRAPHICS_IMAGE_USAGE_SHADER_INPUT;
+    desc.mipLevels     = 1;
+    desc.pMipmaps      = &mipmap;
+    desc.imageDataSize = sizeof(pWhitePixel);
+    desc.pImageData    = pWhitePixel;
+    ocResult result = ocGraphicsCreateImage(pGraphics, &desc, &pGraphics->pDefaultImage);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocAssert(pGraphics->pDefaultImage->imageIndex == 0);
+
+    // Every element of the array must be valid when it's used by a pipeline so the ones that have not yet been used are pointed at the
+    // default image. This is done once here so that creating an image only needs to write it's own element.
+    VkDescriptorImageInfo* pDefaultDescriptors = (VkDescriptorImageInfo*)ocMalloc(sizeof(*pDefaultDescriptors) * pGraphics->maxImages);
+    if (pDefaultDescriptors == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    for (uint32_t iImage = 0; iImage < pGraphics->maxImages; ++iImage) {
+        pDefaultDescriptors[iImage] = pGraphics->pDefaultImage->descriptor;
+    }
+
+    VkWriteDescriptorSet descriptorWrite;
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.pNext = NULL;
+    descriptorWrite.dstSet = pGraphics->imageDescriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorCount = pGraphics->maxImages;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.pImageInfo = pDefaultDescriptors;
+    descriptorWrite.pBufferInfo = NULL;
+    descriptorWrite.pTexelBufferView = NULL;
+    vkUpdateDescriptorSets(pGraphics->device, 1, &descriptorWrite, 0, NULL);
+
+    ocFree(pDefaultDescriptors);
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocGraphicsUninit_VulkanDescriptors(ocGraphicsContext* pGraphics)
+{
+    ocAssert(pGraphics != NULL);
+
+    if (pGraphics->pDefaultImage != NULL) {
+        ocGraphicsImage* pDefaultImage = pGraphics->pDefaultImage;
+        pGraphics->pDefaultImage = NULL;
+        ocGraphicsDeleteImage(pGraphics, pDefaultImage);
+    }
+
+    if (pGraphics->frameDescriptorPool != NULL) {
+        vkDestroyDescriptorPool(pGraphics->device, pGraphics->frameDescriptorPool, NULL);
+    }
+    if (pGraphics->descriptorPool != NULL) {
+        vkDestroyDescriptorPool(pGraphics->device, pGraphics->descriptorPool, NULL);    // <-- Frees the image set.
+    }
+
+    ocStackUninit(&pGraphics->freeImageIndices);
+}
+
+OC_PRIVATE ocResult ocGraphicsInit_Vulkan(ocGraphicsContext* pGraphics, uint32_t desiredMSAASamples)
+{
+    ocResult result = ocGraphicsInit_VulkanInstance(pGraphics);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocGraphicsInit_VulkanDevices(pGraphics, desiredMSAASamples);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocGraphicsInit_VulkanRenderPasses(pGraphics);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocGraphicsInit_VulkanPipelineCache(pGraphics);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocGraphicsInit_VulkanPipelines(pGraphics);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocGraphicsInit_VulkanSamplers(pGraphics);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+
+    result = ocGraphicsInit_VulkanDescriptors(pGraphics);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
     return OC_SUCCESS;
 }
 
@@ -1339,6 +2041,9 @@ OC_PRIVATE void ocGraphicsUninit_Vulkan(ocGraphicsContext* pGraphics)
 
     // TODO: Implement this fully.
 
+    ocGraphicsUninit_VulkanDescriptors(pGraphics);
+    ocGraphicsUninit_VulkanPipelines(pGraphics);
+
     vkDestroyInstance(pGraphics->instance, NULL);
     vkbUninit();
 }
@@ -1757,6 +2462,21 @@ ocResult ocGraphicsCreateImage(ocGraphicsContext* pGraphics, ocGraphicsImageDesc
     pImage->descriptor.imageView = pImage->imageViewVK;
     pImage->descriptor.sampler = pGraphics->sampler_Nearest;
 
+    // Images that can be used as shader input are added to the image array. This is the only time the descriptor is written.
+    pImage->imageIndex = 0;
+    if (ocIsBitSet(pDesc->usage, OC_GRAPHICS_IMAGE_USAGE_SHADER_INPUT)) {
+        ocResult result = ocvkAllocateImageIndex(pGraphics, &pImage->imageIndex);
+        if (result != OC_SUCCESS) {
+            vkDestroyImageView(pGraphics->device, pImage->imageViewVK, NULL);
+            vkDestroyImage(pGraphics->device, pImage->imageVK, NULL);
+            vkFreeMemory(pGraphics->device, pImage->imageMemoryVK, NULL);
+            ocFree(pImage);
+            return result;
+        }
+
+        ocvkWriteImageDescriptor(pGraphics, pImage->imageIndex, &pImage->descriptor);
+    }
+
     *ppImage = pImage;
     return OC_SUCCESS;
 }
@@ -1765,8 +2485,35 @@ void ocGraphicsDeleteImage(ocGraphicsContext* pGraphics, ocGraphicsImage* pImage
 {
     if (pGraphics == NULL || pImage == NULL) return;
 
-    vkFreeMemory(pGraphics->device, pImage->imageVK, NULL);
+    if ((pImage->usage & VK_IMAGE_USAGE_SAMPLED_BIT) != 0) {
+        ocvkReleaseImageIndex(pGraphics, pImage->imageIndex);
+    }
+
+    vkDestroyImageView(pGraphics->device, pImage->imageViewVK, NULL);
     vkDestroyImage(pGraphics->device, pImage->imageVK, NULL);
+    vkFreeMemory(pGraphics->device, pImage->imageMemoryVK, NULL);
+    ocFree(pImage);
+}
+
+void ocGraphicsReplaceImage(ocGraphicsContext* pGraphics, ocGraphicsImage* pImage, ocGraphicsImage* pNewImage)
+{
+    if (pGraphics == NULL || pImage == NULL || pNewImage == NULL) return;
+
+    // The descriptor is part of the image so it moves with everything else. The index in the image array stays with pImage since that's
+    // what objects refer to, so it needs to be pointed at the new contents.
+    ocGraphicsImage oldImage = *pImage;
+    *pImage = *pNewImage;
+    *pNewImage = oldImage;
+
+    uint32_t imageIndex = pImage->imageIndex;
+    pImage->imageIndex = pNewImage->imageIndex;
+    pNewImage->imageIndex = imageIndex;
+
+    if ((pImage->usage & VK_IMAGE_USAGE_SAMPLED_BIT) != 0) {
+        ocvkWriteImageDescriptor(pGraphics, pImage->imageIndex, &pImage->descriptor);
+    }
+
+    ocGraphicsDeleteImage(pGraphics, pNewImage);
 }
 
 
@@ -1856,9 +2603,27 @@ ocResult ocGraphicsCreateMesh(ocGraphicsContext* pGraphics, ocGraphicsMeshDesc*
 void ocGraphicsDeleteMesh(ocGraphicsContext* pGraphics, ocGraphicsMesh* pMesh)
 {
     if (pGraphics == NULL || pMesh == NULL) return;
+
+    vkDestroyBuffer(pGraphics->device, pMesh->vertexBufferVK, NULL);
+    vkDestroyBuffer(pGraphics->device, pMesh->indexBufferVK, NULL);
+    vkFreeMemory(pGraphics->device, pMesh->vertexBufferMemory, NULL);
+    vkFreeMemory(pGraphics->device, pMesh->indexBufferMemory, NULL);
     ocFree(pMesh);
 }
 
+void ocGraphicsReplaceMesh(ocGraphicsContext* pGraphics, ocGraphicsMesh* pMesh, ocGraphicsMesh* pNewMesh)
+{
+    if (pGraphics == NULL || pMesh == NULL || pNewMesh == NULL) return;
+
+    // Objects refer to the mesh by pointer and the pipeline is selected from the mesh's format at draw time, so swapping the contents is
+    // all that needs to be done.
+    ocGraphicsMesh oldMesh = *pMesh;
+    *pMesh = *pNewMesh;
+    *pNewMesh = oldMesh;
+
+    ocGraphicsDeleteMesh(pGraphics, pNewMesh);
+}
+
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1867,6 +2632,261 @@ void ocGraphicsDeleteMesh(ocGraphicsContext* pGraphics, ocGraphicsMesh* pMesh)
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+// The number of objects the object buffer can hold when a world is first created. It doubles in size when it runs out of room.
+#define OC_VK_INITIAL_OBJECT_CAPACITY   256
+
+// The number of bone matrices the bone buffer can hold when a world is first created. It doubles in size when it runs out of room.
+#define OC_VK_INITIAL_BONE_CAPACITY     1024
+
+// The number of particle instances the particle buffer can hold when the first particle system is created. It doubles in size when it
+// runs out of room.
+#define OC_VK_INITIAL_PARTICLE_CAPACITY 4096
+
+// The number of lights and light indices the light and light cluster buffers of a render target can hold when it's first created. They
+// double in size when they run out of room.
+#define OC_VK_INITIAL_LIGHT_CAPACITY        64
+#define OC_VK_INITIAL_LIGHT_INDEX_CAPACITY  16384
+
+// Creates a host visible buffer that's permanently mapped. If pOldData is not NULL, oldSize bytes are copied from it into the new buffer.
+OC_PRIVATE ocResult ocvkCreateMappedBuffer(ocGraphicsContext* pGraphics, VkBufferUsageFlags usage, VkDeviceSize size, const void* pOldData, VkDeviceSize oldSize, VkBuffer* pBuffer, VkDeviceMemory* pBufferMemory, void** ppBufferData)
+{
+    ocAssert(pGraphics != NULL);
+    ocAssert(oldSize <= size);
+
+    VkDevice device = pGraphics->device;
+
+    VkBufferCreateInfo bufferInfo;
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.pNext = NULL;
+    bufferInfo.flags = 0;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.queueFamilyIndexCount = 0;
+    bufferInfo.pQueueFamilyIndices = NULL;
+
+    VkBuffer newBuffer;
+    VkResult vkresult = vkCreateBuffer(device, &bufferInfo, NULL, &newBuffer);
+    if (vkresult != VK_SUCCESS) {
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    VkDeviceMemory newBufferMemory;
+    vkresult = ocvkAllocateAndBindBufferMemory(pGraphics->physicalDevice, device, newBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, NULL, &newBufferMemory);
+    if (vkresult != VK_SUCCESS) {
+        vkDestroyBuffer(device, newBuffer, NULL);
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    // Permanently map the buffer.
+    void* pNewBufferData;
+    vkresult = vkMapMemory(device, newBufferMemory, 0, bufferInfo.size, 0, &pNewBufferData);
+    if (vkresult != VK_SUCCESS) {
+        vkFreeMemory(device, newBufferMemory, NULL);
+        vkDestroyBuffer(device, newBuffer, NULL);
+        return ocToResultFromVulkan(vkresult);
+    }
+
+    if (pOldData != NULL) {
+        memcpy(pNewBufferData, pOldData, (size_t)oldSize);
+    }
+
+    *pBuffer = newBuffer;
+    *pBufferMemory = newBufferMemory;
+    *ppBufferData = pNewBufferData;
+
+    return OC_SUCCESS;
+}
+
+// Destroys a buffer created with ocvkCreateMappedBuffer().
+OC_PRIVATE void ocvkDeleteMappedBuffer(ocGraphicsContext* pGraphics, VkBuffer buffer, VkDeviceMemory bufferMemory)
+{
+    ocAssert(pGraphics != NULL);
+
+    if (buffer == NULL) {
+        return;
+    }
+
+    vkUnmapMemory(pGraphics->device, bufferMemory);
+    vkFreeMemory(pGraphics->device, bufferMemory, NULL);
+    vkDestroyBuffer(pGraphics->device, buffer, NULL);
+}
+
+// Makes sure the world's object buffer can hold at least the given number of objects.
+//
+// When the buffer grows a new buffer is created and the existing data is copied over. This relies on the GPU not using the old buffer,
+// which is currently always the case between draws since each draw waits for the queue to become idle.
+OC_PRIVATE ocResult ocvkGraphicsWorldReserveObjects(ocGraphicsWorld* pWorld, uint32_t capacity)
+{
+    ocAssert(pWorld != NULL);
+
+    if (capacity <= pWorld->objectBufferCapacity) {
+        return OC_SUCCESS;
+    }
+
+    uint32_t newCapacity = (pWorld->objectBufferCapacity == 0) ? OC_VK_INITIAL_OBJECT_CAPACITY : pWorld->objectBufferCapacity*2;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+
+    VkBuffer newBuffer;
+    VkDeviceMemory newBufferMemory;
+    void* pNewBufferData;
+    ocResult result = ocvkCreateMappedBuffer(pWorld->pGraphics, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(ocvkObjectData) * newCapacity, pWorld->pObjectBufferData, sizeof(ocvkObjectData) * pWorld->objectBufferCapacity, &newBuffer, &newBufferMemory, &pNewBufferData);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pWorld->objectBuffer, pWorld->objectBufferMemory);
+
+    pWorld->objectBuffer = newBuffer;
+    pWorld->objectBufferMemory = newBufferMemory;
+    pWorld->pObjectBufferData = (ocvkObjectData*)pNewBufferData;
+    pWorld->objectBufferCapacity = newCapacity;
+
+    return OC_SUCCESS;
+}
+
+// Makes sure the world's bone buffer can hold at least the given number of matrices. This works the same way as
+// ocvkGraphicsWorldReserveObjects().
+OC_PRIVATE ocResult ocvkGraphicsWorldReserveBones(ocGraphicsWorld* pWorld, uint32_t capacity)
+{
+    ocAssert(pWorld != NULL);
+
+    if (capacity <= pWorld->boneBufferCapacity) {
+        return OC_SUCCESS;
+    }
+
+    uint32_t newCapacity = (pWorld->boneBufferCapacity == 0) ? OC_VK_INITIAL_BONE_CAPACITY : pWorld->boneBufferCapacity*2;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+
+    VkBuffer newBuffer;
+    VkDeviceMemory newBufferMemory;
+    void* pNewBufferData;
+    ocResult result = ocvkCreateMappedBuffer(pWorld->pGraphics, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(glm::mat4) * newCapacity, pWorld->pBoneBufferData, sizeof(glm::mat4) * pWorld->boneBufferCapacity, &newBuffer, &newBufferMemory, &pNewBufferData);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pWorld->boneBuffer, pWorld->boneBufferMemory);
+
+    pWorld->boneBuffer = newBuffer;
+    pWorld->boneBufferMemory = newBufferMemory;
+    pWorld->pBoneBufferData = (glm::mat4*)pNewBufferData;
+    pWorld->boneBufferCapacity = newCapacity;
+
+    return OC_SUCCESS;
+}
+
+// Makes sure the world's particle buffer can hold at least the given number of instances. This works the same way as
+// ocvkGraphicsWorldReserveObjects(), except the buffer is not created until the first particle system is.
+OC_PRIVATE ocResult ocvkGraphicsWorldReserveParticles(ocGraphicsWorld* pWorld, uint32_t capacity)
+{
+    ocAssert(pWorld != NULL);
+
+    if (capacity <= pWorld->particleBufferCapacity) {
+        return OC_SUCCESS;
+    }
+
+    uint32_t newCapacity = (pWorld->particleBufferCapacity == 0) ? OC_VK_INITIAL_PARTICLE_CAPACITY : pWorld->particleBufferCapacity*2;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+
+    VkBuffer newBuffer;
+    VkDeviceMemory newBufferMemory;
+    void* pNewBufferData;
+    ocResult result = ocvkCreateMappedBuffer(pWorld->pGraphics, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, sizeof(ocParticleInstance) * newCapacity, pWorld->pParticleBufferData, sizeof(ocParticleInstance) * pWorld->particleBufferCapacity, &newBuffer, &newBufferMemory, &pNewBufferData);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pWorld->particleBuffer, pWorld->particleBufferMemory);
+
+    pWorld->particleBuffer = newBuffer;
+    pWorld->particleBufferMemory = newBufferMemory;
+    pWorld->pParticleBufferData = (ocParticleInstance*)pNewBufferData;
+    pWorld->particleBufferCapacity = newCapacity;
+
+    return OC_SUCCESS;
+}
+
+// Makes sure a render target's light buffer can hold at least the given number of lights. This works the same way as
+// ocvkGraphicsWorldReserveObjects(), except the existing data is not kept since the whole buffer is rewritten every time the render
+// target is drawn.
+OC_PRIVATE ocResult ocvkGraphicsRTReserveLights(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT, uint32_t capacity)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(pRT != NULL);
+
+    if (capacity <= pRT->lightBufferCapacity) {
+        return OC_SUCCESS;
+    }
+
+    uint32_t newCapacity = (pRT->lightBufferCapacity == 0) ? OC_VK_INITIAL_LIGHT_CAPACITY : pRT->lightBufferCapacity*2;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+
+    VkBuffer newBuffer;
+    VkDeviceMemory newBufferMemory;
+    void* pNewBufferData;
+    ocResult result = ocvkCreateMappedBuffer(pWorld->pGraphics, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(ocvkLightData) * newCapacity, NULL, 0, &newBuffer, &newBufferMemory, &pNewBufferData);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pRT->lightBuffer, pRT->lightBufferMemory);
+
+    pRT->lightBuffer = newBuffer;
+    pRT->lightBufferMemory = newBufferMemory;
+    pRT->pLightBufferData = (ocvkLightData*)pNewBufferData;
+    pRT->lightBufferCapacity = newCapacity;
+
+    return OC_SUCCESS;
+}
+
+// Makes sure a render target's light cluster buffer can hold at least the given number of light indices. Like the light buffer, the
+// existing data is not kept.
+OC_PRIVATE ocResult ocvkGraphicsRTReserveLightIndices(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT, uint32_t capacity)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(pRT != NULL);
+
+    if (capacity <= pRT->clusterBufferCapacity) {
+        return OC_SUCCESS;
+    }
+
+    uint32_t newCapacity = (pRT->clusterBufferCapacity == 0) ? OC_VK_INITIAL_LIGHT_INDEX_CAPACITY : pRT->clusterBufferCapacity*2;
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+
+    VkDeviceSize size = sizeof(ocvkLightClusterHeader) + sizeof(ocLightClusterRange)*OC_LIGHT_CLUSTER_COUNT + sizeof(uint32_t)*newCapacity;
+
+    VkBuffer newBuffer;
+    VkDeviceMemory newBufferMemory;
+    void* pNewBufferData;
+    ocResult result = ocvkCreateMappedBuffer(pWorld->pGraphics, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, size, NULL, 0, &newBuffer, &newBufferMemory, &pNewBufferData);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pRT->clusterBuffer, pRT->clusterBufferMemory);
+
+    // Lighting stays disabled until the buffer is written.
+    ocZeroObject((ocvkLightClusterHeader*)pNewBufferData);
+
+    pRT->clusterBuffer = newBuffer;
+    pRT->clusterBufferMemory = newBufferMemory;
+    pRT->pClusterBufferData = pNewBufferData;
+    pRT->clusterBufferCapacity = newCapacity;
+
+    return OC_SUCCESS;
+}
+
 ocResult ocGraphicsWorldInit(ocGraphicsContext* pGraphics, ocGraphicsWorld* pWorld)
 {
     ocResult result = ocGraphicsWorldInitBase(pGraphics, pWorld);
@@ -1874,6 +2894,45 @@ ocResult ocGraphicsWorldInit(ocGraphicsContext* pGraphics, ocGraphicsWorld* pWor
         return result;
     }
 
+    // The object and bone buffers are created up front so the frame descriptor set always has something to point to.
+    ocStackInit(&pWorld->freeObjectIndices);
+    result = ocvkGraphicsWorldReserveObjects(pWorld, OC_VK_INITIAL_OBJECT_CAPACITY);
+    if (result != OC_SUCCESS) {
+        ocStackUninit(&pWorld->freeObjectIndices);
+        ocGraphicsWorldUninitBase(pWorld);
+        return result;
+    }
+
+    result = ocvkGraphicsWorldReserveBones(pWorld, OC_VK_INITIAL_BONE_CAPACITY);
+    if (result != OC_SUCCESS) {
+        ocvkDeleteMappedBuffer(pGraphics, pWorld->objectBuffer, pWorld->objectBufferMemory);
+        ocStackUninit(&pWorld->freeObjectIndices);
+        ocGraphicsWorldUninitBase(pWorld);
+        return result;
+    }
+
+    result = ocAnimationWorldInit(&pGraphics->pEngine->jobQueue, &pWorld->animation);
+    if (result != OC_SUCCESS) {
+        ocvkDeleteMappedBuffer(pGraphics, pWorld->boneBuffer, pWorld->boneBufferMemory);
+        ocvkDeleteMappedBuffer(pGraphics, pWorld->objectBuffer, pWorld->objectBufferMemory);
+        ocStackUninit(&pWorld->freeObjectIndices);
+        ocGraphicsWorldUninitBase(pWorld);
+        return result;
+    }
+
+    result = ocParticleWorldInit(&pGraphics->pEngine->jobQueue, &pWorld->particles);
+    if (result != OC_SUCCESS) {
+        ocAnimationWorldUninit(&pWorld->animation);
+        ocvkDeleteMappedBuffer(pGraphics, pWorld->boneBuffer, pWorld->boneBufferMemory);
+        ocvkDeleteMappedBuffer(pGraphics, pWorld->objectBuffer, pWorld->objectBufferMemory);
+        ocStackUninit(&pWorld->freeObjectIndices);
+        ocGraphicsWorldUninitBase(pWorld);
+        return result;
+    }
+
+    ocStackInit(&pWorld->lights);
+    ocStackInit(&pWorld->lightSpheres);
+
     pWorld->pObjects = new std::vector<ocGraphicsObject*>();
 
     return OC_SUCCESS;
@@ -1883,6 +2942,17 @@ void ocGraphicsWorldUninit(ocGraphicsWorld* pWorld)
 {
     if (pWorld == NULL) return;
 
+    ocParticleWorldUninit(&pWorld->particles);
+    ocAnimationWorldUninit(&pWorld->animation);
+
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pWorld->particleBuffer, pWorld->particleBufferMemory);
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pWorld->boneBuffer, pWorld->boneBufferMemory);
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pWorld->objectBuffer, pWorld->objectBufferMemory);
+
+    ocStackUninit(&pWorld->freeObjectIndices);
+    ocStackUninit(&pWorld->lightSpheres);
+    ocStackUninit(&pWorld->lights);
+
     delete pWorld->pObjects;
     ocGraphicsWorldUninitBase(pWorld);
 }
@@ -1897,51 +2967,230 @@ void ocGraphicsWorldDraw(ocGraphicsWorld* pWorld)
     }
 }
 
+OC_PRIVATE ocBool32 ocvkIsClusteredLight(const ocGraphicsObject* pObject)
+{
+    return pObject->type == ocGraphicsObjectType_PointLight || pObject->type == ocGraphicsObjectType_SpotLight;
+}
+
+// Converts a light object to the render target's view space.
+OC_PRIVATE ocvkLightData ocvkMakeLightData(const ocGraphicsObject* pObject, const glm::mat4 &view)
+{
+    ocvkLightData light;
+    ocZeroObject(&light);
+
+    glm::vec3 position = glm::vec3(view * glm::vec4(glm::vec3(pObject->_position), 1));
+    glm::vec3 direction;
+
+    switch (pObject->type)
+    {
+        case ocGraphicsObjectType_AmbientLight:
+        {
+            light.type  = OC_VK_LIGHT_TYPE_AMBIENT;
+            light.color = glm::vec4(pObject->data.ambientLight.color.r, pObject->data.ambientLight.color.g, pObject->data.ambientLight.color.b, 1);
+        } break;
+
+        case ocGraphicsObjectType_DirectionalLight:
+        {
+            direction = glm::normalize(glm::mat3(view) * pObject->data.directionalLight.direction);
+
+            light.type  = OC_VK_LIGHT_TYPE_DIRECTIONAL;
+            light.color = glm::vec4(pObject->data.directionalLight.color.r, pObject->data.directionalLight.color.g, pObject->data.directionalLight.color.b, 1);
+            light.directionCosOuter = glm::vec4(direction, 0);
+        } break;
+
+        case ocGraphicsObjectType_PointLight:
+        {
+            light.type  = OC_VK_LIGHT_TYPE_POINT;
+            light.color = glm::vec4(pObject->data.pointLight.color.r, pObject->data.pointLight.color.g, pObject->data.pointLight.color.b, 1);
+            light.positionRadius = glm::vec4(position, pObject->data.pointLight.radius);
+            light.attenuation    = pObject->data.pointLight.attenuation;
+        } break;
+
+        case ocGraphicsObjectType_SpotLight:
+        {
+            direction = glm::normalize(glm::mat3(view) * (pObject->_rotation * glm::vec3(0, 0, -1)));
+
+            light.type  = OC_VK_LIGHT_TYPE_SPOT;
+            light.color = glm::vec4(pObject->data.spotLight.color.r, pObject->data.spotLight.color.g, pObject->data.spotLight.color.b, 1);
+            light.positionRadius    = glm::vec4(position, pObject->data.spotLight.radius);
+            light.directionCosOuter = glm::vec4(direction, cosf(pObject->data.spotLight.angleOuter));
+            light.cosInner          = cosf(pObject->data.spotLight.angleInner);
+            light.attenuation       = pObject->data.spotLight.attenuation;
+        } break;
+
+        default: break;
+    }
+
+    return light;
+}
+
+// Writes the world's lights to the light buffer of a render target and assigns them to the clusters of it's view frustum. Point and spot
+// lights are clustered, and go at the start of the light buffer. Ambient and directional lights affect everything, so they go at the end
+// and are not clustered.
+//
+// This must be done before the frame descriptor set is written since the buffers may be recreated. If anything fails, lighting is
+// disabled for this draw rather than drawing with a partially written buffer.
+OC_PRIVATE void ocvkGraphicsRTUpdateLights(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(pRT != NULL);
+
+    ocZeroObject((ocvkLightClusterHeader*)pRT->pClusterBufferData);
+
+    uint32_t lightCount = (uint32_t)pWorld->lights.count;
+    if (lightCount == 0) {
+        return;
+    }
+
+    if (ocvkGraphicsRTReserveLights(pWorld, pRT, lightCount) != OC_SUCCESS || ocStackResize(&pWorld->lightSpheres, lightCount) != OC_SUCCESS) {
+        return;
+    }
+
+    uint32_t clusteredLightCount = 0;
+    for (uint32_t iLight = 0; iLight < lightCount; ++iLight) {
+        ocGraphicsObject* pObject = pWorld->lights.pItems[iLight];
+        if (ocvkIsClusteredLight(pObject)) {
+            ocvkLightData light = ocvkMakeLightData(pObject, pRT->view);
+            pRT->pLightBufferData[clusteredLightCount] = light;
+            pWorld->lightSpheres.pItems[clusteredLightCount] = light.positionRadius;   // <-- Spot lights use the sphere around their whole range.
+            clusteredLightCount += 1;
+        }
+    }
+
+    uint32_t globalLightCount = 0;
+    for (uint32_t iLight = 0; iLight < lightCount; ++iLight) {
+        ocGraphicsObject* pObject = pWorld->lights.pItems[iLight];
+        if (!ocvkIsClusteredLight(pObject)) {
+            pRT->pLightBufferData[clusteredLightCount + globalLightCount] = ocvkMakeLightData(pObject, pRT->view);
+            globalLightCount += 1;
+        }
+    }
+
+    ocLightClusterGridSetView(&pRT->lightClusters, pRT->projection, pRT->sizeX, pRT->sizeY);
+    if (ocLightClusterGridBuild(&pRT->lightClusters, pWorld->lightSpheres.pItems, clusteredLightCount) != OC_SUCCESS) {
+        return;
+    }
+
+    if (ocvkGraphicsRTReserveLightIndices(pWorld, pRT, ocLightClusterGridGetIndexCount(&pRT->lightClusters)) != OC_SUCCESS) {
+        return;
+    }
+
+    ocvkLightClusterHeader* pHeader = (ocvkLightClusterHeader*)pRT->pClusterBufferData;
+    ocLightClusterRange* pRanges = (ocLightClusterRange*)ocOffsetPtr(pHeader, sizeof(*pHeader));
+    uint32_t* pIndices = (uint32_t*)ocOffsetPtr(pRanges, sizeof(ocLightClusterRange)*OC_LIGHT_CLUSTER_COUNT);
+    ocLightClusterGridWrite(&pRT->lightClusters, pRanges, pIndices);
+
+    ocLightClusterParams params = ocLightClusterGridGetParams(&pRT->lightClusters);
+    pHeader->clusterScale      = glm::vec4(params.scaleX, params.scaleY, params.scaleZ, params.biasZ);
+    pHeader->globalLightOffset = clusteredLightCount;
+    pHeader->globalLightCount  = globalLightCount;
+    pHeader->lightCount        = lightCount;     // <-- Set last since this is what enables lighting.
+}
+
 void ocGraphicsWorldDrawRT(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT)
 {
     if (pWorld == NULL || pRT == NULL) return;
 
-    // Update the uniform buffers for the render target.
-    glm::mat4 projection = pRT->projection * ocMakeMat4_VulkanClipCorrection();
+    // Update the uniform buffers for the render target. The clip correction is applied after the projection so that lighting and light
+    // clustering can both work with the uncorrected projection.
+    glm::mat4 projection = ocMakeMat4_VulkanClipCorrection() * pRT->projection;
     glm::mat4 view       = pRT->view;
 
     memcpy(ocOffsetPtr(pRT->pUniformBufferData, 0),                 &projection, sizeof(pRT->projection));
     memcpy(ocOffsetPtr(pRT->pUniformBufferData, sizeof(glm::mat4)), &view,       sizeof(pRT->view));
 
-    // The descriptor set for the RTs uniforms need to be updated.
-    VkWriteDescriptorSet descriptorWrite;
-    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptorWrite.pNext = NULL;
-    descriptorWrite.dstSet = pWorld->pGraphics->mainPipeline_DescriptorSets[0];
-    descriptorWrite.dstBinding = 0;
-    descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptorWrite.pImageInfo = NULL;
-    descriptorWrite.pBufferInfo = &pRT->uniformBufferDescriptor;
-    descriptorWrite.pTexelBufferView = NULL;
-    vkUpdateDescriptorSets(pWorld->pGraphics->device, 1, &descriptorWrite, 0, NULL);
+    ocvkGraphicsRTUpdateLights(pWorld, pRT);
 
-    descriptorWrite.dstSet = pWorld->pGraphics->mainPipeline_DescriptorSets[0];
-    descriptorWrite.dstBinding = 1;
-    descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptorWrite.pImageInfo = NULL;
-    descriptorWrite.pBufferInfo = &pWorld->pObjects->at(0)->uniformBufferDescriptor;
-    descriptorWrite.pTexelBufferView = NULL;
-    vkUpdateDescriptorSets(pWorld->pGraphics->device, 1, &descriptorWrite, 0, NULL);
+    // The frame descriptor set. The pool it comes from can be reset here because the previous draw waited for the queue to become idle.
+    VkDescriptorSet frameDescriptorSet;
+    vkResetDescriptorPool(pWorld->pGraphics->device, pWorld->pGraphics->frameDescriptorPool, 0);
 
-    descriptorWrite.dstSet = pWorld->pGraphics->mainPipeline_DescriptorSets[0];
-    descriptorWrite.dstBinding = 2;
-    descriptorWrite.dstArrayElement = 0;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrite.pImageInfo = &pWorld->pCurrentImage->descriptor;
-    descriptorWrite.pBufferInfo = NULL;
-    descriptorWrite.pTexelBufferView = NULL;
-    vkUpdateDescriptorSets(pWorld->pGraphics->device, 1, &descriptorWrite, 0, NULL);
+    VkDescriptorSetAllocateInfo descriptorSetAllocInfo;
+    descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descriptorSetAllocInfo.pNext = NULL;
+    descriptorSetAllocInfo.descriptorPool = pWorld->pGraphics->frameDescriptorPool;
+    descriptorSetAllocInfo.descriptorSetCount = 1;
+    descriptorSetAllocInfo.pSetLayouts = &pWorld->pGraphics->mainPipeline_DescriptorSetLayouts[OC_VK_DESCRIPTOR_SET_FRAME];
+    if (vkAllocateDescriptorSets(pWorld->pGraphics->device, &descriptorSetAllocInfo, &frameDescriptorSet) != VK_SUCCESS) {
+        return;
+    }
 
+    VkDescriptorBufferInfo objectBufferDescriptor;
+    objectBufferDescriptor.buffer = pWorld->objectBuffer;
+    objectBufferDescriptor.offset = 0;
+    objectBufferDescriptor.range  = VK_WHOLE_SIZE;
+
+    VkDescriptorBufferInfo boneBufferDescriptor;
+    boneBufferDescriptor.buffer = pWorld->boneBuffer;
+    boneBufferDescriptor.offset = 0;
+    boneBufferDescriptor.range  = VK_WHOLE_SIZE;
+
+    VkDescriptorBufferInfo lightBufferDescriptor;
+    lightBufferDescriptor.buffer = pRT->lightBuffer;
+    lightBufferDescriptor.offset = 0;
+    lightBufferDescriptor.range  = VK_WHOLE_SIZE;
+
+    VkDescriptorBufferInfo clusterBufferDescriptor;
+    clusterBufferDescriptor.buffer = pRT->clusterBuffer;
+    clusterBufferDescriptor.offset = 0;
+    clusterBufferDescriptor.range  = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet pDescriptorWrites[5];
+    pDescriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    pDescriptorWrites[0].pNext = NULL;
+    pDescriptorWrites[0].dstSet = frameDescriptorSet;
+    pDescriptorWrites[0].dstBinding = 0;
+    pDescriptorWrites[0].dstArrayElement = 0;
+    pDescriptorWrites[0].descriptorCount = 1;
+    pDescriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    pDescriptorWrites[0].pImageInfo = NULL;
+    pDescriptorWrites[0].pBufferInfo = &pRT->uniformBufferDescriptor;
+    pDescriptorWrites[0].pTexelBufferView = NULL;
+    pDescriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    pDescriptorWrites[1].pNext = NULL;
+    pDescriptorWrites[1].dstSet = frameDescriptorSet;
+    pDescriptorWrites[1].dstBinding = 1;
+    pDescriptorWrites[1].dstArrayElement = 0;
+    pDescriptorWrites[1].descriptorCount = 1;
+    pDescriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pDescriptorWrites[1].pImageInfo = NULL;
+    pDescriptorWrites[1].pBufferInfo = &objectBufferDescriptor;
+    pDescriptorWrites[1].pTexelBufferView = NULL;
+    pDescriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    pDescriptorWrites[2].pNext = NULL;
+    pDescriptorWrites[2].dstSet = frameDescriptorSet;
+    pDescriptorWrites[2].dstBinding = 2;
+    pDescriptorWrites[2].dstArrayElement = 0;
+    pDescriptorWrites[2].descriptorCount = 1;
+    pDescriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pDescriptorWrites[2].pImageInfo = NULL;
+    pDescriptorWrites[2].pBufferInfo = &boneBufferDescriptor;
+    pDescriptorWrites[2].pTexelBufferView = NULL;
+    pDescriptorWrites[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    pDescriptorWrites[3].pNext = NULL;
+    pDescriptorWrites[3].dstSet = frameDescriptorSet;
+    pDescriptorWrites[3].dstBinding = 3;
+    pDescriptorWrites[3].dstArrayElement = 0;
+    pDescriptorWrites[3].descriptorCount = 1;
+    pDescriptorWrites[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pDescriptorWrites[3].pImageInfo = NULL;
+    pDescriptorWrites[3].pBufferInfo = &lightBufferDescriptor;
+    pDescriptorWrites[3].pTexelBufferView = NULL;
+    pDescriptorWrites[4].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    pDescriptorWrites[4].pNext = NULL;
+    pDescriptorWrites[4].dstSet = frameDescriptorSet;
+    pDescriptorWrites[4].dstBinding = 4;
+    pDescriptorWrites[4].dstArrayElement = 0;
+    pDescriptorWrites[4].descriptorCount = 1;
+    pDescriptorWrites[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pDescriptorWrites[4].pImageInfo = NULL;
+    pDescriptorWrites[4].pBufferInfo = &clusterBufferDescriptor;
+    pDescriptorWrites[4].pTexelBufferView = NULL;
+    vkUpdateDescriptorSets(pWorld->pGraphics->device, ocCountOf(pDescriptorWrites), pDescriptorWrites, 0, NULL);
+
+    VkDescriptorSet pDescriptorSets[OC_VK_DESCRIPTOR_SET_COUNT];
+    pDescriptorSets[OC_VK_DESCRIPTOR_SET_FRAME]  = frameDescriptorSet;
+    pDescriptorSets[OC_VK_DESCRIPTOR_SET_IMAGES] = pWorld->pGraphics->imageDescriptorSet;
 
 
 
@@ -2010,18 +3259,49 @@ void ocGraphicsWorldDrawRT(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT)
             VkRect2D scissor = ocvkRect2D(0, 0, pRT->sizeX, pRT->sizeY);
             vkCmdSetScissor(cmdbuf, 0, 1, &scissor);
 
-            // Draw some objects.
+            // Draw some objects. Each mesh uses the pipeline variant for it's vertex format and primitive type. Every variant uses the same
+            // layout so the descriptor sets only need to be bound once. The object's index is passed as the instance index which the
+            // shaders use to look up it's data in the object buffer.
+            VkPipeline currentPipeline = NULL;
+            vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pWorld->pGraphics->mainPipeline_Layout, 0, ocCountOf(pDescriptorSets), pDescriptorSets, 0, NULL);
+
             for (size_t iObject = 0; iObject < pWorld->pObjects->size(); ++iObject) {
                 ocGraphicsObject* pObject = pWorld->pObjects->at(iObject);
                 if (pObject->type == ocGraphicsObjectType_Mesh) {
                     ocGraphicsMesh* pMesh = pObject->data.mesh.pResource;   // <-- For ease of use.
 
-                    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pWorld->pGraphics->mainPipeline);
-                    vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pWorld->pGraphics->mainPipeline_Layout, 0, 1, &pWorld->pGraphics->mainPipeline_DescriptorSets[0], 0, NULL);
+                    VkPipeline pipeline = ocvkGetMainPipeline(pWorld->pGraphics, pMesh->vertexFormat, pMesh->primitiveType);
+                    if (pipeline == NULL) {
+                        continue;   // <-- The pipeline does not support this combination of vertex format and primitive type, or it failed to be created.
+                    }
+
+                    if (pipeline != currentPipeline) {
+                        vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                        currentPipeline = pipeline;
+                    }
 
                     vkCmdBindVertexBuffers(cmdbuf, 0, 1, &pMesh->vertexBufferVK, &pMesh->vertexBufferOffset);
                     vkCmdBindIndexBuffer(cmdbuf, pMesh->indexBufferVK, pMesh->indexBufferOffset, ocToVulkanIndexFormat(pMesh->indexFormat));
-                    vkCmdDrawIndexed(cmdbuf, pMesh->indexCount, 1, 0, 0, 0);
+                    vkCmdDrawIndexed(cmdbuf, pMesh->indexCount, 1, 0, 0, pObject->objectIndex);
+                }
+            }
+
+            // Particles are drawn after the meshes since they're blended. Every particle system shares the particle buffer, so each one is a
+            // single instanced draw of it's live particles starting at it's offset in the buffer.
+            VkPipeline particlePipeline = pWorld->pGraphics->particlePipeline;
+            if (particlePipeline != NULL && pWorld->particleBuffer != NULL) {
+                VkDeviceSize particleBufferOffset = 0;
+                vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, particlePipeline);
+                vkCmdBindVertexBuffers(cmdbuf, 0, 1, &pWorld->particleBuffer, &particleBufferOffset);
+
+                for (size_t iObject = 0; iObject < pWorld->pObjects->size(); ++iObject) {
+                    ocGraphicsObject* pObject = pWorld->pObjects->at(iObject);
+                    if (pObject->type == ocGraphicsObjectType_ParticleSystem) {
+                        ocParticleEmitter* pEmitter = pObject->data.particleSystem.pEmitter;
+                        if (pEmitter->particleCount > 0) {
+                            vkCmdDraw(cmdbuf, 6, pEmitter->particleCount, 0, pEmitter->instanceOffset);
+                        }
+                    }
                 }
             }
         }
@@ -2070,8 +3350,14 @@ void ocGraphicsWorldDrawRT(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT)
 void ocGraphicsWorldStep(ocGraphicsWorld* pWorld, double dt)
 {
     if (pWorld == NULL || dt == 0) return;
-    
-    // TODO: Step animations and particle effects.
+
+    // The bone buffer is always big enough for every palette because it's grown when skinned objects are created.
+    ocAssert(ocAnimationWorldGetPaletteSize(&pWorld->animation) <= pWorld->boneBufferCapacity);
+    ocAnimationWorldStep(&pWorld->animation, (float)dt, pWorld->pBoneBufferData);
+
+    // Likewise for the particle buffer, which is grown when particle systems are created.
+    ocAssert(ocParticleWorldGetInstanceCount(&pWorld->particles) <= pWorld->particleBufferCapacity);
+    ocParticleWorldStep(&pWorld->particles, (float)dt, pWorld->pParticleBufferData);
 }
 
 
@@ -2412,6 +3698,25 @@ OC_PRIVATE ocResult ocGraphicsWorldAllocAndInitRT(ocGraphicsWorld* pWorld, ocGra
     pRT->uniformBufferDescriptor.offset = 0;
     pRT->uniformBufferDescriptor.range  = sizeof(glm::mat4)*2;
 
+
+    // Lighting. The buffers are created up front so the frame descriptor set always has something to point to.
+    result = ocvkGraphicsRTReserveLights(pWorld, pRT, OC_VK_INITIAL_LIGHT_CAPACITY);
+    if (result == OC_SUCCESS) {
+        result = ocvkGraphicsRTReserveLightIndices(pWorld, pRT, OC_VK_INITIAL_LIGHT_INDEX_CAPACITY);
+    }
+    if (result == OC_SUCCESS) {
+        result = ocLightClusterGridInit(&pWorld->pGraphics->pEngine->jobQueue, &pRT->lightClusters);
+    }
+    if (result != OC_SUCCESS) {
+        ocvkDeleteMappedBuffer(pWorld->pGraphics, pRT->clusterBuffer, pRT->clusterBufferMemory);
+        ocvkDeleteMappedBuffer(pWorld->pGraphics, pRT->lightBuffer, pRT->lightBufferMemory);
+        ocvkDeleteMappedBuffer(pWorld->pGraphics, pRT->uniformBuffer, pRT->uniformBufferMemory);
+        ocGraphicsWorldUninitRT_OutputFramebuffers(pWorld, pRT);
+        ocGraphicsWorldUninitRT_MainFramebuffer(pWorld, pRT);
+        ocFree(pRT);
+        return result;
+    }
+
     *ppRT = pRT;
     return OC_SUCCESS;
 }
@@ -2467,6 +3772,10 @@ void ocGraphicsWorldDeleteRT(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT)
     // TODO: Destroy the uniform buffer.
     vkUnmapMemory(pWorld->pGraphics->device, pRT->uniformBufferMemory);
 
+    ocLightClusterGridUninit(&pRT->lightClusters);
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pRT->clusterBuffer, pRT->clusterBufferMemory);
+    ocvkDeleteMappedBuffer(pWorld->pGraphics, pRT->lightBuffer, pRT->lightBufferMemory);
+
     ocGraphicsWorldUninitRT_OutputFramebuffers(pWorld, pRT);
     ocGraphicsWorldUninitRT_MainFramebuffer(pWorld, pRT);
 
@@ -2488,35 +3797,23 @@ OC_PRIVATE ocResult ocGraphicsObjectInit(ocGraphicsObject* pObject, ocGraphicsWo
     pObject->_scale     = glm::vec4(1, 1, 1, 1);
     pObject->_transform = glm::mat4();
 
-    // Uniform buffer.
-    VkBufferCreateInfo uboInfo; // TODO: ocvkBufferCreateInfo() / ocvkDefaultBufferCreateInfo() / ocvkSimpleBufferCreateInfo()
-    uboInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    uboInfo.pNext = NULL;
-    uboInfo.flags = 0;
-    uboInfo.size = sizeof(glm::mat4)*2;
-    uboInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    uboInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    uboInfo.queueFamilyIndexCount = 0;
-    uboInfo.pQueueFamilyIndices = NULL;
-    VkResult vkresult = vkCreateBuffer(pWorld->pGraphics->device, &uboInfo, NULL, &pObject->uniformBuffer);
-    if (vkresult != VK_SUCCESS) {
-        return result;
-    }
+    // The object's slot in the object buffer. Slots released by deleted objects are reused first.
+    if (ocStackTop(&pWorld->freeObjectIndices, &pObject->objectIndex) == OC_SUCCESS) {
+        ocStackPop(&pWorld->freeObjectIndices);
+    } else {
+        result = ocvkGraphicsWorldReserveObjects(pWorld, pWorld->nextObjectIndex + 1);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
 
-    vkresult = ocvkAllocateAndBindBufferMemory(pWorld->pGraphics->physicalDevice, pWorld->pGraphics->device, pObject->uniformBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, NULL, &pObject->uniformBufferMemory);
-    if (vkresult != VK_SUCCESS) {
-        vkDestroyBuffer(pWorld->pGraphics->device, pObject->uniformBuffer, NULL);
-        return result;
+        pObject->objectIndex = pWorld->nextObjectIndex;
+        pWorld->nextObjectIndex += 1;
     }
 
-    // Permanently map the uniform buffer data.
-    vkMapMemory(pWorld->pGraphics->device, pObject->uniformBufferMemory, 0, sizeof(glm::mat4)*2, 0, &pObject->_pUniformBufferData);
-    memcpy(ocOffsetPtr(pObject->_pUniformBufferData, 0), glm::value_ptr(pObject->_transform), sizeof(glm::mat4));
-
-
-    pObject->uniformBufferDescriptor.buffer = pObject->uniformBuffer;
-    pObject->uniformBufferDescriptor.offset = 0;
-    pObject->uniformBufferDescriptor.range  = sizeof(glm::mat4);
+    ocvkObjectData* pObjectData = &pWorld->pObjectBufferData[pObject->objectIndex];
+    ocZeroObject(pObjectData);
+    pObjectData->model = pObject->_transform;
+    pObjectData->imageIndex = 0;    // <-- The default image.
 
     return OC_SUCCESS;
 }
@@ -2537,6 +3834,7 @@ ocResult ocGraphicsWorldCreateMeshObject(ocGraphicsWorld* pWorld, ocGraphicsMesh
     }
 
     pObject->data.mesh.pResource = pMesh;
+    pObject->data.mesh.pCharacter = NULL;
 
     // Add the object to the world. Should this be done explicitly at a higher level for consistency with ocWorld?
     pWorld->pObjects->push_back(pObject);
@@ -2545,14 +3843,183 @@ ocResult ocGraphicsWorldCreateMeshObject(ocGraphicsWorld* pWorld, ocGraphicsMesh
     return OC_SUCCESS;
 }
 
+ocResult ocGraphicsWorldCreateSkinnedMeshObject(ocGraphicsWorld* pWorld, ocGraphicsMesh* pMesh, const ocSkeleton* pSkeleton, ocGraphicsObject** ppObjectOut)
+{
+    if (pWorld == NULL || pMesh == NULL || pSkeleton == NULL || ppObjectOut == NULL) return OC_INVALID_ARGS;
+    if (pMesh->vertexFormat != ocGraphicsVertexFormat_P3T2N3J4W4) return OC_INVALID_ARGS;
+
+    ocAnimationCharacter* pCharacter;
+    ocResult result = ocAnimationWorldCreateCharacter(&pWorld->animation, pSkeleton, &pCharacter);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocvkGraphicsWorldReserveBones(pWorld, ocAnimationWorldGetPaletteSize(&pWorld->animation));
+    if (result != OC_SUCCESS) {
+        ocAnimationWorldDeleteCharacter(&pWorld->animation, pCharacter);
+        return result;
+    }
+
+    ocGraphicsObject* pObject;
+    result = ocGraphicsWorldCreateMeshObject(pWorld, pMesh, &pObject);
+    if (result != OC_SUCCESS) {
+        ocAnimationWorldDeleteCharacter(&pWorld->animation, pCharacter);
+        return result;
+    }
+
+    pObject->data.mesh.pCharacter = pCharacter;
+    pCharacter->pUserData = pObject;
+
+    // The palette of the bind pose is all identity matrices. It's written here so the object is drawn correctly before it's first step.
+    for (ocUInt32 iBone = 0; iBone < pSkeleton->boneCount; ++iBone) {
+        pWorld->pBoneBufferData[pCharacter->paletteOffset + iBone] = glm::mat4();
+    }
+
+    pWorld->pObjectBufferData[pObject->objectIndex].boneOffset = pCharacter->paletteOffset;
+
+    *ppObjectOut = pObject;
+    return OC_SUCCESS;
+}
+
+ocAnimationCharacter* ocGraphicsWorldGetObjectAnimationCharacter(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject)
+{
+    if (pWorld == NULL || pObject == NULL || pObject->type != ocGraphicsObjectType_Mesh) return NULL;
+    return pObject->data.mesh.pCharacter;
+}
+
+ocResult ocGraphicsWorldCreateParticleSystemObject(ocGraphicsWorld* pWorld, const ocParticleEmitterDesc* pDesc, ocGraphicsObject** ppObjectOut)
+{
+    if (pWorld == NULL || pDesc == NULL || ppObjectOut == NULL) return OC_INVALID_ARGS;
+
+    ocParticleEmitter* pEmitter;
+    ocResult result = ocParticleWorldCreateEmitter(&pWorld->particles, pDesc, glm::vec3(0, 0, 0), glm::quat(1, 0, 0, 0), &pEmitter);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocvkGraphicsWorldReserveParticles(pWorld, ocParticleWorldGetInstanceCount(&pWorld->particles));
+    if (result != OC_SUCCESS) {
+        ocParticleWorldDeleteEmitter(&pWorld->particles, pEmitter);
+        return result;
+    }
+
+    ocGraphicsObject* pObject = ocMallocObject(ocGraphicsObject);
+    if (pObject == NULL) {
+        ocParticleWorldDeleteEmitter(&pWorld->particles, pEmitter);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    result = ocGraphicsObjectInit(pObject, pWorld, ocGraphicsObjectType_ParticleSystem);
+    if (result != OC_SUCCESS) {
+        ocParticleWorldDeleteEmitter(&pWorld->particles, pEmitter);
+        ocFree(pObject);
+        return result;
+    }
+
+    pObject->data.particleSystem.pEmitter = pEmitter;
+    pEmitter->pUserData = pObject;
+
+    pWorld->pObjects->push_back(pObject);
+
+    *ppObjectOut = pObject;
+    return OC_SUCCESS;
+}
+
+ocParticleEmitter* ocGraphicsWorldGetObjectParticleEmitter(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject)
+{
+    if (pWorld == NULL || pObject == NULL || pObject->type != ocGraphicsObjectType_ParticleSystem) return NULL;
+    return pObject->data.particleSystem.pEmitter;
+}
+
+ocResult ocGraphicsWorldCreateLightObject(ocGraphicsWorld* pWorld, const ocGraphicsLightDesc* pDesc, ocGraphicsObject** ppObjectOut)
+{
+    if (pWorld == NULL || pDesc == NULL || ppObjectOut == NULL) return OC_INVALID_ARGS;
+
+    switch (pDesc->type)
+    {
+        case ocGraphicsObjectType_AmbientLight:
+        case ocGraphicsObjectType_DirectionalLight:
+        case ocGraphicsObjectType_PointLight:
+        case ocGraphicsObjectType_SpotLight: break;
+        default: return OC_INVALID_ARGS;
+    }
+
+    ocGraphicsObject* pObject = ocMallocObject(ocGraphicsObject);
+    if (pObject == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocResult result = ocGraphicsObjectInit(pObject, pWorld, pDesc->type);
+    if (result != OC_SUCCESS) {
+        ocFree(pObject);
+        return result;
+    }
+
+    switch (pDesc->type)
+    {
+        case ocGraphicsObjectType_AmbientLight:
+        {
+            pObject->data.ambientLight.color = pDesc->color;
+        } break;
+
+        case ocGraphicsObjectType_DirectionalLight:
+        {
+            pObject->data.directionalLight.color     = pDesc->color;
+            pObject->data.directionalLight.direction = glm::vec3(0, 0, -1);
+        } break;
+
+        case ocGraphicsObjectType_PointLight:
+        {
+            pObject->data.pointLight.color       = pDesc->color;
+            pObject->data.pointLight.radius      = pDesc->radius;
+            pObject->data.pointLight.attenuation = pDesc->attenuation;
+        } break;
+
+        case ocGraphicsObjectType_SpotLight:
+        {
+            pObject->data.spotLight.color       = pDesc->color;
+            pObject->data.spotLight.radius      = pDesc->radius;
+            pObject->data.spotLight.attenuation = pDesc->attenuation;
+            pObject->data.spotLight.angleOuter  = pDesc->angleOuter;
+            pObject->data.spotLight.angleInner  = ocMin(pDesc->angleInner, pDesc->angleOuter);
+        } break;
+
+        default: break;
+    }
+
+    result = ocStackPush(&pWorld->lights, pObject);
+    if (result != OC_SUCCESS) {
+        ocStackPush(&pWorld->freeObjectIndices, pObject->objectIndex);
+        ocFree(pObject);
+        return result;
+    }
+
+    *ppObjectOut = pObject;
+    return OC_SUCCESS;
+}
+
 void ocGraphicsWorldDeleteObject(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject)
 {
     if (pWorld == NULL || pObject == NULL) return;
 
     pWorld->pObjects->erase(std::remove(pWorld->pObjects->begin(), pWorld->pObjects->end(), pObject), pWorld->pObjects->end());
 
-    // TODO: Destroy the uniform buffer.
-    vkUnmapMemory(pWorld->pGraphics->device, pObject->uniformBufferMemory);
+    for (size_t iLight = 0; iLight < pWorld->lights.count; ++iLight) {
+        if (pWorld->lights.pItems[iLight] == pObject) {
+            pWorld->lights.pItems[iLight] = pWorld->lights.pItems[pWorld->lights.count-1];
+            ocStackPop(&pWorld->lights);
+            break;
+        }
+    }
+
+    if (pObject->type == ocGraphicsObjectType_Mesh && pObject->data.mesh.pCharacter != NULL) {
+        ocAnimationWorldDeleteCharacter(&pWorld->animation, pObject->data.mesh.pCharacter);
+    }
+    if (pObject->type == ocGraphicsObjectType_ParticleSystem) {
+        ocParticleWorldDeleteEmitter(&pWorld->particles, pObject->data.particleSystem.pEmitter);
+    }
+
+    ocStackPush(&pWorld->freeObjectIndices, pObject->objectIndex);
     ocFree(pObject);
 }
 
@@ -2580,7 +4047,30 @@ void ocGraphicsWorldSetObjectTransform(ocGraphicsWorld* pWorld, ocGraphicsObject
     pObject->_scale     = glm::vec4(scale, 1);
     pObject->_transform = ocMakeMat4(pObject->_position, pObject->_rotation, pObject->_scale);
 
-    // Update uniform buffer.
-    memcpy(ocOffsetPtr(pObject->_pUniformBufferData, 0), glm::value_ptr(pObject->_transform), sizeof(glm::mat4));
+    // Update the object buffer.
+    pWorld->pObjectBufferData[pObject->objectIndex].model = pObject->_transform;
+
+    // Particles are simulated in world space so the emitter needs to know where it is. Scale does not affect particles.
+    if (pObject->type == ocGraphicsObjectType_ParticleSystem) {
+        ocParticleEmitterSetTransform(pObject->data.particleSystem.pEmitter, position, rotation);
+    }
+
+    // Directional lights shine down their forward axis. Spot lights work this out from the rotation when they're drawn.
+    if (pObject->type == ocGraphicsObjectType_DirectionalLight) {
+        pObject->data.directionalLight.direction = rotation * glm::vec3(0, 0, -1);
+    }
+}
+
+void ocGraphicsWorldSetObjectImage(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject, ocGraphicsImage* pImage)
+{
+    if (pWorld == NULL || pObject == NULL) return;
+
+    uint32_t imageIndex = 0;    // <-- The default image.
+    if (pImage != NULL) {
+        ocAssert((pImage->usage & VK_IMAGE_USAGE_SAMPLED_BIT) != 0);   // <-- The image was not created with OC_GRAPHICS_IMAGE_USAGE_SHADER_INPUT.
+        imageIndex = pImage->imageIndex;
+    }
+
+    pWorld->pObjectBufferData[pObject->objectIndex].imageIndex = imageIndex;
 }
 
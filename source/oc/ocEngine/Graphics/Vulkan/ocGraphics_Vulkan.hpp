@@ -6,6 +6,82 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+// The IDs of the specialization constants that are set when a pipeline is created. These must match the IDs used in the shaders.
+#define OC_VK_SPEC_CONSTANT_PRIMITIVE_TYPE  0   // <-- int. The ocGraphicsPrimitiveType the pipeline draws.
+#define OC_VK_SPEC_CONSTANT_MAX_IMAGES      1   // <-- int. The size of the image array. See ocGraphicsContext::maxImages.
+
+// The descriptor sets used by the main pipelines. These must match the sets used in the shaders.
+//
+// The frame set is allocated from a pool that's reset each time a render target is drawn. It contains the camera's uniform buffer, the
+// world's object and bone buffers, and the render target's light and light cluster buffers. The image set is allocated once and
+// contains an array with every image that can be used as shader input. Images write their own descriptor when they're created so
+// nothing needs to be updated while drawing. Objects refer to an image by it's index in the array, which is stored in their entry in
+// the object buffer.
+#define OC_VK_DESCRIPTOR_SET_FRAME          0
+#define OC_VK_DESCRIPTOR_SET_IMAGES         1
+#define OC_VK_DESCRIPTOR_SET_COUNT          2
+
+// The maximum number of images that can be used as shader input at the same time. This is clamped to the device's limits.
+#define OC_VK_MAX_IMAGES                    4096
+
+// The maximum number of times the frame descriptor pool can be allocated from before it's reset.
+#define OC_VK_MAX_FRAME_DESCRIPTOR_SETS     16
+
+// The per-object data in the world's object buffer. The layout must match ObjectData in stdio.glsl (std430).
+struct ocvkObjectData
+{
+    glm::mat4 model;
+    uint32_t imageIndex;
+    uint32_t boneOffset;                    // <-- The index of the object's first bone in the bone buffer. Only used by skinned meshes.
+    uint32_t padding[2];
+};
+
+// The types of light in the light buffer. These must match the LIGHT_TYPE_* defines in stdio.glsl.
+#define OC_VK_LIGHT_TYPE_POINT              0
+#define OC_VK_LIGHT_TYPE_SPOT               1
+#define OC_VK_LIGHT_TYPE_DIRECTIONAL        2
+#define OC_VK_LIGHT_TYPE_AMBIENT            3
+
+// A light in a render target's light buffer, in the view space of the render target. The layout must match LightData in stdio.glsl (std430).
+struct ocvkLightData
+{
+    glm::vec4 positionRadius;               // <-- XYZ = position, W = radius.
+    glm::vec4 color;
+    glm::vec4 directionCosOuter;            // <-- XYZ = direction, W = cosine of the outer angle. Only used by spot and directional lights.
+    float cosInner;
+    float attenuation;
+    uint32_t type;                          // <-- One of OC_VK_LIGHT_TYPE_*.
+    uint32_t padding;
+};
+
+// The start of a render target's light cluster buffer. This is followed by an ocLightClusterRange for every cluster, and then the packed
+// light indices they refer to. The layout must match the LightClusters buffer in stdio.glsl (std430).
+//
+// The clustered lights come first in the light buffer, and are followed by the lights that affect everything, which are not binned.
+struct ocvkLightClusterHeader
+{
+    glm::vec4 clusterScale;                 // <-- See ocLightClusterParams.
+    uint32_t lightCount;                    // <-- The total number of lights. When this is 0, lighting is disabled and everything is drawn unlit.
+    uint32_t globalLightOffset;
+    uint32_t globalLightCount;
+    uint32_t padding;
+};
+
+// A variant of a pipeline. A table of these, g_ocPipelineVariants, is generated by oc_build from the pipeline definitions. There is one
+// for each vertex format and combination of keywords a pipeline supports. Variants with identical shader code point to the same array.
+struct ocvkPipelineVariant
+{
+    const char* pipelineName;
+    const char* keywords;                   // <-- Space separated. Empty for the base variant.
+    ocGraphicsVertexFormat vertexFormat;
+    uint32_t primitiveTypes;                // <-- A bit for each supported ocGraphicsPrimitiveType.
+    uint32_t warmUpPrimitiveTypes;          // <-- A bit for each ocGraphicsPrimitiveType whose pipeline is created at startup rather than on first use.
+    const unsigned char* pVertexShaderCode;
+    size_t vertexShaderCodeSize;
+    const unsigned char* pFragmentShaderCode;
+    size_t fragmentShaderCodeSize;
+};
+
 struct ocGraphicsContext : public ocGraphicsContextBase
 {
     VkbAPI vk;  /* The Vulkan API. This is also bound globally. */
@@ -17,16 +93,27 @@ struct ocGraphicsContext : public ocGraphicsContextBase
     uint32_t queueLocalIndex;
     VkCommandPool commandPool;
     VkQueue queue;
-    VkDescriptorPool descriptorPool;
+    VkDescriptorPool descriptorPool;            // <-- For persistent descriptor sets.
+    VkDescriptorPool frameDescriptorPool;       // <-- For descriptor sets that only live for the duration of a draw. Reset at the start of each draw.
     VkRenderPass renderPass0;
     VkRenderPass renderPass_FinalComposite_Image;
     VkRenderPass renderPass_FinalComposite_Window;
-    VkShaderModule mainPipeline_VS;
-    VkShaderModule mainPipeline_FS;
-    VkDescriptorSetLayout mainPipeline_DescriptorSetLayouts[1];
-    VkDescriptorSet mainPipeline_DescriptorSets[1];
+    VkShaderModule mainPipeline_VS[ocGraphicsVertexFormat_Count];   // <-- Can be shared between vertex formats when the code is identical.
+    VkShaderModule mainPipeline_FS[ocGraphicsVertexFormat_Count];
+    VkDescriptorSetLayout mainPipeline_DescriptorSetLayouts[OC_VK_DESCRIPTOR_SET_COUNT];
+    VkDescriptorSet imageDescriptorSet;
+    uint32_t maxImages;                     // <-- The size of the image array. OC_VK_MAX_IMAGES clamped to the device's limits.
+    uint32_t nextImageIndex;                // <-- The next index in the image array that has never been used.
+    ocStack<uint32_t> freeImageIndices;     // <-- Indices in the image array that have been released by deleted images.
+    ocGraphicsImage* pDefaultImage;         // <-- A 1x1 white image. Always index 0 in the image array, and used to fill unused indices.
     VkPipelineLayout mainPipeline_Layout;
-    VkPipeline mainPipeline;
+    VkPipeline mainPipelines[ocGraphicsVertexFormat_Count][ocGraphicsPrimitiveType_Count];  // <-- NULL until created. Only warm-up pipelines are created at startup.
+    uint32_t mainPipelinesSupported[ocGraphicsVertexFormat_Count];  // <-- A bit for each ocGraphicsPrimitiveType supported by each vertex format.
+    uint32_t mainPipelinesFailed[ocGraphicsVertexFormat_Count];     // <-- A bit for each pipeline that failed to be created so it's not retried every frame.
+    VkShaderModule particlePipeline_VS;
+    VkShaderModule particlePipeline_FS;
+    VkPipeline particlePipeline;            // <-- NULL if the Particle pipeline is not in the pipeline table, in which case particles are not drawn.
+    VkPipelineCache pipelineCache;          // <-- Loaded from and saved to the cache folder. Can be NULL.
     VkSampleCountFlagBits msaaSamples;
     VkSampler sampler_Linear;
     VkSampler sampler_Nearest;
@@ -44,6 +131,7 @@ struct ocGraphicsImage
     uint32_t sizeY;
     uint32_t mipLevels;
     VkDescriptorImageInfo descriptor;
+    uint32_t imageIndex;        // <-- The index in the image array. Only valid for images created with OC_GRAPHICS_IMAGE_USAGE_SHADER_INPUT.
 };
 
 struct ocGraphicsMesh
@@ -96,23 +184,19 @@ struct ocGraphicsObject : public ocGraphicsObjectBase
     glm::vec4 _scale;
     glm::mat4 _transform;   // <-- The transformation matrix made up of _position, _rotation and _scale
 
-    // TODO: Optimize uniform data. Maybe use object pools as a way to group allocations?
-    VkBuffer uniformBuffer;
-    VkDeviceMemory uniformBufferMemory;
-    VkDescriptorBufferInfo uniformBufferDescriptor;
-    void* _pUniformBufferData;    // A pointer to a permanently mapped uniform buffer containing the uniform data of the object. The first bit of data is always the transform.
+    uint32_t objectIndex;       // <-- The index of the object's data in the world's object buffer. Passed to the shaders as the instance index.
 
     union
     {
         struct
         {
             ocGraphicsMesh* pResource;
+            ocAnimationCharacter* pCharacter;   // <-- NULL if the mesh is not skinned.
         } mesh;
 
         struct
         {
-            //ocGraphicsResource_ParticleSystem* pResource;
-            int unused;
+            ocParticleEmitter* pEmitter;
         } particleSystem;
 
         struct
@@ -153,9 +237,36 @@ struct ocGraphicsWorld : public ocGraphicsWorldBase
     // because we initialize to 0.
     std::vector<ocGraphicsObject*>* pObjects;
 
-
-    // TEMP.
-    ocGraphicsImage* pCurrentImage;
+    // The data of every object, indexed by ocGraphicsObject::objectIndex. This is a single storage buffer that's permanently mapped so
+    // that any number of objects can be drawn without updating descriptors. It grows as objects are added.
+    VkBuffer objectBuffer;
+    VkDeviceMemory objectBufferMemory;
+    ocvkObjectData* pObjectBufferData;
+    uint32_t objectBufferCapacity;          // <-- In objects.
+    uint32_t nextObjectIndex;               // <-- The next index in the object buffer that has never been used.
+    ocStack<uint32_t> freeObjectIndices;    // <-- Indices in the object buffer that have been released by deleted objects.
+
+    // The bone palettes of every skinned mesh, indexed by ocvkObjectData::boneOffset. This works the same way as the object buffer, and
+    // is written to directly by the animation world when it's stepped.
+    VkBuffer boneBuffer;
+    VkDeviceMemory boneBufferMemory;
+    glm::mat4* pBoneBufferData;
+    uint32_t boneBufferCapacity;            // <-- In matrices.
+
+    // The particle instances of every particle system, at ocParticleEmitter::instanceOffset. This is bound as an instance rate vertex
+    // buffer and is written to directly by the particle world when it's stepped.
+    VkBuffer particleBuffer;
+    VkDeviceMemory particleBufferMemory;
+    ocParticleInstance* pParticleBufferData;
+    uint32_t particleBufferCapacity;        // <-- In instances.
+
+    // Light objects are kept separately from the other objects since they're never drawn. Instead, they're gathered into the light
+    // buffer of each render target when it's drawn.
+    ocStack<ocGraphicsObject*> lights;
+    ocStack<glm::vec4> lightSpheres;        // <-- Scratch space for the view space bounding spheres of lights that are being clustered.
+
+    ocAnimationWorld animation;
+    ocParticleWorld particles;
 };
 
 
@@ -209,6 +320,22 @@ struct ocGraphicsRT : public ocGraphicsRTBase
     void* pUniformBufferData;
 
 
+    //// Lighting ////
+
+    // The lights are binned into the clusters of the render target's view frustum each time it's drawn. The light buffer holds the
+    // world's lights in the render target's view space, and the cluster buffer holds the list of lights affecting each cluster. Both
+    // are permanently mapped and grow when they run out of room.
+    ocLightClusterGrid lightClusters;
+    VkBuffer lightBuffer;
+    VkDeviceMemory lightBufferMemory;
+    ocvkLightData* pLightBufferData;
+    uint32_t lightBufferCapacity;       // <-- In lights.
+    VkBuffer clusterBuffer;
+    VkDeviceMemory clusterBufferMemory;
+    void* pClusterBufferData;
+    uint32_t clusterBufferCapacity;     // <-- In light indices, not counting the header and ranges.
+
+
     //// Command Buffers ////
     VkCommandBuffer cbPreTransition;    // Transitions the images of the main framebuffers to their initial states for rendering.
     VkCommandBuffer cbPreTransition_Outputs[3];
@@ -1,8 +1,12 @@
+// Bindings that are Vulkan only share their numbers with the material bindings, which are not used by Vulkan.
 #ifndef OC_UBO_BINDING_CAMERA_VERT
 #define OC_UBO_BINDING_CAMERA_VERT      0
 #endif
 #ifndef OC_UBO_BINDING_OBJECT_VERT
-#define OC_UBO_BINDING_OBJECT_VERT      1
+#define OC_UBO_BINDING_OBJECT_VERT      1   // <-- A storage buffer when compiling for Vulkan.
+#endif
+#ifndef OC_UBO_BINDING_BONES_VERT
+#define OC_UBO_BINDING_BONES_VERT       2   // <-- Vulkan only.
 #endif
 #ifndef OC_UBO_BINDING_MATERIAL_VERT
 #define OC_UBO_BINDING_MATERIAL_VERT    2
@@ -10,49 +14,101 @@
 #ifndef OC_UBO_BINDING_MATERIAL_FRAG
 #define OC_UBO_BINDING_MATERIAL_FRAG    3
 #endif
+#ifndef OC_UBO_BINDING_LIGHTS_FRAG
+#define OC_UBO_BINDING_LIGHTS_FRAG      3   // <-- Vulkan only.
+#endif
+#ifndef OC_UBO_BINDING_LIGHT_CLUSTERS_FRAG
+#define OC_UBO_BINDING_LIGHT_CLUSTERS_FRAG  4   // <-- Vulkan only.
+#endif
+
+// The size of the light cluster grid. These must match OC_LIGHT_CLUSTER_COUNT_* in ocLightClusters.hpp.
+#define OC_LIGHT_CLUSTER_COUNT_X    16
+#define OC_LIGHT_CLUSTER_COUNT_Y    9
+#define OC_LIGHT_CLUSTER_COUNT_Z    24
+#define OC_LIGHT_CLUSTER_COUNT      (OC_LIGHT_CLUSTER_COUNT_X * OC_LIGHT_CLUSTER_COUNT_Y * OC_LIGHT_CLUSTER_COUNT_Z)
+
+// The types of light in the light buffer. These must match OC_VK_LIGHT_TYPE_*.
+#define LIGHT_TYPE_POINT            0
+#define LIGHT_TYPE_SPOT             1
+#define LIGHT_TYPE_DIRECTIONAL      2
+#define LIGHT_TYPE_AMBIENT          3
 
 //
 // Vertex
 //
 #if defined(SHADER_STAGE_VERTEX)
+    OC_SPECIALIZATION_CONSTANT(0, int, SPEC_PrimitiveType, OC_PRIMITIVE_TYPE_TRIANGLE);
+
     OC_UBO(0, OC_UBO_BINDING_CAMERA_VERT, UBO_Camera)
     {
         mat4 Projection;
         mat4 View;
     } Camera;
     
-    OC_UBO(0, OC_UBO_BINDING_OBJECT_VERT, UBO_Object)
-    {
-        mat4 Model;
-    } Object;
+    #ifdef VULKAN
+        // The data of every object in the world. The engine passes the index of the object being drawn as the instance index. Must match
+        // ocvkObjectData.
+        struct ObjectData
+        {
+            mat4 Model;
+            uint ImageIndex;
+            uint BoneOffset;
+        };
+
+        OC_SSBO(0, OC_UBO_BINDING_OBJECT_VERT, SSBO_Objects)
+        {
+            ObjectData Objects[];
+        };
+
+        #define Object Objects[gl_InstanceIndex]
+
+        // The bone palettes of every skinned mesh. The palette of the object being drawn starts at Object.BoneOffset.
+        #ifdef OC_VERTEX_FORMAT_P3T2N3J4W4
+            OC_SSBO(0, OC_UBO_BINDING_BONES_VERT, SSBO_Bones)
+            {
+                mat4 Bones[];
+            };
+        #endif
+    #else
+        OC_UBO(0, OC_UBO_BINDING_OBJECT_VERT, UBO_Object)
+        {
+            mat4 Model;
+        } Object;
+    #endif
 
     #ifdef VULKAN
         layout(location = 0) in vec3 VERT_Position;
         layout(location = 1) in vec2 VERT_TexCoord;
         layout(location = 2) in vec3 VERT_Normal;
-        #ifdef OC_VERTEX_FORMAT_V3T2N3T3B3
+        #ifdef OC_VERTEX_FORMAT_P3T2N3T3B3
             layout(location = 3) in vec3 VERT_Tangent;
             layout(location = 4) in vec3 VERT_Binormal;
         #endif
+        #ifdef OC_VERTEX_FORMAT_P3T2N3J4W4
+            layout(location = 3) in uvec4 VERT_BoneIndices;
+            layout(location = 4) in vec4 VERT_BoneWeights;
+        #endif
         
         layout(location = 0) out vec2 FRAG_TexCoord;
         layout(location = 1) out vec3 FRAG_Normal;
-        #ifdef OC_VERTEX_FORMAT_V3T2N3T3B3
+        #ifdef OC_VERTEX_FORMAT_P3T2N3T3B3
             layout(location = 2) out vec3 FRAG_Tangent;
             layout(location = 3) out vec3 FRAG_Binormal;
         #endif
+        layout(location = 4) flat out uint FRAG_ImageIndex;
+        layout(location = 5) out vec3 FRAG_ViewPosition;
     #else
         attribute vec3 VERT_Position;
         attribute vec2 VERT_TexCoord;
         attribute vec3 VERT_Normal;
-        #ifdef OC_VERTEX_FORMAT_V3T2N3T3B3
+        #ifdef OC_VERTEX_FORMAT_P3T2N3T3B3
             attribute vec3 VERT_Tangent;
             attribute vec3 VERT_Binormal;
         #endif
         
         varying vec2 FRAG_TexCoord;
         varying vec3 FRAG_Normal;
-        #ifdef OC_VERTEX_FORMAT_V3T2N3T3B3
+        #ifdef OC_VERTEX_FORMAT_P3T2N3T3B3
             varying vec3 FRAG_Tangent;
             varying vec3 FRAG_Binormal;
         #endif
@@ -68,22 +124,63 @@
         // Inputs
         layout (location = 0) in vec2 FRAG_TexCoord;
         layout (location = 1) in vec3 FRAG_Normal;
-        #ifdef OC_VERTEX_FORMAT_V3T2N3T3B3
-            layout (location = 2) in vec2 FRAG_Tangent;
+        #ifdef OC_VERTEX_FORMAT_P3T2N3T3B3
+            layout (location = 2) in vec3 FRAG_Tangent;
             layout (location = 3) in vec3 FRAG_Binormal;
         #endif
+        layout (location = 4) flat in uint FRAG_ImageIndex;
+        layout (location = 5) in vec3 FRAG_ViewPosition;   // <-- The normal, tangent and binormal are also in view space.
         
         // Outputs
         layout (location = 0) out vec4 OUT_Color;
         
-        // Uniforms
-        layout (binding = 2) uniform sampler2D Texture0;
+        // Uniforms. Every image is in a single array. The index is the same for every fragment of a draw so it's dynamically uniform.
+        OC_SPECIALIZATION_CONSTANT(1, int, SPEC_MaxImages, 4096);
+        layout (set = 1, binding = 0) uniform sampler2D Images[SPEC_MaxImages];
+
+        #define Texture0 Images[FRAG_ImageIndex]
+
+        // The lights affecting the render target, in view space. Must match ocvkLightData.
+        struct LightData
+        {
+            vec4 PositionRadius;
+            vec4 Color;
+            vec4 DirectionCosOuter;
+            float CosInner;
+            float Attenuation;
+            uint Type;
+        };
+
+        OC_SSBO(0, OC_UBO_BINDING_LIGHTS_FRAG, SSBO_Lights)
+        {
+            LightData Lights[];
+        };
+
+        // The list of lights affecting each cluster of the render target's view frustum. The lights in the list of a cluster are at
+        // LightIndices[Offset] to LightIndices[Offset + Count - 1]. Lights that affect everything are not in any list, and are instead at
+        // Lights[GlobalLightOffset] to Lights[GlobalLightOffset + GlobalLightCount - 1]. Must match ocvkLightClusterHeader.
+        struct LightClusterRange
+        {
+            uint Offset;
+            uint Count;
+        };
+
+        OC_SSBO(0, OC_UBO_BINDING_LIGHT_CLUSTERS_FRAG, SSBO_LightClusters)
+        {
+            vec4 ClusterScale;              // <-- See ocLightClusterParams.
+            uint LightCount;                // <-- 0 when lighting is disabled.
+            uint GlobalLightOffset;
+            uint GlobalLightCount;
+            uint Padding;                   // <-- The ranges are only 4 byte aligned under std430 so this needs to be explicit.
+            LightClusterRange ClusterRanges[OC_LIGHT_CLUSTER_COUNT];
+            uint LightIndices[];
+        };
     #else
         // Inputs
         varying vec2 FRAG_TexCoord;
         varying vec3 FRAG_Normal;
-        #ifdef OC_VERTEX_FORMAT_V3T2N3T3B3
-            varying vec2 FRAG_Tangent;
+        #ifdef OC_VERTEX_FORMAT_P3T2N3T3B3
+            varying vec3 FRAG_Tangent;
             varying vec3 FRAG_Binormal;
         #endif
         
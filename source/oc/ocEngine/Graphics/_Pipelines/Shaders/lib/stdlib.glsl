@@ -11,6 +11,23 @@
 #define OC_UBO(_set, _binding, _blockname) uniform struct _blockname
 #endif
 
+#ifdef VULKAN
+#define OC_SSBO(_set, _binding, _blockname) layout (std430, set = _set, binding = _binding) readonly buffer _blockname
+#endif
+
+// Specialization constants are set when the pipeline is created, which lets the driver optimize them like any other constant without
+// needing a separate shader for each value. The IDs must match the OC_VK_SPEC_CONSTANT_* IDs used by the engine.
+#ifdef VULKAN
+#define OC_SPECIALIZATION_CONSTANT(_id, _type, _name, _default) layout (constant_id = _id) const _type _name = _default
+#else
+#define OC_SPECIALIZATION_CONSTANT(_id, _type, _name, _default) const _type _name = _default
+#endif
+
+// Values of the SPEC_PrimitiveType specialization constant. These must match ocGraphicsPrimitiveType.
+#define OC_PRIMITIVE_TYPE_POINT     0
+#define OC_PRIMITIVE_TYPE_LINE      1
+#define OC_PRIMITIVE_TYPE_TRIANGLE  2
+
 #if defined(__VERSION__) && __VERSION__ <= 120
     #if defined(SHADER_STAGE_FRAGMENT)
         vec4 texture(sampler1D s, float coord, float bias) { return texture1D(s, coord, bias); }
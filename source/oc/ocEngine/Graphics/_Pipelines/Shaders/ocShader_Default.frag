@@ -1,10 +1,67 @@
 #include "lib/stdlib.glsl"
 #include "lib/stdio.glsl"
 
+#ifdef VULKAN
+// The light arriving at a point from a single light, before it's multiplied by the surface's color.
+vec3 CalculateLight(LightData light, vec3 position, vec3 normal)
+{
+    if (light.Type == LIGHT_TYPE_AMBIENT) {
+        return light.Color.rgb;
+    }
+
+    if (light.Type == LIGHT_TYPE_DIRECTIONAL) {
+        return light.Color.rgb * max(dot(normal, -light.DirectionCosOuter.xyz), 0.0);
+    }
+
+    // Point and spot lights. The light fades to exactly nothing at the radius so that it's safe to leave it out of clusters that are
+    // further away than that.
+    vec3  toLight  = light.PositionRadius.xyz - position;
+    float dist     = length(toLight);
+    vec3  L        = toLight / max(dist, 0.0001);
+
+    float window  = clamp(1.0 - pow(dist / light.PositionRadius.w, 4.0), 0.0, 1.0);
+    float falloff = (window * window) / (1.0 + light.Attenuation * dist * dist);
+
+    if (light.Type == LIGHT_TYPE_SPOT) {
+        falloff *= smoothstep(light.DirectionCosOuter.w, light.CosInner, dot(-L, light.DirectionCosOuter.xyz));
+    }
+
+    return light.Color.rgb * falloff * max(dot(normal, L), 0.0);
+}
+
+// Adds up the light from every light affecting the fragment. Only the lights in the fragment's cluster need to be considered.
+vec3 CalculateLighting(vec3 position, vec3 normal)
+{
+    uvec3 cluster;
+    cluster.x = uint(clamp(floor(gl_FragCoord.x * ClusterScale.x), 0.0, float(OC_LIGHT_CLUSTER_COUNT_X - 1)));
+    cluster.y = uint(clamp(floor(gl_FragCoord.y * ClusterScale.y), 0.0, float(OC_LIGHT_CLUSTER_COUNT_Y - 1)));
+    cluster.z = uint(clamp(floor(log(max(-position.z, 0.0001)) * ClusterScale.z + ClusterScale.w), 0.0, float(OC_LIGHT_CLUSTER_COUNT_Z - 1)));
+
+    LightClusterRange range = ClusterRanges[(cluster.z*uint(OC_LIGHT_CLUSTER_COUNT_Y) + cluster.y)*uint(OC_LIGHT_CLUSTER_COUNT_X) + cluster.x];
+
+    vec3 result = vec3(0);
+    for (uint i = 0; i < range.Count; ++i) {
+        result += CalculateLight(Lights[LightIndices[range.Offset + i]], position, normal);
+    }
+    for (uint i = 0; i < GlobalLightCount; ++i) {
+        result += CalculateLight(Lights[GlobalLightOffset + i], position, normal);
+    }
+
+    return result;
+}
+#endif
+
 void main()
 {
     OUT_Color = texture(Texture0, FRAG_TexCoord, 0.0f);
 
+#ifdef VULKAN
+    // Everything is drawn unlit when there are no lights.
+    if (LightCount > 0) {
+        OUT_Color.rgb *= CalculateLighting(FRAG_ViewPosition, normalize(FRAG_Normal));
+    }
+#endif
+
 #ifndef VULKAN
     gl_FragColor = OUT_Color;
 #endif
@@ -3,7 +3,39 @@
 
 void main()
 {
+#ifdef OC_VERTEX_FORMAT_P3T2N3J4W4
+    // Linear blend skinning. The weights of each vertex must add up to 1.
+    mat4 skin =
+        Bones[Object.BoneOffset + VERT_BoneIndices.x] * VERT_BoneWeights.x +
+        Bones[Object.BoneOffset + VERT_BoneIndices.y] * VERT_BoneWeights.y +
+        Bones[Object.BoneOffset + VERT_BoneIndices.z] * VERT_BoneWeights.z +
+        Bones[Object.BoneOffset + VERT_BoneIndices.w] * VERT_BoneWeights.w;
+
+    vec4 position = skin * vec4(VERT_Position, 1);
+    vec3 normal   = mat3(skin) * VERT_Normal;
+#else
+    vec4 position = vec4(VERT_Position, 1);
+    vec3 normal   = VERT_Normal;
+#endif
+
+    // Lighting is done in view space. Scaling is assumed to be uniform, which means the normal matrix is the same as the model-view matrix.
+    mat4 modelView    = Camera.View * Object.Model;
+    vec4 viewPosition = modelView * position;
+
     FRAG_TexCoord = VERT_TexCoord;
-    FRAG_Normal   = VERT_Normal;
-    gl_Position   = Camera.Projection * Camera.View * Object.Model * vec4(VERT_Position, 1);
+    FRAG_Normal   = mat3(modelView) * normal;
+#ifdef OC_VERTEX_FORMAT_P3T2N3T3B3
+    FRAG_Tangent  = mat3(modelView) * VERT_Tangent;
+    FRAG_Binormal = mat3(modelView) * VERT_Binormal;
+#endif
+#ifdef VULKAN
+    FRAG_ImageIndex   = Object.ImageIndex;
+    FRAG_ViewPosition = viewPosition.xyz;
+#endif
+    gl_Position   = Camera.Projection * viewPosition;
+
+    // Points are undefined unless the size is written.
+    if (SPEC_PrimitiveType == OC_PRIMITIVE_TYPE_POINT) {
+        gl_PointSize = 1.0;
+    }
 }
@@ -0,0 +1,13 @@
+#include "lib/stdlib.glsl"
+
+layout(location = 0) in vec2 FRAG_Corner;
+layout(location = 1) in vec4 FRAG_Color;
+
+layout(location = 0) out vec4 OUT_Color;
+
+void main()
+{
+    // A soft disc that fades out towards the edge of the quad.
+    float falloff = clamp(1.0 - dot(FRAG_Corner, FRAG_Corner), 0.0, 1.0);
+    OUT_Color = FRAG_Color * falloff;
+}
@@ -0,0 +1,35 @@
+#include "lib/stdlib.glsl"
+
+// Particles are drawn as camera facing quads, 6 vertices per particle, with each particle being an instance. The corners of the quad come
+// from the vertex index so the only vertex buffer is the instance data, which must match ocParticleInstance. The vertex format of this
+// pipeline is ignored.
+
+OC_UBO(0, 0, UBO_Camera)
+{
+    mat4 Projection;
+    mat4 View;
+} Camera;
+
+layout(location = 0) in vec4 INST_PositionSize;    // <-- XYZ is the position. W is the size.
+layout(location = 1) in vec4 INST_Color;
+
+layout(location = 0) out vec2 FRAG_Corner;
+layout(location = 1) out vec4 FRAG_Color;
+
+const vec2 Corners[6] = vec2[6](
+    vec2(-1, -1), vec2( 1, -1), vec2( 1,  1),
+    vec2(-1, -1), vec2( 1,  1), vec2(-1,  1)
+);
+
+void main()
+{
+    vec2 corner = Corners[gl_VertexIndex];
+
+    // The quad is expanded in view space so that it always faces the camera.
+    vec4 position = Camera.View * vec4(INST_PositionSize.xyz, 1);
+    position.xy += corner * (INST_PositionSize.w * 0.5);
+
+    FRAG_Corner = corner;
+    FRAG_Color  = vec4(INST_Color.rgb * INST_Color.a, INST_Color.a);    // <-- Premultiplied.
+    gl_Position = Camera.Projection * position;
+}
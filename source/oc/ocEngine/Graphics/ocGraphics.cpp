@@ -121,6 +121,29 @@ void ocGraphicsRTUninitBase(ocGraphicsRTBase* pRT)
 
 
 
+ocGraphicsLightDesc ocGraphicsLightDescInit(ocGraphicsObjectType type)
+{
+    ocGraphicsLightDesc desc;
+    ocZeroObject(&desc);
+    desc.type        = type;
+    desc.color.r     = 1;
+    desc.color.g     = 1;
+    desc.color.b     = 1;
+    desc.color.a     = 1;
+    desc.radius      = 10;
+    desc.attenuation = 0;
+    desc.angleInner  = glm::radians(30.0f);
+    desc.angleOuter  = glm::radians(45.0f);
+
+    return desc;
+}
+
+
+
+#include "ocLightClusters.cpp"
+
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // Backends
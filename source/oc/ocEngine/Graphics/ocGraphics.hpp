@@ -24,7 +24,10 @@ enum ocGraphicsObjectType
 enum ocGraphicsVertexFormat
 {
     ocGraphicsVertexFormat_P3T2N3,          // <-- Normal mapping disabled
-    ocGraphicsVertexFormat_P3T2N3T3B3       // <-- Normal mapping enabled
+    ocGraphicsVertexFormat_P3T2N3T3B3,      // <-- Normal mapping enabled
+    ocGraphicsVertexFormat_P3T2N3J4W4,      // <-- Skinned. 4 bone indices (8-bit unsigned) and 4 bone weights (8-bit normalized) per vertex.
+
+    ocGraphicsVertexFormat_Count            // <-- Not a real format. The number of vertex formats.
 };
 
 enum ocGraphicsIndexFormat
@@ -37,7 +40,9 @@ enum ocGraphicsPrimitiveType
 {
     ocGraphicsPrimitiveType_Point,
     ocGraphicsPrimitiveType_Line,
-    ocGraphicsPrimitiveType_Triangle
+    ocGraphicsPrimitiveType_Triangle,
+
+    ocGraphicsPrimitiveType_Count           // <-- Not a real type. The number of primitive types.
 };
 
 enum ocGraphicsShaderStage
@@ -56,6 +61,8 @@ OC_INLINE size_t ocGetVertexSizeFromFormat(ocGraphicsVertexFormat vertexFormat)
     {
         case ocGraphicsVertexFormat_P3T2N3:     return sizeof(float) * (3+2+3);
         case ocGraphicsVertexFormat_P3T2N3T3B3: return sizeof(float) * (3+2+3+3+3);
+        case ocGraphicsVertexFormat_P3T2N3J4W4: return sizeof(float) * (3+2+3) + 4 + 4;
+        default: break;
     }
 
     return 0;
@@ -99,6 +106,27 @@ struct ocGraphicsImageDesc
     const void* pImageData;
 };
 
+// Describes a light object. Which members are used depends on the type:
+//   - Ambient lights only use the color and light everything evenly.
+//   - Directional lights use the color and shine down the object's forward axis (-Z).
+//   - Point lights use the color, radius and attenuation. Nothing outside of the radius is lit.
+//   - Spot lights use everything and shine down the object's forward axis. The angles are half angles in radians. The light fades out
+//     between the inner and outer angles.
+//
+// The color is not clamped so it can be made brighter than 1 for strong lights.
+struct ocGraphicsLightDesc
+{
+    ocGraphicsObjectType type;
+    ocColorF color;
+    float radius;
+    float attenuation;                  // <-- How quickly the light fades with distance, on top of fading to nothing at the radius.
+    float angleInner;
+    float angleOuter;
+};
+
+// Creates a light description with sensible defaults for the given type: a white light with a radius of 10.
+ocGraphicsLightDesc ocGraphicsLightDescInit(ocGraphicsObjectType type);
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -245,6 +273,10 @@ ocResult ocGraphicsCreateImage(ocGraphicsContext* pGraphics, ocGraphicsImageDesc
 // Deletes an image.
 void ocGraphicsDeleteImage(ocGraphicsContext* pGraphics, ocGraphicsImage* pImage);
 
+// Moves the contents of pNewImage into pImage and deletes pNewImage, along with the old contents of pImage. Anything referring to pImage
+// will see the new contents. Neither image can be in use by the GPU, so this should be done between frames.
+void ocGraphicsReplaceImage(ocGraphicsContext* pGraphics, ocGraphicsImage* pImage, ocGraphicsImage* pNewImage);
+
 
 // ocGraphicsCreateMesh
 ocResult ocGraphicsCreateMesh(ocGraphicsContext* pGraphics, ocGraphicsMeshDesc* pDesc, ocGraphicsMesh** ppMesh);
@@ -252,6 +284,10 @@ ocResult ocGraphicsCreateMesh(ocGraphicsContext* pGraphics, ocGraphicsMeshDesc*
 // ocGraphicsDeleteMesh
 void ocGraphicsDeleteMesh(ocGraphicsContext* pGraphics, ocGraphicsMesh* pMesh);
 
+// Moves the contents of pNewMesh into pMesh and deletes pNewMesh, along with the old contents of pMesh. Objects drawing pMesh will draw
+// the new contents. Neither mesh can be in use by the GPU, so this should be done between frames.
+void ocGraphicsReplaceMesh(ocGraphicsContext* pGraphics, ocGraphicsMesh* pMesh, ocGraphicsMesh* pNewMesh);
+
 
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -273,7 +309,8 @@ void ocGraphicsWorldDraw(ocGraphicsWorld* pWorld);
 // Draws an individual render target.
 void ocGraphicsWorldDrawRT(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT);
 
-// ocGraphicsWorldStep()
+// Steps the world by dt seconds. This advances the animations of skinned mesh objects and updates their bone palettes, and simulates the
+// particles of particle system objects.
 void ocGraphicsWorldStep(ocGraphicsWorld* pWorld, double dt);
 
 
@@ -290,6 +327,27 @@ void ocGraphicsWorldDeleteRT(ocGraphicsWorld* pWorld, ocGraphicsRT* pRT);
 // Creates a mesh object.
 ocResult ocGraphicsWorldCreateMeshObject(ocGraphicsWorld* pWorld, ocGraphicsMesh* pMesh, ocGraphicsObject** ppObjectOut);
 
+// Creates a mesh object that's deformed by a skeleton. The mesh must use ocGraphicsVertexFormat_P3T2N3J4W4 and the skeleton must
+// remain valid while the object exists. The object starts in the bind pose of the skeleton. Use the animation character from
+// ocGraphicsWorldGetObjectAnimationCharacter() to play clips on it.
+ocResult ocGraphicsWorldCreateSkinnedMeshObject(ocGraphicsWorld* pWorld, ocGraphicsMesh* pMesh, const ocSkeleton* pSkeleton, ocGraphicsObject** ppObjectOut);
+
+// Retrieves the animation character of a skinned mesh object. Returns NULL if the object is not skinned.
+ocAnimationCharacter* ocGraphicsWorldGetObjectAnimationCharacter(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject);
+
+// Creates a particle system object. The object starts out emitting at the origin. Use the particle emitter from
+// ocGraphicsWorldGetObjectParticleEmitter() to start and stop it or to fire bursts.
+ocResult ocGraphicsWorldCreateParticleSystemObject(ocGraphicsWorld* pWorld, const ocParticleEmitterDesc* pDesc, ocGraphicsObject** ppObjectOut);
+
+// Retrieves the particle emitter of a particle system object. Returns NULL if the object is not a particle system.
+ocParticleEmitter* ocGraphicsWorldGetObjectParticleEmitter(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject);
+
+// Creates a light object. pDesc->type must be one of the light types. The light starts out at the origin, shining down -Z.
+//
+// Point and spot lights are assigned to the clusters of each render target's view frustum every time it's drawn, so the cost of
+// shading a fragment only depends on the lights that are near it rather than the number of lights in the world.
+ocResult ocGraphicsWorldCreateLightObject(ocGraphicsWorld* pWorld, const ocGraphicsLightDesc* pDesc, ocGraphicsObject** ppObjectOut);
+
 // Deletes the given graphics object.
 void ocGraphicsWorldDeleteObject(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject);
 
@@ -312,6 +370,14 @@ void ocGraphicsWorldSetObjectScale(ocGraphicsWorld* pWorld, ocGraphicsObject* pO
 // Sets the position, rotation and scale of an object as a single operation.
 void ocGraphicsWorldSetObjectTransform(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale);
 
+// Sets the image the object is textured with. Set pImage to NULL to use a plain white image, which is the default.
+//
+// The image must have been created with OC_GRAPHICS_IMAGE_USAGE_SHADER_INPUT and must not be deleted while the object is using it.
+void ocGraphicsWorldSetObjectImage(ocGraphicsWorld* pWorld, ocGraphicsObject* pObject, ocGraphicsImage* pImage);
+
+
+#include "ocLightClusters.hpp"
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -0,0 +1,459 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Clusters are padded by this much in normalized device coordinates and by this fraction of their depth so that a fragment that's right
+// on the boundary between two clusters is never assigned to a cluster that missed a light because of rounding.
+#define OC_LIGHT_CLUSTER_PADDING_NDC    0.001f
+#define OC_LIGHT_CLUSTER_PADDING_DEPTH  0.001f
+
+OC_PRIVATE glm::vec3 ocLightClusterUnproject(const glm::mat4 &invProjection, float x, float y, float z)
+{
+    glm::vec4 point = invProjection * glm::vec4(x, y, z, 1);
+    return glm::vec3(point) / point.w;
+}
+
+// Calculates the bounding box of each cluster. Every cluster is the section of the frustum of it's tile that's between the depths of
+// it's slice. The edges of the tile's frustum are found by unprojecting it's corners at the near and far planes, which works for both
+// perspective and orthographic projections.
+OC_PRIVATE void ocLightClusterGridCalculateBounds(ocLightClusterGrid* pGrid, const float* pSliceDepths)
+{
+    glm::mat4 invProjection = glm::inverse(pGrid->projection);
+
+    for (ocUInt32 y = 0; y < OC_LIGHT_CLUSTER_COUNT_Y; ++y) {
+        for (ocUInt32 x = 0; x < OC_LIGHT_CLUSTER_COUNT_X; ++x) {
+            float ndcX0 = -1 + 2 * (float)(x    ) / OC_LIGHT_CLUSTER_COUNT_X - OC_LIGHT_CLUSTER_PADDING_NDC;
+            float ndcX1 = -1 + 2 * (float)(x + 1) / OC_LIGHT_CLUSTER_COUNT_X + OC_LIGHT_CLUSTER_PADDING_NDC;
+            float ndcY0 =  1 - 2 * (float)(y    ) / OC_LIGHT_CLUSTER_COUNT_Y + OC_LIGHT_CLUSTER_PADDING_NDC;     // <-- Rows go from top to bottom.
+            float ndcY1 =  1 - 2 * (float)(y + 1) / OC_LIGHT_CLUSTER_COUNT_Y - OC_LIGHT_CLUSTER_PADDING_NDC;
+
+            glm::vec3 pNear[4];
+            glm::vec3 pFar[4];
+            pNear[0] = ocLightClusterUnproject(invProjection, ndcX0, ndcY0, -1); pFar[0] = ocLightClusterUnproject(invProjection, ndcX0, ndcY0, 1);
+            pNear[1] = ocLightClusterUnproject(invProjection, ndcX1, ndcY0, -1); pFar[1] = ocLightClusterUnproject(invProjection, ndcX1, ndcY0, 1);
+            pNear[2] = ocLightClusterUnproject(invProjection, ndcX0, ndcY1, -1); pFar[2] = ocLightClusterUnproject(invProjection, ndcX0, ndcY1, 1);
+            pNear[3] = ocLightClusterUnproject(invProjection, ndcX1, ndcY1, -1); pFar[3] = ocLightClusterUnproject(invProjection, ndcX1, ndcY1, 1);
+
+            for (ocUInt32 z = 0; z < OC_LIGHT_CLUSTER_COUNT_Z; ++z) {
+                float pDepths[2];
+                pDepths[0] = pSliceDepths[z  ] - fabsf(pSliceDepths[z  ]) * OC_LIGHT_CLUSTER_PADDING_DEPTH;
+                pDepths[1] = pSliceDepths[z+1] + fabsf(pSliceDepths[z+1]) * OC_LIGHT_CLUSTER_PADDING_DEPTH;
+
+                ocLightClusterBounds* pBounds = &pGrid->bounds[(z*OC_LIGHT_CLUSTER_COUNT_Y + y)*OC_LIGHT_CLUSTER_COUNT_X + x];
+                for (int i = 0; i < 3; ++i) {
+                    pBounds->min[i] =  FLT_MAX;
+                    pBounds->max[i] = -FLT_MAX;
+                }
+
+                // View space looks down -Z, so a depth of d is at a Z of -d.
+                for (ocUInt32 iCorner = 0; iCorner < 4; ++iCorner) {
+                    for (ocUInt32 iDepth = 0; iDepth < 2; ++iDepth) {
+                        glm::vec3 edge = pFar[iCorner] - pNear[iCorner];
+                        glm::vec3 point = pNear[iCorner] + edge * ((-pDepths[iDepth] - pNear[iCorner].z) / edge.z);
+                        for (int i = 0; i < 3; ++i) {
+                            pBounds->min[i] = ocMin(pBounds->min[i], point[i]);
+                            pBounds->max[i] = ocMax(pBounds->max[i], point[i]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+// Tests a range of candidates against the bounding box of a cluster and writes the indices of the ones that touch it to pIndicesOut.
+// Returns the number of indices written. Candidates are stored as 4 arrays of stride floats: X, Y, Z and squared radius.
+OC_PRIVATE ocUInt32 ocLightClusterCull_Scalar(const ocLightClusterBounds* pBounds, const float* pCandidates, ocUInt32 stride, const ocUInt32* pCandidateIndices, ocUInt32 iBegin, ocUInt32 iEnd, ocUInt32* pIndicesOut)
+{
+    const float* pX = pCandidates;
+    const float* pY = pX + stride;
+    const float* pZ = pY + stride;
+    const float* pRadiusSq = pZ + stride;
+
+    ocUInt32 count = 0;
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        // The distance from the center of the sphere to the nearest point of the box.
+        float dx = ocMax(ocMax(pBounds->min[0] - pX[i], pX[i] - pBounds->max[0]), 0.0f);
+        float dy = ocMax(ocMax(pBounds->min[1] - pY[i], pY[i] - pBounds->max[1]), 0.0f);
+        float dz = ocMax(ocMax(pBounds->min[2] - pZ[i], pZ[i] - pBounds->max[2]), 0.0f);
+        if (dx*dx + dy*dy + dz*dz <= pRadiusSq[i]) {
+            pIndicesOut[count++] = pCandidateIndices[i];
+        }
+    }
+
+    return count;
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE ocUInt32 ocLightClusterCull_SSE2(const ocLightClusterBounds* pBounds, const float* pCandidates, ocUInt32 stride, const ocUInt32* pCandidateIndices, ocUInt32 iBegin, ocUInt32 iEnd, ocUInt32* pIndicesOut)
+{
+    const float* pX = pCandidates;
+    const float* pY = pX + stride;
+    const float* pZ = pY + stride;
+    const float* pRadiusSq = pZ + stride;
+
+    const __m128 minX = _mm_set1_ps(pBounds->min[0]);
+    const __m128 minY = _mm_set1_ps(pBounds->min[1]);
+    const __m128 minZ = _mm_set1_ps(pBounds->min[2]);
+    const __m128 maxX = _mm_set1_ps(pBounds->max[0]);
+    const __m128 maxY = _mm_set1_ps(pBounds->max[1]);
+    const __m128 maxZ = _mm_set1_ps(pBounds->max[2]);
+    const __m128 zero = _mm_setzero_ps();
+
+    ocUInt32 count = 0;
+    ocUInt32 i = iBegin;
+    for (; i + 4 <= iEnd; i += 4) {
+        __m128 x = _mm_loadu_ps(pX + i);
+        __m128 y = _mm_loadu_ps(pY + i);
+        __m128 z = _mm_loadu_ps(pZ + i);
+        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)), zero);
+        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)), zero);
+        __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, z), _mm_sub_ps(z, maxZ)), zero);
+        __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+        ocUInt32 mask = (ocUInt32)_mm_movemask_ps(_mm_cmple_ps(distanceSq, _mm_loadu_ps(pRadiusSq + i)));
+        while (mask != 0) {
+            pIndicesOut[count++] = pCandidateIndices[i + ocBitScanForward32(mask) - 1];
+            mask &= mask - 1;
+        }
+    }
+
+    return count + ocLightClusterCull_Scalar(pBounds, pCandidates, stride, pCandidateIndices, i, iEnd, pIndicesOut + count);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE ocUInt32 ocLightClusterCull_AVX2(const ocLightClusterBounds* pBounds, const float* pCandidates, ocUInt32 stride, const ocUInt32* pCandidateIndices, ocUInt32 iBegin, ocUInt32 iEnd, ocUInt32* pIndicesOut)
+{
+    const float* pX = pCandidates;
+    const float* pY = pX + stride;
+    const float* pZ = pY + stride;
+    const float* pRadiusSq = pZ + stride;
+
+    const __m256 minX = _mm256_set1_ps(pBounds->min[0]);
+    const __m256 minY = _mm256_set1_ps(pBounds->min[1]);
+    const __m256 minZ = _mm256_set1_ps(pBounds->min[2]);
+    const __m256 maxX = _mm256_set1_ps(pBounds->max[0]);
+    const __m256 maxY = _mm256_set1_ps(pBounds->max[1]);
+    const __m256 maxZ = _mm256_set1_ps(pBounds->max[2]);
+    const __m256 zero = _mm256_setzero_ps();
+
+    ocUInt32 count = 0;
+    ocUInt32 i = iBegin;
+    for (; i + 8 <= iEnd; i += 8) {
+        __m256 x = _mm256_loadu_ps(pX + i);
+        __m256 y = _mm256_loadu_ps(pY + i);
+        __m256 z = _mm256_loadu_ps(pZ + i);
+        __m256 dx = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minX, x), _mm256_sub_ps(x, maxX)), zero);
+        __m256 dy = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minY, y), _mm256_sub_ps(y, maxY)), zero);
+        __m256 dz = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minZ, z), _mm256_sub_ps(z, maxZ)), zero);
+        __m256 distanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+        ocUInt32 mask = (ocUInt32)_mm256_movemask_ps(_mm256_cmp_ps(distanceSq, _mm256_loadu_ps(pRadiusSq + i), _CMP_LE_OQ));
+        while (mask != 0) {
+            pIndicesOut[count++] = pCandidateIndices[i + ocBitScanForward32(mask) - 1];
+            mask &= mask - 1;
+        }
+    }
+
+    return count + ocLightClusterCull_Scalar(pBounds, pCandidates, stride, pCandidateIndices, i, iEnd, pIndicesOut + count);
+}
+#endif
+
+OC_PRIVATE ocUInt32 ocLightClusterCull(const ocLightClusterBounds* pBounds, const float* pCandidates, ocUInt32 stride, const ocUInt32* pCandidateIndices, ocUInt32 iBegin, ocUInt32 iEnd, ocUInt32* pIndicesOut)
+{
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        return ocLightClusterCull_AVX2(pBounds, pCandidates, stride, pCandidateIndices, iBegin, iEnd, pIndicesOut);
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        return ocLightClusterCull_SSE2(pBounds, pCandidates, stride, pCandidateIndices, iBegin, iEnd, pIndicesOut);
+    }
+#endif
+
+    return ocLightClusterCull_Scalar(pBounds, pCandidates, stride, pCandidateIndices, iBegin, iEnd, pIndicesOut);
+}
+
+
+// Builds the lists of every cluster in a slice. The ranges of the slice are relative to the start of the slice's list.
+OC_PRIVATE ocResult ocLightClusterGridBinSlice(ocLightClusterGrid* pGrid, ocUInt32 iSlice)
+{
+    const ocUInt32 tilesPerSlice = OC_LIGHT_CLUSTER_COUNT_X * OC_LIGHT_CLUSTER_COUNT_Y;
+    ocUInt32 stride = pGrid->lightStride;
+
+    const float* pX = pGrid->lights.pItems;
+    const float* pY = pX + stride;
+    const float* pZ = pY + stride;
+    const float* pRadius = pZ + stride;
+
+    float* pCandidates = pGrid->candidates.pItems + (size_t)iSlice * stride * 4;
+    ocUInt32* pCandidateIndices = pGrid->candidateIndices.pItems + (size_t)iSlice * stride;
+
+    // Every cluster in a slice has the same depth range so the first one is as good as any.
+    float sliceMinZ = pGrid->bounds[iSlice * tilesPerSlice].min[2];
+    float sliceMaxZ = pGrid->bounds[iSlice * tilesPerSlice].max[2];
+
+    ocUInt32 candidateCount = 0;
+    for (ocUInt32 iLight = 0; iLight < pGrid->lightCount; ++iLight) {
+        if (pZ[iLight] - pRadius[iLight] <= sliceMaxZ && pZ[iLight] + pRadius[iLight] >= sliceMinZ) {
+            pCandidates[stride*0 + candidateCount] = pX[iLight];
+            pCandidates[stride*1 + candidateCount] = pY[iLight];
+            pCandidates[stride*2 + candidateCount] = pZ[iLight];
+            pCandidates[stride*3 + candidateCount] = pRadius[iLight] * pRadius[iLight];
+            pCandidateIndices[candidateCount] = iLight;
+            candidateCount += 1;
+        }
+    }
+
+    // The candidates are padded to a multiple of 8 with lights that never touch anything so the SIMD kernels don't need a remainder.
+    ocUInt32 paddedCandidateCount = ocAlign(candidateCount, 8);
+    for (ocUInt32 i = candidateCount; i < paddedCandidateCount; ++i) {
+        pCandidates[stride*0 + i] =  0;
+        pCandidates[stride*1 + i] =  0;
+        pCandidates[stride*2 + i] =  0;
+        pCandidates[stride*3 + i] = -1;
+        pCandidateIndices[i] = 0;
+    }
+
+    ocStack<ocUInt32>* pIndices = &pGrid->sliceIndices[iSlice];
+    ocStackClear(pIndices);
+
+    for (ocUInt32 iTile = 0; iTile < tilesPerSlice; ++iTile) {
+        ocUInt32 iCluster = iSlice * tilesPerSlice + iTile;
+
+        ocLightClusterRange* pRange = &pGrid->ranges[iCluster];
+        pRange->offset = (ocUInt32)pIndices->count;
+        pRange->count  = 0;
+
+        if (candidateCount == 0) {
+            continue;
+        }
+
+        // Make room for every candidate and then shrink back down to the ones that were kept.
+        ocResult result = ocStackResize(pIndices, pIndices->count + candidateCount);
+        if (result != OC_SUCCESS) {
+            pIndices->count = pRange->offset;
+            return result;
+        }
+
+        pRange->count   = ocLightClusterCull(&pGrid->bounds[iCluster], pCandidates, stride, pCandidateIndices, 0, paddedCandidateCount, pIndices->pItems + pRange->offset);
+        pIndices->count = pRange->offset + pRange->count;
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocLightClusterGridJobProc(void* pUserData)
+{
+    ocLightClusterJob* pJob = (ocLightClusterJob*)pUserData;
+    ocAssert(pJob != NULL);
+
+    pJob->result = ocLightClusterGridBinSlice(pJob->pGrid, pJob->slice);
+}
+
+
+ocResult ocLightClusterGridInit(ocJobQueue* pJobQueue, ocLightClusterGrid* pGrid)
+{
+    if (pGrid == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pGrid);
+
+    pGrid->pJobQueue = pJobQueue;
+    ocStackInit(&pGrid->lights);
+    ocStackInit(&pGrid->candidates);
+    ocStackInit(&pGrid->candidateIndices);
+    for (ocUInt32 iSlice = 0; iSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iSlice) {
+        ocStackInit(&pGrid->sliceIndices[iSlice]);
+    }
+
+    // The view starts out as a unit perspective projection so the grid is valid before the first call to ocLightClusterGridSetView().
+    ocLightClusterGridSetView(pGrid, glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f), 1, 1);
+
+    return OC_SUCCESS;
+}
+
+void ocLightClusterGridUninit(ocLightClusterGrid* pGrid)
+{
+    if (pGrid == NULL) {
+        return;
+    }
+
+    for (ocUInt32 iSlice = 0; iSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iSlice) {
+        ocStackUninit(&pGrid->sliceIndices[iSlice]);
+    }
+    ocStackUninit(&pGrid->candidateIndices);
+    ocStackUninit(&pGrid->candidates);
+    ocStackUninit(&pGrid->lights);
+}
+
+void ocLightClusterGridSetView(ocLightClusterGrid* pGrid, const glm::mat4 &projection, ocUInt32 sizeX, ocUInt32 sizeY)
+{
+    if (pGrid == NULL || sizeX == 0 || sizeY == 0) {
+        return;
+    }
+
+    if (pGrid->sizeX == sizeX && pGrid->sizeY == sizeY && memcmp(&pGrid->projection, &projection, sizeof(projection)) == 0) {
+        return;
+    }
+
+    pGrid->projection = projection;
+    pGrid->sizeX = sizeX;
+    pGrid->sizeY = sizeY;
+
+    // The depths of the near and far planes.
+    glm::mat4 invProjection = glm::inverse(projection);
+    float nearDepth = -ocLightClusterUnproject(invProjection, 0, 0, -1).z;
+    float farDepth  = -ocLightClusterUnproject(invProjection, 0, 0,  1).z;
+
+    // Slices are spaced exponentially, which needs a near plane that's in front of the camera.
+    float sliceNear = ocMax(nearDepth, OC_LIGHT_CLUSTER_MIN_DEPTH);
+    float sliceFar  = ocMax(farDepth, sliceNear * 2);
+    float logRatio  = logf(sliceFar / sliceNear);
+
+    pGrid->params.scaleX = (float)OC_LIGHT_CLUSTER_COUNT_X / sizeX;
+    pGrid->params.scaleY = (float)OC_LIGHT_CLUSTER_COUNT_Y / sizeY;
+    pGrid->params.scaleZ = (float)OC_LIGHT_CLUSTER_COUNT_Z / logRatio;
+    pGrid->params.biasZ  = -(float)OC_LIGHT_CLUSTER_COUNT_Z * logf(sliceNear) / logRatio;
+
+    // The first and last slices go all the way to the near and far planes because fragments outside of the slices are clamped to them.
+    float pSliceDepths[OC_LIGHT_CLUSTER_COUNT_Z+1];
+    for (ocUInt32 z = 0; z <= OC_LIGHT_CLUSTER_COUNT_Z; ++z) {
+        pSliceDepths[z] = sliceNear * expf(logRatio * z / OC_LIGHT_CLUSTER_COUNT_Z);
+    }
+    pSliceDepths[0] = ocMin(nearDepth, pSliceDepths[0]);
+    pSliceDepths[OC_LIGHT_CLUSTER_COUNT_Z] = ocMax(farDepth, pSliceDepths[OC_LIGHT_CLUSTER_COUNT_Z]);
+
+    ocLightClusterGridCalculateBounds(pGrid, pSliceDepths);
+}
+
+ocLightClusterParams ocLightClusterGridGetParams(const ocLightClusterGrid* pGrid)
+{
+    ocAssert(pGrid != NULL);
+    return pGrid->params;
+}
+
+ocResult ocLightClusterGridBuild(ocLightClusterGrid* pGrid, const glm::vec4* pSpheres, ocUInt32 lightCount)
+{
+    if (pGrid == NULL || (pSpheres == NULL && lightCount > 0)) {
+        return OC_INVALID_ARGS;
+    }
+
+    pGrid->lightCount  = 0;
+    pGrid->lightStride = 0;
+    pGrid->indexCount  = 0;
+    ocZeroObject(&pGrid->ranges);
+    for (ocUInt32 iSlice = 0; iSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iSlice) {
+        ocStackClear(&pGrid->sliceIndices[iSlice]);
+    }
+
+    if (lightCount == 0) {
+        return OC_SUCCESS;
+    }
+
+    ocUInt32 stride = ocAlign(lightCount, 8);
+    if (ocStackResize(&pGrid->lights, (size_t)stride * 4) != OC_SUCCESS ||
+        ocStackResize(&pGrid->candidates, (size_t)stride * 4 * OC_LIGHT_CLUSTER_COUNT_Z) != OC_SUCCESS ||
+        ocStackResize(&pGrid->candidateIndices, (size_t)stride * OC_LIGHT_CLUSTER_COUNT_Z) != OC_SUCCESS) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pGrid->lightCount  = lightCount;
+    pGrid->lightStride = stride;
+
+    float* pX = pGrid->lights.pItems;
+    float* pY = pX + stride;
+    float* pZ = pY + stride;
+    float* pRadius = pZ + stride;
+    for (ocUInt32 iLight = 0; iLight < lightCount; ++iLight) {
+        pX[iLight] = pSpheres[iLight].x;
+        pY[iLight] = pSpheres[iLight].y;
+        pZ[iLight] = pSpheres[iLight].z;
+        pRadius[iLight] = pSpheres[iLight].w;
+    }
+
+    // Each slice is a job. Slices are independent, and there are enough of them to keep every thread busy.
+    for (ocUInt32 iSlice = 0; iSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iSlice) {
+        pGrid->jobs[iSlice].pGrid  = pGrid;
+        pGrid->jobs[iSlice].slice  = iSlice;
+        pGrid->jobs[iSlice].result = OC_SUCCESS;
+    }
+
+    if (pGrid->pJobQueue != NULL) {
+        ocUInt32 counter = 0;
+        for (ocUInt32 iSlice = 0; iSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iSlice) {
+            if (ocJobQueueSubmit(pGrid->pJobQueue, ocLightClusterGridJobProc, &pGrid->jobs[iSlice], &counter) != OC_SUCCESS) {
+                ocLightClusterGridJobProc(&pGrid->jobs[iSlice]);
+            }
+        }
+
+        ocJobQueueWaitForCounter(pGrid->pJobQueue, &counter);
+    } else {
+        for (ocUInt32 iSlice = 0; iSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iSlice) {
+            ocLightClusterGridJobProc(&pGrid->jobs[iSlice]);
+        }
+    }
+
+    // Pack the lists of every slice together.
+    const ocUInt32 tilesPerSlice = OC_LIGHT_CLUSTER_COUNT_X * OC_LIGHT_CLUSTER_COUNT_Y;
+
+    ocUInt32 indexCount = 0;
+    for (ocUInt32 iSlice = 0; iSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iSlice) {
+        if (pGrid->jobs[iSlice].result != OC_SUCCESS) {
+            // Leave the grid empty rather than half built.
+            ocZeroObject(&pGrid->ranges);
+            for (ocUInt32 iOtherSlice = 0; iOtherSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iOtherSlice) {
+                ocStackClear(&pGrid->sliceIndices[iOtherSlice]);
+            }
+
+            return pGrid->jobs[iSlice].result;
+        }
+
+        for (ocUInt32 iTile = 0; iTile < tilesPerSlice; ++iTile) {
+            pGrid->ranges[iSlice * tilesPerSlice + iTile].offset += indexCount;
+        }
+
+        indexCount += (ocUInt32)pGrid->sliceIndices[iSlice].count;
+    }
+
+    pGrid->indexCount = indexCount;
+    return OC_SUCCESS;
+}
+
+ocUInt32 ocLightClusterGridGetIndexCount(const ocLightClusterGrid* pGrid)
+{
+    if (pGrid == NULL) {
+        return 0;
+    }
+
+    return pGrid->indexCount;
+}
+
+ocLightClusterRange ocLightClusterGridGetRange(const ocLightClusterGrid* pGrid, ocUInt32 x, ocUInt32 y, ocUInt32 z)
+{
+    ocAssert(pGrid != NULL);
+    ocAssert(x < OC_LIGHT_CLUSTER_COUNT_X && y < OC_LIGHT_CLUSTER_COUNT_Y && z < OC_LIGHT_CLUSTER_COUNT_Z);
+
+    return pGrid->ranges[(z*OC_LIGHT_CLUSTER_COUNT_Y + y)*OC_LIGHT_CLUSTER_COUNT_X + x];
+}
+
+void ocLightClusterGridWrite(const ocLightClusterGrid* pGrid, ocLightClusterRange* pRanges, ocUInt32* pIndices)
+{
+    if (pGrid == NULL || pRanges == NULL) {
+        return;
+    }
+
+    memcpy(pRanges, pGrid->ranges, sizeof(pGrid->ranges));
+
+    if (pIndices != NULL) {
+        for (ocUInt32 iSlice = 0; iSlice < OC_LIGHT_CLUSTER_COUNT_Z; ++iSlice) {
+            const ocStack<ocUInt32>* pSliceIndices = &pGrid->sliceIndices[iSlice];
+            if (pSliceIndices->count > 0) {
+                memcpy(pIndices, pSliceIndices->pItems, sizeof(ocUInt32) * pSliceIndices->count);
+                pIndices += pSliceIndices->count;
+            }
+        }
+    }
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Clustered light assignment. The view frustum is split into a grid of clusters: OC_LIGHT_CLUSTER_COUNT_X by OC_LIGHT_CLUSTER_COUNT_Y
+// tiles on screen, and OC_LIGHT_CLUSTER_COUNT_Z slices in depth. Slices are spaced exponentially between the near and far planes so that
+// clusters are roughly as deep as they are wide. Each light is a sphere in view space, and is added to the list of every cluster whose
+// bounding box it touches. When shading, a fragment finds it's cluster from it's screen position and view depth and only needs to go
+// over the lights in that cluster's list.
+//
+// The lists of every cluster are packed together into a single array of light indices, with each cluster referring to a range of it.
+// Building the grid goes through each slice in parallel on the job queue. The lights that overlap a slice in depth are gathered first,
+// and then 4 or 8 of them are tested against each cluster of the slice at a time with SIMD.
+//
+// Spot lights are binned by their bounding sphere, which is conservative. Lights that affect everything, such as directional and ambient
+// lights, don't need to be binned.
+
+#define OC_LIGHT_CLUSTER_COUNT_X        16
+#define OC_LIGHT_CLUSTER_COUNT_Y        9
+#define OC_LIGHT_CLUSTER_COUNT_Z        24
+#define OC_LIGHT_CLUSTER_COUNT          (OC_LIGHT_CLUSTER_COUNT_X * OC_LIGHT_CLUSTER_COUNT_Y * OC_LIGHT_CLUSTER_COUNT_Z)
+#define OC_LIGHT_CLUSTER_MIN_DEPTH      0.01f   // <-- Slices are never placed closer than this, which keeps the logarithm sane for orthographic projections.
+
+struct ocLightClusterGrid;
+
+// The range of a cluster's list in the packed light index array. Clusters are ordered by slice, then row (top to bottom), then column.
+struct ocLightClusterRange
+{
+    ocUInt32 offset;
+    ocUInt32 count;
+};
+
+// What a shader needs to find the cluster of a fragment:
+//   x = floor(fragX * scaleX)
+//   y = floor(fragY * scaleY)                      <-- fragY is 0 at the top of the render target.
+//   z = floor(log(viewDepth) * scaleZ + biasZ)     <-- Clamped to the grid.
+struct ocLightClusterParams
+{
+    float scaleX;
+    float scaleY;
+    float scaleZ;
+    float biasZ;
+};
+
+// The view space bounding box of a cluster.
+struct ocLightClusterBounds
+{
+    float min[3];
+    float max[3];
+};
+
+struct ocLightClusterJob
+{
+    ocLightClusterGrid* pGrid;
+    ocUInt32 slice;
+    ocResult result;
+};
+
+struct ocLightClusterGrid
+{
+    ocJobQueue* pJobQueue;          // <-- Can be NULL, in which case everything is run on the calling thread.
+
+    // The view. The bounds are only recalculated when the projection or size changes.
+    glm::mat4 projection;
+    ocUInt32 sizeX;
+    ocUInt32 sizeY;
+    ocLightClusterParams params;
+    ocLightClusterBounds bounds[OC_LIGHT_CLUSTER_COUNT];
+
+    // The lights of the last build, as a structure of arrays in view space: X, Y, Z and radius, each lightStride floats long.
+    ocUInt32 lightCount;
+    ocUInt32 lightStride;           // <-- lightCount rounded up to a multiple of 8.
+    ocStack<float> lights;
+
+    // The lights that overlap each slice in depth, in the same layout as the lights except that the radius is squared. Each slice has
+    // it's own region so that slices can be binned at the same time.
+    ocStack<float> candidates;
+    ocStack<ocUInt32> candidateIndices;
+
+    // The result. The list of each slice is built separately and then the ranges are moved so that the lists are packed together.
+    ocLightClusterRange ranges[OC_LIGHT_CLUSTER_COUNT];
+    ocStack<ocUInt32> sliceIndices[OC_LIGHT_CLUSTER_COUNT_Z];
+    ocUInt32 indexCount;
+
+    ocLightClusterJob jobs[OC_LIGHT_CLUSTER_COUNT_Z];
+};
+
+// Initializes a light cluster grid. pJobQueue is optional.
+ocResult ocLightClusterGridInit(ocJobQueue* pJobQueue, ocLightClusterGrid* pGrid);
+
+// Uninitializes a light cluster grid.
+void ocLightClusterGridUninit(ocLightClusterGrid* pGrid);
+
+// Sets the projection and the size in pixels of the render target. The projection uses OpenGL conventions, which is the same as the
+// projection of a render target before it's corrected for Vulkan. Perspective and orthographic projections are both supported.
+void ocLightClusterGridSetView(ocLightClusterGrid* pGrid, const glm::mat4 &projection, ocUInt32 sizeX, ocUInt32 sizeY);
+
+// Retrieves the parameters a shader needs to find the cluster of a fragment.
+ocLightClusterParams ocLightClusterGridGetParams(const ocLightClusterGrid* pGrid);
+
+// Bins lights into the clusters. Each light is a sphere in view space, with the radius in W. The index of a light in the cluster lists
+// is it's index in pSpheres.
+ocResult ocLightClusterGridBuild(ocLightClusterGrid* pGrid, const glm::vec4* pSpheres, ocUInt32 lightCount);
+
+// Retrieves the number of light indices in the lists of every cluster combined.
+ocUInt32 ocLightClusterGridGetIndexCount(const ocLightClusterGrid* pGrid);
+
+// Retrieves the range of a cluster's list.
+ocLightClusterRange ocLightClusterGridGetRange(const ocLightClusterGrid* pGrid, ocUInt32 x, ocUInt32 y, ocUInt32 z);
+
+// Writes the range of every cluster and the packed light indices. pRanges must have room for OC_LIGHT_CLUSTER_COUNT ranges and pIndices
+// for ocLightClusterGridGetIndexCount() indices. This is intended to write straight to a buffer that's visible to the GPU.
+void ocLightClusterGridWrite(const ocLightClusterGrid* pGrid, ocLightClusterRange* pRanges, ocUInt32* pIndices);
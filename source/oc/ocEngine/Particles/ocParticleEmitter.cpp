@@ -0,0 +1,567 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Curves
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocParticleCurve ocParticleCurveInit(const glm::vec4 &value)
+{
+    ocParticleCurve curve;
+    ocZeroObject(&curve);
+    curve.keyCount      = 1;
+    curve.keys[0].time  = 0;
+    curve.keys[0].value = value;
+
+    return curve;
+}
+
+ocResult ocParticleCurveAddKey(ocParticleCurve* pCurve, float time, const glm::vec4 &value)
+{
+    if (pCurve == NULL || time < 0 || time > 1) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (pCurve->keyCount == OC_PARTICLE_CURVE_MAX_KEYS) {
+        return OC_TOO_LARGE;
+    }
+
+    if (pCurve->keyCount > 0 && time < pCurve->keys[pCurve->keyCount-1].time) {
+        return OC_INVALID_ARGS;
+    }
+
+    pCurve->keys[pCurve->keyCount].time  = time;
+    pCurve->keys[pCurve->keyCount].value = value;
+    pCurve->keyCount += 1;
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE glm::vec4 ocParticleCurveEvaluate(const ocParticleCurve* pCurve, float time)
+{
+    ocAssert(pCurve->keyCount > 0);
+
+    if (time <= pCurve->keys[0].time) {
+        return pCurve->keys[0].value;
+    }
+
+    for (ocUInt32 iKey = 1; iKey < pCurve->keyCount; ++iKey) {
+        const ocParticleCurveKey* pKey0 = &pCurve->keys[iKey-1];
+        const ocParticleCurveKey* pKey1 = &pCurve->keys[iKey];
+        if (time <= pKey1->time) {
+            float span = pKey1->time - pKey0->time;
+            float t = (span > 0) ? (time - pKey0->time) / span : 1;
+            return pKey0->value + (pKey1->value - pKey0->value)*t;
+        }
+    }
+
+    return pCurve->keys[pCurve->keyCount-1].value;
+}
+
+// Bakes the components of a curve into tables of OC_PARTICLE_CURVE_RESOLUTION+1 samples each.
+OC_PRIVATE void ocParticleCurveBake(const ocParticleCurve* pCurve, ocUInt32 componentCount, float* pTables, ocUInt32 tableStride)
+{
+    for (ocUInt32 iSample = 0; iSample <= OC_PARTICLE_CURVE_RESOLUTION; ++iSample) {
+        glm::vec4 value = ocParticleCurveEvaluate(pCurve, (float)iSample / OC_PARTICLE_CURVE_RESOLUTION);
+        for (ocUInt32 iComponent = 0; iComponent < componentCount; ++iComponent) {
+            pTables[iComponent*tableStride + iSample] = value[iComponent];
+        }
+    }
+}
+
+OC_PRIVATE ocBool32 ocParticleCurveIsValid(const ocParticleCurve* pCurve)
+{
+    return pCurve->keyCount > 0 && pCurve->keyCount <= OC_PARTICLE_CURVE_MAX_KEYS;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Spawning
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// A xorshift generator. Each emitter has it's own state so that emitters can be spawned in parallel.
+OC_INLINE float ocParticleRandom(ocUInt32* pState)
+{
+    ocUInt32 x = *pState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *pState = x;
+
+    return (float)(x >> 8) * (1.0f / 16777216.0f);  // <-- [0, 1)
+}
+
+OC_INLINE float ocParticleRandomRange(ocUInt32* pState, float lo, float hi)
+{
+    return lo + (hi - lo)*ocParticleRandom(pState);
+}
+
+OC_PRIVATE void ocParticleEmitterSpawn(ocParticleEmitter* pEmitter, float dt)
+{
+    ocAssert(pEmitter != NULL);
+
+    const ocParticleEmitterDesc* pDesc = &pEmitter->desc;
+
+    float spawnCount = pEmitter->spawnAccumulator;
+    if (pEmitter->isEmitting) {
+        spawnCount += pDesc->spawnRate*dt;
+    }
+
+    ocUInt32 count = (ocUInt32)spawnCount;
+    pEmitter->spawnAccumulator = spawnCount - (float)count;
+
+    count += pEmitter->burstCount;
+    pEmitter->burstCount = 0;
+
+    count = ocMin(count, pDesc->maxParticles - pEmitter->particleCount);
+    if (count == 0) {
+        return;
+    }
+
+    // Particles are fired in a cone around the direction, which is built from a basis around it.
+    glm::vec3 direction = pEmitter->absoluteRotation * pDesc->direction;
+    glm::vec3 tangent   = glm::normalize(glm::cross(direction, (fabsf(direction.x) < 0.9f) ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0)));
+    glm::vec3 bitangent = glm::cross(direction, tangent);
+    float cosSpread = cosf(pDesc->spread);
+
+    for (ocUInt32 iParticle = pEmitter->particleCount; iParticle < pEmitter->particleCount + count; ++iParticle) {
+        float cosTheta = 1 - ocParticleRandom(&pEmitter->randomState)*(1 - cosSpread);
+        float sinTheta = sqrtf(ocMax(0.0f, 1 - cosTheta*cosTheta));
+        float phi      = ocParticleRandom(&pEmitter->randomState) * 6.28318531f;
+        float speed    = ocParticleRandomRange(&pEmitter->randomState, pDesc->speedMin, pDesc->speedMax);
+        glm::vec3 velocity = (tangent*(sinTheta*cosf(phi)) + bitangent*(sinTheta*sinf(phi)) + direction*cosTheta) * speed;
+
+        // A random point in the sphere, from a random direction and a radius that's weighted towards the surface by volume.
+        float z      = ocParticleRandomRange(&pEmitter->randomState, -1, 1);
+        float r      = sqrtf(ocMax(0.0f, 1 - z*z));
+        float theta  = ocParticleRandom(&pEmitter->randomState) * 6.28318531f;
+        float radius = pDesc->spawnRadius * cbrtf(ocParticleRandom(&pEmitter->randomState));
+        glm::vec3 position = pEmitter->absolutePosition + glm::vec3(r*cosf(theta), r*sinf(theta), z)*radius;
+
+        pEmitter->positions.pX[iParticle]  = position.x;
+        pEmitter->positions.pY[iParticle]  = position.y;
+        pEmitter->positions.pZ[iParticle]  = position.z;
+        pEmitter->velocities.pX[iParticle] = velocity.x;
+        pEmitter->velocities.pY[iParticle] = velocity.y;
+        pEmitter->velocities.pZ[iParticle] = velocity.z;
+        pEmitter->pAges[iParticle]         = 0;
+        pEmitter->pInvLifetimes[iParticle] = 1 / ocParticleRandomRange(&pEmitter->randomState, pDesc->lifetimeMin, pDesc->lifetimeMax);
+    }
+
+    pEmitter->particleCount += count;
+}
+
+// Removes the particles that died in the previous step by moving the last particle into their slot.
+OC_PRIVATE void ocParticleEmitterRemoveDead(ocParticleEmitter* pEmitter)
+{
+    ocAssert(pEmitter != NULL);
+
+    ocUInt32 iParticle = 0;
+    while (iParticle < pEmitter->particleCount) {
+        if (pEmitter->pAges[iParticle]*pEmitter->pInvLifetimes[iParticle] < 1) {
+            iParticle += 1;
+            continue;
+        }
+
+        ocUInt32 iLast = pEmitter->particleCount - 1;
+        pEmitter->positions.pX[iParticle]  = pEmitter->positions.pX[iLast];
+        pEmitter->positions.pY[iParticle]  = pEmitter->positions.pY[iLast];
+        pEmitter->positions.pZ[iParticle]  = pEmitter->positions.pZ[iLast];
+        pEmitter->velocities.pX[iParticle] = pEmitter->velocities.pX[iLast];
+        pEmitter->velocities.pY[iParticle] = pEmitter->velocities.pY[iLast];
+        pEmitter->velocities.pZ[iParticle] = pEmitter->velocities.pZ[iLast];
+        pEmitter->pAges[iParticle]         = pEmitter->pAges[iLast];
+        pEmitter->pInvLifetimes[iParticle] = pEmitter->pInvLifetimes[iLast];
+        pEmitter->particleCount -= 1;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Simulation
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Particles are integrated with semi-implicit Euler, with drag applied as a force against the velocity. Each particle is then written to
+// the instance array with it's colour and size sampled from the baked curves. The SIMD paths do the same operations in the same order as
+// the scalar path so that every path gives the same results. The scalar path is also used for the remainder.
+
+//// Integration ////
+
+OC_PRIVATE void ocParticleIntegrate_Scalar(ocParticleEmitter* pEmitter, float dt, ocUInt32 iBegin, ocUInt32 iEnd)
+{
+    float gx   = pEmitter->desc.gravity.x;
+    float gy   = pEmitter->desc.gravity.y;
+    float gz   = pEmitter->desc.gravity.z;
+    float drag = pEmitter->desc.drag;
+
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        float vx = pEmitter->velocities.pX[i] + (gx - pEmitter->velocities.pX[i]*drag)*dt;
+        float vy = pEmitter->velocities.pY[i] + (gy - pEmitter->velocities.pY[i]*drag)*dt;
+        float vz = pEmitter->velocities.pZ[i] + (gz - pEmitter->velocities.pZ[i]*drag)*dt;
+        pEmitter->velocities.pX[i] = vx;
+        pEmitter->velocities.pY[i] = vy;
+        pEmitter->velocities.pZ[i] = vz;
+        pEmitter->positions.pX[i]  = pEmitter->positions.pX[i] + vx*dt;
+        pEmitter->positions.pY[i]  = pEmitter->positions.pY[i] + vy*dt;
+        pEmitter->positions.pZ[i]  = pEmitter->positions.pZ[i] + vz*dt;
+        pEmitter->pAges[i]         = pEmitter->pAges[i] + dt;
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE void ocParticleIntegrate_SSE2(ocParticleEmitter* pEmitter, float dt, ocUInt32 iBegin, ocUInt32 iEnd)
+{
+    const __m128 gx   = _mm_set1_ps(pEmitter->desc.gravity.x);
+    const __m128 gy   = _mm_set1_ps(pEmitter->desc.gravity.y);
+    const __m128 gz   = _mm_set1_ps(pEmitter->desc.gravity.z);
+    const __m128 drag = _mm_set1_ps(pEmitter->desc.drag);
+    const __m128 dt4  = _mm_set1_ps(dt);
+
+    ocUInt32 i = iBegin;
+    for (; i + 4 <= iEnd; i += 4) {
+        __m128 vx = _mm_loadu_ps(pEmitter->velocities.pX + i);
+        __m128 vy = _mm_loadu_ps(pEmitter->velocities.pY + i);
+        __m128 vz = _mm_loadu_ps(pEmitter->velocities.pZ + i);
+        vx = _mm_add_ps(vx, _mm_mul_ps(_mm_sub_ps(gx, _mm_mul_ps(vx, drag)), dt4));
+        vy = _mm_add_ps(vy, _mm_mul_ps(_mm_sub_ps(gy, _mm_mul_ps(vy, drag)), dt4));
+        vz = _mm_add_ps(vz, _mm_mul_ps(_mm_sub_ps(gz, _mm_mul_ps(vz, drag)), dt4));
+        _mm_storeu_ps(pEmitter->velocities.pX + i, vx);
+        _mm_storeu_ps(pEmitter->velocities.pY + i, vy);
+        _mm_storeu_ps(pEmitter->velocities.pZ + i, vz);
+        _mm_storeu_ps(pEmitter->positions.pX + i, _mm_add_ps(_mm_loadu_ps(pEmitter->positions.pX + i), _mm_mul_ps(vx, dt4)));
+        _mm_storeu_ps(pEmitter->positions.pY + i, _mm_add_ps(_mm_loadu_ps(pEmitter->positions.pY + i), _mm_mul_ps(vy, dt4)));
+        _mm_storeu_ps(pEmitter->positions.pZ + i, _mm_add_ps(_mm_loadu_ps(pEmitter->positions.pZ + i), _mm_mul_ps(vz, dt4)));
+        _mm_storeu_ps(pEmitter->pAges + i, _mm_add_ps(_mm_loadu_ps(pEmitter->pAges + i), dt4));
+    }
+
+    ocParticleIntegrate_Scalar(pEmitter, dt, i, iEnd);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE void ocParticleIntegrate_AVX2(ocParticleEmitter* pEmitter, float dt, ocUInt32 iBegin, ocUInt32 iEnd)
+{
+    const __m256 gx   = _mm256_set1_ps(pEmitter->desc.gravity.x);
+    const __m256 gy   = _mm256_set1_ps(pEmitter->desc.gravity.y);
+    const __m256 gz   = _mm256_set1_ps(pEmitter->desc.gravity.z);
+    const __m256 drag = _mm256_set1_ps(pEmitter->desc.drag);
+    const __m256 dt8  = _mm256_set1_ps(dt);
+
+    ocUInt32 i = iBegin;
+    for (; i + 8 <= iEnd; i += 8) {
+        __m256 vx = _mm256_loadu_ps(pEmitter->velocities.pX + i);
+        __m256 vy = _mm256_loadu_ps(pEmitter->velocities.pY + i);
+        __m256 vz = _mm256_loadu_ps(pEmitter->velocities.pZ + i);
+        vx = _mm256_add_ps(vx, _mm256_mul_ps(_mm256_sub_ps(gx, _mm256_mul_ps(vx, drag)), dt8));
+        vy = _mm256_add_ps(vy, _mm256_mul_ps(_mm256_sub_ps(gy, _mm256_mul_ps(vy, drag)), dt8));
+        vz = _mm256_add_ps(vz, _mm256_mul_ps(_mm256_sub_ps(gz, _mm256_mul_ps(vz, drag)), dt8));
+        _mm256_storeu_ps(pEmitter->velocities.pX + i, vx);
+        _mm256_storeu_ps(pEmitter->velocities.pY + i, vy);
+        _mm256_storeu_ps(pEmitter->velocities.pZ + i, vz);
+        _mm256_storeu_ps(pEmitter->positions.pX + i, _mm256_add_ps(_mm256_loadu_ps(pEmitter->positions.pX + i), _mm256_mul_ps(vx, dt8)));
+        _mm256_storeu_ps(pEmitter->positions.pY + i, _mm256_add_ps(_mm256_loadu_ps(pEmitter->positions.pY + i), _mm256_mul_ps(vy, dt8)));
+        _mm256_storeu_ps(pEmitter->positions.pZ + i, _mm256_add_ps(_mm256_loadu_ps(pEmitter->positions.pZ + i), _mm256_mul_ps(vz, dt8)));
+        _mm256_storeu_ps(pEmitter->pAges + i, _mm256_add_ps(_mm256_loadu_ps(pEmitter->pAges + i), dt8));
+    }
+
+    ocParticleIntegrate_Scalar(pEmitter, dt, i, iEnd);
+}
+#endif
+
+OC_PRIVATE void ocParticleIntegrate(ocParticleEmitter* pEmitter, float dt, ocUInt32 iBegin, ocUInt32 iEnd)
+{
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocParticleIntegrate_AVX2(pEmitter, dt, iBegin, iEnd);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocParticleIntegrate_SSE2(pEmitter, dt, iBegin, iEnd);
+        return;
+    }
+#endif
+
+    ocParticleIntegrate_Scalar(pEmitter, dt, iBegin, iEnd);
+}
+
+
+//// Instances ////
+
+// The curves are sampled at the normalized age of each particle. The segment index is clamped so that the last sample is reached at
+// exactly 1 rather than reading past the end of the table. Particles that have reached the end of their life are given a size of 0 so
+// they disappear straight away rather than on the next step, when they're removed.
+
+OC_PRIVATE void ocParticleWriteInstances_Scalar(const ocParticleEmitter* pEmitter, ocUInt32 iBegin, ocUInt32 iEnd, ocParticleInstance* pInstances)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        float age = pEmitter->pAges[i]*pEmitter->pInvLifetimes[i];
+        float t = ocMin(age, 1.0f) * OC_PARTICLE_CURVE_RESOLUTION;
+        float segment = ocMin((float)(ocInt32)t, (float)(OC_PARTICLE_CURVE_RESOLUTION-1));
+        float frac = t - segment;
+        ocInt32 iSample = (ocInt32)segment;
+
+        ocParticleInstance* pInstance = &pInstances[i];
+        pInstance->position[0] = pEmitter->positions.pX[i];
+        pInstance->position[1] = pEmitter->positions.pY[i];
+        pInstance->position[2] = pEmitter->positions.pZ[i];
+        pInstance->size = pEmitter->sizeTable[iSample] + (pEmitter->sizeTable[iSample+1] - pEmitter->sizeTable[iSample])*frac;
+        if (age >= 1) {
+            pInstance->size = 0;
+        }
+
+        for (ocUInt32 iComponent = 0; iComponent < 4; ++iComponent) {
+            const float* pTable = pEmitter->colorTable[iComponent];
+            pInstance->color[iComponent] = pTable[iSample] + (pTable[iSample+1] - pTable[iSample])*frac;
+        }
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_INLINE __m128 ocParticleSampleTable_SSE2(const float* pTable, const ocInt32* pSamples, __m128 frac)
+{
+    __m128 a = _mm_set_ps(pTable[pSamples[3]],   pTable[pSamples[2]],   pTable[pSamples[1]],   pTable[pSamples[0]]);
+    __m128 b = _mm_set_ps(pTable[pSamples[3]+1], pTable[pSamples[2]+1], pTable[pSamples[1]+1], pTable[pSamples[0]+1]);
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), frac));
+}
+
+// Transposes 4 particles from one register per attribute into their instances.
+OC_INLINE void ocParticleStoreInstances4(ocParticleInstance* pInstances, __m128 x, __m128 y, __m128 z, __m128 size, __m128 r, __m128 g, __m128 b, __m128 a)
+{
+    _MM_TRANSPOSE4_PS(x, y, z, size);
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+    _mm_storeu_ps(pInstances[0].position, x);
+    _mm_storeu_ps(pInstances[0].color,    r);
+    _mm_storeu_ps(pInstances[1].position, y);
+    _mm_storeu_ps(pInstances[1].color,    g);
+    _mm_storeu_ps(pInstances[2].position, z);
+    _mm_storeu_ps(pInstances[2].color,    b);
+    _mm_storeu_ps(pInstances[3].position, size);
+    _mm_storeu_ps(pInstances[3].color,    a);
+}
+
+OC_PRIVATE void ocParticleWriteInstances_SSE2(const ocParticleEmitter* pEmitter, ocUInt32 iBegin, ocUInt32 iEnd, ocParticleInstance* pInstances)
+{
+    const __m128 one        = _mm_set1_ps(1);
+    const __m128 resolution = _mm_set1_ps(OC_PARTICLE_CURVE_RESOLUTION);
+    const __m128 maxSegment = _mm_set1_ps(OC_PARTICLE_CURVE_RESOLUTION-1);
+
+    ocUInt32 i = iBegin;
+    for (; i + 4 <= iEnd; i += 4) {
+        __m128 age = _mm_mul_ps(_mm_loadu_ps(pEmitter->pAges + i), _mm_loadu_ps(pEmitter->pInvLifetimes + i));
+        __m128 t = _mm_mul_ps(_mm_min_ps(age, one), resolution);
+        __m128 segment = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(t)), maxSegment);
+        __m128 frac = _mm_sub_ps(t, segment);
+
+        ocInt32 pSamples[4];
+        _mm_storeu_si128((__m128i*)pSamples, _mm_cvttps_epi32(segment));
+
+        __m128 size = ocParticleSampleTable_SSE2(pEmitter->sizeTable, pSamples, frac);
+        size = _mm_andnot_ps(_mm_cmpge_ps(age, one), size);
+
+        ocParticleStoreInstances4(pInstances + i,
+            _mm_loadu_ps(pEmitter->positions.pX + i),
+            _mm_loadu_ps(pEmitter->positions.pY + i),
+            _mm_loadu_ps(pEmitter->positions.pZ + i),
+            size,
+            ocParticleSampleTable_SSE2(pEmitter->colorTable[0], pSamples, frac),
+            ocParticleSampleTable_SSE2(pEmitter->colorTable[1], pSamples, frac),
+            ocParticleSampleTable_SSE2(pEmitter->colorTable[2], pSamples, frac),
+            ocParticleSampleTable_SSE2(pEmitter->colorTable[3], pSamples, frac));
+    }
+
+    ocParticleWriteInstances_Scalar(pEmitter, i, iEnd, pInstances);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_INLINE __m256 ocParticleSampleTable_AVX2(const float* pTable, __m256i samples, __m256 frac)
+{
+    __m256 a = _mm256_i32gather_ps(pTable,     samples, 4);
+    __m256 b = _mm256_i32gather_ps(pTable + 1, samples, 4);
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), frac));
+}
+
+OC_AVX2_FUNCTION OC_PRIVATE void ocParticleWriteInstances_AVX2(const ocParticleEmitter* pEmitter, ocUInt32 iBegin, ocUInt32 iEnd, ocParticleInstance* pInstances)
+{
+    const __m256 one        = _mm256_set1_ps(1);
+    const __m256 resolution = _mm256_set1_ps(OC_PARTICLE_CURVE_RESOLUTION);
+    const __m256 maxSegment = _mm256_set1_ps(OC_PARTICLE_CURVE_RESOLUTION-1);
+
+    ocUInt32 i = iBegin;
+    for (; i + 8 <= iEnd; i += 8) {
+        __m256 age = _mm256_mul_ps(_mm256_loadu_ps(pEmitter->pAges + i), _mm256_loadu_ps(pEmitter->pInvLifetimes + i));
+        __m256 t = _mm256_mul_ps(_mm256_min_ps(age, one), resolution);
+        __m256 segment = _mm256_min_ps(_mm256_cvtepi32_ps(_mm256_cvttps_epi32(t)), maxSegment);
+        __m256 frac = _mm256_sub_ps(t, segment);
+        __m256i samples = _mm256_cvttps_epi32(segment);
+
+        __m256 x = _mm256_loadu_ps(pEmitter->positions.pX + i);
+        __m256 y = _mm256_loadu_ps(pEmitter->positions.pY + i);
+        __m256 z = _mm256_loadu_ps(pEmitter->positions.pZ + i);
+        __m256 size = ocParticleSampleTable_AVX2(pEmitter->sizeTable, samples, frac);
+        size = _mm256_andnot_ps(_mm256_cmp_ps(age, one, _CMP_GE_OQ), size);
+        __m256 r = ocParticleSampleTable_AVX2(pEmitter->colorTable[0], samples, frac);
+        __m256 g = ocParticleSampleTable_AVX2(pEmitter->colorTable[1], samples, frac);
+        __m256 b = ocParticleSampleTable_AVX2(pEmitter->colorTable[2], samples, frac);
+        __m256 a = ocParticleSampleTable_AVX2(pEmitter->colorTable[3], samples, frac);
+
+        ocParticleStoreInstances4(pInstances + i + 0,
+            _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z), _mm256_castps256_ps128(size),
+            _mm256_castps256_ps128(r), _mm256_castps256_ps128(g), _mm256_castps256_ps128(b), _mm256_castps256_ps128(a));
+        ocParticleStoreInstances4(pInstances + i + 4,
+            _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(size, 1),
+            _mm256_extractf128_ps(r, 1), _mm256_extractf128_ps(g, 1), _mm256_extractf128_ps(b, 1), _mm256_extractf128_ps(a, 1));
+    }
+
+    ocParticleWriteInstances_Scalar(pEmitter, i, iEnd, pInstances);
+}
+#endif
+
+OC_PRIVATE void ocParticleWriteInstances(const ocParticleEmitter* pEmitter, ocUInt32 iBegin, ocUInt32 iEnd, ocParticleInstance* pInstances)
+{
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocParticleWriteInstances_AVX2(pEmitter, iBegin, iEnd, pInstances);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocParticleWriteInstances_SSE2(pEmitter, iBegin, iEnd, pInstances);
+        return;
+    }
+#endif
+
+    ocParticleWriteInstances_Scalar(pEmitter, iBegin, iEnd, pInstances);
+}
+
+// Simulates a range of the particles of an emitter and writes them to their instances. pInstances is the whole instance array.
+OC_PRIVATE void ocParticleEmitterSimulate(ocParticleEmitter* pEmitter, float dt, ocUInt32 iBegin, ocUInt32 iEnd, ocParticleInstance* pInstances)
+{
+    ocAssert(pEmitter != NULL);
+
+    ocParticleIntegrate(pEmitter, dt, iBegin, iEnd);
+    ocParticleWriteInstances(pEmitter, iBegin, iEnd, pInstances + pEmitter->instanceOffset);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Emitters
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocParticleEmitterDesc ocParticleEmitterDescInit()
+{
+    ocParticleEmitterDesc desc;
+    ocZeroObject(&desc);
+    desc.maxParticles = 1024;
+    desc.spawnRate    = 64;
+    desc.lifetimeMin  = 1;
+    desc.lifetimeMax  = 2;
+    desc.direction    = glm::vec3(0, 1, 0);
+    desc.spread       = 0.25f;
+    desc.speedMin     = 1;
+    desc.speedMax     = 2;
+    desc.spawnRadius  = 0;
+    desc.gravity      = glm::vec3(0, -1, 0);
+    desc.drag         = 0;
+    desc.colorCurve   = ocParticleCurveInit(glm::vec4(1, 1, 1, 1));
+    desc.sizeCurve    = ocParticleCurveInit(glm::vec4(0.1f, 0, 0, 0));
+
+    return desc;
+}
+
+OC_PRIVATE ocResult ocParticleEmitterInit(const ocParticleEmitterDesc* pDesc, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation, ocUInt32 randomSeed, ocParticleEmitter* pEmitter)
+{
+    ocAssert(pEmitter != NULL);
+
+    ocZeroObject(pEmitter);
+
+    if (pDesc == NULL || pDesc->maxParticles == 0 || pDesc->lifetimeMin <= 0 || pDesc->lifetimeMax < pDesc->lifetimeMin ||
+        !ocParticleCurveIsValid(&pDesc->colorCurve) || !ocParticleCurveIsValid(&pDesc->sizeCurve)) {
+        return OC_INVALID_ARGS;
+    }
+
+    // The pool is a single allocation of 8 arrays: position, velocity, age and inverse lifetime.
+    ocUInt32 stride = ocAlign(pDesc->maxParticles, 8);
+    pEmitter->pPayload = (float*)ocCalloc((size_t)stride * 8, sizeof(float));
+    if (pEmitter->pPayload == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pEmitter->desc             = *pDesc;
+    pEmitter->absolutePosition = absolutePosition;
+    pEmitter->absoluteRotation = absoluteRotation;
+    pEmitter->isEmitting       = OC_TRUE;
+    pEmitter->randomState      = (randomSeed != 0) ? randomSeed : 1;     // <-- xorshift gets stuck on 0.
+    pEmitter->positions.pX     = pEmitter->pPayload + (size_t)stride*0;
+    pEmitter->positions.pY     = pEmitter->pPayload + (size_t)stride*1;
+    pEmitter->positions.pZ     = pEmitter->pPayload + (size_t)stride*2;
+    pEmitter->velocities.pX    = pEmitter->pPayload + (size_t)stride*3;
+    pEmitter->velocities.pY    = pEmitter->pPayload + (size_t)stride*4;
+    pEmitter->velocities.pZ    = pEmitter->pPayload + (size_t)stride*5;
+    pEmitter->pAges            = pEmitter->pPayload + (size_t)stride*6;
+    pEmitter->pInvLifetimes    = pEmitter->pPayload + (size_t)stride*7;
+
+    ocParticleCurveBake(&pDesc->colorCurve, 4, &pEmitter->colorTable[0][0], OC_PARTICLE_CURVE_RESOLUTION+1);
+    ocParticleCurveBake(&pDesc->sizeCurve,  1, &pEmitter->sizeTable[0],     OC_PARTICLE_CURVE_RESOLUTION+1);
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocParticleEmitterUninit(ocParticleEmitter* pEmitter)
+{
+    ocAssert(pEmitter != NULL);
+    ocFree(pEmitter->pPayload);
+}
+
+void ocParticleEmitterSetTransform(ocParticleEmitter* pEmitter, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation)
+{
+    if (pEmitter == NULL) {
+        return;
+    }
+
+    pEmitter->absolutePosition = absolutePosition;
+    pEmitter->absoluteRotation = absoluteRotation;
+}
+
+void ocParticleEmitterSetEmitting(ocParticleEmitter* pEmitter, ocBool32 isEmitting)
+{
+    if (pEmitter == NULL) {
+        return;
+    }
+
+    pEmitter->isEmitting = isEmitting;
+    if (!isEmitting) {
+        pEmitter->spawnAccumulator = 0;
+    }
+}
+
+void ocParticleEmitterBurst(ocParticleEmitter* pEmitter, ocUInt32 count)
+{
+    if (pEmitter == NULL) {
+        return;
+    }
+
+    pEmitter->burstCount = ocMin(pEmitter->burstCount + ocMin(count, pEmitter->desc.maxParticles), pEmitter->desc.maxParticles);
+}
+
+ocUInt32 ocParticleEmitterGetParticleCount(const ocParticleEmitter* pEmitter)
+{
+    if (pEmitter == NULL) {
+        return 0;
+    }
+
+    return pEmitter->particleCount;
+}
@@ -0,0 +1,108 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// A particle emitter spawns particles at a steady rate or in bursts and simulates them until they die. Particles are simulated in world
+// space, so moving the emitter only affects where new particles are spawned.
+//
+// The particles of each emitter live in a pool that's stored as a structure of arrays: the position, velocity, age and inverse lifetime
+// of each particle each have their own array so that 4 or 8 particles can be integrated at a time with SIMD. Dead particles are removed
+// by moving the last particle into their slot, so the live particles are always packed at the start of the pool.
+//
+// The colour and size of a particle are curves over it's normalized age, which goes from 0 when it's spawned to 1 when it dies. Curves
+// are baked into tables of OC_PARTICLE_CURVE_RESOLUTION segments when the emitter is created so that they can be sampled with a lookup and
+// a lerp instead of a search through the keys.
+
+#define OC_PARTICLE_CURVE_MAX_KEYS      8
+#define OC_PARTICLE_CURVE_RESOLUTION    32      // <-- The number of segments a curve is baked into.
+
+struct ocParticleWorld;
+
+struct ocParticleCurveKey
+{
+    float time;                     // <-- The normalized age of the key, between 0 and 1.
+    glm::vec4 value;
+};
+
+// A piecewise linear curve. Before the first key and after the last key the curve holds the value of that key. Keys must be added in
+// order of time.
+struct ocParticleCurve
+{
+    ocUInt32 keyCount;
+    ocParticleCurveKey keys[OC_PARTICLE_CURVE_MAX_KEYS];
+};
+
+struct ocParticleEmitterDesc
+{
+    ocUInt32 maxParticles;
+    float spawnRate;                // <-- In particles per second.
+    float lifetimeMin;              // <-- In seconds. The lifetime of each particle is random between the minimum and the maximum.
+    float lifetimeMax;
+    glm::vec3 direction;            // <-- The direction particles are fired in, relative to the emitter. Must be unit length.
+    float spread;                   // <-- The half angle of the cone around the direction that particles are fired in, in radians.
+    float speedMin;
+    float speedMax;
+    float spawnRadius;              // <-- Particles are spawned at a random point within a sphere of this radius around the emitter.
+    glm::vec3 gravity;              // <-- An acceleration applied to every particle, in world space.
+    float drag;                     // <-- The fraction of it's velocity a particle loses each second.
+    ocParticleCurve colorCurve;     // <-- RGBA. Not premultiplied.
+    ocParticleCurve sizeCurve;      // <-- Only X is used. This is the width of the particle in world units.
+};
+
+// The data of each particle that's drawn. The instances of every emitter are packed together into a single array which is used as an
+// instance rate vertex buffer.
+struct ocParticleInstance
+{
+    float position[3];
+    float size;                     // <-- 0 for particles that have died during the step.
+    float color[4];
+};
+
+struct ocParticleEmitter
+{
+    ocParticleWorld* pWorld;
+    ocParticleEmitterDesc desc;
+    glm::vec3 absolutePosition;
+    glm::quat absoluteRotation;
+    ocBool32 isEmitting;
+    float spawnAccumulator;         // <-- The fraction of a particle that's carried over to the next step.
+    ocUInt32 burstCount;            // <-- The number of particles to spawn on the next step on top of the spawn rate.
+    ocUInt32 randomState;
+    ocUInt32 instanceOffset;        // <-- The index of the first instance of this emitter in the instance array.
+
+    // The pool. Only the first particleCount particles are alive.
+    ocUInt32 particleCount;
+    ocVec3Array positions;
+    ocVec3Array velocities;
+    float* pAges;
+    float* pInvLifetimes;
+
+    // The curves, baked into a table for each component.
+    float colorTable[4][OC_PARTICLE_CURVE_RESOLUTION+1];
+    float sizeTable[OC_PARTICLE_CURVE_RESOLUTION+1];
+
+    // Dynamically allocated data as a single allocation. This is the storage for the pool.
+    float* pPayload;
+
+    void* pUserData;
+};
+
+// Creates a curve with a single key, which makes it hold the same value over the whole life of a particle.
+ocParticleCurve ocParticleCurveInit(const glm::vec4 &value);
+
+// Adds a key to a curve. time must not be less than the time of the previous key.
+ocResult ocParticleCurveAddKey(ocParticleCurve* pCurve, float time, const glm::vec4 &value);
+
+// Creates an emitter description with sensible defaults: a slow upwards fountain of small white particles.
+ocParticleEmitterDesc ocParticleEmitterDescInit();
+
+
+// Moves an emitter. This only affects particles spawned after this is called.
+void ocParticleEmitterSetTransform(ocParticleEmitter* pEmitter, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation);
+
+// Starts or stops the steady spawning of particles. Particles that are already alive are not affected, and nor are bursts.
+void ocParticleEmitterSetEmitting(ocParticleEmitter* pEmitter, ocBool32 isEmitting);
+
+// Spawns a number of particles at once on the next step. This is limited by the space left in the pool.
+void ocParticleEmitterBurst(ocParticleEmitter* pEmitter, ocUInt32 count);
+
+// Retrieves the number of particles that are alive.
+ocUInt32 ocParticleEmitterGetParticleCount(const ocParticleEmitter* pEmitter);
@@ -0,0 +1,222 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+OC_PRIVATE void ocParticleWorldJobProc(void* pUserData)
+{
+    ocParticleJob* pJob = (ocParticleJob*)pUserData;
+    ocAssert(pJob != NULL);
+
+    if (pJob->pEmitter != NULL) {
+        ocParticleEmitterSimulate(pJob->pEmitter, pJob->dt, pJob->begin, pJob->end, pJob->pInstances);
+    } else {
+        for (ocUInt32 iEmitter = pJob->begin; iEmitter < pJob->end; ++iEmitter) {
+            ocParticleEmitter* pEmitter = pJob->pWorld->emitters.pItems[iEmitter];
+            ocParticleEmitterRemoveDead(pEmitter);
+            ocParticleEmitterSpawn(pEmitter, pJob->dt);
+        }
+    }
+}
+
+// Runs every job in the job list, and waits for them to finish.
+OC_PRIVATE void ocParticleWorldRunJobs(ocParticleWorld* pWorld)
+{
+    ocUInt32 jobCount = (ocUInt32)pWorld->jobs.count;
+
+    if (pWorld->pJobQueue != NULL && jobCount > 1) {
+        ocUInt32 counter = 0;
+        for (ocUInt32 iJob = 0; iJob < jobCount; ++iJob) {
+            if (ocJobQueueSubmit(pWorld->pJobQueue, ocParticleWorldJobProc, &pWorld->jobs.pItems[iJob], &counter) != OC_SUCCESS) {
+                ocParticleWorldJobProc(&pWorld->jobs.pItems[iJob]);
+            }
+        }
+
+        ocJobQueueWaitForCounter(pWorld->pJobQueue, &counter);
+    } else {
+        for (ocUInt32 iJob = 0; iJob < jobCount; ++iJob) {
+            ocParticleWorldJobProc(&pWorld->jobs.pItems[iJob]);
+        }
+    }
+}
+
+ocResult ocParticleWorldInit(ocJobQueue* pJobQueue, ocParticleWorld* pWorld)
+{
+    if (pWorld == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pWorld);
+
+    pWorld->pJobQueue  = pJobQueue;
+    pWorld->randomSeed = 0x9E3779B9;
+    ocStackInit(&pWorld->emitters);
+    ocStackInit(&pWorld->freeInstanceRanges);
+    ocStackInit(&pWorld->jobs);
+
+    return OC_SUCCESS;
+}
+
+void ocParticleWorldUninit(ocParticleWorld* pWorld)
+{
+    if (pWorld == NULL) {
+        return;
+    }
+
+    for (size_t iEmitter = 0; iEmitter < pWorld->emitters.count; ++iEmitter) {
+        ocParticleEmitterUninit(pWorld->emitters.pItems[iEmitter]);
+        ocFree(pWorld->emitters.pItems[iEmitter]);
+    }
+
+    ocStackUninit(&pWorld->emitters);
+    ocStackUninit(&pWorld->freeInstanceRanges);
+    ocStackUninit(&pWorld->jobs);
+}
+
+// Finds room for the instances of an emitter, reusing the first free range that's big enough.
+OC_PRIVATE ocUInt32 ocParticleWorldAllocateInstances(ocParticleWorld* pWorld, ocUInt32 count)
+{
+    for (size_t iRange = 0; iRange < pWorld->freeInstanceRanges.count; ++iRange) {
+        ocParticleInstanceRange* pRange = &pWorld->freeInstanceRanges.pItems[iRange];
+        if (pRange->count >= count) {
+            ocUInt32 offset = pRange->offset;
+            pRange->offset += count;
+            pRange->count  -= count;
+            if (pRange->count == 0) {
+                *pRange = pWorld->freeInstanceRanges.pItems[pWorld->freeInstanceRanges.count-1];
+                ocStackPop(&pWorld->freeInstanceRanges);
+            }
+
+            return offset;
+        }
+    }
+
+    ocUInt32 offset = pWorld->instanceCount;
+    pWorld->instanceCount += count;
+    return offset;
+}
+
+ocResult ocParticleWorldCreateEmitter(ocParticleWorld* pWorld, const ocParticleEmitterDesc* pDesc, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation, ocParticleEmitter** ppEmitter)
+{
+    if (ppEmitter == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppEmitter = NULL;
+
+    if (pWorld == NULL || pDesc == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocParticleEmitter* pEmitter = ocMallocObject(ocParticleEmitter);
+    if (pEmitter == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pWorld->randomSeed += 0x9E3779B9;
+    ocResult result = ocParticleEmitterInit(pDesc, absolutePosition, absoluteRotation, pWorld->randomSeed, pEmitter);
+    if (result != OC_SUCCESS) {
+        ocFree(pEmitter);
+        return result;
+    }
+
+    result = ocStackPush(&pWorld->emitters, pEmitter);
+    if (result != OC_SUCCESS) {
+        ocParticleEmitterUninit(pEmitter);
+        ocFree(pEmitter);
+        return result;
+    }
+
+    pEmitter->pWorld         = pWorld;
+    pEmitter->instanceOffset = ocParticleWorldAllocateInstances(pWorld, pDesc->maxParticles);
+
+    *ppEmitter = pEmitter;
+    return OC_SUCCESS;
+}
+
+void ocParticleWorldDeleteEmitter(ocParticleWorld* pWorld, ocParticleEmitter* pEmitter)
+{
+    if (pWorld == NULL || pEmitter == NULL) {
+        return;
+    }
+
+    ocAssert(pEmitter->pWorld == pWorld);
+
+    for (size_t iEmitter = 0; iEmitter < pWorld->emitters.count; ++iEmitter) {
+        if (pWorld->emitters.pItems[iEmitter] == pEmitter) {
+            pWorld->emitters.pItems[iEmitter] = pWorld->emitters.pItems[pWorld->emitters.count-1];
+            ocStackPop(&pWorld->emitters);
+            break;
+        }
+    }
+
+    ocParticleInstanceRange range;
+    range.offset = pEmitter->instanceOffset;
+    range.count  = pEmitter->desc.maxParticles;
+    ocStackPush(&pWorld->freeInstanceRanges, range);    // <-- If this fails the range is just never reused.
+
+    ocParticleEmitterUninit(pEmitter);
+    ocFree(pEmitter);
+}
+
+ocUInt32 ocParticleWorldGetInstanceCount(const ocParticleWorld* pWorld)
+{
+    if (pWorld == NULL) {
+        return 0;
+    }
+
+    return pWorld->instanceCount;
+}
+
+void ocParticleWorldStep(ocParticleWorld* pWorld, float dt, ocParticleInstance* pInstances)
+{
+    if (pWorld == NULL || pInstances == NULL) {
+        return;
+    }
+
+    ocUInt32 emitterCount = (ocUInt32)pWorld->emitters.count;
+    if (emitterCount == 0) {
+        return;
+    }
+
+    // Spawning.
+    ocUInt32 jobCount = (emitterCount + OC_PARTICLE_EMITTER_BATCH_SIZE - 1) / OC_PARTICLE_EMITTER_BATCH_SIZE;
+    if (ocStackResize(&pWorld->jobs, jobCount) != OC_SUCCESS) {
+        return;
+    }
+
+    for (ocUInt32 iJob = 0; iJob < jobCount; ++iJob) {
+        ocParticleJob* pJob = &pWorld->jobs.pItems[iJob];
+        pJob->pWorld     = pWorld;
+        pJob->pEmitter   = NULL;
+        pJob->begin      = iJob * OC_PARTICLE_EMITTER_BATCH_SIZE;
+        pJob->end        = ocMin(pJob->begin + OC_PARTICLE_EMITTER_BATCH_SIZE, emitterCount);
+        pJob->dt         = dt;
+        pJob->pInstances = pInstances;
+    }
+
+    ocParticleWorldRunJobs(pWorld);
+
+    // Simulation. The particle counts are only known once spawning is done.
+    jobCount = 0;
+    for (ocUInt32 iEmitter = 0; iEmitter < emitterCount; ++iEmitter) {
+        jobCount += (pWorld->emitters.pItems[iEmitter]->particleCount + OC_PARTICLE_CHUNK_SIZE - 1) / OC_PARTICLE_CHUNK_SIZE;
+    }
+
+    if (ocStackResize(&pWorld->jobs, jobCount) != OC_SUCCESS) {
+        return;
+    }
+
+    ocUInt32 iJob = 0;
+    for (ocUInt32 iEmitter = 0; iEmitter < emitterCount; ++iEmitter) {
+        ocParticleEmitter* pEmitter = pWorld->emitters.pItems[iEmitter];
+        for (ocUInt32 iParticle = 0; iParticle < pEmitter->particleCount; iParticle += OC_PARTICLE_CHUNK_SIZE) {
+            ocParticleJob* pJob = &pWorld->jobs.pItems[iJob++];
+            pJob->pWorld     = pWorld;
+            pJob->pEmitter   = pEmitter;
+            pJob->begin      = iParticle;
+            pJob->end        = ocMin(iParticle + OC_PARTICLE_CHUNK_SIZE, pEmitter->particleCount);
+            pJob->dt         = dt;
+            pJob->pInstances = pInstances;
+        }
+    }
+
+    ocParticleWorldRunJobs(pWorld);
+}
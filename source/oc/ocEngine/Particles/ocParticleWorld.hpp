@@ -0,0 +1,65 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// The particle world simulates every particle emitter. A step goes through two stages:
+//   1) For each emitter, the particles that died in the previous step are removed and new particles are spawned. This is serial within
+//      an emitter, so emitters are split into batches of OC_PARTICLE_EMITTER_BATCH_SIZE which are run in parallel on the job queue.
+//   2) Every particle is integrated and written to the instance array. Particles don't depend on each other, so the particles of every
+//      emitter are split into chunks of OC_PARTICLE_CHUNK_SIZE which are run in parallel on the job queue. This is where nearly all of
+//      the time goes, and a single emitter with a lot of particles is spread over every thread.
+//
+// The instances of every emitter are packed together into a single array of ocParticleWorldGetInstanceCount() instances, with each
+// emitter at it's instanceOffset and room for it's maximum number of particles. This array is provided by the caller of
+// ocParticleWorldStep() so that it can be written straight to a buffer that's visible to the GPU and drawn with one instanced draw per
+// emitter. The instances are only written, never read.
+
+#define OC_PARTICLE_CHUNK_SIZE          16384   // <-- The number of particles handled by each simulation job. Must be a multiple of 8.
+#define OC_PARTICLE_EMITTER_BATCH_SIZE  16      // <-- The number of emitters handled by each spawning job.
+
+struct ocParticleInstanceRange
+{
+    ocUInt32 offset;
+    ocUInt32 count;
+};
+
+struct ocParticleJob
+{
+    ocParticleWorld* pWorld;
+    ocParticleEmitter* pEmitter;    // <-- NULL for spawning jobs, in which case begin and end are emitter indices.
+    ocUInt32 begin;
+    ocUInt32 end;
+    float dt;
+    ocParticleInstance* pInstances;
+};
+
+struct ocParticleWorld
+{
+    ocJobQueue* pJobQueue;          // <-- Can be NULL, in which case everything is run on the calling thread.
+    ocStack<ocParticleEmitter*> emitters;
+    ocUInt32 randomSeed;            // <-- Used to give each emitter a different random sequence.
+
+    // The instances of deleted emitters are reused by new emitters that fit. Instances are never moved so the count only grows.
+    ocUInt32 instanceCount;
+    ocStack<ocParticleInstanceRange> freeInstanceRanges;
+    ocStack<ocParticleJob> jobs;
+};
+
+// Initializes a particle world. pJobQueue is optional.
+ocResult ocParticleWorldInit(ocJobQueue* pJobQueue, ocParticleWorld* pWorld);
+
+// Uninitializes a particle world. Any emitters that have not been deleted are deleted.
+void ocParticleWorldUninit(ocParticleWorld* pWorld);
+
+// Creates a particle emitter. The emitter starts out emitting, with no particles.
+ocResult ocParticleWorldCreateEmitter(ocParticleWorld* pWorld, const ocParticleEmitterDesc* pDesc, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation, ocParticleEmitter** ppEmitter);
+
+// Deletes a particle emitter. It's instances are reused by later emitters.
+void ocParticleWorldDeleteEmitter(ocParticleWorld* pWorld, ocParticleEmitter* pEmitter);
+
+// Retrieves the number of instances needed for the particles of every emitter.
+ocUInt32 ocParticleWorldGetInstanceCount(const ocParticleWorld* pWorld);
+
+// Advances every emitter by dt seconds and writes their particles to pInstances, which must have room for
+// ocParticleWorldGetInstanceCount() instances. Only the first particleCount instances of each emitter are written.
+//
+// This must not be called at the same time as anything that creates, deletes or changes an emitter.
+void ocParticleWorldStep(ocParticleWorld* pWorld, float dt, ocParticleInstance* pInstances);
@@ -0,0 +1,4 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#include "ocParticleEmitter.cpp"
+#include "ocParticleWorld.cpp"
\ No newline at end of file
@@ -0,0 +1,574 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_BVH_BIN_COUNT            16
+#define OC_BVH_STACK_SIZE           (OC_BVH_MAX_DEPTH*3 + 4)    // <-- Each level replaces the node being visited with up to 4 children.
+#define OC_BVH_MIN_DIRECTION        1e-20f                      // <-- Ray directions are clamped away from zero so their inverse is finite.
+
+ocResult ocBVHInit(ocBVH* pBVH)
+{
+    if (pBVH == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pBVH);
+
+    ocStackInit(&pBVH->nodes);
+    ocStackInit(&pBVH->items);
+    ocStackInit(&pBVH->order);
+    ocStackInit(&pBVH->centers);
+
+    return OC_SUCCESS;
+}
+
+void ocBVHUninit(ocBVH* pBVH)
+{
+    if (pBVH == NULL) return;
+
+    ocStackUninit(&pBVH->centers);
+    ocStackUninit(&pBVH->order);
+    ocStackUninit(&pBVH->items);
+    ocStackUninit(&pBVH->nodes);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Building
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct ocBVHBuilder
+{
+    ocBVH* pBVH;
+    const glm::vec3* pBoundsMin;
+    const glm::vec3* pBoundsMax;
+    const glm::vec3* pCenters;
+    ocUInt32* pOrder;
+};
+
+// A range of order that will become a child of the node being built.
+struct ocBVHBuildRange
+{
+    ocUInt32 begin;
+    ocUInt32 end;
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+};
+
+struct ocBVHCenterLess
+{
+    const glm::vec3* pCenters;
+    int axis;
+
+    bool operator()(ocUInt32 a, ocUInt32 b) const
+    {
+        return pCenters[a][axis] < pCenters[b][axis];
+    }
+};
+
+OC_INLINE float ocBVHHalfArea(const glm::vec3 &aabbMin, const glm::vec3 &aabbMax)
+{
+    glm::vec3 size = glm::max(aabbMax - aabbMin, glm::vec3(0, 0, 0));
+    return size.x*size.y + size.y*size.z + size.z*size.x;
+}
+
+OC_PRIVATE void ocBVHBuilderGetBounds(const ocBVHBuilder* pBuilder, ocBVHBuildRange* pRange)
+{
+    pRange->aabbMin = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    pRange->aabbMax = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (ocUInt32 i = pRange->begin; i < pRange->end; ++i) {
+        ocUInt32 item = pBuilder->pOrder[i];
+        pRange->aabbMin = glm::min(pRange->aabbMin, pBuilder->pBoundsMin[item]);
+        pRange->aabbMax = glm::max(pRange->aabbMax, pBuilder->pBoundsMax[item]);
+    }
+}
+
+// Splits a range in two, returning the index of the first item of the second half. The split is chosen with the surface area heuristic
+// from the centers of the items, which are put into bins along the axis where they're most spread out. Deep in the tree the split is made
+// at the median instead, which guarantees the depth never goes past OC_BVH_MAX_DEPTH.
+OC_PRIVATE ocUInt32 ocBVHBuilderSplit(const ocBVHBuilder* pBuilder, const ocBVHBuildRange* pRange, ocUInt32 depth)
+{
+    const glm::vec3* pCenters = pBuilder->pCenters;
+    ocUInt32* pOrder = pBuilder->pOrder;
+    ocUInt32 begin = pRange->begin;
+    ocUInt32 end   = pRange->end;
+    ocUInt32 middle = begin + (end - begin)/2;
+
+    glm::vec3 centerMin = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    glm::vec3 centerMax = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (ocUInt32 i = begin; i < end; ++i) {
+        centerMin = glm::min(centerMin, pCenters[pOrder[i]]);
+        centerMax = glm::max(centerMax, pCenters[pOrder[i]]);
+    }
+
+    glm::vec3 centerSize = centerMax - centerMin;
+    int axis = (centerSize.x > centerSize.y) ? ((centerSize.x > centerSize.z) ? 0 : 2) : ((centerSize.y > centerSize.z) ? 1 : 2);
+    if (!(centerSize[axis] > 0)) {
+        return middle;  // <-- Every center is in the same place, so any split is as good as any other.
+    }
+
+    if (depth >= OC_BVH_MAX_DEPTH/2) {
+        ocBVHCenterLess less;
+        less.pCenters = pCenters;
+        less.axis     = axis;
+        std::nth_element(pOrder + begin, pOrder + middle, pOrder + end, less);
+        return middle;
+    }
+
+    ocUInt32 binCounts[OC_BVH_BIN_COUNT];
+    glm::vec3 binMin[OC_BVH_BIN_COUNT];
+    glm::vec3 binMax[OC_BVH_BIN_COUNT];
+    for (ocUInt32 iBin = 0; iBin < OC_BVH_BIN_COUNT; ++iBin) {
+        binCounts[iBin] = 0;
+        binMin[iBin] = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+        binMax[iBin] = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    }
+
+    float binScale = (OC_BVH_BIN_COUNT * 0.9999f) / centerSize[axis];
+    for (ocUInt32 i = begin; i < end; ++i) {
+        ocUInt32 item = pOrder[i];
+        ocUInt32 iBin = ocMin((ocUInt32)((pCenters[item][axis] - centerMin[axis]) * binScale), (ocUInt32)OC_BVH_BIN_COUNT-1);
+        binCounts[iBin] += 1;
+        binMin[iBin] = glm::min(binMin[iBin], pBuilder->pBoundsMin[item]);
+        binMax[iBin] = glm::max(binMax[iBin], pBuilder->pBoundsMax[item]);
+    }
+
+    // The cost of splitting after each bin is the area of each side weighted by the number of items in it. The right side is swept
+    // first so the left side can be done in the same pass as the cost.
+    float rightCosts[OC_BVH_BIN_COUNT];
+    glm::vec3 sideMin = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    glm::vec3 sideMax = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    ocUInt32 sideCount = 0;
+    for (ocUInt32 iBin = OC_BVH_BIN_COUNT-1; iBin > 0; --iBin) {
+        sideMin = glm::min(sideMin, binMin[iBin]);
+        sideMax = glm::max(sideMax, binMax[iBin]);
+        sideCount += binCounts[iBin];
+        rightCosts[iBin] = (sideCount > 0) ? ocBVHHalfArea(sideMin, sideMax) * sideCount : 0;
+    }
+
+    float bestCost = FLT_MAX;
+    ocUInt32 bestBin = 0;
+    sideMin = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    sideMax = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    sideCount = 0;
+    for (ocUInt32 iBin = 1; iBin < OC_BVH_BIN_COUNT; ++iBin) {
+        sideMin = glm::min(sideMin, binMin[iBin-1]);
+        sideMax = glm::max(sideMax, binMax[iBin-1]);
+        sideCount += binCounts[iBin-1];
+        if (sideCount == 0 || sideCount == end - begin) {
+            continue;
+        }
+
+        float cost = ocBVHHalfArea(sideMin, sideMax) * sideCount + rightCosts[iBin];
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestBin  = iBin;
+        }
+    }
+
+    if (bestBin == 0) {
+        return middle;
+    }
+
+    // Items in bins before the split go to the front.
+    ocUInt32 i = begin;
+    ocUInt32 j = end;
+    while (i < j) {
+        ocUInt32 iBin = ocMin((ocUInt32)((pCenters[pOrder[i]][axis] - centerMin[axis]) * binScale), (ocUInt32)OC_BVH_BIN_COUNT-1);
+        if (iBin < bestBin) {
+            i += 1;
+        } else {
+            j -= 1;
+            ocUInt32 temp = pOrder[i];
+            pOrder[i] = pOrder[j];
+            pOrder[j] = temp;
+        }
+    }
+
+    return i;
+}
+
+OC_PRIVATE ocResult ocBVHBuilderBuildNode(ocBVHBuilder* pBuilder, const ocBVHBuildRange* pRange, ocUInt32 depth, ocUInt32* pNodeIndex)
+{
+    ocBVH* pBVH = pBuilder->pBVH;
+
+    // The range is split in two, and then the biggest of the halves is split again until there are 4 children or they're all small
+    // enough to be leaves.
+    ocBVHBuildRange ranges[4];
+    ocUInt32 rangeCount = 1;
+    ranges[0] = *pRange;
+
+    while (rangeCount < 4) {
+        ocUInt32 iBest = rangeCount;
+        float bestArea = -1;
+        for (ocUInt32 iRange = 0; iRange < rangeCount; ++iRange) {
+            if (ranges[iRange].end - ranges[iRange].begin <= OC_BVH_MAX_LEAF_SIZE) {
+                continue;
+            }
+
+            // Median splits need the item counts to shrink as fast as possible, so the largest range is split.
+            float area = (depth >= OC_BVH_MAX_DEPTH/2) ? (float)(ranges[iRange].end - ranges[iRange].begin) : ocBVHHalfArea(ranges[iRange].aabbMin, ranges[iRange].aabbMax);
+            if (area > bestArea) {
+                bestArea = area;
+                iBest = iRange;
+            }
+        }
+
+        if (iBest == rangeCount) {
+            break;
+        }
+
+        ocUInt32 split = ocBVHBuilderSplit(pBuilder, &ranges[iBest], depth);
+        ranges[rangeCount].begin = split;
+        ranges[rangeCount].end   = ranges[iBest].end;
+        ranges[iBest].end        = split;
+        ocBVHBuilderGetBounds(pBuilder, &ranges[iBest]);
+        ocBVHBuilderGetBounds(pBuilder, &ranges[rangeCount]);
+        rangeCount += 1;
+    }
+
+    // The node is added before it's children so the root ends up at index 0. Children can reallocate the node array, so the node is
+    // always accessed by index.
+    ocUInt32 nodeIndex = (ocUInt32)pBVH->nodes.count;
+    ocBVHNode node;
+    for (ocUInt32 iChild = 0; iChild < 4; ++iChild) {
+        node.minX[iChild] = node.minY[iChild] = node.minZ[iChild] = FLT_MAX;
+        node.maxX[iChild] = node.maxY[iChild] = node.maxZ[iChild] = FLT_MAX;
+        node.children[iChild] = OC_BVH_EMPTY;
+        node.counts[iChild]   = 0;
+    }
+
+    ocResult result = ocStackPush(&pBVH->nodes, node);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (ocUInt32 iChild = 0; iChild < rangeCount; ++iChild) {
+        const ocBVHBuildRange* pChildRange = &ranges[iChild];
+        ocUInt32 count = pChildRange->end - pChildRange->begin;
+
+        ocUInt32 child;
+        if (count <= OC_BVH_MAX_LEAF_SIZE) {
+            child = OC_BVH_LEAF | pChildRange->begin;   // <-- Moved to it's final place once the tree is done.
+            pBVH->leafCount += 1;
+        } else {
+            result = ocBVHBuilderBuildNode(pBuilder, pChildRange, depth + 1, &child);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+            count = 0;
+        }
+
+        ocBVHNode* pNode = &pBVH->nodes.pItems[nodeIndex];
+        pNode->minX[iChild]     = pChildRange->aabbMin.x;
+        pNode->minY[iChild]     = pChildRange->aabbMin.y;
+        pNode->minZ[iChild]     = pChildRange->aabbMin.z;
+        pNode->maxX[iChild]     = pChildRange->aabbMax.x;
+        pNode->maxY[iChild]     = pChildRange->aabbMax.y;
+        pNode->maxZ[iChild]     = pChildRange->aabbMax.z;
+        pNode->children[iChild] = child;
+        pNode->counts[iChild]   = count;
+    }
+
+    *pNodeIndex = nodeIndex;
+    return OC_SUCCESS;
+}
+
+ocResult ocBVHBuild(ocBVH* pBVH, const glm::vec3* pBoundsMin, const glm::vec3* pBoundsMax, ocUInt32 count)
+{
+    if (pBVH == NULL) return OC_INVALID_ARGS;
+    if ((pBoundsMin == NULL || pBoundsMax == NULL) && count > 0) return OC_INVALID_ARGS;
+
+    ocStackClear(&pBVH->nodes);
+    ocStackClear(&pBVH->items);
+    pBVH->leafCount = 0;
+    pBVH->aabbMin = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    pBVH->aabbMax = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    if (count == 0) {
+        return OC_SUCCESS;
+    }
+
+    ocResult result = ocStackResize(&pBVH->order, count);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackResize(&pBVH->centers, count);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (ocUInt32 i = 0; i < count; ++i) {
+        pBVH->order.pItems[i]   = i;
+        pBVH->centers.pItems[i] = (pBoundsMin[i] + pBoundsMax[i]) * 0.5f;
+    }
+
+    ocBVHBuilder builder;
+    builder.pBVH       = pBVH;
+    builder.pBoundsMin = pBoundsMin;
+    builder.pBoundsMax = pBoundsMax;
+    builder.pCenters   = pBVH->centers.pItems;
+    builder.pOrder     = pBVH->order.pItems;
+
+    ocBVHBuildRange root;
+    root.begin = 0;
+    root.end   = count;
+    ocBVHBuilderGetBounds(&builder, &root);
+    pBVH->aabbMin = root.aabbMin;
+    pBVH->aabbMax = root.aabbMax;
+
+    ocUInt32 rootIndex;
+    result = ocBVHBuilderBuildNode(&builder, &root, 0, &rootIndex);
+    if (result != OC_SUCCESS) {
+        ocStackClear(&pBVH->nodes);
+        return result;
+    }
+
+    // Leaves are moved so each one starts on a multiple of the leaf size.
+    result = ocStackResize(&pBVH->items, pBVH->leafCount * OC_BVH_MAX_LEAF_SIZE);
+    if (result != OC_SUCCESS) {
+        ocStackClear(&pBVH->nodes);
+        return result;
+    }
+
+    ocUInt32 nextItem = 0;
+    for (ocSizeT iNode = 0; iNode < pBVH->nodes.count; ++iNode) {
+        ocBVHNode* pNode = &pBVH->nodes.pItems[iNode];
+        for (ocUInt32 iChild = 0; iChild < 4; ++iChild) {
+            if (pNode->children[iChild] == OC_BVH_EMPTY || (pNode->children[iChild] & OC_BVH_LEAF) == 0) {
+                continue;
+            }
+
+            ocUInt32 first = pNode->children[iChild] & ~OC_BVH_LEAF;
+            for (ocUInt32 iItem = 0; iItem < OC_BVH_MAX_LEAF_SIZE; ++iItem) {
+                pBVH->items.pItems[nextItem + iItem] = (iItem < pNode->counts[iChild]) ? pBVH->order.pItems[first + iItem] : OC_BVH_EMPTY;
+            }
+
+            pNode->children[iChild] = OC_BVH_LEAF | nextItem;
+            nextItem += OC_BVH_MAX_LEAF_SIZE;
+        }
+    }
+
+    return OC_SUCCESS;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Traversal
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// A ray with everything that's needed for testing it against the children of a node.
+struct ocBVHRayData
+{
+#ifdef OC_SUPPORT_SSE2
+    __m128 originX;
+    __m128 originY;
+    __m128 originZ;
+    __m128 invDirectionX;
+    __m128 invDirectionY;
+    __m128 invDirectionZ;
+    __m128 extentsX;
+    __m128 extentsY;
+    __m128 extentsZ;
+#endif
+    glm::vec3 origin;
+    glm::vec3 invDirection;
+    glm::vec3 extents;
+};
+
+OC_INLINE float ocBVHSafeInverse(float x)
+{
+    if (fabsf(x) < OC_BVH_MIN_DIRECTION) {
+        x = (x < 0) ? -OC_BVH_MIN_DIRECTION : OC_BVH_MIN_DIRECTION;
+    }
+
+    return 1 / x;
+}
+
+OC_PRIVATE void ocBVHRayDataInit(const ocBVHRay* pRay, ocBVHRayData* pData)
+{
+    pData->origin       = pRay->origin;
+    pData->invDirection = glm::vec3(ocBVHSafeInverse(pRay->direction.x), ocBVHSafeInverse(pRay->direction.y), ocBVHSafeInverse(pRay->direction.z));
+    pData->extents      = pRay->extents;
+
+#ifdef OC_SUPPORT_SSE2
+    pData->originX       = _mm_set1_ps(pData->origin.x);
+    pData->originY       = _mm_set1_ps(pData->origin.y);
+    pData->originZ       = _mm_set1_ps(pData->origin.z);
+    pData->invDirectionX = _mm_set1_ps(pData->invDirection.x);
+    pData->invDirectionY = _mm_set1_ps(pData->invDirection.y);
+    pData->invDirectionZ = _mm_set1_ps(pData->invDirection.z);
+    pData->extentsX      = _mm_set1_ps(pData->extents.x);
+    pData->extentsY      = _mm_set1_ps(pData->extents.y);
+    pData->extentsZ      = _mm_set1_ps(pData->extents.z);
+#endif
+}
+
+// The slab test against the 4 children of a node. Returns a mask of the children that are hit, with the distance at which the ray
+// enters each of them in pNear.
+OC_INLINE ocUInt32 ocBVHIntersectNode(const ocBVHNode* pNode, const ocBVHRayData* pRay, float maxDistance, float* pNear)
+{
+#ifdef OC_SUPPORT_SSE2
+    __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(pNode->minX), pRay->extentsX), pRay->originX), pRay->invDirectionX);
+    __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_loadu_ps(pNode->maxX), pRay->extentsX), pRay->originX), pRay->invDirectionX);
+    __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(pNode->minY), pRay->extentsY), pRay->originY), pRay->invDirectionY);
+    __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_loadu_ps(pNode->maxY), pRay->extentsY), pRay->originY), pRay->invDirectionY);
+    __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(pNode->minZ), pRay->extentsZ), pRay->originZ), pRay->invDirectionZ);
+    __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_loadu_ps(pNode->maxZ), pRay->extentsZ), pRay->originZ), pRay->invDirectionZ);
+
+    __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+    __m128 tFar  = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_set1_ps(maxDistance)));
+
+    _mm_storeu_ps(pNear, tNear);
+    return (ocUInt32)_mm_movemask_ps(_mm_cmple_ps(tNear, tFar));
+#else
+    ocUInt32 mask = 0;
+    for (ocUInt32 iChild = 0; iChild < 4; ++iChild) {
+        float t0x = (pNode->minX[iChild] - pRay->extents.x - pRay->origin.x) * pRay->invDirection.x;
+        float t1x = (pNode->maxX[iChild] + pRay->extents.x - pRay->origin.x) * pRay->invDirection.x;
+        float t0y = (pNode->minY[iChild] - pRay->extents.y - pRay->origin.y) * pRay->invDirection.y;
+        float t1y = (pNode->maxY[iChild] + pRay->extents.y - pRay->origin.y) * pRay->invDirection.y;
+        float t0z = (pNode->minZ[iChild] - pRay->extents.z - pRay->origin.z) * pRay->invDirection.z;
+        float t1z = (pNode->maxZ[iChild] + pRay->extents.z - pRay->origin.z) * pRay->invDirection.z;
+
+        float tNear = ocMax(ocMax(ocMin(t0x, t1x), ocMin(t0y, t1y)), ocMax(ocMin(t0z, t1z), 0.0f));
+        float tFar  = ocMin(ocMin(ocMax(t0x, t1x), ocMax(t0y, t1y)), ocMin(ocMax(t0z, t1z), maxDistance));
+
+        pNear[iChild] = tNear;
+        if (tNear <= tFar) {
+            mask |= (1U << iChild);
+        }
+    }
+
+    return mask;
+#endif
+}
+
+// An entry of the traversal stack. Leaves go on the stack along with nodes so everything is visited in order of distance.
+struct ocBVHStackEntry
+{
+    ocUInt32 child;
+    ocUInt32 count;
+    float distance;
+};
+
+void ocBVHRaycast(const ocBVH* pBVH, const ocBVHRay* pRay, ocBVHRayLeafProc onLeaf, void* pUserData)
+{
+    if (pBVH == NULL || pRay == NULL || onLeaf == NULL || pBVH->nodes.count == 0) {
+        return;
+    }
+
+    ocBVHRayData ray;
+    ocBVHRayDataInit(pRay, &ray);
+
+    float maxDistance = pRay->maxDistance;
+    const ocBVHNode* pNodes = pBVH->nodes.pItems;
+
+    ocBVHStackEntry stack[OC_BVH_STACK_SIZE];
+    ocUInt32 stackCount = 1;
+    stack[0].child    = 0;
+    stack[0].count    = 0;
+    stack[0].distance = 0;
+
+    while (stackCount > 0) {
+        ocBVHStackEntry entry = stack[--stackCount];
+        if (entry.distance > maxDistance) {
+            continue;   // <-- Something closer was hit after this was pushed.
+        }
+
+        if ((entry.child & OC_BVH_LEAF) != 0) {
+            maxDistance = onLeaf(pUserData, entry.child & ~OC_BVH_LEAF, entry.count, maxDistance);
+            continue;
+        }
+
+        const ocBVHNode* pNode = &pNodes[entry.child];
+        float near[4];
+        ocUInt32 mask = ocBVHIntersectNode(pNode, &ray, maxDistance, near);
+        if (mask == 0) {
+            continue;
+        }
+
+        // The children that were hit are sorted furthest first so the nearest is popped next.
+        ocBVHStackEntry hits[4];
+        ocUInt32 hitCount = 0;
+        for (ocUInt32 iChild = 0; iChild < 4; ++iChild) {
+            if ((mask & (1U << iChild)) == 0) {
+                continue;
+            }
+
+            ocBVHStackEntry hit;
+            hit.child    = pNode->children[iChild];
+            hit.count    = pNode->counts[iChild];
+            hit.distance = near[iChild];
+
+            ocUInt32 iHit = hitCount;
+            while (iHit > 0 && hits[iHit-1].distance < hit.distance) {
+                hits[iHit] = hits[iHit-1];
+                iHit -= 1;
+            }
+            hits[iHit] = hit;
+            hitCount += 1;
+        }
+
+        ocAssert(stackCount + hitCount <= OC_BVH_STACK_SIZE);
+        for (ocUInt32 iHit = 0; iHit < hitCount; ++iHit) {
+            stack[stackCount++] = hits[iHit];
+        }
+    }
+}
+
+void ocBVHQuery(const ocBVH* pBVH, const glm::vec3 &aabbMin, const glm::vec3 &aabbMax, ocBVHLeafProc onLeaf, void* pUserData)
+{
+    if (pBVH == NULL || onLeaf == NULL || pBVH->nodes.count == 0) {
+        return;
+    }
+
+    const ocBVHNode* pNodes = pBVH->nodes.pItems;
+
+#ifdef OC_SUPPORT_SSE2
+    __m128 queryMinX = _mm_set1_ps(aabbMin.x);
+    __m128 queryMinY = _mm_set1_ps(aabbMin.y);
+    __m128 queryMinZ = _mm_set1_ps(aabbMin.z);
+    __m128 queryMaxX = _mm_set1_ps(aabbMax.x);
+    __m128 queryMaxY = _mm_set1_ps(aabbMax.y);
+    __m128 queryMaxZ = _mm_set1_ps(aabbMax.z);
+#endif
+
+    ocUInt32 stack[OC_BVH_STACK_SIZE];
+    ocUInt32 stackCount = 1;
+    stack[0] = 0;
+
+    while (stackCount > 0) {
+        const ocBVHNode* pNode = &pNodes[stack[--stackCount]];
+
+#ifdef OC_SUPPORT_SSE2
+        __m128 overlapX = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(pNode->minX), queryMaxX), _mm_cmpge_ps(_mm_loadu_ps(pNode->maxX), queryMinX));
+        __m128 overlapY = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(pNode->minY), queryMaxY), _mm_cmpge_ps(_mm_loadu_ps(pNode->maxY), queryMinY));
+        __m128 overlapZ = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(pNode->minZ), queryMaxZ), _mm_cmpge_ps(_mm_loadu_ps(pNode->maxZ), queryMinZ));
+        ocUInt32 mask = (ocUInt32)_mm_movemask_ps(_mm_and_ps(overlapX, _mm_and_ps(overlapY, overlapZ)));
+#else
+        ocUInt32 mask = 0;
+        for (ocUInt32 iChild = 0; iChild < 4; ++iChild) {
+            if (pNode->minX[iChild] <= aabbMax.x && pNode->maxX[iChild] >= aabbMin.x &&
+                pNode->minY[iChild] <= aabbMax.y && pNode->maxY[iChild] >= aabbMin.y &&
+                pNode->minZ[iChild] <= aabbMax.z && pNode->maxZ[iChild] >= aabbMin.z) {
+                mask |= (1U << iChild);
+            }
+        }
+#endif
+
+        for (ocUInt32 iChild = 0; iChild < 4; ++iChild) {
+            if ((mask & (1U << iChild)) == 0) {
+                continue;
+            }
+
+            ocUInt32 child = pNode->children[iChild];
+            if ((child & OC_BVH_LEAF) != 0) {
+                onLeaf(pUserData, child & ~OC_BVH_LEAF, pNode->counts[iChild]);
+            } else {
+                ocAssert(stackCount < OC_BVH_STACK_SIZE);
+                stack[stackCount++] = child;
+            }
+        }
+    }
+}
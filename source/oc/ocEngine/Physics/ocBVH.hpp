@@ -0,0 +1,71 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// A bounding volume hierarchy with 4 children per node. The bounds of the children of a node are stored as a structure of arrays so that
+// a ray can be tested against all 4 of them at once with SIMD. The tree is built top down with the surface area heuristic, using bins
+// rather than sorting so that building is close to linear.
+//
+// The tree does not know what it's items are. It's built from a list of bounding boxes, and leaves refer to ranges of items, which holds
+// the indices of those boxes. Each leaf starts at a multiple of OC_BVH_MAX_LEAF_SIZE so that owners can keep their own data for each leaf
+// in fixed size blocks, which is what triangle meshes do. Unused slots at the end of a leaf are set to OC_BVH_EMPTY.
+
+#define OC_BVH_MAX_LEAF_SIZE    4
+#define OC_BVH_MAX_DEPTH        32          // <-- The deepest the builder will go. Past half of this it switches to median splits.
+#define OC_BVH_LEAF             0x80000000  // <-- Set on a child that's a leaf, in which case the rest is the index of it's first item.
+#define OC_BVH_EMPTY            0xFFFFFFFF  // <-- A child or item that doesn't exist.
+
+struct ocBVHNode
+{
+    float minX[4];              // <-- Children that don't exist are a point at FLT_MAX, which is never hit.
+    float minY[4];
+    float minZ[4];
+    float maxX[4];
+    float maxY[4];
+    float maxZ[4];
+    ocUInt32 children[4];       // <-- The index of the child node, or OC_BVH_LEAF | the index of the first item in items.
+    ocUInt32 counts[4];         // <-- The number of items in each leaf. 0 for nodes.
+};
+
+struct ocBVH
+{
+    ocStack<ocBVHNode> nodes;   // <-- The root is always at index 0. Empty when the tree was built from nothing.
+    ocStack<ocUInt32> items;    // <-- Item indices, grouped by leaf.
+    ocUInt32 leafCount;
+    glm::vec3 aabbMin;          // <-- The bounds of everything in the tree.
+    glm::vec3 aabbMax;
+
+    // Working memory for building, kept so rebuilding doesn't need to allocate.
+    ocStack<ocUInt32> order;
+    ocStack<glm::vec3> centers;
+};
+
+// A ray, or a box being swept along a ray when extents is not zero. Distances are in units of the length of the direction, which does not
+// need to be normalized.
+struct ocBVHRay
+{
+    glm::vec3 origin;
+    glm::vec3 direction;
+    glm::vec3 extents;          // <-- The half extents of the box being swept. Every box in the tree is grown by this much.
+    float maxDistance;
+};
+
+// Called for each leaf that's hit by a ray, nearest first. first is the index of the first item of the leaf in items. Returns the new
+// maximum distance of the ray, which is how the search stops early once something has been hit.
+typedef float (* ocBVHRayLeafProc)(void* pUserData, ocUInt32 first, ocUInt32 count, float maxDistance);
+
+// Called for each leaf that overlaps a box.
+typedef void (* ocBVHLeafProc)(void* pUserData, ocUInt32 first, ocUInt32 count);
+
+//
+ocResult ocBVHInit(ocBVH* pBVH);
+
+//
+void ocBVHUninit(ocBVH* pBVH);
+
+// Rebuilds the tree from a list of bounding boxes. The memory of the previous build is reused.
+ocResult ocBVHBuild(ocBVH* pBVH, const glm::vec3* pBoundsMin, const glm::vec3* pBoundsMax, ocUInt32 count);
+
+// Visits the leaves hit by a ray, nearest first.
+void ocBVHRaycast(const ocBVH* pBVH, const ocBVHRay* pRay, ocBVHRayLeafProc onLeaf, void* pUserData);
+
+// Visits the leaves that overlap a box.
+void ocBVHQuery(const ocBVH* pBVH, const glm::vec3 &aabbMin, const glm::vec3 &aabbMax, ocBVHLeafProc onLeaf, void* pUserData);
@@ -0,0 +1,490 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+ocResult ocBroadphaseInit(ocBroadphase* pBroadphase)
+{
+    if (pBroadphase == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pBroadphase);
+
+    ocStackInit(&pBroadphase->proxies);
+    ocStackInit(&pBroadphase->order);
+    ocStackInit(&pBroadphase->treeIDs);
+    ocStackInit(&pBroadphase->treeBoundsMin);
+    ocStackInit(&pBroadphase->treeBoundsMax);
+
+    return ocBVHInit(&pBroadphase->tree);
+}
+
+void ocBroadphaseUninit(ocBroadphase* pBroadphase)
+{
+    if (pBroadphase == NULL) return;
+
+    ocBVHUninit(&pBroadphase->tree);
+    ocStackUninit(&pBroadphase->treeBoundsMax);
+    ocStackUninit(&pBroadphase->treeBoundsMin);
+    ocStackUninit(&pBroadphase->treeIDs);
+    ocStackUninit(&pBroadphase->order);
+    ocStackUninit(&pBroadphase->proxies);
+    ocFree(pBroadphase->pSortedData);
+}
+
+ocResult ocBroadphaseInsert(ocBroadphase* pBroadphase, ocUInt32 id, ocBool32 isPassive)
+{
+    if (pBroadphase == NULL) return OC_INVALID_ARGS;
+
+    ocSizeT oldProxyCount = pBroadphase->proxies.count;
+    if (id >= oldProxyCount) {
+        ocResult result = ocStackResize(&pBroadphase->proxies, id + 1);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        for (ocSizeT iProxy = oldProxyCount; iProxy < pBroadphase->proxies.count; ++iProxy) {
+            ocZeroObject(&pBroadphase->proxies.pItems[iProxy]);
+            pBroadphase->proxies.pItems[iProxy].treeSlot = OC_BROADPHASE_NONE;
+        }
+    }
+
+    ocBroadphaseProxy* pProxy = &pBroadphase->proxies.pItems[id];
+    ocAssert(!pProxy->isInSweep && pProxy->treeSlot == OC_BROADPHASE_NONE);
+
+    // New bodies go on the end. They'll be moved into place by the insertion sort on the next step. A body that left the sweep since the
+    // last step is still in the order, in which case it's just put back.
+    if (!pProxy->isInOrder) {
+        ocResult result = ocStackPush(&pBroadphase->order, id);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        pProxy->isInOrder = OC_TRUE;
+    }
+
+    pProxy->flags     = isPassive ? OC_BROADPHASE_FLAG_PASSIVE : 0;
+    pProxy->isInSweep = OC_TRUE;
+    if (isPassive) {
+        pBroadphase->sweepPassiveCount += 1;
+    }
+
+    return OC_SUCCESS;
+}
+
+void ocBroadphaseRemove(ocBroadphase* pBroadphase, ocUInt32 id)
+{
+    if (pBroadphase == NULL || id >= pBroadphase->proxies.count) return;
+
+    // Nothing is erased here. The order is cleaned up on the next step, and the tree on it's next rebuild.
+    ocBroadphaseProxy* pProxy = &pBroadphase->proxies.pItems[id];
+    if (pProxy->treeSlot != OC_BROADPHASE_NONE) {
+        pBroadphase->treeIDs.pItems[pProxy->treeSlot] = OC_BROADPHASE_NONE;
+        pBroadphase->treeRemovedCount += 1;
+        pProxy->treeSlot = OC_BROADPHASE_NONE;
+    }
+
+    if (pProxy->isInSweep) {
+        if ((pProxy->flags & OC_BROADPHASE_FLAG_PASSIVE) != 0) {
+            pBroadphase->sweepPassiveCount -= 1;
+        }
+
+        pProxy->isInSweep = OC_FALSE;
+    }
+
+    pProxy->flags = 0;
+}
+
+ocResult ocBroadphaseSetPassive(ocBroadphase* pBroadphase, ocUInt32 id, ocBool32 isPassive)
+{
+    if (pBroadphase == NULL || id >= pBroadphase->proxies.count) return OC_INVALID_ARGS;
+
+    ocBroadphaseRemove(pBroadphase, id);
+    return ocBroadphaseInsert(pBroadphase, id, isPassive);
+}
+
+// Removes bodies that have left the sweep from the order, keeping the rest sorted. Returns the number of active bodies in the sweep.
+OC_PRIVATE ocUInt32 ocBroadphaseCompactOrder(ocBroadphase* pBroadphase)
+{
+    ocAssert(pBroadphase != NULL);
+
+    ocBroadphaseProxy* pProxies = pBroadphase->proxies.pItems;
+    ocUInt32* pOrder = pBroadphase->order.pItems;
+    ocSizeT count = pBroadphase->order.count;
+    ocSizeT iWrite = 0;
+    ocUInt32 activeCount = 0;
+    for (ocSizeT iRead = 0; iRead < count; ++iRead) {
+        ocUInt32 id = pOrder[iRead];
+        if (!pProxies[id].isInSweep) {
+            pProxies[id].isInOrder = OC_FALSE;
+            continue;
+        }
+
+        if ((pProxies[id].flags & OC_BROADPHASE_FLAG_PASSIVE) == 0) {
+            activeCount += 1;
+        }
+
+        pOrder[iWrite++] = id;
+    }
+
+    pBroadphase->order.count = iWrite;
+    return activeCount;
+}
+
+// Rebuilds the tree from the bodies that are still in it, plus the passive bodies waiting in the sweep. If it fails, every passive body is
+// left in the sweep so that nothing is missed.
+OC_PRIVATE ocResult ocBroadphaseRebuildTree(ocBroadphase* pBroadphase, const ocBroadphaseBounds* pBounds)
+{
+    ocAssert(pBroadphase != NULL);
+    ocAssert(pBounds != NULL);
+
+    ocUInt32 oldTreeCount = (ocUInt32)pBroadphase->treeIDs.count;
+    ocUInt32 newTreeCount = oldTreeCount - pBroadphase->treeRemovedCount + pBroadphase->sweepPassiveCount;
+
+    // Everything that can fail to allocate is done up front. The order is given room for every body in the tree in case they need to go
+    // back into the sweep.
+    ocSizeT orderCount = pBroadphase->order.count;
+    ocResult result = ocStackResize(&pBroadphase->order, orderCount + oldTreeCount);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+    pBroadphase->order.count = orderCount;
+
+    result = ocStackResize(&pBroadphase->treeIDs, ocMax(oldTreeCount, newTreeCount));
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackResize(&pBroadphase->treeBoundsMin, newTreeCount);
+    if (result != OC_SUCCESS) {
+        pBroadphase->treeIDs.count = oldTreeCount;
+        return result;
+    }
+
+    result = ocStackResize(&pBroadphase->treeBoundsMax, newTreeCount);
+    if (result != OC_SUCCESS) {
+        pBroadphase->treeIDs.count = oldTreeCount;
+        return result;
+    }
+
+    ocBroadphaseProxy* pProxies = pBroadphase->proxies.pItems;
+    ocUInt32* pTreeIDs = pBroadphase->treeIDs.pItems;
+    ocUInt32 treeCount = 0;
+    for (ocUInt32 iSlot = 0; iSlot < oldTreeCount; ++iSlot) {
+        if (pTreeIDs[iSlot] != OC_BROADPHASE_NONE) {
+            pTreeIDs[treeCount++] = pTreeIDs[iSlot];
+        }
+    }
+
+    for (ocSizeT iOrder = 0; iOrder < pBroadphase->order.count; ++iOrder) {
+        ocUInt32 id = pBroadphase->order.pItems[iOrder];
+        if (pProxies[id].isInSweep && (pProxies[id].flags & OC_BROADPHASE_FLAG_PASSIVE) != 0) {
+            pTreeIDs[treeCount++] = id;
+        }
+    }
+
+    ocAssert(treeCount == newTreeCount);
+    pBroadphase->treeIDs.count = treeCount;
+
+    for (ocUInt32 iSlot = 0; iSlot < treeCount; ++iSlot) {
+        ocUInt32 index = pBounds->pIndices[pTreeIDs[iSlot]];
+        pBroadphase->treeBoundsMin.pItems[iSlot] = glm::vec3(pBounds->pMinX[index], pBounds->pMinY[index], pBounds->pMinZ[index]);
+        pBroadphase->treeBoundsMax.pItems[iSlot] = glm::vec3(pBounds->pMaxX[index], pBounds->pMaxY[index], pBounds->pMaxZ[index]);
+    }
+
+    result = ocBVHBuild(&pBroadphase->tree, pBroadphase->treeBoundsMin.pItems, pBroadphase->treeBoundsMax.pItems, treeCount);
+    if (result != OC_SUCCESS) {
+        for (ocUInt32 iSlot = 0; iSlot < treeCount; ++iSlot) {
+            ocBroadphaseProxy* pProxy = &pProxies[pTreeIDs[iSlot]];
+            pProxy->treeSlot = OC_BROADPHASE_NONE;
+            if (!pProxy->isInSweep) {
+                if (!pProxy->isInOrder) {
+                    pBroadphase->order.pItems[pBroadphase->order.count++] = pTreeIDs[iSlot];   // <-- Can't fail. Reserved above.
+                    pProxy->isInOrder = OC_TRUE;
+                }
+
+                pProxy->isInSweep = OC_TRUE;
+                pBroadphase->sweepPassiveCount += 1;
+            }
+        }
+
+        ocStackClear(&pBroadphase->treeIDs);
+        pBroadphase->treeRemovedCount = 0;
+        return result;
+    }
+
+    for (ocUInt32 iSlot = 0; iSlot < treeCount; ++iSlot) {
+        ocBroadphaseProxy* pProxy = &pProxies[pTreeIDs[iSlot]];
+        pProxy->treeSlot  = iSlot;
+        pProxy->isInSweep = OC_FALSE;
+    }
+
+    pBroadphase->treeRemovedCount  = 0;
+    pBroadphase->sweepPassiveCount = 0;
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocBroadphaseReserveSorted(ocBroadphase* pBroadphase, ocUInt32 count)
+{
+    ocAssert(pBroadphase != NULL);
+
+    // There's always at least 4 elements of padding at the end so the sweep can read 4 candidates past the last body.
+    ocUInt32 requiredCapacity = ((count + 3) & ~3U) + 4;
+    if (requiredCapacity <= pBroadphase->sortedCapacity) {
+        return OC_SUCCESS;
+    }
+
+    ocUInt32 newCapacity = ocMax(requiredCapacity, pBroadphase->sortedCapacity*2);
+    void* pNewData = ocMalloc(newCapacity * (sizeof(float)*6 + sizeof(ocUInt32)));
+    if (pNewData == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocFree(pBroadphase->pSortedData);
+    pBroadphase->pSortedData    = pNewData;
+    pBroadphase->sortedCapacity = newCapacity;
+    pBroadphase->pSortedMinX    = (float*)pNewData;
+    pBroadphase->pSortedMinY    = pBroadphase->pSortedMinX + newCapacity;
+    pBroadphase->pSortedMinZ    = pBroadphase->pSortedMinY + newCapacity;
+    pBroadphase->pSortedMaxX    = pBroadphase->pSortedMinZ + newCapacity;
+    pBroadphase->pSortedMaxY    = pBroadphase->pSortedMaxX + newCapacity;
+    pBroadphase->pSortedMaxZ    = pBroadphase->pSortedMaxY + newCapacity;
+    pBroadphase->pSortedFlags   = (ocUInt32*)(pBroadphase->pSortedMaxZ + newCapacity);
+
+    return OC_SUCCESS;
+}
+
+OC_INLINE ocBool32 ocBroadphaseIsPairReported(ocUInt32 flagsA, ocUInt32 flagsB)
+{
+    return (flagsA & flagsB & OC_BROADPHASE_FLAG_PASSIVE) == 0;
+}
+
+OC_INLINE ocBool32 ocBroadphaseOverlaps(const ocBroadphaseBounds* pBounds, ocUInt32 index, const glm::vec3 &aabbMin, const glm::vec3 &aabbMax)
+{
+    return pBounds->pMinX[index] <= aabbMax.x && pBounds->pMaxX[index] >= aabbMin.x &&
+           pBounds->pMinY[index] <= aabbMax.y && pBounds->pMaxY[index] >= aabbMin.y &&
+           pBounds->pMinZ[index] <= aabbMax.z && pBounds->pMaxZ[index] >= aabbMin.z;
+}
+
+OC_PRIVATE ocResult ocBroadphaseAddPair(ocUInt32 indexA, ocUInt32 indexB, ocStack<ocBroadphasePair>* pPairs)
+{
+    ocBroadphasePair pair;
+    pair.indexA = ocMin(indexA, indexB);
+    pair.indexB = ocMax(indexA, indexB);
+    return ocStackPush(pPairs, pair);
+}
+
+struct ocBroadphaseTreeQuery
+{
+    const ocBroadphase* pBroadphase;
+    const ocBroadphaseBounds* pBounds;
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+    ocUInt32 index;                         // <-- The body the tree is being queried for, when finding pairs.
+    ocStack<ocBroadphasePair>* pPairs;      // <-- NULL when querying a box, in which case indices are output instead.
+    ocStack<ocUInt32>* pIndices;
+    ocResult result;
+};
+
+OC_PRIVATE void ocBroadphaseTreeQueryLeaf(void* pUserData, ocUInt32 first, ocUInt32 count)
+{
+    ocBroadphaseTreeQuery* pQuery = (ocBroadphaseTreeQuery*)pUserData;
+    const ocBroadphase* pBroadphase = pQuery->pBroadphase;
+
+    for (ocUInt32 iItem = first; iItem < first + count; ++iItem) {
+        ocUInt32 slot = pBroadphase->tree.items.pItems[iItem];
+        if (slot == OC_BVH_EMPTY || pBroadphase->treeIDs.pItems[slot] == OC_BROADPHASE_NONE) {
+            continue;
+        }
+
+        ocUInt32 index = pQuery->pBounds->pIndices[pBroadphase->treeIDs.pItems[slot]];
+        if (!ocBroadphaseOverlaps(pQuery->pBounds, index, pQuery->aabbMin, pQuery->aabbMax)) {
+            continue;
+        }
+
+        ocResult result;
+        if (pQuery->pPairs != NULL) {
+            result = ocBroadphaseAddPair(pQuery->index, index, pQuery->pPairs);
+        } else {
+            result = ocStackPush(pQuery->pIndices, index);
+        }
+
+        if (result != OC_SUCCESS) {
+            pQuery->result = result;
+        }
+    }
+}
+
+ocResult ocBroadphaseFindPairs(ocBroadphase* pBroadphase, const ocBroadphaseBounds* pBounds, ocStack<ocBroadphasePair>* pPairs)
+{
+    if (pBroadphase == NULL || pBounds == NULL || pPairs == NULL) return OC_INVALID_ARGS;
+
+    // The tree is rebuilt once there are about as many passive bodies waiting in the sweep as there are active ones, so they never make
+    // up more than half of it. If the rebuild fails they're just swept for another step.
+    ocUInt32 activeCount = ocBroadphaseCompactOrder(pBroadphase);
+    ocUInt32 treeCount = (ocUInt32)pBroadphase->treeIDs.count;
+    if ((pBroadphase->sweepPassiveCount >= OC_BROADPHASE_MIN_TREE_BATCH && pBroadphase->sweepPassiveCount >= activeCount) ||
+        (pBroadphase->treeRemovedCount  >= OC_BROADPHASE_MIN_TREE_BATCH && pBroadphase->treeRemovedCount*2 >= treeCount)) {
+        if (ocBroadphaseRebuildTree(pBroadphase, pBounds) == OC_SUCCESS) {
+            ocBroadphaseCompactOrder(pBroadphase);
+        }
+    }
+
+    const ocUInt32* pIndices = pBounds->pIndices;
+    const ocBroadphaseProxy* pProxies = pBroadphase->proxies.pItems;
+    ocUInt32* pOrder = pBroadphase->order.pItems;
+    ocUInt32 count = (ocUInt32)pBroadphase->order.count;
+
+    // Insertion sort. Most bodies are already in the right place.
+    for (ocUInt32 i = 1; i < count; ++i) {
+        ocUInt32 item = pOrder[i];
+        float key = pBounds->pMinX[pIndices[item]];
+
+        ocUInt32 j = i;
+        while (j > 0 && pBounds->pMinX[pIndices[pOrder[j-1]]] > key) {
+            pOrder[j] = pOrder[j-1];
+            j -= 1;
+        }
+        pOrder[j] = item;
+    }
+
+    ocResult result = ocBroadphaseReserveSorted(pBroadphase, count);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (ocUInt32 i = 0; i < count; ++i) {
+        ocUInt32 index = pIndices[pOrder[i]];
+        pBroadphase->pSortedMinX[i]  = pBounds->pMinX[index];
+        pBroadphase->pSortedMinY[i]  = pBounds->pMinY[index];
+        pBroadphase->pSortedMinZ[i]  = pBounds->pMinZ[index];
+        pBroadphase->pSortedMaxX[i]  = pBounds->pMaxX[index];
+        pBroadphase->pSortedMaxY[i]  = pBounds->pMaxY[index];
+        pBroadphase->pSortedMaxZ[i]  = pBounds->pMaxZ[index];
+        pBroadphase->pSortedFlags[i] = pProxies[pOrder[i]].flags;
+    }
+
+    // The padding can never overlap anything, and ends the sweep.
+    for (ocUInt32 i = count; i < pBroadphase->sortedCapacity; ++i) {
+        pBroadphase->pSortedMinX[i]  =  FLT_MAX;
+        pBroadphase->pSortedMinY[i]  =  FLT_MAX;
+        pBroadphase->pSortedMinZ[i]  =  FLT_MAX;
+        pBroadphase->pSortedMaxX[i]  = -FLT_MAX;
+        pBroadphase->pSortedMaxY[i]  = -FLT_MAX;
+        pBroadphase->pSortedMaxZ[i]  = -FLT_MAX;
+        pBroadphase->pSortedFlags[i] = OC_BROADPHASE_FLAG_PASSIVE;
+    }
+
+    const float* pMinX = pBroadphase->pSortedMinX;
+    const float* pMinY = pBroadphase->pSortedMinY;
+    const float* pMinZ = pBroadphase->pSortedMinZ;
+    const float* pMaxY = pBroadphase->pSortedMaxY;
+    const float* pMaxZ = pBroadphase->pSortedMaxZ;
+    const ocUInt32* pFlags = pBroadphase->pSortedFlags;
+
+    for (ocUInt32 i = 0; i < count; ++i) {
+        float maxX = pBroadphase->pSortedMaxX[i];
+        ocUInt32 j = i + 1;
+
+#ifdef OC_SUPPORT_SSE2
+        // Candidates are sorted by minimum X, so once a lane fails the X test every lane after it does too.
+        __m128 vMaxX = _mm_set1_ps(maxX);
+        __m128 vMinY = _mm_set1_ps(pMinY[i]);
+        __m128 vMinZ = _mm_set1_ps(pMinZ[i]);
+        __m128 vMaxY = _mm_set1_ps(pMaxY[i]);
+        __m128 vMaxZ = _mm_set1_ps(pMaxZ[i]);
+        for (;;) {
+            __m128 overlapX = _mm_cmple_ps(_mm_loadu_ps(pMinX + j), vMaxX);
+            __m128 overlapY = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(pMinY + j), vMaxY), _mm_cmpge_ps(_mm_loadu_ps(pMaxY + j), vMinY));
+            __m128 overlapZ = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(pMinZ + j), vMaxZ), _mm_cmpge_ps(_mm_loadu_ps(pMaxZ + j), vMinZ));
+            int maskX = _mm_movemask_ps(overlapX);
+            int mask  = _mm_movemask_ps(_mm_and_ps(overlapX, _mm_and_ps(overlapY, overlapZ)));
+
+            while (mask != 0) {
+                ocUInt32 iLane = 0;
+                while ((mask & (1 << iLane)) == 0) iLane += 1;
+                mask &= ~(1 << iLane);
+
+                if (ocBroadphaseIsPairReported(pFlags[i], pFlags[j + iLane])) {
+                    result = ocBroadphaseAddPair(pIndices[pOrder[i]], pIndices[pOrder[j + iLane]], pPairs);
+                    if (result != OC_SUCCESS) {
+                        return result;
+                    }
+                }
+            }
+
+            if (maskX != 0xF) {
+                break;
+            }
+
+            j += 4;
+        }
+#else
+        for (; j < count && pMinX[j] <= maxX; ++j) {
+            if (pMinY[j] <= pMaxY[i] && pMaxY[j] >= pMinY[i] && pMinZ[j] <= pMaxZ[i] && pMaxZ[j] >= pMinZ[i]) {
+                if (ocBroadphaseIsPairReported(pFlags[i], pFlags[j])) {
+                    result = ocBroadphaseAddPair(pIndices[pOrder[i]], pIndices[pOrder[j]], pPairs);
+                    if (result != OC_SUCCESS) {
+                        return result;
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+    // Active bodies against the tree. Everything in the tree is passive, so there's nothing to do when every body in the sweep is too.
+    if (pBroadphase->tree.nodes.count > 0 && activeCount > 0) {
+        ocBroadphaseTreeQuery query;
+        query.pBroadphase = pBroadphase;
+        query.pBounds     = pBounds;
+        query.pPairs      = pPairs;
+        query.pIndices    = NULL;
+        query.result      = OC_SUCCESS;
+
+        for (ocUInt32 i = 0; i < count; ++i) {
+            if ((pFlags[i] & OC_BROADPHASE_FLAG_PASSIVE) != 0) {
+                continue;
+            }
+
+            query.index   = pIndices[pOrder[i]];
+            query.aabbMin = glm::vec3(pMinX[i], pMinY[i], pMinZ[i]);
+            query.aabbMax = glm::vec3(pBroadphase->pSortedMaxX[i], pMaxY[i], pMaxZ[i]);
+            ocBVHQuery(&pBroadphase->tree, query.aabbMin, query.aabbMax, ocBroadphaseTreeQueryLeaf, &query);
+            if (query.result != OC_SUCCESS) {
+                return query.result;
+            }
+        }
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocBroadphaseQuery(ocBroadphase* pBroadphase, const ocBroadphaseBounds* pBounds, const glm::vec3 &aabbMin, const glm::vec3 &aabbMax, ocStack<ocUInt32>* pIndices)
+{
+    if (pBroadphase == NULL || pBounds == NULL || pIndices == NULL) return OC_INVALID_ARGS;
+
+    // The sweep is small, so it's just scanned. It can still have bodies that have left it since the last step, which are skipped.
+    for (ocSizeT iOrder = 0; iOrder < pBroadphase->order.count; ++iOrder) {
+        ocUInt32 id = pBroadphase->order.pItems[iOrder];
+        if (!pBroadphase->proxies.pItems[id].isInSweep) {
+            continue;
+        }
+
+        ocUInt32 index = pBounds->pIndices[id];
+        if (ocBroadphaseOverlaps(pBounds, index, aabbMin, aabbMax)) {
+            ocResult result = ocStackPush(pIndices, index);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+        }
+    }
+
+    ocBroadphaseTreeQuery query;
+    query.pBroadphase = pBroadphase;
+    query.pBounds     = pBounds;
+    query.aabbMin     = aabbMin;
+    query.aabbMax     = aabbMax;
+    query.index       = OC_BROADPHASE_NONE;
+    query.pPairs      = NULL;
+    query.pIndices    = pIndices;
+    query.result      = OC_SUCCESS;
+    ocBVHQuery(&pBroadphase->tree, aabbMin, aabbMax, ocBroadphaseTreeQueryLeaf, &query);
+
+    return query.result;
+}
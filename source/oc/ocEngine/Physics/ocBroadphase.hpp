@@ -0,0 +1,97 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Sweep and prune for active bodies, and a tree for passive ones.
+//
+// Active bodies are kept sorted along the X axis by the minimum of their bounding box. The order is kept between steps and re-sorted with
+// an insertion sort, which is close to linear since bodies don't move far in a single step. The bounds are then gathered into sorted
+// arrays and swept, testing the Y and Z axes of 4 candidates at a time.
+//
+// Passive bodies, which are static and sleeping bodies, never pair with each other and don't move, so sweeping them every step would be
+// wasted work. They're put in an ocBVH instead, and each active body looks up the passive bodies it touches in the tree. That way the
+// cost of a step depends on the number of active bodies, not the total. Rebuilding the tree is expensive, so bodies that become passive
+// are added to the sweep at first, flagged so they don't pair with each other, and only moved into the tree once enough of them have built
+// up. Bodies that leave the tree are marked as removed and skipped until the next rebuild.
+//
+// Bodies are identified by their ID in the dynamics world, which doesn't change while the body exists. The broadphase does not own any
+// bounds. They're passed in by the dynamics world every step, indexed by the position of each body in it's arrays, along with the map from
+// IDs to those positions.
+
+#define OC_BROADPHASE_FLAG_PASSIVE      0x00000001  // <-- Pairs where both bodies are passive are not reported.
+#define OC_BROADPHASE_MIN_TREE_BATCH    256         // <-- The tree is not rebuilt until at least this many passive bodies are waiting.
+#define OC_BROADPHASE_NONE              (~0U)
+
+struct ocBroadphasePair
+{
+    ocUInt32 indexA;
+    ocUInt32 indexB;
+};
+
+struct ocBroadphaseBounds
+{
+    const float* pMinX;
+    const float* pMinY;
+    const float* pMinZ;
+    const float* pMaxX;
+    const float* pMaxY;
+    const float* pMaxZ;
+    const ocUInt32* pIndices;   // <-- Maps an ID to the index of it's bounds.
+};
+
+// Where a body is in the broadphase. Indexed by ID.
+struct ocBroadphaseProxy
+{
+    ocUInt32 flags;
+    ocUInt32 treeSlot;          // <-- The position of the body in treeIDs, or OC_BROADPHASE_NONE when it's not in the tree.
+    ocBool8 isInSweep;
+    ocBool8 isInOrder;          // <-- Bodies are removed from the order lazily, so this can still be set after leaving the sweep.
+};
+
+struct ocBroadphase
+{
+    ocStack<ocBroadphaseProxy> proxies;
+    ocStack<ocUInt32> order;    // <-- The IDs of the bodies in the sweep, sorted by the minimum X of their bounds as of the last step.
+
+    // The bounds in sorted order, gathered each step. Every array is sortedCapacity long, including padding, and they're all carved out
+    // of pSortedData.
+    ocUInt32 sortedCapacity;
+    void* pSortedData;
+    float* pSortedMinX;
+    float* pSortedMinY;
+    float* pSortedMinZ;
+    float* pSortedMaxX;
+    float* pSortedMaxY;
+    float* pSortedMaxZ;
+    ocUInt32* pSortedFlags;
+
+    // Passive bodies. The items of the tree are positions in treeIDs, which are OC_BROADPHASE_NONE for bodies that have left the tree
+    // since it was built.
+    ocBVH tree;
+    ocStack<ocUInt32> treeIDs;
+    ocUInt32 treeRemovedCount;
+    ocUInt32 sweepPassiveCount;             // <-- Passive bodies in the sweep that are waiting to be moved into the tree.
+    ocStack<glm::vec3> treeBoundsMin;       // <-- Working memory for rebuilding the tree.
+    ocStack<glm::vec3> treeBoundsMax;
+};
+
+//
+ocResult ocBroadphaseInit(ocBroadphase* pBroadphase);
+
+//
+void ocBroadphaseUninit(ocBroadphase* pBroadphase);
+
+// Adds a body. It's bounds must be valid by the next call to ocBroadphaseFindPairs().
+ocResult ocBroadphaseInsert(ocBroadphase* pBroadphase, ocUInt32 id, ocBool32 isPassive);
+
+//
+void ocBroadphaseRemove(ocBroadphase* pBroadphase, ocUInt32 id);
+
+// Changes whether or not a body is passive. This must also be called when a passive body is moved, with isPassive still set, so the tree
+// doesn't keep it's old bounds.
+ocResult ocBroadphaseSetPassive(ocBroadphase* pBroadphase, ocUInt32 id, ocBool32 isPassive);
+
+// Finds every pair of bodies with overlapping bounds where at least one of them is active. Pairs are appended to pPairs, with
+// indexA < indexB.
+ocResult ocBroadphaseFindPairs(ocBroadphase* pBroadphase, const ocBroadphaseBounds* pBounds, ocStack<ocBroadphasePair>* pPairs);
+
+// Finds every body whose bounds overlap a box, active or passive. The indices of the bodies are appended to pIndices.
+ocResult ocBroadphaseQuery(ocBroadphase* pBroadphase, const ocBroadphaseBounds* pBounds, const glm::vec3 &aabbMin, const glm::vec3 &aabbMax, ocStack<ocUInt32>* pIndices);
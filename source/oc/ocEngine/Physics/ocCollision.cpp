@@ -0,0 +1,1838 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_COLLISION_EPSILON                1e-6f
+#define OC_COLLISION_FEATURE_TOLERANCE      0.02f   // <-- Vertices this close to the furthest one, relative to the size of the shape, are part of the same face.
+#define OC_COLLISION_INTERIOR_SCALE         0.9f    // <-- How far towards it's surface the interior point of a shape can be moved for MPR.
+#define OC_COLLISION_BOX_FACE_TOLERANCE     0.995f  // <-- The cosine of the angle within which a box face is treated as lying flat against a surface.
+#define OC_COLLISION_PARALLEL_TOLERANCE     0.05f   // <-- The sine of the angle at which a capsule is treated as lying flat against a surface.
+
+ocResult ocConvexHullInit(const float* pPoints, ocUInt32 pointCount, ocConvexHull* pHull)
+{
+    if (pHull == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pHull);
+
+    if (pPoints == NULL || pointCount == 0) return OC_INVALID_ARGS;
+
+    // The three arrays are one allocation. Padding is done by repeating the first vertex so it never changes the result of a support query.
+    ocUInt32 paddedCount = (pointCount + 3) & ~3U;
+    float* pData = (float*)ocMalloc(paddedCount * 3 * sizeof(float));
+    if (pData == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pHull->pVerticesX  = pData;
+    pHull->pVerticesY  = pData + paddedCount;
+    pHull->pVerticesZ  = pData + paddedCount*2;
+    pHull->vertexCount = pointCount;
+
+    glm::vec3 sum = glm::vec3(0, 0, 0);
+    pHull->aabbMin = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    pHull->aabbMax = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (ocUInt32 iVertex = 0; iVertex < paddedCount; ++iVertex) {
+        ocUInt32 iPoint = (iVertex < pointCount) ? iVertex : 0;
+        glm::vec3 point = glm::vec3(pPoints[iPoint*3 + 0], pPoints[iPoint*3 + 1], pPoints[iPoint*3 + 2]);
+
+        pHull->pVerticesX[iVertex] = point.x;
+        pHull->pVerticesY[iVertex] = point.y;
+        pHull->pVerticesZ[iVertex] = point.z;
+
+        if (iVertex < pointCount) {
+            sum += point;
+            pHull->aabbMin = glm::min(pHull->aabbMin, point);
+            pHull->aabbMax = glm::max(pHull->aabbMax, point);
+        }
+    }
+
+    pHull->center = sum / (float)pointCount;
+
+    return OC_SUCCESS;
+}
+
+void ocConvexHullUninit(ocConvexHull* pHull)
+{
+    if (pHull == NULL) return;
+
+    ocFree(pHull->pVerticesX);  // <-- The start of the allocation.
+    ocZeroObject(pHull);
+}
+
+ocUInt32 ocConvexHullSupport(const ocConvexHull* pHull, const glm::vec3 &direction)
+{
+    ocAssert(pHull != NULL);
+
+    ocUInt32 paddedCount = (pHull->vertexCount + 3) & ~3U;
+    ocUInt32 bestIndex = 0;
+    float bestDot = -FLT_MAX;
+
+#ifdef OC_SUPPORT_SSE2
+    // Each lane tracks it's own best vertex, and the lanes are compared at the end.
+    __m128 dirX = _mm_set1_ps(direction.x);
+    __m128 dirY = _mm_set1_ps(direction.y);
+    __m128 dirZ = _mm_set1_ps(direction.z);
+    __m128 laneBestDot = _mm_set1_ps(-FLT_MAX);
+    __m128i laneBestIndex = _mm_setzero_si128();
+    __m128i laneIndex = _mm_set_epi32(3, 2, 1, 0);
+    __m128i four = _mm_set1_epi32(4);
+
+    for (ocUInt32 iVertex = 0; iVertex < paddedCount; iVertex += 4) {
+        __m128 dot = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(_mm_loadu_ps(pHull->pVerticesX + iVertex), dirX),
+            _mm_mul_ps(_mm_loadu_ps(pHull->pVerticesY + iVertex), dirY)),
+            _mm_mul_ps(_mm_loadu_ps(pHull->pVerticesZ + iVertex), dirZ));
+
+        __m128i isBetter = _mm_castps_si128(_mm_cmpgt_ps(dot, laneBestDot));
+        laneBestDot   = _mm_max_ps(dot, laneBestDot);
+        laneBestIndex = _mm_or_si128(_mm_and_si128(isBetter, laneIndex), _mm_andnot_si128(isBetter, laneBestIndex));
+        laneIndex     = _mm_add_epi32(laneIndex, four);
+    }
+
+    float lanesDot[4];
+    ocInt32 lanesIndex[4];
+    _mm_storeu_ps(lanesDot, laneBestDot);
+    _mm_storeu_si128((__m128i*)lanesIndex, laneBestIndex);
+    for (ocUInt32 iLane = 0; iLane < 4; ++iLane) {
+        if (lanesDot[iLane] > bestDot || (lanesDot[iLane] == bestDot && (ocUInt32)lanesIndex[iLane] < bestIndex)) {
+            bestDot   = lanesDot[iLane];
+            bestIndex = (ocUInt32)lanesIndex[iLane];
+        }
+    }
+#else
+    for (ocUInt32 iVertex = 0; iVertex < paddedCount; ++iVertex) {
+        float dot = pHull->pVerticesX[iVertex]*direction.x + pHull->pVerticesY[iVertex]*direction.y + pHull->pVerticesZ[iVertex]*direction.z;
+        if (dot > bestDot) {
+            bestDot   = dot;
+            bestIndex = iVertex;
+        }
+    }
+#endif
+
+    return (bestIndex < pHull->vertexCount) ? bestIndex : 0;  // <-- Padding is a copy of vertex 0.
+}
+
+
+ocCollisionShape ocCollisionShapeSphere(float radius)
+{
+    ocCollisionShape shape;
+    ocZeroObject(&shape);
+    shape.type = ocCollisionShapeType_Sphere;
+    shape.sphere.radius = radius;
+    return shape;
+}
+
+ocCollisionShape ocCollisionShapeCapsule(float radius, float halfHeight)
+{
+    ocCollisionShape shape;
+    ocZeroObject(&shape);
+    shape.type = ocCollisionShapeType_Capsule;
+    shape.capsule.radius     = radius;
+    shape.capsule.halfHeight = halfHeight;
+    return shape;
+}
+
+ocCollisionShape ocCollisionShapeBox(const glm::vec3 &halfExtents)
+{
+    ocCollisionShape shape;
+    ocZeroObject(&shape);
+    shape.type = ocCollisionShapeType_Box;
+    shape.box.halfExtents[0] = halfExtents.x;
+    shape.box.halfExtents[1] = halfExtents.y;
+    shape.box.halfExtents[2] = halfExtents.z;
+    return shape;
+}
+
+ocCollisionShape ocCollisionShapeConvexHull(const ocConvexHull* pHull)
+{
+    ocCollisionShape shape;
+    ocZeroObject(&shape);
+    shape.type = ocCollisionShapeType_ConvexHull;
+    shape.convexHull.pHull = pHull;
+    return shape;
+}
+
+ocCollisionShape ocCollisionShapeTriangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+{
+    ocCollisionShape shape;
+    ocZeroObject(&shape);
+    shape.type = ocCollisionShapeType_Triangle;
+    for (int i = 0; i < 3; ++i) {
+        shape.triangle.vertices[0 + i] = a[i];
+        shape.triangle.vertices[3 + i] = b[i];
+        shape.triangle.vertices[6 + i] = c[i];
+    }
+    return shape;
+}
+
+ocCollisionShape ocCollisionShapeTriangleMesh(const ocTriangleMesh* pMesh)
+{
+    ocCollisionShape shape;
+    ocZeroObject(&shape);
+    shape.type = ocCollisionShapeType_TriangleMesh;
+    shape.triangleMesh.pMesh = pMesh;
+    return shape;
+}
+
+OC_INLINE glm::vec3 ocCollisionTriangleVertex(const ocCollisionShape* pShape, ocUInt32 index)
+{
+    return glm::vec3(pShape->triangle.vertices[index*3 + 0], pShape->triangle.vertices[index*3 + 1], pShape->triangle.vertices[index*3 + 2]);
+}
+
+// The extents of a rotated box. Each world axis is the sum of the projections of the box's axes onto it.
+OC_INLINE glm::vec3 ocCollisionRotateExtents(const glm::quat &rotation, const glm::vec3 &halfExtents)
+{
+    glm::mat3 m = glm::mat3_cast(rotation);
+    return glm::abs(m[0])*halfExtents.x + glm::abs(m[1])*halfExtents.y + glm::abs(m[2])*halfExtents.z;
+}
+
+void ocCollisionShapeGetAABB(const ocCollisionShape* pShape, const glm::vec3 &position, const glm::quat &rotation, glm::vec3 &aabbMin, glm::vec3 &aabbMax)
+{
+    ocAssert(pShape != NULL);
+
+    glm::vec3 center = position;
+    glm::vec3 extents;
+    switch (pShape->type)
+    {
+        case ocCollisionShapeType_Sphere:
+        {
+            extents = glm::vec3(pShape->sphere.radius);
+        } break;
+
+        case ocCollisionShapeType_Capsule:
+        {
+            extents = glm::abs(rotation * glm::vec3(0, pShape->capsule.halfHeight, 0)) + glm::vec3(pShape->capsule.radius);
+        } break;
+
+        case ocCollisionShapeType_Box:
+        {
+            extents = ocCollisionRotateExtents(rotation, glm::vec3(pShape->box.halfExtents[0], pShape->box.halfExtents[1], pShape->box.halfExtents[2]));
+        } break;
+
+        case ocCollisionShapeType_Triangle:
+        {
+            glm::vec3 a = rotation * ocCollisionTriangleVertex(pShape, 0);
+            glm::vec3 b = rotation * ocCollisionTriangleVertex(pShape, 1);
+            glm::vec3 c = rotation * ocCollisionTriangleVertex(pShape, 2);
+            aabbMin = position + glm::min(glm::min(a, b), c);
+            aabbMax = position + glm::max(glm::max(a, b), c);
+        } return;
+
+        case ocCollisionShapeType_TriangleMesh:
+        {
+            const ocTriangleMesh* pMesh = pShape->triangleMesh.pMesh;
+            center  = position + rotation * ((pMesh->bvh.aabbMin + pMesh->bvh.aabbMax) * 0.5f);
+            extents = ocCollisionRotateExtents(rotation, (pMesh->bvh.aabbMax - pMesh->bvh.aabbMin) * 0.5f);
+        } break;
+
+        case ocCollisionShapeType_ConvexHull:
+        default:
+        {
+            const ocConvexHull* pHull = pShape->convexHull.pHull;
+            center  = position + rotation * ((pHull->aabbMin + pHull->aabbMax) * 0.5f);
+            extents = ocCollisionRotateExtents(rotation, (pHull->aabbMax - pHull->aabbMin) * 0.5f);
+        } break;
+    }
+
+    aabbMin = center - extents;
+    aabbMax = center + extents;
+}
+
+glm::vec3 ocCollisionShapeGetInertia(const ocCollisionShape* pShape, float mass)
+{
+    ocAssert(pShape != NULL);
+
+    switch (pShape->type)
+    {
+        case ocCollisionShapeType_Sphere:
+        {
+            float r = pShape->sphere.radius;
+            return glm::vec3(0.4f * mass * r*r);
+        }
+
+        case ocCollisionShapeType_Capsule:
+        {
+            // A cylinder with a hemisphere on each end. The mass is split between them by volume.
+            float r = pShape->capsule.radius;
+            float h = pShape->capsule.halfHeight * 2;
+            float cylinderVolume = 3.14159265f * r*r * h;
+            float sphereVolume   = 3.14159265f * r*r*r * (4.0f/3.0f);
+            float cylinderMass   = mass * cylinderVolume / (cylinderVolume + sphereVolume);
+            float sphereMass     = mass - cylinderMass;
+
+            float iy = cylinderMass*r*r*0.5f + sphereMass*r*r*0.4f;
+            float ix = cylinderMass*(h*h/12 + r*r/4) + sphereMass*(r*r*0.4f + h*h/4 + h*r*3/8);
+            return glm::vec3(ix, iy, ix);
+        }
+
+        case ocCollisionShapeType_Box:
+        case ocCollisionShapeType_ConvexHull:
+        default:
+        {
+            glm::vec3 e;
+            if (pShape->type == ocCollisionShapeType_Box) {
+                e = glm::vec3(pShape->box.halfExtents[0], pShape->box.halfExtents[1], pShape->box.halfExtents[2]);
+            } else {
+                glm::vec3 aabbMin;
+                glm::vec3 aabbMax;
+                ocCollisionShapeGetAABB(pShape, glm::vec3(0, 0, 0), glm::quat(1, 0, 0, 0), aabbMin, aabbMax);
+                e = (aabbMax - aabbMin) * 0.5f;
+            }
+
+            return glm::vec3(e.y*e.y + e.z*e.z, e.x*e.x + e.z*e.z, e.x*e.x + e.y*e.y) * (mass / 3);
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Spheres and Capsules
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Spheres and capsules are a segment with a radius. A sphere's segment has zero length.
+OC_PRIVATE void ocCollisionGetSegment(const ocCollisionObject* pObject, glm::vec3 &p0, glm::vec3 &p1, float &radius)
+{
+    if (pObject->pShape->type == ocCollisionShapeType_Sphere) {
+        p0 = pObject->position;
+        p1 = pObject->position;
+        radius = pObject->pShape->sphere.radius;
+    } else {
+        glm::vec3 axis = pObject->rotation * glm::vec3(0, pObject->pShape->capsule.halfHeight, 0);
+        p0 = pObject->position - axis;
+        p1 = pObject->position + axis;
+        radius = pObject->pShape->capsule.radius;
+    }
+}
+
+// Finds the closest points between two segments. From Real-Time Collision Detection by Christer Ericson.
+OC_PRIVATE void ocCollisionClosestPointsSegmentSegment(const glm::vec3 &p1, const glm::vec3 &q1, const glm::vec3 &p2, const glm::vec3 &q2, glm::vec3 &c1, glm::vec3 &c2)
+{
+    glm::vec3 d1 = q1 - p1;
+    glm::vec3 d2 = q2 - p2;
+    glm::vec3 r  = p1 - p2;
+    float a = glm::dot(d1, d1);
+    float e = glm::dot(d2, d2);
+    float f = glm::dot(d2, r);
+    float s;
+    float t;
+
+    if (a <= OC_COLLISION_EPSILON && e <= OC_COLLISION_EPSILON) {
+        s = 0;
+        t = 0;
+    } else if (a <= OC_COLLISION_EPSILON) {
+        s = 0;
+        t = ocClamp(f / e, 0.0f, 1.0f);
+    } else {
+        float c = glm::dot(d1, r);
+        if (e <= OC_COLLISION_EPSILON) {
+            t = 0;
+            s = ocClamp(-c / a, 0.0f, 1.0f);
+        } else {
+            float b = glm::dot(d1, d2);
+            float denom = a*e - b*b;
+            s = (denom > OC_COLLISION_EPSILON) ? ocClamp((b*f - c*e) / denom, 0.0f, 1.0f) : 0;  // <-- Parallel segments use any point.
+            t = (b*s + f) / e;
+            if (t < 0) {
+                t = 0;
+                s = ocClamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1) {
+                t = 1;
+                s = ocClamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    c1 = p1 + d1*s;
+    c2 = p2 + d2*t;
+}
+
+OC_PRIVATE ocBool32 ocCollideRounded(const ocCollisionObject* pA, const ocCollisionObject* pB, float margin, ocContactManifold* pManifold)
+{
+    glm::vec3 a0, a1, b0, b1;
+    float radiusA, radiusB;
+    ocCollisionGetSegment(pA, a0, a1, radiusA);
+    ocCollisionGetSegment(pB, b0, b1, radiusB);
+
+    glm::vec3 closestA, closestB;
+    ocCollisionClosestPointsSegmentSegment(a0, a1, b0, b1, closestA, closestB);
+
+    glm::vec3 delta = closestB - closestA;
+    float distance = glm::length(delta);
+    float separation = distance - radiusA - radiusB;
+    if (separation >= margin) {
+        return OC_FALSE;
+    }
+
+    // Cores that touch have no direction between them, in which case any direction will do.
+    glm::vec3 normal = (distance > OC_COLLISION_EPSILON) ? delta / distance : glm::vec3(0, 1, 0);
+
+    pManifold->normal = normal;
+    pManifold->pointCount = 1;
+    pManifold->points[0].position   = closestA + normal*(radiusA + separation*0.5f);
+    pManifold->points[0].separation = separation;
+
+    return OC_TRUE;
+}
+
+void ocCollideSpheres(const ocSpherePairs* pPairs, ocUInt32 count, float margin, ocContactManifold* pManifolds)
+{
+    ocAssert(pPairs != NULL);
+    ocAssert(pManifolds != NULL || count == 0);
+
+    ocUInt32 iPair = 0;
+
+#ifdef OC_SUPPORT_SSE2
+    __m128 vMargin  = _mm_set1_ps(margin);
+    __m128 vEpsilon = _mm_set1_ps(OC_COLLISION_EPSILON);
+    __m128 vOne     = _mm_set1_ps(1);
+    __m128 vHalf    = _mm_set1_ps(0.5f);
+
+    for (; iPair + 4 <= count; iPair += 4) {
+        __m128 ax = _mm_loadu_ps(pPairs->pCenterAX + iPair);
+        __m128 ay = _mm_loadu_ps(pPairs->pCenterAY + iPair);
+        __m128 az = _mm_loadu_ps(pPairs->pCenterAZ + iPair);
+        __m128 ar = _mm_loadu_ps(pPairs->pRadiusA  + iPair);
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(pPairs->pCenterBX + iPair), ax);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(pPairs->pCenterBY + iPair), ay);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(pPairs->pCenterBZ + iPair), az);
+
+        __m128 distance   = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        __m128 separation = _mm_sub_ps(_mm_sub_ps(distance, ar), _mm_loadu_ps(pPairs->pRadiusB + iPair));
+        int isTouching = _mm_movemask_ps(_mm_cmplt_ps(separation, vMargin));
+        if (isTouching == 0) {
+            for (ocUInt32 iLane = 0; iLane < 4; ++iLane) {
+                pManifolds[iPair + iLane].pointCount = 0;
+            }
+            continue;
+        }
+
+        // Coincident centers get a normal pointing up, the same as ocCollideRounded().
+        __m128 hasDirection = _mm_cmpgt_ps(distance, vEpsilon);
+        __m128 invDistance  = _mm_and_ps(hasDirection, _mm_div_ps(vOne, _mm_max_ps(distance, vEpsilon)));
+        __m128 nx = _mm_mul_ps(dx, invDistance);
+        __m128 ny = _mm_or_ps(_mm_mul_ps(dy, invDistance), _mm_andnot_ps(hasDirection, vOne));
+        __m128 nz = _mm_mul_ps(dz, invDistance);
+
+        __m128 offset = _mm_add_ps(ar, _mm_mul_ps(separation, vHalf));
+        float px[4], py[4], pz[4], normalX[4], normalY[4], normalZ[4], s[4];
+        _mm_storeu_ps(px, _mm_add_ps(ax, _mm_mul_ps(nx, offset)));
+        _mm_storeu_ps(py, _mm_add_ps(ay, _mm_mul_ps(ny, offset)));
+        _mm_storeu_ps(pz, _mm_add_ps(az, _mm_mul_ps(nz, offset)));
+        _mm_storeu_ps(normalX, nx);
+        _mm_storeu_ps(normalY, ny);
+        _mm_storeu_ps(normalZ, nz);
+        _mm_storeu_ps(s, separation);
+
+        for (ocUInt32 iLane = 0; iLane < 4; ++iLane) {
+            ocContactManifold* pManifold = &pManifolds[iPair + iLane];
+            if ((isTouching & (1 << iLane)) == 0) {
+                pManifold->pointCount = 0;
+                continue;
+            }
+
+            pManifold->normal = glm::vec3(normalX[iLane], normalY[iLane], normalZ[iLane]);
+            pManifold->pointCount = 1;
+            pManifold->points[0].position   = glm::vec3(px[iLane], py[iLane], pz[iLane]);
+            pManifold->points[0].separation = s[iLane];
+        }
+    }
+#endif
+
+    for (; iPair < count; ++iPair) {
+        ocCollisionShape shapeA = ocCollisionShapeSphere(pPairs->pRadiusA[iPair]);
+        ocCollisionShape shapeB = ocCollisionShapeSphere(pPairs->pRadiusB[iPair]);
+        ocCollisionObject a = {&shapeA, glm::vec3(pPairs->pCenterAX[iPair], pPairs->pCenterAY[iPair], pPairs->pCenterAZ[iPair]), glm::quat(1, 0, 0, 0)};
+        ocCollisionObject b = {&shapeB, glm::vec3(pPairs->pCenterBX[iPair], pPairs->pCenterBY[iPair], pPairs->pCenterBZ[iPair]), glm::quat(1, 0, 0, 0)};
+
+        pManifolds[iPair].pointCount = 0;
+        ocCollideRounded(&a, &b, margin, &pManifolds[iPair]);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Minkowski Portal Refinement
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Support points exclude the radius of spheres and capsules. The radius is added on by ocCollisionSupport().
+OC_PRIVATE glm::vec3 ocCollisionSupportLocal(const ocCollisionShape* pShape, const glm::vec3 &direction)
+{
+    switch (pShape->type)
+    {
+        case ocCollisionShapeType_Sphere:
+        {
+            return glm::vec3(0, 0, 0);
+        }
+
+        case ocCollisionShapeType_Capsule:
+        {
+            return glm::vec3(0, (direction.y >= 0) ? pShape->capsule.halfHeight : -pShape->capsule.halfHeight, 0);
+        }
+
+        case ocCollisionShapeType_Box:
+        {
+            return glm::vec3(
+                (direction.x >= 0) ? pShape->box.halfExtents[0] : -pShape->box.halfExtents[0],
+                (direction.y >= 0) ? pShape->box.halfExtents[1] : -pShape->box.halfExtents[1],
+                (direction.z >= 0) ? pShape->box.halfExtents[2] : -pShape->box.halfExtents[2]);
+        }
+
+        case ocCollisionShapeType_Triangle:
+        {
+            glm::vec3 a = ocCollisionTriangleVertex(pShape, 0);
+            glm::vec3 b = ocCollisionTriangleVertex(pShape, 1);
+            glm::vec3 c = ocCollisionTriangleVertex(pShape, 2);
+            float da = glm::dot(a, direction);
+            float db = glm::dot(b, direction);
+            float dc = glm::dot(c, direction);
+            if (da >= db && da >= dc) return a;
+            return (db >= dc) ? b : c;
+        }
+
+        case ocCollisionShapeType_TriangleMesh:
+        {
+            ocAssert(OC_FALSE);     // <-- Not convex. Meshes are collided one triangle at a time.
+            return glm::vec3(0, 0, 0);
+        }
+
+        case ocCollisionShapeType_ConvexHull:
+        default:
+        {
+            const ocConvexHull* pHull = pShape->convexHull.pHull;
+            ocUInt32 iVertex = ocConvexHullSupport(pHull, direction);
+            return glm::vec3(pHull->pVerticesX[iVertex], pHull->pVerticesY[iVertex], pHull->pVerticesZ[iVertex]);
+        }
+    }
+}
+
+// The closest point on a triangle to the origin. From Real-Time Collision Detection by Christer Ericson.
+OC_PRIVATE glm::vec3 ocCollisionClosestPointTriangleToOrigin(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c)
+{
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+    glm::vec3 ap = -a;
+
+    float d1 = glm::dot(ab, ap);
+    float d2 = glm::dot(ac, ap);
+    if (d1 <= 0 && d2 <= 0) return a;
+
+    glm::vec3 bp = -b;
+    float d3 = glm::dot(ab, bp);
+    float d4 = glm::dot(ac, bp);
+    if (d3 >= 0 && d4 <= d3) return b;
+
+    float vc = d1*d4 - d3*d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    glm::vec3 cp = -c;
+    float d5 = glm::dot(ab, cp);
+    float d6 = glm::dot(ac, cp);
+    if (d6 >= 0 && d5 <= d6) return c;
+
+    float vb = d5*d2 - d1*d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    float va = d3*d6 - d5*d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    float denom = 1 / (va + vb + vc);
+    return a + ab*(vb*denom) + ac*(vc*denom);
+}
+
+OC_INLINE float ocCollisionShapeRadius(const ocCollisionShape* pShape)
+{
+    if (pShape->type == ocCollisionShapeType_Sphere)  return pShape->sphere.radius;
+    if (pShape->type == ocCollisionShapeType_Capsule) return pShape->capsule.radius;
+    return 0;
+}
+
+// The world space support point of an object in the given direction, which must be normalized. The object is inflated by extraRadius.
+OC_PRIVATE glm::vec3 ocCollisionSupport(const ocCollisionObject* pObject, const glm::vec3 &direction, float extraRadius)
+{
+    glm::vec3 localDirection = glm::conjugate(pObject->rotation) * direction;
+    glm::vec3 point = pObject->position + pObject->rotation * ocCollisionSupportLocal(pObject->pShape, localDirection);
+    return point + direction * (ocCollisionShapeRadius(pObject->pShape) + extraRadius);
+}
+
+// The center of an object's shape, which is not always at the position of the object.
+OC_PRIVATE glm::vec3 ocCollisionCenter(const ocCollisionObject* pObject)
+{
+    const ocCollisionShape* pShape = pObject->pShape;
+    if (pShape->type == ocCollisionShapeType_ConvexHull) {
+        return pObject->position + pObject->rotation * pShape->convexHull.pHull->center;
+    }
+
+    if (pShape->type == ocCollisionShapeType_Triangle) {
+        glm::vec3 centroid = (ocCollisionTriangleVertex(pShape, 0) + ocCollisionTriangleVertex(pShape, 1) + ocCollisionTriangleVertex(pShape, 2)) * (1.0f/3);
+        return pObject->position + pObject->rotation * centroid;
+    }
+
+    return pObject->position;
+}
+
+// A point inside an object, as close to the target as is cheap to find. MPR searches along the ray from the interior point of the
+// Minkowski difference towards the origin, and it's results are only accurate when that ray passes close to the contact. Using the
+// centers of the objects goes wrong when one of them is large, such as a small box resting near the edge of a large floor, so the
+// point is moved towards the other object instead. It's kept slightly inside the shape so it's never on the surface.
+OC_PRIVATE glm::vec3 ocCollisionInteriorPoint(const ocCollisionObject* pObject, const glm::vec3 &target)
+{
+    const ocCollisionShape* pShape = pObject->pShape;
+    glm::vec3 localTarget = glm::conjugate(pObject->rotation) * (target - pObject->position);
+
+    if (pShape->type == ocCollisionShapeType_Box) {
+        glm::vec3 localPoint;
+        for (int i = 0; i < 3; ++i) {
+            float extent = pShape->box.halfExtents[i] * OC_COLLISION_INTERIOR_SCALE;
+            localPoint[i] = ocClamp(localTarget[i], -extent, extent);
+        }
+
+        return pObject->position + pObject->rotation * localPoint;
+    }
+
+    if (pShape->type == ocCollisionShapeType_Capsule) {
+        float extent = pShape->capsule.halfHeight * OC_COLLISION_INTERIOR_SCALE;
+        return pObject->position + pObject->rotation * glm::vec3(0, ocClamp(localTarget.y, -extent, extent), 0);
+    }
+
+    if (pShape->type == ocCollisionShapeType_ConvexHull) {
+        return pObject->position + pObject->rotation * pShape->convexHull.pHull->center;
+    }
+
+    if (pShape->type == ocCollisionShapeType_Triangle) {
+        glm::vec3 a = ocCollisionTriangleVertex(pShape, 0);
+        glm::vec3 b = ocCollisionTriangleVertex(pShape, 1);
+        glm::vec3 c = ocCollisionTriangleVertex(pShape, 2);
+        glm::vec3 centroid = (a + b + c) * (1.0f/3);
+        glm::vec3 closest  = ocCollisionClosestPointTriangleToOrigin(a - localTarget, b - localTarget, c - localTarget) + localTarget;
+        return pObject->position + pObject->rotation * (centroid + (closest - centroid)*OC_COLLISION_INTERIOR_SCALE);
+    }
+
+    return pObject->position;
+}
+
+// A vertex of the Minkowski difference A - B, along with the points on each shape that it came from.
+struct ocMPRVertex
+{
+    glm::vec3 v;
+    glm::vec3 a;
+    glm::vec3 b;
+};
+
+struct ocMPRContext
+{
+    const ocCollisionObject* pA;
+    const ocCollisionObject* pB;
+    float margin;               // <-- A is inflated by this much so shapes that are close, but not touching, are still found.
+    ocMPRVertex portal[4];      // <-- [0] is the interior point. [1], [2] and [3] are the portal.
+};
+
+OC_PRIVATE void ocMPRSupport(ocMPRContext* pContext, const glm::vec3 &direction, ocMPRVertex* pVertex)
+{
+    pVertex->a = ocCollisionSupport(pContext->pA,  direction, pContext->margin);
+    pVertex->b = ocCollisionSupport(pContext->pB, -direction, 0);
+    pVertex->v = pVertex->a - pVertex->b;
+}
+
+OC_INLINE ocBool32 ocMPRIsZero(float x)
+{
+    return fabsf(x) < OC_COLLISION_EPSILON;
+}
+
+OC_PRIVATE glm::vec3 ocMPRPortalDirection(const ocMPRContext* pContext)
+{
+    const ocMPRVertex* p = pContext->portal;
+    glm::vec3 direction = glm::cross(p[2].v - p[1].v, p[3].v - p[1].v);
+    float length = glm::length(direction);
+    return (length > 0) ? direction / length : direction;
+}
+
+OC_PRIVATE void ocMPRExpandPortal(ocMPRContext* pContext, const ocMPRVertex &v4)
+{
+    ocMPRVertex* p = pContext->portal;
+    glm::vec3 v4v0 = glm::cross(v4.v, p[0].v);
+
+    if (glm::dot(p[1].v, v4v0) > 0) {
+        if (glm::dot(p[2].v, v4v0) > 0) {
+            p[1] = v4;
+        } else {
+            p[3] = v4;
+        }
+    } else {
+        if (glm::dot(p[3].v, v4v0) > 0) {
+            p[2] = v4;
+        } else {
+            p[1] = v4;
+        }
+    }
+}
+
+OC_PRIVATE ocBool32 ocMPRReachedTolerance(const ocMPRContext* pContext, const ocMPRVertex &v4, const glm::vec3 &direction)
+{
+    float dv4 = glm::dot(v4.v, direction);
+    float d1  = dv4 - glm::dot(pContext->portal[1].v, direction);
+    float d2  = dv4 - glm::dot(pContext->portal[2].v, direction);
+    float d3  = dv4 - glm::dot(pContext->portal[3].v, direction);
+    return ocMin(d1, ocMin(d2, d3)) <= OC_COLLISION_MPR_TOLERANCE;
+}
+
+// Finds the initial portal. Returns -1 if the shapes are separated, 0 if a portal was found, 1 if the origin is on the first support
+// point, and 2 if the origin is on the segment between the interior point and the first support point.
+OC_PRIVATE int ocMPRDiscoverPortal(ocMPRContext* pContext)
+{
+    ocMPRVertex* p = pContext->portal;
+
+    p[0].a = ocCollisionInteriorPoint(pContext->pA, ocCollisionCenter(pContext->pB));
+    p[0].b = ocCollisionInteriorPoint(pContext->pB, p[0].a);
+    p[0].v = p[0].a - p[0].b;
+    if (glm::dot(p[0].v, p[0].v) < OC_COLLISION_EPSILON*OC_COLLISION_EPSILON) {
+        p[0].v.x += OC_COLLISION_EPSILON*10;   // <-- The interior point must not be at the origin.
+    }
+
+    glm::vec3 direction = glm::normalize(-p[0].v);
+    ocMPRSupport(pContext, direction, &p[1]);
+    if (glm::dot(p[1].v, direction) <= 0) {
+        return -1;
+    }
+
+    direction = glm::cross(p[0].v, p[1].v);
+    if (glm::dot(direction, direction) < OC_COLLISION_EPSILON*OC_COLLISION_EPSILON) {
+        return (glm::dot(p[1].v, p[1].v) < OC_COLLISION_EPSILON*OC_COLLISION_EPSILON) ? 1 : 2;
+    }
+
+    direction = glm::normalize(direction);
+    ocMPRSupport(pContext, direction, &p[2]);
+    if (glm::dot(p[2].v, direction) <= 0) {
+        return -1;
+    }
+
+    direction = glm::normalize(glm::cross(p[1].v - p[0].v, p[2].v - p[0].v));
+    if (glm::dot(direction, p[0].v) > 0) {
+        ocMPRVertex temp = p[1];
+        p[1] = p[2];
+        p[2] = temp;
+        direction = -direction;
+    }
+
+    for (ocUInt32 iIteration = 0; iIteration < OC_COLLISION_MPR_MAX_ITERATIONS; ++iIteration) {
+        ocMPRSupport(pContext, direction, &p[3]);
+        if (glm::dot(p[3].v, direction) <= 0) {
+            return -1;
+        }
+
+        // If the origin is outside either of the new faces, the opposite vertex is replaced and we try again.
+        if (glm::dot(glm::cross(p[1].v, p[3].v), p[0].v) < -OC_COLLISION_EPSILON) {
+            p[2] = p[3];
+        } else if (glm::dot(glm::cross(p[3].v, p[2].v), p[0].v) < -OC_COLLISION_EPSILON) {
+            p[1] = p[3];
+        } else {
+            return 0;
+        }
+
+        glm::vec3 normal = glm::cross(p[1].v - p[0].v, p[2].v - p[0].v);
+        float length = glm::length(normal);
+        if (length < OC_COLLISION_EPSILON) {
+            return -1;  // <-- Degenerate. Treated as not touching.
+        }
+
+        direction = normal / length;
+    }
+
+    return -1;
+}
+
+// Moves the portal towards the origin until the origin is inside it, or it can be shown that the origin is outside the shape.
+OC_PRIVATE ocBool32 ocMPRRefinePortal(ocMPRContext* pContext)
+{
+    for (ocUInt32 iIteration = 0; iIteration < OC_COLLISION_MPR_MAX_ITERATIONS; ++iIteration) {
+        glm::vec3 direction = ocMPRPortalDirection(pContext);
+        if (glm::dot(pContext->portal[1].v, direction) >= 0) {
+            return OC_TRUE;     // <-- The origin is on the inside of the portal.
+        }
+
+        ocMPRVertex v4;
+        ocMPRSupport(pContext, direction, &v4);
+        float dot = glm::dot(v4.v, direction);
+        if ((dot < 0 && !ocMPRIsZero(dot)) || ocMPRReachedTolerance(pContext, v4, direction)) {
+            return OC_FALSE;
+        }
+
+        ocMPRExpandPortal(pContext, v4);
+    }
+
+    return OC_FALSE;
+}
+
+// The contact point is found from the barycentric coordinates of the origin inside the final portal.
+OC_PRIVATE glm::vec3 ocMPRFindPosition(const ocMPRContext* pContext)
+{
+    const ocMPRVertex* p = pContext->portal;
+
+    float b[4];
+    b[0] = glm::dot(glm::cross(p[1].v, p[2].v), p[3].v);
+    b[1] = glm::dot(glm::cross(p[3].v, p[2].v), p[0].v);
+    b[2] = glm::dot(glm::cross(p[0].v, p[1].v), p[3].v);
+    b[3] = glm::dot(glm::cross(p[2].v, p[1].v), p[0].v);
+    float sum = b[0] + b[1] + b[2] + b[3];
+
+    if (sum <= OC_COLLISION_EPSILON) {
+        glm::vec3 direction = ocMPRPortalDirection(pContext);
+        b[0] = 0;
+        b[1] = glm::dot(glm::cross(p[2].v, p[3].v), direction);
+        b[2] = glm::dot(glm::cross(p[3].v, p[1].v), direction);
+        b[3] = glm::dot(glm::cross(p[1].v, p[2].v), direction);
+        sum = b[1] + b[2] + b[3];
+    }
+
+    if (fabsf(sum) <= OC_COLLISION_EPSILON) {
+        return (p[1].a + p[1].b) * 0.5f;
+    }
+
+    glm::vec3 a = glm::vec3(0, 0, 0);
+    glm::vec3 bb = glm::vec3(0, 0, 0);
+    for (ocUInt32 i = 0; i < 4; ++i) {
+        a  += p[i].a * b[i];
+        bb += p[i].b * b[i];
+    }
+
+    return (a + bb) * (0.5f / sum);
+}
+
+// Finds the penetration normal (from A to B), depth and position of two overlapping shapes, with A inflated by the margin. Returns
+// OC_FALSE if they don't overlap.
+OC_PRIVATE ocBool32 ocMPRPenetration(const ocCollisionObject* pA, const ocCollisionObject* pB, float margin, glm::vec3 &normal, float &depth, glm::vec3 &position)
+{
+    ocMPRContext context;
+    context.pA = pA;
+    context.pB = pB;
+    context.margin = margin;
+
+    int result = ocMPRDiscoverPortal(&context);
+    if (result < 0) {
+        return OC_FALSE;
+    }
+
+    if (result == 1) {
+        return OC_FALSE;    // <-- Exactly touching, which has no normal. The next step will either separate or overlap.
+    }
+
+    if (result == 2) {
+        depth    = glm::length(context.portal[1].v);
+        normal   = context.portal[1].v / depth;
+        position = (context.portal[1].a + context.portal[1].b) * 0.5f;
+        return OC_TRUE;
+    }
+
+    if (!ocMPRRefinePortal(&context)) {
+        return OC_FALSE;
+    }
+
+    for (ocUInt32 iIteration = 0; ; ++iIteration) {
+        glm::vec3 direction = ocMPRPortalDirection(&context);
+
+        ocMPRVertex v4;
+        ocMPRSupport(&context, direction, &v4);
+        if (ocMPRReachedTolerance(&context, v4, direction) || iIteration >= OC_COLLISION_MPR_MAX_ITERATIONS) {
+            glm::vec3 closest = ocCollisionClosestPointTriangleToOrigin(context.portal[1].v, context.portal[2].v, context.portal[3].v);
+            depth = glm::length(closest);
+            normal = (depth > OC_COLLISION_EPSILON) ? closest / depth : direction;
+            position = ocMPRFindPosition(&context);
+            return OC_TRUE;
+        }
+
+        ocMPRExpandPortal(&context, v4);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Manifolds
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Builds an orthonormal basis around a unit vector.
+OC_INLINE void ocCollisionMakeBasis(const glm::vec3 &n, glm::vec3 &t1, glm::vec3 &t2)
+{
+    if (fabsf(n.x) >= 0.57735f) {
+        t1 = glm::normalize(glm::vec3(n.y, -n.x, 0));
+    } else {
+        t1 = glm::normalize(glm::vec3(0, n.z, -n.y));
+    }
+
+    t2 = glm::cross(n, t1);
+}
+
+// Retrieves the vertices of the feature of an object that faces the given direction, which will be a single point, an edge, or a face
+// with it's vertices in order around the direction. Rounded shapes are offset by their radius so the points are on their surface.
+OC_PRIVATE ocUInt32 ocCollisionGetFeature(const ocCollisionObject* pObject, const glm::vec3 &direction, glm::vec3* pPoints)
+{
+    const ocCollisionShape* pShape = pObject->pShape;
+
+    if (pShape->type == ocCollisionShapeType_Sphere) {
+        pPoints[0] = pObject->position + direction*pShape->sphere.radius;
+        return 1;
+    }
+
+    if (pShape->type == ocCollisionShapeType_Capsule) {
+        glm::vec3 axis = pObject->rotation * glm::vec3(0, 1, 0);
+        glm::vec3 offset = direction*pShape->capsule.radius;
+        float d = glm::dot(axis, direction);
+        if (fabsf(d) < OC_COLLISION_PARALLEL_TOLERANCE) {
+            pPoints[0] = pObject->position - axis*pShape->capsule.halfHeight + offset;
+            pPoints[1] = pObject->position + axis*pShape->capsule.halfHeight + offset;
+            return 2;
+        }
+
+        pPoints[0] = pObject->position + axis*((d > 0) ? pShape->capsule.halfHeight : -pShape->capsule.halfHeight) + offset;
+        return 1;
+    }
+
+    // Polytopes. Every vertex is projected onto the direction, and those near the top are part of the feature.
+    glm::vec3 localDirection = glm::conjugate(pObject->rotation) * direction;
+    const float* pX;
+    const float* pY;
+    const float* pZ;
+    ocUInt32 vertexCount;
+    float boxX[8], boxY[8], boxZ[8];
+    float triangleX[3], triangleY[3], triangleZ[3];
+
+    if (pShape->type == ocCollisionShapeType_Triangle) {
+        for (ocUInt32 iVertex = 0; iVertex < 3; ++iVertex) {
+            triangleX[iVertex] = pShape->triangle.vertices[iVertex*3 + 0];
+            triangleY[iVertex] = pShape->triangle.vertices[iVertex*3 + 1];
+            triangleZ[iVertex] = pShape->triangle.vertices[iVertex*3 + 2];
+        }
+        pX = triangleX;
+        pY = triangleY;
+        pZ = triangleZ;
+        vertexCount = 3;
+
+        // Same as boxes. Something resting on a triangle should touch the whole face.
+        glm::vec3 a = ocCollisionTriangleVertex(pShape, 0);
+        glm::vec3 faceNormal = glm::cross(ocCollisionTriangleVertex(pShape, 1) - a, ocCollisionTriangleVertex(pShape, 2) - a);
+        float faceNormalLength = glm::length(faceNormal);
+        if (faceNormalLength > OC_COLLISION_EPSILON && fabsf(glm::dot(faceNormal, localDirection)) >= faceNormalLength*OC_COLLISION_BOX_FACE_TOLERANCE) {
+            for (ocUInt32 iVertex = 0; iVertex < 3; ++iVertex) {
+                pPoints[iVertex] = pObject->position + pObject->rotation * glm::vec3(pX[iVertex], pY[iVertex], pZ[iVertex]);
+            }
+            return 3;
+        }
+    } else if (pShape->type == ocCollisionShapeType_Box) {
+        for (ocUInt32 iVertex = 0; iVertex < 8; ++iVertex) {
+            boxX[iVertex] = (iVertex & 1) ? pShape->box.halfExtents[0] : -pShape->box.halfExtents[0];
+            boxY[iVertex] = (iVertex & 2) ? pShape->box.halfExtents[1] : -pShape->box.halfExtents[1];
+            boxZ[iVertex] = (iVertex & 4) ? pShape->box.halfExtents[2] : -pShape->box.halfExtents[2];
+        }
+        pX = boxX;
+        pY = boxY;
+        pZ = boxZ;
+        vertexCount = 8;
+    } else {
+        pX = pShape->convexHull.pHull->pVerticesX;
+        pY = pShape->convexHull.pHull->pVerticesY;
+        pZ = pShape->convexHull.pHull->pVerticesZ;
+        vertexCount = pShape->convexHull.pHull->vertexCount;
+    }
+
+    // The direction from MPR is only approximate, so a box that's resting on it's face can come out as an edge or a vertex, which makes
+    // stacks rock. A box face is always used when it's close enough to the direction. Points that end up too far apart are discarded
+    // when the features are clipped.
+    if (pShape->type == ocCollisionShapeType_Box) {
+        glm::vec3 absDirection = glm::abs(localDirection);
+        ocUInt32 iAxis = (absDirection.x > absDirection.y) ? ((absDirection.x > absDirection.z) ? 0 : 2) : ((absDirection.y > absDirection.z) ? 1 : 2);
+        if (absDirection[iAxis] >= OC_COLLISION_BOX_FACE_TOLERANCE) {
+            ocUInt32 faceBit = (localDirection[iAxis] > 0) ? (1U << iAxis) : 0;
+            ocUInt32 pointCount = 0;
+            for (ocUInt32 iVertex = 0; iVertex < 8; ++iVertex) {
+                if ((iVertex & (1U << iAxis)) == faceBit) {
+                    pPoints[pointCount++] = pObject->position + pObject->rotation * glm::vec3(pX[iVertex], pY[iVertex], pZ[iVertex]);
+                }
+            }
+
+            // Swapping the last two vertices puts them in order around the face.
+            glm::vec3 temp = pPoints[2];
+            pPoints[2] = pPoints[3];
+            pPoints[3] = temp;
+            return pointCount;
+        }
+    }
+
+    float maxDot = -FLT_MAX;
+    float minDot =  FLT_MAX;
+    for (ocUInt32 iVertex = 0; iVertex < vertexCount; ++iVertex) {
+        float dot = pX[iVertex]*localDirection.x + pY[iVertex]*localDirection.y + pZ[iVertex]*localDirection.z;
+        maxDot = ocMax(maxDot, dot);
+        minDot = ocMin(minDot, dot);
+    }
+
+    float tolerance = ocMax((maxDot - minDot) * OC_COLLISION_FEATURE_TOLERANCE, 1e-4f);
+
+    ocUInt32 pointCount = 0;
+    for (ocUInt32 iVertex = 0; iVertex < vertexCount && pointCount < OC_COLLISION_MAX_FEATURE_POINTS; ++iVertex) {
+        float dot = pX[iVertex]*localDirection.x + pY[iVertex]*localDirection.y + pZ[iVertex]*localDirection.z;
+        if (dot >= maxDot - tolerance) {
+            pPoints[pointCount++] = pObject->position + pObject->rotation * glm::vec3(pX[iVertex], pY[iVertex], pZ[iVertex]);
+        }
+    }
+
+    if (pointCount < 3) {
+        return pointCount;
+    }
+
+    // Faces are sorted by angle around their center. A face with no area is really an edge, in which case the two points furthest
+    // apart are used.
+    glm::vec3 t1, t2;
+    ocCollisionMakeBasis(direction, t1, t2);
+
+    glm::vec3 center = glm::vec3(0, 0, 0);
+    for (ocUInt32 iPoint = 0; iPoint < pointCount; ++iPoint) {
+        center += pPoints[iPoint];
+    }
+    center = center / (float)pointCount;
+
+    float angles[OC_COLLISION_MAX_FEATURE_POINTS];
+    for (ocUInt32 iPoint = 0; iPoint < pointCount; ++iPoint) {
+        glm::vec3 offset = pPoints[iPoint] - center;
+        angles[iPoint] = atan2f(glm::dot(offset, t2), glm::dot(offset, t1));
+    }
+
+    for (ocUInt32 i = 1; i < pointCount; ++i) {
+        for (ocUInt32 j = i; j > 0 && angles[j-1] > angles[j]; --j) {
+            float tempAngle = angles[j-1]; angles[j-1] = angles[j]; angles[j] = tempAngle;
+            glm::vec3 tempPoint = pPoints[j-1]; pPoints[j-1] = pPoints[j]; pPoints[j] = tempPoint;
+        }
+    }
+
+    float area = 0;
+    float maxDistanceSq = 0;
+    ocUInt32 iFar0 = 0;
+    ocUInt32 iFar1 = 1;
+    for (ocUInt32 i = 0; i < pointCount; ++i) {
+        area += glm::dot(glm::cross(pPoints[i] - center, pPoints[(i+1) % pointCount] - center), direction);
+        for (ocUInt32 j = i+1; j < pointCount; ++j) {
+            glm::vec3 delta = pPoints[j] - pPoints[i];
+            float distanceSq = glm::dot(delta, delta);
+            if (distanceSq > maxDistanceSq) {
+                maxDistanceSq = distanceSq;
+                iFar0 = i;
+                iFar1 = j;
+            }
+        }
+    }
+
+    if (fabsf(area) <= maxDistanceSq * 1e-3f) {
+        glm::vec3 p0 = pPoints[iFar0];
+        glm::vec3 p1 = pPoints[iFar1];
+        pPoints[0] = p0;
+        pPoints[1] = p1;
+        return 2;
+    }
+
+    return pointCount;
+}
+
+// Clips a polygon against a plane, keeping the part behind it. Returns the new point count.
+OC_PRIVATE ocUInt32 ocCollisionClipPolygon(const glm::vec3* pIn, ocUInt32 inCount, const glm::vec3 &planeNormal, float planeDistance, glm::vec3* pOut)
+{
+    if (inCount == 0) {
+        return 0;
+    }
+
+    // A single point or a segment are clipped directly. Treating them as a closed polygon would duplicate points.
+    if (inCount == 1) {
+        if (glm::dot(pIn[0], planeNormal) <= planeDistance) {
+            pOut[0] = pIn[0];
+            return 1;
+        }
+        return 0;
+    }
+
+    if (inCount == 2) {
+        float d0 = glm::dot(pIn[0], planeNormal) - planeDistance;
+        float d1 = glm::dot(pIn[1], planeNormal) - planeDistance;
+        if (d0 > 0 && d1 > 0) {
+            return 0;
+        }
+
+        pOut[0] = (d0 <= 0) ? pIn[0] : pIn[0] + (pIn[1] - pIn[0]) * (d0 / (d0 - d1));
+        pOut[1] = (d1 <= 0) ? pIn[1] : pIn[1] + (pIn[0] - pIn[1]) * (d1 / (d1 - d0));
+        return 2;
+    }
+
+    ocUInt32 outCount = 0;
+    for (ocUInt32 i = 0; i < inCount; ++i) {
+        const glm::vec3 &p0 = pIn[i];
+        const glm::vec3 &p1 = pIn[(i+1) % inCount];
+        float d0 = glm::dot(p0, planeNormal) - planeDistance;
+        float d1 = glm::dot(p1, planeNormal) - planeDistance;
+
+        if (d0 <= 0) {
+            pOut[outCount++] = p0;
+        }
+        if ((d0 <= 0) != (d1 <= 0)) {
+            pOut[outCount++] = p0 + (p1 - p0) * (d0 / (d0 - d1));
+        }
+    }
+
+    return outCount;
+}
+
+OC_INLINE float ocCollisionTriangleArea(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, const glm::vec3 &normal)
+{
+    return glm::dot(glm::cross(b - a, c - a), normal);
+}
+
+// Reduces a manifold to OC_COLLISION_MAX_MANIFOLD_POINTS points, keeping the deepest point and then the points that cover the most area.
+OC_PRIVATE void ocCollisionReduceManifold(const ocContactPoint* pPoints, ocUInt32 pointCount, ocContactManifold* pManifold)
+{
+    if (pointCount <= OC_COLLISION_MAX_MANIFOLD_POINTS) {
+        for (ocUInt32 iPoint = 0; iPoint < pointCount; ++iPoint) {
+            pManifold->points[iPoint] = pPoints[iPoint];
+        }
+        pManifold->pointCount = pointCount;
+        return;
+    }
+
+    ocUInt32 i0 = 0;
+    for (ocUInt32 i = 1; i < pointCount; ++i) {
+        if (pPoints[i].separation < pPoints[i0].separation) i0 = i;
+    }
+
+    ocUInt32 i1 = (i0 == 0) ? 1 : 0;
+    float best = -1;
+    for (ocUInt32 i = 0; i < pointCount; ++i) {
+        glm::vec3 delta = pPoints[i].position - pPoints[i0].position;
+        float distanceSq = glm::dot(delta, delta);
+        if (distanceSq > best) { best = distanceSq; i1 = i; }
+    }
+
+    ocUInt32 i2 = i0;
+    best = -1;
+    for (ocUInt32 i = 0; i < pointCount; ++i) {
+        float area = fabsf(ocCollisionTriangleArea(pPoints[i0].position, pPoints[i1].position, pPoints[i].position, pManifold->normal));
+        if (area > best) { best = area; i2 = i; }
+    }
+
+    // The last point is the one that's furthest outside the triangle formed by the first three.
+    float winding = (ocCollisionTriangleArea(pPoints[i0].position, pPoints[i1].position, pPoints[i2].position, pManifold->normal) < 0) ? -1.0f : 1.0f;
+    ocUInt32 i3 = i0;
+    best = 0;
+    for (ocUInt32 i = 0; i < pointCount; ++i) {
+        const glm::vec3 &p = pPoints[i].position;
+        float area = ocMin(ocCollisionTriangleArea(pPoints[i0].position, pPoints[i1].position, p, pManifold->normal) * winding,
+                     ocMin(ocCollisionTriangleArea(pPoints[i1].position, pPoints[i2].position, p, pManifold->normal) * winding,
+                           ocCollisionTriangleArea(pPoints[i2].position, pPoints[i0].position, p, pManifold->normal) * winding));
+        if (area < best) { best = area; i3 = i; }
+    }
+
+    pManifold->points[0] = pPoints[i0];
+    pManifold->points[1] = pPoints[i1];
+    pManifold->points[2] = pPoints[i2];
+    pManifold->pointCount = 3;
+    if (i3 != i0 && i3 != i1 && i3 != i2) {
+        pManifold->points[3] = pPoints[i3];
+        pManifold->pointCount = 4;
+    }
+}
+
+// Finds how far an object is from the plane of a triangle, along the normal of the triangle that faces the object. Returns OC_FALSE if
+// the triangle has no area.
+OC_PRIVATE ocBool32 ocCollisionTriangleFaceSeparation(const ocCollisionObject* pTriangle, const ocCollisionObject* pOther, glm::vec3 &normal, float &separation, glm::vec3 &pointOnOther)
+{
+    glm::vec3 a = pTriangle->position + pTriangle->rotation * ocCollisionTriangleVertex(pTriangle->pShape, 0);
+    glm::vec3 n = glm::cross(pTriangle->rotation * (ocCollisionTriangleVertex(pTriangle->pShape, 1) - ocCollisionTriangleVertex(pTriangle->pShape, 0)),
+                             pTriangle->rotation * (ocCollisionTriangleVertex(pTriangle->pShape, 2) - ocCollisionTriangleVertex(pTriangle->pShape, 0)));
+    float length = glm::length(n);
+    if (length <= OC_COLLISION_EPSILON) {
+        return OC_FALSE;
+    }
+
+    normal = n / length;
+    if (glm::dot(ocCollisionCenter(pOther) - a, normal) < 0) {
+        normal = -normal;
+    }
+
+    pointOnOther = ocCollisionSupport(pOther, -normal, 0);
+    separation = glm::dot(pointOnOther - a, normal);
+    return OC_TRUE;
+}
+
+OC_PRIVATE ocBool32 ocCollideGeneral(const ocCollisionObject* pA, const ocCollisionObject* pB, float margin, ocContactManifold* pManifold)
+{
+    glm::vec3 normal;
+    glm::vec3 position;
+    float depth;
+    if (!ocMPRPenetration(pA, pB, margin, normal, depth, position)) {
+        return OC_FALSE;
+    }
+
+    // A was inflated by the margin, which needs to be taken back off.
+    float separation = margin - depth;
+
+    // Triangles are thin, so MPR can find a way out through the side of a triangle that's much deeper than the way out through it's
+    // face, such as when a box sinks into the ground. The face is used whenever it's the shallower of the two.
+    ocBool32 isTriangleA = pA->pShape->type == ocCollisionShapeType_Triangle;
+    if (isTriangleA || pB->pShape->type == ocCollisionShapeType_Triangle) {
+        glm::vec3 faceNormal;
+        glm::vec3 pointOnOther;
+        float faceSeparation;
+        if (ocCollisionTriangleFaceSeparation(isTriangleA ? pA : pB, isTriangleA ? pB : pA, faceNormal, faceSeparation, pointOnOther) && faceSeparation > separation) {
+            normal     = isTriangleA ? faceNormal : -faceNormal;
+            separation = faceSeparation;
+            position   = pointOnOther - faceNormal*(faceSeparation*0.5f) + normal*(margin*0.5f);
+        }
+    }
+
+    if (separation >= margin) {
+        return OC_FALSE;
+    }
+
+    glm::vec3 featureA[OC_COLLISION_MAX_FEATURE_POINTS];
+    glm::vec3 featureB[OC_COLLISION_MAX_FEATURE_POINTS];
+    ocUInt32 featureCountA = ocCollisionGetFeature(pA, normal, featureA);
+    ocUInt32 featureCountB = ocCollisionGetFeature(pB, -normal, featureB);
+
+    if (featureCountA < 3 && featureCountB < 3) {
+        // Vertices and edges only ever touch at a single point, which is what MPR already found.
+        pManifold->normal = normal;
+        pManifold->pointCount = 1;
+        pManifold->points[0].position   = position - normal*(margin*0.5f);
+        pManifold->points[0].separation = separation;
+        return OC_TRUE;
+    }
+
+    // One of the features is a face, which becomes the reference face. The other feature is clipped against it's sides.
+    ocBool32 isReferenceA = featureCountA >= featureCountB;
+    const glm::vec3* pReference = isReferenceA ? featureA : featureB;
+    const glm::vec3* pIncident  = isReferenceA ? featureB : featureA;
+    ocUInt32 referenceCount = isReferenceA ? featureCountA : featureCountB;
+    ocUInt32 incidentCount  = isReferenceA ? featureCountB : featureCountA;
+
+    // The reference face's actual normal is used rather than the MPR normal. They're nearly the same, but using the face normal means
+    // objects resting on a face are pushed straight out of it.
+    glm::vec3 referenceNormal = glm::vec3(0, 0, 0);
+    for (ocUInt32 i = 0; i < referenceCount; ++i) {
+        referenceNormal += glm::cross(pReference[i], pReference[(i+1) % referenceCount]);
+    }
+    referenceNormal = glm::normalize(referenceNormal);
+    if (glm::dot(referenceNormal, isReferenceA ? normal : -normal) < 0) {
+        referenceNormal = -referenceNormal;
+    }
+
+    glm::vec3 clipBuffers[2][OC_COLLISION_MAX_FEATURE_POINTS*2 + 2];
+    ocUInt32 clippedCount = incidentCount;
+    for (ocUInt32 i = 0; i < incidentCount; ++i) {
+        clipBuffers[0][i] = pIncident[i];
+    }
+
+    glm::vec3 referenceCenter = glm::vec3(0, 0, 0);
+    for (ocUInt32 i = 0; i < referenceCount; ++i) {
+        referenceCenter += pReference[i];
+    }
+    referenceCenter = referenceCenter / (float)referenceCount;
+
+    ocUInt32 iBuffer = 0;
+    for (ocUInt32 i = 0; i < referenceCount && clippedCount > 0; ++i) {
+        const glm::vec3 &p0 = pReference[i];
+        const glm::vec3 &p1 = pReference[(i+1) % referenceCount];
+        glm::vec3 sideNormal = glm::cross(p1 - p0, referenceNormal);
+        float length = glm::length(sideNormal);
+        if (length < OC_COLLISION_EPSILON) {
+            continue;
+        }
+
+        sideNormal = sideNormal / length;
+        if (glm::dot(referenceCenter - p0, sideNormal) > 0) {
+            sideNormal = -sideNormal;
+        }
+
+        // The clipped polygon can gain a point for every plane, so the buffers are sized for that.
+        if (clippedCount >= OC_COLLISION_MAX_FEATURE_POINTS*2) {
+            break;
+        }
+
+        clippedCount = ocCollisionClipPolygon(clipBuffers[iBuffer], clippedCount, sideNormal, glm::dot(p0, sideNormal), clipBuffers[iBuffer ^ 1]);
+        iBuffer ^= 1;
+    }
+
+    float referenceDistance = glm::dot(pReference[0], referenceNormal);
+    ocContactPoint points[OC_COLLISION_MAX_FEATURE_POINTS*2 + 2];
+    ocUInt32 pointCount = 0;
+    for (ocUInt32 i = 0; i < clippedCount; ++i) {
+        const glm::vec3 &p = clipBuffers[iBuffer][i];
+        float s = glm::dot(p, referenceNormal) - referenceDistance;
+        if (s < margin) {
+            points[pointCount].position   = p - referenceNormal*(s*0.5f);
+            points[pointCount].separation = s;
+            pointCount += 1;
+        }
+    }
+
+    if (pointCount == 0) {
+        // Clipping can remove everything when the features only just overlap at a corner. Fall back to the MPR point.
+        pManifold->normal = normal;
+        pManifold->pointCount = 1;
+        pManifold->points[0].position   = position - normal*(margin*0.5f);
+        pManifold->points[0].separation = separation;
+        return OC_TRUE;
+    }
+
+    pManifold->normal = isReferenceA ? referenceNormal : -referenceNormal;
+    ocCollisionReduceManifold(points, pointCount, pManifold);
+
+    return OC_TRUE;
+}
+
+ocBool32 ocCollide(const ocCollisionObject* pA, const ocCollisionObject* pB, float margin, ocContactManifold* pManifold)
+{
+    if (pA == NULL || pB == NULL || pManifold == NULL) {
+        return OC_FALSE;
+    }
+
+    pManifold->pointCount = 0;
+
+    if (pA->pShape->type == ocCollisionShapeType_TriangleMesh || pB->pShape->type == ocCollisionShapeType_TriangleMesh) {
+        ocAssert(OC_FALSE); // <-- Use ocTriangleMeshCollide().
+        return OC_FALSE;
+    }
+
+    ocBool32 isRoundedA = pA->pShape->type == ocCollisionShapeType_Sphere || pA->pShape->type == ocCollisionShapeType_Capsule;
+    ocBool32 isRoundedB = pB->pShape->type == ocCollisionShapeType_Sphere || pB->pShape->type == ocCollisionShapeType_Capsule;
+    if (isRoundedA && isRoundedB) {
+        return ocCollideRounded(pA, pB, margin, pManifold);
+    }
+
+    return ocCollideGeneral(pA, pB, margin, pManifold);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Casts
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// A cast is a ray against the Minkowski difference of the target and the cast shape, whose support points are found from the support
+// points of both. A NULL cast object is a point, which turns it into a plain ray. The direction must be normalized.
+//
+// The radius of spheres and capsules is left out of the support points and treated as a margin around the difference instead. GJK
+// converges slowly on round shapes, but finishes in a few steps on the point and segment that are left.
+OC_PRIVATE glm::vec3 ocCollisionCastSupport(const ocCollisionObject* pCast, const ocCollisionObject* pTarget, const glm::vec3 &direction)
+{
+    glm::vec3 point = ocCollisionSupport(pTarget, direction, -ocCollisionShapeRadius(pTarget->pShape));
+    if (pCast != NULL) {
+        point -= ocCollisionSupport(pCast, -direction, -ocCollisionShapeRadius(pCast->pShape)) - pCast->position;
+    }
+
+    return point;
+}
+
+OC_INLINE float ocCollisionCastMargin(const ocCollisionObject* pCast, const ocCollisionObject* pTarget)
+{
+    float margin = ocCollisionShapeRadius(pTarget->pShape);
+    if (pCast != NULL) {
+        margin += ocCollisionShapeRadius(pCast->pShape);
+    }
+
+    return margin;
+}
+
+// The closest point to the origin on the segment between vertices ia and ib of a simplex. The vertices that are needed to describe the
+// point are written to pKeep.
+OC_PRIVATE glm::vec3 ocGJKClosestSegment(const glm::vec3* pW, ocUInt32 ia, ocUInt32 ib, ocUInt32* pKeep, ocUInt32* pKeepCount)
+{
+    glm::vec3 a  = pW[ia];
+    glm::vec3 ab = pW[ib] - a;
+    float lengthSq = glm::dot(ab, ab);
+    float t = (lengthSq > OC_COLLISION_EPSILON*OC_COLLISION_EPSILON) ? -glm::dot(a, ab) / lengthSq : 0;
+
+    if (t <= 0) {
+        pKeep[0] = ia;
+        *pKeepCount = 1;
+        return a;
+    }
+
+    if (t >= 1) {
+        pKeep[0] = ib;
+        *pKeepCount = 1;
+        return pW[ib];
+    }
+
+    pKeep[0] = ia;
+    pKeep[1] = ib;
+    *pKeepCount = 2;
+    return a + ab*t;
+}
+
+// The same as ocCollisionClosestPointTriangleToOrigin(), but keeps track of the vertices that are needed. Triangles with no area are
+// treated as their closest edge.
+OC_PRIVATE glm::vec3 ocGJKClosestTriangle(const glm::vec3* pW, ocUInt32 ia, ocUInt32 ib, ocUInt32 ic, ocUInt32* pKeep, ocUInt32* pKeepCount)
+{
+    glm::vec3 a = pW[ia];
+    glm::vec3 b = pW[ib];
+    glm::vec3 c = pW[ic];
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+
+    glm::vec3 n = glm::cross(ab, ac);
+    if (glm::dot(n, n) <= glm::dot(ab, ab) * glm::dot(ac, ac) * 1e-10f) {
+        ocUInt32 keep[3][2];
+        ocUInt32 keepCount[3];
+        glm::vec3 closest[3];
+        closest[0] = ocGJKClosestSegment(pW, ia, ib, keep[0], &keepCount[0]);
+        closest[1] = ocGJKClosestSegment(pW, ia, ic, keep[1], &keepCount[1]);
+        closest[2] = ocGJKClosestSegment(pW, ib, ic, keep[2], &keepCount[2]);
+
+        ocUInt32 iBest = 0;
+        for (ocUInt32 i = 1; i < 3; ++i) {
+            if (glm::dot(closest[i], closest[i]) < glm::dot(closest[iBest], closest[iBest])) {
+                iBest = i;
+            }
+        }
+
+        for (ocUInt32 i = 0; i < keepCount[iBest]; ++i) {
+            pKeep[i] = keep[iBest][i];
+        }
+        *pKeepCount = keepCount[iBest];
+        return closest[iBest];
+    }
+
+    float d1 = -glm::dot(ab, a);
+    float d2 = -glm::dot(ac, a);
+    if (d1 <= 0 && d2 <= 0) {
+        pKeep[0] = ia;
+        *pKeepCount = 1;
+        return a;
+    }
+
+    float d3 = -glm::dot(ab, b);
+    float d4 = -glm::dot(ac, b);
+    if (d3 >= 0 && d4 <= d3) {
+        pKeep[0] = ib;
+        *pKeepCount = 1;
+        return b;
+    }
+
+    float vc = d1*d4 - d3*d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+        pKeep[0] = ia;
+        pKeep[1] = ib;
+        *pKeepCount = 2;
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    float d5 = -glm::dot(ab, c);
+    float d6 = -glm::dot(ac, c);
+    if (d6 >= 0 && d5 <= d6) {
+        pKeep[0] = ic;
+        *pKeepCount = 1;
+        return c;
+    }
+
+    float vb = d5*d2 - d1*d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+        pKeep[0] = ia;
+        pKeep[1] = ic;
+        *pKeepCount = 2;
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    float va = d3*d6 - d5*d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+        pKeep[0] = ib;
+        pKeep[1] = ic;
+        *pKeepCount = 2;
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    pKeep[0] = ia;
+    pKeep[1] = ib;
+    pKeep[2] = ic;
+    *pKeepCount = 3;
+
+    // Projecting onto the plane rather than using the barycentric coordinates keeps the point perpendicular to the face when the
+    // triangle is a sliver, which GJK relies on to make progress.
+    return n * (glm::dot(n, a) / glm::dot(n, n));
+}
+
+// Finds the point of a simplex closest to the origin. Returns the number of vertices that are needed to describe it, which are written
+// to pKeep. The origin is inside a tetrahedron when all 4 vertices are kept.
+OC_PRIVATE glm::vec3 ocGJKClosestPoint(const glm::vec3* pW, ocUInt32 count, ocUInt32* pKeep, ocUInt32* pKeepCount)
+{
+    if (count == 1) {
+        pKeep[0] = 0;
+        *pKeepCount = 1;
+        return pW[0];
+    }
+
+    if (count == 2) {
+        return ocGJKClosestSegment(pW, 0, 1, pKeep, pKeepCount);
+    }
+
+    if (count == 3) {
+        return ocGJKClosestTriangle(pW, 0, 1, 2, pKeep, pKeepCount);
+    }
+
+    // Only the faces that the origin is in front of can contain the closest point. Faces of a flat tetrahedron have no front, so they're
+    // all tested.
+    static const ocUInt32 faces[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};   // <-- The last is the opposite vertex.
+
+    glm::vec3 closest = glm::vec3(0, 0, 0);
+    float closestDistanceSq = FLT_MAX;
+    ocBool32 isInside = OC_TRUE;
+    for (ocUInt32 iFace = 0; iFace < 4; ++iFace) {
+        const glm::vec3 &a = pW[faces[iFace][0]];
+        glm::vec3 n = glm::cross(pW[faces[iFace][1]] - a, pW[faces[iFace][2]] - a);
+        glm::vec3 toOpposite = pW[faces[iFace][3]] - a;
+        float originSide   = -glm::dot(n, a);
+        float oppositeSide = glm::dot(n, toOpposite);
+        ocBool32 isFlat = oppositeSide*oppositeSide <= glm::dot(n, n) * glm::dot(toOpposite, toOpposite) * 1e-8f;   // <-- Relative to size.
+        if (originSide*oppositeSide > 0 && !isFlat) {
+            continue;
+        }
+
+        isInside = OC_FALSE;
+
+        ocUInt32 keep[3];
+        ocUInt32 keepCount;
+        glm::vec3 point = ocGJKClosestTriangle(pW, faces[iFace][0], faces[iFace][1], faces[iFace][2], keep, &keepCount);
+        float distanceSq = glm::dot(point, point);
+        if (distanceSq < closestDistanceSq) {
+            closestDistanceSq = distanceSq;
+            closest = point;
+            for (ocUInt32 i = 0; i < keepCount; ++i) {
+                pKeep[i] = keep[i];
+            }
+            *pKeepCount = keepCount;
+        }
+    }
+
+    if (isInside) {
+        for (ocUInt32 i = 0; i < 4; ++i) {
+            pKeep[i] = i;
+        }
+        *pKeepCount = 4;
+        return glm::vec3(0, 0, 0);
+    }
+
+    return closest;
+}
+
+// The GJK ray cast. The ray is moved forward to the supporting plane of the Minkowski difference, pushed out by the margin, each time it's
+// found to be separating, and stops once the ray's current position is within the margin of it. The last separating plane is the normal
+// of the hit.
+OC_PRIVATE ocBool32 ocCollisionCastGJK(const ocCollisionObject* pCast, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, const ocCollisionObject* pTarget, ocCollisionCastHit* pHit)
+{
+    glm::vec3 simplex[4];   // <-- Support points of the Minkowski difference.
+    ocUInt32 simplexCount = 0;
+
+    float margin = ocCollisionCastMargin(pCast, pTarget);
+    float distance = 0;
+    glm::vec3 x = origin;
+    glm::vec3 normal = glm::vec3(0, 0, 0);
+    glm::vec3 v = x - ocCollisionCastSupport(pCast, pTarget, -direction);
+    float sizeSq = glm::dot(v, v) + margin*margin;     // <-- The scale of the problem, which the tolerance is relative to.
+
+    ocBool32 isHit = OC_FALSE;
+    for (ocUInt32 iIteration = 0; iIteration < OC_COLLISION_CAST_MAX_ITERATIONS; ++iIteration) {
+        float vv = glm::dot(v, v);
+        float tolerance = ocMax(sqrtf(sizeSq) * OC_COLLISION_CAST_TOLERANCE, OC_COLLISION_EPSILON);
+        if (vv <= (margin + tolerance)*(margin + tolerance)) {
+            isHit = OC_TRUE;
+            break;
+        }
+
+        float vLength = sqrtf(vv);
+        glm::vec3 p = ocCollisionCastSupport(pCast, pTarget, v / vLength);
+        float vw = glm::dot(v, x - p);
+        ocBool32 isAdvancing = vw > margin*vLength;
+        if (isAdvancing) {
+            float vr = glm::dot(v, direction);
+            if (vr >= 0) {
+                return OC_FALSE;    // <-- Moving away from the separating plane.
+            }
+
+            distance -= (vw - margin*vLength) / vr;
+            if (distance > maxDistance) {
+                return OC_FALSE;
+            }
+
+            x = origin + direction*distance;
+            normal = v;
+        }
+
+        ocBool32 isDuplicate = OC_FALSE;
+        for (ocUInt32 i = 0; i < simplexCount; ++i) {
+            glm::vec3 delta = simplex[i] - p;
+            if (glm::dot(delta, delta) <= tolerance*tolerance) {
+                isDuplicate = OC_TRUE;
+            }
+        }
+
+        // A support point that's already in the simplex means the closest point can't get any closer, unless the ray has just moved.
+        if (isDuplicate && !isAdvancing) {
+            isHit = OC_TRUE;
+            break;
+        }
+
+        if (!isDuplicate) {
+            simplex[simplexCount++] = p;
+        }
+
+        glm::vec3 w[4];
+        sizeSq = margin*margin;
+        for (ocUInt32 i = 0; i < simplexCount; ++i) {
+            w[i] = x - simplex[i];
+            sizeSq = ocMax(sizeSq, glm::dot(w[i], w[i]));
+        }
+
+        ocUInt32 keep[4];
+        ocUInt32 keepCount;
+        v = ocGJKClosestPoint(w, simplexCount, keep, &keepCount);
+        if (keepCount == 4) {
+            isHit = OC_TRUE;
+            break;
+        }
+
+        glm::vec3 kept[3];
+        for (ocUInt32 i = 0; i < keepCount; ++i) {
+            kept[i] = simplex[keep[i]];
+        }
+        for (ocUInt32 i = 0; i < keepCount; ++i) {
+            simplex[i] = kept[i];
+        }
+        simplexCount = keepCount;
+    }
+
+    if (!isHit) {
+        return OC_FALSE;
+    }
+
+    float normalLength = glm::length(normal);
+    if (normalLength <= OC_COLLISION_EPSILON) {
+        // Started out touching.
+        pHit->distance = 0;
+        pHit->normal   = -direction;
+        pHit->position = x;
+    } else {
+        pHit->distance = distance;
+        pHit->normal   = normal / normalLength;
+        pHit->position = x;
+        if (pCast != NULL) {
+            pHit->position += ocCollisionSupport(pCast, -pHit->normal, 0) - pCast->position;
+        }
+    }
+
+    pHit->triangleIndex = OC_BVH_EMPTY;
+    return OC_TRUE;
+}
+
+OC_PRIVATE ocBool32 ocCollisionRaycastSphere(const glm::vec3 &center, float radius, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit)
+{
+    glm::vec3 m = origin - center;
+    float b = glm::dot(m, direction);
+    float c = glm::dot(m, m) - radius*radius;
+    if (c <= 0) {
+        pHit->distance = 0;
+        pHit->normal   = -direction;
+        pHit->position = origin;
+        return OC_TRUE;
+    }
+
+    if (b > 0) {
+        return OC_FALSE;
+    }
+
+    float discriminant = b*b - c;
+    if (discriminant < 0) {
+        return OC_FALSE;
+    }
+
+    float t = -b - sqrtf(discriminant);
+    if (t > maxDistance) {
+        return OC_FALSE;
+    }
+
+    pHit->distance = t;
+    pHit->position = origin + direction*t;
+    pHit->normal   = (radius > 0) ? (pHit->position - center) / radius : -direction;
+    return OC_TRUE;
+}
+
+OC_PRIVATE ocBool32 ocCollisionRaycastBox(const ocCollisionObject* pObject, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit)
+{
+    glm::quat inverseRotation = glm::conjugate(pObject->rotation);
+    glm::vec3 localOrigin    = inverseRotation * (origin - pObject->position);
+    glm::vec3 localDirection = inverseRotation * direction;
+
+    float tEnter = -FLT_MAX;
+    float tExit  =  FLT_MAX;
+    glm::vec3 localNormal = glm::vec3(0, 0, 0);
+    for (int i = 0; i < 3; ++i) {
+        float extent = pObject->pShape->box.halfExtents[i];
+        if (fabsf(localDirection[i]) < OC_COLLISION_EPSILON) {
+            if (fabsf(localOrigin[i]) > extent) {
+                return OC_FALSE;
+            }
+            continue;
+        }
+
+        float invDirection = 1 / localDirection[i];
+        float t0 = (-extent - localOrigin[i]) * invDirection;
+        float t1 = ( extent - localOrigin[i]) * invDirection;
+        if (t0 > t1) {
+            float temp = t0; t0 = t1; t1 = temp;
+        }
+
+        if (t0 > tEnter) {
+            tEnter = t0;
+            localNormal = glm::vec3(0, 0, 0);
+            localNormal[i] = (localDirection[i] > 0) ? -1.0f : 1.0f;
+        }
+
+        tExit = ocMin(tExit, t1);
+        if (tEnter > tExit) {
+            return OC_FALSE;
+        }
+    }
+
+    if (tExit < 0 || tEnter > maxDistance) {
+        return OC_FALSE;
+    }
+
+    if (tEnter <= 0) {
+        pHit->distance = 0;
+        pHit->normal   = -direction;
+        pHit->position = origin;
+        return OC_TRUE;
+    }
+
+    pHit->distance = tEnter;
+    pHit->position = origin + direction*tEnter;
+    pHit->normal   = pObject->rotation * localNormal;
+    return OC_TRUE;
+}
+
+// Möller-Trumbore. Triangles are hit from both sides.
+OC_PRIVATE ocBool32 ocCollisionRaycastTriangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit)
+{
+    glm::vec3 e1 = b - a;
+    glm::vec3 e2 = c - a;
+    glm::vec3 p = glm::cross(direction, e2);
+    float det = glm::dot(e1, p);
+    if (det == 0) {
+        return OC_FALSE;
+    }
+
+    float invDet = 1 / det;
+    glm::vec3 t = origin - a;
+    float u = glm::dot(t, p) * invDet;
+    if (u < 0 || u > 1) {
+        return OC_FALSE;
+    }
+
+    glm::vec3 q = glm::cross(t, e1);
+    float v = glm::dot(direction, q) * invDet;
+    if (v < 0 || u + v > 1) {
+        return OC_FALSE;
+    }
+
+    float distance = glm::dot(e2, q) * invDet;
+    if (distance < 0 || distance > maxDistance) {
+        return OC_FALSE;
+    }
+
+    glm::vec3 normal = glm::normalize(glm::cross(e1, e2));
+    pHit->distance = distance;
+    pHit->position = origin + direction*distance;
+    pHit->normal   = (glm::dot(normal, direction) > 0) ? -normal : normal;
+    return OC_TRUE;
+}
+
+ocBool32 ocCollisionRaycast(const ocCollisionObject* pObject, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit)
+{
+    if (pObject == NULL || pHit == NULL) return OC_FALSE;
+
+    pHit->triangleIndex = OC_BVH_EMPTY;
+
+    const ocCollisionShape* pShape = pObject->pShape;
+    switch (pShape->type)
+    {
+        case ocCollisionShapeType_Sphere:
+        {
+            return ocCollisionRaycastSphere(pObject->position, pShape->sphere.radius, origin, direction, maxDistance, pHit);
+        }
+
+        case ocCollisionShapeType_Box:
+        {
+            return ocCollisionRaycastBox(pObject, origin, direction, maxDistance, pHit);
+        }
+
+        case ocCollisionShapeType_Triangle:
+        {
+            glm::vec3 a = pObject->position + pObject->rotation * ocCollisionTriangleVertex(pShape, 0);
+            glm::vec3 b = pObject->position + pObject->rotation * ocCollisionTriangleVertex(pShape, 1);
+            glm::vec3 c = pObject->position + pObject->rotation * ocCollisionTriangleVertex(pShape, 2);
+            return ocCollisionRaycastTriangle(a, b, c, origin, direction, maxDistance, pHit);
+        }
+
+        case ocCollisionShapeType_TriangleMesh:
+        {
+            glm::quat inverseRotation = glm::conjugate(pObject->rotation);
+            if (!ocTriangleMeshRaycast(pShape->triangleMesh.pMesh, inverseRotation * (origin - pObject->position), inverseRotation * direction, maxDistance, pHit)) {
+                return OC_FALSE;
+            }
+
+            pHit->position = pObject->position + pObject->rotation * pHit->position;
+            pHit->normal   = pObject->rotation * pHit->normal;
+            return OC_TRUE;
+        }
+
+        case ocCollisionShapeType_Capsule:
+        case ocCollisionShapeType_ConvexHull:
+        default:
+        {
+            return ocCollisionCastGJK(NULL, origin, direction, maxDistance, pObject, pHit);
+        }
+    }
+}
+
+ocBool32 ocCollisionShapeCast(const ocCollisionObject* pCast, const glm::vec3 &direction, float maxDistance, const ocCollisionObject* pObject, ocCollisionCastHit* pHit)
+{
+    if (pCast == NULL || pObject == NULL || pHit == NULL) return OC_FALSE;
+
+    if (pCast->pShape->type == ocCollisionShapeType_TriangleMesh) {
+        ocAssert(OC_FALSE);
+        return OC_FALSE;
+    }
+
+    pHit->triangleIndex = OC_BVH_EMPTY;
+
+    if (pObject->pShape->type == ocCollisionShapeType_TriangleMesh) {
+        return ocTriangleMeshShapeCast(pObject, pCast, direction, maxDistance, pHit);
+    }
+
+    // Two spheres are a ray against a sphere with both radii, which is common enough to be worth doing directly.
+    if (pCast->pShape->type == ocCollisionShapeType_Sphere && pObject->pShape->type == ocCollisionShapeType_Sphere) {
+        float radius = pObject->pShape->sphere.radius;
+        if (!ocCollisionRaycastSphere(pObject->position, radius + pCast->pShape->sphere.radius, pCast->position, direction, maxDistance, pHit)) {
+            return OC_FALSE;
+        }
+
+        pHit->position = (pHit->distance > 0) ? pObject->position + pHit->normal*radius : pCast->position;
+        return OC_TRUE;
+    }
+
+    return ocCollisionCastGJK(pCast, pCast->position, direction, maxDistance, pObject, pHit);
+}
@@ -0,0 +1,174 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Collision shapes and the narrow phase.
+//
+// Spheres, capsules and boxes are described entirely by their dimensions. Convex hulls reference an ocConvexHull which stores it's
+// vertices as a structure of arrays so that support points can be found 4 vertices at a time. Triangle meshes reference an ocTriangleMesh
+// and can only be used for static bodies. They're not convex, so they collide one triangle at a time.
+//
+// Sphere and capsule pairs are tested analytically, with sphere pairs done in batches of 4 using SIMD. Every other pair goes through
+// Minkowski Portal Refinement (MPR) to find the contact normal and depth, after which the features of each shape that face each other
+// are clipped against each other to produce a manifold of up to 4 points. This is what allows boxes to rest flat on each other without
+// needing contacts to be accumulated over several frames.
+//
+// Shapes can also be cast along a ray, which is how scene queries find the first thing a ray or a moving shape would hit. Rays against
+// spheres, boxes and triangles are done analytically. Everything else uses the GJK ray cast from "Ray Casting against General Convex
+// Objects with Application to Continuous Collision Detection" by Gino van den Bergen, which only needs support points.
+//
+// Shapes are not scaled by the scale of the object they're attached to.
+
+#define OC_COLLISION_MAX_MANIFOLD_POINTS    4
+#define OC_COLLISION_MAX_FEATURE_POINTS     16      // <-- The maximum number of vertices of a face that are used for clipping.
+#define OC_COLLISION_MPR_MAX_ITERATIONS     64
+#define OC_COLLISION_MPR_TOLERANCE          1e-4f
+#define OC_COLLISION_CAST_MAX_ITERATIONS    32
+#define OC_COLLISION_CAST_TOLERANCE         1e-4f   // <-- How close a cast gets to the surface, relative to the size of the shapes.
+
+struct ocTriangleMesh;
+
+enum ocCollisionShapeType
+{
+    ocCollisionShapeType_Sphere,
+    ocCollisionShapeType_Capsule,
+    ocCollisionShapeType_Box,
+    ocCollisionShapeType_ConvexHull,
+    ocCollisionShapeType_Triangle,      // <-- Flat, so it can't be used for dynamic bodies. Used for the triangles of meshes.
+    ocCollisionShapeType_TriangleMesh   // <-- Static bodies only.
+};
+
+// A convex hull, centered at the origin of the body it's attached to. The vertex arrays are padded to a multiple of 4 by repeating the
+// first vertex. Faces are not stored. They're found from the vertices when needed.
+struct ocConvexHull
+{
+    float* pVerticesX;
+    float* pVerticesY;
+    float* pVerticesZ;
+    ocUInt32 vertexCount;       // <-- Not including padding.
+    glm::vec3 center;           // <-- The average of the vertices. Always inside the hull.
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+};
+
+struct ocCollisionShape
+{
+    ocCollisionShapeType type;
+
+    union
+    {
+        struct
+        {
+            float radius;
+        } sphere;
+
+        struct
+        {
+            float radius;
+            float halfHeight;   // <-- The distance from the center to the center of each cap, along the local Y axis.
+        } capsule;
+
+        struct
+        {
+            float halfExtents[3];
+        } box;
+
+        struct
+        {
+            const ocConvexHull* pHull; // <-- Not copied. Must remain valid while the shape is in use.
+        } convexHull;
+
+        struct
+        {
+            float vertices[9];  // <-- Relative to the position of the object.
+        } triangle;
+
+        struct
+        {
+            const ocTriangleMesh* pMesh; // <-- Not copied. Must remain valid while the shape is in use.
+        } triangleMesh;
+    };
+};
+
+struct ocContactPoint
+{
+    glm::vec3 position;         // <-- Half way between the surfaces of the two shapes, in world space.
+    float separation;           // <-- Negative when the shapes are overlapping.
+};
+
+// The contacts between a pair of shapes. The normal points from the first shape to the second.
+struct ocContactManifold
+{
+    glm::vec3 normal;
+    ocUInt32 pointCount;
+    ocContactPoint points[OC_COLLISION_MAX_MANIFOLD_POINTS];
+};
+
+// A shape placed in the world, for passing to the narrow phase.
+struct ocCollisionObject
+{
+    const ocCollisionShape* pShape;
+    glm::vec3 position;
+    glm::quat rotation;
+};
+
+// Where a ray or a cast shape first touches an object.
+struct ocCollisionCastHit
+{
+    float distance;             // <-- Along the direction of the cast. 0 when the cast starts out touching the object.
+    glm::vec3 position;         // <-- The point of contact, in world space.
+    glm::vec3 normal;           // <-- The normal of the surface that was hit, facing back along the cast.
+    ocUInt32 triangleIndex;     // <-- The triangle that was hit for triangle meshes. OC_BVH_EMPTY for everything else.
+};
+
+// Initializes a convex hull from a list of points. The points do not need to be on the hull, but any that are inside it are wasted
+// work when finding support points. The points are copied.
+ocResult ocConvexHullInit(const float* pPoints, ocUInt32 pointCount, ocConvexHull* pHull);
+
+//
+void ocConvexHullUninit(ocConvexHull* pHull);
+
+// Retrieves the index of the vertex furthest along the given direction.
+ocUInt32 ocConvexHullSupport(const ocConvexHull* pHull, const glm::vec3 &direction);
+
+
+// Shape helpers.
+ocCollisionShape ocCollisionShapeSphere(float radius);
+ocCollisionShape ocCollisionShapeCapsule(float radius, float halfHeight);
+ocCollisionShape ocCollisionShapeBox(const glm::vec3 &halfExtents);
+ocCollisionShape ocCollisionShapeConvexHull(const ocConvexHull* pHull);
+ocCollisionShape ocCollisionShapeTriangle(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c);
+ocCollisionShape ocCollisionShapeTriangleMesh(const ocTriangleMesh* pMesh);
+
+// Calculates the axis aligned bounding box of a shape in world space.
+void ocCollisionShapeGetAABB(const ocCollisionShape* pShape, const glm::vec3 &position, const glm::quat &rotation, glm::vec3 &aabbMin, glm::vec3 &aabbMax);
+
+// Calculates the diagonal of the inertia tensor of a shape with the given mass, in local space. Convex hulls use the inertia of their
+// bounding box, which is close enough for debris. Triangles and triangle meshes have no volume and are never dynamic, so they do the same.
+glm::vec3 ocCollisionShapeGetInertia(const ocCollisionShape* pShape, float mass);
+
+
+// Finds the contacts between two shapes. Shapes that are separated by less than margin are also reported, with a positive separation,
+// so the solver can stop them before they overlap. Returns OC_FALSE if there are no contacts. Triangle meshes are not handled here, since
+// they need a manifold for each triangle. Use ocTriangleMeshCollide() for those.
+ocBool32 ocCollide(const ocCollisionObject* pA, const ocCollisionObject* pB, float margin, ocContactManifold* pManifold);
+
+// Finds the contacts between count pairs of spheres. The inputs are structures of arrays, one element per pair. Manifolds with no
+// contacts have a point count of 0.
+struct ocSpherePairs
+{
+    const float* pCenterAX;
+    const float* pCenterAY;
+    const float* pCenterAZ;
+    const float* pRadiusA;
+    const float* pCenterBX;
+    const float* pCenterBY;
+    const float* pCenterBZ;
+    const float* pRadiusB;
+};
+void ocCollideSpheres(const ocSpherePairs* pPairs, ocUInt32 count, float margin, ocContactManifold* pManifolds);
+
+// Finds where a ray first hits an object. The direction must be normalized. Rays that start inside a shape hit it at a distance of 0.
+ocBool32 ocCollisionRaycast(const ocCollisionObject* pObject, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit);
+
+// Finds where a shape first hits an object when it's moved along a ray, without rotating. The direction must be normalized. The shape
+// being cast can't be a triangle mesh.
+ocBool32 ocCollisionShapeCast(const ocCollisionObject* pCast, const glm::vec3 &direction, float maxDistance, const ocCollisionObject* pObject, ocCollisionCastHit* pHit);
@@ -1,6 +1,1298 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
-ocResult ocDynamicsWorldInit(ocDynamicsWorld* pWorld)
+#define OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT  29
+#define OC_DYNAMICS_RESTITUTION_THRESHOLD   1.0f    // <-- Contacts approaching slower than this don't bounce, so resting bodies settle.
+#define OC_DYNAMICS_WARM_START_DISTANCE     0.05f   // <-- How far a contact point can move relative to A and still be matched to the previous step.
+
+ocDynamicsBodyDesc ocDynamicsBodyDescInit()
+{
+    ocDynamicsBodyDesc desc;
+    desc.type           = ocDynamicsBodyType_Dynamic;
+    desc.shape          = ocCollisionShapeSphere(0.5f);
+    desc.mass           = 1;
+    desc.friction       = 0.5f;
+    desc.restitution    = 0;
+    desc.linearDamping  = 0.01f;
+    desc.angularDamping = 0.05f;
+    desc.pUserData      = NULL;
+
+    return desc;
+}
+
+ocDynamicsRay ocDynamicsRayInit(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance)
+{
+    ocDynamicsRay ray;
+    ray.origin       = origin;
+    ray.direction    = direction;
+    ray.maxDistance  = maxDistance;
+    ray.ignoreBodyID = OC_DYNAMICS_BODY_NONE;
+
+    return ray;
+}
+
+ocDynamicsSweep ocDynamicsSweepInit(const ocCollisionShape &shape, const glm::vec3 &origin, const glm::quat &rotation, const glm::vec3 &direction, float maxDistance)
+{
+    ocDynamicsSweep sweep;
+    sweep.shape        = shape;
+    sweep.origin       = origin;
+    sweep.rotation     = rotation;
+    sweep.direction    = direction;
+    sweep.maxDistance  = maxDistance;
+    sweep.ignoreBodyID = OC_DYNAMICS_BODY_NONE;
+
+    return sweep;
+}
+
+// Retrieves a pointer to each of the body arrays along with the size of their elements. The float arrays come first so they stay
+// 16 byte aligned, since the capacity is always a multiple of 4.
+OC_PRIVATE void ocDynamicsWorldGetBodyArrays(ocDynamicsWorld* pWorld, void** ppArrays[OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT], ocSizeT elementSizes[OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT])
+{
+    void** ppFloatArrays[] = {
+        (void**)&pWorld->pPositionX,        (void**)&pWorld->pPositionY,        (void**)&pWorld->pPositionZ,
+        (void**)&pWorld->pRotationX,        (void**)&pWorld->pRotationY,        (void**)&pWorld->pRotationZ,        (void**)&pWorld->pRotationW,
+        (void**)&pWorld->pLinearVelocityX,  (void**)&pWorld->pLinearVelocityY,  (void**)&pWorld->pLinearVelocityZ,
+        (void**)&pWorld->pAngularVelocityX, (void**)&pWorld->pAngularVelocityY, (void**)&pWorld->pAngularVelocityZ,
+        (void**)&pWorld->pInvMass,          (void**)&pWorld->pLinearDamping,    (void**)&pWorld->pAngularDamping,
+        (void**)&pWorld->pAABBMinX,         (void**)&pWorld->pAABBMinY,         (void**)&pWorld->pAABBMinZ,
+        (void**)&pWorld->pAABBMaxX,         (void**)&pWorld->pAABBMaxY,         (void**)&pWorld->pAABBMaxZ,
+        (void**)&pWorld->pSleepTime
+    };
+
+    ocUInt32 iArray = 0;
+    for (; iArray < ocCountOf(ppFloatArrays); ++iArray) {
+        ppArrays[iArray] = ppFloatArrays[iArray];
+        elementSizes[iArray] = sizeof(float);
+    }
+
+    ppArrays[iArray] = (void**)&pWorld->pLocalInvInertia; elementSizes[iArray] = sizeof(*pWorld->pLocalInvInertia); iArray += 1;
+    ppArrays[iArray] = (void**)&pWorld->pInvInertia;      elementSizes[iArray] = sizeof(*pWorld->pInvInertia);      iArray += 1;
+    ppArrays[iArray] = (void**)&pWorld->pDescs;           elementSizes[iArray] = sizeof(*pWorld->pDescs);           iArray += 1;
+    ppArrays[iArray] = (void**)&pWorld->pBodyIDs;         elementSizes[iArray] = sizeof(*pWorld->pBodyIDs);         iArray += 1;
+    ppArrays[iArray] = (void**)&pWorld->pIslandNext;      elementSizes[iArray] = sizeof(*pWorld->pIslandNext);      iArray += 1;
+    ppArrays[iArray] = NULL;                              elementSizes[iArray] = 0;
+
+    ocAssert(iArray == OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT-1);
+}
+
+OC_PRIVATE ocResult ocDynamicsWorldGrowBodies(ocDynamicsWorld* pWorld)
+{
+    ocAssert(pWorld != NULL);
+
+    ocUInt32 newCapacity = ocMax(pWorld->bodyCapacity * 2, 64U);
+
+    void** ppArrays[OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT];
+    ocSizeT elementSizes[OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT];
+    ocDynamicsWorldGetBodyArrays(pWorld, ppArrays, elementSizes);
+
+    ocSizeT dataSize = 0;
+    for (ocUInt32 iArray = 0; ppArrays[iArray] != NULL; ++iArray) {
+        dataSize += newCapacity * elementSizes[iArray];
+    }
+
+    ocUInt8* pNewData = (ocUInt8*)ocMalloc(dataSize);
+    if (pNewData == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocUInt8* pCursor = pNewData;
+    for (ocUInt32 iArray = 0; ppArrays[iArray] != NULL; ++iArray) {
+        if (pWorld->bodyCount > 0) {
+            ocCopyMemory(pCursor, *ppArrays[iArray], pWorld->bodyCount * elementSizes[iArray]);
+        }
+
+        *ppArrays[iArray] = pCursor;
+        pCursor += newCapacity * elementSizes[iArray];
+    }
+
+    ocFree(pWorld->pBodyData);
+    pWorld->pBodyData    = pNewData;
+    pWorld->bodyCapacity = newCapacity;
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocDynamicsWorldAllocBodyID(ocDynamicsWorld* pWorld, ocDynamicsBodyID* pBodyID)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(pBodyID != NULL);
+
+    if (ocStackTop(&pWorld->freeBodyIDs, pBodyID) == OC_SUCCESS) {
+        ocStackPop(&pWorld->freeBodyIDs);
+        return OC_SUCCESS;
+    }
+
+    ocUInt32 newCapacity = ocMax(pWorld->bodyIDCapacity * 2, 64U);
+    ocUInt32* pNewIndices = (ocUInt32*)ocRealloc(pWorld->pBodyIndices, newCapacity * sizeof(*pNewIndices));
+    if (pNewIndices == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // The new IDs are pushed in reverse so the lowest ones are used first.
+    ocUInt32 oldCapacity = pWorld->bodyIDCapacity;
+    pWorld->pBodyIndices   = pNewIndices;
+    pWorld->bodyIDCapacity = newCapacity;
+    for (ocUInt32 iID = newCapacity-1; iID > oldCapacity; --iID) {
+        ocResult result = ocStackPush(&pWorld->freeBodyIDs, iID);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    *pBodyID = oldCapacity;
+    return OC_SUCCESS;
+}
+
+// Swaps two bodies in the arrays, which changes their indices.
+OC_PRIVATE void ocDynamicsWorldSwapBodies(ocDynamicsWorld* pWorld, ocUInt32 indexA, ocUInt32 indexB)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(indexA < pWorld->bodyCount && indexB < pWorld->bodyCount);
+
+    if (indexA == indexB) {
+        return;
+    }
+
+    void** ppArrays[OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT];
+    ocSizeT elementSizes[OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT];
+    ocDynamicsWorldGetBodyArrays(pWorld, ppArrays, elementSizes);
+
+    for (ocUInt32 iArray = 0; ppArrays[iArray] != NULL; ++iArray) {
+        ocUInt8 temp[sizeof(ocDynamicsBodyDesc)];
+        ocAssert(elementSizes[iArray] <= sizeof(temp));
+
+        ocUInt8* pArray = (ocUInt8*)*ppArrays[iArray];
+        ocCopyMemory(temp, pArray + indexA*elementSizes[iArray], elementSizes[iArray]);
+        ocCopyMemory(pArray + indexA*elementSizes[iArray], pArray + indexB*elementSizes[iArray], elementSizes[iArray]);
+        ocCopyMemory(pArray + indexB*elementSizes[iArray], temp, elementSizes[iArray]);
+    }
+
+    pWorld->pBodyIndices[pWorld->pBodyIDs[indexA]] = indexA;
+    pWorld->pBodyIndices[pWorld->pBodyIDs[indexB]] = indexB;
+}
+
+OC_INLINE glm::vec3 ocDynamicsWorldGetPosition(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    return glm::vec3(pWorld->pPositionX[index], pWorld->pPositionY[index], pWorld->pPositionZ[index]);
+}
+
+OC_INLINE glm::quat ocDynamicsWorldGetRotation(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    return glm::quat(pWorld->pRotationW[index], pWorld->pRotationX[index], pWorld->pRotationY[index], pWorld->pRotationZ[index]);
+}
+
+OC_INLINE glm::vec3 ocDynamicsWorldGetLinearVelocity(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    return glm::vec3(pWorld->pLinearVelocityX[index], pWorld->pLinearVelocityY[index], pWorld->pLinearVelocityZ[index]);
+}
+
+OC_INLINE glm::vec3 ocDynamicsWorldGetAngularVelocity(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    return glm::vec3(pWorld->pAngularVelocityX[index], pWorld->pAngularVelocityY[index], pWorld->pAngularVelocityZ[index]);
+}
+
+OC_INLINE void ocDynamicsWorldSetVelocities(ocDynamicsWorld* pWorld, ocUInt32 index, const glm::vec3 &linearVelocity, const glm::vec3 &angularVelocity)
+{
+    pWorld->pLinearVelocityX[index]  = linearVelocity.x;
+    pWorld->pLinearVelocityY[index]  = linearVelocity.y;
+    pWorld->pLinearVelocityZ[index]  = linearVelocity.z;
+    pWorld->pAngularVelocityX[index] = angularVelocity.x;
+    pWorld->pAngularVelocityY[index] = angularVelocity.y;
+    pWorld->pAngularVelocityZ[index] = angularVelocity.z;
+}
+
+// The inverse mass of a body as far as contacts are concerned. Sleeping bodies are treated like static bodies until they're woken.
+OC_INLINE float ocDynamicsWorldGetContactInvMass(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    return (index < pWorld->awakeBodyCount) ? pWorld->pInvMass[index] : 0;
+}
+
+OC_INLINE ocBool32 ocDynamicsWorldIsSleeping(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    return index >= pWorld->awakeBodyCount && pWorld->pInvMass[index] > 0;
+}
+
+// Updates the bounds of a single body, for bodies that have been moved outside of a step.
+OC_PRIVATE void ocDynamicsWorldUpdateBodyBounds(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+    ocCollisionShapeGetAABB(&pWorld->pDescs[index].shape, ocDynamicsWorldGetPosition(pWorld, index), ocDynamicsWorldGetRotation(pWorld, index), aabbMin, aabbMax);
+    pWorld->pAABBMinX[index] = aabbMin.x - OC_DYNAMICS_CONTACT_MARGIN;
+    pWorld->pAABBMinY[index] = aabbMin.y - OC_DYNAMICS_CONTACT_MARGIN;
+    pWorld->pAABBMinZ[index] = aabbMin.z - OC_DYNAMICS_CONTACT_MARGIN;
+    pWorld->pAABBMaxX[index] = aabbMax.x + OC_DYNAMICS_CONTACT_MARGIN;
+    pWorld->pAABBMaxY[index] = aabbMax.y + OC_DYNAMICS_CONTACT_MARGIN;
+    pWorld->pAABBMaxZ[index] = aabbMax.z + OC_DYNAMICS_CONTACT_MARGIN;
+}
+
+OC_INLINE ocBroadphaseBounds ocDynamicsWorldGetBroadphaseBounds(ocDynamicsWorld* pWorld)
+{
+    ocBroadphaseBounds bounds;
+    bounds.pMinX    = pWorld->pAABBMinX;
+    bounds.pMinY    = pWorld->pAABBMinY;
+    bounds.pMinZ    = pWorld->pAABBMinZ;
+    bounds.pMaxX    = pWorld->pAABBMaxX;
+    bounds.pMaxY    = pWorld->pAABBMaxY;
+    bounds.pMaxZ    = pWorld->pAABBMaxZ;
+    bounds.pIndices = pWorld->pBodyIndices;
+    return bounds;
+}
+
+OC_INLINE ocCollisionObject ocDynamicsWorldGetCollisionObject(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    ocCollisionObject object;
+    object.pShape   = &pWorld->pDescs[index].shape;
+    object.position = ocDynamicsWorldGetPosition(pWorld, index);
+    object.rotation = ocDynamicsWorldGetRotation(pWorld, index);
+    return object;
+}
+
+// Runs every job in pWorld->jobs, in parallel when there's a job queue.
+OC_PRIVATE void ocDynamicsWorldRunJobs(ocDynamicsWorld* pWorld, ocJobProc proc)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(proc != NULL);
+
+    ocDynamicsJob* pJobs = pWorld->jobs.pItems;
+    ocUInt32 jobCount = (ocUInt32)pWorld->jobs.count;
+
+    if (pWorld->pJobQueue != NULL && jobCount > 1) {
+        ocUInt32 counter = 0;
+        for (ocUInt32 iJob = 0; iJob < jobCount; ++iJob) {
+            if (ocJobQueueSubmit(pWorld->pJobQueue, proc, &pJobs[iJob], &counter) != OC_SUCCESS) {
+                proc(&pJobs[iJob]);
+            }
+        }
+
+        ocJobQueueWaitForCounter(pWorld->pJobQueue, &counter);
+    } else {
+        for (ocUInt32 iJob = 0; iJob < jobCount; ++iJob) {
+            proc(&pJobs[iJob]);
+        }
+    }
+}
+
+OC_PRIVATE ocResult ocDynamicsWorldPushJob(ocDynamicsWorld* pWorld, ocUInt32 begin, ocUInt32 end, float dt)
+{
+    ocDynamicsJob job;
+    job.pWorld = pWorld;
+    job.begin  = begin;
+    job.end    = end;
+    job.dt     = dt;
+    job.pQueries = NULL;
+    job.pHits    = NULL;
+    return ocStackPush(&pWorld->jobs, job);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Integration
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Applies gravity and damping to the velocity of every awake body.
+OC_PRIVATE void ocDynamicsWorldIntegrateVelocities(ocDynamicsWorld* pWorld, float dt)
+{
+    const ocUInt32 count = pWorld->awakeBodyCount;
+    const glm::vec3 gravity = pWorld->gravity * dt;
+    ocUInt32 i = 0;
+
+#ifdef OC_SUPPORT_SSE2
+    const __m128 vGravityX = _mm_set1_ps(gravity.x);
+    const __m128 vGravityY = _mm_set1_ps(gravity.y);
+    const __m128 vGravityZ = _mm_set1_ps(gravity.z);
+    const __m128 vDt       = _mm_set1_ps(dt);
+    const __m128 vOne      = _mm_set1_ps(1);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 linearScale  = _mm_div_ps(vOne, _mm_add_ps(vOne, _mm_mul_ps(vDt, _mm_loadu_ps(pWorld->pLinearDamping  + i))));
+        __m128 angularScale = _mm_div_ps(vOne, _mm_add_ps(vOne, _mm_mul_ps(vDt, _mm_loadu_ps(pWorld->pAngularDamping + i))));
+
+        _mm_storeu_ps(pWorld->pLinearVelocityX + i, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pWorld->pLinearVelocityX + i), vGravityX), linearScale));
+        _mm_storeu_ps(pWorld->pLinearVelocityY + i, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pWorld->pLinearVelocityY + i), vGravityY), linearScale));
+        _mm_storeu_ps(pWorld->pLinearVelocityZ + i, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(pWorld->pLinearVelocityZ + i), vGravityZ), linearScale));
+        _mm_storeu_ps(pWorld->pAngularVelocityX + i, _mm_mul_ps(_mm_loadu_ps(pWorld->pAngularVelocityX + i), angularScale));
+        _mm_storeu_ps(pWorld->pAngularVelocityY + i, _mm_mul_ps(_mm_loadu_ps(pWorld->pAngularVelocityY + i), angularScale));
+        _mm_storeu_ps(pWorld->pAngularVelocityZ + i, _mm_mul_ps(_mm_loadu_ps(pWorld->pAngularVelocityZ + i), angularScale));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        float linearScale  = 1 / (1 + dt*pWorld->pLinearDamping[i]);
+        float angularScale = 1 / (1 + dt*pWorld->pAngularDamping[i]);
+
+        pWorld->pLinearVelocityX[i]   = (pWorld->pLinearVelocityX[i] + gravity.x) * linearScale;
+        pWorld->pLinearVelocityY[i]   = (pWorld->pLinearVelocityY[i] + gravity.y) * linearScale;
+        pWorld->pLinearVelocityZ[i]   = (pWorld->pLinearVelocityZ[i] + gravity.z) * linearScale;
+        pWorld->pAngularVelocityX[i] *= angularScale;
+        pWorld->pAngularVelocityY[i] *= angularScale;
+        pWorld->pAngularVelocityZ[i] *= angularScale;
+    }
+}
+
+// Moves every awake body by it's velocity. Rotations are integrated with q' = q + 0.5*dt*w*q, where w is the angular velocity as a pure
+// quaternion, and then normalized.
+OC_PRIVATE void ocDynamicsWorldIntegratePositions(ocDynamicsWorld* pWorld, float dt)
+{
+    const ocUInt32 count = pWorld->awakeBodyCount;
+    const float halfDt = dt * 0.5f;
+    ocUInt32 i = 0;
+
+#ifdef OC_SUPPORT_SSE2
+    const __m128 vDt     = _mm_set1_ps(dt);
+    const __m128 vHalfDt = _mm_set1_ps(halfDt);
+
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(pWorld->pPositionX + i, _mm_add_ps(_mm_loadu_ps(pWorld->pPositionX + i), _mm_mul_ps(_mm_loadu_ps(pWorld->pLinearVelocityX + i), vDt)));
+        _mm_storeu_ps(pWorld->pPositionY + i, _mm_add_ps(_mm_loadu_ps(pWorld->pPositionY + i), _mm_mul_ps(_mm_loadu_ps(pWorld->pLinearVelocityY + i), vDt)));
+        _mm_storeu_ps(pWorld->pPositionZ + i, _mm_add_ps(_mm_loadu_ps(pWorld->pPositionZ + i), _mm_mul_ps(_mm_loadu_ps(pWorld->pLinearVelocityZ + i), vDt)));
+
+        __m128 wx = _mm_mul_ps(_mm_loadu_ps(pWorld->pAngularVelocityX + i), vHalfDt);
+        __m128 wy = _mm_mul_ps(_mm_loadu_ps(pWorld->pAngularVelocityY + i), vHalfDt);
+        __m128 wz = _mm_mul_ps(_mm_loadu_ps(pWorld->pAngularVelocityZ + i), vHalfDt);
+        __m128 qx = _mm_loadu_ps(pWorld->pRotationX + i);
+        __m128 qy = _mm_loadu_ps(pWorld->pRotationY + i);
+        __m128 qz = _mm_loadu_ps(pWorld->pRotationZ + i);
+        __m128 qw = _mm_loadu_ps(pWorld->pRotationW + i);
+
+        // (0, w) * q = (-w.q, qw*w + w x q)
+        __m128 nw = _mm_sub_ps(qw, _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, qx), _mm_mul_ps(wy, qy)), _mm_mul_ps(wz, qz)));
+        __m128 nx = _mm_add_ps(qx, _mm_add_ps(_mm_mul_ps(qw, wx), _mm_sub_ps(_mm_mul_ps(wy, qz), _mm_mul_ps(wz, qy))));
+        __m128 ny = _mm_add_ps(qy, _mm_add_ps(_mm_mul_ps(qw, wy), _mm_sub_ps(_mm_mul_ps(wz, qx), _mm_mul_ps(wx, qz))));
+        __m128 nz = _mm_add_ps(qz, _mm_add_ps(_mm_mul_ps(qw, wz), _mm_sub_ps(_mm_mul_ps(wx, qy), _mm_mul_ps(wy, qx))));
+
+        // A full precision square root rather than _mm_rsqrt_ps() so rotations don't drift for bodies that sit still for a long time.
+        __m128 invLength = _mm_div_ps(_mm_set1_ps(1), _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_add_ps(_mm_mul_ps(nz, nz), _mm_mul_ps(nw, nw)))));
+        _mm_storeu_ps(pWorld->pRotationX + i, _mm_mul_ps(nx, invLength));
+        _mm_storeu_ps(pWorld->pRotationY + i, _mm_mul_ps(ny, invLength));
+        _mm_storeu_ps(pWorld->pRotationZ + i, _mm_mul_ps(nz, invLength));
+        _mm_storeu_ps(pWorld->pRotationW + i, _mm_mul_ps(nw, invLength));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        pWorld->pPositionX[i] += pWorld->pLinearVelocityX[i] * dt;
+        pWorld->pPositionY[i] += pWorld->pLinearVelocityY[i] * dt;
+        pWorld->pPositionZ[i] += pWorld->pLinearVelocityZ[i] * dt;
+
+        float wx = pWorld->pAngularVelocityX[i] * halfDt;
+        float wy = pWorld->pAngularVelocityY[i] * halfDt;
+        float wz = pWorld->pAngularVelocityZ[i] * halfDt;
+        float qx = pWorld->pRotationX[i];
+        float qy = pWorld->pRotationY[i];
+        float qz = pWorld->pRotationZ[i];
+        float qw = pWorld->pRotationW[i];
+
+        float nw = qw - (wx*qx + wy*qy + wz*qz);
+        float nx = qx + qw*wx + (wy*qz - wz*qy);
+        float ny = qy + qw*wy + (wz*qx - wx*qz);
+        float nz = qz + qw*wz + (wx*qy - wy*qx);
+
+        float invLength = 1 / sqrtf(nx*nx + ny*ny + nz*nz + nw*nw);
+        pWorld->pRotationX[i] = nx * invLength;
+        pWorld->pRotationY[i] = ny * invLength;
+        pWorld->pRotationZ[i] = nz * invLength;
+        pWorld->pRotationW[i] = nw * invLength;
+    }
+}
+
+// Updates the bounding boxes and world space inverse inertia of every awake body. Static and sleeping bodies don't move, so theirs are
+// only updated when they're teleported.
+OC_PRIVATE void ocDynamicsWorldUpdateBodies(ocDynamicsWorld* pWorld)
+{
+    for (ocUInt32 i = 0; i < pWorld->awakeBodyCount; ++i) {
+        glm::vec3 position = ocDynamicsWorldGetPosition(pWorld, i);
+        glm::quat rotation = ocDynamicsWorldGetRotation(pWorld, i);
+
+        glm::vec3 aabbMin;
+        glm::vec3 aabbMax;
+        ocCollisionShapeGetAABB(&pWorld->pDescs[i].shape, position, rotation, aabbMin, aabbMax);
+        pWorld->pAABBMinX[i] = aabbMin.x - OC_DYNAMICS_CONTACT_MARGIN;
+        pWorld->pAABBMinY[i] = aabbMin.y - OC_DYNAMICS_CONTACT_MARGIN;
+        pWorld->pAABBMinZ[i] = aabbMin.z - OC_DYNAMICS_CONTACT_MARGIN;
+        pWorld->pAABBMaxX[i] = aabbMax.x + OC_DYNAMICS_CONTACT_MARGIN;
+        pWorld->pAABBMaxY[i] = aabbMax.y + OC_DYNAMICS_CONTACT_MARGIN;
+        pWorld->pAABBMaxZ[i] = aabbMax.z + OC_DYNAMICS_CONTACT_MARGIN;
+
+        // R * diag(I^-1) * R^T
+        glm::mat3 r = glm::mat3_cast(rotation);
+        glm::mat3 scaled = r;
+        scaled[0] *= pWorld->pLocalInvInertia[i].x;
+        scaled[1] *= pWorld->pLocalInvInertia[i].y;
+        scaled[2] *= pWorld->pLocalInvInertia[i].z;
+        pWorld->pInvInertia[i] = scaled * glm::transpose(r);
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Narrow Phase
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Finds the contacts for a range of pairs. Sphere pairs are gathered and done together with ocCollideSpheres(), mesh pairs go through
+// ocTriangleMeshCollide() and everything else goes through ocCollide(). Each pair writes to it's own manifold, or it's own range of
+// meshContacts, so jobs never touch the same memory.
+OC_PRIVATE void ocDynamicsWorldNarrowphaseJobProc(void* pUserData)
+{
+    ocDynamicsJob* pJob = (ocDynamicsJob*)pUserData;
+    ocDynamicsWorld* pWorld = pJob->pWorld;
+    const ocBroadphasePair* pPairs = pWorld->pairs.pItems;
+    ocContactManifold* pManifolds = pWorld->manifolds.pItems;
+
+    float centerAX[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    float centerAY[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    float centerAZ[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    float radiusA[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    float centerBX[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    float centerBY[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    float centerBZ[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    float radiusB[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    ocUInt32 spherePairIndices[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    ocContactManifold sphereManifolds[OC_DYNAMICS_NARROWPHASE_BATCH_SIZE];
+    ocUInt32 spherePairCount = 0;
+
+    ocAssert(pJob->end - pJob->begin <= OC_DYNAMICS_NARROWPHASE_BATCH_SIZE);
+
+    for (ocUInt32 iPair = pJob->begin; iPair < pJob->end; ++iPair) {
+        ocUInt32 indexA = pPairs[iPair].indexA;
+        ocUInt32 indexB = pPairs[iPair].indexB;
+        const ocCollisionShape* pShapeA = &pWorld->pDescs[indexA].shape;
+        const ocCollisionShape* pShapeB = &pWorld->pDescs[indexB].shape;
+
+        if (iPair >= pWorld->meshPairBegin) {
+            ocCollisionObject a = ocDynamicsWorldGetCollisionObject(pWorld, indexA);
+            ocCollisionObject b = ocDynamicsWorldGetCollisionObject(pWorld, indexB);
+            ocTriangleMeshContact* pMeshContacts = &pWorld->meshContacts.pItems[(iPair - pWorld->meshPairBegin) * OC_DYNAMICS_MAX_MESH_CONTACTS];
+            ocUInt32 meshContactCount = ocTriangleMeshCollide(&a, &b, OC_DYNAMICS_CONTACT_MARGIN, pMeshContacts, OC_DYNAMICS_MAX_MESH_CONTACTS);
+            for (ocUInt32 iContact = meshContactCount; iContact < OC_DYNAMICS_MAX_MESH_CONTACTS; ++iContact) {
+                pMeshContacts[iContact].manifold.pointCount = 0;
+            }
+
+            pManifolds[iPair].pointCount = 0;
+            continue;
+        }
+
+        if (pShapeA->type == ocCollisionShapeType_Sphere && pShapeB->type == ocCollisionShapeType_Sphere) {
+            centerAX[spherePairCount] = pWorld->pPositionX[indexA];
+            centerAY[spherePairCount] = pWorld->pPositionY[indexA];
+            centerAZ[spherePairCount] = pWorld->pPositionZ[indexA];
+            radiusA[spherePairCount]  = pShapeA->sphere.radius;
+            centerBX[spherePairCount] = pWorld->pPositionX[indexB];
+            centerBY[spherePairCount] = pWorld->pPositionY[indexB];
+            centerBZ[spherePairCount] = pWorld->pPositionZ[indexB];
+            radiusB[spherePairCount]  = pShapeB->sphere.radius;
+            spherePairIndices[spherePairCount] = iPair;
+            spherePairCount += 1;
+            continue;
+        }
+
+        ocCollisionObject a = ocDynamicsWorldGetCollisionObject(pWorld, indexA);
+        ocCollisionObject b = ocDynamicsWorldGetCollisionObject(pWorld, indexB);
+        ocCollide(&a, &b, OC_DYNAMICS_CONTACT_MARGIN, &pManifolds[iPair]);
+    }
+
+    if (spherePairCount > 0) {
+        ocSpherePairs spheres;
+        spheres.pCenterAX = centerAX;
+        spheres.pCenterAY = centerAY;
+        spheres.pCenterAZ = centerAZ;
+        spheres.pRadiusA  = radiusA;
+        spheres.pCenterBX = centerBX;
+        spheres.pCenterBY = centerBY;
+        spheres.pCenterBZ = centerBZ;
+        spheres.pRadiusB  = radiusB;
+        ocCollideSpheres(&spheres, spherePairCount, OC_DYNAMICS_CONTACT_MARGIN, sphereManifolds);
+
+        for (ocUInt32 iSphere = 0; iSphere < spherePairCount; ++iSphere) {
+            pManifolds[spherePairIndices[iSphere]] = sphereManifolds[iSphere];
+        }
+    }
+}
+
+OC_PRIVATE ocResult ocDynamicsWorldFindContacts(ocDynamicsWorld* pWorld, float dt)
+{
+    ocStackClear(&pWorld->pairs);
+
+    ocBroadphaseBounds bounds = ocDynamicsWorldGetBroadphaseBounds(pWorld);
+    ocResult result = ocBroadphaseFindPairs(&pWorld->broadphase, &bounds, &pWorld->pairs);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // A is always the body with the lower ID so the normal of a pair has the same direction from one step to the next.
+    ocUInt32 pairCount = (ocUInt32)pWorld->pairs.count;
+    for (ocUInt32 iPair = 0; iPair < pairCount; ++iPair) {
+        ocBroadphasePair* pPair = &pWorld->pairs.pItems[iPair];
+        if (pWorld->pBodyIDs[pPair->indexA] > pWorld->pBodyIDs[pPair->indexB]) {
+            ocUInt32 temp = pPair->indexA;
+            pPair->indexA = pPair->indexB;
+            pPair->indexB = temp;
+        }
+    }
+
+    // Pairs with a triangle mesh are moved to the end. Only one of the bodies can be a mesh since meshes are always static.
+    ocUInt32 meshPairBegin = pairCount;
+    for (ocUInt32 iPair = 0; iPair < meshPairBegin; ) {
+        ocBroadphasePair* pPair = &pWorld->pairs.pItems[iPair];
+        if (pWorld->pDescs[pPair->indexA].shape.type == ocCollisionShapeType_TriangleMesh || pWorld->pDescs[pPair->indexB].shape.type == ocCollisionShapeType_TriangleMesh) {
+            meshPairBegin -= 1;
+            ocBroadphasePair temp = *pPair;
+            *pPair = pWorld->pairs.pItems[meshPairBegin];
+            pWorld->pairs.pItems[meshPairBegin] = temp;
+        } else {
+            iPair += 1;
+        }
+    }
+    pWorld->meshPairBegin = meshPairBegin;
+
+    result = ocStackResize(&pWorld->manifolds, pairCount);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackResize(&pWorld->meshContacts, (pairCount - meshPairBegin) * OC_DYNAMICS_MAX_MESH_CONTACTS);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocStackClear(&pWorld->jobs);
+    for (ocUInt32 iPair = 0; iPair < pairCount; iPair += OC_DYNAMICS_NARROWPHASE_BATCH_SIZE) {
+        result = ocDynamicsWorldPushJob(pWorld, iPair, ocMin(iPair + OC_DYNAMICS_NARROWPHASE_BATCH_SIZE, pairCount), dt);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    ocDynamicsWorldRunJobs(pWorld, ocDynamicsWorldNarrowphaseJobProc);
+
+    return OC_SUCCESS;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Contacts
+//
+///////////////////////////////////////////////////////////////////////////////
+
+OC_PRIVATE int ocDynamicsContactCompare(const void* a, const void* b)
+{
+    const ocDynamicsContact* pContactA = (const ocDynamicsContact*)a;
+    const ocDynamicsContact* pContactB = (const ocDynamicsContact*)b;
+
+    if (pContactA->key < pContactB->key) return -1;
+    if (pContactA->key > pContactB->key) return +1;
+    if (pContactA->subKey < pContactB->subKey) return -1;
+    if (pContactA->subKey > pContactB->subKey) return +1;
+    return 0;
+}
+
+OC_PRIVATE const ocDynamicsContact* ocDynamicsWorldFindPrevContact(ocDynamicsWorld* pWorld, ocUInt64 key, ocUInt32 subKey)
+{
+    ocSizeT lo = 0;
+    ocSizeT hi = pWorld->prevContacts.count;
+    while (lo < hi) {
+        ocSizeT mid = (lo + hi) / 2;
+        const ocDynamicsContact* pMid = &pWorld->prevContacts.pItems[mid];
+        if (pMid->key == key && pMid->subKey == subKey) {
+            return pMid;
+        }
+
+        if (pMid->key < key || (pMid->key == key && pMid->subKey < subKey)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return NULL;
+}
+
+OC_INLINE float ocDynamicsEffectiveMass(float invMassA, float invMassB, const glm::mat3 &invInertiaA, const glm::mat3 &invInertiaB, const glm::vec3 &anchorA, const glm::vec3 &anchorB, const glm::vec3 &direction)
+{
+    glm::vec3 rnA = glm::cross(anchorA, direction);
+    glm::vec3 rnB = glm::cross(anchorB, direction);
+    float k = invMassA + invMassB + glm::dot(rnA, invInertiaA * rnA) + glm::dot(rnB, invInertiaB * rnB);
+    return (k > 0) ? 1 / k : 0;
+}
+
+// Turns a manifold from the narrow phase into a contact constraint, carrying over the impulses of points that were also touching on the
+// previous step.
+OC_PRIVATE ocResult ocDynamicsWorldAddContact(ocDynamicsWorld* pWorld, ocUInt32 indexA, ocUInt32 indexB, ocUInt32 subKey, const ocContactManifold* pManifold, float dt)
+{
+    const float invDt = 1 / dt;
+
+    glm::vec3 positionA = ocDynamicsWorldGetPosition(pWorld, indexA);
+    glm::vec3 positionB = ocDynamicsWorldGetPosition(pWorld, indexB);
+    glm::quat inverseRotationA = glm::conjugate(ocDynamicsWorldGetRotation(pWorld, indexA));
+    glm::vec3 linearVelocityA  = ocDynamicsWorldGetLinearVelocity(pWorld, indexA);
+    glm::vec3 linearVelocityB  = ocDynamicsWorldGetLinearVelocity(pWorld, indexB);
+    glm::vec3 angularVelocityA = ocDynamicsWorldGetAngularVelocity(pWorld, indexA);
+    glm::vec3 angularVelocityB = ocDynamicsWorldGetAngularVelocity(pWorld, indexB);
+    float invMassA = ocDynamicsWorldGetContactInvMass(pWorld, indexA);
+    float invMassB = ocDynamicsWorldGetContactInvMass(pWorld, indexB);
+    const glm::mat3 &invInertiaA = pWorld->pInvInertia[indexA];
+    const glm::mat3 &invInertiaB = pWorld->pInvInertia[indexB];
+
+    ocDynamicsContact contact;
+    contact.key         = ((ocUInt64)pWorld->pBodyIDs[indexA] << 32) | pWorld->pBodyIDs[indexB];
+    contact.subKey      = subKey;
+    contact.indexA      = indexA;
+    contact.indexB      = indexB;
+    contact.normal      = pManifold->normal;
+    contact.friction    = sqrtf(pWorld->pDescs[indexA].friction * pWorld->pDescs[indexB].friction);
+    contact.restitution = ocMax(pWorld->pDescs[indexA].restitution, pWorld->pDescs[indexB].restitution);
+    contact.pointCount  = pManifold->pointCount;
+    ocCollisionMakeBasis(contact.normal, contact.tangents[0], contact.tangents[1]);
+
+    const ocDynamicsContact* pPrevContact = ocDynamicsWorldFindPrevContact(pWorld, contact.key, contact.subKey);
+
+    for (ocUInt32 iPoint = 0; iPoint < contact.pointCount; ++iPoint) {
+        ocDynamicsContactPoint* pPoint = &contact.points[iPoint];
+        pPoint->anchorA        = pManifold->points[iPoint].position - positionA;
+        pPoint->anchorB        = pManifold->points[iPoint].position - positionB;
+        pPoint->localAnchorA   = inverseRotationA * pPoint->anchorA;
+        pPoint->separation     = pManifold->points[iPoint].separation;
+        pPoint->normalMass     = ocDynamicsEffectiveMass(invMassA, invMassB, invInertiaA, invInertiaB, pPoint->anchorA, pPoint->anchorB, contact.normal);
+        pPoint->tangentMass[0] = ocDynamicsEffectiveMass(invMassA, invMassB, invInertiaA, invInertiaB, pPoint->anchorA, pPoint->anchorB, contact.tangents[0]);
+        pPoint->tangentMass[1] = ocDynamicsEffectiveMass(invMassA, invMassB, invInertiaA, invInertiaB, pPoint->anchorA, pPoint->anchorB, contact.tangents[1]);
+        pPoint->normalImpulse     = 0;
+        pPoint->tangentImpulse[0] = 0;
+        pPoint->tangentImpulse[1] = 0;
+
+        // Points that are apart are allowed to close the gap in this step, but no more. Points that overlap are pushed apart by a
+        // fraction of the overlap.
+        float s = pPoint->separation;
+        if (s > 0) {
+            pPoint->bias = s * invDt;
+        } else {
+            pPoint->bias = OC_DYNAMICS_BAUMGARTE * invDt * ocMin(0.0f, s + OC_DYNAMICS_ALLOWED_PENETRATION);
+        }
+
+        // Bouncing. Only done when the points will actually meet during this step.
+        glm::vec3 relativeVelocity = linearVelocityB + glm::cross(angularVelocityB, pPoint->anchorB) - linearVelocityA - glm::cross(angularVelocityA, pPoint->anchorA);
+        float approachVelocity = glm::dot(relativeVelocity, contact.normal);
+        if (contact.restitution > 0 && approachVelocity < -OC_DYNAMICS_RESTITUTION_THRESHOLD && s + approachVelocity*dt < 0) {
+            pPoint->bias = ocMin(pPoint->bias, contact.restitution * approachVelocity);
+        }
+
+        // Warm starting.
+        if (pPrevContact != NULL) {
+            float bestDistanceSq = OC_DYNAMICS_WARM_START_DISTANCE * OC_DYNAMICS_WARM_START_DISTANCE;
+            for (ocUInt32 iPrevPoint = 0; iPrevPoint < pPrevContact->pointCount; ++iPrevPoint) {
+                const ocDynamicsContactPoint* pPrevPoint = &pPrevContact->points[iPrevPoint];
+                glm::vec3 delta = pPrevPoint->localAnchorA - pPoint->localAnchorA;
+                float distanceSq = glm::dot(delta, delta);
+                if (distanceSq < bestDistanceSq) {
+                    bestDistanceSq = distanceSq;
+                    pPoint->normalImpulse     = pPrevPoint->normalImpulse;
+                    pPoint->tangentImpulse[0] = pPrevPoint->tangentImpulse[0];
+                    pPoint->tangentImpulse[1] = pPrevPoint->tangentImpulse[1];
+                }
+            }
+        }
+    }
+
+    return ocStackPush(&pWorld->contacts, contact);
+}
+
+OC_PRIVATE ocResult ocDynamicsWorldBuildContacts(ocDynamicsWorld* pWorld, float dt)
+{
+    // The new contacts are built into what was the previous step's array, which is no longer needed once this is done.
+    ocStack<ocDynamicsContact> temp = pWorld->prevContacts;
+    pWorld->prevContacts = pWorld->contacts;
+    pWorld->contacts = temp;
+    ocStackClear(&pWorld->contacts);
+
+    for (ocUInt32 iPair = 0; iPair < pWorld->meshPairBegin; ++iPair) {
+        const ocContactManifold* pManifold = &pWorld->manifolds.pItems[iPair];
+        if (pManifold->pointCount == 0) {
+            continue;
+        }
+
+        ocResult result = ocDynamicsWorldAddContact(pWorld, pWorld->pairs.pItems[iPair].indexA, pWorld->pairs.pItems[iPair].indexB, 0, pManifold, dt);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    for (ocUInt32 iPair = pWorld->meshPairBegin; iPair < pWorld->pairs.count; ++iPair) {
+        const ocTriangleMeshContact* pMeshContacts = &pWorld->meshContacts.pItems[(iPair - pWorld->meshPairBegin) * OC_DYNAMICS_MAX_MESH_CONTACTS];
+        for (ocUInt32 iContact = 0; iContact < OC_DYNAMICS_MAX_MESH_CONTACTS; ++iContact) {
+            if (pMeshContacts[iContact].manifold.pointCount == 0) {
+                continue;
+            }
+
+            ocResult result = ocDynamicsWorldAddContact(pWorld, pWorld->pairs.pItems[iPair].indexA, pWorld->pairs.pItems[iPair].indexB, pMeshContacts[iContact].triangleIndex, &pMeshContacts[iContact].manifold, dt);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+        }
+    }
+
+    // Sorted so the next step can find them with a binary search.
+    if (pWorld->contacts.count > 1) {
+        qsort(pWorld->contacts.pItems, pWorld->contacts.count, sizeof(ocDynamicsContact), ocDynamicsContactCompare);
+    }
+
+    return OC_SUCCESS;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Islands
+//
+///////////////////////////////////////////////////////////////////////////////
+
+OC_INLINE ocUInt32 ocDynamicsIslandFind(ocUInt32* pParents, ocUInt32 index)
+{
+    while (pParents[index] != index) {
+        pParents[index] = pParents[pParents[index]];    // <-- Path halving.
+        index = pParents[index];
+    }
+
+    return index;
+}
+
+// Groups the contacts by island, and then splits the islands into solver jobs. An island is never split between jobs. Only awake bodies
+// are part of islands. Sleeping bodies that are touched by an awake body are queued to be woken at the end of the step.
+OC_PRIVATE ocResult ocDynamicsWorldBuildIslands(ocDynamicsWorld* pWorld, float dt)
+{
+    ocUInt32 bodyCount = pWorld->awakeBodyCount;
+    ocUInt32 contactCount = (ocUInt32)pWorld->contacts.count;
+
+    ocResult result = ocStackResize(&pWorld->islandParents, bodyCount);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackResize(&pWorld->islandOffsets, bodyCount + 1);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackResize(&pWorld->islandContacts, contactCount);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocUInt32* pParents = pWorld->islandParents.pItems;
+    ocUInt32* pOffsets = pWorld->islandOffsets.pItems;
+    for (ocUInt32 i = 0; i < bodyCount; ++i) {
+        pParents[i] = i;
+        pOffsets[i] = 0;
+    }
+    pOffsets[bodyCount] = 0;
+
+    // Static and sleeping bodies don't join islands together.
+    const ocDynamicsContact* pContacts = pWorld->contacts.pItems;
+    for (ocUInt32 iContact = 0; iContact < contactCount; ++iContact) {
+        ocUInt32 indexA = pContacts[iContact].indexA;
+        ocUInt32 indexB = pContacts[iContact].indexB;
+        if (indexA < bodyCount && indexB < bodyCount) {
+            ocUInt32 rootA = ocDynamicsIslandFind(pParents, indexA);
+            ocUInt32 rootB = ocDynamicsIslandFind(pParents, indexB);
+            if (rootA != rootB) {
+                pParents[ocMax(rootA, rootB)] = ocMin(rootA, rootB);
+            }
+        } else {
+            ocUInt32 otherIndex = (indexA < bodyCount) ? indexB : indexA;
+            if (ocDynamicsWorldIsSleeping(pWorld, otherIndex)) {
+                result = ocStackPush(&pWorld->bodiesToWake, pWorld->pBodyIDs[otherIndex]);
+                if (result != OC_SUCCESS) {
+                    return result;
+                }
+            }
+        }
+    }
+
+    // A counting sort by the root of each contact's island. The broadphase never reports pairs of passive bodies, so every contact has
+    // at least one awake body.
+    for (ocUInt32 iContact = 0; iContact < contactCount; ++iContact) {
+        ocUInt32 index = (pContacts[iContact].indexA < bodyCount) ? pContacts[iContact].indexA : pContacts[iContact].indexB;
+        pOffsets[ocDynamicsIslandFind(pParents, index)] += 1;
+    }
+
+    ocUInt32 runningOffset = 0;
+    for (ocUInt32 i = 0; i <= bodyCount; ++i) {
+        ocUInt32 count = pOffsets[i];
+        pOffsets[i] = runningOffset;
+        runningOffset += count;
+    }
+
+    ocUInt32* pIslandContacts = pWorld->islandContacts.pItems;
+    for (ocUInt32 iContact = 0; iContact < contactCount; ++iContact) {
+        ocUInt32 index = (pContacts[iContact].indexA < bodyCount) ? pContacts[iContact].indexA : pContacts[iContact].indexB;
+        pIslandContacts[pOffsets[ocDynamicsIslandFind(pParents, index)]++] = iContact;
+    }
+
+    // The offsets now point to the end of each island, which is the start of the next one. Islands are added to the current job until
+    // it's big enough.
+    ocStackClear(&pWorld->jobs);
+    ocUInt32 jobBegin = 0;
+    for (ocUInt32 i = 0; i < bodyCount; ++i) {
+        ocUInt32 islandEnd = pOffsets[i];
+        if (islandEnd - jobBegin >= OC_DYNAMICS_MIN_ISLAND_BATCH_SIZE) {
+            result = ocDynamicsWorldPushJob(pWorld, jobBegin, islandEnd, dt);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+
+            jobBegin = islandEnd;
+        }
+    }
+
+    if (jobBegin < contactCount) {
+        result = ocDynamicsWorldPushJob(pWorld, jobBegin, contactCount, dt);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    return OC_SUCCESS;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Solver
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// The velocities of both bodies of a contact, loaded once per contact rather than once per point.
+struct ocDynamicsSolverBodies
+{
+    glm::vec3 linearVelocityA;
+    glm::vec3 angularVelocityA;
+    glm::vec3 linearVelocityB;
+    glm::vec3 angularVelocityB;
+    float invMassA;
+    float invMassB;
+    const glm::mat3* pInvInertiaA;
+    const glm::mat3* pInvInertiaB;
+};
+
+OC_INLINE void ocDynamicsSolverLoad(ocDynamicsWorld* pWorld, const ocDynamicsContact* pContact, ocDynamicsSolverBodies* pBodies)
+{
+    pBodies->linearVelocityA  = ocDynamicsWorldGetLinearVelocity(pWorld, pContact->indexA);
+    pBodies->angularVelocityA = ocDynamicsWorldGetAngularVelocity(pWorld, pContact->indexA);
+    pBodies->linearVelocityB  = ocDynamicsWorldGetLinearVelocity(pWorld, pContact->indexB);
+    pBodies->angularVelocityB = ocDynamicsWorldGetAngularVelocity(pWorld, pContact->indexB);
+    pBodies->invMassA         = ocDynamicsWorldGetContactInvMass(pWorld, pContact->indexA);
+    pBodies->invMassB         = ocDynamicsWorldGetContactInvMass(pWorld, pContact->indexB);
+    pBodies->pInvInertiaA     = &pWorld->pInvInertia[pContact->indexA];
+    pBodies->pInvInertiaB     = &pWorld->pInvInertia[pContact->indexB];
+}
+
+// Static and sleeping bodies can be shared with contacts in other islands being solved on other threads, so they're never written.
+OC_INLINE void ocDynamicsSolverStore(ocDynamicsWorld* pWorld, const ocDynamicsContact* pContact, const ocDynamicsSolverBodies* pBodies)
+{
+    if (pBodies->invMassA > 0) {
+        ocDynamicsWorldSetVelocities(pWorld, pContact->indexA, pBodies->linearVelocityA, pBodies->angularVelocityA);
+    }
+    if (pBodies->invMassB > 0) {
+        ocDynamicsWorldSetVelocities(pWorld, pContact->indexB, pBodies->linearVelocityB, pBodies->angularVelocityB);
+    }
+}
+
+OC_INLINE void ocDynamicsSolverApplyImpulse(ocDynamicsSolverBodies* pBodies, const ocDynamicsContactPoint* pPoint, const glm::vec3 &impulse)
+{
+    pBodies->linearVelocityA  -= impulse * pBodies->invMassA;
+    pBodies->angularVelocityA -= (*pBodies->pInvInertiaA) * glm::cross(pPoint->anchorA, impulse);
+    pBodies->linearVelocityB  += impulse * pBodies->invMassB;
+    pBodies->angularVelocityB += (*pBodies->pInvInertiaB) * glm::cross(pPoint->anchorB, impulse);
+}
+
+OC_INLINE float ocDynamicsSolverRelativeVelocity(const ocDynamicsSolverBodies* pBodies, const ocDynamicsContactPoint* pPoint, const glm::vec3 &direction)
+{
+    glm::vec3 velocityA = pBodies->linearVelocityA + glm::cross(pBodies->angularVelocityA, pPoint->anchorA);
+    glm::vec3 velocityB = pBodies->linearVelocityB + glm::cross(pBodies->angularVelocityB, pPoint->anchorB);
+    return glm::dot(velocityB - velocityA, direction);
+}
+
+OC_PRIVATE void ocDynamicsWorldSolverJobProc(void* pUserData)
+{
+    ocDynamicsJob* pJob = (ocDynamicsJob*)pUserData;
+    ocDynamicsWorld* pWorld = pJob->pWorld;
+    ocDynamicsContact* pContacts = pWorld->contacts.pItems;
+    const ocUInt32* pIslandContacts = pWorld->islandContacts.pItems;
+
+    // Warm starting. The impulses from the previous step are applied up front.
+    for (ocUInt32 i = pJob->begin; i < pJob->end; ++i) {
+        ocDynamicsContact* pContact = &pContacts[pIslandContacts[i]];
+
+        ocDynamicsSolverBodies bodies;
+        ocDynamicsSolverLoad(pWorld, pContact, &bodies);
+
+        for (ocUInt32 iPoint = 0; iPoint < pContact->pointCount; ++iPoint) {
+            const ocDynamicsContactPoint* pPoint = &pContact->points[iPoint];
+            glm::vec3 impulse = pContact->normal*pPoint->normalImpulse + pContact->tangents[0]*pPoint->tangentImpulse[0] + pContact->tangents[1]*pPoint->tangentImpulse[1];
+            ocDynamicsSolverApplyImpulse(&bodies, pPoint, impulse);
+        }
+
+        ocDynamicsSolverStore(pWorld, pContact, &bodies);
+    }
+
+    for (ocUInt32 iIteration = 0; iIteration < OC_DYNAMICS_VELOCITY_ITERATIONS; ++iIteration) {
+        for (ocUInt32 i = pJob->begin; i < pJob->end; ++i) {
+            ocDynamicsContact* pContact = &pContacts[pIslandContacts[i]];
+
+            ocDynamicsSolverBodies bodies;
+            ocDynamicsSolverLoad(pWorld, pContact, &bodies);
+
+            // Friction first so the normal impulse, which is more important, gets the final say.
+            for (ocUInt32 iPoint = 0; iPoint < pContact->pointCount; ++iPoint) {
+                ocDynamicsContactPoint* pPoint = &pContact->points[iPoint];
+                float maxFriction = pContact->friction * pPoint->normalImpulse;
+
+                for (ocUInt32 iTangent = 0; iTangent < 2; ++iTangent) {
+                    const glm::vec3 &tangent = pContact->tangents[iTangent];
+                    float lambda = -pPoint->tangentMass[iTangent] * ocDynamicsSolverRelativeVelocity(&bodies, pPoint, tangent);
+                    float newImpulse = ocClamp(pPoint->tangentImpulse[iTangent] + lambda, -maxFriction, maxFriction);
+                    lambda = newImpulse - pPoint->tangentImpulse[iTangent];
+                    pPoint->tangentImpulse[iTangent] = newImpulse;
+
+                    ocDynamicsSolverApplyImpulse(&bodies, pPoint, tangent * lambda);
+                }
+            }
+
+            for (ocUInt32 iPoint = 0; iPoint < pContact->pointCount; ++iPoint) {
+                ocDynamicsContactPoint* pPoint = &pContact->points[iPoint];
+                float lambda = -pPoint->normalMass * (ocDynamicsSolverRelativeVelocity(&bodies, pPoint, pContact->normal) + pPoint->bias);
+                float newImpulse = ocMax(pPoint->normalImpulse + lambda, 0.0f);
+                lambda = newImpulse - pPoint->normalImpulse;
+                pPoint->normalImpulse = newImpulse;
+
+                ocDynamicsSolverApplyImpulse(&bodies, pPoint, pContact->normal * lambda);
+            }
+
+            ocDynamicsSolverStore(pWorld, pContact, &bodies);
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Sleeping
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Wakes the island of a sleeping body by walking the ring of it's bodies and moving each of them to the end of the awake range. Does
+// nothing for bodies that are awake or static.
+OC_PRIVATE void ocDynamicsWorldWakeIsland(ocDynamicsWorld* pWorld, ocUInt32 index)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(index < pWorld->bodyCount);
+
+    if (!ocDynamicsWorldIsSleeping(pWorld, index)) {
+        return;
+    }
+
+    ocDynamicsBodyID firstID = pWorld->pBodyIDs[index];
+    ocDynamicsBodyID bodyID = firstID;
+    do {
+        ocUInt32 bodyIndex = pWorld->pBodyIndices[bodyID];
+        ocDynamicsBodyID nextID = pWorld->pIslandNext[bodyIndex];
+        ocAssert(bodyIndex >= pWorld->awakeBodyCount);
+
+        pWorld->pIslandNext[bodyIndex] = bodyID;
+        pWorld->pSleepTime[bodyIndex]  = 0;
+        ocBroadphaseSetPassive(&pWorld->broadphase, bodyID, OC_FALSE);
+        ocDynamicsWorldSwapBodies(pWorld, bodyIndex, pWorld->awakeBodyCount);
+        pWorld->awakeBodyCount += 1;
+
+        bodyID = nextID;
+    } while (bodyID != firstID);
+
+    pWorld->isQueryBVHDirty = OC_TRUE;
+}
+
+// Wakes every sleeping body whose bounds overlap a box. This is used when a body is moved or deleted outside of a step, since anything
+// that's asleep on top of it would otherwise be left floating.
+OC_PRIVATE void ocDynamicsWorldWakeBodiesInBounds(ocDynamicsWorld* pWorld, const glm::vec3 &aabbMin, const glm::vec3 &aabbMax)
+{
+    ocAssert(pWorld != NULL);
+
+    ocStackClear(&pWorld->wakeQueryResults);
+
+    ocBroadphaseBounds bounds = ocDynamicsWorldGetBroadphaseBounds(pWorld);
+    ocBroadphaseQuery(&pWorld->broadphase, &bounds, aabbMin, aabbMax, &pWorld->wakeQueryResults);     // <-- If this fails, whatever was found is still woken.
+
+    // Waking moves bodies around, so the indices are turned into IDs first.
+    for (ocSizeT iResult = 0; iResult < pWorld->wakeQueryResults.count; ++iResult) {
+        pWorld->wakeQueryResults.pItems[iResult] = pWorld->pBodyIDs[pWorld->wakeQueryResults.pItems[iResult]];
+    }
+
+    for (ocSizeT iResult = 0; iResult < pWorld->wakeQueryResults.count; ++iResult) {
+        ocDynamicsWorldWakeIsland(pWorld, pWorld->pBodyIndices[pWorld->wakeQueryResults.pItems[iResult]]);
+    }
+}
+
+OC_INLINE void ocDynamicsWorldGetBodyBounds(ocDynamicsWorld* pWorld, ocUInt32 index, glm::vec3 &aabbMin, glm::vec3 &aabbMax)
+{
+    aabbMin = glm::vec3(pWorld->pAABBMinX[index], pWorld->pAABBMinY[index], pWorld->pAABBMinZ[index]);
+    aabbMax = glm::vec3(pWorld->pAABBMaxX[index], pWorld->pAABBMaxY[index], pWorld->pAABBMaxZ[index]);
+}
+
+// Updates the sleep time of every awake body and puts islands to sleep once every body in them has been slow for long enough. Must be
+// called after the solver and before positions are integrated, while the islands from ocDynamicsWorldBuildIslands() are still valid.
+OC_PRIVATE void ocDynamicsWorldUpdateSleep(ocDynamicsWorld* pWorld, float dt)
+{
+    ocAssert(pWorld != NULL);
+
+    if (!pWorld->isSleepingEnabled) {
+        return;
+    }
+
+    ocUInt32 awakeCount = pWorld->awakeBodyCount;
+    if (ocStackResize(&pWorld->islandSleepTimes, awakeCount) != OC_SUCCESS) {
+        return; // <-- Nothing goes to sleep this step.
+    }
+
+    ocUInt32* pParents = pWorld->islandParents.pItems;
+    float* pIslandSleepTimes = pWorld->islandSleepTimes.pItems;
+    for (ocUInt32 i = 0; i < awakeCount; ++i) {
+        pIslandSleepTimes[i] = FLT_MAX;
+    }
+
+    const float maxLinearVelocitySq  = OC_DYNAMICS_SLEEP_LINEAR_VELOCITY  * OC_DYNAMICS_SLEEP_LINEAR_VELOCITY;
+    const float maxAngularVelocitySq = OC_DYNAMICS_SLEEP_ANGULAR_VELOCITY * OC_DYNAMICS_SLEEP_ANGULAR_VELOCITY;
+    ocUInt32 sleepyBodyCount = 0;
+    for (ocUInt32 i = 0; i < awakeCount; ++i) {
+        glm::vec3 linearVelocity  = ocDynamicsWorldGetLinearVelocity(pWorld, i);
+        glm::vec3 angularVelocity = ocDynamicsWorldGetAngularVelocity(pWorld, i);
+        if (glm::dot(linearVelocity, linearVelocity) > maxLinearVelocitySq || glm::dot(angularVelocity, angularVelocity) > maxAngularVelocitySq) {
+            pWorld->pSleepTime[i] = 0;
+        } else {
+            pWorld->pSleepTime[i] += dt;
+            if (pWorld->pSleepTime[i] >= OC_DYNAMICS_TIME_TO_SLEEP) {
+                sleepyBodyCount += 1;
+            }
+        }
+
+        ocUInt32 root = ocDynamicsIslandFind(pParents, i);
+        pIslandSleepTimes[root] = ocMin(pIslandSleepTimes[root], pWorld->pSleepTime[i]);
+    }
+
+    if (sleepyBodyCount == 0) {
+        return;
+    }
+
+    // The bodies of each island that's going to sleep are linked into a ring by inserting them after the root.
+    for (ocUInt32 i = 0; i < awakeCount; ++i) {
+        ocUInt32 root = ocDynamicsIslandFind(pParents, i);
+        if (root != i && pIslandSleepTimes[root] >= OC_DYNAMICS_TIME_TO_SLEEP) {
+            pWorld->pIslandNext[i]    = pWorld->pIslandNext[root];
+            pWorld->pIslandNext[root] = pWorld->pBodyIDs[i];
+        }
+    }
+
+    // Bodies are moved out of the awake range from the back so the body that's swapped into the place of a sleeping one has always been
+    // looked at already. Bodies in front of the one being looked at are never moved, so their islands can still be found.
+    for (ocUInt32 i = awakeCount; i > 0; --i) {
+        ocUInt32 index = i-1;
+        if (pIslandSleepTimes[ocDynamicsIslandFind(pParents, index)] < OC_DYNAMICS_TIME_TO_SLEEP) {
+            continue;
+        }
+
+        ocDynamicsWorldSetVelocities(pWorld, index, glm::vec3(0, 0, 0), glm::vec3(0, 0, 0));
+        pWorld->pInvInertia[index] = glm::mat3(0.0f);   // <-- Sleeping bodies act like static bodies. Restored by the first step after waking.
+        ocBroadphaseSetPassive(&pWorld->broadphase, pWorld->pBodyIDs[index], OC_TRUE);
+        ocDynamicsWorldSwapBodies(pWorld, index, pWorld->awakeBodyCount-1);
+        pWorld->awakeBodyCount -= 1;
+    }
+}
+
+// Wakes the bodies that were touched by an awake body during the step.
+OC_PRIVATE void ocDynamicsWorldWakeTouchedBodies(ocDynamicsWorld* pWorld)
+{
+    ocAssert(pWorld != NULL);
+
+    for (ocSizeT iBody = 0; iBody < pWorld->bodiesToWake.count; ++iBody) {
+        ocDynamicsWorldWakeIsland(pWorld, pWorld->pBodyIndices[pWorld->bodiesToWake.pItems[iBody]]);
+    }
+
+    ocStackClear(&pWorld->bodiesToWake);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+OC_PRIVATE ocResult ocDynamicsWorldUpdateQueryBVH(ocDynamicsWorld* pWorld)
+{
+    if (!pWorld->isQueryBVHDirty) {
+        return OC_SUCCESS;
+    }
+
+    ocResult result = ocStackResize(&pWorld->queryBoundsMin, pWorld->bodyCount);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackResize(&pWorld->queryBoundsMax, pWorld->bodyCount);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // The bounds used by the broadphase are expanded by the contact margin and are out of date by the end of a step, so they're
+    // calculated again.
+    for (ocUInt32 iBody = 0; iBody < pWorld->bodyCount; ++iBody) {
+        ocCollisionShapeGetAABB(&pWorld->pDescs[iBody].shape, ocDynamicsWorldGetPosition(pWorld, iBody), ocDynamicsWorldGetRotation(pWorld, iBody), pWorld->queryBoundsMin.pItems[iBody], pWorld->queryBoundsMax.pItems[iBody]);
+    }
+
+    result = ocBVHBuild(&pWorld->queryBVH, pWorld->queryBoundsMin.pItems, pWorld->queryBoundsMax.pItems, pWorld->bodyCount);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    pWorld->isQueryBVHDirty = OC_FALSE;
+    return OC_SUCCESS;
+}
+
+struct ocDynamicsQueryContext
+{
+    ocDynamicsWorld* pWorld;
+    const ocCollisionObject* pCast;     // <-- NULL for rays.
+    glm::vec3 origin;
+    glm::vec3 direction;                // <-- Normalized.
+    ocDynamicsBodyID ignoreBodyID;
+    ocDynamicsHit* pHit;
+};
+
+OC_PRIVATE float ocDynamicsWorldQueryLeaf(void* pUserData, ocUInt32 first, ocUInt32 count, float maxDistance)
+{
+    ocDynamicsQueryContext* pContext = (ocDynamicsQueryContext*)pUserData;
+    ocDynamicsWorld* pWorld = pContext->pWorld;
+
+    for (ocUInt32 iItem = first; iItem < first + count; ++iItem) {
+        ocUInt32 index = pWorld->queryBVH.items.pItems[iItem];
+        if (pWorld->pBodyIDs[index] == pContext->ignoreBodyID) {
+            continue;
+        }
+
+        ocCollisionObject object = ocDynamicsWorldGetCollisionObject(pWorld, index);
+
+        ocCollisionCastHit hit;
+        ocBool32 isHit;
+        if (pContext->pCast == NULL) {
+            isHit = ocCollisionRaycast(&object, pContext->origin, pContext->direction, maxDistance, &hit);
+        } else {
+            isHit = ocCollisionShapeCast(pContext->pCast, pContext->direction, maxDistance, &object, &hit);
+        }
+
+        if (isHit && hit.distance <= maxDistance) {
+            maxDistance = hit.distance;
+            pContext->pHit->bodyID        = pWorld->pBodyIDs[index];
+            pContext->pHit->triangleIndex = hit.triangleIndex;
+            pContext->pHit->distance      = hit.distance;
+            pContext->pHit->position      = hit.position;
+            pContext->pHit->normal        = hit.normal;
+        }
+    }
+
+    return maxDistance;
+}
+
+// Casts a ray, or a shape when pCast is not NULL, through the query tree. The shape's bounds are swept through the tree with it.
+OC_PRIVATE void ocDynamicsWorldQuery(ocDynamicsWorld* pWorld, const ocCollisionObject* pCast, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, ocDynamicsBodyID ignoreBodyID, ocDynamicsHit* pHit)
+{
+    pHit->bodyID        = OC_DYNAMICS_BODY_NONE;
+    pHit->triangleIndex = OC_BVH_EMPTY;
+    pHit->distance      = maxDistance;
+    pHit->position      = glm::vec3(0, 0, 0);
+    pHit->normal        = glm::vec3(0, 0, 0);
+
+    float length = glm::length(direction);
+    if (!(length > 0) || !(maxDistance >= 0)) {
+        return;
+    }
+
+    ocDynamicsQueryContext context;
+    context.pWorld       = pWorld;
+    context.pCast        = pCast;
+    context.origin       = origin;
+    context.direction    = direction / length;
+    context.ignoreBodyID = ignoreBodyID;
+    context.pHit         = pHit;
+
+    ocBVHRay ray;
+    ray.origin      = origin;
+    ray.direction   = context.direction;
+    ray.extents     = glm::vec3(0, 0, 0);
+    ray.maxDistance = maxDistance;
+    if (pCast != NULL) {
+        glm::vec3 aabbMin;
+        glm::vec3 aabbMax;
+        ocCollisionShapeGetAABB(pCast->pShape, pCast->position, pCast->rotation, aabbMin, aabbMax);
+        ray.origin  = (aabbMin + aabbMax) * 0.5f;
+        ray.extents = (aabbMax - aabbMin) * 0.5f;
+    }
+
+    ocBVHRaycast(&pWorld->queryBVH, &ray, ocDynamicsWorldQueryLeaf, &context);
+}
+
+OC_PRIVATE void ocDynamicsWorldRaycastJobProc(void* pUserData)
+{
+    ocDynamicsJob* pJob = (ocDynamicsJob*)pUserData;
+    const ocDynamicsRay* pRays = (const ocDynamicsRay*)pJob->pQueries;
+
+    for (ocUInt32 iRay = pJob->begin; iRay < pJob->end; ++iRay) {
+        const ocDynamicsRay* pRay = &pRays[iRay];
+        ocDynamicsWorldQuery(pJob->pWorld, NULL, pRay->origin, pRay->direction, pRay->maxDistance, pRay->ignoreBodyID, &pJob->pHits[iRay]);
+    }
+}
+
+OC_PRIVATE void ocDynamicsWorldSweepJobProc(void* pUserData)
+{
+    ocDynamicsJob* pJob = (ocDynamicsJob*)pUserData;
+    const ocDynamicsSweep* pSweeps = (const ocDynamicsSweep*)pJob->pQueries;
+
+    for (ocUInt32 iSweep = pJob->begin; iSweep < pJob->end; ++iSweep) {
+        const ocDynamicsSweep* pSweep = &pSweeps[iSweep];
+
+        ocCollisionObject cast;
+        cast.pShape   = &pSweep->shape;
+        cast.position = pSweep->origin;
+        cast.rotation = glm::normalize(pSweep->rotation);
+        ocDynamicsWorldQuery(pJob->pWorld, &cast, pSweep->origin, pSweep->direction, pSweep->maxDistance, pSweep->ignoreBodyID, &pJob->pHits[iSweep]);
+    }
+}
+
+OC_PRIVATE ocResult ocDynamicsWorldRunQueries(ocDynamicsWorld* pWorld, const void* pQueries, ocUInt32 count, ocDynamicsHit* pHits, ocJobProc proc)
+{
+    ocResult result = ocDynamicsWorldUpdateQueryBVH(pWorld);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocStackClear(&pWorld->jobs);
+    for (ocUInt32 iQuery = 0; iQuery < count; iQuery += OC_DYNAMICS_QUERY_BATCH_SIZE) {
+        result = ocDynamicsWorldPushJob(pWorld, iQuery, ocMin(iQuery + OC_DYNAMICS_QUERY_BATCH_SIZE, count), 0);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        pWorld->jobs.pItems[pWorld->jobs.count-1].pQueries = pQueries;
+        pWorld->jobs.pItems[pWorld->jobs.count-1].pHits    = pHits;
+    }
+
+    ocDynamicsWorldRunJobs(pWorld, proc);
+
+    return OC_SUCCESS;
+}
+
+
+
+ocResult ocDynamicsWorldInit(ocJobQueue* pJobQueue, ocDynamicsWorld* pWorld)
 {
     if (pWorld == NULL) {
         return OC_INVALID_ARGS;
@@ -8,6 +1300,39 @@ ocResult ocDynamicsWorldInit(ocDynamicsWorld* pWorld)
 
     ocZeroObject(pWorld);
 
+    pWorld->pJobQueue = pJobQueue;
+    pWorld->gravity = glm::vec3(0, -9.81f, 0);
+
+    ocResult result = ocBroadphaseInit(&pWorld->broadphase);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocStackInit(&pWorld->freeBodyIDs);
+    ocStackInit(&pWorld->pairs);
+    ocStackInit(&pWorld->manifolds);
+    ocStackInit(&pWorld->contacts);
+    ocStackInit(&pWorld->prevContacts);
+    ocStackInit(&pWorld->islandParents);
+    ocStackInit(&pWorld->islandOffsets);
+    ocStackInit(&pWorld->islandContacts);
+    ocStackInit(&pWorld->jobs);
+    ocStackInit(&pWorld->islandSleepTimes);
+    ocStackInit(&pWorld->bodiesToWake);
+    ocStackInit(&pWorld->wakeQueryResults);
+    ocStackInit(&pWorld->meshContacts);
+    ocStackInit(&pWorld->queryBoundsMin);
+    ocStackInit(&pWorld->queryBoundsMax);
+
+    result = ocBVHInit(&pWorld->queryBVH);
+    if (result != OC_SUCCESS) {
+        ocBroadphaseUninit(&pWorld->broadphase);
+        return result;
+    }
+
+    pWorld->isQueryBVHDirty   = OC_TRUE;
+    pWorld->isSleepingEnabled = OC_TRUE;
+
     return OC_SUCCESS;
 }
 
@@ -16,6 +1341,26 @@ void ocDynamicsWorldUninit(ocDynamicsWorld* pWorld)
     if (pWorld == NULL) {
         return;
     }
+
+    ocBVHUninit(&pWorld->queryBVH);
+    ocStackUninit(&pWorld->queryBoundsMax);
+    ocStackUninit(&pWorld->queryBoundsMin);
+    ocStackUninit(&pWorld->meshContacts);
+    ocStackUninit(&pWorld->wakeQueryResults);
+    ocStackUninit(&pWorld->bodiesToWake);
+    ocStackUninit(&pWorld->islandSleepTimes);
+    ocStackUninit(&pWorld->jobs);
+    ocStackUninit(&pWorld->islandContacts);
+    ocStackUninit(&pWorld->islandOffsets);
+    ocStackUninit(&pWorld->islandParents);
+    ocStackUninit(&pWorld->prevContacts);
+    ocStackUninit(&pWorld->contacts);
+    ocStackUninit(&pWorld->manifolds);
+    ocStackUninit(&pWorld->pairs);
+    ocStackUninit(&pWorld->freeBodyIDs);
+    ocBroadphaseUninit(&pWorld->broadphase);
+    ocFree(pWorld->pBodyIndices);
+    ocFree(pWorld->pBodyData);
 }
 
 
@@ -25,7 +1370,34 @@ void ocDynamicsWorldStep(ocDynamicsWorld* pWorld, double dt)
         return;
     }
 
-    /* Not yet implemented. */
+    // Nothing can happen while everything is asleep.
+    if (pWorld->awakeBodyCount == 0) {
+        return;
+    }
+
+    float stepDt = ocMin((float)dt, OC_DYNAMICS_MAX_TIME_STEP);
+
+    ocDynamicsWorldIntegrateVelocities(pWorld, stepDt);
+    ocDynamicsWorldUpdateBodies(pWorld);
+
+    // If anything fails to allocate there are no contacts for this step, but bodies still move.
+    ocResult result = ocDynamicsWorldFindContacts(pWorld, stepDt);
+    if (result == OC_SUCCESS) {
+        result = ocDynamicsWorldBuildContacts(pWorld, stepDt);
+    }
+    if (result == OC_SUCCESS) {
+        result = ocDynamicsWorldBuildIslands(pWorld, stepDt);
+    }
+    if (result == OC_SUCCESS) {
+        ocDynamicsWorldRunJobs(pWorld, ocDynamicsWorldSolverJobProc);
+        ocDynamicsWorldUpdateSleep(pWorld, stepDt);
+    } else {
+        ocStackClear(&pWorld->contacts);
+    }
+
+    ocDynamicsWorldIntegratePositions(pWorld, stepDt);
+    ocDynamicsWorldWakeTouchedBodies(pWorld);
+    pWorld->isQueryBVHDirty = OC_TRUE;
 }
 
 
@@ -35,8 +1407,7 @@ void ocDynamicsWorldSetGravity(ocDynamicsWorld* pWorld, const glm::vec3 &gravity
         return;
     }
 
-    /* Not yet implemented. */
-    (void)gravity;
+    pWorld->gravity = gravity;
 }
 
 glm::vec3 ocDynamicsWorldGetGravity(ocDynamicsWorld* pWorld)
@@ -45,6 +1416,307 @@ glm::vec3 ocDynamicsWorldGetGravity(ocDynamicsWorld* pWorld)
         return glm::vec3(0, 0, 0);
     }
 
-    /* Not yet implemented. */
-    return glm::vec3(0, 0, 0);
-}
\ No newline at end of file
+    return pWorld->gravity;
+}
+
+void ocDynamicsWorldEnableSleeping(ocDynamicsWorld* pWorld, ocBool32 isEnabled)
+{
+    if (pWorld == NULL) {
+        return;
+    }
+
+    pWorld->isSleepingEnabled = isEnabled;
+    if (isEnabled) {
+        return;
+    }
+
+    // Waking an island moves static bodies from the front of the passive range into the places of it's bodies, which are never in front
+    // of the cursor, so the cursor only moves on once the body under it is known to be static.
+    ocUInt32 index = pWorld->awakeBodyCount;
+    while (index < pWorld->bodyCount) {
+        if (ocDynamicsWorldIsSleeping(pWorld, index)) {
+            ocDynamicsWorldWakeIsland(pWorld, index);
+            index = ocMax(index, pWorld->awakeBodyCount);
+        } else {
+            index += 1;
+        }
+    }
+}
+
+
+ocResult ocDynamicsWorldCreateBody(ocDynamicsWorld* pWorld, const ocDynamicsBodyDesc* pDesc, const glm::vec3 &position, const glm::quat &rotation, ocDynamicsBodyID* pBodyID)
+{
+    if (pBodyID == NULL) return OC_INVALID_ARGS;
+    *pBodyID = OC_DYNAMICS_BODY_NONE;
+
+    if (pWorld == NULL || pDesc == NULL) return OC_INVALID_ARGS;
+    if (pDesc->type == ocDynamicsBodyType_Dynamic && !(pDesc->mass > 0)) return OC_INVALID_ARGS;
+    if (pDesc->shape.type == ocCollisionShapeType_ConvexHull && pDesc->shape.convexHull.pHull == NULL) return OC_INVALID_ARGS;
+    if (pDesc->shape.type == ocCollisionShapeType_TriangleMesh && pDesc->shape.triangleMesh.pMesh == NULL) return OC_INVALID_ARGS;
+
+    // Triangles have no volume, so they can't be simulated.
+    if (pDesc->type == ocDynamicsBodyType_Dynamic && (pDesc->shape.type == ocCollisionShapeType_Triangle || pDesc->shape.type == ocCollisionShapeType_TriangleMesh)) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (pWorld->bodyCount == pWorld->bodyCapacity) {
+        ocResult result = ocDynamicsWorldGrowBodies(pWorld);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    ocDynamicsBodyID bodyID;
+    ocResult result = ocDynamicsWorldAllocBodyID(pWorld, &bodyID);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocBool32 isDynamic = pDesc->type == ocDynamicsBodyType_Dynamic;
+    result = ocBroadphaseInsert(&pWorld->broadphase, bodyID, !isDynamic);
+    if (result != OC_SUCCESS) {
+        ocStackPush(&pWorld->freeBodyIDs, bodyID);
+        return result;
+    }
+
+    ocUInt32 index = pWorld->bodyCount;
+    glm::vec3 inertia = ocCollisionShapeGetInertia(&pDesc->shape, pDesc->mass);
+    glm::quat normalizedRotation = glm::normalize(rotation);
+
+    pWorld->pPositionX[index]        = position.x;
+    pWorld->pPositionY[index]        = position.y;
+    pWorld->pPositionZ[index]        = position.z;
+    pWorld->pRotationX[index]        = normalizedRotation.x;
+    pWorld->pRotationY[index]        = normalizedRotation.y;
+    pWorld->pRotationZ[index]        = normalizedRotation.z;
+    pWorld->pRotationW[index]        = normalizedRotation.w;
+    ocDynamicsWorldSetVelocities(pWorld, index, glm::vec3(0, 0, 0), glm::vec3(0, 0, 0));
+    pWorld->pInvMass[index]          = isDynamic ? 1 / pDesc->mass : 0;
+    pWorld->pLinearDamping[index]    = pDesc->linearDamping;
+    pWorld->pAngularDamping[index]   = pDesc->angularDamping;
+    pWorld->pSleepTime[index]        = 0;
+    pWorld->pLocalInvInertia[index]  = isDynamic ? glm::vec3(1 / inertia.x, 1 / inertia.y, 1 / inertia.z) : glm::vec3(0, 0, 0);
+    pWorld->pInvInertia[index]       = glm::mat3(0.0f);     // <-- Updated by the next step for dynamic bodies.
+    pWorld->pDescs[index]            = *pDesc;
+    pWorld->pBodyIDs[index]          = bodyID;
+    pWorld->pIslandNext[index]       = bodyID;
+    pWorld->pBodyIndices[bodyID]     = index;
+    pWorld->bodyCount += 1;
+
+    // The bounds are needed by the broadphase before the next step has a chance to update them.
+    ocDynamicsWorldUpdateBodyBounds(pWorld, index);
+    pWorld->isQueryBVHDirty = OC_TRUE;
+
+    // New dynamic bodies start awake.
+    if (isDynamic) {
+        ocDynamicsWorldSwapBodies(pWorld, index, pWorld->awakeBodyCount);
+        pWorld->awakeBodyCount += 1;
+    }
+
+    *pBodyID = bodyID;
+    return OC_SUCCESS;
+}
+
+void ocDynamicsWorldDeleteBody(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return;
+
+    ocUInt32 index = pWorld->pBodyIndices[bodyID];
+    ocAssert(index < pWorld->bodyCount && pWorld->pBodyIDs[index] == bodyID);
+
+    // Anything that might be resting on the body is woken so it doesn't float. The body's own island is woken too, which takes it out of
+    // the ring of sleeping bodies it may be part of.
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+    ocDynamicsWorldGetBodyBounds(pWorld, index, aabbMin, aabbMax);
+    ocDynamicsWorldWakeIsland(pWorld, index);
+    ocDynamicsWorldWakeBodiesInBounds(pWorld, aabbMin, aabbMax);
+    ocBroadphaseRemove(&pWorld->broadphase, bodyID);
+
+    // The body is moved to the end of the awake range if it's awake, and then the last body is moved into the hole to keep the arrays
+    // packed.
+    index = pWorld->pBodyIndices[bodyID];
+    if (index < pWorld->awakeBodyCount) {
+        pWorld->awakeBodyCount -= 1;
+        ocDynamicsWorldSwapBodies(pWorld, index, pWorld->awakeBodyCount);
+        index = pWorld->awakeBodyCount;
+    }
+
+    ocUInt32 lastIndex = pWorld->bodyCount-1;
+    if (index != lastIndex) {
+        void** ppArrays[OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT];
+        ocSizeT elementSizes[OC_DYNAMICS_WORLD_BODY_ARRAY_COUNT];
+        ocDynamicsWorldGetBodyArrays(pWorld, ppArrays, elementSizes);
+
+        for (ocUInt32 iArray = 0; ppArrays[iArray] != NULL; ++iArray) {
+            ocUInt8* pArray = (ocUInt8*)*ppArrays[iArray];
+            ocCopyMemory(pArray + index*elementSizes[iArray], pArray + lastIndex*elementSizes[iArray], elementSizes[iArray]);
+        }
+
+        pWorld->pBodyIndices[pWorld->pBodyIDs[index]] = index;
+    }
+
+    pWorld->bodyCount -= 1;
+    pWorld->isQueryBVHDirty = OC_TRUE;
+
+    // Contacts involving the body are removed so a new body that's given the same ID doesn't inherit them. Removing them in place
+    // keeps the rest sorted.
+    ocSizeT contactCount = 0;
+    for (ocSizeT iContact = 0; iContact < pWorld->contacts.count; ++iContact) {
+        ocUInt64 key = pWorld->contacts.pItems[iContact].key;
+        if ((ocUInt32)(key >> 32) != bodyID && (ocUInt32)(key & 0xFFFFFFFF) != bodyID) {
+            pWorld->contacts.pItems[contactCount++] = pWorld->contacts.pItems[iContact];
+        }
+    }
+    pWorld->contacts.count = contactCount;
+
+    ocStackPush(&pWorld->freeBodyIDs, bodyID);  // <-- If this fails the ID is just never reused.
+}
+
+void ocDynamicsWorldSetBodyTransform(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, const glm::vec3 &position, const glm::quat &rotation)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return;
+
+    // Sleeping bodies touching the body where it was might have been resting on it. Waking can move the body, so it's index is looked up
+    // again afterwards.
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+    ocDynamicsWorldGetBodyBounds(pWorld, pWorld->pBodyIndices[bodyID], aabbMin, aabbMax);
+    ocDynamicsWorldWakeBodiesInBounds(pWorld, aabbMin, aabbMax);
+
+    ocUInt32 index = pWorld->pBodyIndices[bodyID];
+    glm::quat normalizedRotation = glm::normalize(rotation);
+    pWorld->pPositionX[index] = position.x;
+    pWorld->pPositionY[index] = position.y;
+    pWorld->pPositionZ[index] = position.z;
+    pWorld->pRotationX[index] = normalizedRotation.x;
+    pWorld->pRotationY[index] = normalizedRotation.y;
+    pWorld->pRotationZ[index] = normalizedRotation.z;
+    pWorld->pRotationW[index] = normalizedRotation.w;
+    ocDynamicsWorldUpdateBodyBounds(pWorld, index);
+    pWorld->isQueryBVHDirty = OC_TRUE;
+
+    // Static bodies never pair with sleeping bodies, so anything asleep where the body has been moved to is woken as well. Passive bodies
+    // need to be given to the broadphase again so it doesn't keep their old bounds.
+    ocDynamicsWorldGetBodyBounds(pWorld, index, aabbMin, aabbMax);
+    ocDynamicsWorldWakeBodiesInBounds(pWorld, aabbMin, aabbMax);
+
+    index = pWorld->pBodyIndices[bodyID];
+    if (pWorld->pInvMass[index] > 0) {
+        ocDynamicsWorldWakeIsland(pWorld, index);
+    } else {
+        ocBroadphaseSetPassive(&pWorld->broadphase, bodyID, OC_TRUE);
+    }
+}
+
+void ocDynamicsWorldGetBodyTransform(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, glm::vec3 &position, glm::quat &rotation)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return;
+
+    ocUInt32 index = pWorld->pBodyIndices[bodyID];
+    position = ocDynamicsWorldGetPosition(pWorld, index);
+    rotation = ocDynamicsWorldGetRotation(pWorld, index);
+}
+
+void ocDynamicsWorldSetBodyLinearVelocity(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, const glm::vec3 &velocity)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return;
+
+    ocUInt32 index = pWorld->pBodyIndices[bodyID];
+    if (pWorld->pInvMass[index] > 0) {
+        ocDynamicsWorldWakeIsland(pWorld, index);
+        index = pWorld->pBodyIndices[bodyID];
+
+        pWorld->pLinearVelocityX[index] = velocity.x;
+        pWorld->pLinearVelocityY[index] = velocity.y;
+        pWorld->pLinearVelocityZ[index] = velocity.z;
+    }
+}
+
+glm::vec3 ocDynamicsWorldGetBodyLinearVelocity(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return glm::vec3(0, 0, 0);
+
+    return ocDynamicsWorldGetLinearVelocity(pWorld, pWorld->pBodyIndices[bodyID]);
+}
+
+void ocDynamicsWorldSetBodyAngularVelocity(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, const glm::vec3 &velocity)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return;
+
+    ocUInt32 index = pWorld->pBodyIndices[bodyID];
+    if (pWorld->pInvMass[index] > 0) {
+        ocDynamicsWorldWakeIsland(pWorld, index);
+        index = pWorld->pBodyIndices[bodyID];
+
+        pWorld->pAngularVelocityX[index] = velocity.x;
+        pWorld->pAngularVelocityY[index] = velocity.y;
+        pWorld->pAngularVelocityZ[index] = velocity.z;
+    }
+}
+
+glm::vec3 ocDynamicsWorldGetBodyAngularVelocity(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return glm::vec3(0, 0, 0);
+
+    return ocDynamicsWorldGetAngularVelocity(pWorld, pWorld->pBodyIndices[bodyID]);
+}
+
+void ocDynamicsWorldApplyImpulse(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, const glm::vec3 &impulse, const glm::vec3 &point)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return;
+
+    ocUInt32 index = pWorld->pBodyIndices[bodyID];
+    float invMass = pWorld->pInvMass[index];
+    if (invMass == 0) {
+        return;
+    }
+
+    ocDynamicsWorldWakeIsland(pWorld, index);
+    index = pWorld->pBodyIndices[bodyID];
+
+    // The world space inertia is only updated during a step, so it's calculated here in case the body has been rotated since.
+    glm::mat3 r = glm::mat3_cast(ocDynamicsWorldGetRotation(pWorld, index));
+    glm::vec3 localAngularImpulse = glm::transpose(r) * glm::cross(point - ocDynamicsWorldGetPosition(pWorld, index), impulse);
+    glm::vec3 angularVelocityChange = r * (localAngularImpulse * pWorld->pLocalInvInertia[index]);
+
+    ocDynamicsWorldSetVelocities(pWorld, index,
+        ocDynamicsWorldGetLinearVelocity(pWorld, index) + impulse*invMass,
+        ocDynamicsWorldGetAngularVelocity(pWorld, index) + angularVelocityChange);
+}
+
+void ocDynamicsWorldWakeBody(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return;
+
+    ocDynamicsWorldWakeIsland(pWorld, pWorld->pBodyIndices[bodyID]);
+}
+
+ocBool32 ocDynamicsWorldIsBodySleeping(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID)
+{
+    if (pWorld == NULL || bodyID >= pWorld->bodyIDCapacity) return OC_FALSE;
+
+    return ocDynamicsWorldIsSleeping(pWorld, pWorld->pBodyIndices[bodyID]);
+}
+
+
+ocResult ocDynamicsWorldRaycast(ocDynamicsWorld* pWorld, const ocDynamicsRay* pRays, ocUInt32 count, ocDynamicsHit* pHits)
+{
+    if (pWorld == NULL || (count > 0 && (pRays == NULL || pHits == NULL))) return OC_INVALID_ARGS;
+
+    return ocDynamicsWorldRunQueries(pWorld, pRays, count, pHits, ocDynamicsWorldRaycastJobProc);
+}
+
+ocResult ocDynamicsWorldSweep(ocDynamicsWorld* pWorld, const ocDynamicsSweep* pSweeps, ocUInt32 count, ocDynamicsHit* pHits)
+{
+    if (pWorld == NULL || (count > 0 && (pSweeps == NULL || pHits == NULL))) return OC_INVALID_ARGS;
+
+    for (ocUInt32 iSweep = 0; iSweep < count; ++iSweep) {
+        const ocCollisionShape* pShape = &pSweeps[iSweep].shape;
+        if (pShape->type == ocCollisionShapeType_TriangleMesh || (pShape->type == ocCollisionShapeType_ConvexHull && pShape->convexHull.pHull == NULL)) {
+            return OC_INVALID_ARGS;
+        }
+    }
+
+    return ocDynamicsWorldRunQueries(pWorld, pSweeps, count, pHits, ocDynamicsWorldSweepJobProc);
+}
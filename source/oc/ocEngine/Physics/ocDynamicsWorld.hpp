@@ -1,21 +1,290 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+// Rigid body dynamics.
+//
+// Body data is stored as a structure of arrays, tightly packed, so that integration can be done 4 bodies at a time with SIMD. Each step
+// goes through these stages:
+//   1) Gravity and damping are applied to velocities.
+//   2) Bounding boxes are updated and the broadphase finds pairs of bodies whose bounds overlap.
+//   3) The narrow phase finds the contacts for each pair. Pairs are split into chunks which are run in parallel on the job queue.
+//   4) Contacts are matched with those from the previous step so the solver can start from last step's impulses (warm starting).
+//   5) Awake bodies connected by contacts are grouped into islands. Islands don't share any awake bodies, so they're solved in parallel
+//      on the job queue with a sequential impulse solver. Static and sleeping bodies are shared between islands, but are never written
+//      to.
+//   6) Islands whose bodies have all been slow for long enough are put to sleep.
+//   7) Positions and rotations are integrated from the solved velocities.
+//
+// Sleeping bodies are skipped entirely. Awake bodies are kept at the front of the body arrays and every stage only goes through those,
+// so the cost of a step depends on the number of awake bodies rather than the total. Sleeping and static bodies are passive in the
+// broadphase, which keeps them in a tree rather than sweeping them. A sleeping body is woken, along with the rest of it's island, when an
+// awake body touches it, when it's teleported, when it's velocity is changed or when a body it may be resting on is moved or deleted.
+// Bodies touched by an awake body are treated as static for the rest of that step, and are woken at the end of it.
+//
+// Contacts are speculative. Bodies that are within OC_DYNAMICS_CONTACT_MARGIN of each other have their contacts solved so that they
+// don't overlap by the end of the step, which keeps resting contacts stable without needing a lot of iterations.
+//
+// Pairs with a triangle mesh are moved to the end of the pair list. Each of them can touch several triangles, so they get a contact for
+// each triangle, up to OC_DYNAMICS_MAX_MESH_CONTACTS.
+//
+// Rays and shapes can be cast into the world in batches. Queries use their own ocBVH over the bounds of every body, which is rebuilt by
+// the first query after anything has moved. Each batch is split into chunks which are run in parallel on the job queue. Queries only
+// read from the world, but they must not be run at the same time as a step, or at the same time as another query since the first of
+// them may be rebuilding the tree.
+
+#define OC_DYNAMICS_CONTACT_MARGIN          0.02f   // <-- In world units.
+#define OC_DYNAMICS_ALLOWED_PENETRATION     0.005f  // <-- Overlap that is not corrected. Stops resting contacts from jittering.
+#define OC_DYNAMICS_BAUMGARTE               0.2f    // <-- The fraction of the overlap that's corrected each step.
+#define OC_DYNAMICS_VELOCITY_ITERATIONS     8
+#define OC_DYNAMICS_MAX_TIME_STEP           (1.0f/30)
+#define OC_DYNAMICS_NARROWPHASE_BATCH_SIZE  256     // <-- The number of pairs handled by each narrow phase job.
+#define OC_DYNAMICS_MIN_ISLAND_BATCH_SIZE   64      // <-- Small islands are combined so that each solver job has at least this many contacts.
+#define OC_DYNAMICS_MAX_MESH_CONTACTS       8       // <-- The most triangles of a mesh a body can touch at once. The deepest are kept.
+#define OC_DYNAMICS_QUERY_BATCH_SIZE        64      // <-- The number of rays or sweeps handled by each query job.
+#define OC_DYNAMICS_SLEEP_LINEAR_VELOCITY   0.05f   // <-- Bodies slower than this, in world units per second, are allowed to sleep.
+#define OC_DYNAMICS_SLEEP_ANGULAR_VELOCITY  0.05f   // <-- In radians per second.
+#define OC_DYNAMICS_TIME_TO_SLEEP           0.5f    // <-- How long, in seconds, every body of an island must be slow before it goes to sleep.
+
+typedef ocUInt32 ocDynamicsBodyID;
+#define OC_DYNAMICS_BODY_NONE               (~0U)
+
+enum ocDynamicsBodyType
+{
+    ocDynamicsBodyType_Static,                      // <-- Never moves unless it's teleported with ocDynamicsWorldSetBodyTransform().
+    ocDynamicsBodyType_Dynamic                      // <-- Can't use triangle meshes.
+};
+
+struct ocDynamicsBodyDesc
+{
+    ocDynamicsBodyType type;
+    ocCollisionShape shape;                         // <-- Copied. Convex hulls and triangle meshes must remain valid while the body exists.
+    float mass;                                     // <-- Ignored for static bodies.
+    float friction;                                 // <-- The friction of a contact is the geometric mean of both bodies.
+    float restitution;                              // <-- The restitution of a contact is the larger of both bodies.
+    float linearDamping;                            // <-- The fraction of velocity lost per second, roughly.
+    float angularDamping;
+    void* pUserData;                                // <-- Not used by the dynamics world. For ocWorld this is the ocDynamicsBodyComponent.
+};
+
+// Retrieves a body description with default settings, which is a dynamic unit sphere of 1 kg.
+ocDynamicsBodyDesc ocDynamicsBodyDescInit();
+
+// A point of a contact constraint. Anchors are relative to the center of each body.
+struct ocDynamicsContactPoint
+{
+    glm::vec3 anchorA;
+    glm::vec3 anchorB;
+    glm::vec3 localAnchorA;                         // <-- In the local space of A. Used to match points between steps.
+    float separation;
+    float normalMass;
+    float tangentMass[2];
+    float bias;
+    float normalImpulse;                            // <-- Accumulated over the step, and carried over to the next step.
+    float tangentImpulse[2];
+};
+
+struct ocDynamicsContact
+{
+    ocUInt64 key;                                   // <-- The IDs of both bodies, the lower one in the high bits. A is the lower ID.
+    ocUInt32 subKey;                                // <-- The triangle for contacts with a triangle mesh. 0 for everything else.
+    ocUInt32 indexA;                                // <-- The index of each body in the arrays of the world for the current step.
+    ocUInt32 indexB;
+    glm::vec3 normal;                               // <-- From A to B.
+    glm::vec3 tangents[2];
+    float friction;
+    float restitution;
+    ocUInt32 pointCount;
+    ocDynamicsContactPoint points[OC_COLLISION_MAX_MANIFOLD_POINTS];
+};
+
+// A ray for ocDynamicsWorldRaycast().
+struct ocDynamicsRay
+{
+    glm::vec3 origin;
+    glm::vec3 direction;                            // <-- Does not need to be normalized. Distances are always in world units.
+    float maxDistance;
+    ocDynamicsBodyID ignoreBodyID;                  // <-- A body that's never hit, such as the one the ray is coming from. Can be OC_DYNAMICS_BODY_NONE.
+};
+
+// Retrieves a ray that doesn't ignore any bodies.
+ocDynamicsRay ocDynamicsRayInit(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance);
+
+// A shape that's moved along a ray for ocDynamicsWorldSweep(). The shape is not rotated as it moves.
+struct ocDynamicsSweep
+{
+    ocCollisionShape shape;                         // <-- Can't be a triangle mesh.
+    glm::vec3 origin;
+    glm::quat rotation;
+    glm::vec3 direction;                            // <-- Does not need to be normalized.
+    float maxDistance;
+    ocDynamicsBodyID ignoreBodyID;
+};
+
+// Retrieves a sweep that doesn't ignore any bodies.
+ocDynamicsSweep ocDynamicsSweepInit(const ocCollisionShape &shape, const glm::vec3 &origin, const glm::quat &rotation, const glm::vec3 &direction, float maxDistance);
+
+// The nearest thing hit by a ray or sweep.
+struct ocDynamicsHit
+{
+    ocDynamicsBodyID bodyID;                        // <-- OC_DYNAMICS_BODY_NONE if nothing was hit.
+    ocUInt32 triangleIndex;                         // <-- The triangle that was hit when the body is a triangle mesh.
+    float distance;
+    glm::vec3 position;
+    glm::vec3 normal;                               // <-- Facing back towards the ray.
+};
+
+struct ocDynamicsWorld;
+
+// A range of work for a job. For the narrow phase it's a range of pairs, for the solver it's a range of islandContacts and for queries
+// it's a range of pQueries and pHits.
+struct ocDynamicsJob
+{
+    ocDynamicsWorld* pWorld;
+    ocUInt32 begin;
+    ocUInt32 end;
+    float dt;
+    const void* pQueries;
+    ocDynamicsHit* pHits;
+};
+
 struct ocDynamicsWorld
 {
-    int _unused;
+    ocJobQueue* pJobQueue;                          // <-- Can be NULL, in which case everything is done on the calling thread.
+    glm::vec3 gravity;
+
+    // Bodies, tightly packed, with awake bodies first and static and sleeping bodies after them. Deleting a body moves the last one into
+    // it's place, and bodies are swapped around as they fall asleep and wake up. Every array is bodyCapacity long, and they're all carved
+    // out of pBodyData.
+    ocUInt32 bodyCount;
+    ocUInt32 awakeBodyCount;
+    ocUInt32 bodyCapacity;
+    void* pBodyData;
+    float* pPositionX;
+    float* pPositionY;
+    float* pPositionZ;
+    float* pRotationX;
+    float* pRotationY;
+    float* pRotationZ;
+    float* pRotationW;
+    float* pLinearVelocityX;
+    float* pLinearVelocityY;
+    float* pLinearVelocityZ;
+    float* pAngularVelocityX;
+    float* pAngularVelocityY;
+    float* pAngularVelocityZ;
+    float* pInvMass;                                // <-- 0 for static bodies.
+    float* pLinearDamping;
+    float* pAngularDamping;
+    float* pAABBMinX;                               // <-- Expanded by the contact margin.
+    float* pAABBMinY;
+    float* pAABBMinZ;
+    float* pAABBMaxX;
+    float* pAABBMaxY;
+    float* pAABBMaxZ;
+    float* pSleepTime;                              // <-- How long the body has been slow enough to sleep.
+    glm::vec3* pLocalInvInertia;                    // <-- The diagonal of the inverse inertia tensor, in local space.
+    glm::mat3* pInvInertia;                         // <-- The inverse inertia tensor in world space. Updated at the start of each step.
+    ocDynamicsBodyDesc* pDescs;
+    ocDynamicsBodyID* pBodyIDs;                     // <-- The ID of the body at each index.
+    ocDynamicsBodyID* pIslandNext;                  // <-- The bodies of a sleeping island are linked in a ring. Awake and static bodies link to themselves.
+
+    // Maps a body ID to it's index in the arrays above. IDs are reused once the body has been deleted.
+    ocUInt32* pBodyIndices;
+    ocUInt32 bodyIDCapacity;
+    ocStack<ocDynamicsBodyID> freeBodyIDs;
+
+    ocBroadphase broadphase;
+
+    // Per-step working memory. Kept between steps to avoid reallocating. The contacts from the previous step are used for warm starting
+    // and are sorted by their key.
+    ocStack<ocBroadphasePair> pairs;
+    ocStack<ocContactManifold> manifolds;
+    ocUInt32 meshPairBegin;                         // <-- Pairs from here on have a triangle mesh. They use meshContacts rather than manifolds.
+    ocStack<ocTriangleMeshContact> meshContacts;    // <-- OC_DYNAMICS_MAX_MESH_CONTACTS for each mesh pair. Unused ones have no points.
+    ocStack<ocDynamicsContact> contacts;
+    ocStack<ocDynamicsContact> prevContacts;
+    ocStack<ocUInt32> islandParents;                // <-- Union-find, indexed by body index.
+    ocStack<ocUInt32> islandOffsets;                // <-- The start of each island in islandContacts, indexed by the body index of it's root.
+    ocStack<ocUInt32> islandContacts;               // <-- Contact indices, grouped by island.
+    ocStack<ocDynamicsJob> jobs;
+    ocStack<float> islandSleepTimes;                // <-- The shortest sleep time of any body in each island, indexed by the body index of it's root.
+    ocStack<ocDynamicsBodyID> bodiesToWake;         // <-- Sleeping bodies touched by an awake body during the step.
+    ocStack<ocUInt32> wakeQueryResults;
+
+    ocBool32 isSleepingEnabled;
+
+    // Scene queries. The tree holds the index of each body, and is rebuilt when isQueryBVHDirty is set.
+    ocBVH queryBVH;
+    ocBool32 isQueryBVHDirty;
+    ocStack<glm::vec3> queryBoundsMin;
+    ocStack<glm::vec3> queryBoundsMax;
 };
 
 //
-ocResult ocDynamicsWorldInit(ocDynamicsWorld* pWorld);
+ocResult ocDynamicsWorldInit(ocJobQueue* pJobQueue, ocDynamicsWorld* pWorld);
 
 //
 void ocDynamicsWorldUninit(ocDynamicsWorld* pWorld);
 
-//
+// Steps the simulation. Time steps longer than OC_DYNAMICS_MAX_TIME_STEP are clamped, which makes the simulation run slower than real
+// time rather than become unstable.
 void ocDynamicsWorldStep(ocDynamicsWorld* pWorld, double dt);
 
 //
 void ocDynamicsWorldSetGravity(ocDynamicsWorld* pWorld, const glm::vec3 &gravity);
 
 //
-glm::vec3 ocDynamicsWorldGetGravity(ocDynamicsWorld* pWorld);
\ No newline at end of file
+glm::vec3 ocDynamicsWorldGetGravity(ocDynamicsWorld* pWorld);
+
+// Enables or disables sleeping. Enabled by default. Disabling it wakes every body.
+void ocDynamicsWorldEnableSleeping(ocDynamicsWorld* pWorld, ocBool32 isEnabled);
+
+
+// Creates a body.
+ocResult ocDynamicsWorldCreateBody(ocDynamicsWorld* pWorld, const ocDynamicsBodyDesc* pDesc, const glm::vec3 &position, const glm::quat &rotation, ocDynamicsBodyID* pBodyID);
+
+//
+void ocDynamicsWorldDeleteBody(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID);
+
+// Retrieves the index of a body in the world's arrays. The index changes when other bodies are deleted.
+OC_INLINE ocUInt32 ocDynamicsWorldGetBodyIndex(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID)
+{
+    ocAssert(bodyID < pWorld->bodyIDCapacity);
+    return pWorld->pBodyIndices[bodyID];
+}
+
+// Teleports a body. It's velocity is left unchanged. Wakes the body, and any sleeping bodies touching it at either the old or the new
+// transform.
+void ocDynamicsWorldSetBodyTransform(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, const glm::vec3 &position, const glm::quat &rotation);
+
+//
+void ocDynamicsWorldGetBodyTransform(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, glm::vec3 &position, glm::quat &rotation);
+
+//
+void ocDynamicsWorldSetBodyLinearVelocity(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, const glm::vec3 &velocity);
+
+//
+glm::vec3 ocDynamicsWorldGetBodyLinearVelocity(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID);
+
+//
+void ocDynamicsWorldSetBodyAngularVelocity(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, const glm::vec3 &velocity);
+
+//
+glm::vec3 ocDynamicsWorldGetBodyAngularVelocity(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID);
+
+// Applies an impulse at a point in world space. Does nothing for static bodies.
+void ocDynamicsWorldApplyImpulse(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID, const glm::vec3 &impulse, const glm::vec3 &point);
+
+// Wakes a body and the rest of it's island. Does nothing for static bodies. Setting the velocity of a body or applying an impulse to it
+// also wakes it.
+void ocDynamicsWorldWakeBody(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID);
+
+//
+ocBool32 ocDynamicsWorldIsBodySleeping(ocDynamicsWorld* pWorld, ocDynamicsBodyID bodyID);
+
+
+// Finds the nearest body hit by each of a list of rays. Every ray gets a hit, which has a body ID of OC_DYNAMICS_BODY_NONE when nothing
+// was hit. Must not be called during a step or another query.
+ocResult ocDynamicsWorldRaycast(ocDynamicsWorld* pWorld, const ocDynamicsRay* pRays, ocUInt32 count, ocDynamicsHit* pHits);
+
+// Finds the nearest body hit by each of a list of shapes moving along a ray. Works the same way as ocDynamicsWorldRaycast().
+ocResult ocDynamicsWorldSweep(ocDynamicsWorld* pWorld, const ocDynamicsSweep* pSweeps, ocUInt32 count, ocDynamicsHit* pHits);
@@ -1,3 +1,7 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+#include "ocBVH.cpp"
+#include "ocCollision.cpp"
+#include "ocTriangleMesh.cpp"
+#include "ocBroadphase.cpp"
 #include "ocDynamicsWorld.cpp"
\ No newline at end of file
@@ -1,3 +1,7 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+#include "ocBVH.hpp"
+#include "ocCollision.hpp"
+#include "ocTriangleMesh.hpp"
+#include "ocBroadphase.hpp"
 #include "ocDynamicsWorld.hpp"
\ No newline at end of file
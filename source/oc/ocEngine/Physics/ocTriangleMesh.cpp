@@ -0,0 +1,512 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+OC_PRIVATE ocUInt32 ocTriangleMeshReadIndex(const ocGraphicsMeshDesc* pGroup, ocUInt32 i)
+{
+    if (pGroup->indexFormat == ocGraphicsIndexFormat_UInt16) {
+        return ((const ocUInt16*)pGroup->pIndices)[i];
+    } else {
+        return ((const ocUInt32*)pGroup->pIndices)[i];
+    }
+}
+
+ocResult ocTriangleMeshInit(const ocGraphicsMeshDesc* pGroups, ocUInt32 groupCount, ocTriangleMesh* pMesh)
+{
+    if (pMesh == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pMesh);
+
+    if (pGroups == NULL && groupCount > 0) return OC_INVALID_ARGS;
+
+    ocUInt32 triangleCount = 0;
+    for (ocUInt32 iGroup = 0; iGroup < groupCount; ++iGroup) {
+        if (pGroups[iGroup].primitiveType == ocGraphicsPrimitiveType_Triangle) {
+            triangleCount += pGroups[iGroup].indexCount / 3;
+        }
+    }
+
+    ocResult result = ocBVHInit(&pMesh->bvh);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // The vertices of each triangle are gathered first, along with their bounds for building the tree. They're copied into blocks
+    // once the order of the leaves is known.
+    glm::vec3* pVertices   = (glm::vec3*)ocMalloc(sizeof(glm::vec3) * ocMax(triangleCount, 1U) * 5);
+    glm::vec3* pBoundsMin  = pVertices + triangleCount*3;
+    glm::vec3* pBoundsMax  = pBoundsMin + triangleCount;
+    if (pVertices == NULL) {
+        ocBVHUninit(&pMesh->bvh);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocUInt32 iTriangle = 0;
+    for (ocUInt32 iGroup = 0; iGroup < groupCount; ++iGroup) {
+        const ocGraphicsMeshDesc* pGroup = &pGroups[iGroup];
+        if (pGroup->primitiveType != ocGraphicsPrimitiveType_Triangle) {
+            continue;
+        }
+
+        size_t vertexSize = ocGetVertexSizeFromFormat(pGroup->vertexFormat);
+        if (vertexSize == 0 || pGroup->pVertices == NULL || (pGroup->pIndices == NULL && pGroup->indexCount > 0)) {
+            result = OC_INVALID_ARGS;
+            goto done;
+        }
+
+        for (ocUInt32 iIndex = 0; iIndex + 2 < pGroup->indexCount; iIndex += 3) {
+            for (ocUInt32 iCorner = 0; iCorner < 3; ++iCorner) {
+                ocUInt32 iVertex = ocTriangleMeshReadIndex(pGroup, iIndex + iCorner);
+                if (iVertex >= pGroup->vertexCount) {
+                    result = OC_INVALID_ARGS;
+                    goto done;
+                }
+
+                const float* pPosition = (const float*)((const ocUInt8*)pGroup->pVertices + iVertex*vertexSize);
+                pVertices[iTriangle*3 + iCorner] = glm::vec3(pPosition[0], pPosition[1], pPosition[2]);
+            }
+
+            const glm::vec3* pTriangle = &pVertices[iTriangle*3];
+            pBoundsMin[iTriangle] = glm::min(glm::min(pTriangle[0], pTriangle[1]), pTriangle[2]);
+            pBoundsMax[iTriangle] = glm::max(glm::max(pTriangle[0], pTriangle[1]), pTriangle[2]);
+            iTriangle += 1;
+        }
+    }
+
+    result = ocBVHBuild(&pMesh->bvh, pBoundsMin, pBoundsMax, triangleCount);
+    if (result != OC_SUCCESS) {
+        goto done;
+    }
+
+    pMesh->blockCount = (ocUInt32)(pMesh->bvh.items.count / OC_BVH_MAX_LEAF_SIZE);
+    pMesh->pBlocks = (ocTriangleMeshBlock*)ocMalloc(sizeof(ocTriangleMeshBlock) * ocMax(pMesh->blockCount, 1U));
+    if (pMesh->pBlocks == NULL) {
+        result = OC_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    for (ocUInt32 iBlock = 0; iBlock < pMesh->blockCount; ++iBlock) {
+        ocTriangleMeshBlock* pBlock = &pMesh->pBlocks[iBlock];
+        for (ocUInt32 iSlot = 0; iSlot < OC_BVH_MAX_LEAF_SIZE; ++iSlot) {
+            ocUInt32 iItem = pMesh->bvh.items.pItems[iBlock*OC_BVH_MAX_LEAF_SIZE + iSlot];
+
+            glm::vec3 v0 = glm::vec3(0, 0, 0);
+            glm::vec3 e1 = glm::vec3(0, 0, 0);
+            glm::vec3 e2 = glm::vec3(0, 0, 0);
+            if (iItem != OC_BVH_EMPTY) {
+                v0 = pVertices[iItem*3 + 0];
+                e1 = pVertices[iItem*3 + 1] - v0;
+                e2 = pVertices[iItem*3 + 2] - v0;
+            }
+
+            pBlock->v0X[iSlot] = v0.x;
+            pBlock->v0Y[iSlot] = v0.y;
+            pBlock->v0Z[iSlot] = v0.z;
+            pBlock->e1X[iSlot] = e1.x;
+            pBlock->e1Y[iSlot] = e1.y;
+            pBlock->e1Z[iSlot] = e1.z;
+            pBlock->e2X[iSlot] = e2.x;
+            pBlock->e2Y[iSlot] = e2.y;
+            pBlock->e2Z[iSlot] = e2.z;
+            pBlock->triangleIndices[iSlot] = iItem;
+        }
+    }
+
+    pMesh->triangleCount = triangleCount;
+
+done:
+    ocFree(pVertices);
+    if (result != OC_SUCCESS) {
+        ocTriangleMeshUninit(pMesh);
+    }
+
+    return result;
+}
+
+ocResult ocTriangleMeshInitFromOCD(const void* pMeshComponentData, ocTriangleMesh* pMesh)
+{
+    if (pMesh == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pMesh);
+
+    if (pMeshComponentData == NULL) return OC_INVALID_ARGS;
+
+    // This is the same layout that's read by ocWorld when it creates the graphics meshes.
+    const ocUInt8* pComponentData = (const ocUInt8*)pMeshComponentData;
+    ocUInt32 groupCount       = *(const ocUInt32*)(pComponentData + 0);
+    ocUInt64 vertexDataOffset = *(const ocUInt64*)(pComponentData + 16);
+    ocUInt64 indexDataOffset  = *(const ocUInt64*)(pComponentData + 32);
+
+    const ocUInt8* pVertexData = pComponentData + vertexDataOffset;
+    const ocUInt8* pIndexData  = pComponentData + indexDataOffset;
+
+    ocGraphicsMeshDesc* pDescs = (ocGraphicsMeshDesc*)ocMalloc(sizeof(ocGraphicsMeshDesc) * ocMax(groupCount, 1U));
+    if (pDescs == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    const ocOCDSceneBuilderMeshGroup* pGroups = (const ocOCDSceneBuilderMeshGroup*)(pComponentData + 40);
+    for (ocUInt32 iGroup = 0; iGroup < groupCount; ++iGroup) {
+        const ocOCDSceneBuilderMeshGroup* pGroup = &pGroups[iGroup];
+
+        ocGraphicsMeshDesc* pDesc = &pDescs[iGroup];
+        pDesc->primitiveType = (ocGraphicsPrimitiveType)pGroup->primitiveType;
+        pDesc->vertexFormat  = (ocGraphicsVertexFormat)pGroup->vertexFormat;
+        pDesc->vertexCount   = pGroup->vertexCount;
+        pDesc->pVertices     = (void*)(pVertexData + pGroup->vertexDataOffset);
+        pDesc->indexFormat   = (ocGraphicsIndexFormat)pGroup->indexFormat;
+        pDesc->indexCount    = pGroup->indexCount;
+        pDesc->pIndices      = (void*)(pIndexData + pGroup->indexDataOffset);
+    }
+
+    ocResult result = ocTriangleMeshInit(pDescs, groupCount, pMesh);
+    ocFree(pDescs);
+
+    return result;
+}
+
+void ocTriangleMeshUninit(ocTriangleMesh* pMesh)
+{
+    if (pMesh == NULL) return;
+
+    ocFree(pMesh->pBlocks);
+    ocBVHUninit(&pMesh->bvh);
+    ocZeroObject(pMesh);
+}
+
+void ocTriangleMeshGetTriangle(const ocTriangleMesh* pMesh, ocUInt32 iBlock, ocUInt32 iSlot, glm::vec3 &a, glm::vec3 &b, glm::vec3 &c)
+{
+    ocAssert(pMesh != NULL);
+    ocAssert(iBlock < pMesh->blockCount);
+    ocAssert(iSlot < OC_BVH_MAX_LEAF_SIZE);
+
+    const ocTriangleMeshBlock* pBlock = &pMesh->pBlocks[iBlock];
+    a = glm::vec3(pBlock->v0X[iSlot], pBlock->v0Y[iSlot], pBlock->v0Z[iSlot]);
+    b = a + glm::vec3(pBlock->e1X[iSlot], pBlock->e1Y[iSlot], pBlock->e1Z[iSlot]);
+    c = a + glm::vec3(pBlock->e2X[iSlot], pBlock->e2Y[iSlot], pBlock->e2Z[iSlot]);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Ray Casts
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct ocTriangleMeshRaycastContext
+{
+    const ocTriangleMesh* pMesh;
+    glm::vec3 origin;
+    glm::vec3 direction;
+    ocUInt32 hitBlock;          // <-- OC_BVH_EMPTY until something is hit.
+    ocUInt32 hitSlot;
+};
+
+// Möller-Trumbore against the 4 triangles of a block at once. Degenerate triangles, which includes unused slots, have a determinant of
+// exactly 0 and are never hit.
+OC_PRIVATE float ocTriangleMeshRaycastLeaf(void* pUserData, ocUInt32 first, ocUInt32 count, float maxDistance)
+{
+    (void)count;
+
+    ocTriangleMeshRaycastContext* pContext = (ocTriangleMeshRaycastContext*)pUserData;
+    ocUInt32 iBlock = first / OC_BVH_MAX_LEAF_SIZE;
+    const ocTriangleMeshBlock* pBlock = &pContext->pMesh->pBlocks[iBlock];
+
+    float distances[4];
+
+#ifdef OC_SUPPORT_SSE2
+    __m128 dirX = _mm_set1_ps(pContext->direction.x);
+    __m128 dirY = _mm_set1_ps(pContext->direction.y);
+    __m128 dirZ = _mm_set1_ps(pContext->direction.z);
+    __m128 e1X = _mm_loadu_ps(pBlock->e1X);
+    __m128 e1Y = _mm_loadu_ps(pBlock->e1Y);
+    __m128 e1Z = _mm_loadu_ps(pBlock->e1Z);
+    __m128 e2X = _mm_loadu_ps(pBlock->e2X);
+    __m128 e2Y = _mm_loadu_ps(pBlock->e2Y);
+    __m128 e2Z = _mm_loadu_ps(pBlock->e2Z);
+
+    __m128 pX = _mm_sub_ps(_mm_mul_ps(dirY, e2Z), _mm_mul_ps(dirZ, e2Y));
+    __m128 pY = _mm_sub_ps(_mm_mul_ps(dirZ, e2X), _mm_mul_ps(dirX, e2Z));
+    __m128 pZ = _mm_sub_ps(_mm_mul_ps(dirX, e2Y), _mm_mul_ps(dirY, e2X));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1X, pX), _mm_mul_ps(e1Y, pY)), _mm_mul_ps(e1Z, pZ));
+    __m128 invDet = _mm_div_ps(_mm_set1_ps(1), det);
+
+    __m128 tX = _mm_sub_ps(_mm_set1_ps(pContext->origin.x), _mm_loadu_ps(pBlock->v0X));
+    __m128 tY = _mm_sub_ps(_mm_set1_ps(pContext->origin.y), _mm_loadu_ps(pBlock->v0Y));
+    __m128 tZ = _mm_sub_ps(_mm_set1_ps(pContext->origin.z), _mm_loadu_ps(pBlock->v0Z));
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tX, pX), _mm_mul_ps(tY, pY)), _mm_mul_ps(tZ, pZ)), invDet);
+
+    __m128 qX = _mm_sub_ps(_mm_mul_ps(tY, e1Z), _mm_mul_ps(tZ, e1Y));
+    __m128 qY = _mm_sub_ps(_mm_mul_ps(tZ, e1X), _mm_mul_ps(tX, e1Z));
+    __m128 qZ = _mm_sub_ps(_mm_mul_ps(tX, e1Y), _mm_mul_ps(tY, e1X));
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, qX), _mm_mul_ps(dirY, qY)), _mm_mul_ps(dirZ, qZ)), invDet);
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2X, qX), _mm_mul_ps(e2Y, qY)), _mm_mul_ps(e2Z, qZ)), invDet);
+
+    __m128 zero = _mm_setzero_ps();
+    __m128 isHit = _mm_cmpneq_ps(det, zero);
+    isHit = _mm_and_ps(isHit, _mm_cmpge_ps(u, zero));
+    isHit = _mm_and_ps(isHit, _mm_cmpge_ps(v, zero));
+    isHit = _mm_and_ps(isHit, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1)));
+    isHit = _mm_and_ps(isHit, _mm_cmpge_ps(t, zero));
+    isHit = _mm_and_ps(isHit, _mm_cmple_ps(t, _mm_set1_ps(maxDistance)));
+
+    _mm_storeu_ps(distances, _mm_or_ps(_mm_and_ps(isHit, t), _mm_andnot_ps(isHit, _mm_set1_ps(FLT_MAX))));
+#else
+    for (ocUInt32 iSlot = 0; iSlot < 4; ++iSlot) {
+        distances[iSlot] = FLT_MAX;
+
+        glm::vec3 e1 = glm::vec3(pBlock->e1X[iSlot], pBlock->e1Y[iSlot], pBlock->e1Z[iSlot]);
+        glm::vec3 e2 = glm::vec3(pBlock->e2X[iSlot], pBlock->e2Y[iSlot], pBlock->e2Z[iSlot]);
+        glm::vec3 p = glm::cross(pContext->direction, e2);
+        float det = glm::dot(e1, p);
+        if (det == 0) {
+            continue;
+        }
+
+        float invDet = 1 / det;
+        glm::vec3 tv = pContext->origin - glm::vec3(pBlock->v0X[iSlot], pBlock->v0Y[iSlot], pBlock->v0Z[iSlot]);
+        float u = glm::dot(tv, p) * invDet;
+        glm::vec3 q = glm::cross(tv, e1);
+        float v = glm::dot(pContext->direction, q) * invDet;
+        float t = glm::dot(e2, q) * invDet;
+        if (u >= 0 && v >= 0 && u + v <= 1 && t >= 0 && t <= maxDistance) {
+            distances[iSlot] = t;
+        }
+    }
+#endif
+
+    for (ocUInt32 iSlot = 0; iSlot < 4; ++iSlot) {
+        if (distances[iSlot] <= maxDistance) {
+            maxDistance = distances[iSlot];
+            pContext->hitBlock = iBlock;
+            pContext->hitSlot  = iSlot;
+        }
+    }
+
+    return maxDistance;
+}
+
+ocBool32 ocTriangleMeshRaycast(const ocTriangleMesh* pMesh, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit)
+{
+    if (pMesh == NULL || pHit == NULL) return OC_FALSE;
+
+    ocTriangleMeshRaycastContext context;
+    context.pMesh     = pMesh;
+    context.origin    = origin;
+    context.direction = direction;
+    context.hitBlock  = OC_BVH_EMPTY;
+    context.hitSlot   = 0;
+
+    ocBVHRay ray;
+    ray.origin      = origin;
+    ray.direction   = direction;
+    ray.extents     = glm::vec3(0, 0, 0);
+    ray.maxDistance = maxDistance;
+    ocBVHRaycast(&pMesh->bvh, &ray, ocTriangleMeshRaycastLeaf, &context);
+
+    if (context.hitBlock == OC_BVH_EMPTY) {
+        return OC_FALSE;
+    }
+
+    // The distance is recalculated for the one triangle that was hit rather than carried through the traversal.
+    glm::vec3 a, b, c;
+    ocTriangleMeshGetTriangle(pMesh, context.hitBlock, context.hitSlot, a, b, c);
+    if (!ocCollisionRaycastTriangle(a, b, c, origin, direction, FLT_MAX, pHit)) {
+        return OC_FALSE;    // <-- Only when the SIMD and scalar tests disagree right on an edge.
+    }
+
+    pHit->triangleIndex = pMesh->pBlocks[context.hitBlock].triangleIndices[context.hitSlot];
+    return OC_TRUE;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Shape Casts
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct ocTriangleMeshShapeCastContext
+{
+    const ocTriangleMesh* pMesh;
+    ocCollisionObject cast;     // <-- In the local space of the mesh.
+    glm::vec3 direction;
+    ocCollisionCastHit hit;
+    ocBool32 isHit;
+};
+
+OC_PRIVATE float ocTriangleMeshShapeCastLeaf(void* pUserData, ocUInt32 first, ocUInt32 count, float maxDistance)
+{
+    ocTriangleMeshShapeCastContext* pContext = (ocTriangleMeshShapeCastContext*)pUserData;
+    ocUInt32 iBlock = first / OC_BVH_MAX_LEAF_SIZE;
+
+    for (ocUInt32 iSlot = 0; iSlot < count; ++iSlot) {
+        glm::vec3 a, b, c;
+        ocTriangleMeshGetTriangle(pContext->pMesh, iBlock, iSlot, a, b, c);
+        if (glm::dot(glm::cross(b - a, c - a), glm::cross(b - a, c - a)) == 0) {
+            continue;
+        }
+
+        ocCollisionShape triangle = ocCollisionShapeTriangle(a, b, c);
+        ocCollisionObject object;
+        object.pShape   = &triangle;
+        object.position = glm::vec3(0, 0, 0);
+        object.rotation = glm::quat(1, 0, 0, 0);
+
+        ocCollisionCastHit hit;
+        if (ocCollisionShapeCast(&pContext->cast, pContext->direction, maxDistance, &object, &hit) && hit.distance <= maxDistance) {
+            maxDistance = hit.distance;
+            pContext->hit = hit;
+            pContext->hit.triangleIndex = pContext->pMesh->pBlocks[iBlock].triangleIndices[iSlot];
+            pContext->isHit = OC_TRUE;
+        }
+    }
+
+    return maxDistance;
+}
+
+ocBool32 ocTriangleMeshShapeCast(const ocCollisionObject* pMeshObject, const ocCollisionObject* pCast, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit)
+{
+    if (pMeshObject == NULL || pCast == NULL || pHit == NULL) return OC_FALSE;
+    ocAssert(pMeshObject->pShape->type == ocCollisionShapeType_TriangleMesh);
+
+    // Everything is done in the local space of the mesh, where the cast shape's bounds are swept through the tree.
+    glm::quat inverseRotation = glm::conjugate(pMeshObject->rotation);
+
+    ocTriangleMeshShapeCastContext context;
+    context.pMesh           = pMeshObject->pShape->triangleMesh.pMesh;
+    context.cast.pShape     = pCast->pShape;
+    context.cast.position   = inverseRotation * (pCast->position - pMeshObject->position);
+    context.cast.rotation   = inverseRotation * pCast->rotation;
+    context.direction       = inverseRotation * direction;
+    context.isHit           = OC_FALSE;
+
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+    ocCollisionShapeGetAABB(context.cast.pShape, context.cast.position, context.cast.rotation, aabbMin, aabbMax);
+
+    ocBVHRay ray;
+    ray.origin      = (aabbMin + aabbMax) * 0.5f;
+    ray.direction   = context.direction;
+    ray.extents     = (aabbMax - aabbMin) * 0.5f;
+    ray.maxDistance = maxDistance;
+    ocBVHRaycast(&context.pMesh->bvh, &ray, ocTriangleMeshShapeCastLeaf, &context);
+
+    if (!context.isHit) {
+        return OC_FALSE;
+    }
+
+    *pHit = context.hit;
+    pHit->position = pMeshObject->position + pMeshObject->rotation * context.hit.position;
+    pHit->normal   = pMeshObject->rotation * context.hit.normal;
+    return OC_TRUE;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Contacts
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct ocTriangleMeshCollideContext
+{
+    const ocTriangleMesh* pMesh;
+    const ocCollisionObject* pMeshObject;
+    const ocCollisionObject* pOther;
+    ocBool32 isMeshA;
+    float margin;
+    ocTriangleMeshContact* pContacts;
+    ocUInt32 maxContacts;
+    ocUInt32 contactCount;
+};
+
+OC_INLINE float ocTriangleMeshContactDepth(const ocContactManifold* pManifold)
+{
+    float separation = FLT_MAX;
+    for (ocUInt32 iPoint = 0; iPoint < pManifold->pointCount; ++iPoint) {
+        separation = ocMin(separation, pManifold->points[iPoint].separation);
+    }
+
+    return -separation;
+}
+
+OC_PRIVATE void ocTriangleMeshCollideLeaf(void* pUserData, ocUInt32 first, ocUInt32 count)
+{
+    ocTriangleMeshCollideContext* pContext = (ocTriangleMeshCollideContext*)pUserData;
+    ocUInt32 iBlock = first / OC_BVH_MAX_LEAF_SIZE;
+
+    for (ocUInt32 iSlot = 0; iSlot < count; ++iSlot) {
+        glm::vec3 a, b, c;
+        ocTriangleMeshGetTriangle(pContext->pMesh, iBlock, iSlot, a, b, c);
+        if (glm::dot(glm::cross(b - a, c - a), glm::cross(b - a, c - a)) == 0) {
+            continue;   // <-- No area, so no normal.
+        }
+
+        ocCollisionShape triangle = ocCollisionShapeTriangle(a, b, c);
+        ocCollisionObject object;
+        object.pShape   = &triangle;
+        object.position = pContext->pMeshObject->position;
+        object.rotation = pContext->pMeshObject->rotation;
+
+        ocTriangleMeshContact contact;
+        contact.triangleIndex = pContext->pMesh->pBlocks[iBlock].triangleIndices[iSlot];
+
+        ocBool32 isTouching;
+        if (pContext->isMeshA) {
+            isTouching = ocCollide(&object, pContext->pOther, pContext->margin, &contact.manifold);
+        } else {
+            isTouching = ocCollide(pContext->pOther, &object, pContext->margin, &contact.manifold);
+        }
+
+        if (!isTouching || contact.manifold.pointCount == 0) {
+            continue;
+        }
+
+        if (pContext->contactCount < pContext->maxContacts) {
+            pContext->pContacts[pContext->contactCount++] = contact;
+            continue;
+        }
+
+        // Full, so the shallowest contact is replaced if this one is deeper.
+        ocUInt32 iShallowest = 0;
+        for (ocUInt32 iContact = 1; iContact < pContext->contactCount; ++iContact) {
+            if (ocTriangleMeshContactDepth(&pContext->pContacts[iContact].manifold) < ocTriangleMeshContactDepth(&pContext->pContacts[iShallowest].manifold)) {
+                iShallowest = iContact;
+            }
+        }
+
+        if (ocTriangleMeshContactDepth(&contact.manifold) > ocTriangleMeshContactDepth(&pContext->pContacts[iShallowest].manifold)) {
+            pContext->pContacts[iShallowest] = contact;
+        }
+    }
+}
+
+ocUInt32 ocTriangleMeshCollide(const ocCollisionObject* pA, const ocCollisionObject* pB, float margin, ocTriangleMeshContact* pContacts, ocUInt32 maxContacts)
+{
+    if (pA == NULL || pB == NULL || pContacts == NULL || maxContacts == 0) return 0;
+
+    ocTriangleMeshCollideContext context;
+    context.isMeshA = pA->pShape->type == ocCollisionShapeType_TriangleMesh;
+    context.pMeshObject  = context.isMeshA ? pA : pB;
+    context.pOther       = context.isMeshA ? pB : pA;
+    context.pMesh        = context.pMeshObject->pShape->triangleMesh.pMesh;
+    context.margin       = margin;
+    context.pContacts    = pContacts;
+    context.maxContacts  = maxContacts;
+    context.contactCount = 0;
+
+    ocAssert(context.pMeshObject->pShape->type == ocCollisionShapeType_TriangleMesh);
+    ocAssert(context.pOther->pShape->type != ocCollisionShapeType_TriangleMesh);
+
+    // The bounds of the other object are moved into the local space of the mesh to find the triangles it might be touching.
+    glm::vec3 aabbMin;
+    glm::vec3 aabbMax;
+    ocCollisionShapeGetAABB(context.pOther->pShape, context.pOther->position, context.pOther->rotation, aabbMin, aabbMax);
+
+    glm::quat inverseRotation = glm::conjugate(context.pMeshObject->rotation);
+    glm::vec3 localCenter  = inverseRotation * ((aabbMin + aabbMax) * 0.5f - context.pMeshObject->position);
+    glm::vec3 localExtents = ocCollisionRotateExtents(inverseRotation, (aabbMax - aabbMin) * 0.5f) + glm::vec3(margin);
+    ocBVHQuery(&context.pMesh->bvh, localCenter - localExtents, localCenter + localExtents, ocTriangleMeshCollideLeaf, &context);
+
+    return context.contactCount;
+}
@@ -0,0 +1,63 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Static triangle meshes for collision and scene queries, such as level geometry and terrain.
+//
+// Triangles are put in an ocBVH, and the triangles of each leaf are copied into a block of 4 which is stored as a structure of arrays.
+// A ray is tested against all 4 triangles of a block at once with SIMD. Blocks are stored in the same order as the leaves, which keeps
+// triangles that are near each other near each other in memory. Each triangle is stored as a vertex and two edges, which is what the
+// ray test needs, so vertices are duplicated between triangles. Triangles are hit from both sides.
+//
+// Triangles are numbered in the order they appear in the source, across every group. This is the triangleIndex reported by hits and
+// contacts.
+
+struct ocTriangleMeshBlock
+{
+    float v0X[4];
+    float v0Y[4];
+    float v0Z[4];
+    float e1X[4];                   // <-- v1 - v0.
+    float e1Y[4];
+    float e1Z[4];
+    float e2X[4];                   // <-- v2 - v0.
+    float e2Y[4];
+    float e2Z[4];
+    ocUInt32 triangleIndices[4];    // <-- OC_BVH_EMPTY for unused slots, which are degenerate and are never hit.
+};
+
+struct ocTriangleMesh
+{
+    ocBVH bvh;
+    ocTriangleMeshBlock* pBlocks;   // <-- One for each leaf. The block of a leaf is the index of it's first item / OC_BVH_MAX_LEAF_SIZE.
+    ocUInt32 blockCount;
+    ocUInt32 triangleCount;
+};
+
+// A triangle from a mesh that's touching something, for ocTriangleMeshCollide().
+struct ocTriangleMeshContact
+{
+    ocUInt32 triangleIndex;
+    ocContactManifold manifold;
+};
+
+// Creates a mesh from the triangle groups of a graphics mesh. Groups that are not made of triangles are skipped. Only the position of
+// each vertex is used, which is always the first 3 floats.
+ocResult ocTriangleMeshInit(const ocGraphicsMeshDesc* pGroups, ocUInt32 groupCount, ocTriangleMesh* pMesh);
+
+// Creates a mesh from the data of a mesh component of an OCD scene.
+ocResult ocTriangleMeshInitFromOCD(const void* pMeshComponentData, ocTriangleMesh* pMesh);
+
+//
+void ocTriangleMeshUninit(ocTriangleMesh* pMesh);
+
+// Retrieves the vertices of a triangle from the block it's stored in.
+void ocTriangleMeshGetTriangle(const ocTriangleMesh* pMesh, ocUInt32 iBlock, ocUInt32 iSlot, glm::vec3 &a, glm::vec3 &b, glm::vec3 &c);
+
+// Finds the nearest triangle hit by a ray, in the local space of the mesh. The direction must be normalized.
+ocBool32 ocTriangleMeshRaycast(const ocTriangleMesh* pMesh, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit);
+
+// Finds the first triangle of a mesh hit by a shape moving along a ray, in world space. pMeshObject must be a triangle mesh.
+ocBool32 ocTriangleMeshShapeCast(const ocCollisionObject* pMeshObject, const ocCollisionObject* pCast, const glm::vec3 &direction, float maxDistance, ocCollisionCastHit* pHit);
+
+// Finds the triangles that are touching a convex object. Exactly one of A and B must be a triangle mesh, and normals point from A to B
+// like ocCollide(). When there are more than maxContacts triangles touching, the deepest ones are kept. Returns the number of contacts.
+ocUInt32 ocTriangleMeshCollide(const ocCollisionObject* pA, const ocCollisionObject* pB, float margin, ocTriangleMeshContact* pContacts, ocUInt32 maxContacts);
@@ -72,6 +72,25 @@
 #endif
 #endif
 
+// SIMD. SSE2 is part of the x64 baseline so there's no need for a run-time check. Define OC_NO_SSE2 to force the scalar code paths.
+#if !defined(OC_NO_SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OC_SUPPORT_SSE2
+#endif
+#endif
+
+// AVX2 is not part of the baseline, so it's only enabled for the functions that use it, which are marked with OC_AVX2_FUNCTION, and only
+// called after a run-time check. Define OC_NO_AVX2 to leave out the AVX2 code paths.
+#if defined(OC_SUPPORT_SSE2) && !defined(OC_NO_AVX2)
+#if defined(_MSC_VER) && _MSC_VER >= 1800
+#define OC_SUPPORT_AVX2
+#define OC_AVX2_FUNCTION
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OC_SUPPORT_AVX2
+#define OC_AVX2_FUNCTION    __attribute__((target("avx2")))
+#endif
+#endif
+
 #ifndef NDEBUG
 #define OC_DEBUG
 #else
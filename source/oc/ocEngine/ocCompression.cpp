@@ -0,0 +1,237 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_LZ_HASH_BITS     14
+
+OC_INLINE ocUInt32 ocLZRead32(const ocUInt8* p)
+{
+    ocUInt32 value;
+    ocCopyMemory(&value, p, 4);
+    return value;
+}
+
+OC_INLINE ocUInt32 ocLZHash(ocUInt32 value)
+{
+    return (value * 2654435761U) >> (32 - OC_LZ_HASH_BITS);
+}
+
+OC_PRIVATE ocUInt8* ocLZWriteLength(ocUInt8* pOut, ocSizeT length)
+{
+    // The first 15 is stored in the token.
+    ocAssert(length >= 15);
+    length -= 15;
+
+    while (length >= 255) {
+        *pOut++ = 255;
+        length -= 255;
+    }
+
+    *pOut++ = (ocUInt8)length;
+    return pOut;
+}
+
+OC_PRIVATE ocUInt8* ocLZWriteSequence(ocUInt8* pOut, const ocUInt8* pLiterals, ocSizeT literalCount, ocSizeT matchOffset, ocSizeT matchLength)
+{
+    ocUInt8* pToken = pOut++;
+    ocUInt8 token;
+
+    if (literalCount >= 15) {
+        token = 15 << 4;
+        pOut = ocLZWriteLength(pOut, literalCount);
+    } else {
+        token = (ocUInt8)(literalCount << 4);
+    }
+
+    ocCopyMemory(pOut, pLiterals, literalCount);
+    pOut += literalCount;
+
+    // A match length of 0 means this is the last sequence.
+    if (matchLength > 0) {
+        ocAssert(matchLength >= OC_LZ_MIN_MATCH);
+        ocAssert(matchOffset > 0 && matchOffset <= OC_LZ_MAX_OFFSET);
+
+        *pOut++ = (ocUInt8)((matchOffset >> 0) & 0xFF);
+        *pOut++ = (ocUInt8)((matchOffset >> 8) & 0xFF);
+
+        matchLength -= OC_LZ_MIN_MATCH;
+        if (matchLength >= 15) {
+            token |= 15;
+            pOut = ocLZWriteLength(pOut, matchLength);
+        } else {
+            token |= (ocUInt8)matchLength;
+        }
+    }
+
+    *pToken = token;
+    return pOut;
+}
+
+OC_PRIVATE ocResult ocLZReadLength(const ocUInt8** ppIn, const ocUInt8* pInEnd, ocSizeT* pLength)
+{
+    const ocUInt8* pIn = *ppIn;
+    for (;;) {
+        if (pIn >= pInEnd) {
+            return OC_CORRUPT_FILE;
+        }
+
+        ocUInt8 b = *pIn++;
+        *pLength += b;
+
+        if (b != 255) {
+            break;
+        }
+    }
+
+    *ppIn = pIn;
+    return OC_SUCCESS;
+}
+
+
+ocSizeT ocLZCompressBound(ocSizeT srcSize)
+{
+    return srcSize + (srcSize / 255) + 16;
+}
+
+ocResult ocLZCompress(const void* pSrc, ocSizeT srcSize, void* pDst, ocSizeT dstCapacity, ocSizeT* pDstSize)
+{
+    if (pDstSize == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *pDstSize = 0;
+
+    if ((pSrc == NULL && srcSize > 0) || pDst == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (dstCapacity < ocLZCompressBound(srcSize)) {
+        return OC_INVALID_ARGS;
+    }
+
+    // Positions are stored as 32-bit in the hash table.
+    if (srcSize > 0xFFFFFFF0) {
+        return OC_TOO_LARGE;
+    }
+
+    // Each slot in the hash table is the position of the last occurance of a 4 byte sequence, plus 1. A value of 0 means the slot is empty.
+    ocUInt32* pHashTable = (ocUInt32*)ocCalloc((ocSizeT)1 << OC_LZ_HASH_BITS, sizeof(ocUInt32));
+    if (pHashTable == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    const ocUInt8* pIn = (const ocUInt8*)pSrc;
+    ocUInt8* pOut = (ocUInt8*)pDst;
+    ocSizeT anchor = 0;
+    ocSizeT pos = 0;
+
+    if (srcSize >= OC_LZ_MIN_MATCH) {
+        ocSizeT matchLimit = srcSize - OC_LZ_MIN_MATCH;
+        while (pos <= matchLimit) {
+            ocUInt32 sequence = ocLZRead32(pIn + pos);
+            ocUInt32 hash = ocLZHash(sequence);
+            ocSizeT candidate = pHashTable[hash];
+            pHashTable[hash] = (ocUInt32)(pos + 1);
+
+            if (candidate == 0 || (pos - (candidate - 1)) > OC_LZ_MAX_OFFSET || ocLZRead32(pIn + (candidate - 1)) != sequence) {
+                pos += 1;
+                continue;
+            }
+
+            candidate -= 1;
+
+            ocSizeT matchLength = OC_LZ_MIN_MATCH;
+            while (pos + matchLength < srcSize && pIn[candidate + matchLength] == pIn[pos + matchLength]) {
+                matchLength += 1;
+            }
+
+            pOut = ocLZWriteSequence(pOut, pIn + anchor, pos - anchor, pos - candidate, matchLength);
+            pos += matchLength;
+            anchor = pos;
+        }
+    }
+
+    // The last sequence is just the remaining literals.
+    pOut = ocLZWriteSequence(pOut, pIn + anchor, srcSize - anchor, 0, 0);
+
+    ocFree(pHashTable);
+
+    *pDstSize = (ocSizeT)(pOut - (ocUInt8*)pDst);
+    return OC_SUCCESS;
+}
+
+ocResult ocLZDecompress(const void* pSrc, ocSizeT srcSize, void* pDst, ocSizeT dstSize)
+{
+    if ((pSrc == NULL && srcSize > 0) || (pDst == NULL && dstSize > 0)) {
+        return OC_INVALID_ARGS;
+    }
+
+    const ocUInt8* pIn     = (const ocUInt8*)pSrc;
+    const ocUInt8* pInEnd  = pIn + srcSize;
+    ocUInt8*       pOut    = (ocUInt8*)pDst;
+    ocUInt8*       pOutEnd = pOut + dstSize;
+
+    while (pIn < pInEnd) {
+        ocUInt8 token = *pIn++;
+
+        // Literals.
+        ocSizeT literalCount = token >> 4;
+        if (literalCount == 15) {
+            if (ocLZReadLength(&pIn, pInEnd, &literalCount) != OC_SUCCESS) {
+                return OC_CORRUPT_FILE;
+            }
+        }
+
+        if (literalCount > (ocSizeT)(pInEnd - pIn) || literalCount > (ocSizeT)(pOutEnd - pOut)) {
+            return OC_CORRUPT_FILE;
+        }
+
+        ocCopyMemory(pOut, pIn, literalCount);
+        pIn  += literalCount;
+        pOut += literalCount;
+
+        // The last sequence does not have a match.
+        if (pIn == pInEnd) {
+            break;
+        }
+
+        // Match.
+        if ((pInEnd - pIn) < 2) {
+            return OC_CORRUPT_FILE;
+        }
+
+        ocSizeT matchOffset = (ocSizeT)pIn[0] | ((ocSizeT)pIn[1] << 8);
+        pIn += 2;
+
+        if (matchOffset == 0 || matchOffset > (ocSizeT)(pOut - (ocUInt8*)pDst)) {
+            return OC_CORRUPT_FILE;
+        }
+
+        ocSizeT matchLength = token & 0x0F;
+        if (matchLength == 15) {
+            if (ocLZReadLength(&pIn, pInEnd, &matchLength) != OC_SUCCESS) {
+                return OC_CORRUPT_FILE;
+            }
+        }
+        matchLength += OC_LZ_MIN_MATCH;
+
+        if (matchLength > (ocSizeT)(pOutEnd - pOut)) {
+            return OC_CORRUPT_FILE;
+        }
+
+        // Matches are allowed to overlap the output which is how runs are encoded. In this case it needs to be copied byte-by-byte.
+        const ocUInt8* pMatch = pOut - matchOffset;
+        if (matchOffset >= matchLength) {
+            ocCopyMemory(pOut, pMatch, matchLength);
+            pOut += matchLength;
+        } else {
+            for (ocSizeT i = 0; i < matchLength; ++i) {
+                *pOut++ = *pMatch++;
+            }
+        }
+    }
+
+    if (pOut != pOutEnd) {
+        return OC_CORRUPT_FILE;
+    }
+
+    return OC_SUCCESS;
+}
\ No newline at end of file
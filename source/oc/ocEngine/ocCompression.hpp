@@ -0,0 +1,29 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// This is a simple byte-oriented LZ77 codec. It's not trying to compete with the likes of zlib in terms of compression ratio - the
+// priority is fast decompression and having something in-tree that doesn't pull in another dependency.
+//
+// Compressed data is a list of sequences. Each sequence is made up of the following:
+//   [1 byte]  Token. The high 4 bits is the literal count and the low 4 bits is the match length minus OC_LZ_MIN_MATCH. When either
+//             is 15, the length continues in the following bytes. Each of these bytes is added to the length, stopping at the first
+//             byte that is not 255.
+//   [?]       Literal bytes.
+//   [2 bytes] Match offset. This is the distance back from the current output position (little-endian).
+//
+// The last sequence only contains literals and does not have a match.
+
+#define OC_LZ_MIN_MATCH     4
+#define OC_LZ_MAX_OFFSET    65535
+
+// Retrieves the maximum size of compressed data for the given input size. Use this to size the output buffer of ocLZCompress().
+ocSizeT ocLZCompressBound(ocSizeT srcSize);
+
+// Compresses a buffer.
+//
+// dstCapacity must be at least ocLZCompressBound(srcSize). pDstSize receives the number of bytes written to pDst.
+ocResult ocLZCompress(const void* pSrc, ocSizeT srcSize, void* pDst, ocSizeT dstCapacity, ocSizeT* pDstSize);
+
+// Decompresses a buffer.
+//
+// dstSize must be the exact size of the uncompressed data. Returns OC_CORRUPT_FILE if the compressed data is malformed.
+ocResult ocLZDecompress(const void* pSrc, ocSizeT srcSize, void* pDst, ocSizeT dstSize);
\ No newline at end of file
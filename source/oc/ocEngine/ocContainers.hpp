@@ -55,6 +55,59 @@ template <typename T> ocResult ocStackPush(ocStack<T>* pStack, const T &item)
     return OC_SUCCESS;
 }
 
+template <typename T> ocResult ocStackPushArray(ocStack<T>* pStack, const T* pItems, size_t count)
+{
+    if (pStack == NULL || (pItems == NULL && count > 0)) return OC_INVALID_ARGS;
+
+    if (pStack->capacity < pStack->count + count) {
+        // Resize.
+        size_t newCapacity = (pStack->capacity == 0) ? 4 : pStack->capacity*2;
+        if (newCapacity < pStack->count + count) {
+            newCapacity = pStack->count + count;
+        }
+
+        T* pNewItems = (T*)ocRealloc(pStack->pItems, sizeof(T) * newCapacity);
+        if (pNewItems == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+
+        pStack->pItems = pNewItems;
+        pStack->capacity = newCapacity;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        pStack->pItems[pStack->count + i] = pItems[i];
+    }
+    pStack->count += count;
+
+    return OC_SUCCESS;
+}
+
+// Sets the number of items in the stack. New items are uninitialized.
+template <typename T> ocResult ocStackResize(ocStack<T>* pStack, size_t count)
+{
+    if (pStack == NULL) return OC_INVALID_ARGS;
+
+    if (pStack->capacity < count) {
+        size_t newCapacity = (pStack->capacity == 0) ? 4 : pStack->capacity*2;
+        if (newCapacity < count) {
+            newCapacity = count;
+        }
+
+        T* pNewItems = (T*)ocRealloc(pStack->pItems, sizeof(T) * newCapacity);
+        if (pNewItems == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+
+        pStack->pItems = pNewItems;
+        pStack->capacity = newCapacity;
+    }
+
+    pStack->count = count;
+
+    return OC_SUCCESS;
+}
+
 template <typename T> ocResult ocStackPop(ocStack<T>* pStack)
 {
     if (pStack == NULL) return OC_INVALID_ARGS;
@@ -87,3 +140,82 @@ template <typename T> ocResult ocStackClear(ocStack<T>* pStack)
     pStack->count = 0;
     return OC_SUCCESS;
 }
+
+
+//
+// Single Producer, Single Consumer Queue
+//
+// A fixed capacity, lock-free ring buffer for passing items between exactly two threads. Push() must only ever be called from one
+// thread and Pop() from one other thread. Neither allocates, so both are safe to use from a real-time thread such as the audio callback.
+// The indices increase forever and are wrapped with a mask, which is why the capacity must be a power of 2.
+//
+template <typename T>
+struct ocSPSCQueue
+{
+    T* pItems;
+    ocUInt32 capacity;
+    volatile ocUInt32 writeIndex;   // <-- Only written by the producer.
+    volatile ocUInt32 readIndex;    // <-- Only written by the consumer.
+};
+
+template <typename T> ocResult ocSPSCQueueInit(ocUInt32 capacity, ocSPSCQueue<T>* pQueue)
+{
+    if (pQueue == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pQueue);
+
+    if (capacity == 0 || (capacity & (capacity-1)) != 0) {
+        return OC_INVALID_ARGS; // <-- Must be a power of 2.
+    }
+
+    pQueue->pItems = (T*)ocMalloc(sizeof(T) * capacity);
+    if (pQueue->pItems == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pQueue->capacity = capacity;
+
+    return OC_SUCCESS;
+}
+
+template <typename T> ocResult ocSPSCQueueUninit(ocSPSCQueue<T>* pQueue)
+{
+    if (pQueue == NULL) return OC_INVALID_ARGS;
+
+    ocFree(pQueue->pItems);
+    return OC_SUCCESS;
+}
+
+// Producer only. Returns OC_TOO_LARGE if the queue is full, in which case the item is not added.
+template <typename T> ocResult ocSPSCQueuePush(ocSPSCQueue<T>* pQueue, const T &item)
+{
+    if (pQueue == NULL) return OC_INVALID_ARGS;
+
+    ocUInt32 writeIndex = pQueue->writeIndex;
+    ocUInt32 readIndex  = ocAtomicLoad(&pQueue->readIndex);
+    if (writeIndex - readIndex == pQueue->capacity) {
+        return OC_TOO_LARGE;
+    }
+
+    pQueue->pItems[writeIndex & (pQueue->capacity-1)] = item;
+    ocAtomicStore(&pQueue->writeIndex, writeIndex + 1);   // <-- Publishes the item to the consumer.
+
+    return OC_SUCCESS;
+}
+
+// Consumer only. Returns OC_FALSE if the queue is empty.
+template <typename T> ocBool32 ocSPSCQueuePop(ocSPSCQueue<T>* pQueue, T* pItemOut)
+{
+    ocAssert(pQueue != NULL);
+    ocAssert(pItemOut != NULL);
+
+    ocUInt32 readIndex  = pQueue->readIndex;
+    ocUInt32 writeIndex = ocAtomicLoad(&pQueue->writeIndex);
+    if (readIndex == writeIndex) {
+        return OC_FALSE;
+    }
+
+    *pItemOut = pQueue->pItems[readIndex & (pQueue->capacity-1)];
+    ocAtomicStore(&pQueue->readIndex, readIndex + 1);     // <-- Gives the slot back to the producer.
+
+    return OC_TRUE;
+}
@@ -0,0 +1,242 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+struct ocDerivedDataCacheWriteJob
+{
+    ocDerivedDataCache* pCache;
+    ocUInt64 key;
+    void* pData;
+    ocSizeT dataSize;
+};
+
+OC_PRIVATE void ocDerivedDataCacheWriteJobProc(void* pUserData)
+{
+    ocDerivedDataCacheWriteJob* pJob = (ocDerivedDataCacheWriteJob*)pUserData;
+    ocAssert(pJob != NULL);
+
+    // There's nobody to report an error to here. A failed write just means the item will be converted again next time.
+    ocDerivedDataCacheStore(pJob->pCache, pJob->key, pJob->pData, pJob->dataSize);
+
+    ocFree(pJob->pData);
+    ocFree(pJob);
+}
+
+
+ocResult ocDerivedDataCacheInit(const char* directory, ocJobQueue* pJobQueue, ocDerivedDataCache* pCache)
+{
+    if (pCache == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pCache);
+
+    if (directory == NULL || directory[0] == '\0') {
+        return OC_INVALID_ARGS;
+    }
+
+    if (oc_strcpy_s(pCache->directory, sizeof(pCache->directory), directory) != 0) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    pCache->pJobQueue = pJobQueue;
+
+    if (!ocIsDirectory(pCache->directory)) {
+        ocResult result = ocCreateDirectoryRecursive(pCache->directory);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    return OC_SUCCESS;
+}
+
+void ocDerivedDataCacheUninit(ocDerivedDataCache* pCache)
+{
+    if (pCache == NULL) {
+        return;
+    }
+
+    if (pCache->pJobQueue != NULL) {
+        ocJobQueueWaitForCounter(pCache->pJobQueue, &pCache->pendingWriteCount);
+    }
+}
+
+ocUInt64 ocDerivedDataCacheMakeKey(const void* pSourceData, ocSizeT sourceDataSize, ocUInt32 converterID, ocUInt32 converterVersion)
+{
+    ocUInt64 sourceSize = sourceDataSize;
+
+    // The converter is hashed first so that items produced by different converters from the same source never share a key.
+    ocUInt64 hash = ocHashFNV1a64(&converterID, sizeof(converterID));
+    hash = ocHashFNV1a64(&converterVersion, sizeof(converterVersion), hash);
+    hash = ocHashFNV1a64(&sourceSize, sizeof(sourceSize), hash);
+    hash = ocHashFNV1a64(pSourceData, sourceDataSize, hash);
+
+    return hash;
+}
+
+ocResult ocDerivedDataCacheMakeKey(ocStreamReader* pReader, ocUInt32 converterID, ocUInt32 converterVersion, ocUInt64* pKey)
+{
+    if (pKey == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *pKey = 0;
+
+    if (pReader == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    // The size is hashed before the data so it needs to be known up front.
+    ocUInt64 sourceEnd;
+    ocResult result = ocStreamReaderSize(pReader, &sourceEnd);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocUInt64 sourceStart;
+    result = ocStreamReaderTell(pReader, &sourceStart);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocUInt64 sourceSize = sourceEnd - sourceStart;
+
+    ocUInt64 hash = ocHashFNV1a64(&converterID, sizeof(converterID));
+    hash = ocHashFNV1a64(&converterVersion, sizeof(converterVersion), hash);
+    hash = ocHashFNV1a64(&sourceSize, sizeof(sourceSize), hash);
+
+    ocUInt8 block[4096];
+    ocUInt64 totalBytesRead = 0;
+    for (;;) {
+        ocSizeT bytesRead = 0;
+        result = ocStreamReaderRead(pReader, block, sizeof(block), &bytesRead);
+        if (result == OC_AT_END_OF_FILE || (result == OC_SUCCESS && bytesRead == 0)) {
+            break;
+        }
+
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        hash = ocHashFNV1a64(block, bytesRead, hash);
+        totalBytesRead += bytesRead;
+    }
+
+    // The file changed while it was being read.
+    if (totalBytesRead != sourceSize) {
+        return OC_ERROR;
+    }
+
+    *pKey = hash;
+    return OC_SUCCESS;
+}
+
+ocResult ocDerivedDataCacheGetItemPath(ocDerivedDataCache* pCache, ocUInt64 key, char* pathOut, size_t pathOutSize)
+{
+    if (pCache == NULL || pathOut == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    int length = snprintf(pathOut, pathOutSize, "%s/%016llx.%s", pCache->directory, (unsigned long long)key, OC_DERIVED_DATA_CACHE_EXTENSION);
+    if (length < 0 || (size_t)length >= pathOutSize) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocDerivedDataCacheLoad(ocDerivedDataCache* pCache, ocUInt64 key, void** ppData, ocSizeT* pDataSize)
+{
+    if (ppData == NULL || pDataSize == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppData = NULL;
+    *pDataSize = 0;
+
+    if (pCache == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    char itemPath[OC_MAX_PATH];
+    ocResult result = ocDerivedDataCacheGetItemPath(pCache, key, itemPath, sizeof(itemPath));
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    return ocOpenAndReadFile(itemPath, ppData, pDataSize);
+}
+
+ocResult ocDerivedDataCacheStore(ocDerivedDataCache* pCache, ocUInt64 key, const void* pData, ocSizeT dataSize)
+{
+    if (pCache == NULL || pData == NULL || dataSize == 0) {
+        return OC_INVALID_ARGS;
+    }
+
+    char itemPath[OC_MAX_PATH];
+    ocResult result = ocDerivedDataCacheGetItemPath(pCache, key, itemPath, sizeof(itemPath));
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // The temporary file needs a unique name because the same item may be written by multiple threads, or multiple instances of
+    // the engine, at the same time.
+#ifdef OC_WIN32
+    unsigned int processID = (unsigned int)GetCurrentProcessId();
+#else
+    unsigned int processID = (unsigned int)getpid();
+#endif
+
+    char tempPath[OC_MAX_PATH];
+    int length = snprintf(tempPath, sizeof(tempPath), "%s.%u.%u.tmp", itemPath, processID, (unsigned int)ocAtomicIncrement(&pCache->tempFileCounter));
+    if (length < 0 || (size_t)length >= sizeof(tempPath)) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    result = ocOpenAndWriteFile(tempPath, pData, dataSize);
+    if (result != OC_SUCCESS) {
+        remove(tempPath);
+        return result;
+    }
+
+    result = ocMoveFile(tempPath, itemPath);
+    if (result != OC_SUCCESS) {
+        remove(tempPath);
+        return result;
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocDerivedDataCacheStoreAsync(ocDerivedDataCache* pCache, ocUInt64 key, void* pData, ocSizeT dataSize)
+{
+    if (pCache == NULL || pData == NULL || dataSize == 0) {
+        ocFree(pData);
+        return OC_INVALID_ARGS;
+    }
+
+    if (pCache->pJobQueue == NULL) {
+        ocResult result = ocDerivedDataCacheStore(pCache, key, pData, dataSize);
+        ocFree(pData);
+        return result;
+    }
+
+    ocDerivedDataCacheWriteJob* pJob = ocMallocObject(ocDerivedDataCacheWriteJob);
+    if (pJob == NULL) {
+        ocFree(pData);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pJob->pCache   = pCache;
+    pJob->key      = key;
+    pJob->pData    = pData;
+    pJob->dataSize = dataSize;
+
+    ocResult result = ocJobQueueSubmit(pCache->pJobQueue, ocDerivedDataCacheWriteJobProc, pJob, &pCache->pendingWriteCount);
+    if (result != OC_SUCCESS) {
+        ocFree(pJob->pData);
+        ocFree(pJob);
+        return result;
+    }
+
+    return OC_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// The derived data cache stores the output of converters (cooked .ocd files) so that source assets only need to be converted once.
+//
+// Each item is keyed by a hash of the content of the source asset combined with an identifier and version of the converter that
+// produced it. Timestamps are never used, so copying a source file or checking it out of version control does not cause it to be
+// converted again, and editing a file always results in a different key. Changing the output of a converter requires the version to
+// be bumped so that old items are ignored.
+//
+// Items are stored as individual files named after their key. Writes go to a temporary file which is then moved into place, which
+// means an item is either complete or it doesn't exist. Nothing is ever deleted automatically - it's always safe to delete the cache
+// directory.
+
+#define OC_DERIVED_DATA_CACHE_EXTENSION     "ocd"
+
+struct ocDerivedDataCache
+{
+    char directory[OC_MAX_PATH];
+    ocJobQueue* pJobQueue;
+    ocUInt32 pendingWriteCount;     // <-- Modified atomically.
+    ocUInt32 tempFileCounter;       // <-- Modified atomically.
+};
+
+// Initializes the cache.
+//
+// The directory will be created if it does not already exist. pJobQueue is used to write items in the background and can be NULL, in
+// which case ocDerivedDataCacheStoreAsync() will write synchronously.
+ocResult ocDerivedDataCacheInit(const char* directory, ocJobQueue* pJobQueue, ocDerivedDataCache* pCache);
+
+// Uninitializes the cache. This will wait for any pending writes to complete.
+void ocDerivedDataCacheUninit(ocDerivedDataCache* pCache);
+
+// Calculates the key of an item from the content of it's source asset.
+//
+// converterID identifies the converter that produces the item, such as the OCD type ID. converterVersion should be incremented every
+// time the converter's output changes.
+ocUInt64 ocDerivedDataCacheMakeKey(const void* pSourceData, ocSizeT sourceDataSize, ocUInt32 converterID, ocUInt32 converterVersion);
+
+// The same as above, except the source asset is read from the current position of a stream to the end, one block at a time, so it
+// never needs to be in memory in it's entirety. The key is the same as the one for the same data in memory.
+ocResult ocDerivedDataCacheMakeKey(ocStreamReader* pReader, ocUInt32 converterID, ocUInt32 converterVersion, ocUInt64* pKey);
+
+// Retrieves the path of the file for the item with the given key.
+ocResult ocDerivedDataCacheGetItemPath(ocDerivedDataCache* pCache, ocUInt64 key, char* pathOut, size_t pathOutSize);
+
+// Loads an item. Returns OC_DOES_NOT_EXIST if the item is not in the cache.
+//
+// Free the returned data with ocFree().
+ocResult ocDerivedDataCacheLoad(ocDerivedDataCache* pCache, ocUInt64 key, void** ppData, ocSizeT* pDataSize);
+
+// Stores an item, replacing any existing item with the same key.
+ocResult ocDerivedDataCacheStore(ocDerivedDataCache* pCache, ocUInt64 key, const void* pData, ocSizeT dataSize);
+
+// Stores an item on a worker thread.
+//
+// This takes ownership of pData which must have been allocated with ocMalloc(). It will be freed with ocFree() once it's been
+// written, including when this returns an error.
+ocResult ocDerivedDataCacheStoreAsync(ocDerivedDataCache* pCache, ocUInt64 key, void* pData, ocSizeT dataSize);
\ No newline at end of file
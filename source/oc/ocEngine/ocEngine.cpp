@@ -21,16 +21,23 @@
 #include "ocMath.cpp"
 #include "ocCamera.cpp"
 #include "ocThreading.cpp"
+#include "ocJobQueue.cpp"
+#include "ocCompression.cpp"
 #include "ocFileSystem.cpp"
 #include "ocStreamReader.cpp"
 #include "ocStreamWriter.cpp"
 #include "ocLogger.cpp"
+#include "Animation/ocAnimation.cpp"
+#include "Particles/ocParticles.cpp"
 #include "Graphics/ocGraphics.cpp"
 #include "Audio/ocAudio.cpp"
 #include "Input/ocInput.cpp"
 #include "Physics/ocPhysics.cpp"
 #include "Components/ocComponents.cpp"
 #include "ocOCD.cpp"
+#include "ocOBJ.cpp"
+#include "ocPackage.cpp"
+#include "ocDerivedDataCache.cpp"
 #include "ocResourceLoader.cpp"
 #include "ocResourceLibrary.cpp"
 #include "ocWorldObject.cpp"
@@ -91,9 +98,6 @@
 #define DR_FS_IMPLEMENTATION
 #include "../../external/dr_fs/dr_fs.h"
 
-#define MINIOBJ_IMPLEMENTATION
-#include "../../external/miniobj/miniobj.h"
-
 #ifdef OC_ENABLE_PCX
 #define DR_PCX_IMPLEMENTATION
 #include "../../external/dr_libs/dr_pcx.h"
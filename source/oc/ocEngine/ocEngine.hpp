@@ -17,6 +17,7 @@
 
 // Standard headers.
 #include <stdlib.h>
+#include <limits.h>
 #include <vector>
 #include <algorithm>
 
@@ -45,6 +46,39 @@
 #include <semaphore.h>
 #endif
 
+#ifdef OC_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#endif
+
+// io_uring is used for asynchronous reads when the headers are available. It's still checked for at run time since it can be disabled
+// or unsupported by the kernel.
+#if defined(OC_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define OC_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+#ifdef OC_LINUX
+#include <sys/inotify.h>
+#endif
+
+#ifdef OC_SUPPORT_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef OC_SUPPORT_AVX2
+#include <immintrin.h>
+#if !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+#endif
+
 // External libraries.
 #include "../../external/stb/stb_image.h"
 
@@ -58,7 +92,6 @@
 #include "../../external/dr_libs/dr_flac.h"
 #include "../../external/dr_libs/dr_wav.h"
 #include "../../external/dr_fs/dr_fs.h"
-#include "../../external/miniobj/miniobj.h"
 
 #ifdef OC_ENABLE_PCX
 #include "../../external/dr_libs/dr_pcx.h"
@@ -130,6 +163,7 @@ typedef ocUInt32         ocBool32;
 
 #define ocAssert(expression)        assert(expression)
 #define ocCopyMemory(dst, src, sz)  memcpy(dst, src, sz)
+#define ocMoveMemory(dst, src, sz)  memmove(dst, src, sz)
 #define ocZeroMemory(p, sz)         memset((p), 0, (sz))
 #define ocZeroObject(p)             ocZeroMemory((p), sizeof(*(p)))
 #define ocMalloc(sz)                malloc(sz)
@@ -177,16 +211,23 @@ struct ocWorldObject;
 #include "ocMath.hpp"
 #include "ocCamera.hpp"
 #include "ocThreading.hpp"
+#include "ocJobQueue.hpp"
+#include "ocCompression.hpp"
 #include "ocFileSystem.hpp"
 #include "ocStreamReader.hpp"
 #include "ocStreamWriter.hpp"
 #include "ocLogger.hpp"
+#include "Animation/ocAnimation.hpp"
+#include "Particles/ocParticles.hpp"
 #include "Graphics/ocGraphics.hpp"
 #include "Audio/ocAudio.hpp"
 #include "Input/ocInput.hpp"
 #include "Physics/ocPhysics.hpp"
 #include "Components/ocComponents.hpp"
 #include "ocOCD.hpp"
+#include "ocOBJ.hpp"
+#include "ocPackage.hpp"
+#include "ocDerivedDataCache.hpp"
 #include "ocResourceLoader.hpp"
 #include "ocResourceLibrary.hpp"
 #include "ocWorldObject.hpp"
@@ -31,6 +31,8 @@ ocResult ocEngineInit(int argc, char** argv, ocStepProc onStep, ocWindowEventPro
     }
 
 
+    ocDerivedDataCache* pDerivedDataCache = NULL;
+
     // File system. This is done early so we can open a log file ASAP.
     ocResult result = ocFileSystemInit(pEngine, &pEngine->fs);
     if (result != OC_SUCCESS) {
@@ -43,40 +45,93 @@ ocResult ocEngineInit(int argc, char** argv, ocStepProc onStep, ocWindowEventPro
         goto on_error1;
     }
 
+    // Job queue. We leave one core for the main thread.
+    pEngine->threadCount = ocGetLogicalProcessorCount() - 1;
+    if (pEngine->threadCount == 0) {
+        pEngine->threadCount = 1;
+    }
+
+    if (ocCmdLineGetValue(argc, argv, "--threads") != NULL) {
+        pEngine->threadCount = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--threads"));
+    }
+
+    result = ocJobQueueInit(pEngine->threadCount, &pEngine->jobQueue);
+    if (result != OC_SUCCESS) {
+        goto on_error2;
+    }
+
+    pEngine->threadCount = pEngine->jobQueue.threadCount;
+
+    // Derived data cache. This is not critical - if it fails to initialize assets will just be converted every time they're loaded.
+    {
+        char cacheFolderPath[OC_MAX_PATH];
+        ocGetCacheFolderPath(&pEngine->fs, cacheFolderPath, sizeof(cacheFolderPath));
+        ocPathAppend(cacheFolderPath, sizeof(cacheFolderPath), cacheFolderPath, "ocd");    // In-place append.
+
+        if (ocDerivedDataCacheInit(cacheFolderPath, &pEngine->jobQueue, &pEngine->derivedDataCache) == OC_SUCCESS) {
+            pDerivedDataCache = &pEngine->derivedDataCache;
+        } else {
+            ocWarningf(pEngine, "Failed to initialize derived data cache at %s. Assets will be converted every time they are loaded.", cacheFolderPath);
+        }
+    }
+
     // Graphics.
     result = ocGraphicsInit(pEngine, 4, &pEngine->graphics);
     if (result != OC_SUCCESS) {
-        goto on_error2;
+        goto on_error3;
     }
 
     // Audio.
     result = ocAudioInit(pEngine, &pEngine->audio);
     if (result != OC_SUCCESS) {
-        goto on_error3;
+        goto on_error4;
     }
 
     // Input.
     result = ocInputInit(&pEngine->input);
     if (result != OC_SUCCESS) {
-        goto on_error4;
+        goto on_error5;
     }
 
     // Component allocator.
     result = ocComponentAllocatorInit(pEngine, &pEngine->componentAllocator);
     if (result != OC_SUCCESS) {
-        goto on_error5;
+        goto on_error6;
     }
 
     // Resource loader.
-    result = ocResourceLoaderInit(&pEngine->fs, &pEngine->resourceLoader);
+    result = ocResourceLoaderInit(&pEngine->fs, &pEngine->jobQueue, &pEngine->resourceLoader);
     if (result != OC_SUCCESS) {
-        goto on_error6;
+        goto on_error7;
     }
 
     // Resource library.
-    result = ocResourceLibraryInit(&pEngine->resourceLoader, &pEngine->graphics, &pEngine->resourceLibrary);
+    result = ocResourceLibraryInit(&pEngine->resourceLoader, &pEngine->graphics, pDerivedDataCache, &pEngine->resourceLibrary);
     if (result != OC_SUCCESS) {
-        goto on_error7;
+        goto on_error8;
+    }
+
+    if (ocCmdLineGetValue(argc, argv, "--image-budget") != NULL) {
+        ocResourceLibrarySetBudget(&pEngine->resourceLibrary, ocResourceType_Image, (ocUInt64)atoi(ocCmdLineGetValue(argc, argv, "--image-budget")) * 1024 * 1024);
+    }
+    if (ocCmdLineGetValue(argc, argv, "--scene-budget") != NULL) {
+        ocResourceLibrarySetBudget(&pEngine->resourceLibrary, ocResourceType_Scene, (ocUInt64)atoi(ocCmdLineGetValue(argc, argv, "--scene-budget")) * 1024 * 1024);
+    }
+    if (ocCmdLineGetValue(argc, argv, "--sound-budget") != NULL) {
+        ocResourceLibrarySetBudget(&pEngine->resourceLibrary, ocResourceType_Sound, (ocUInt64)atoi(ocCmdLineGetValue(argc, argv, "--sound-budget")) * 1024 * 1024);
+    }
+    if (ocCmdLineGetValue(argc, argv, "--skeleton-budget") != NULL) {
+        ocResourceLibrarySetBudget(&pEngine->resourceLibrary, ocResourceType_Skeleton, (ocUInt64)atoi(ocCmdLineGetValue(argc, argv, "--skeleton-budget")) * 1024 * 1024);
+    }
+    if (ocCmdLineGetValue(argc, argv, "--animation-budget") != NULL) {
+        ocResourceLibrarySetBudget(&pEngine->resourceLibrary, ocResourceType_Animation, (ocUInt64)atoi(ocCmdLineGetValue(argc, argv, "--animation-budget")) * 1024 * 1024);
+    }
+
+    if (ocCmdLineIsSet(argc, argv, "--hot-reload")) {
+        result = ocResourceLibraryEnableHotReload(&pEngine->resourceLibrary);
+        if (result != OC_SUCCESS) {
+            ocWarningf(pEngine, "Failed to enable hot reloading. Resources will not be reloaded when their files change.");
+        }
     }
 
 
@@ -84,18 +139,20 @@ ocResult ocEngineInit(int argc, char** argv, ocStepProc onStep, ocWindowEventPro
     // initialized due to the coupling of X11 and OpenGL.
     result = ocPlatformLayerInit(props);
     if (result != OC_SUCCESS) {
-        goto on_error8;
+        goto on_error9;
     }
 
 
     return OC_SUCCESS;
 
-on_error8: ocResourceLibraryUninit(&pEngine->resourceLibrary);
-on_error7: ocResourceLoaderUninit(&pEngine->resourceLoader);
-on_error6: ocComponentAllocatorUninit(&pEngine->componentAllocator);
-on_error5: ocInputUninit(&pEngine->input);
-on_error4: ocAudioUninit(&pEngine->audio);
-on_error3: ocGraphicsUninit(&pEngine->graphics);
+on_error9: ocResourceLibraryUninit(&pEngine->resourceLibrary);
+on_error8: ocResourceLoaderUninit(&pEngine->resourceLoader);
+on_error7: ocComponentAllocatorUninit(&pEngine->componentAllocator);
+on_error6: ocInputUninit(&pEngine->input);
+on_error5: ocAudioUninit(&pEngine->audio);
+on_error4: ocGraphicsUninit(&pEngine->graphics);
+on_error3: ocDerivedDataCacheUninit(&pEngine->derivedDataCache);
+           ocJobQueueUninit(&pEngine->jobQueue);
 on_error2: ocLoggerUninit(&pEngine->logger);
 on_error1: ocFileSystemUninit(&pEngine->fs);
     return result;
@@ -108,12 +165,14 @@ void ocEngineUninit(ocEngineContext* pEngine)
     }
 
     ocPlatformLayerUninit();
+    ocAudioUninit(&pEngine->audio);     // <-- Before the resource library since voices may still be reading sound data.
     ocResourceLibraryUninit(&pEngine->resourceLibrary);
     ocResourceLoaderUninit(&pEngine->resourceLoader);
     ocComponentAllocatorUninit(&pEngine->componentAllocator);
     ocInputUninit(&pEngine->input);
-    ocAudioUninit(&pEngine->audio);
     ocGraphicsUninit(&pEngine->graphics);
+    ocDerivedDataCacheUninit(&pEngine->derivedDataCache);
+    ocJobQueueUninit(&pEngine->jobQueue);
     ocLoggerUninit(&pEngine->logger);
     ocFileSystemUninit(&pEngine->fs);
 }
@@ -125,8 +184,14 @@ void ocStep(ocEngineContext* pEngine)
         return;
     }
 
+    // Recycles the voices that have finished since the last step, before the game and it's worlds play anything new.
+    ocAudioUpdate(&pEngine->audio);
+
     pEngine->onStep(pEngine);
 
+    // This is a frame boundary so it's safe to swap in resources that have been reloaded.
+    ocResourceLibraryUpdate(&pEngine->resourceLibrary);
+
     // Prepare the input state for the next frame.
     ocMakeCurrentInputStatePrevious(pEngine);
 }
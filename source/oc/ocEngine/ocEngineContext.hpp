@@ -15,13 +15,15 @@ struct ocEngineContext
 
     ocFileSystem fs;
     ocLogger logger;
+    ocJobQueue jobQueue;
+    ocDerivedDataCache derivedDataCache;
     ocGraphicsContext graphics;
     ocAudioContext audio;
     ocInputState input;
     ocComponentAllocator componentAllocator;
     ocResourceLoader resourceLoader;
     ocResourceLibrary resourceLibrary;
-    ocUInt32 threadCount;
+    ocUInt32 threadCount;           // <-- The number of worker threads in the job queue.
     ocUInt32 flags;
 };
 
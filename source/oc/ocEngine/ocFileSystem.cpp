@@ -37,6 +37,10 @@ OC_PRIVATE drfs_seek_origin ocToDRFSSeekOrigin(ocSeekOrigin origin)
     }
 }
 
+// Implemented in the Asynchronous Reads section at the bottom of this file.
+OC_PRIVATE ocResult ocFileSystemIOInit(ocFileSystem* pFS);
+OC_PRIVATE void ocFileSystemIOUninit(ocFileSystem* pFS);
+
 
 ocResult ocFileSystemInit(ocEngineContext* pEngine, ocFileSystem* pFS)
 {
@@ -56,6 +60,12 @@ ocResult ocFileSystemInit(ocEngineContext* pEngine, ocFileSystem* pFS)
         return OC_ERROR;
     }
 
+    ocResult result = ocFileSystemIOInit(pFS);
+    if (result != OC_SUCCESS) {
+        drfs_uninit(&pFS->internalFS);
+        return result;
+    }
+
     // The base directories should always be relative to the executable.
     char exePath[OC_MAX_PATH];
     if (ocGetExecutableDirectoryPath(exePath, sizeof(exePath)) == OC_SUCCESS) {
@@ -65,6 +75,11 @@ ocResult ocFileSystemInit(ocEngineContext* pEngine, ocFileSystem* pFS)
 
         // The executable's directory should be the lowest priority base directory.
         drfs_add_base_directory(&pFS->internalFS, exePath);
+
+        // The main data package is optional. When it's not there everything is loaded from loose files.
+        char packagePath[OC_MAX_PATH];
+        ocPathAppend(packagePath, sizeof(packagePath), exePath, "data." OC_PACKAGE_EXTENSION);
+        ocFileSystemMountPackage(pFS, packagePath);
     }
 
     return OC_SUCCESS;
@@ -76,16 +91,152 @@ void ocFileSystemUninit(ocFileSystem* pFS)
         return;
     }
 
+    // The I/O threads can be reading from packages so they need to be shut down first.
+    ocFileSystemIOUninit(pFS);
+
+    for (ocSizeT iPackage = 0; iPackage < pFS->packages.count; ++iPackage) {
+        ocPackageClose(pFS->packages.pItems[iPackage]);
+        ocFree(pFS->packages.pItems[iPackage]);
+    }
+    ocStackUninit(&pFS->packages);
+
     drfs_uninit(&pFS->internalFS);
 }
 
 
+OC_PRIVATE ocResult ocFileSystemResolvePackagePath(ocFileSystem* pFS, const char* packagePath, char* absolutePath, size_t absolutePathSize)
+{
+    if (ocPathIsAbsolute(packagePath)) {
+        if (strcpy_s(absolutePath, absolutePathSize, packagePath) != 0) {
+            return OC_PATH_TOO_LONG;
+        }
+
+        return OC_SUCCESS;
+    }
+
+    return ocFindAbsoluteFilePath(pFS, packagePath, absolutePath, absolutePathSize);
+}
+
+ocResult ocFileSystemMountPackage(ocFileSystem* pFS, const char* packagePath)
+{
+    if (pFS == NULL || packagePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    char absolutePath[OC_MAX_PATH];
+    ocResult result = ocFileSystemResolvePackagePath(pFS, packagePath, absolutePath, sizeof(absolutePath));
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocPackage* pPackage = ocMallocObject(ocPackage);
+    if (pPackage == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    result = ocPackageOpen(absolutePath, pPackage);
+    if (result != OC_SUCCESS) {
+        ocFree(pPackage);
+        return result;
+    }
+
+    result = ocStackPush(&pFS->packages, pPackage);
+    if (result != OC_SUCCESS) {
+        ocPackageClose(pPackage);
+        ocFree(pPackage);
+        return result;
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocFileSystemUnmountPackage(ocFileSystem* pFS, const char* packagePath)
+{
+    if (pFS == NULL || packagePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    char absolutePath[OC_MAX_PATH];
+    ocResult result = ocFileSystemResolvePackagePath(pFS, packagePath, absolutePath, sizeof(absolutePath));
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (ocSizeT iPackage = 0; iPackage < pFS->packages.count; ++iPackage) {
+        ocPackage* pPackage = pFS->packages.pItems[iPackage];
+        if (ocPathEqual(pPackage->absolutePath, absolutePath)) {
+            ocPackageClose(pPackage);
+            ocFree(pPackage);
+
+            // Keep the order of the remaining packages since it determines priority.
+            for (ocSizeT iNext = iPackage + 1; iNext < pFS->packages.count; ++iNext) {
+                pFS->packages.pItems[iNext - 1] = pFS->packages.pItems[iNext];
+            }
+            pFS->packages.count -= 1;
+
+            return OC_SUCCESS;
+        }
+    }
+
+    return OC_DOES_NOT_EXIST;
+}
+
+// Searches the mounted packages for the given file, starting with the most recently mounted package.
+OC_PRIVATE const ocPackageEntry* ocFileSystemFindPackageEntry(ocFileSystem* pFS, const char* path, ocPackage** ppPackage)
+{
+    ocAssert(pFS != NULL);
+    ocAssert(path != NULL);
+    ocAssert(ppPackage != NULL);
+
+    ocBool32 isAbsolute = ocPathIsAbsolute(path);
+
+    for (ocSizeT iPackage = pFS->packages.count; iPackage > 0; --iPackage) {
+        ocPackage* pPackage = pFS->packages.pItems[iPackage - 1];
+
+        const char* pathInPackage = path;
+        if (isAbsolute) {
+            if (!ocPathIsDescendant(path, pPackage->absolutePath)) {
+                continue;
+            }
+
+            pathInPackage = path + strlen(pPackage->absolutePath);
+        }
+
+        const ocPackageEntry* pEntry = ocPackageFindEntry(pPackage, pathInPackage);
+        if (pEntry != NULL) {
+            *ppPackage = pPackage;
+            return pEntry;
+        }
+    }
+
+    return NULL;
+}
+
+
 ocResult ocGetFileInfo(ocFileSystem* pFS, const char* relativePath, ocFileInfo* pInfo)
 {
     if (pInfo != NULL) {
         ocZeroObject(pInfo);
     }
 
+    if (pFS == NULL || relativePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    // Packages first. This is the common case for shipping builds and does not touch the operating system at all.
+    ocPackage* pPackage;
+    const ocPackageEntry* pEntry = ocFileSystemFindPackageEntry(pFS, relativePath, &pPackage);
+    if (pEntry != NULL) {
+        if (pInfo != NULL) {
+            ocPathAppend(pInfo->absolutePath, sizeof(pInfo->absolutePath), pPackage->absolutePath, ocPackageGetEntryPath(pPackage, pEntry));
+            pInfo->sizeInBytes      = pEntry->uncompressedSize;
+            pInfo->lastModifiedTime = pEntry->lastModifiedTime;
+            pInfo->attributes       = OC_FILE_ATTRIBUTE_READONLY;
+        }
+
+        return OC_SUCCESS;
+    }
+
     return ocToResult(drfs_get_file_info(&pFS->internalFS, relativePath, pInfo));
 }
 
@@ -120,6 +271,42 @@ ocResult ocFileOpen(ocFileSystem* pFS, const char* path, unsigned int accessMode
         return OC_INVALID_ARGS;
     }
 
+    // Packages are read-only so they're only checked when opening in read mode.
+    if ((accessMode & OC_WRITE) == 0) {
+        ocPackage* pPackage;
+        const ocPackageEntry* pEntry = ocFileSystemFindPackageEntry(pFS, path, &pPackage);
+        if (pEntry != NULL) {
+            if (ocIsBitSet(pEntry->flags, OC_PACKAGE_ENTRY_FLAG_COMPRESSED)) {
+                if (pEntry->uncompressedSize > SIZE_MAX) {
+                    return OC_TOO_LARGE;
+                }
+
+                pFile->pDecompressedData = ocMalloc((ocSizeT)ocMax(pEntry->uncompressedSize, 1));
+                if (pFile->pDecompressedData == NULL) {
+                    return OC_OUT_OF_MEMORY;
+                }
+
+                ocResult packageResult = ocPackageReadEntry(pPackage, pEntry, pFile->pDecompressedData, (ocSizeT)pEntry->uncompressedSize);
+                if (packageResult != OC_SUCCESS) {
+                    ocFree(pFile->pDecompressedData);
+                    pFile->pDecompressedData = NULL;
+                    return packageResult;
+                }
+
+                pFile->pPackageData = (const ocUInt8*)pFile->pDecompressedData;
+            } else {
+                // The data is read straight from the mapping. Let the OS know we're about to need it so it can start reading ahead.
+                ocPackagePrefetchEntry(pPackage, pEntry);
+                pFile->pPackageData = (const ocUInt8*)ocPackageGetEntryData(pPackage, pEntry);
+            }
+
+            pFile->pPackage        = pPackage;
+            pFile->packageDataSize = pEntry->uncompressedSize;
+            pFile->packageDataPos  = 0;
+            return OC_SUCCESS;
+        }
+    }
+
     drfs_result result = drfs_open(&pFS->internalFS, path, accessMode, &pFile->pInternalFile);
     if (result != drfs_success) {
         return ocToResult(result);
@@ -134,6 +321,12 @@ void ocFileClose(ocFile* pFile)
         return;
     }
 
+    if (pFile->pPackage != NULL) {
+        ocFree(pFile->pDecompressedData);
+        ocZeroObject(pFile);
+        return;
+    }
+
     drfs_close(pFile->pInternalFile);
 }
 
@@ -143,6 +336,30 @@ ocResult ocFileRead(ocFile* pFile, void* pDataOut, size_t bytesToRead, size_t* p
         return OC_INVALID_ARGS;
     }
 
+    if (pFile->pPackage != NULL) {
+        if (pBytesReadOut) {
+            *pBytesReadOut = 0;
+        }
+
+        ocUInt64 bytesRemaining = pFile->packageDataSize - pFile->packageDataPos;
+        if (bytesRemaining == 0 && bytesToRead > 0) {
+            return OC_AT_END_OF_FILE;
+        }
+
+        if (bytesToRead > bytesRemaining) {
+            bytesToRead = (size_t)bytesRemaining;
+        }
+
+        ocCopyMemory(pDataOut, pFile->pPackageData + pFile->packageDataPos, bytesToRead);
+        pFile->packageDataPos += bytesToRead;
+
+        if (pBytesReadOut) {
+            *pBytesReadOut = bytesToRead;
+        }
+
+        return OC_SUCCESS;
+    }
+
     return ocToResult(drfs_read(pFile->pInternalFile, pDataOut, bytesToRead, pBytesReadOut));
 }
 
@@ -152,6 +369,10 @@ ocResult ocFileWrite(ocFile* pFile, const void* pData, size_t bytesToWrite, size
         return OC_INVALID_ARGS;
     }
 
+    if (pFile->pPackage != NULL) {
+        return OC_PERMISSION_DENIED;    // Packages are read-only.
+    }
+
     return ocToResult(drfs_write(pFile->pInternalFile, pData, bytesToWrite, pBytesWrittenOut));
 }
 
@@ -161,6 +382,26 @@ ocResult ocFileSeek(ocFile* pFile, int64_t bytesToSeek, ocSeekOrigin origin)
         return OC_INVALID_ARGS;
     }
 
+    if (pFile->pPackage != NULL) {
+        int64_t base = 0;
+        if (origin == ocSeekOrigin_Current) {
+            base = (int64_t)pFile->packageDataPos;
+        } else if (origin == ocSeekOrigin_End) {
+            base = (int64_t)pFile->packageDataSize;
+        }
+
+        int64_t newPos = base + bytesToSeek;
+        if (newPos < 0) {
+            return OC_NEGATIVE_SEEK;
+        }
+        if ((uint64_t)newPos > pFile->packageDataSize) {
+            return OC_INVALID_ARGS;
+        }
+
+        pFile->packageDataPos = (ocUInt64)newPos;
+        return OC_SUCCESS;
+    }
+
     return ocToResult(drfs_seek(pFile->pInternalFile, bytesToSeek, ocToDRFSSeekOrigin(origin)));
 }
 
@@ -170,6 +411,11 @@ ocResult ocFileTell(ocFile* pFile, uint64_t* pPos)
         return OC_INVALID_ARGS;
     }
 
+    if (pFile->pPackage != NULL) {
+        *pPos = pFile->packageDataPos;
+        return OC_SUCCESS;
+    }
+
     // Currently no error detection with dr_fs.
     *pPos = drfs_tell(pFile->pInternalFile);
     return OC_SUCCESS;
@@ -181,6 +427,11 @@ ocResult ocFileSize(ocFile* pFile, uint64_t* pSize)
         return OC_INVALID_ARGS;
     }
 
+    if (pFile->pPackage != NULL) {
+        *pSize = pFile->packageDataSize;
+        return OC_SUCCESS;
+    }
+
     // Currently no error detection with dr_fs.
     *pSize = drfs_size(pFile->pInternalFile);
     return OC_SUCCESS;
@@ -188,7 +439,7 @@ ocResult ocFileSize(ocFile* pFile, uint64_t* pSize)
 
 void ocFileFlush(ocFile* pFile)
 {
-    if (pFile == NULL) {
+    if (pFile == NULL || pFile->pPackage != NULL) {
         return;
     }
 
@@ -201,9 +452,28 @@ ocBool32 ocAtEOF(ocFile* pFile)
         return false;
     }
 
+    if (pFile->pPackage != NULL) {
+        return pFile->packageDataPos == pFile->packageDataSize;
+    }
+
     return drfs_eof(pFile->pInternalFile);
 }
 
+ocResult ocFileGetData(ocFile* pFile, const void** ppData, ocUInt64* pSize)
+{
+    if (pFile == NULL || ppData == NULL || pSize == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (pFile->pPackage == NULL) {
+        return OC_INVALID_OPERATION;
+    }
+
+    *ppData = pFile->pPackageData;
+    *pSize  = pFile->packageDataSize;
+    return OC_SUCCESS;
+}
+
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -218,6 +488,10 @@ ocResult ocFileWriteString(ocFile* pFile, const char* str)
         return OC_INVALID_ARGS;
     }
 
+    if (pFile->pPackage != NULL) {
+        return OC_PERMISSION_DENIED;
+    }
+
     return ocToResult(drfs_write_string(pFile->pInternalFile, str)); 
 }
 
@@ -227,6 +501,10 @@ ocResult ocFileWriteLine(ocFile* pFile, const char* str)
         return OC_INVALID_ARGS;
     }
 
+    if (pFile->pPackage != NULL) {
+        return OC_PERMISSION_DENIED;
+    }
+
     return ocToResult(drfs_write_line(pFile->pInternalFile, str)); 
 }
 
@@ -364,6 +642,57 @@ void ocGetLogFolderPath(ocFileSystem* pFS, char* pathOut, size_t pathOutSize)
 }
 
 
+void ocGetCacheFolderPath(ocFileSystem* pFS, char* pathOut, size_t pathOutSize)
+{
+    if (pathOut == NULL || pathOutSize == 0) {
+        return;
+    }
+
+    char cacheFolderPath[OC_MAX_PATH];
+    cacheFolderPath[0] = '\0';
+    ocBool32 useLocalPath = ocIsPortable(pFS->pEngine);
+
+#if defined(OC_WIN32)
+    if (SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, cacheFolderPath) == S_OK) {
+        ocPathToForwardSlashes(cacheFolderPath);
+        ocPathAppend(cacheFolderPath, sizeof(cacheFolderPath), cacheFolderPath, OC_CONFIG_NAME);    // In-place append.
+        ocPathAppend(cacheFolderPath, sizeof(cacheFolderPath), cacheFolderPath, "cache");           // In-place append.
+    } else {
+        useLocalPath = OC_TRUE;
+    }
+#else
+    // Caches go into XDG_CACHE_HOME rather than XDG_CONFIG_HOME so they're not picked up by things like config backups.
+    const char* cachedir = getenv("XDG_CACHE_HOME");
+    if (cachedir != NULL && cachedir[0] != '\0') {
+        if (oc_strcpy_s(cacheFolderPath, sizeof(cacheFolderPath), cachedir) != 0) {
+            useLocalPath = OC_TRUE;
+        }
+    } else {
+        const char* homedir = getenv("HOME");
+        if (homedir == NULL) {
+            homedir = getpwuid(getuid())->pw_dir;
+        }
+
+        if (homedir != NULL && oc_strcpy_s(cacheFolderPath, sizeof(cacheFolderPath), homedir) == 0) {
+            ocPathAppend(cacheFolderPath, sizeof(cacheFolderPath), cacheFolderPath, ".cache");      // In-place append.
+        } else {
+            useLocalPath = OC_TRUE;
+        }
+    }
+
+    ocPathAppend(cacheFolderPath, sizeof(cacheFolderPath), cacheFolderPath, OC_CONFIG_NAME);        // In-place append.
+#endif
+
+    if (!useLocalPath && ocPathIsAbsolute(cacheFolderPath)) {
+        oc_strcpy_s(pathOut, pathOutSize, cacheFolderPath);
+    } else {
+        // Portable builds keep everything next to the executable.
+        ocGetExecutableDirectoryPath(pathOut, pathOutSize);
+        ocPathAppend(pathOut, pathOutSize, pathOut, "var/cache");       // In-place append.
+    }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // General File System APIs
@@ -807,3 +1136,1051 @@ ocResult ocCopyFile(const char* srcPath, const char* dstPath, ocBool32 failIfExi
     return result;
 #endif
 }
+
+
+ocResult ocMoveFile(const char* srcPath, const char* dstPath)
+{
+    if (srcPath == NULL || dstPath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+#if _WIN32
+    if (MoveFileExA(srcPath, dstPath, MOVEFILE_REPLACE_EXISTING) == 0) {
+        return OC_ERROR;    /* TODO: Return proper error code. */
+    }
+
+    return OC_SUCCESS;
+#else
+    if (rename(srcPath, dstPath) != 0) {
+        return ocResultFromERRNO(errno);
+    }
+
+    return OC_SUCCESS;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Asynchronous Reads
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct ocFileReadOp
+{
+    ocFileReadBatch* pBatch;
+    ocFileReadRequest* pRequest;
+
+#ifdef OC_HAS_IO_URING
+    int fd;                 // <-- -1 until the read is moved into the submission queue.
+    struct iovec iov;       // <-- The part of the destination buffer that hasn't been filled yet.
+    ocUInt64 offset;        // <-- The file offset of iov.
+    ocFileReadOp* pNext;    // <-- For the pending list.
+#endif
+};
+
+OC_PRIVATE void ocFileReadOpComplete(ocFileReadOp* pOp, ocResult result)
+{
+    ocAssert(pOp != NULL);
+
+    pOp->pRequest->result = result;
+
+    // The batch can be released by another thread as soon as the counter reaches zero so it must not be touched after the release.
+    ocFileReadBatch* pBatch = pOp->pBatch;
+    if (ocAtomicDecrement(&pBatch->pendingCount) == 0) {
+        ocSemaphoreRelease(&pBatch->completionSemaphore);
+    }
+}
+
+// Runs a read on one of the I/O threads using the normal synchronous API.
+OC_PRIVATE void ocFileReadJob(void* pUserData)
+{
+    ocFileReadOp* pOp = (ocFileReadOp*)pUserData;
+    ocAssert(pOp != NULL);
+
+    ocFileReadRequest* pRequest = pOp->pRequest;
+
+    ocFile file;
+    ocResult result = ocFileOpen(pOp->pBatch->pFS, pRequest->path, OC_READ, &file);
+    if (result != OC_SUCCESS) {
+        ocFileReadOpComplete(pOp, result);
+        return;
+    }
+
+    // Seeking past the end is an error for package files, but it's not an error for an asynchronous read so it needs to be checked.
+    //
+    // A read that's been handed back from the io_uring may have already filled part of the buffer so it picks up where it left off.
+    ocUInt64 fileSize;
+    result = ocFileSize(&file, &fileSize);
+    if (result == OC_SUCCESS && pRequest->offset + pRequest->bytesRead < fileSize) {
+        result = ocFileSeek(&file, (ocInt64)(pRequest->offset + pRequest->bytesRead), ocSeekOrigin_Start);
+        while (result == OC_SUCCESS && pRequest->bytesRead < pRequest->size) {
+            size_t bytesRead = 0;
+            result = ocFileRead(&file, (ocUInt8*)pRequest->pDst + pRequest->bytesRead, pRequest->size - pRequest->bytesRead, &bytesRead);
+            if (result == OC_AT_END_OF_FILE || (result == OC_SUCCESS && bytesRead == 0)) {
+                result = OC_SUCCESS;
+                break;
+            }
+
+            pRequest->bytesRead += bytesRead;
+        }
+    }
+
+    ocFileClose(&file);
+    ocFileReadOpComplete(pOp, result);
+}
+
+
+#ifdef OC_HAS_IO_URING
+OC_PRIVATE int ocIOUringEnter(int fd, ocUInt32 toSubmit, ocUInt32 minComplete, ocUInt32 flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+// Opens the file for a read that's about to be moved into the submission queue.
+OC_PRIVATE ocResult ocFileSystemIOOpen_IOUring(ocFileReadOp* pOp)
+{
+    ocAssert(pOp != NULL);
+
+    char absolutePath[OC_MAX_PATH];
+    ocResult result = ocFindAbsoluteFilePath(pOp->pBatch->pFS, pOp->pRequest->path, absolutePath, sizeof(absolutePath));
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    pOp->fd = open(absolutePath, O_RDONLY | O_CLOEXEC);
+    if (pOp->fd < 0) {
+        return ocResultFromERRNO(errno);
+    }
+
+    pOp->iov.iov_base = pOp->pRequest->pDst;
+    pOp->iov.iov_len  = pOp->pRequest->size;
+    pOp->offset       = pOp->pRequest->offset;
+
+    return OC_SUCCESS;
+}
+
+// Takes every read that the kernel hasn't consumed back out of the submission queue and hands it to the I/O threads. This is used when
+// a submission fails, since nothing else would ever submit them and they'd never complete. Must be called while the lock is held.
+OC_PRIVATE void ocFileSystemIOReclaim_IOUring(ocFileSystemIO* pIO)
+{
+    ocAssert(pIO != NULL);
+
+    // Without SQPOLL the kernel only consumes entries from inside io_uring_enter() which is always called with the lock held, so the
+    // head can't move while the tail is rewound.
+    ocUInt32 head = __atomic_load_n(pIO->uring.pSQHead, __ATOMIC_ACQUIRE);
+    ocUInt32 tail = *pIO->uring.pSQTail;
+    __atomic_store_n(pIO->uring.pSQTail, head, __ATOMIC_RELEASE);
+
+    for (ocUInt32 iEntry = head; iEntry != tail; ++iEntry) {
+        ocFileReadOp* pOp = (ocFileReadOp*)(size_t)pIO->uring.pSQEs[pIO->uring.pSQArray[iEntry & pIO->uring.sqMask]].user_data;
+        ocAssert(pOp != NULL);
+
+        pIO->uring.inFlightCount -= 1;
+
+        // The worker reopens the file itself and continues from however much has already been read.
+        close(pOp->fd);
+        pOp->fd = -1;
+
+        ocResult result = ocJobQueueSubmit(&pIO->workers, ocFileReadJob, pOp, NULL);
+        if (result != OC_SUCCESS) {
+            ocFileReadOpComplete(pOp, result);
+        }
+    }
+}
+
+// Copies as many pending reads into the submission queue as there are free slots and submits them. Must be called while the lock is held.
+OC_PRIVATE void ocFileSystemIOPump_IOUring(ocFileSystemIO* pIO)
+{
+    ocAssert(pIO != NULL);
+
+    ocUInt32 tail = *pIO->uring.pSQTail;    // <-- Only written by us so no need for an atomic load.
+
+    // Keeping the in-flight count within the size of the submission queue guarantees the queue never overflows, and since the
+    // completion queue is at least as big, completions are never dropped either.
+    while (pIO->uring.pPendingHead != NULL && pIO->uring.inFlightCount < pIO->uring.sqEntryCount) {
+        ocFileReadOp* pOp = pIO->uring.pPendingHead;
+        pIO->uring.pPendingHead = pOp->pNext;
+        if (pIO->uring.pPendingHead == NULL) {
+            pIO->uring.pPendingTail = NULL;
+        }
+
+        // Files are opened as late as possible so that a large batch doesn't run out of file descriptors.
+        if (pOp->fd == -1) {
+            ocResult result = ocFileSystemIOOpen_IOUring(pOp);
+            if (result != OC_SUCCESS) {
+                ocFileReadOpComplete(pOp, result);
+                continue;
+            }
+        }
+
+        ocUInt32 index = tail & pIO->uring.sqMask;
+        struct io_uring_sqe* pSQE = &pIO->uring.pSQEs[index];
+        ocZeroObject(pSQE);
+        pSQE->opcode    = IORING_OP_READV;
+        pSQE->fd        = pOp->fd;
+        pSQE->addr      = (ocUInt64)(size_t)&pOp->iov;
+        pSQE->len       = 1;
+        pSQE->off       = pOp->offset;
+        pSQE->user_data = (ocUInt64)(size_t)pOp;
+        pIO->uring.pSQArray[index] = index;
+
+        tail += 1;
+        pIO->uring.inFlightCount += 1;
+    }
+
+    __atomic_store_n(pIO->uring.pSQTail, tail, __ATOMIC_RELEASE);
+
+    // Anything the kernel didn't pick up last time is still in the ring so it's included here.
+    ocUInt32 toSubmit = tail - __atomic_load_n(pIO->uring.pSQHead, __ATOMIC_ACQUIRE);
+    while (toSubmit > 0) {
+        int submittedCount = ocIOUringEnter(pIO->uring.fd, toSubmit, 0, 0);
+        if (submittedCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            ocFileSystemIOReclaim_IOUring(pIO);
+            break;
+        }
+
+        toSubmit -= (ocUInt32)submittedCount;
+        if (submittedCount == 0) {
+            break;
+        }
+    }
+}
+
+// Appends a list of reads to the pending list and submits as many as possible. Must be called while the lock is held.
+OC_PRIVATE void ocFileSystemIOEnqueue_IOUring(ocFileSystemIO* pIO, ocFileReadOp* pHead, ocFileReadOp* pTail)
+{
+    ocAssert(pIO != NULL);
+
+    if (pHead != NULL) {
+        if (pIO->uring.pPendingTail != NULL) {
+            pIO->uring.pPendingTail->pNext = pHead;
+        } else {
+            pIO->uring.pPendingHead = pHead;
+        }
+        pIO->uring.pPendingTail = pTail;
+    }
+
+    ocFileSystemIOPump_IOUring(pIO);
+}
+
+// Handles a completion from the kernel. Returns true if the op needs to be resubmitted to read the rest of the data.
+OC_PRIVATE ocBool32 ocFileSystemIOHandleCompletion_IOUring(ocFileReadOp* pOp, int res)
+{
+    ocAssert(pOp != NULL);
+
+    if (res < 0) {
+        if (res == -EINTR || res == -EAGAIN) {
+            return OC_TRUE;
+        }
+
+        close(pOp->fd);
+        ocFileReadOpComplete(pOp, ocResultFromERRNO(-res));
+        return OC_FALSE;
+    }
+
+    pOp->pRequest->bytesRead += (ocSizeT)res;
+    pOp->iov.iov_base = (ocUInt8*)pOp->iov.iov_base + res;
+    pOp->iov.iov_len -= (size_t)res;
+    pOp->offset += (ocUInt64)res;
+
+    // A short read is not necessarily the end of the file. The only way to know for sure is to read again and get 0 bytes back.
+    if (res > 0 && pOp->iov.iov_len > 0) {
+        return OC_TRUE;
+    }
+
+    close(pOp->fd);
+    ocFileReadOpComplete(pOp, OC_SUCCESS);
+    return OC_FALSE;
+}
+
+// Fails every read that hasn't been moved into the submission queue yet. Must be called while the lock is held.
+OC_PRIVATE void ocFileSystemIOFailPending_IOUring(ocFileSystemIO* pIO, ocResult result)
+{
+    ocAssert(pIO != NULL);
+
+    ocFileReadOp* pOp = pIO->uring.pPendingHead;
+    pIO->uring.pPendingHead = NULL;
+    pIO->uring.pPendingTail = NULL;
+
+    while (pOp != NULL) {
+        ocFileReadOp* pNext = pOp->pNext;   // <-- The op can't be touched after it's been completed.
+        if (pOp->fd != -1) {
+            close(pOp->fd);
+        }
+
+        ocFileReadOpComplete(pOp, result);
+        pOp = pNext;
+    }
+}
+
+OC_PRIVATE ocThreadResult OC_THREADCALL ocFileSystemIOCompletionThread_IOUring(void* pData)
+{
+    ocFileSystemIO* pIO = (ocFileSystemIO*)pData;
+    ocAssert(pIO != NULL);
+
+    for (;;) {
+        // A failed wait doesn't affect reads that are already in the kernel. They still complete and are picked up from the completion
+        // queue below, so the thread keeps going. Reads that are waiting to be submitted are failed since the ring can't be relied on to
+        // ever make room for them, and the thread backs off for a moment so a persistent error doesn't turn into a busy loop.
+        if (ocIOUringEnter(pIO->uring.fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            ocResult waitResult = ocResultFromERRNO(errno);
+
+            ocMutexLock(&pIO->uring.lock);
+            {
+                ocFileSystemIOFailPending_IOUring(pIO, waitResult);
+            }
+            ocMutexUnlock(&pIO->uring.lock);
+
+            usleep(1000);
+        }
+
+        ocBool32 isTerminating = OC_FALSE;
+        ocUInt32 completedCount = 0;
+        ocFileReadOp* pResubmitHead = NULL;
+        ocFileReadOp* pResubmitTail = NULL;
+
+        ocUInt32 head = *pIO->uring.pCQHead;    // <-- Only written by us.
+        ocUInt32 tail = __atomic_load_n(pIO->uring.pCQTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            struct io_uring_cqe* pCQE = &pIO->uring.pCQEs[head & pIO->uring.cqMask];
+            ocFileReadOp* pOp = (ocFileReadOp*)(size_t)pCQE->user_data;
+            int res = pCQE->res;
+            head += 1;
+
+            // The only op without any user data is the no-op that's submitted to wake us up when shutting down.
+            if (pOp == NULL) {
+                isTerminating = OC_TRUE;
+                continue;
+            }
+
+            completedCount += 1;
+            if (ocFileSystemIOHandleCompletion_IOUring(pOp, res)) {
+                pOp->pNext = NULL;
+                if (pResubmitTail != NULL) {
+                    pResubmitTail->pNext = pOp;
+                } else {
+                    pResubmitHead = pOp;
+                }
+                pResubmitTail = pOp;
+            }
+        }
+        __atomic_store_n(pIO->uring.pCQHead, head, __ATOMIC_RELEASE);
+
+        if (completedCount > 0) {
+            ocMutexLock(&pIO->uring.lock);
+            {
+                pIO->uring.inFlightCount -= completedCount;
+                ocFileSystemIOEnqueue_IOUring(pIO, pResubmitHead, pResubmitTail);
+            }
+            ocMutexUnlock(&pIO->uring.lock);
+        }
+
+        if (isTerminating) {
+            break;
+        }
+    }
+
+    return (ocThreadResult)0;
+}
+
+OC_PRIVATE void ocFileSystemIOUnmap_IOUring(ocFileSystemIO* pIO)
+{
+    ocAssert(pIO != NULL);
+
+    if (pIO->uring.pSQEs != NULL) {
+        munmap(pIO->uring.pSQEs, pIO->uring.sqesSize);
+    }
+    if (pIO->uring.pCQRing != NULL && pIO->uring.pCQRing != pIO->uring.pSQRing) {
+        munmap(pIO->uring.pCQRing, pIO->uring.cqRingSize);
+    }
+    if (pIO->uring.pSQRing != NULL) {
+        munmap(pIO->uring.pSQRing, pIO->uring.sqRingSize);
+    }
+
+    close(pIO->uring.fd);
+    pIO->uring.fd = -1;
+}
+
+OC_PRIVATE ocResult ocFileSystemIOInit_IOUring(ocFileSystemIO* pIO)
+{
+    ocAssert(pIO != NULL);
+
+    struct io_uring_params params;
+    ocZeroObject(&params);
+
+    int fd = (int)syscall(__NR_io_uring_setup, OC_FILE_SYSTEM_IO_URING_ENTRY_COUNT, &params);
+    if (fd < 0) {
+        return ocResultFromERRNO(errno);
+    }
+
+    pIO->uring.fd = fd;
+    pIO->uring.sqRingSize = params.sq_off.array + params.sq_entries*sizeof(ocUInt32);
+    pIO->uring.cqRingSize = params.cq_off.cqes  + params.cq_entries*sizeof(struct io_uring_cqe);
+    pIO->uring.sqesSize   = params.sq_entries*sizeof(struct io_uring_sqe);
+
+    // Newer kernels map both rings with a single call.
+    ocBool32 isSingleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (isSingleMapping) {
+        pIO->uring.sqRingSize = ocMax(pIO->uring.sqRingSize, pIO->uring.cqRingSize);
+        pIO->uring.cqRingSize = pIO->uring.sqRingSize;
+    }
+
+    void* pSQRing = mmap(NULL, pIO->uring.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (pSQRing == MAP_FAILED) {
+        ocFileSystemIOUnmap_IOUring(pIO);
+        return OC_ERROR;
+    }
+    pIO->uring.pSQRing = pSQRing;
+
+    void* pCQRing = pSQRing;
+    if (!isSingleMapping) {
+        pCQRing = mmap(NULL, pIO->uring.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (pCQRing == MAP_FAILED) {
+            ocFileSystemIOUnmap_IOUring(pIO);
+            return OC_ERROR;
+        }
+    }
+    pIO->uring.pCQRing = pCQRing;
+
+    void* pSQEs = mmap(NULL, pIO->uring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (pSQEs == MAP_FAILED) {
+        ocFileSystemIOUnmap_IOUring(pIO);
+        return OC_ERROR;
+    }
+    pIO->uring.pSQEs = (struct io_uring_sqe*)pSQEs;
+
+    pIO->uring.pSQHead      = (ocUInt32*)((ocUInt8*)pSQRing + params.sq_off.head);
+    pIO->uring.pSQTail      = (ocUInt32*)((ocUInt8*)pSQRing + params.sq_off.tail);
+    pIO->uring.pSQArray     = (ocUInt32*)((ocUInt8*)pSQRing + params.sq_off.array);
+    pIO->uring.sqMask       = *(ocUInt32*)((ocUInt8*)pSQRing + params.sq_off.ring_mask);
+    pIO->uring.sqEntryCount = params.sq_entries;
+    pIO->uring.pCQHead      = (ocUInt32*)((ocUInt8*)pCQRing + params.cq_off.head);
+    pIO->uring.pCQTail      = (ocUInt32*)((ocUInt8*)pCQRing + params.cq_off.tail);
+    pIO->uring.pCQEs        = (struct io_uring_cqe*)((ocUInt8*)pCQRing + params.cq_off.cqes);
+    pIO->uring.cqMask       = *(ocUInt32*)((ocUInt8*)pCQRing + params.cq_off.ring_mask);
+
+    if (!ocMutexInit(&pIO->uring.lock)) {
+        ocFileSystemIOUnmap_IOUring(pIO);
+        return OC_ERROR;
+    }
+
+    if (!ocThreadCreate(ocFileSystemIOCompletionThread_IOUring, pIO, &pIO->uring.completionThread)) {
+        ocMutexUninit(&pIO->uring.lock);
+        ocFileSystemIOUnmap_IOUring(pIO);
+        return OC_ERROR;
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocFileSystemIOUninit_IOUring(ocFileSystemIO* pIO)
+{
+    ocAssert(pIO != NULL);
+
+    if (pIO->uring.fd == -1) {
+        return;
+    }
+
+    // The completion thread is woken up with a no-op. There's always room for it since every batch must have been waited on by now, and
+    // the kernel consumes the submission queue on every submission.
+    ocMutexLock(&pIO->uring.lock);
+    {
+        ocUInt32 tail  = *pIO->uring.pSQTail;
+        ocUInt32 index = tail & pIO->uring.sqMask;
+        struct io_uring_sqe* pSQE = &pIO->uring.pSQEs[index];
+        ocZeroObject(pSQE);
+        pSQE->opcode    = IORING_OP_NOP;
+        pSQE->user_data = 0;
+        pIO->uring.pSQArray[index] = index;
+        __atomic_store_n(pIO->uring.pSQTail, tail + 1, __ATOMIC_RELEASE);
+
+        while (ocIOUringEnter(pIO->uring.fd, 1, 0, 0) < 0 && errno == EINTR) {
+        }
+    }
+    ocMutexUnlock(&pIO->uring.lock);
+
+    ocThreadWait(&pIO->uring.completionThread);
+    ocMutexUninit(&pIO->uring.lock);
+    ocFileSystemIOUnmap_IOUring(pIO);
+}
+
+// Determines whether or not the given read should go through the io_uring rather than the normal file API. This resolves the path
+// and hits the disk so it's only ever called from the I/O threads.
+OC_PRIVATE ocBool32 ocFileSystemIOShouldUse_IOUring(ocFileSystem* pFS, const ocFileReadRequest* pRequest)
+{
+    ocAssert(pFS != NULL);
+    ocAssert(pRequest != NULL);
+
+    // The kernel can only read plain files. Anything else, such as a file inside an archive that's opened through dr_fs, goes through
+    // the normal file API. Paths that can't be resolved are left to the normal file API to report.
+    char absolutePath[OC_MAX_PATH];
+    if (ocFindAbsoluteFilePath(pFS, pRequest->path, absolutePath, sizeof(absolutePath)) != OC_SUCCESS) {
+        return OC_FALSE;
+    }
+
+    struct stat info;
+    return stat(absolutePath, &info) == 0 && S_ISREG(info.st_mode);
+}
+
+// Runs on one of the I/O threads and sorts a list of reads between the io_uring and the I/O threads. The whole list is sorted by a single
+// job so that everything destined for the kernel can still be queued with a single lock and a single system call.
+OC_PRIVATE void ocFileSystemIODispatchJob_IOUring(void* pUserData)
+{
+    ocFileReadOp* pOp = (ocFileReadOp*)pUserData;
+    ocAssert(pOp != NULL);
+
+    ocFileSystem* pFS = pOp->pBatch->pFS;
+
+    ocFileReadOp* pURingHead = NULL;
+    ocFileReadOp* pURingTail = NULL;
+
+    while (pOp != NULL) {
+        ocFileReadOp* pNext = pOp->pNext;   // <-- The op can't be touched after it's been handed off.
+        pOp->pNext = NULL;
+
+        if (ocFileSystemIOShouldUse_IOUring(pFS, pOp->pRequest)) {
+            if (pURingTail != NULL) {
+                pURingTail->pNext = pOp;
+            } else {
+                pURingHead = pOp;
+            }
+            pURingTail = pOp;
+        } else {
+            if (ocJobQueueSubmit(&pFS->io.workers, ocFileReadJob, pOp, NULL) != OC_SUCCESS) {
+                ocFileReadJob(pOp);
+            }
+        }
+
+        pOp = pNext;
+    }
+
+    if (pURingHead != NULL) {
+        ocMutexLock(&pFS->io.uring.lock);
+        {
+            ocFileSystemIOEnqueue_IOUring(&pFS->io, pURingHead, pURingTail);
+        }
+        ocMutexUnlock(&pFS->io.uring.lock);
+    }
+}
+#endif
+
+
+OC_PRIVATE ocResult ocFileSystemIOInit(ocFileSystem* pFS)
+{
+    ocAssert(pFS != NULL);
+    ocAssert(pFS->pEngine != NULL);
+
+    ocUInt32 threadCount = OC_FILE_SYSTEM_IO_THREAD_COUNT;
+    if (ocCmdLineGetValue(pFS->pEngine->argc, pFS->pEngine->argv, "--io-threads") != NULL) {
+        threadCount = (ocUInt32)atoi(ocCmdLineGetValue(pFS->pEngine->argc, pFS->pEngine->argv, "--io-threads"));
+    }
+
+    ocResult result = ocJobQueueInit(threadCount, &pFS->io.workers);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+#ifdef OC_HAS_IO_URING
+    // Not being able to use io_uring is not an error. It may have been disabled, or the kernel may be too old. Everything will go through
+    // the I/O threads instead.
+    pFS->io.uring.fd = -1;
+    ocFileSystemIOInit_IOUring(&pFS->io);
+#endif
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocFileSystemIOUninit(ocFileSystem* pFS)
+{
+    ocAssert(pFS != NULL);
+
+#ifdef OC_HAS_IO_URING
+    ocFileSystemIOUninit_IOUring(&pFS->io);
+#endif
+
+    ocJobQueueUninit(&pFS->io.workers);
+}
+
+
+ocResult ocFileSystemSubmitReads(ocFileSystem* pFS, ocFileReadRequest* pRequests, ocUInt32 requestCount, ocFileReadBatch* pBatch)
+{
+    if (pBatch == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pBatch);
+
+    if (pFS == NULL || (pRequests == NULL && requestCount > 0)) {
+        return OC_INVALID_ARGS;
+    }
+
+    // Everything is validated before anything is submitted so that a failure doesn't leave half a batch in flight.
+    for (ocUInt32 iRequest = 0; iRequest < requestCount; ++iRequest) {
+        if (pRequests[iRequest].path == NULL || (pRequests[iRequest].pDst == NULL && pRequests[iRequest].size > 0)) {
+            return OC_INVALID_ARGS;
+        }
+    }
+
+    ocFileReadOp* pOps = (ocFileReadOp*)ocCalloc(ocMax(requestCount, 1), sizeof(*pOps));
+    if (pOps == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    if (!ocSemaphoreInit(0, &pBatch->completionSemaphore)) {
+        ocFree(pOps);
+        return OC_ERROR;
+    }
+
+    pBatch->pFS          = pFS;
+    pBatch->pRequests    = pRequests;
+    pBatch->requestCount = requestCount;
+    pBatch->pOps         = pOps;
+
+    // The extra count is released at the end so the batch can't complete while it's still being submitted.
+    pBatch->pendingCount = requestCount + 1;
+
+#ifdef OC_HAS_IO_URING
+    ocFileReadOp* pURingHead = NULL;
+    ocFileReadOp* pURingTail = NULL;
+#endif
+
+    for (ocUInt32 iRequest = 0; iRequest < requestCount; ++iRequest) {
+        ocFileReadOp* pOp = &pOps[iRequest];
+        pOp->pBatch   = pBatch;
+        pOp->pRequest = &pRequests[iRequest];
+        pOp->pRequest->result    = OC_SUCCESS;
+        pOp->pRequest->bytesRead = 0;
+
+#ifdef OC_HAS_IO_URING
+        // Package files are served from memory so there's nothing to gain from the kernel. Everything else may be a candidate, but the
+        // final decision needs to touch the disk so it's left to the I/O threads.
+        pOp->fd = -1;
+        ocPackage* pPackage;
+        if (pFS->io.uring.fd != -1 && ocFileSystemFindPackageEntry(pFS, pOp->pRequest->path, &pPackage) == NULL) {
+            if (pURingTail != NULL) {
+                pURingTail->pNext = pOp;
+            } else {
+                pURingHead = pOp;
+            }
+            pURingTail = pOp;
+
+            continue;
+        }
+#endif
+
+        ocResult result = ocJobQueueSubmit(&pFS->io.workers, ocFileReadJob, pOp, NULL);
+        if (result != OC_SUCCESS) {
+            ocFileReadOpComplete(pOp, result);
+        }
+    }
+
+#ifdef OC_HAS_IO_URING
+    if (pURingHead != NULL) {
+        if (ocJobQueueSubmit(&pFS->io.workers, ocFileSystemIODispatchJob_IOUring, pURingHead, NULL) != OC_SUCCESS) {
+            ocFileSystemIODispatchJob_IOUring(pURingHead);
+        }
+    }
+#endif
+
+    if (ocAtomicDecrement(&pBatch->pendingCount) == 0) {
+        ocSemaphoreRelease(&pBatch->completionSemaphore);
+    }
+
+    return OC_SUCCESS;
+}
+
+ocBool32 ocFileSystemPollReads(ocFileReadBatch* pBatch)
+{
+    if (pBatch == NULL || pBatch->pFS == NULL) {
+        return OC_TRUE;
+    }
+
+    return ocAtomicLoad(&pBatch->pendingCount) == 0;
+}
+
+ocResult ocFileSystemWaitForReads(ocFileReadBatch* pBatch)
+{
+    if (pBatch == NULL || pBatch->pFS == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocSemaphoreWait(&pBatch->completionSemaphore);
+    ocSemaphoreUninit(&pBatch->completionSemaphore);
+    ocFree(pBatch->pOps);
+
+    ocResult result = OC_SUCCESS;
+    for (ocUInt32 iRequest = 0; iRequest < pBatch->requestCount; ++iRequest) {
+        if (pBatch->pRequests[iRequest].result != OC_SUCCESS) {
+            result = pBatch->pRequests[iRequest].result;
+            break;
+        }
+    }
+
+    ocZeroObject(pBatch);
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// File Watching
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_FILE_WATCHER_BUFFER_SIZE     (16*1024)
+
+struct ocFileWatcherDirectory
+{
+    ocString absolutePath;
+
+#ifdef OC_WIN32
+    HANDLE hDirectory;
+    OVERLAPPED overlapped;
+    DWORD buffer[OC_FILE_WATCHER_BUFFER_SIZE / sizeof(DWORD)];    // <-- ReadDirectoryChangesW() requires DWORD alignment.
+#endif
+#ifdef OC_LINUX
+    int wd;
+#endif
+};
+
+// Records a change to a file, or pushes back the time of a change that's already waiting to settle.
+OC_PRIVATE void ocFileWatcherRecordChange(ocFileWatcher* pWatcher, ocFileWatcherDirectory* pDirectory, const char* fileName)
+{
+    ocAssert(pWatcher != NULL);
+    ocAssert(pDirectory != NULL);
+    ocAssert(fileName != NULL);
+
+    char absolutePath[OC_MAX_PATH];
+    if (ocPathAppend(absolutePath, sizeof(absolutePath), pDirectory->absolutePath, fileName) == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < pWatcher->changes.count; ++i) {
+        if (ocPathEqual(pWatcher->changes.pItems[i].absolutePath, absolutePath)) {
+            pWatcher->changes.pItems[i].lastEventTime = pWatcher->time;
+            return;
+        }
+    }
+
+    ocFileWatcherChange change;
+    change.absolutePath = ocMakeString(absolutePath);
+    change.lastEventTime = pWatcher->time;
+    if (change.absolutePath == NULL || ocStackPush(&pWatcher->changes, change) != OC_SUCCESS) {
+        ocFreeString(change.absolutePath);
+    }
+}
+
+#ifdef OC_WIN32
+OC_PRIVATE ocBool32 ocFileWatcherBeginRead_Win32(ocFileWatcherDirectory* pDirectory)
+{
+    ocAssert(pDirectory != NULL);
+
+    ocZeroObject(&pDirectory->overlapped);
+    return ReadDirectoryChangesW(pDirectory->hDirectory, pDirectory->buffer, sizeof(pDirectory->buffer), FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, NULL, &pDirectory->overlapped, NULL);
+}
+
+OC_PRIVATE ocResult ocFileWatcherWatchDirectory_Win32(ocFileWatcher* pWatcher, ocFileWatcherDirectory* pDirectory)
+{
+    (void)pWatcher;
+    ocAssert(pDirectory != NULL);
+
+    pDirectory->hDirectory = CreateFileA(pDirectory->absolutePath, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    if (pDirectory->hDirectory == INVALID_HANDLE_VALUE) {
+        return OC_ERROR;
+    }
+
+    if (!ocFileWatcherBeginRead_Win32(pDirectory)) {
+        CloseHandle(pDirectory->hDirectory);
+        return OC_ERROR;
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocFileWatcherUnwatchDirectory_Win32(ocFileWatcher* pWatcher, ocFileWatcherDirectory* pDirectory)
+{
+    (void)pWatcher;
+    ocAssert(pDirectory != NULL);
+
+    // The buffer is written to by the operating system so the read needs to be fully cancelled before it's freed.
+    DWORD bytesTransferred;
+    CancelIo(pDirectory->hDirectory);
+    GetOverlappedResult(pDirectory->hDirectory, &pDirectory->overlapped, &bytesTransferred, TRUE);
+    CloseHandle(pDirectory->hDirectory);
+}
+
+OC_PRIVATE void ocFileWatcherReadEvents_Win32(ocFileWatcher* pWatcher)
+{
+    ocAssert(pWatcher != NULL);
+
+    for (size_t iDirectory = 0; iDirectory < pWatcher->directories.count; ++iDirectory) {
+        ocFileWatcherDirectory* pDirectory = pWatcher->directories.pItems[iDirectory];
+
+        // This fails with ERROR_IO_INCOMPLETE when nothing has changed.
+        DWORD bytesTransferred;
+        if (!GetOverlappedResult(pDirectory->hDirectory, &pDirectory->overlapped, &bytesTransferred, FALSE)) {
+            continue;
+        }
+
+        // Zero bytes means there were too many changes to fit in the buffer.
+        if (bytesTransferred == 0) {
+            ocWarningf(pWatcher->pFS->pEngine, "Too many file changes in %s. Some changes have been missed.", pDirectory->absolutePath);
+        } else {
+            ocUInt8* pRunningBuffer = (ocUInt8*)pDirectory->buffer;
+            for (;;) {
+                FILE_NOTIFY_INFORMATION* pInfo = (FILE_NOTIFY_INFORMATION*)pRunningBuffer;
+                if (pInfo->Action == FILE_ACTION_ADDED || pInfo->Action == FILE_ACTION_MODIFIED || pInfo->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                    char fileName[OC_MAX_PATH];
+                    int fileNameLength = WideCharToMultiByte(CP_UTF8, 0, pInfo->FileName, (int)(pInfo->FileNameLength / sizeof(WCHAR)), fileName, sizeof(fileName) - 1, NULL, NULL);
+                    if (fileNameLength > 0) {
+                        fileName[fileNameLength] = '\0';
+                        ocFileWatcherRecordChange(pWatcher, pDirectory, fileName);
+                    }
+                }
+
+                if (pInfo->NextEntryOffset == 0) {
+                    break;
+                }
+
+                pRunningBuffer += pInfo->NextEntryOffset;
+            }
+        }
+
+        ocFileWatcherBeginRead_Win32(pDirectory);
+    }
+}
+#endif
+
+#ifdef OC_LINUX
+OC_PRIVATE ocResult ocFileWatcherInit_Linux(ocFileWatcher* pWatcher)
+{
+    ocAssert(pWatcher != NULL);
+
+    pWatcher->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (pWatcher->fd < 0) {
+        return ocResultFromERRNO(errno);
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocFileWatcherUninit_Linux(ocFileWatcher* pWatcher)
+{
+    ocAssert(pWatcher != NULL);
+
+    close(pWatcher->fd);
+}
+
+OC_PRIVATE ocResult ocFileWatcherWatchDirectory_Linux(ocFileWatcher* pWatcher, ocFileWatcherDirectory* pDirectory)
+{
+    ocAssert(pWatcher != NULL);
+    ocAssert(pDirectory != NULL);
+
+    // IN_MODIFY is reported for every write. It's not needed to detect the change, but it keeps the change from settling while the
+    // file is still being written.
+    pDirectory->wd = inotify_add_watch(pWatcher->fd, pDirectory->absolutePath, IN_CLOSE_WRITE | IN_MOVED_TO | IN_MODIFY);
+    if (pDirectory->wd < 0) {
+        return ocResultFromERRNO(errno);
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocFileWatcherUnwatchDirectory_Linux(ocFileWatcher* pWatcher, ocFileWatcherDirectory* pDirectory)
+{
+    ocAssert(pWatcher != NULL);
+    ocAssert(pDirectory != NULL);
+
+    inotify_rm_watch(pWatcher->fd, pDirectory->wd);
+}
+
+OC_PRIVATE void ocFileWatcherReadEvents_Linux(ocFileWatcher* pWatcher)
+{
+    ocAssert(pWatcher != NULL);
+
+    char buffer[OC_FILE_WATCHER_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        ssize_t bytesRead = read(pWatcher->fd, buffer, sizeof(buffer));
+        if (bytesRead <= 0) {
+            break;  // <-- EAGAIN when there's nothing left to read.
+        }
+
+        const struct inotify_event* pEvent;
+        for (char* pRunningBuffer = buffer; pRunningBuffer < buffer + bytesRead; pRunningBuffer += sizeof(struct inotify_event) + pEvent->len) {
+            pEvent = (const struct inotify_event*)pRunningBuffer;
+
+            if ((pEvent->mask & IN_Q_OVERFLOW) != 0) {
+                ocWarningf(pWatcher->pFS->pEngine, "Too many file changes. Some changes have been missed.");
+                continue;
+            }
+
+            if (pEvent->len == 0 || (pEvent->mask & IN_ISDIR) != 0) {
+                continue;
+            }
+
+            for (size_t iDirectory = 0; iDirectory < pWatcher->directories.count; ++iDirectory) {
+                if (pWatcher->directories.pItems[iDirectory]->wd == pEvent->wd) {
+                    ocFileWatcherRecordChange(pWatcher, pWatcher->directories.pItems[iDirectory], pEvent->name);
+                    break;
+                }
+            }
+        }
+    }
+}
+#endif
+
+ocResult ocFileWatcherInit(ocFileSystem* pFS, ocFileWatcher* pWatcher)
+{
+    if (pWatcher == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pWatcher);
+
+    if (pFS == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    pWatcher->pFS = pFS;
+    ocStackInit(&pWatcher->directories);
+    ocStackInit(&pWatcher->changes);
+    ocTimerInit(&pWatcher->timer);
+
+#if defined(OC_WIN32)
+    return OC_SUCCESS;  // <-- Nothing to do until a directory is watched.
+#elif defined(OC_LINUX)
+    return ocFileWatcherInit_Linux(pWatcher);
+#else
+    return OC_FEATURE_NOT_SUPPORTED;
+#endif
+}
+
+void ocFileWatcherUninit(ocFileWatcher* pWatcher)
+{
+    if (pWatcher == NULL || pWatcher->pFS == NULL) {
+        return;
+    }
+
+    for (size_t iDirectory = 0; iDirectory < pWatcher->directories.count; ++iDirectory) {
+        ocFileWatcherDirectory* pDirectory = pWatcher->directories.pItems[iDirectory];
+#ifdef OC_WIN32
+        ocFileWatcherUnwatchDirectory_Win32(pWatcher, pDirectory);
+#endif
+#ifdef OC_LINUX
+        ocFileWatcherUnwatchDirectory_Linux(pWatcher, pDirectory);
+#endif
+        ocFreeString(pDirectory->absolutePath);
+        ocFree(pDirectory);
+    }
+
+    for (size_t iChange = 0; iChange < pWatcher->changes.count; ++iChange) {
+        ocFreeString(pWatcher->changes.pItems[iChange].absolutePath);
+    }
+
+#ifdef OC_LINUX
+    ocFileWatcherUninit_Linux(pWatcher);
+#endif
+
+    ocStackUninit(&pWatcher->directories);
+    ocStackUninit(&pWatcher->changes);
+}
+
+ocResult ocFileWatcherWatchDirectory(ocFileWatcher* pWatcher, const char* absolutePath)
+{
+    if (pWatcher == NULL || absolutePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    for (size_t iDirectory = 0; iDirectory < pWatcher->directories.count; ++iDirectory) {
+        if (ocPathEqual(pWatcher->directories.pItems[iDirectory]->absolutePath, absolutePath)) {
+            return OC_SUCCESS;
+        }
+    }
+
+    // This also filters out directories inside packages.
+    if (!ocIsDirectory(absolutePath)) {
+        return OC_NOT_DIRECTORY;
+    }
+
+    ocFileWatcherDirectory* pDirectory = (ocFileWatcherDirectory*)ocCalloc(1, sizeof(*pDirectory));
+    if (pDirectory == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pDirectory->absolutePath = ocMakeString(absolutePath);
+    if (pDirectory->absolutePath == NULL) {
+        ocFree(pDirectory);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocResult result;
+#if defined(OC_WIN32)
+    result = ocFileWatcherWatchDirectory_Win32(pWatcher, pDirectory);
+#elif defined(OC_LINUX)
+    result = ocFileWatcherWatchDirectory_Linux(pWatcher, pDirectory);
+#else
+    result = OC_FEATURE_NOT_SUPPORTED;
+#endif
+    if (result != OC_SUCCESS) {
+        goto on_error1;
+    }
+
+    result = ocStackPush(&pWatcher->directories, pDirectory);
+    if (result != OC_SUCCESS) {
+        goto on_error2;
+    }
+
+    return OC_SUCCESS;
+
+on_error2:
+#ifdef OC_WIN32
+    ocFileWatcherUnwatchDirectory_Win32(pWatcher, pDirectory);
+#endif
+#ifdef OC_LINUX
+    ocFileWatcherUnwatchDirectory_Linux(pWatcher, pDirectory);
+#endif
+on_error1:
+    ocFreeString(pDirectory->absolutePath);
+    ocFree(pDirectory);
+    return result;
+}
+
+void ocFileWatcherPoll(ocFileWatcher* pWatcher, ocFileWatcherChangeProc onChange, void* pUserData)
+{
+    if (pWatcher == NULL || pWatcher->pFS == NULL) {
+        return;
+    }
+
+    pWatcher->time += ocTimerTick(&pWatcher->timer);
+
+#ifdef OC_WIN32
+    ocFileWatcherReadEvents_Win32(pWatcher);
+#endif
+#ifdef OC_LINUX
+    ocFileWatcherReadEvents_Linux(pWatcher);
+#endif
+
+    // Changes that have settled are removed by moving the last change into their slot, so this needs to iterate backwards.
+    for (size_t iChange = pWatcher->changes.count; iChange > 0; --iChange) {
+        ocFileWatcherChange change = pWatcher->changes.pItems[iChange-1];
+        if (pWatcher->time - change.lastEventTime < OC_FILE_WATCHER_DEBOUNCE_TIME) {
+            continue;
+        }
+
+        pWatcher->changes.pItems[iChange-1] = pWatcher->changes.pItems[pWatcher->changes.count-1];
+        pWatcher->changes.count -= 1;
+
+        if (onChange != NULL) {
+            onChange(pUserData, change.absolutePath);
+        }
+
+        ocFreeString(change.absolutePath);
+    }
+}
\ No newline at end of file
@@ -19,15 +19,70 @@ enum ocSeekOrigin
 };
 
 
+// The number of threads used for asynchronous reads that can't be handed to the operating system. Can be overridden with --io-threads.
+#define OC_FILE_SYSTEM_IO_THREAD_COUNT      4
+
+// The maximum number of reads that can be in flight in the io_uring at any one time. Anything beyond this is queued.
+#define OC_FILE_SYSTEM_IO_URING_ENTRY_COUNT 256
+
+struct ocPackage;
+struct ocFileReadOp;
+
+// Backend state for asynchronous reads. See ocFileSystemSubmitReads().
+struct ocFileSystemIO
+{
+    // Reads that can't be handed to the operating system, such as those from packages and archives, are run on a small pool of
+    // dedicated threads.
+    // This is separate to the engine's job queue so that threads blocking on the disk never hold up other work.
+    ocJobQueue workers;
+
+#ifdef OC_HAS_IO_URING
+    struct
+    {
+        int fd;                         // <-- -1 when io_uring is not available, in which case everything goes through the workers.
+        void* pSQRing;
+        size_t sqRingSize;
+        void* pCQRing;
+        size_t cqRingSize;
+        struct io_uring_sqe* pSQEs;
+        size_t sqesSize;
+        ocUInt32* pSQHead;
+        ocUInt32* pSQTail;
+        ocUInt32* pSQArray;
+        ocUInt32 sqMask;
+        ocUInt32 sqEntryCount;
+        ocUInt32* pCQHead;
+        ocUInt32* pCQTail;
+        struct io_uring_cqe* pCQEs;
+        ocUInt32 cqMask;
+        ocMutex lock;                   // <-- Protects the submission queue, the pending list and the in-flight count.
+        ocFileReadOp* pPendingHead;     // <-- Reads waiting for a free slot in the ring.
+        ocFileReadOp* pPendingTail;
+        ocUInt32 inFlightCount;
+        ocThread completionThread;
+    } uring;
+#endif
+};
+
 struct ocFileSystem
 {
     drfs_context internalFS;
     ocEngineContext* pEngine;
+    ocStack<ocPackage*> packages;   // <-- Mounted packages. Searched from last to first, before the base directories.
+    ocFileSystemIO io;
 };
 
 struct ocFile
 {
     drfs_file* pInternalFile;
+
+    // Files opened from a mounted package are read-only and served from memory. pPackageData points into the package's mapping, or
+    // to pDecompressedData when the entry is compressed.
+    ocPackage* pPackage;
+    const ocUInt8* pPackageData;
+    void* pDecompressedData;
+    ocUInt64 packageDataSize;
+    ocUInt64 packageDataPos;
 };
 
 typedef struct drfs_file_info ocFileInfo;
@@ -43,6 +98,17 @@ ocResult ocFileSystemInit(ocEngineContext* pEngine, ocFileSystem* pFS);
 void ocFileSystemUninit(ocFileSystem* pFS);
 
 
+// Mounts a package ('PAK1' OCD file).
+//
+// Files in mounted packages take priority over loose files in the base directories. Packages mounted later take priority over those
+// mounted earlier. Files in a package can be opened by their path relative to the root of the package, or by the absolute path of
+// the package with the relative path appended to it.
+ocResult ocFileSystemMountPackage(ocFileSystem* pFS, const char* packagePath);
+
+// Unmounts a package. Files opened from the package must be closed beforehand.
+ocResult ocFileSystemUnmountPackage(ocFileSystem* pFS, const char* packagePath);
+
+
 // Retrieves information about the given file.
 //
 // pInfo can be NULL, in which case this function can be used as a simple way of checking whether or not the file exists.
@@ -81,6 +147,113 @@ void ocFileFlush(ocFile* pFile);
 // Determines whether or not the file is at the end.
 ocBool32 ocAtEOF(ocFile* pFile);
 
+// Retrieves a pointer to the entire content of the file without copying.
+//
+// This only works for files that are backed by memory, which is currently only files opened from a package. Returns
+// OC_INVALID_OPERATION for everything else in which case the file should be read normally.
+ocResult ocFileGetData(ocFile* pFile, const void** ppData, ocUInt64* pSize);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Asynchronous Reads
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// A single read in a batch. The result and bytesRead members are set when the read completes.
+//
+// Reading past the end of the file is not an error. In this case the request succeeds and bytesRead will be less than size.
+struct ocFileReadRequest
+{
+    const char* path;       // <-- Resolved the same way as ocFileOpen().
+    ocUInt64 offset;
+    ocSizeT size;
+    void* pDst;
+    ocResult result;
+    ocSizeT bytesRead;
+};
+
+struct ocFileReadBatch
+{
+    ocFileSystem* pFS;
+    ocFileReadRequest* pRequests;
+    ocUInt32 requestCount;
+    ocUInt32 pendingCount;          // <-- Atomic. The batch is complete when this reaches 0.
+    ocSemaphore completionSemaphore;
+    ocFileReadOp* pOps;             // <-- Internal state for each request.
+};
+
+// Submits a batch of reads without waiting for them to complete.
+//
+// On Linux, reads from loose files are handed to the kernel with io_uring so they can all be in flight at the same time. Everything
+// else is run on the file system's I/O threads. The requests, including their path strings and destination buffers, and the batch object
+// itself must remain valid until ocFileSystemWaitForReads() has returned.
+//
+// ocFileSystemWaitForReads() must always be called for a batch that was successfully submitted, even if it's known to be complete.
+// Packages must not be mounted or unmounted while reads are in flight.
+ocResult ocFileSystemSubmitReads(ocFileSystem* pFS, ocFileReadRequest* pRequests, ocUInt32 requestCount, ocFileReadBatch* pBatch);
+
+// Determines whether or not every read in the given batch has completed. This does not block.
+ocBool32 ocFileSystemPollReads(ocFileReadBatch* pBatch);
+
+// Waits for every read in the given batch to complete and releases the batch's resources.
+//
+// Returns the result of the first request that failed, or OC_SUCCESS if they all succeeded. Check the result of each request for
+// more detail.
+ocResult ocFileSystemWaitForReads(ocFileReadBatch* pBatch);
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// File Watching
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// The number of seconds a file needs to go without being modified before a change is reported. Editors tend to save files in several
+// steps so this avoids reporting the same change more than once, or reporting a file before it's been completely written.
+#define OC_FILE_WATCHER_DEBOUNCE_TIME   0.25
+
+typedef void (* ocFileWatcherChangeProc)(void* pUserData, const char* absolutePath);
+
+struct ocFileWatcherDirectory;
+
+struct ocFileWatcherChange
+{
+    ocString absolutePath;
+    double lastEventTime;
+};
+
+struct ocFileWatcher
+{
+    ocFileSystem* pFS;
+    ocStack<ocFileWatcherDirectory*> directories;
+    ocStack<ocFileWatcherChange> changes;   // <-- Changes that are waiting to settle.
+    ocTimer timer;
+    double time;                            // <-- The number of seconds since the watcher was initialized, as of the last poll.
+
+#ifdef OC_LINUX
+    int fd;                                 // <-- The inotify instance.
+#endif
+};
+
+// Initializes a file watcher.
+//
+// This uses inotify on Linux and ReadDirectoryChangesW() on Windows. Returns OC_FEATURE_NOT_SUPPORTED on other platforms.
+ocResult ocFileWatcherInit(ocFileSystem* pFS, ocFileWatcher* pWatcher);
+
+// Uninitializes a file watcher.
+void ocFileWatcherUninit(ocFileWatcher* pWatcher);
+
+// Starts watching the files in the given directory. Sub-directories are not watched. Does nothing if the directory is already being
+// watched. Directories inside packages cannot be watched.
+ocResult ocFileWatcherWatchDirectory(ocFileWatcher* pWatcher, const char* absolutePath);
+
+// Reports every file that has been created or modified since the last poll and has since gone at least OC_FILE_WATCHER_DEBOUNCE_TIME
+// seconds without being modified again. This does not block and is intended to be called once per frame.
+//
+// A file watcher is not thread-safe. It should only be used from a single thread.
+void ocFileWatcherPoll(ocFileWatcher* pWatcher, ocFileWatcherChangeProc onChange, void* pUserData);
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -113,6 +286,9 @@ ocResult ocGetExecutableDirectoryPath(char* pathOut, size_t pathOutSize);
 // Retrieves the path of the directory that contains the log file.
 void ocGetLogFolderPath(ocFileSystem* pFS, char* pathOut, size_t pathOutSize);
 
+// Retrieves the path of the directory where generated data, such as cooked .ocd files, should be cached.
+void ocGetCacheFolderPath(ocFileSystem* pFS, char* pathOut, size_t pathOutSize);
+
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -158,4 +334,10 @@ ocResult ocOpenAndWriteFile(const char* filePath, const void* pFileData, size_t
 ocResult ocOpenAndWriteTextFile(const char* filePath, const char* pFileData);
 
 // Copies a file.
-ocResult ocCopyFile(const char* srcPath, const char* dstPath, ocBool32 failIfExists);
\ No newline at end of file
+ocResult ocCopyFile(const char* srcPath, const char* dstPath, ocBool32 failIfExists);
+
+// Moves a file, replacing the destination if it already exists.
+//
+// When the source and destination are on the same volume this is atomic, so it can be used to publish a file that was written to a
+// temporary location without anybody ever seeing a partially written file.
+ocResult ocMoveFile(const char* srcPath, const char* dstPath);
\ No newline at end of file
@@ -0,0 +1,208 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+OC_PRIVATE void ocJobRun(ocJob* pJob)
+{
+    ocAssert(pJob != NULL);
+
+    pJob->proc(pJob->pUserData);
+
+    if (pJob->pCounter != NULL) {
+        ocAtomicDecrement(pJob->pCounter);
+    }
+}
+
+// Removes the job at the front of the queue. Must be called while the lock is held.
+OC_PRIVATE ocBool32 ocJobQueuePop(ocJobQueue* pQueue, ocJob* pJob)
+{
+    ocAssert(pQueue != NULL);
+    ocAssert(pJob != NULL);
+
+    if (pQueue->jobCount == 0) {
+        return OC_FALSE;
+    }
+
+    *pJob = pQueue->pJobs[pQueue->jobHead];
+    pQueue->jobHead   = (pQueue->jobHead + 1) % pQueue->jobCapacity;
+    pQueue->jobCount -= 1;
+
+    return OC_TRUE;
+}
+
+// Grows the ring buffer. Must be called while the lock is held.
+OC_PRIVATE ocResult ocJobQueueGrow(ocJobQueue* pQueue)
+{
+    ocAssert(pQueue != NULL);
+
+    ocUInt32 newCapacity = (pQueue->jobCapacity == 0) ? 64 : pQueue->jobCapacity*2;
+    ocJob* pNewJobs = (ocJob*)ocMalloc(newCapacity * sizeof(*pNewJobs));
+    if (pNewJobs == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // The jobs need to be unwrapped so they're contiguous in the new buffer.
+    for (ocUInt32 i = 0; i < pQueue->jobCount; ++i) {
+        pNewJobs[i] = pQueue->pJobs[(pQueue->jobHead + i) % pQueue->jobCapacity];
+    }
+
+    ocFree(pQueue->pJobs);
+    pQueue->pJobs       = pNewJobs;
+    pQueue->jobCapacity = newCapacity;
+    pQueue->jobHead     = 0;
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocThreadResult OC_THREADCALL ocJobQueueWorkerThread(void* pData)
+{
+    ocJobQueue* pQueue = (ocJobQueue*)pData;
+    ocAssert(pQueue != NULL);
+
+    for (;;) {
+        ocSemaphoreWait(&pQueue->jobSemaphore);
+
+        // The queue may be empty here if the job was picked up by a thread in ocJobQueueWaitForCounter(). We only terminate once
+        // the queue has been drained so that nothing that's been submitted is lost.
+        ocJob job;
+        ocMutexLock(&pQueue->lock);
+        ocBool32 hasJob = ocJobQueuePop(pQueue, &job);
+        ocBool32 isTerminating = pQueue->isTerminating;
+        ocMutexUnlock(&pQueue->lock);
+
+        if (hasJob) {
+            ocJobRun(&job);
+        } else if (isTerminating) {
+            break;
+        }
+    }
+
+    return (ocThreadResult)0;
+}
+
+
+ocResult ocJobQueueInit(ocUInt32 threadCount, ocJobQueue* pQueue)
+{
+    if (pQueue == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pQueue);
+
+    if (threadCount > OC_MAX_JOB_THREADS) {
+        threadCount = OC_MAX_JOB_THREADS;
+    }
+
+    if (!ocMutexInit(&pQueue->lock)) {
+        return OC_ERROR;
+    }
+
+    if (!ocSemaphoreInit(0, &pQueue->jobSemaphore)) {
+        ocMutexUninit(&pQueue->lock);
+        return OC_ERROR;
+    }
+
+    for (ocUInt32 iThread = 0; iThread < threadCount; ++iThread) {
+        if (!ocThreadCreate(ocJobQueueWorkerThread, pQueue, &pQueue->threads[iThread])) {
+            break;
+        }
+
+        pQueue->threadCount += 1;
+    }
+
+    // It's not an error if we couldn't create every thread, but we need at least one if any were requested.
+    if (threadCount > 0 && pQueue->threadCount == 0) {
+        ocSemaphoreUninit(&pQueue->jobSemaphore);
+        ocMutexUninit(&pQueue->lock);
+        return OC_ERROR;
+    }
+
+    return OC_SUCCESS;
+}
+
+void ocJobQueueUninit(ocJobQueue* pQueue)
+{
+    if (pQueue == NULL) {
+        return;
+    }
+
+    ocMutexLock(&pQueue->lock);
+    pQueue->isTerminating = OC_TRUE;
+    ocMutexUnlock(&pQueue->lock);
+
+    for (ocUInt32 iThread = 0; iThread < pQueue->threadCount; ++iThread) {
+        ocSemaphoreRelease(&pQueue->jobSemaphore);
+    }
+
+    for (ocUInt32 iThread = 0; iThread < pQueue->threadCount; ++iThread) {
+        ocThreadWait(&pQueue->threads[iThread]);
+    }
+
+    ocSemaphoreUninit(&pQueue->jobSemaphore);
+    ocMutexUninit(&pQueue->lock);
+    ocFree(pQueue->pJobs);
+}
+
+ocResult ocJobQueueSubmit(ocJobQueue* pQueue, ocJobProc proc, void* pUserData, ocUInt32* pCounter)
+{
+    if (pQueue == NULL || proc == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocJob job;
+    job.proc      = proc;
+    job.pUserData = pUserData;
+    job.pCounter  = pCounter;
+
+    if (pCounter != NULL) {
+        ocAtomicIncrement(pCounter);
+    }
+
+    // With no worker threads the job is run immediately.
+    if (pQueue->threadCount == 0) {
+        ocJobRun(&job);
+        return OC_SUCCESS;
+    }
+
+    ocMutexLock(&pQueue->lock);
+    {
+        if (pQueue->jobCount == pQueue->jobCapacity) {
+            ocResult result = ocJobQueueGrow(pQueue);
+            if (result != OC_SUCCESS) {
+                ocMutexUnlock(&pQueue->lock);
+
+                if (pCounter != NULL) {
+                    ocAtomicDecrement(pCounter);
+                }
+
+                return result;
+            }
+        }
+
+        pQueue->pJobs[(pQueue->jobHead + pQueue->jobCount) % pQueue->jobCapacity] = job;
+        pQueue->jobCount += 1;
+    }
+    ocMutexUnlock(&pQueue->lock);
+
+    ocSemaphoreRelease(&pQueue->jobSemaphore);
+    return OC_SUCCESS;
+}
+
+void ocJobQueueWaitForCounter(ocJobQueue* pQueue, ocUInt32* pCounter)
+{
+    if (pQueue == NULL || pCounter == NULL) {
+        return;
+    }
+
+    while (ocAtomicLoad(pCounter) > 0) {
+        // Help out with any queued jobs. These may not be associated with our counter, but it's better than sitting idle.
+        ocJob job;
+        ocMutexLock(&pQueue->lock);
+        ocBool32 hasJob = ocJobQueuePop(pQueue, &job);
+        ocMutexUnlock(&pQueue->lock);
+
+        if (hasJob) {
+            ocJobRun(&job);
+        } else {
+            ocYieldThread();
+        }
+    }
+}
\ No newline at end of file
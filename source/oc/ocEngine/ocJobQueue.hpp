@@ -0,0 +1,50 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// The job queue is a pool of worker threads for getting work off the main thread. Jobs are started in the order they are submitted,
+// but there are multiple workers so they may finish in any order.
+//
+// A job can optionally be associated with a counter. The counter is incremented when the job is submitted and decremented when it
+// finishes. Use ocJobQueueWaitForCounter() to wait for a group of jobs to complete. The waiting thread will run queued jobs itself
+// while it waits rather than sitting idle.
+
+#define OC_MAX_JOB_THREADS  32
+
+typedef void (* ocJobProc)(void* pUserData);
+
+struct ocJob
+{
+    ocJobProc proc;
+    void* pUserData;
+    ocUInt32* pCounter;
+};
+
+struct ocJobQueue
+{
+    ocThread threads[OC_MAX_JOB_THREADS];
+    ocUInt32 threadCount;
+    ocMutex lock;
+    ocSemaphore jobSemaphore;   // <-- Released once for every job that's submitted, and once for every thread when terminating.
+    ocJob* pJobs;               // <-- A ring buffer.
+    ocUInt32 jobCapacity;
+    ocUInt32 jobHead;
+    ocUInt32 jobCount;
+    ocBool32 isTerminating;
+};
+
+// Initializes a job queue.
+//
+// When threadCount is 0, jobs are run on the calling thread from inside ocJobQueueSubmit().
+ocResult ocJobQueueInit(ocUInt32 threadCount, ocJobQueue* pQueue);
+
+// Uninitializes a job queue.
+//
+// This will wait for every job that has already been submitted to finish.
+void ocJobQueueUninit(ocJobQueue* pQueue);
+
+// Submits a job.
+//
+// pCounter can be NULL. When non-NULL, it's incremented immediately and decremented after the job has finished.
+ocResult ocJobQueueSubmit(ocJobQueue* pQueue, ocJobProc proc, void* pUserData, ocUInt32* pCounter);
+
+// Waits for the given counter to reach zero, running queued jobs on the calling thread while waiting.
+void ocJobQueueWaitForCounter(ocJobQueue* pQueue, ocUInt32* pCounter);
\ No newline at end of file
@@ -1 +1,664 @@
-// Copyright (C) 2018 David Reid. See included LICENSE file.
\ No newline at end of file
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SIMD Level
+//
+///////////////////////////////////////////////////////////////////////////////
+
+static ocBool32 g_ocIsSIMDLevelInitialized = OC_FALSE;
+static ocSIMDLevel g_ocSupportedSIMDLevel = ocSIMDLevel_None;
+static ocSIMDLevel g_ocSIMDLevel = ocSIMDLevel_None;
+
+#ifdef OC_SUPPORT_AVX2
+OC_PRIVATE void ocCPUID(ocUInt32 info[4], ocUInt32 function, ocUInt32 subfunction)
+{
+#if defined(_MSC_VER)
+    __cpuidex((int*)info, (int)function, (int)subfunction);
+#else
+    __cpuid_count(function, subfunction, info[0], info[1], info[2], info[3]);
+#endif
+}
+
+OC_PRIVATE ocUInt64 ocXGETBV(ocUInt32 index)
+{
+#if defined(_MSC_VER)
+    return _xgetbv(index);
+#else
+    ocUInt32 lo;
+    ocUInt32 hi;
+    __asm__ __volatile__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(index));
+    return ((ocUInt64)hi << 32) | lo;
+#endif
+}
+#endif
+
+OC_PRIVATE ocSIMDLevel ocDetectSIMDLevel()
+{
+#ifdef OC_SUPPORT_AVX2
+    // AVX2 needs support from the OS as well as the CPU, since the OS needs to save the upper halves of the YMM registers.
+    ocUInt32 info[4];
+    ocCPUID(info, 0, 0);
+    if (info[0] >= 7) {
+        ocCPUID(info, 1, 0);
+        ocBool32 hasOSXSAVE = (info[2] & (1U << 27)) != 0;
+        ocBool32 hasAVX     = (info[2] & (1U << 28)) != 0;
+        if (hasOSXSAVE && hasAVX && (ocXGETBV(0) & 6) == 6) {
+            ocCPUID(info, 7, 0);
+            if ((info[1] & (1U << 5)) != 0) {
+                return ocSIMDLevel_AVX2;
+            }
+        }
+    }
+#endif
+
+#ifdef OC_SUPPORT_SSE2
+    return ocSIMDLevel_SSE2;
+#else
+    return ocSIMDLevel_None;
+#endif
+}
+
+OC_PRIVATE void ocInitSIMDLevel()
+{
+    // This can race, but every thread will detect the same level so it doesn't matter.
+    if (!g_ocIsSIMDLevelInitialized) {
+        g_ocSupportedSIMDLevel = ocDetectSIMDLevel();
+        g_ocSIMDLevel = g_ocSupportedSIMDLevel;
+        g_ocIsSIMDLevelInitialized = OC_TRUE;
+    }
+}
+
+ocSIMDLevel ocGetSupportedSIMDLevel()
+{
+    ocInitSIMDLevel();
+    return g_ocSupportedSIMDLevel;
+}
+
+ocSIMDLevel ocGetSIMDLevel()
+{
+    ocInitSIMDLevel();
+    return g_ocSIMDLevel;
+}
+
+void ocSetSIMDLevel(ocSIMDLevel level)
+{
+    ocInitSIMDLevel();
+    g_ocSIMDLevel = ocMin(level, g_ocSupportedSIMDLevel);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Batched Transforms
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// The SIMD paths work on columns of 4 or 8 matrices at a time, one element per register, and are transposed on the way in and out. The
+// scalar path does the same operations in the same order so that every path gives the same results. It's also used for the remainder.
+
+#ifdef OC_SUPPORT_SSE2
+OC_INLINE void ocLoadTransposed4(const float* pMatrices, ocUInt32 column, __m128* pX, __m128* pY, __m128* pZ, __m128* pW)
+{
+    __m128 x = _mm_loadu_ps(pMatrices + 0*16 + column*4);
+    __m128 y = _mm_loadu_ps(pMatrices + 1*16 + column*4);
+    __m128 z = _mm_loadu_ps(pMatrices + 2*16 + column*4);
+    __m128 w = _mm_loadu_ps(pMatrices + 3*16 + column*4);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+
+    *pX = x;
+    *pY = y;
+    *pZ = z;
+    *pW = w;
+}
+
+OC_INLINE void ocStoreTransposed4(float* pMatrices, ocUInt32 column, __m128 x, __m128 y, __m128 z, __m128 w)
+{
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(pMatrices + 0*16 + column*4, x);
+    _mm_storeu_ps(pMatrices + 1*16 + column*4, y);
+    _mm_storeu_ps(pMatrices + 2*16 + column*4, z);
+    _mm_storeu_ps(pMatrices + 3*16 + column*4, w);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_INLINE __m256 ocCombine8(__m128 lo, __m128 hi)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+OC_AVX2_FUNCTION OC_INLINE void ocLoadTransposed8(const float* pMatrices, ocUInt32 column, __m256* pX, __m256* pY, __m256* pZ, __m256* pW)
+{
+    __m128 x0, y0, z0, w0;
+    __m128 x1, y1, z1, w1;
+    ocLoadTransposed4(pMatrices + 0*16, column, &x0, &y0, &z0, &w0);
+    ocLoadTransposed4(pMatrices + 4*16, column, &x1, &y1, &z1, &w1);
+
+    *pX = ocCombine8(x0, x1);
+    *pY = ocCombine8(y0, y1);
+    *pZ = ocCombine8(z0, z1);
+    *pW = ocCombine8(w0, w1);
+}
+
+OC_AVX2_FUNCTION OC_INLINE void ocStoreTransposed8(float* pMatrices, ocUInt32 column, __m256 x, __m256 y, __m256 z, __m256 w)
+{
+    ocStoreTransposed4(pMatrices + 0*16, column, _mm256_castps256_ps128(x),   _mm256_castps256_ps128(y),   _mm256_castps256_ps128(z),   _mm256_castps256_ps128(w));
+    ocStoreTransposed4(pMatrices + 4*16, column, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1));
+}
+#endif
+
+
+//// ocMakeMat4Array ////
+
+OC_PRIVATE void ocMakeMat4Array_Scalar(const ocTransformArray* pTransforms, ocUInt32 iBegin, ocUInt32 iEnd, float* pMatrices)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        float x = pTransforms->rotation.pX[i];
+        float y = pTransforms->rotation.pY[i];
+        float z = pTransforms->rotation.pZ[i];
+        float w = pTransforms->rotation.pW[i];
+        float sx = pTransforms->scale.pX[i];
+        float sy = pTransforms->scale.pY[i];
+        float sz = pTransforms->scale.pZ[i];
+
+        float x2 = x + x;
+        float y2 = y + y;
+        float z2 = z + z;
+        float xx = x*x2;
+        float yy = y*y2;
+        float zz = z*z2;
+        float xy = x*y2;
+        float xz = x*z2;
+        float yz = y*z2;
+        float wx = w*x2;
+        float wy = w*y2;
+        float wz = w*z2;
+
+        float* pMatrix = pMatrices + i*16;
+        pMatrix[ 0] = (1 - (yy + zz)) * sx;
+        pMatrix[ 1] = (xy + wz) * sx;
+        pMatrix[ 2] = (xz - wy) * sx;
+        pMatrix[ 3] = 0;
+        pMatrix[ 4] = (xy - wz) * sy;
+        pMatrix[ 5] = (1 - (xx + zz)) * sy;
+        pMatrix[ 6] = (yz + wx) * sy;
+        pMatrix[ 7] = 0;
+        pMatrix[ 8] = (xz + wy) * sz;
+        pMatrix[ 9] = (yz - wx) * sz;
+        pMatrix[10] = (1 - (xx + yy)) * sz;
+        pMatrix[11] = 0;
+        pMatrix[12] = pTransforms->position.pX[i];
+        pMatrix[13] = pTransforms->position.pY[i];
+        pMatrix[14] = pTransforms->position.pZ[i];
+        pMatrix[15] = 1;
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE void ocMakeMat4Array_SSE2(const ocTransformArray* pTransforms, ocUInt32 count, float* pMatrices)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one  = _mm_set1_ps(1);
+
+    ocUInt32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(pTransforms->rotation.pX + i);
+        __m128 y = _mm_loadu_ps(pTransforms->rotation.pY + i);
+        __m128 z = _mm_loadu_ps(pTransforms->rotation.pZ + i);
+        __m128 w = _mm_loadu_ps(pTransforms->rotation.pW + i);
+        __m128 sx = _mm_loadu_ps(pTransforms->scale.pX + i);
+        __m128 sy = _mm_loadu_ps(pTransforms->scale.pY + i);
+        __m128 sz = _mm_loadu_ps(pTransforms->scale.pZ + i);
+
+        __m128 x2 = _mm_add_ps(x, x);
+        __m128 y2 = _mm_add_ps(y, y);
+        __m128 z2 = _mm_add_ps(z, z);
+        __m128 xx = _mm_mul_ps(x, x2);
+        __m128 yy = _mm_mul_ps(y, y2);
+        __m128 zz = _mm_mul_ps(z, z2);
+        __m128 xy = _mm_mul_ps(x, y2);
+        __m128 xz = _mm_mul_ps(x, z2);
+        __m128 yz = _mm_mul_ps(y, z2);
+        __m128 wx = _mm_mul_ps(w, x2);
+        __m128 wy = _mm_mul_ps(w, y2);
+        __m128 wz = _mm_mul_ps(w, z2);
+
+        float* pMatrix = pMatrices + i*16;
+        ocStoreTransposed4(pMatrix, 0, _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx), _mm_mul_ps(_mm_add_ps(xy, wz), sx), _mm_mul_ps(_mm_sub_ps(xz, wy), sx), zero);
+        ocStoreTransposed4(pMatrix, 1, _mm_mul_ps(_mm_sub_ps(xy, wz), sy), _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy), _mm_mul_ps(_mm_add_ps(yz, wx), sy), zero);
+        ocStoreTransposed4(pMatrix, 2, _mm_mul_ps(_mm_add_ps(xz, wy), sz), _mm_mul_ps(_mm_sub_ps(yz, wx), sz), _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz), zero);
+        ocStoreTransposed4(pMatrix, 3, _mm_loadu_ps(pTransforms->position.pX + i), _mm_loadu_ps(pTransforms->position.pY + i), _mm_loadu_ps(pTransforms->position.pZ + i), one);
+    }
+
+    ocMakeMat4Array_Scalar(pTransforms, i, count, pMatrices);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE void ocMakeMat4Array_AVX2(const ocTransformArray* pTransforms, ocUInt32 count, float* pMatrices)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one  = _mm256_set1_ps(1);
+
+    ocUInt32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(pTransforms->rotation.pX + i);
+        __m256 y = _mm256_loadu_ps(pTransforms->rotation.pY + i);
+        __m256 z = _mm256_loadu_ps(pTransforms->rotation.pZ + i);
+        __m256 w = _mm256_loadu_ps(pTransforms->rotation.pW + i);
+        __m256 sx = _mm256_loadu_ps(pTransforms->scale.pX + i);
+        __m256 sy = _mm256_loadu_ps(pTransforms->scale.pY + i);
+        __m256 sz = _mm256_loadu_ps(pTransforms->scale.pZ + i);
+
+        __m256 x2 = _mm256_add_ps(x, x);
+        __m256 y2 = _mm256_add_ps(y, y);
+        __m256 z2 = _mm256_add_ps(z, z);
+        __m256 xx = _mm256_mul_ps(x, x2);
+        __m256 yy = _mm256_mul_ps(y, y2);
+        __m256 zz = _mm256_mul_ps(z, z2);
+        __m256 xy = _mm256_mul_ps(x, y2);
+        __m256 xz = _mm256_mul_ps(x, z2);
+        __m256 yz = _mm256_mul_ps(y, z2);
+        __m256 wx = _mm256_mul_ps(w, x2);
+        __m256 wy = _mm256_mul_ps(w, y2);
+        __m256 wz = _mm256_mul_ps(w, z2);
+
+        float* pMatrix = pMatrices + i*16;
+        ocStoreTransposed8(pMatrix, 0, _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx), _mm256_mul_ps(_mm256_add_ps(xy, wz), sx), _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx), zero);
+        ocStoreTransposed8(pMatrix, 1, _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy), _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy), _mm256_mul_ps(_mm256_add_ps(yz, wx), sy), zero);
+        ocStoreTransposed8(pMatrix, 2, _mm256_mul_ps(_mm256_add_ps(xz, wy), sz), _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz), _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz), zero);
+        ocStoreTransposed8(pMatrix, 3, _mm256_loadu_ps(pTransforms->position.pX + i), _mm256_loadu_ps(pTransforms->position.pY + i), _mm256_loadu_ps(pTransforms->position.pZ + i), one);
+    }
+
+    ocMakeMat4Array_Scalar(pTransforms, i, count, pMatrices);
+}
+#endif
+
+void ocMakeMat4Array(const ocTransformArray* pTransforms, ocUInt32 count, glm::mat4* pMatrices)
+{
+    ocAssert(pTransforms != NULL);
+    ocAssert(pMatrices != NULL || count == 0);
+
+    float* pMatrixData = (float*)pMatrices;
+
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocMakeMat4Array_AVX2(pTransforms, count, pMatrixData);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocMakeMat4Array_SSE2(pTransforms, count, pMatrixData);
+        return;
+    }
+#endif
+
+    ocMakeMat4Array_Scalar(pTransforms, 0, count, pMatrixData);
+}
+
+
+//// ocQuatMultiplyArray ////
+
+OC_PRIVATE void ocQuatMultiplyArray_Scalar(const ocQuatArray* pA, const ocQuatArray* pB, ocUInt32 iBegin, ocUInt32 iEnd, ocQuatArray* pResult)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        float ax = pA->pX[i];
+        float ay = pA->pY[i];
+        float az = pA->pZ[i];
+        float aw = pA->pW[i];
+        float bx = pB->pX[i];
+        float by = pB->pY[i];
+        float bz = pB->pZ[i];
+        float bw = pB->pW[i];
+
+        pResult->pX[i] = ((aw*bx + ax*bw) + ay*bz) - az*by;
+        pResult->pY[i] = ((aw*by + ay*bw) + az*bx) - ax*bz;
+        pResult->pZ[i] = ((aw*bz + az*bw) + ax*by) - ay*bx;
+        pResult->pW[i] = ((aw*bw - ax*bx) - ay*by) - az*bz;
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_INLINE void ocQuatMultiply4(__m128 ax, __m128 ay, __m128 az, __m128 aw, __m128 bx, __m128 by, __m128 bz, __m128 bw, __m128* pX, __m128* pY, __m128* pZ, __m128* pW)
+{
+    *pX = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, bx), _mm_mul_ps(ax, bw)), _mm_mul_ps(ay, bz)), _mm_mul_ps(az, by));
+    *pY = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, by), _mm_mul_ps(ay, bw)), _mm_mul_ps(az, bx)), _mm_mul_ps(ax, bz));
+    *pZ = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(aw, bz), _mm_mul_ps(az, bw)), _mm_mul_ps(ax, by)), _mm_mul_ps(ay, bx));
+    *pW = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(aw, bw), _mm_mul_ps(ax, bx)), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+}
+
+OC_PRIVATE void ocQuatMultiplyArray_SSE2(const ocQuatArray* pA, const ocQuatArray* pB, ocUInt32 count, ocQuatArray* pResult)
+{
+    ocUInt32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z, w;
+        ocQuatMultiply4(
+            _mm_loadu_ps(pA->pX + i), _mm_loadu_ps(pA->pY + i), _mm_loadu_ps(pA->pZ + i), _mm_loadu_ps(pA->pW + i),
+            _mm_loadu_ps(pB->pX + i), _mm_loadu_ps(pB->pY + i), _mm_loadu_ps(pB->pZ + i), _mm_loadu_ps(pB->pW + i),
+            &x, &y, &z, &w);
+
+        _mm_storeu_ps(pResult->pX + i, x);
+        _mm_storeu_ps(pResult->pY + i, y);
+        _mm_storeu_ps(pResult->pZ + i, z);
+        _mm_storeu_ps(pResult->pW + i, w);
+    }
+
+    ocQuatMultiplyArray_Scalar(pA, pB, i, count, pResult);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_INLINE void ocQuatMultiply8(__m256 ax, __m256 ay, __m256 az, __m256 aw, __m256 bx, __m256 by, __m256 bz, __m256 bw, __m256* pX, __m256* pY, __m256* pZ, __m256* pW)
+{
+    *pX = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(aw, bx), _mm256_mul_ps(ax, bw)), _mm256_mul_ps(ay, bz)), _mm256_mul_ps(az, by));
+    *pY = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(aw, by), _mm256_mul_ps(ay, bw)), _mm256_mul_ps(az, bx)), _mm256_mul_ps(ax, bz));
+    *pZ = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(aw, bz), _mm256_mul_ps(az, bw)), _mm256_mul_ps(ax, by)), _mm256_mul_ps(ay, bx));
+    *pW = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_mul_ps(aw, bw), _mm256_mul_ps(ax, bx)), _mm256_mul_ps(ay, by)), _mm256_mul_ps(az, bz));
+}
+
+OC_AVX2_FUNCTION OC_PRIVATE void ocQuatMultiplyArray_AVX2(const ocQuatArray* pA, const ocQuatArray* pB, ocUInt32 count, ocQuatArray* pResult)
+{
+    ocUInt32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z, w;
+        ocQuatMultiply8(
+            _mm256_loadu_ps(pA->pX + i), _mm256_loadu_ps(pA->pY + i), _mm256_loadu_ps(pA->pZ + i), _mm256_loadu_ps(pA->pW + i),
+            _mm256_loadu_ps(pB->pX + i), _mm256_loadu_ps(pB->pY + i), _mm256_loadu_ps(pB->pZ + i), _mm256_loadu_ps(pB->pW + i),
+            &x, &y, &z, &w);
+
+        _mm256_storeu_ps(pResult->pX + i, x);
+        _mm256_storeu_ps(pResult->pY + i, y);
+        _mm256_storeu_ps(pResult->pZ + i, z);
+        _mm256_storeu_ps(pResult->pW + i, w);
+    }
+
+    ocQuatMultiplyArray_Scalar(pA, pB, i, count, pResult);
+}
+#endif
+
+void ocQuatMultiplyArray(const ocQuatArray* pA, const ocQuatArray* pB, ocUInt32 count, ocQuatArray* pResult)
+{
+    ocAssert(pA != NULL);
+    ocAssert(pB != NULL);
+    ocAssert(pResult != NULL);
+
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocQuatMultiplyArray_AVX2(pA, pB, count, pResult);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocQuatMultiplyArray_SSE2(pA, pB, count, pResult);
+        return;
+    }
+#endif
+
+    ocQuatMultiplyArray_Scalar(pA, pB, 0, count, pResult);
+}
+
+
+//// ocMakeAbsoluteTransformArray ////
+
+OC_PRIVATE void ocMakeAbsoluteTransformArray_Scalar(const ocTransformArray* pRelative, const ocTransformArray* pParents, ocUInt32 iBegin, ocUInt32 iEnd, ocTransformArray* pAbsolute)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        pAbsolute->position.pX[i] = pParents->position.pX[i] + pRelative->position.pX[i];
+        pAbsolute->position.pY[i] = pParents->position.pY[i] + pRelative->position.pY[i];
+        pAbsolute->position.pZ[i] = pParents->position.pZ[i] + pRelative->position.pZ[i];
+        pAbsolute->scale.pX[i] = pParents->scale.pX[i] * pRelative->scale.pX[i];
+        pAbsolute->scale.pY[i] = pParents->scale.pY[i] * pRelative->scale.pY[i];
+        pAbsolute->scale.pZ[i] = pParents->scale.pZ[i] * pRelative->scale.pZ[i];
+    }
+
+    ocQuatMultiplyArray_Scalar(&pParents->rotation, &pRelative->rotation, iBegin, iEnd, &pAbsolute->rotation);
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE void ocMakeAbsoluteTransformArray_SSE2(const ocTransformArray* pRelative, const ocTransformArray* pParents, ocUInt32 count, ocTransformArray* pAbsolute)
+{
+    ocUInt32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(pAbsolute->position.pX + i, _mm_add_ps(_mm_loadu_ps(pParents->position.pX + i), _mm_loadu_ps(pRelative->position.pX + i)));
+        _mm_storeu_ps(pAbsolute->position.pY + i, _mm_add_ps(_mm_loadu_ps(pParents->position.pY + i), _mm_loadu_ps(pRelative->position.pY + i)));
+        _mm_storeu_ps(pAbsolute->position.pZ + i, _mm_add_ps(_mm_loadu_ps(pParents->position.pZ + i), _mm_loadu_ps(pRelative->position.pZ + i)));
+        _mm_storeu_ps(pAbsolute->scale.pX + i, _mm_mul_ps(_mm_loadu_ps(pParents->scale.pX + i), _mm_loadu_ps(pRelative->scale.pX + i)));
+        _mm_storeu_ps(pAbsolute->scale.pY + i, _mm_mul_ps(_mm_loadu_ps(pParents->scale.pY + i), _mm_loadu_ps(pRelative->scale.pY + i)));
+        _mm_storeu_ps(pAbsolute->scale.pZ + i, _mm_mul_ps(_mm_loadu_ps(pParents->scale.pZ + i), _mm_loadu_ps(pRelative->scale.pZ + i)));
+
+        __m128 x, y, z, w;
+        ocQuatMultiply4(
+            _mm_loadu_ps(pParents->rotation.pX + i),  _mm_loadu_ps(pParents->rotation.pY + i),  _mm_loadu_ps(pParents->rotation.pZ + i),  _mm_loadu_ps(pParents->rotation.pW + i),
+            _mm_loadu_ps(pRelative->rotation.pX + i), _mm_loadu_ps(pRelative->rotation.pY + i), _mm_loadu_ps(pRelative->rotation.pZ + i), _mm_loadu_ps(pRelative->rotation.pW + i),
+            &x, &y, &z, &w);
+
+        _mm_storeu_ps(pAbsolute->rotation.pX + i, x);
+        _mm_storeu_ps(pAbsolute->rotation.pY + i, y);
+        _mm_storeu_ps(pAbsolute->rotation.pZ + i, z);
+        _mm_storeu_ps(pAbsolute->rotation.pW + i, w);
+    }
+
+    ocMakeAbsoluteTransformArray_Scalar(pRelative, pParents, i, count, pAbsolute);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE void ocMakeAbsoluteTransformArray_AVX2(const ocTransformArray* pRelative, const ocTransformArray* pParents, ocUInt32 count, ocTransformArray* pAbsolute)
+{
+    ocUInt32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(pAbsolute->position.pX + i, _mm256_add_ps(_mm256_loadu_ps(pParents->position.pX + i), _mm256_loadu_ps(pRelative->position.pX + i)));
+        _mm256_storeu_ps(pAbsolute->position.pY + i, _mm256_add_ps(_mm256_loadu_ps(pParents->position.pY + i), _mm256_loadu_ps(pRelative->position.pY + i)));
+        _mm256_storeu_ps(pAbsolute->position.pZ + i, _mm256_add_ps(_mm256_loadu_ps(pParents->position.pZ + i), _mm256_loadu_ps(pRelative->position.pZ + i)));
+        _mm256_storeu_ps(pAbsolute->scale.pX + i, _mm256_mul_ps(_mm256_loadu_ps(pParents->scale.pX + i), _mm256_loadu_ps(pRelative->scale.pX + i)));
+        _mm256_storeu_ps(pAbsolute->scale.pY + i, _mm256_mul_ps(_mm256_loadu_ps(pParents->scale.pY + i), _mm256_loadu_ps(pRelative->scale.pY + i)));
+        _mm256_storeu_ps(pAbsolute->scale.pZ + i, _mm256_mul_ps(_mm256_loadu_ps(pParents->scale.pZ + i), _mm256_loadu_ps(pRelative->scale.pZ + i)));
+
+        __m256 x, y, z, w;
+        ocQuatMultiply8(
+            _mm256_loadu_ps(pParents->rotation.pX + i),  _mm256_loadu_ps(pParents->rotation.pY + i),  _mm256_loadu_ps(pParents->rotation.pZ + i),  _mm256_loadu_ps(pParents->rotation.pW + i),
+            _mm256_loadu_ps(pRelative->rotation.pX + i), _mm256_loadu_ps(pRelative->rotation.pY + i), _mm256_loadu_ps(pRelative->rotation.pZ + i), _mm256_loadu_ps(pRelative->rotation.pW + i),
+            &x, &y, &z, &w);
+
+        _mm256_storeu_ps(pAbsolute->rotation.pX + i, x);
+        _mm256_storeu_ps(pAbsolute->rotation.pY + i, y);
+        _mm256_storeu_ps(pAbsolute->rotation.pZ + i, z);
+        _mm256_storeu_ps(pAbsolute->rotation.pW + i, w);
+    }
+
+    ocMakeAbsoluteTransformArray_Scalar(pRelative, pParents, i, count, pAbsolute);
+}
+#endif
+
+void ocMakeAbsoluteTransformArray(const ocTransformArray* pRelative, const ocTransformArray* pParents, ocUInt32 count, ocTransformArray* pAbsolute)
+{
+    ocAssert(pRelative != NULL);
+    ocAssert(pParents != NULL);
+    ocAssert(pAbsolute != NULL);
+
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocMakeAbsoluteTransformArray_AVX2(pRelative, pParents, count, pAbsolute);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocMakeAbsoluteTransformArray_SSE2(pRelative, pParents, count, pAbsolute);
+        return;
+    }
+#endif
+
+    ocMakeAbsoluteTransformArray_Scalar(pRelative, pParents, 0, count, pAbsolute);
+}
+
+
+//// ocInverseAffineMat4Array ////
+
+// The inverse of the upper 3x3 is found with cross products of it's columns, a, b and c. The rows of the inverse are (b x c), (c x a)
+// and (a x b), divided by the determinant. The translation is then the negated translation multiplied by the inverse.
+
+OC_PRIVATE void ocInverseAffineMat4Array_Scalar(const float* pMatrices, ocUInt32 iBegin, ocUInt32 iEnd, float* pResult)
+{
+    for (ocUInt32 i = iBegin; i < iEnd; ++i) {
+        const float* pMatrix = pMatrices + i*16;
+        float ax = pMatrix[ 0], ay = pMatrix[ 1], az = pMatrix[ 2];
+        float bx = pMatrix[ 4], by = pMatrix[ 5], bz = pMatrix[ 6];
+        float cx = pMatrix[ 8], cy = pMatrix[ 9], cz = pMatrix[10];
+        float tx = pMatrix[12], ty = pMatrix[13], tz = pMatrix[14];
+
+        float r0x = by*cz - bz*cy;
+        float r0y = bz*cx - bx*cz;
+        float r0z = bx*cy - by*cx;
+        float r1x = cy*az - cz*ay;
+        float r1y = cz*ax - cx*az;
+        float r1z = cx*ay - cy*ax;
+        float r2x = ay*bz - az*by;
+        float r2y = az*bx - ax*bz;
+        float r2z = ax*by - ay*bx;
+
+        float invDet = 1 / ((ax*r0x + ay*r0y) + az*r0z);
+        r0x *= invDet; r0y *= invDet; r0z *= invDet;
+        r1x *= invDet; r1y *= invDet; r1z *= invDet;
+        r2x *= invDet; r2y *= invDet; r2z *= invDet;
+
+        float* pInverse = pResult + i*16;
+        pInverse[ 0] = r0x;
+        pInverse[ 1] = r1x;
+        pInverse[ 2] = r2x;
+        pInverse[ 3] = 0;
+        pInverse[ 4] = r0y;
+        pInverse[ 5] = r1y;
+        pInverse[ 6] = r2y;
+        pInverse[ 7] = 0;
+        pInverse[ 8] = r0z;
+        pInverse[ 9] = r1z;
+        pInverse[10] = r2z;
+        pInverse[11] = 0;
+        pInverse[12] = -((r0x*tx + r0y*ty) + r0z*tz);
+        pInverse[13] = -((r1x*tx + r1y*ty) + r1z*tz);
+        pInverse[14] = -((r2x*tx + r2y*ty) + r2z*tz);
+        pInverse[15] = 1;
+    }
+}
+
+#ifdef OC_SUPPORT_SSE2
+OC_PRIVATE void ocInverseAffineMat4Array_SSE2(const float* pMatrices, ocUInt32 count, float* pResult)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one  = _mm_set1_ps(1);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+
+    ocUInt32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 ax, ay, az, aw;
+        __m128 bx, by, bz, bw;
+        __m128 cx, cy, cz, cw;
+        __m128 tx, ty, tz, tw;
+        ocLoadTransposed4(pMatrices + i*16, 0, &ax, &ay, &az, &aw);
+        ocLoadTransposed4(pMatrices + i*16, 1, &bx, &by, &bz, &bw);
+        ocLoadTransposed4(pMatrices + i*16, 2, &cx, &cy, &cz, &cw);
+        ocLoadTransposed4(pMatrices + i*16, 3, &tx, &ty, &tz, &tw);
+
+        __m128 r0x = _mm_sub_ps(_mm_mul_ps(by, cz), _mm_mul_ps(bz, cy));
+        __m128 r0y = _mm_sub_ps(_mm_mul_ps(bz, cx), _mm_mul_ps(bx, cz));
+        __m128 r0z = _mm_sub_ps(_mm_mul_ps(bx, cy), _mm_mul_ps(by, cx));
+        __m128 r1x = _mm_sub_ps(_mm_mul_ps(cy, az), _mm_mul_ps(cz, ay));
+        __m128 r1y = _mm_sub_ps(_mm_mul_ps(cz, ax), _mm_mul_ps(cx, az));
+        __m128 r1z = _mm_sub_ps(_mm_mul_ps(cx, ay), _mm_mul_ps(cy, ax));
+        __m128 r2x = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+        __m128 r2y = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+        __m128 r2z = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+
+        __m128 invDet = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, r0x), _mm_mul_ps(ay, r0y)), _mm_mul_ps(az, r0z)));
+        r0x = _mm_mul_ps(r0x, invDet); r0y = _mm_mul_ps(r0y, invDet); r0z = _mm_mul_ps(r0z, invDet);
+        r1x = _mm_mul_ps(r1x, invDet); r1y = _mm_mul_ps(r1y, invDet); r1z = _mm_mul_ps(r1z, invDet);
+        r2x = _mm_mul_ps(r2x, invDet); r2y = _mm_mul_ps(r2y, invDet); r2z = _mm_mul_ps(r2z, invDet);
+
+        __m128 itx = _mm_xor_ps(sign, _mm_add_ps(_mm_add_ps(_mm_mul_ps(r0x, tx), _mm_mul_ps(r0y, ty)), _mm_mul_ps(r0z, tz)));
+        __m128 ity = _mm_xor_ps(sign, _mm_add_ps(_mm_add_ps(_mm_mul_ps(r1x, tx), _mm_mul_ps(r1y, ty)), _mm_mul_ps(r1z, tz)));
+        __m128 itz = _mm_xor_ps(sign, _mm_add_ps(_mm_add_ps(_mm_mul_ps(r2x, tx), _mm_mul_ps(r2y, ty)), _mm_mul_ps(r2z, tz)));
+
+        ocStoreTransposed4(pResult + i*16, 0, r0x, r1x, r2x, zero);
+        ocStoreTransposed4(pResult + i*16, 1, r0y, r1y, r2y, zero);
+        ocStoreTransposed4(pResult + i*16, 2, r0z, r1z, r2z, zero);
+        ocStoreTransposed4(pResult + i*16, 3, itx, ity, itz, one);
+    }
+
+    ocInverseAffineMat4Array_Scalar(pMatrices, i, count, pResult);
+}
+#endif
+
+#ifdef OC_SUPPORT_AVX2
+OC_AVX2_FUNCTION OC_PRIVATE void ocInverseAffineMat4Array_AVX2(const float* pMatrices, ocUInt32 count, float* pResult)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one  = _mm256_set1_ps(1);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    ocUInt32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 ax, ay, az, aw;
+        __m256 bx, by, bz, bw;
+        __m256 cx, cy, cz, cw;
+        __m256 tx, ty, tz, tw;
+        ocLoadTransposed8(pMatrices + i*16, 0, &ax, &ay, &az, &aw);
+        ocLoadTransposed8(pMatrices + i*16, 1, &bx, &by, &bz, &bw);
+        ocLoadTransposed8(pMatrices + i*16, 2, &cx, &cy, &cz, &cw);
+        ocLoadTransposed8(pMatrices + i*16, 3, &tx, &ty, &tz, &tw);
+
+        __m256 r0x = _mm256_sub_ps(_mm256_mul_ps(by, cz), _mm256_mul_ps(bz, cy));
+        __m256 r0y = _mm256_sub_ps(_mm256_mul_ps(bz, cx), _mm256_mul_ps(bx, cz));
+        __m256 r0z = _mm256_sub_ps(_mm256_mul_ps(bx, cy), _mm256_mul_ps(by, cx));
+        __m256 r1x = _mm256_sub_ps(_mm256_mul_ps(cy, az), _mm256_mul_ps(cz, ay));
+        __m256 r1y = _mm256_sub_ps(_mm256_mul_ps(cz, ax), _mm256_mul_ps(cx, az));
+        __m256 r1z = _mm256_sub_ps(_mm256_mul_ps(cx, ay), _mm256_mul_ps(cy, ax));
+        __m256 r2x = _mm256_sub_ps(_mm256_mul_ps(ay, bz), _mm256_mul_ps(az, by));
+        __m256 r2y = _mm256_sub_ps(_mm256_mul_ps(az, bx), _mm256_mul_ps(ax, bz));
+        __m256 r2z = _mm256_sub_ps(_mm256_mul_ps(ax, by), _mm256_mul_ps(ay, bx));
+
+        __m256 invDet = _mm256_div_ps(one, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, r0x), _mm256_mul_ps(ay, r0y)), _mm256_mul_ps(az, r0z)));
+        r0x = _mm256_mul_ps(r0x, invDet); r0y = _mm256_mul_ps(r0y, invDet); r0z = _mm256_mul_ps(r0z, invDet);
+        r1x = _mm256_mul_ps(r1x, invDet); r1y = _mm256_mul_ps(r1y, invDet); r1z = _mm256_mul_ps(r1z, invDet);
+        r2x = _mm256_mul_ps(r2x, invDet); r2y = _mm256_mul_ps(r2y, invDet); r2z = _mm256_mul_ps(r2z, invDet);
+
+        __m256 itx = _mm256_xor_ps(sign, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r0x, tx), _mm256_mul_ps(r0y, ty)), _mm256_mul_ps(r0z, tz)));
+        __m256 ity = _mm256_xor_ps(sign, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r1x, tx), _mm256_mul_ps(r1y, ty)), _mm256_mul_ps(r1z, tz)));
+        __m256 itz = _mm256_xor_ps(sign, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r2x, tx), _mm256_mul_ps(r2y, ty)), _mm256_mul_ps(r2z, tz)));
+
+        ocStoreTransposed8(pResult + i*16, 0, r0x, r1x, r2x, zero);
+        ocStoreTransposed8(pResult + i*16, 1, r0y, r1y, r2y, zero);
+        ocStoreTransposed8(pResult + i*16, 2, r0z, r1z, r2z, zero);
+        ocStoreTransposed8(pResult + i*16, 3, itx, ity, itz, one);
+    }
+
+    ocInverseAffineMat4Array_Scalar(pMatrices, i, count, pResult);
+}
+#endif
+
+void ocInverseAffineMat4Array(const glm::mat4* pMatrices, ocUInt32 count, glm::mat4* pResult)
+{
+    ocAssert(pMatrices != NULL || count == 0);
+    ocAssert(pResult != NULL || count == 0);
+
+    const float* pMatrixData = (const float*)pMatrices;
+    float* pResultData = (float*)pResult;
+
+#ifdef OC_SUPPORT_AVX2
+    if (ocGetSIMDLevel() == ocSIMDLevel_AVX2) {
+        ocInverseAffineMat4Array_AVX2(pMatrixData, count, pResultData);
+        return;
+    }
+#endif
+#ifdef OC_SUPPORT_SSE2
+    if (ocGetSIMDLevel() == ocSIMDLevel_SSE2) {
+        ocInverseAffineMat4Array_SSE2(pMatrixData, count, pResultData);
+        return;
+    }
+#endif
+
+    ocInverseAffineMat4Array_Scalar(pMatrixData, 0, count, pResultData);
+}
@@ -62,3 +62,69 @@ OC_INLINE glm::vec3 ocMakeRelativeScale(const glm::vec3 &absoluteScale, const gl
 {
     return absoluteScale / relativeTo;
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Batched Transforms
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// These work on many transforms at a time, which is a lot faster than going through glm one object at a time. Positions, rotations and
+// scales are passed in as structures of arrays so that 4 or 8 of them can be loaded into a SIMD register at once. Matrices are arrays of
+// glm::mat4 since that's what the rest of the engine and the GPU want.
+//
+// The code path is chosen at run time based on what the CPU supports. Each path gives exactly the same results as the others.
+
+enum ocSIMDLevel
+{
+    ocSIMDLevel_None,
+    ocSIMDLevel_SSE2,
+    ocSIMDLevel_AVX2
+};
+
+struct ocVec3Array
+{
+    float* pX;
+    float* pY;
+    float* pZ;
+};
+
+struct ocQuatArray
+{
+    float* pX;
+    float* pY;
+    float* pZ;
+    float* pW;
+};
+
+struct ocTransformArray
+{
+    ocVec3Array position;
+    ocQuatArray rotation;
+    ocVec3Array scale;
+};
+
+// Retrieves the best SIMD level supported by the CPU and the compiler.
+ocSIMDLevel ocGetSupportedSIMDLevel();
+
+// Retrieves the SIMD level used by the batched functions. This is the best supported level unless it's been changed with ocSetSIMDLevel().
+ocSIMDLevel ocGetSIMDLevel();
+
+// Changes the SIMD level used by the batched functions. It's clamped to the supported level. This is for benchmarking and for checking
+// the code paths against each other, and is not thread-safe.
+void ocSetSIMDLevel(ocSIMDLevel level);
+
+// Builds a matrix for each transform. This is the same as ocMakeMat4().
+void ocMakeMat4Array(const ocTransformArray* pTransforms, ocUInt32 count, glm::mat4* pMatrices);
+
+// Multiplies each quaternion in pA by the one at the same index in pB. pResult can be the same as either input.
+void ocQuatMultiplyArray(const ocQuatArray* pA, const ocQuatArray* pB, ocUInt32 count, ocQuatArray* pResult);
+
+// Makes relative transforms absolute. The parent of each transform is at the same index in pParents. This is the same as
+// ocMakeAbsolutePosition(), ocMakeAbsoluteRotation() and ocMakeAbsoluteScale(). pAbsolute can be the same as pRelative.
+void ocMakeAbsoluteTransformArray(const ocTransformArray* pRelative, const ocTransformArray* pParents, ocUInt32 count, ocTransformArray* pAbsolute);
+
+// Inverts affine matrices, which are matrices with a bottom row of (0, 0, 0, 1) like the ones built from a position, rotation and scale.
+// This is cheaper than a general inverse. The matrices must be invertible. pResult can be the same as pMatrices.
+void ocInverseAffineMat4Array(const glm::mat4* pMatrices, ocUInt32 count, glm::mat4* pResult);
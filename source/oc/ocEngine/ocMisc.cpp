@@ -489,3 +489,24 @@ unsigned int ocBitScanReverse64(uint64_t x)
     return 0;
 #endif
 }
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Hashing
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocUInt64 ocHashFNV1a64(const void* pData, ocSizeT dataSize, ocUInt64 seed)
+{
+    const ocUInt8* pBytes = (const ocUInt8*)pData;
+
+    ocUInt64 hash = seed;
+    for (ocSizeT i = 0; i < dataSize; ++i) {
+        hash ^= pBytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
\ No newline at end of file
@@ -114,7 +114,23 @@ OC_INLINE uint64_t ocMaskLSB64(uint64_t x)
 #if defined(OC_WIN32) && defined(_MSC_VER)
 #define ocAtomicIncrement(a) InterlockedIncrement((LONG*)a)
 #define ocAtomicDecrement(a) InterlockedDecrement((LONG*)a)
+#define ocAtomicLoad(a)      InterlockedCompareExchange((LONG*)a, 0, 0)
+#define ocAtomicStore(a, v)  InterlockedExchange((LONG*)a, (LONG)(v))
 #else
 #define ocAtomicIncrement(a) __sync_add_and_fetch(a, 1)
 #define ocAtomicDecrement(a) __sync_sub_and_fetch(a, 1)
-#endif
\ No newline at end of file
+#define ocAtomicLoad(a)      __sync_add_and_fetch(a, 0)
+#define ocAtomicStore(a, v)  __atomic_store_n(a, v, __ATOMIC_SEQ_CST)
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Hashing
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_HASH_FNV1A64_SEED    0xcbf29ce484222325ULL
+
+// 64-bit FNV-1a. Pass the result of a previous call as the seed to hash data incrementally.
+ocUInt64 ocHashFNV1a64(const void* pData, ocSizeT dataSize, ocUInt64 seed = OC_HASH_FNV1A64_SEED);
\ No newline at end of file
@@ -0,0 +1,1149 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// The size of the text buffer is this multiplied by the number of chunks in a batch, which is one more than the number of worker
+// threads since the calling thread helps out while it waits.
+#define OC_OBJ_CHUNK_SIZE                   (4*1024*1024)
+
+// Batches are split evenly between threads, but chunks are never made smaller than this.
+#define OC_OBJ_MIN_CHUNK_SIZE               (64*1024)
+
+// Extra bytes allocated past the end of the text buffer. The number parser reads 8 bytes at a time, and a new line needs to be
+// appended to the last line of the file if it doesn't already have one.
+#define OC_OBJ_TEXT_PADDING                 16
+
+#define OC_OBJ_NO_INDEX                     0xFFFFFFFF
+
+#define OC_OBJ_FACE_VERTEX_RELATIVE_POSITION 0x00000001
+#define OC_OBJ_FACE_VERTEX_RELATIVE_TEXCOORD 0x00000002
+#define OC_OBJ_FACE_VERTEX_RELATIVE_NORMAL   0x00000004
+
+// A vertex of a face as it's written in the file. An index of 0 means the attribute was not specified. Relative (negative) indices
+// are made relative to the start of the chunk and flagged, because the number of elements in previous chunks is not known until the
+// chunks are merged.
+struct ocOBJFaceVertex
+{
+    ocInt32 position;
+    ocInt32 texcoord;
+    ocInt32 normal;
+    ocUInt32 flags;
+};
+
+struct ocOBJMaterialSwitch
+{
+    ocUInt32 faceIndex;     // The index of the first face in the chunk that uses the material.
+    ocUInt32 nameOffset;    // Offset of the name in the chunk's name buffer.
+    ocBool32 isLibrary;     // Set for mtllib statements, in which case the name is the file of the library rather than a material.
+};
+
+struct ocOBJChunk
+{
+    const char* pText;
+    const char* pTextEnd;   // Always the character after a new line.
+    ocStack<float> positions;
+    ocStack<float> texcoords;
+    ocStack<float> normals;
+    ocStack<ocOBJFaceVertex> faceVertices;
+    ocStack<ocUInt32> faceVertexCounts;
+    ocStack<ocOBJMaterialSwitch> materialSwitches;
+    ocStack<char> names;
+    ocResult result;
+};
+
+struct ocOBJVertexCacheEntry
+{
+    ocUInt32 position;
+    ocUInt32 texcoord;
+    ocUInt32 normal;
+    ocUInt32 index;         // OC_OBJ_NO_INDEX when the slot is empty.
+};
+
+struct ocOBJMeshGroup
+{
+    char* materialName;
+    ocStack<float> vertexData;      // P3T2N3
+    ocStack<ocUInt32> indexData;
+    ocOBJVertexCacheEntry* pVertexCache;
+    ocUInt32 vertexCacheCapacity;   // Always a power of 2.
+    ocUInt32 vertexCount;
+};
+
+struct ocOBJImporter
+{
+    ocStack<float> positions;
+    ocStack<float> texcoords;
+    ocStack<float> normals;
+    ocStack<ocOBJMeshGroup> groups;
+    ocUInt32 currentGroupIndex;     // OC_OBJ_NO_INDEX until the first usemtl statement or face.
+    char* materialLibrary;          // NULL until the first mtllib statement.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tokenizing
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Numbers are parsed 8 digits at a time using plain 64-bit arithmetic which works on every platform we support. Number parsing is
+// where most of the time is spent when importing large files. This assumes little-endian, as does the rest of the engine.
+OC_INLINE ocUInt64 ocOBJLoadEightChars(const char* p)
+{
+    ocUInt64 chars;
+    ocCopyMemory(&chars, p, 8);
+    return chars;
+}
+
+OC_INLINE ocBool32 ocOBJIsEightDigits(ocUInt64 chars)
+{
+    return (((chars & 0xF0F0F0F0F0F0F0F0ULL) | (((chars + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL);
+}
+
+OC_INLINE ocUInt32 ocOBJParseEightDigits(ocUInt64 chars)
+{
+    chars -= 0x3030303030303030ULL;
+    chars  = (chars * 10) + (chars >> 8);
+    chars  = (((chars & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) + (((chars >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return (ocUInt32)chars;
+}
+
+OC_INLINE ocBool32 ocOBJIsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+OC_INLINE ocBool32 ocOBJIsSpace(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+OC_INLINE const char* ocOBJSkipSpaces(const char* p)
+{
+    while (ocOBJIsSpace(*p)) {
+        p += 1;
+    }
+
+    return p;
+}
+
+// Accumulates digits into the mantissa. Digits past the 19th are counted but not accumulated because they may not fit.
+OC_PRIVATE const char* ocOBJParseDigits(const char* p, ocUInt64* pMantissa, ocUInt32* pDigitCount)
+{
+    ocUInt64 mantissa = *pMantissa;
+    ocUInt32 digitCount = *pDigitCount;
+
+    while (digitCount + 8 <= 19) {
+        ocUInt64 chars = ocOBJLoadEightChars(p);
+        if (!ocOBJIsEightDigits(chars)) {
+            break;
+        }
+
+        mantissa = (mantissa * 100000000) + ocOBJParseEightDigits(chars);
+        digitCount += 8;
+        p += 8;
+    }
+
+    while (ocOBJIsDigit(*p)) {
+        if (digitCount < 19) {
+            mantissa = (mantissa * 10) + (ocUInt64)(*p - '0');
+        }
+
+        digitCount += 1;
+        p += 1;
+    }
+
+    *pMantissa = mantissa;
+    *pDigitCount = digitCount;
+    return p;
+}
+
+// Parses a floating point number, returning a pointer to the character after it. If there is no number the value is set to 0 and
+// the returned pointer is at the first non-space character.
+OC_PRIVATE const char* ocOBJParseFloat(const char* p, float* pValue)
+{
+    static const double powersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    p = ocOBJSkipSpaces(p);
+    const char* pStart = p;
+
+    ocBool32 isNegative = (*p == '-');
+    if (*p == '-' || *p == '+') {
+        p += 1;
+    }
+
+    ocUInt64 mantissa = 0;
+    ocUInt32 digitCount = 0;
+    ocInt32 exponent = 0;
+
+    p = ocOBJParseDigits(p, &mantissa, &digitCount);
+    if (*p == '.') {
+        p += 1;
+
+        const char* pFraction = p;
+        p = ocOBJParseDigits(p, &mantissa, &digitCount);
+        exponent -= (ocInt32)(p - pFraction);
+    }
+
+    if (digitCount == 0) {
+        *pValue = 0;
+        return pStart;
+    }
+
+    if (*p == 'e' || *p == 'E') {
+        const char* pExponent = p + 1;
+
+        ocBool32 isExponentNegative = (*pExponent == '-');
+        if (*pExponent == '-' || *pExponent == '+') {
+            pExponent += 1;
+        }
+
+        if (ocOBJIsDigit(*pExponent)) {
+            ocInt32 explicitExponent = 0;
+            while (ocOBJIsDigit(*pExponent)) {
+                if (explicitExponent < 100000) {
+                    explicitExponent = (explicitExponent * 10) + (*pExponent - '0');
+                }
+                pExponent += 1;
+            }
+
+            exponent += (isExponentNegative) ? -explicitExponent : explicitExponent;
+            p = pExponent;
+        }
+    }
+
+    // When the mantissa and the power of 10 are both exactly representable as doubles the result of a single multiplication or division
+    // is correctly rounded. Anything else is rare enough that it's not worth doing ourselves.
+    if (digitCount <= 19 && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        double value = (double)mantissa;
+        if (exponent < 0) {
+            value /= powersOf10[-exponent];
+        } else {
+            value *= powersOf10[exponent];
+        }
+
+        *pValue = (float)((isNegative) ? -value : value);
+    } else {
+        *pValue = (float)strtod(pStart, NULL);
+    }
+
+    return p;
+}
+
+OC_PRIVATE const char* ocOBJParseIndex(const char* p, ocInt32* pIndex)
+{
+    ocBool32 isNegative = (*p == '-');
+    if (isNegative) {
+        p += 1;
+    }
+
+    // Out of range indices are clamped which will cause them to be rejected when they're resolved.
+    ocInt64 index = 0;
+    while (ocOBJIsDigit(*p)) {
+        if (index <= INT32_MAX) {
+            index = (index * 10) + (*p - '0');
+        }
+        p += 1;
+    }
+
+    if (index > INT32_MAX) {
+        index = INT32_MAX;
+    }
+
+    *pIndex = (ocInt32)((isNegative) ? -index : index);
+    return p;
+}
+
+// Parses a face vertex in the form of "p", "p/t", "p//n" or "p/t/n".
+OC_PRIVATE const char* ocOBJParseFaceVertex(ocOBJChunk* pChunk, const char* p, ocOBJFaceVertex* pVertex)
+{
+    ocZeroObject(pVertex);
+
+    p = ocOBJParseIndex(p, &pVertex->position);
+    if (*p == '/') {
+        p += 1;
+        if (*p != '/') {
+            p = ocOBJParseIndex(p, &pVertex->texcoord);
+        }
+
+        if (*p == '/') {
+            p += 1;
+            p = ocOBJParseIndex(p, &pVertex->normal);
+        }
+    }
+
+    // -1 refers to the most recently defined element. Here it's made relative to the start of the chunk, which will be negative when it
+    // refers to an element in a previous chunk.
+    if (pVertex->position < 0) {
+        pVertex->position += (ocInt32)(pChunk->positions.count / 3);
+        pVertex->flags |= OC_OBJ_FACE_VERTEX_RELATIVE_POSITION;
+    }
+    if (pVertex->texcoord < 0) {
+        pVertex->texcoord += (ocInt32)(pChunk->texcoords.count / 2);
+        pVertex->flags |= OC_OBJ_FACE_VERTEX_RELATIVE_TEXCOORD;
+    }
+    if (pVertex->normal < 0) {
+        pVertex->normal += (ocInt32)(pChunk->normals.count / 3);
+        pVertex->flags |= OC_OBJ_FACE_VERTEX_RELATIVE_NORMAL;
+    }
+
+    return p;
+}
+
+OC_PRIVATE const char* ocOBJParseFloats(const char* p, ocUInt32 count, ocStack<float>* pStack, ocResult* pResult)
+{
+    float values[3];
+    ocAssert(count <= ocCountOf(values));
+
+    for (ocUInt32 i = 0; i < count; ++i) {
+        p = ocOBJParseFloat(p, &values[i]);
+    }
+
+    *pResult = ocStackPushArray(pStack, values, count);
+    return p;
+}
+
+OC_PRIVATE ocResult ocOBJTokenizeChunk(ocOBJChunk* pChunk)
+{
+    ocAssert(pChunk != NULL);
+
+    ocResult result = OC_SUCCESS;
+
+    const char* p = pChunk->pText;
+    while (p < pChunk->pTextEnd) {
+        p = ocOBJSkipSpaces(p);
+
+        if (p[0] == 'v') {
+            if (ocOBJIsSpace(p[1])) {
+                p = ocOBJParseFloats(p + 1, 3, &pChunk->positions, &result);
+            } else if (p[1] == 't' && ocOBJIsSpace(p[2])) {
+                p = ocOBJParseFloats(p + 2, 2, &pChunk->texcoords, &result);
+            } else if (p[1] == 'n' && ocOBJIsSpace(p[2])) {
+                p = ocOBJParseFloats(p + 2, 3, &pChunk->normals, &result);
+            }
+        } else if (p[0] == 'f' && ocOBJIsSpace(p[1])) {
+            p += 1;
+
+            ocUInt32 faceVertexCount = 0;
+            for (;;) {
+                p = ocOBJSkipSpaces(p);
+                if (!ocOBJIsDigit(*p) && *p != '-') {
+                    break;
+                }
+
+                ocOBJFaceVertex vertex;
+                p = ocOBJParseFaceVertex(pChunk, p, &vertex);
+
+                result = ocStackPush(&pChunk->faceVertices, vertex);
+                if (result != OC_SUCCESS) {
+                    return result;
+                }
+
+                faceVertexCount += 1;
+            }
+
+            result = ocStackPush(&pChunk->faceVertexCounts, faceVertexCount);
+        } else if ((strncmp(p, "usemtl", 6) == 0 || strncmp(p, "mtllib", 6) == 0) && ocOBJIsSpace(p[6])) {
+            ocBool32 isLibrary = p[0] == 'm';
+            p = ocOBJSkipSpaces(p + 6);
+
+            // Material names run to the end of the line. A library statement can list multiple files, but only the first is used.
+            const char* pNameEnd = p;
+            while (*pNameEnd != '\n' && *pNameEnd != '\r' && !(isLibrary && ocOBJIsSpace(*pNameEnd))) {
+                pNameEnd += 1;
+            }
+            while (pNameEnd > p && ocOBJIsSpace(pNameEnd[-1])) {
+                pNameEnd -= 1;
+            }
+
+            ocOBJMaterialSwitch materialSwitch;
+            materialSwitch.faceIndex  = (ocUInt32)pChunk->faceVertexCounts.count;
+            materialSwitch.nameOffset = (ocUInt32)pChunk->names.count;
+            materialSwitch.isLibrary  = isLibrary;
+
+            result = ocStackPush(&pChunk->materialSwitches, materialSwitch);
+            if (result == OC_SUCCESS) {
+                result = ocStackPushArray(&pChunk->names, p, (size_t)(pNameEnd - p));
+            }
+            if (result == OC_SUCCESS) {
+                result = ocStackPush(&pChunk->names, '\0');
+            }
+
+            p = pNameEnd;
+        }
+
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        // Everything else on the line is ignored. Every chunk ends with a new line so this will always find one.
+        p = (const char*)memchr(p, '\n', (size_t)(pChunk->pTextEnd - p));
+        ocAssert(p != NULL);
+        p += 1;
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocOBJTokenizeChunkJobProc(void* pUserData)
+{
+    ocOBJChunk* pChunk = (ocOBJChunk*)pUserData;
+    ocAssert(pChunk != NULL);
+
+    pChunk->result = ocOBJTokenizeChunk(pChunk);
+}
+
+OC_PRIVATE void ocOBJChunkInit(ocOBJChunk* pChunk)
+{
+    ocAssert(pChunk != NULL);
+
+    ocZeroObject(pChunk);
+    ocStackInit(&pChunk->positions);
+    ocStackInit(&pChunk->texcoords);
+    ocStackInit(&pChunk->normals);
+    ocStackInit(&pChunk->faceVertices);
+    ocStackInit(&pChunk->faceVertexCounts);
+    ocStackInit(&pChunk->materialSwitches);
+    ocStackInit(&pChunk->names);
+}
+
+OC_PRIVATE void ocOBJChunkUninit(ocOBJChunk* pChunk)
+{
+    ocAssert(pChunk != NULL);
+
+    ocStackUninit(&pChunk->names);
+    ocStackUninit(&pChunk->materialSwitches);
+    ocStackUninit(&pChunk->faceVertexCounts);
+    ocStackUninit(&pChunk->faceVertices);
+    ocStackUninit(&pChunk->normals);
+    ocStackUninit(&pChunk->texcoords);
+    ocStackUninit(&pChunk->positions);
+}
+
+// Chunks are reused between batches so that their buffers only need to be allocated once.
+OC_PRIVATE void ocOBJChunkReset(ocOBJChunk* pChunk, const char* pText, const char* pTextEnd)
+{
+    ocAssert(pChunk != NULL);
+
+    pChunk->pText    = pText;
+    pChunk->pTextEnd = pTextEnd;
+    pChunk->result   = OC_SUCCESS;
+    ocStackClear(&pChunk->positions);
+    ocStackClear(&pChunk->texcoords);
+    ocStackClear(&pChunk->normals);
+    ocStackClear(&pChunk->faceVertices);
+    ocStackClear(&pChunk->faceVertexCounts);
+    ocStackClear(&pChunk->materialSwitches);
+    ocStackClear(&pChunk->names);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Merging
+//
+///////////////////////////////////////////////////////////////////////////////
+
+OC_PRIVATE void ocOBJImporterInit(ocOBJImporter* pImporter)
+{
+    ocAssert(pImporter != NULL);
+
+    ocZeroObject(pImporter);
+    ocStackInit(&pImporter->positions);
+    ocStackInit(&pImporter->texcoords);
+    ocStackInit(&pImporter->normals);
+    ocStackInit(&pImporter->groups);
+    pImporter->currentGroupIndex = OC_OBJ_NO_INDEX;
+}
+
+// The vertex attributes are only needed while merging. They're freed before the output is allocated to reduce the peak memory usage.
+OC_PRIVATE void ocOBJImporterFreeAttributes(ocOBJImporter* pImporter)
+{
+    ocAssert(pImporter != NULL);
+
+    ocStackUninit(&pImporter->normals);
+    ocStackUninit(&pImporter->texcoords);
+    ocStackUninit(&pImporter->positions);
+    ocStackInit(&pImporter->normals);
+    ocStackInit(&pImporter->texcoords);
+    ocStackInit(&pImporter->positions);
+
+    for (size_t iGroup = 0; iGroup < pImporter->groups.count; ++iGroup) {
+        ocFree(pImporter->groups.pItems[iGroup].pVertexCache);
+        pImporter->groups.pItems[iGroup].pVertexCache = NULL;
+        pImporter->groups.pItems[iGroup].vertexCacheCapacity = 0;
+    }
+}
+
+OC_PRIVATE void ocOBJImporterUninit(ocOBJImporter* pImporter)
+{
+    ocAssert(pImporter != NULL);
+
+    ocOBJImporterFreeAttributes(pImporter);
+
+    for (size_t iGroup = 0; iGroup < pImporter->groups.count; ++iGroup) {
+        ocOBJMeshGroup* pGroup = &pImporter->groups.pItems[iGroup];
+        ocStackUninit(&pGroup->indexData);
+        ocStackUninit(&pGroup->vertexData);
+        ocFree(pGroup->materialName);
+    }
+
+    ocFree(pImporter->materialLibrary);
+    ocStackUninit(&pImporter->groups);
+    ocStackUninit(&pImporter->normals);
+    ocStackUninit(&pImporter->texcoords);
+    ocStackUninit(&pImporter->positions);
+}
+
+OC_PRIVATE ocResult ocOBJImporterSelectMaterial(ocOBJImporter* pImporter, const char* materialName)
+{
+    ocAssert(pImporter != NULL);
+    ocAssert(materialName != NULL);
+
+    // Materials are usually switched between a small number of materials so a linear search is fine.
+    for (size_t iGroup = 0; iGroup < pImporter->groups.count; ++iGroup) {
+        if (strcmp(pImporter->groups.pItems[iGroup].materialName, materialName) == 0) {
+            pImporter->currentGroupIndex = (ocUInt32)iGroup;
+            return OC_SUCCESS;
+        }
+    }
+
+    size_t materialNameSize = strlen(materialName) + 1;
+
+    ocOBJMeshGroup group;
+    ocZeroObject(&group);
+    group.materialName = (char*)ocMalloc(materialNameSize);
+    if (group.materialName == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocCopyMemory(group.materialName, materialName, materialNameSize);
+    ocStackInit(&group.vertexData);
+    ocStackInit(&group.indexData);
+
+    ocResult result = ocStackPush(&pImporter->groups, group);
+    if (result != OC_SUCCESS) {
+        ocFree(group.materialName);
+        return result;
+    }
+
+    pImporter->currentGroupIndex = (ocUInt32)(pImporter->groups.count - 1);
+    return OC_SUCCESS;
+}
+
+// Applies a usemtl or mtllib statement. Materials are referenced by the path of their library followed by their name, the same way
+// files inside an archive are referenced, so that they can be resolved by whatever loads them. Materials that are used before any
+// library has been specified keep their plain name.
+OC_PRIVATE ocResult ocOBJImporterApplyMaterialSwitch(ocOBJImporter* pImporter, const ocOBJChunk* pChunk, const ocOBJMaterialSwitch* pMaterialSwitch)
+{
+    ocAssert(pImporter != NULL);
+    ocAssert(pChunk != NULL);
+    ocAssert(pMaterialSwitch != NULL);
+
+    const char* name = pChunk->names.pItems + pMaterialSwitch->nameOffset;
+
+    if (pMaterialSwitch->isLibrary) {
+        size_t nameSize = strlen(name) + 1;
+        char* materialLibrary = (char*)ocMalloc(nameSize);
+        if (materialLibrary == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+
+        ocCopyMemory(materialLibrary, name, nameSize);
+        ocFree(pImporter->materialLibrary);
+        pImporter->materialLibrary = materialLibrary;
+        return OC_SUCCESS;
+    }
+
+    if (pImporter->materialLibrary == NULL) {
+        return ocOBJImporterSelectMaterial(pImporter, name);
+    }
+
+    char materialPath[OC_MAX_PATH];
+    if (ocPathAppend(materialPath, sizeof(materialPath), pImporter->materialLibrary, name) == 0) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    return ocOBJImporterSelectMaterial(pImporter, materialPath);
+}
+
+OC_INLINE ocUInt32 ocOBJHashVertex(ocUInt32 position, ocUInt32 texcoord, ocUInt32 normal)
+{
+    ocUInt32 hash = (position * 0x9E3779B1) ^ (texcoord * 0x85EBCA77) ^ (normal * 0xC2B2AE3D);
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6D;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+OC_PRIVATE ocResult ocOBJMeshGroupGrowVertexCache(ocOBJMeshGroup* pGroup)
+{
+    ocAssert(pGroup != NULL);
+
+    ocUInt32 newCapacity = (pGroup->vertexCacheCapacity == 0) ? 1024 : pGroup->vertexCacheCapacity*2;
+    if (newCapacity == 0) {
+        return OC_TOO_LARGE;
+    }
+
+    ocOBJVertexCacheEntry* pNewCache = (ocOBJVertexCacheEntry*)ocMalloc(newCapacity * sizeof(*pNewCache));
+    if (pNewCache == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // Setting every byte to 0xFF marks every slot as empty.
+    memset(pNewCache, 0xFF, newCapacity * sizeof(*pNewCache));
+
+    for (ocUInt32 iEntry = 0; iEntry < pGroup->vertexCacheCapacity; ++iEntry) {
+        ocOBJVertexCacheEntry* pEntry = &pGroup->pVertexCache[iEntry];
+        if (pEntry->index != OC_OBJ_NO_INDEX) {
+            ocUInt32 slot = ocOBJHashVertex(pEntry->position, pEntry->texcoord, pEntry->normal) & (newCapacity - 1);
+            while (pNewCache[slot].index != OC_OBJ_NO_INDEX) {
+                slot = (slot + 1) & (newCapacity - 1);
+            }
+
+            pNewCache[slot] = *pEntry;
+        }
+    }
+
+    ocFree(pGroup->pVertexCache);
+    pGroup->pVertexCache = pNewCache;
+    pGroup->vertexCacheCapacity = newCapacity;
+
+    return OC_SUCCESS;
+}
+
+OC_INLINE ocResult ocOBJResolveIndex(ocInt32 index, ocBool32 isRelative, ocUInt64 chunkBase, ocUInt64 count, ocUInt32* pIndexOut)
+{
+    ocInt64 absoluteIndex;
+    if (isRelative) {
+        absoluteIndex = (ocInt64)chunkBase + index;
+    } else {
+        if (index == 0) {
+            *pIndexOut = OC_OBJ_NO_INDEX;
+            return OC_SUCCESS;
+        }
+
+        absoluteIndex = (ocInt64)index - 1;
+    }
+
+    if (absoluteIndex < 0 || absoluteIndex >= (ocInt64)count) {
+        return OC_CORRUPT_FILE;
+    }
+
+    *pIndexOut = (ocUInt32)absoluteIndex;
+    return OC_SUCCESS;
+}
+
+// Retrieves the index of a face vertex within the current group, adding it to the group if it's not already there.
+OC_PRIVATE ocResult ocOBJImporterAddFaceVertex(ocOBJImporter* pImporter, ocOBJMeshGroup* pGroup, const ocOBJFaceVertex* pVertex, const ocUInt64* pChunkBases, ocUInt32* pIndex)
+{
+    ocAssert(pImporter != NULL);
+    ocAssert(pGroup != NULL);
+    ocAssert(pVertex != NULL);
+
+    ocUInt32 position;
+    ocUInt32 texcoord;
+    ocUInt32 normal;
+    ocResult result = ocOBJResolveIndex(pVertex->position, ocIsBitSet(pVertex->flags, OC_OBJ_FACE_VERTEX_RELATIVE_POSITION), pChunkBases[0], pImporter->positions.count/3, &position);
+    if (result != OC_SUCCESS || position == OC_OBJ_NO_INDEX) {
+        return OC_CORRUPT_FILE;
+    }
+
+    result = ocOBJResolveIndex(pVertex->texcoord, ocIsBitSet(pVertex->flags, OC_OBJ_FACE_VERTEX_RELATIVE_TEXCOORD), pChunkBases[1], pImporter->texcoords.count/2, &texcoord);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocOBJResolveIndex(pVertex->normal, ocIsBitSet(pVertex->flags, OC_OBJ_FACE_VERTEX_RELATIVE_NORMAL), pChunkBases[2], pImporter->normals.count/3, &normal);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+
+    // The cache is kept at most half full.
+    if (((ocUInt64)pGroup->vertexCount + 1) * 2 > pGroup->vertexCacheCapacity) {
+        result = ocOBJMeshGroupGrowVertexCache(pGroup);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    ocUInt32 slot = ocOBJHashVertex(position, texcoord, normal) & (pGroup->vertexCacheCapacity - 1);
+    for (;;) {
+        ocOBJVertexCacheEntry* pEntry = &pGroup->pVertexCache[slot];
+        if (pEntry->index == OC_OBJ_NO_INDEX) {
+            break;
+        }
+
+        if (pEntry->position == position && pEntry->texcoord == texcoord && pEntry->normal == normal) {
+            *pIndex = pEntry->index;
+            return OC_SUCCESS;
+        }
+
+        slot = (slot + 1) & (pGroup->vertexCacheCapacity - 1);
+    }
+
+
+    // It's a new vertex. Missing attributes are set to 0.
+    float vertex[8];
+    ocZeroMemory(vertex, sizeof(vertex));
+
+    ocCopyMemory(vertex + 0, pImporter->positions.pItems + ((size_t)position * 3), sizeof(float)*3);
+    if (texcoord != OC_OBJ_NO_INDEX) {
+        ocCopyMemory(vertex + 3, pImporter->texcoords.pItems + ((size_t)texcoord * 2), sizeof(float)*2);
+    }
+    if (normal != OC_OBJ_NO_INDEX) {
+        ocCopyMemory(vertex + 5, pImporter->normals.pItems + ((size_t)normal * 3), sizeof(float)*3);
+    }
+
+    result = ocStackPushArray(&pGroup->vertexData, vertex, ocCountOf(vertex));
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocOBJVertexCacheEntry* pEntry = &pGroup->pVertexCache[slot];
+    pEntry->position = position;
+    pEntry->texcoord = texcoord;
+    pEntry->normal   = normal;
+    pEntry->index    = pGroup->vertexCount;
+
+    *pIndex = pGroup->vertexCount;
+    pGroup->vertexCount += 1;
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocOBJImporterMergeChunk(ocOBJImporter* pImporter, ocOBJChunk* pChunk)
+{
+    ocAssert(pImporter != NULL);
+    ocAssert(pChunk != NULL);
+
+    // The indices of the first element of each attribute in the chunk, for resolving relative indices.
+    ocUInt64 chunkBases[3];
+    chunkBases[0] = pImporter->positions.count / 3;
+    chunkBases[1] = pImporter->texcoords.count / 2;
+    chunkBases[2] = pImporter->normals.count   / 3;
+
+    ocResult result = ocStackPushArray(&pImporter->positions, pChunk->positions.pItems, pChunk->positions.count);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackPushArray(&pImporter->texcoords, pChunk->texcoords.pItems, pChunk->texcoords.count);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackPushArray(&pImporter->normals, pChunk->normals.pItems, pChunk->normals.count);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+
+    size_t iMaterialSwitch = 0;
+    size_t iFaceVertex = 0;
+    for (size_t iFace = 0; iFace < pChunk->faceVertexCounts.count; ++iFace) {
+        while (iMaterialSwitch < pChunk->materialSwitches.count && pChunk->materialSwitches.pItems[iMaterialSwitch].faceIndex == iFace) {
+            result = ocOBJImporterApplyMaterialSwitch(pImporter, pChunk, &pChunk->materialSwitches.pItems[iMaterialSwitch]);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+
+            iMaterialSwitch += 1;
+        }
+
+        ocUInt32 faceVertexCount = pChunk->faceVertexCounts.pItems[iFace];
+        const ocOBJFaceVertex* pFaceVertices = pChunk->faceVertices.pItems + iFaceVertex;
+        iFaceVertex += faceVertexCount;
+
+        // Points and lines are not supported.
+        if (faceVertexCount < 3) {
+            continue;
+        }
+
+        if (pImporter->currentGroupIndex == OC_OBJ_NO_INDEX) {
+            result = ocOBJImporterSelectMaterial(pImporter, "default");
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+        }
+
+        ocOBJMeshGroup* pGroup = &pImporter->groups.pItems[pImporter->currentGroupIndex];
+
+        // Triangulated as a fan.
+        ocUInt32 triangle[3];
+        result = ocOBJImporterAddFaceVertex(pImporter, pGroup, &pFaceVertices[0], chunkBases, &triangle[0]);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        result = ocOBJImporterAddFaceVertex(pImporter, pGroup, &pFaceVertices[1], chunkBases, &triangle[2]);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        for (ocUInt32 iVertex = 2; iVertex < faceVertexCount; ++iVertex) {
+            triangle[1] = triangle[2];
+            result = ocOBJImporterAddFaceVertex(pImporter, pGroup, &pFaceVertices[iVertex], chunkBases, &triangle[2]);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+
+            result = ocStackPushArray(&pGroup->indexData, triangle, 3);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+        }
+    }
+
+    // Material switches after the last face apply to the next chunk.
+    for (; iMaterialSwitch < pChunk->materialSwitches.count; ++iMaterialSwitch) {
+        result = ocOBJImporterApplyMaterialSwitch(pImporter, pChunk, &pChunk->materialSwitches.pItems[iMaterialSwitch]);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    return OC_SUCCESS;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Output
+//
+///////////////////////////////////////////////////////////////////////////////
+
+OC_INLINE ocUInt64 ocOBJStringSize(const char* str)
+{
+    return ocAlign(strlen(str) + 1, 8);
+}
+
+// Writes the final OCD file. The layout is the same as what ocOCDSceneBuilder produces, but since everything is known up front it's
+// written in one go straight into an allocation of the final size. The data of each group is freed as soon as it's been copied.
+OC_PRIVATE ocResult ocOBJImporterRenderOCD(ocOBJImporter* pImporter, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    ocAssert(pImporter != NULL);
+    ocAssert(ppOCDData != NULL);
+    ocAssert(pOCDDataSize != NULL);
+
+    // Groups without any faces are left out.
+    ocUInt32 groupCount = 0;
+    ocUInt64 vertexDataSize = 0;
+    ocUInt64 indexDataSize = 0;
+    ocUInt64 stringDataSize = ocOBJStringSize("mesh");
+    for (size_t iGroup = 0; iGroup < pImporter->groups.count; ++iGroup) {
+        ocOBJMeshGroup* pGroup = &pImporter->groups.pItems[iGroup];
+        if (pGroup->indexData.count > 0) {
+            groupCount     += 1;
+            vertexDataSize += pGroup->vertexData.count * sizeof(float);
+            indexDataSize  += pGroup->indexData.count  * sizeof(ocUInt32);
+            stringDataSize += ocOBJStringSize(pGroup->materialName);
+        }
+    }
+
+    if (groupCount == 0) {
+        return OC_CORRUPT_FILE;     // Nothing to import.
+    }
+
+    ocUInt64 meshHeaderSize         = 40;
+    ocUInt64 meshVertexDataOffset   = meshHeaderSize + (groupCount * sizeof(ocOCDSceneBuilderMeshGroup));
+    ocUInt64 meshIndexDataOffset    = meshVertexDataOffset + ocAlign(vertexDataSize, 8);
+    ocUInt64 meshDataSize           = meshIndexDataOffset  + ocAlign(indexDataSize,  8);
+
+    ocUInt64 subresourcesOffset     = OC_OCD_HEADER_SIZE + 32;
+    ocUInt64 objectsOffset          = subresourcesOffset  + (groupCount * sizeof(ocOCDSceneBuilderSubresource));
+    ocUInt64 componentsOffset       = objectsOffset       + sizeof(ocOCDSceneBuilderObject);
+    ocUInt64 componentDataOffset    = componentsOffset    + sizeof(ocOCDSceneBuilderComponent);
+    ocUInt64 subresourceDataOffset  = componentDataOffset + meshDataSize;
+    ocUInt64 stringDataOffset       = subresourceDataOffset;    // There's no subresource data.
+    ocUInt64 fileSize               = stringDataOffset    + stringDataSize;
+
+    if (fileSize > SIZE_MAX) {
+        return OC_TOO_LARGE;
+    }
+
+    // Zero-initialized so that padding doesn't need to be explicitly written.
+    ocUInt8* pOCDData = (ocUInt8*)ocCalloc(1, (ocSizeT)fileSize);
+    if (pOCDData == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // OCD header.
+    *(ocUInt32*)(pOCDData + 0) = OC_OCD_FOURCC;
+    *(ocUInt32*)(pOCDData + 4) = OC_OCD_TYPE_ID_SCENE;
+
+    // SCN1 header.
+    *(ocUInt32*)(pOCDData + OC_OCD_HEADER_SIZE +  0) = groupCount;
+    *(ocUInt32*)(pOCDData + OC_OCD_HEADER_SIZE +  4) = 1;
+    *(ocUInt64*)(pOCDData + OC_OCD_HEADER_SIZE +  8) = subresourcesOffset;
+    *(ocUInt64*)(pOCDData + OC_OCD_HEADER_SIZE + 16) = objectsOffset;
+    *(ocUInt64*)(pOCDData + OC_OCD_HEADER_SIZE + 24) = fileSize;
+
+    // The object.
+    ocUInt64 stringOffset = stringDataOffset;
+    {
+        ocOCDSceneBuilderObject object;
+        ocZeroObject(&object);
+        object.nameOffset       = stringOffset;
+        object.parentIndex      = OC_SCENE_OBJECT_NONE;
+        object.firstChildIndex  = OC_SCENE_OBJECT_NONE;
+        object.lastChildIndex   = OC_SCENE_OBJECT_NONE;
+        object.prevSiblingIndex = OC_SCENE_OBJECT_NONE;
+        object.nextSiblingIndex = OC_SCENE_OBJECT_NONE;
+        object.absolutePosition = glm::vec3(0, 0, 0);
+        object.absoluteRotation = glm::quat(1, 0, 0, 0);
+        object.absoluteScale    = glm::vec3(1, 1, 1);
+        object.componentCount   = 1;
+        object.componentsOffset = componentsOffset;
+        ocCopyMemory(pOCDData + objectsOffset, &object, sizeof(object));
+
+        ocCopyMemory(pOCDData + stringOffset, "mesh", 5);
+        stringOffset += ocOBJStringSize("mesh");
+    }
+
+    // The mesh component.
+    {
+        ocOCDSceneBuilderComponent component;
+        ocZeroObject(&component);
+        component.type       = OC_COMPONENT_TYPE_MESH;
+        component.dataSize   = meshDataSize;
+        component.dataOffset = componentDataOffset;
+        ocCopyMemory(pOCDData + componentsOffset, &component, sizeof(component));
+
+        ocUInt8* pMeshData = pOCDData + componentDataOffset;
+        *(ocUInt32*)(pMeshData +  0) = groupCount;
+        *(ocUInt64*)(pMeshData +  8) = vertexDataSize;
+        *(ocUInt64*)(pMeshData + 16) = meshVertexDataOffset;
+        *(ocUInt64*)(pMeshData + 24) = indexDataSize;
+        *(ocUInt64*)(pMeshData + 32) = meshIndexDataOffset;
+    }
+
+    // Groups and their materials.
+    ocUInt32 iOutputGroup = 0;
+    ocUInt64 groupVertexDataOffset = 0;
+    ocUInt64 groupIndexDataOffset = 0;
+    for (size_t iGroup = 0; iGroup < pImporter->groups.count; ++iGroup) {
+        ocOBJMeshGroup* pGroup = &pImporter->groups.pItems[iGroup];
+        if (pGroup->indexData.count == 0) {
+            continue;
+        }
+
+        ocOCDSceneBuilderSubresource subresource;
+        ocZeroObject(&subresource);
+        subresource.pathOffset = stringOffset;
+        subresource.dataOffset = subresourceDataOffset;
+        ocCopyMemory(pOCDData + subresourcesOffset + (iOutputGroup * sizeof(subresource)), &subresource, sizeof(subresource));
+
+        ocCopyMemory(pOCDData + stringOffset, pGroup->materialName, strlen(pGroup->materialName) + 1);
+        stringOffset += ocOBJStringSize(pGroup->materialName);
+
+        ocOCDSceneBuilderMeshGroup meshGroup;
+        ocZeroObject(&meshGroup);
+        meshGroup.materialSubresourceIndex = iOutputGroup;
+        meshGroup.primitiveType    = ocGraphicsPrimitiveType_Triangle;
+        meshGroup.vertexFormat     = ocGraphicsVertexFormat_P3T2N3;
+        meshGroup.vertexCount      = pGroup->vertexCount;
+        meshGroup.vertexDataOffset = groupVertexDataOffset;
+        meshGroup.indexFormat      = ocGraphicsIndexFormat_UInt32;
+        meshGroup.indexCount       = (ocUInt32)pGroup->indexData.count;
+        meshGroup.indexDataOffset  = groupIndexDataOffset;
+        ocCopyMemory(pOCDData + componentDataOffset + meshHeaderSize + (iOutputGroup * sizeof(meshGroup)), &meshGroup, sizeof(meshGroup));
+
+        ocSizeT groupVertexDataSize = pGroup->vertexData.count * sizeof(float);
+        ocCopyMemory(pOCDData + componentDataOffset + meshVertexDataOffset + groupVertexDataOffset, pGroup->vertexData.pItems, groupVertexDataSize);
+        groupVertexDataOffset += groupVertexDataSize;
+        ocStackUninit(&pGroup->vertexData);
+        ocStackInit(&pGroup->vertexData);
+
+        ocSizeT groupIndexDataSize = pGroup->indexData.count * sizeof(ocUInt32);
+        ocCopyMemory(pOCDData + componentDataOffset + meshIndexDataOffset + groupIndexDataOffset, pGroup->indexData.pItems, groupIndexDataSize);
+        groupIndexDataOffset += groupIndexDataSize;
+        ocStackUninit(&pGroup->indexData);
+        ocStackInit(&pGroup->indexData);
+
+        iOutputGroup += 1;
+    }
+
+    *ppOCDData = pOCDData;
+    *pOCDDataSize = (ocSizeT)fileSize;
+    return OC_SUCCESS;
+}
+
+
+ocResult ocConvertOBJToOCD(ocStreamReader* pReader, ocJobQueue* pJobQueue, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    if (ppOCDData == NULL || pOCDDataSize == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppOCDData = NULL;
+    *pOCDDataSize = 0;
+
+    if (pReader == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocResult result = OC_SUCCESS;
+
+    ocUInt32 chunkCount = 1;
+    if (pJobQueue != NULL) {
+        chunkCount = pJobQueue->threadCount + 1;
+    }
+
+    ocOBJChunk chunks[OC_MAX_JOB_THREADS + 1];
+    for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+        ocOBJChunkInit(&chunks[iChunk]);
+    }
+
+    ocOBJImporter importer;
+    ocOBJImporterInit(&importer);
+
+    ocSizeT textCapacity = chunkCount * OC_OBJ_CHUNK_SIZE;
+    ocSizeT textSize = 0;
+    ocSizeT textStart = 0;
+    ocBool32 isAtEnd = OC_FALSE;
+    ocBool32 isFirstBatch = OC_TRUE;
+
+    char* pText = (char*)ocMalloc(textCapacity + OC_OBJ_TEXT_PADDING);
+    if (pText == NULL) {
+        result = OC_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    for (;;) {
+        // Fill the buffer. Files may return less than requested so this needs to loop.
+        while (!isAtEnd && textSize < textCapacity) {
+            ocSizeT bytesRead = 0;
+            result = ocStreamReaderRead(pReader, pText + textSize, textCapacity - textSize, &bytesRead);
+            if (result == OC_AT_END_OF_FILE || (result == OC_SUCCESS && bytesRead == 0)) {
+                result = OC_SUCCESS;
+                isAtEnd = OC_TRUE;
+                break;
+            }
+
+            if (result != OC_SUCCESS) {
+                goto done;
+            }
+
+            textSize += bytesRead;
+        }
+
+        if (textSize == 0) {
+            break;
+        }
+
+        ocZeroMemory(pText + textSize, OC_OBJ_TEXT_PADDING);
+
+        // Only whole lines are processed. The partial line at the end of the buffer is carried over to the next batch, except at the end
+        // of the file where a new line is appended instead.
+        ocSizeT processSize;
+        if (isAtEnd) {
+            pText[textSize] = '\n';
+            processSize = textSize + 1;
+        } else {
+            processSize = textSize;
+            while (processSize > 0 && pText[processSize-1] != '\n') {
+                processSize -= 1;
+            }
+
+            if (processSize == 0) {
+                // A single line that doesn't fit in the buffer. Unlikely, but still valid.
+                char* pNewText = (char*)ocRealloc(pText, (textCapacity*2) + OC_OBJ_TEXT_PADDING);
+                if (pNewText == NULL) {
+                    result = OC_OUT_OF_MEMORY;
+                    goto done;
+                }
+
+                pText = pNewText;
+                textCapacity *= 2;
+                continue;
+            }
+        }
+
+        // Skip over the UTF-8 BOM if there is one.
+        if (isFirstBatch && processSize >= 3 && (ocUInt8)pText[0] == 0xEF && (ocUInt8)pText[1] == 0xBB && (ocUInt8)pText[2] == 0xBF) {
+            textStart = 3;
+        }
+        isFirstBatch = OC_FALSE;
+
+
+        // Split the batch into chunks on line boundaries.
+        ocSizeT chunkSize = ocMax((processSize - textStart) / chunkCount, (ocSizeT)OC_OBJ_MIN_CHUNK_SIZE);
+        ocUInt32 chunksInBatch = 0;
+        ocSizeT chunkStart = textStart;
+        while (chunkStart < processSize) {
+            ocSizeT chunkEnd = processSize;
+            if (chunksInBatch + 1 < chunkCount && processSize - chunkStart > chunkSize) {
+                const char* pNewLine = (const char*)memchr(pText + chunkStart + chunkSize - 1, '\n', processSize - (chunkStart + chunkSize - 1));
+                ocAssert(pNewLine != NULL);     // <-- Always found because the last character to process is a new line.
+                chunkEnd = (ocSizeT)(pNewLine - pText) + 1;
+            }
+
+            ocOBJChunkReset(&chunks[chunksInBatch], pText + chunkStart, pText + chunkEnd);
+            chunksInBatch += 1;
+            chunkStart = chunkEnd;
+        }
+
+        // Tokenize.
+        if (pJobQueue != NULL && chunksInBatch > 1) {
+            ocUInt32 counter = 0;
+            for (ocUInt32 iChunk = 0; iChunk < chunksInBatch; ++iChunk) {
+                if (ocJobQueueSubmit(pJobQueue, ocOBJTokenizeChunkJobProc, &chunks[iChunk], &counter) != OC_SUCCESS) {
+                    ocOBJTokenizeChunkJobProc(&chunks[iChunk]);
+                }
+            }
+
+            ocJobQueueWaitForCounter(pJobQueue, &counter);
+        } else {
+            for (ocUInt32 iChunk = 0; iChunk < chunksInBatch; ++iChunk) {
+                ocOBJTokenizeChunkJobProc(&chunks[iChunk]);
+            }
+        }
+
+        // Merge. This must be done in order.
+        for (ocUInt32 iChunk = 0; iChunk < chunksInBatch; ++iChunk) {
+            result = chunks[iChunk].result;
+            if (result != OC_SUCCESS) {
+                goto done;
+            }
+
+            result = ocOBJImporterMergeChunk(&importer, &chunks[iChunk]);
+            if (result != OC_SUCCESS) {
+                goto done;
+            }
+        }
+
+        if (isAtEnd) {
+            break;
+        }
+
+        textSize -= processSize;
+        textStart = 0;
+        memmove(pText, pText + processSize, textSize);
+    }
+
+    // Only the output is needed from here on out.
+    ocFree(pText);
+    pText = NULL;
+
+    for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+        ocOBJChunkUninit(&chunks[iChunk]);
+        ocOBJChunkInit(&chunks[iChunk]);
+    }
+
+    ocOBJImporterFreeAttributes(&importer);
+
+    result = ocOBJImporterRenderOCD(&importer, ppOCDData, pOCDDataSize);
+
+done:
+    ocOBJImporterUninit(&importer);
+    for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+        ocOBJChunkUninit(&chunks[iChunk]);
+    }
+    ocFree(pText);
+    return result;
+}
\ No newline at end of file
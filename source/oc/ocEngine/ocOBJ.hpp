@@ -0,0 +1,24 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Wavefront OBJ importer.
+//
+// OBJ files are converted to OCD in a single streaming pass. The file is read in large batches of whole lines which are split into
+// chunks and tokenized in parallel on the job queue. The tokenized chunks are then merged in file order, which is where face indices
+// are resolved and vertices are deduplicated and appended directly to the mesh group of their material. Only one batch of text is
+// held in memory at a time, so importing a file needs room for it's positions, texture coordinates and normals, plus the output.
+//
+// The supported statements are v, vt, vn, f, usemtl and mtllib. Faces with more than 3 vertices are triangulated as a fan and negative
+// (relative) indices are supported. Vertices must be defined before they are referenced. Everything else is ignored. The output is a
+// scene with a single object containing a single mesh component, with a group for each material using the P3T2N3 vertex format and
+// 32-bit indices. Faces before the first usemtl statement use the "default" material.
+//
+// The material of each group is a subresource of the scene. It's path is the path of the most recent material library, relative to
+// the OBJ file, followed by the name of the material (such as "materials.mtl/wood"). The library itself is not read.
+
+// Converts OBJ data to a scene OCD file.
+//
+// pJobQueue is used for tokenizing the file in parallel and can be NULL, in which case everything is done on the calling thread. The
+// output is allocated once at it's final size.
+//
+// Free the returned data with ocFree().
+ocResult ocConvertOBJToOCD(ocStreamReader* pReader, ocJobQueue* pJobQueue, void** ppOCDData, ocSizeT* pOCDDataSize);
\ No newline at end of file
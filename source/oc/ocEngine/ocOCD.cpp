@@ -257,7 +257,6 @@ ocResult ocOCDSceneBuilderInit(ocOCDSceneBuilder* pBuilder)
     ocStackInit(&pBuilder->components);
 
     ocOCDDataBlockInit(&pBuilder->subresourceBlock);
-    ocOCDDataBlockInit(&pBuilder->objectBlock);
     ocOCDDataBlockInit(&pBuilder->componentBlock);
     ocOCDDataBlockInit(&pBuilder->componentDataBlock);
     ocOCDDataBlockInit(&pBuilder->subresourceDataBlock);
@@ -280,7 +279,6 @@ ocResult ocOCDSceneBuilderUninit(ocOCDSceneBuilder* pBuilder)
     ocOCDDataBlockUninit(&pBuilder->subresourceDataBlock);
     ocOCDDataBlockUninit(&pBuilder->componentDataBlock);
     ocOCDDataBlockUninit(&pBuilder->componentBlock);
-    ocOCDDataBlockUninit(&pBuilder->objectBlock);
     ocOCDDataBlockUninit(&pBuilder->subresourceBlock);
 
     ocStackUninit(&pBuilder->components);
@@ -295,184 +293,98 @@ ocResult ocOCDSceneBuilderRender(ocOCDSceneBuilder* pBuilder, ocStreamWriter* pW
 {
     ocAssert(pBuilder != NULL);
 
-    // Everything is written to an in-memory data block because we use a 2-pass algorithm which requires us to both read and write data which in turn means we need
-    // access to the main data pointer, which ocOCDDataBlock provides.
-    ocOCDDataBlock mainDataBlock;
-    ocResult result = ocOCDDataBlockInit(&mainDataBlock);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-
-    // OCD header.
-    ocStreamWriterWrite<ocUInt32>(&mainDataBlock, OC_OCD_FOURCC);
-    ocStreamWriterWrite<ocUInt32>(&mainDataBlock, OC_OCD_TYPE_ID_SCENE);
-
-    // SCN1 data (main data).
-    //
-    // At this point, all data offsets will be relative to the data blocks. We need to do rendering in two passes. The first pass just dumps each block to the main
-    // stream, keeping track of their data offsets. The second pass updates each of the relative data offsets to absolute offsets.
-
-    // Pass 1
-    // ======
-
-    // Header. Offsets are relative to the main payload chunk and updated in the second pass.
-    ocUInt64 headerOffset;
-    result = ocStreamWriterTell(&mainDataBlock, &headerOffset);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-
-    ocStreamWriterWrite<ocUInt32>(&mainDataBlock, (ocUInt32)pBuilder->subresources.count);
-    ocStreamWriterWrite<ocUInt32>(&mainDataBlock, (ocUInt32)pBuilder->objects.count);
-    ocStreamWriterWrite<ocUInt64>(&mainDataBlock, 0);
-    ocStreamWriterWrite<ocUInt64>(&mainDataBlock, 0);
-    ocStreamWriterWrite<ocUInt64>(&mainDataBlock, 0);      // Payload size. Updated in the second pass when the size is known for real.
-    
-    // Payload.
-    ocUInt64 payloadOffset;
-    result = ocStreamWriterTell(&mainDataBlock, &payloadOffset);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-
-    // Subresources.
-    ocUInt64 subresourcesOffset;
-    result = ocStreamWriterTell(&mainDataBlock, &subresourcesOffset);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-    {
-        result = ocStreamWriterWriteOCDDataBlock(&mainDataBlock, pBuilder->subresourceBlock);
-        if (result != OC_SUCCESS) {
-            return result;
-        }
-    }
-
-
-    // Objects.
-    for (ocUInt32 iObject = 0; iObject < pBuilder->objects.count; ++iObject) {
-        result = ocOCDDataBlockWrite(&pBuilder->objectBlock, pBuilder->objects.pItems[iObject]);
-        if (result != OC_SUCCESS) {
-            return result;
-        }
-    }
-
-    ocUInt64 objectsOffset;
-    result = ocStreamWriterTell(&mainDataBlock, &objectsOffset);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-    {
-        result = ocStreamWriterWriteOCDDataBlock(&mainDataBlock, pBuilder->objectBlock);
-        if (result != OC_SUCCESS) {
-            return result;
-        }
-    }
-
-
-    // Components.
-    ocUInt64 componentsOffset;
-    result = ocStreamWriterTell(&mainDataBlock, &componentsOffset);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-    {
-        result = ocStreamWriterWriteOCDDataBlock(&mainDataBlock, pBuilder->componentBlock);
-        if (result != OC_SUCCESS) {
-            return result;
-        }
-    }
-
-    // Component Data.
-    ocUInt64 componentDataOffset;
-    result = ocStreamWriterTell(&mainDataBlock, &componentDataOffset);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-    {
-        result = ocStreamWriterWriteOCDDataBlock(&mainDataBlock, pBuilder->componentDataBlock);
-        if (result != OC_SUCCESS) {
-            return result;
-        }
+    if (pWriter == NULL) {
+        return OC_INVALID_ARGS;
     }
 
-    // Subresource Data.
-    ocUInt64 subresourceDataOffset;
-    result = ocStreamWriterTell(&mainDataBlock, &subresourceDataOffset);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-    {
-        result = ocStreamWriterWriteOCDDataBlock(&mainDataBlock, pBuilder->subresourceDataBlock);
+    // The size of every block is known at this point so the absolute offset of each one can be calculated up front. This lets us
+    // stream everything straight to the output in a single pass, converting the offsets in each record from relative to absolute
+    // as it's written, rather than building a copy of the whole file in memory and patching it afterwards.
+    ocUInt64 subresourcesOffset    = OC_OCD_HEADER_SIZE + 32;   // <-- The SCN1 header is 32 bytes.
+    ocUInt64 objectsOffset         = subresourcesOffset    + pBuilder->subresourceBlock.dataSize;
+    ocUInt64 componentsOffset      = objectsOffset         + (pBuilder->objects.count * sizeof(ocOCDSceneBuilderObject));
+    ocUInt64 componentDataOffset   = componentsOffset      + pBuilder->componentBlock.dataSize;
+    ocUInt64 subresourceDataOffset = componentDataOffset   + pBuilder->componentDataBlock.dataSize;
+    ocUInt64 stringDataOffset      = subresourceDataOffset + pBuilder->subresourceDataBlock.dataSize;
+    ocUInt64 payloadSize           = stringDataOffset      + pBuilder->stringDataBlock.dataSize;
+
+    // There's a lot of small writes below so they're buffered if the writer isn't already.
+    ocBool32 isBufferingTemporarily = OC_FALSE;
+    if (pWriter->writeBufferSize == 0) {
+        ocResult result = ocStreamWriterSetBufferSize(pWriter, OC_OCD_RENDER_BUFFER_SIZE);
         if (result != OC_SUCCESS) {
             return result;
         }
-    }
 
-    // String Data.
-    ocUInt64 stringDataOffset;
-    result = ocStreamWriterTell(&mainDataBlock, &stringDataOffset);
-    if (result != OC_SUCCESS) {
-        return result;
+        isBufferingTemporarily = OC_TRUE;
     }
-    {
-        result = ocStreamWriterWriteOCDDataBlock(&mainDataBlock, pBuilder->stringDataBlock);
-        if (result != OC_SUCCESS) {
-            return result;
-        }
-    }
-
-
-
-    // Pass 2
-    // ======
-
-    // Header. Offsets are relative to the main payload chunk.
-    result = ocStreamWriterSeek(&mainDataBlock, (ocInt64)(headerOffset + sizeof(ocUInt32) + sizeof(ocUInt32)), ocSeekOrigin_Start);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-
-    ocStreamWriterWrite<ocUInt64>(&mainDataBlock, subresourcesOffset);
-    ocStreamWriterWrite<ocUInt64>(&mainDataBlock, objectsOffset);
 
-    ocUInt64 payloadSize;
-    result = ocStreamWriterSize(&mainDataBlock, &payloadSize);
-    if (result != OC_SUCCESS) {
-        return result;
-    }
-    ocStreamWriterWrite<ocUInt64>(&mainDataBlock, payloadSize);
+    ocResult result;
 
+    // OCD header.
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, OC_OCD_FOURCC);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, OC_OCD_TYPE_ID_SCENE);
+    if (result != OC_SUCCESS) goto done;
+
+    // SCN1 header.
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, (ocUInt32)pBuilder->subresources.count);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, (ocUInt32)pBuilder->objects.count);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt64>(pWriter, subresourcesOffset);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt64>(pWriter, objectsOffset);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt64>(pWriter, payloadSize);
+    if (result != OC_SUCCESS) goto done;
 
     // Subresources.
-    ocOCDSceneBuilderSubresource* pSubresources = (ocOCDSceneBuilderSubresource*)ocOffsetPtr(mainDataBlock.pData, (ocSizeT)subresourcesOffset);
     for (ocUInt64 iSubresource = 0; iSubresource < pBuilder->subresources.count; ++iSubresource) {
-        pSubresources[iSubresource].pathOffset += stringDataOffset;
-        pSubresources[iSubresource].dataOffset += subresourceDataOffset;
+        ocOCDSceneBuilderSubresource subresource = ((ocOCDSceneBuilderSubresource*)pBuilder->subresourceBlock.pData)[iSubresource];
+        subresource.pathOffset += stringDataOffset;
+        subresource.dataOffset += subresourceDataOffset;
+
+        result = ocStreamWriterWrite(pWriter, subresource);
+        if (result != OC_SUCCESS) goto done;
     }
 
     // Objects.
-    ocOCDSceneBuilderObject* pObjects = (ocOCDSceneBuilderObject*)ocOffsetPtr(mainDataBlock.pData, (ocSizeT)objectsOffset);
     for (ocUInt64 iObject = 0; iObject < pBuilder->objects.count; ++iObject) {
-        pObjects[iObject].nameOffset += stringDataOffset;
-        pObjects[iObject].componentsOffset += componentsOffset;
+        ocOCDSceneBuilderObject object = pBuilder->objects.pItems[iObject];
+        object.nameOffset += stringDataOffset;
+        object.componentsOffset += componentsOffset;
+
+        result = ocStreamWriterWrite(pWriter, object);
+        if (result != OC_SUCCESS) goto done;
     }
 
     // Components.
-    ocOCDSceneBuilderComponent* pComponents = (ocOCDSceneBuilderComponent*)ocOffsetPtr(mainDataBlock.pData, (ocSizeT)componentsOffset);
     for (ocUInt64 iComponent = 0; iComponent < pBuilder->components.count; ++iComponent) {
-        pComponents[iComponent].dataOffset += componentDataOffset;
-    }
+        ocOCDSceneBuilderComponent component = ((ocOCDSceneBuilderComponent*)pBuilder->componentBlock.pData)[iComponent];
+        component.dataOffset += componentDataOffset;
 
+        result = ocStreamWriterWrite(pWriter, component);
+        if (result != OC_SUCCESS) goto done;
+    }
 
+    // Component Data, Subresource Data and String Data are written as-is.
+    result = ocStreamWriterWriteOCDDataBlock(pWriter, pBuilder->componentDataBlock);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWriteOCDDataBlock(pWriter, pBuilder->subresourceDataBlock);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWriteOCDDataBlock(pWriter, pBuilder->stringDataBlock);
+    if (result != OC_SUCCESS) goto done;
 
-    // The last thing to do is write our in-memory data block to the main stream.
-    result = ocStreamWriterWriteOCDDataBlock(pWriter, mainDataBlock);
-    if (result != OC_SUCCESS) {
-        return result;
+done:
+    if (isBufferingTemporarily) {
+        ocResult flushResult = ocStreamWriterSetBufferSize(pWriter, 0);   // <-- This flushes.
+        if (result == OC_SUCCESS) {
+            result = flushResult;
+        }
     }
 
-    return OC_SUCCESS;
+    return result;
 }
 
 ocResult ocOCDSceneBuilderAddSubresource(ocOCDSceneBuilder* pBuilder, const char* path, ocUInt32* pIndex)
@@ -953,3 +865,805 @@ ocResult ocOCDSceneBuilderMeshComponentAddGroup(ocOCDSceneBuilder* pBuilder, con
 {
     return ocOCDSceneBuilderMeshComponentAddGroup(pBuilder, materialPath, primitiveType, vertexFormat, vertexCount, pVertexData, ocGraphicsIndexFormat_UInt16, indexCount, pIndexData);
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Skeletons and Animations
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Skeletons and animations are mapped in place when they're loaded so each of their blocks is aligned to 16 bytes from the start of the
+// file. The body of the file is built in a data block that starts at baseOffset, which is the size of the headers.
+OC_PRIVATE ocResult ocOCDDataBlockWritePadding16(ocOCDDataBlock* pBlock, ocUInt64 baseOffset)
+{
+    ocUInt8 padding[16] = {0};
+    return ocOCDDataBlockWrite(pBlock, padding, (ocSizeT)(ocAlign(baseOffset + pBlock->dataSize, 16) - (baseOffset + pBlock->dataSize)), NULL);
+}
+
+// Writes a block of data aligned to 16 bytes, returning it's absolute offset in the file.
+OC_PRIVATE ocResult ocOCDDataBlockWriteAligned16(ocOCDDataBlock* pBlock, ocUInt64 baseOffset, const void* pData, ocSizeT dataSize, ocUInt64* pOffsetOut)
+{
+    ocResult result = ocOCDDataBlockWritePadding16(pBlock, baseOffset);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    *pOffsetOut = baseOffset + pBlock->dataSize;
+    if (dataSize == 0) {
+        return OC_SUCCESS;
+    }
+
+    return ocOCDDataBlockWrite(pBlock, pData, dataSize, NULL);
+}
+
+// Writes the OCD header, a fixed size header made up of the given 32-bit words, and then the body.
+OC_PRIVATE ocResult ocOCDRenderMappedFile(ocStreamWriter* pWriter, ocUInt32 typeID, const ocUInt32* pHeader, ocUInt32 headerWordCount, ocOCDDataBlock* pBody)
+{
+    ocResult result = ocStreamWriterWrite<ocUInt32>(pWriter, OC_OCD_FOURCC);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, typeID);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStreamWriterWrite(pWriter, pHeader, sizeof(ocUInt32) * headerWordCount, NULL);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    return ocStreamWriterWriteOCDDataBlock(pWriter, *pBody);
+}
+
+OC_INLINE void ocOCDStoreHeaderUInt64(ocUInt32* pHeader, ocUInt32 wordIndex, ocUInt64 value)
+{
+    ocCopyMemory(pHeader + wordIndex, &value, sizeof(value));
+}
+
+// Writes the transform arrays of a pose, padded with identity transforms. pTransforms is 10 floats per bone.
+OC_PRIVATE ocResult ocOCDWritePose(ocOCDDataBlock* pBlock, ocUInt64 baseOffset, const float* pTransforms, ocUInt32 boneCount, ocUInt64* pOffsetOut)
+{
+    ocUInt32 paddedBoneCount = ocAlign(boneCount, OC_ANIMATION_LANE_COUNT);
+    const float identity[10] = {0, 0, 0, 0, 0, 0, 1, 1, 1, 1};
+
+    float* pArrays = (float*)ocMalloc(sizeof(float) * paddedBoneCount * 10);
+    if (pArrays == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    for (ocUInt32 iComponent = 0; iComponent < 10; ++iComponent) {
+        for (ocUInt32 iBone = 0; iBone < paddedBoneCount; ++iBone) {
+            pArrays[iComponent*paddedBoneCount + iBone] = (iBone < boneCount) ? pTransforms[iBone*10 + iComponent] : identity[iComponent];
+        }
+    }
+
+    ocResult result = ocOCDDataBlockWriteAligned16(pBlock, baseOffset, pArrays, sizeof(float) * paddedBoneCount * 10, pOffsetOut);
+    ocFree(pArrays);
+
+    return result;
+}
+
+OC_INLINE void ocOCDStoreTransform(float* pTransform, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale)
+{
+    pTransform[0] = position.x;
+    pTransform[1] = position.y;
+    pTransform[2] = position.z;
+    pTransform[3] = rotation.x;
+    pTransform[4] = rotation.y;
+    pTransform[5] = rotation.z;
+    pTransform[6] = rotation.w;
+    pTransform[7] = scale.x;
+    pTransform[8] = scale.y;
+    pTransform[9] = scale.z;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ocOCDSkeletonBuilder
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocResult ocOCDSkeletonBuilderInit(ocOCDSkeletonBuilder* pBuilder)
+{
+    if (pBuilder == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pBuilder);
+    ocStackInit(&pBuilder->bones);
+    ocOCDDataBlockInit(&pBuilder->stringDataBlock);
+
+    return OC_SUCCESS;
+}
+
+ocResult ocOCDSkeletonBuilderUninit(ocOCDSkeletonBuilder* pBuilder)
+{
+    if (pBuilder == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocOCDDataBlockUninit(&pBuilder->stringDataBlock);
+    ocStackUninit(&pBuilder->bones);
+
+    return OC_SUCCESS;
+}
+
+ocResult ocOCDSkeletonBuilderRender(ocOCDSkeletonBuilder* pBuilder, ocStreamWriter* pWriter)
+{
+    if (pBuilder == NULL || pWriter == NULL || pBuilder->bones.count == 0) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocUInt32 boneCount = (ocUInt32)pBuilder->bones.count;
+    ocUInt32 paddedBoneCount = ocAlign(boneCount, OC_ANIMATION_LANE_COUNT);
+    ocUInt64 baseOffset = OC_OCD_HEADER_SIZE + 48;  // <-- The SKL1 header is 48 bytes.
+
+    // The bind pose is converted to matrices the same way it is at run time so the inverse bind matrices exactly undo it.
+    float* pBindPose = (float*)ocMalloc(sizeof(float) * boneCount * 10);
+    glm::mat4* pMatrices = (glm::mat4*)ocMalloc(sizeof(glm::mat4) * paddedBoneCount * 2);
+    if (pBindPose == NULL || pMatrices == NULL) {
+        ocFree(pBindPose);
+        ocFree(pMatrices);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    for (ocUInt32 iBone = 0; iBone < boneCount; ++iBone) {
+        const ocOCDSkeletonBuilderBone &bone = pBuilder->bones.pItems[iBone];
+        ocOCDStoreTransform(pBindPose + iBone*10, bone.position, glm::normalize(bone.rotation), bone.scale);
+    }
+
+    ocOCDDataBlock body;
+    ocOCDDataBlockInit(&body);
+
+    ocUInt64 parentsOffset = 0;
+    ocUInt64 bindPoseOffset = 0;
+    ocUInt64 inverseBindOffset = 0;
+    ocUInt64 stringDataOffset = 0;
+    ocUInt64 nameOffsetsOffset = 0;
+
+    ocResult result;
+    result = ocOCDWritePose(&body, baseOffset, pBindPose, boneCount, &bindPoseOffset);
+    if (result != OC_SUCCESS) goto done;
+
+    {
+        ocTransformArray bindPose = ocAnimationMapTransformArray((float*)((ocUInt8*)body.pData + (bindPoseOffset - baseOffset)), paddedBoneCount);
+        glm::mat4* pLocal = pMatrices;
+        glm::mat4* pModel = pMatrices + paddedBoneCount;
+        ocMakeMat4Array(&bindPose, paddedBoneCount, pLocal);
+
+        for (ocUInt32 iBone = 0; iBone < boneCount; ++iBone) {
+            ocUInt32 iParent = pBuilder->bones.pItems[iBone].parentIndex;
+            pModel[iBone] = (iParent == OC_SKELETON_BONE_NONE) ? pLocal[iBone] : pModel[iParent] * pLocal[iBone];
+        }
+        ocInverseAffineMat4Array(pModel, boneCount, pLocal);
+
+        result = ocOCDDataBlockWriteAligned16(&body, baseOffset, pLocal, sizeof(glm::mat4) * boneCount, &inverseBindOffset);
+        if (result != OC_SUCCESS) goto done;
+    }
+
+    result = ocOCDDataBlockWriteAligned16(&body, baseOffset, NULL, 0, &parentsOffset);
+    if (result != OC_SUCCESS) goto done;
+    for (ocUInt32 iBone = 0; iBone < boneCount; ++iBone) {
+        result = ocOCDDataBlockWrite<ocUInt32>(&body, pBuilder->bones.pItems[iBone].parentIndex);
+        if (result != OC_SUCCESS) goto done;
+    }
+
+    result = ocOCDDataBlockWriteAligned16(&body, baseOffset, pBuilder->stringDataBlock.pData, pBuilder->stringDataBlock.dataSize, &stringDataOffset);
+    if (result != OC_SUCCESS) goto done;
+
+    result = ocOCDDataBlockWriteAligned16(&body, baseOffset, NULL, 0, &nameOffsetsOffset);
+    if (result != OC_SUCCESS) goto done;
+    for (ocUInt32 iBone = 0; iBone < boneCount; ++iBone) {
+        result = ocOCDDataBlockWrite<ocUInt64>(&body, stringDataOffset + pBuilder->bones.pItems[iBone].nameOffset);
+        if (result != OC_SUCCESS) goto done;
+    }
+
+    {
+        ocUInt32 header[12];
+        header[0] = boneCount;
+        header[1] = 0;
+        ocOCDStoreHeaderUInt64(header, 2,  parentsOffset);
+        ocOCDStoreHeaderUInt64(header, 4,  nameOffsetsOffset);
+        ocOCDStoreHeaderUInt64(header, 6,  bindPoseOffset);
+        ocOCDStoreHeaderUInt64(header, 8,  inverseBindOffset);
+        ocOCDStoreHeaderUInt64(header, 10, baseOffset + body.dataSize);
+        result = ocOCDRenderMappedFile(pWriter, OC_OCD_TYPE_ID_SKELETON, header, ocCountOf(header), &body);
+    }
+
+done:
+    ocOCDDataBlockUninit(&body);
+    ocFree(pBindPose);
+    ocFree(pMatrices);
+    return result;
+}
+
+ocResult ocOCDSkeletonBuilderAddBone(ocOCDSkeletonBuilder* pBuilder, const char* name, ocUInt32 parentIndex, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale, ocUInt32* pIndex)
+{
+    if (pIndex) {
+        *pIndex = OC_SKELETON_BONE_NONE;
+    }
+
+    if (pBuilder == NULL || name == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (pBuilder->bones.count >= OC_SKELETON_MAX_BONES) {
+        return OC_INVALID_OPERATION;
+    }
+
+    // Parents must come before their children.
+    if (parentIndex != OC_SKELETON_BONE_NONE && parentIndex >= pBuilder->bones.count) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocOCDSkeletonBuilderBone bone;
+    bone.parentIndex = parentIndex;
+    bone.position    = position;
+    bone.rotation    = rotation;
+    bone.scale       = scale;
+    ocResult result = ocOCDDataBlockWriteString(&pBuilder->stringDataBlock, name, &bone.nameOffset);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocStackPush(&pBuilder->bones, bone);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    if (pIndex) {
+        *pIndex = (ocUInt32)pBuilder->bones.count - 1;
+    }
+
+    return OC_SUCCESS;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ocOCDAnimationBuilder
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// A channel of a bone is one of position (3 components starting at 0), rotation (4 starting at 3) or scale (3 starting at 7).
+OC_PRIVATE ocBool32 ocOCDAnimationBuilderIsChannelConstant(ocOCDAnimationBuilder* pBuilder, const float* pKeys, ocUInt32 boneIndex, ocUInt32 firstComponent, ocUInt32 componentCount)
+{
+    const float* pFirstKey = pKeys + boneIndex*10;
+    for (ocUInt32 iFrame = 1; iFrame < pBuilder->frameCount; ++iFrame) {
+        const float* pKey = pKeys + (iFrame*pBuilder->boneCount + boneIndex)*10;
+        for (ocUInt32 iComponent = firstComponent; iComponent < firstComponent + componentCount; ++iComponent) {
+            if (fabsf(pKey[iComponent] - pFirstKey[iComponent]) > OC_OCD_ANIMATION_CONSTANT_TOLERANCE) {
+                return OC_FALSE;
+            }
+        }
+    }
+
+    return OC_TRUE;
+}
+
+// Writes a set of tracks: the bone indices, then the ranges of positions and scales, then the keys.
+OC_PRIVATE ocResult ocOCDAnimationBuilderWriteTracks(ocOCDAnimationBuilder* pBuilder, const float* pKeys, const ocStack<ocUInt32> &bones, ocUInt32 firstComponent, ocUInt32 componentCount, ocOCDDataBlock* pBody, ocUInt64 baseOffset, ocUInt64* pOffsets)
+{
+    ocUInt32 trackCount = (ocUInt32)bones.count;
+    ocUInt32 paddedTrackCount = ocAlign(trackCount, OC_ANIMATION_LANE_COUNT);
+    ocBool32 isRotation = componentCount == 4;
+
+    ocResult result = ocOCDDataBlockWriteAligned16(pBody, baseOffset, bones.pItems, sizeof(ocUInt32) * trackCount, &pOffsets[0]);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // Positions and scales are quantized between the minimum and maximum of each component of each track.
+    float* pRanges = NULL;
+    if (!isRotation) {
+        pRanges = (float*)ocCalloc(paddedTrackCount * 6, sizeof(float));
+        if (pRanges == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+
+        for (ocUInt32 iTrack = 0; iTrack < trackCount; ++iTrack) {
+            for (ocUInt32 iComponent = 0; iComponent < componentCount; ++iComponent) {
+                float minValue = pKeys[bones.pItems[iTrack]*10 + firstComponent + iComponent];
+                float maxValue = minValue;
+                for (ocUInt32 iFrame = 1; iFrame < pBuilder->frameCount; ++iFrame) {
+                    float value = pKeys[(iFrame*pBuilder->boneCount + bones.pItems[iTrack])*10 + firstComponent + iComponent];
+                    minValue = ocMin(minValue, value);
+                    maxValue = ocMax(maxValue, value);
+                }
+
+                pRanges[(iComponent + 0)*paddedTrackCount + iTrack] = minValue;
+                pRanges[(iComponent + 3)*paddedTrackCount + iTrack] = (maxValue - minValue) / 65535;
+            }
+        }
+
+        result = ocOCDDataBlockWriteAligned16(pBody, baseOffset, pRanges, sizeof(float) * paddedTrackCount * 6, &pOffsets[1]);
+        if (result != OC_SUCCESS) {
+            ocFree(pRanges);
+            return result;
+        }
+    } else {
+        pOffsets[1] = 0;
+    }
+
+    result = ocOCDDataBlockWriteAligned16(pBody, baseOffset, NULL, 0, &pOffsets[2]);
+    for (ocUInt32 iFrame = 0; iFrame < pBuilder->frameCount && result == OC_SUCCESS; ++iFrame) {
+        for (ocUInt32 iComponent = 0; iComponent < componentCount && result == OC_SUCCESS; ++iComponent) {
+            for (ocUInt32 iTrack = 0; iTrack < paddedTrackCount && result == OC_SUCCESS; ++iTrack) {
+                // Padding tracks are the identity. They're decoded, but never used.
+                if (iTrack >= trackCount) {
+                    ocInt16 padding = (isRotation && iComponent == 3) ? 32767 : 0;
+                    result = ocOCDDataBlockWrite<ocInt16>(pBody, padding);
+                    continue;
+                }
+
+                float value = pKeys[(iFrame*pBuilder->boneCount + bones.pItems[iTrack])*10 + firstComponent + iComponent];
+                if (isRotation) {
+                    result = ocOCDDataBlockWrite<ocInt16>(pBody, (ocInt16)ocClamp(roundf(value * 32767), -32767.0f, 32767.0f));
+                } else {
+                    float minValue = pRanges[(iComponent + 0)*paddedTrackCount + iTrack];
+                    float step     = pRanges[(iComponent + 3)*paddedTrackCount + iTrack];
+                    float steps    = (step > 0) ? roundf((value - minValue) / step) : 0;
+                    result = ocOCDDataBlockWrite<ocUInt16>(pBody, (ocUInt16)ocClamp(steps, 0.0f, 65535.0f));
+                }
+            }
+        }
+    }
+
+    ocFree(pRanges);
+    return result;
+}
+
+ocResult ocOCDAnimationBuilderInit(ocUInt32 boneCount, ocUInt32 frameCount, float sampleRate, ocOCDAnimationBuilder* pBuilder)
+{
+    if (pBuilder == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pBuilder);
+
+    if (boneCount == 0 || boneCount > OC_SKELETON_MAX_BONES || frameCount == 0 || !(sampleRate > 0)) {
+        return OC_INVALID_ARGS;
+    }
+
+    pBuilder->pKeys = (float*)ocMalloc(sizeof(float) * boneCount * frameCount * 10);
+    if (pBuilder->pKeys == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pBuilder->boneCount  = boneCount;
+    pBuilder->frameCount = frameCount;
+    pBuilder->sampleRate = sampleRate;
+
+    for (ocUInt32 iKey = 0; iKey < boneCount * frameCount; ++iKey) {
+        ocOCDStoreTransform(pBuilder->pKeys + iKey*10, glm::vec3(0, 0, 0), glm::quat(1, 0, 0, 0), glm::vec3(1, 1, 1));
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocOCDAnimationBuilderUninit(ocOCDAnimationBuilder* pBuilder)
+{
+    if (pBuilder == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocFree(pBuilder->pKeys);
+
+    return OC_SUCCESS;
+}
+
+ocResult ocOCDAnimationBuilderRender(ocOCDAnimationBuilder* pBuilder, ocStreamWriter* pWriter)
+{
+    if (pBuilder == NULL || pWriter == NULL || pBuilder->pKeys == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocUInt32 boneCount  = pBuilder->boneCount;
+    ocUInt32 frameCount = pBuilder->frameCount;
+    ocUInt64 baseOffset = OC_OCD_HEADER_SIZE + 104;  // <-- The ANM1 header is 104 bytes.
+
+    // Rotations are normalized and then flipped where needed so that each key is in the same hemisphere as the one before it. Without
+    // this, interpolating between q and a key close to -q would take the long way around.
+    float* pKeys = (float*)ocMalloc(sizeof(float) * boneCount * frameCount * 10);
+    if (pKeys == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocCopyMemory(pKeys, pBuilder->pKeys, sizeof(float) * boneCount * frameCount * 10);
+    for (ocUInt32 iFrame = 0; iFrame < frameCount; ++iFrame) {
+        for (ocUInt32 iBone = 0; iBone < boneCount; ++iBone) {
+            float* pRotation = pKeys + (iFrame*boneCount + iBone)*10 + 3;
+            glm::quat rotation = glm::normalize(glm::quat(pRotation[3], pRotation[0], pRotation[1], pRotation[2]));
+            if (iFrame > 0) {
+                const float* pPrev = pKeys + ((iFrame-1)*boneCount + iBone)*10 + 3;
+                if (rotation.x*pPrev[0] + rotation.y*pPrev[1] + rotation.z*pPrev[2] + rotation.w*pPrev[3] < 0) {
+                    rotation = -rotation;
+                }
+            }
+
+            pRotation[0] = rotation.x;
+            pRotation[1] = rotation.y;
+            pRotation[2] = rotation.z;
+            pRotation[3] = rotation.w;
+        }
+    }
+
+    ocStack<ocUInt32> positionBones;
+    ocStack<ocUInt32> rotationBones;
+    ocStack<ocUInt32> scaleBones;
+    ocStackInit(&positionBones);
+    ocStackInit(&rotationBones);
+    ocStackInit(&scaleBones);
+
+    ocOCDDataBlock body;
+    ocOCDDataBlockInit(&body);
+
+    // [0] = bones, [1] = ranges, [2] = keys.
+    ocUInt64 constantPoseOffset = 0;
+    ocUInt64 rotationOffsets[3] = {0, 0, 0};
+    ocUInt64 positionOffsets[3] = {0, 0, 0};
+    ocUInt64 scaleOffsets[3]    = {0, 0, 0};
+
+    // The constant pose is the first frame. Animated channels are overwritten when sampled so their value here doesn't matter.
+    ocResult result = ocOCDWritePose(&body, baseOffset, pKeys, boneCount, &constantPoseOffset);
+    if (result != OC_SUCCESS) goto done;
+
+    for (ocUInt32 iBone = 0; iBone < boneCount && result == OC_SUCCESS; ++iBone) {
+        if (!ocOCDAnimationBuilderIsChannelConstant(pBuilder, pKeys, iBone, 0, 3)) {
+            result = ocStackPush(&positionBones, iBone);
+        }
+        if (result == OC_SUCCESS && !ocOCDAnimationBuilderIsChannelConstant(pBuilder, pKeys, iBone, 3, 4)) {
+            result = ocStackPush(&rotationBones, iBone);
+        }
+        if (result == OC_SUCCESS && !ocOCDAnimationBuilderIsChannelConstant(pBuilder, pKeys, iBone, 7, 3)) {
+            result = ocStackPush(&scaleBones, iBone);
+        }
+    }
+    if (result != OC_SUCCESS) goto done;
+
+    result = ocOCDAnimationBuilderWriteTracks(pBuilder, pKeys, rotationBones, 3, 4, &body, baseOffset, rotationOffsets);
+    if (result != OC_SUCCESS) goto done;
+    result = ocOCDAnimationBuilderWriteTracks(pBuilder, pKeys, positionBones, 0, 3, &body, baseOffset, positionOffsets);
+    if (result != OC_SUCCESS) goto done;
+    result = ocOCDAnimationBuilderWriteTracks(pBuilder, pKeys, scaleBones,    7, 3, &body, baseOffset, scaleOffsets);
+    if (result != OC_SUCCESS) goto done;
+
+    {
+        float sampleRate = pBuilder->sampleRate;
+
+        ocUInt32 header[26];
+        header[0] = boneCount;
+        header[1] = frameCount;
+        ocCopyMemory(&header[2], &sampleRate, sizeof(float));
+        header[3] = (ocUInt32)rotationBones.count;
+        header[4] = (ocUInt32)positionBones.count;
+        header[5] = (ocUInt32)scaleBones.count;
+        ocOCDStoreHeaderUInt64(header, 6,  constantPoseOffset);
+        ocOCDStoreHeaderUInt64(header, 8,  rotationOffsets[0]);
+        ocOCDStoreHeaderUInt64(header, 10, rotationOffsets[2]);
+        ocOCDStoreHeaderUInt64(header, 12, positionOffsets[0]);
+        ocOCDStoreHeaderUInt64(header, 14, positionOffsets[1]);
+        ocOCDStoreHeaderUInt64(header, 16, positionOffsets[2]);
+        ocOCDStoreHeaderUInt64(header, 18, scaleOffsets[0]);
+        ocOCDStoreHeaderUInt64(header, 20, scaleOffsets[1]);
+        ocOCDStoreHeaderUInt64(header, 22, scaleOffsets[2]);
+        ocOCDStoreHeaderUInt64(header, 24, baseOffset + body.dataSize);
+        result = ocOCDRenderMappedFile(pWriter, OC_OCD_TYPE_ID_ANIMATION, header, ocCountOf(header), &body);
+    }
+
+done:
+    ocOCDDataBlockUninit(&body);
+    ocStackUninit(&positionBones);
+    ocStackUninit(&rotationBones);
+    ocStackUninit(&scaleBones);
+    ocFree(pKeys);
+    return result;
+}
+
+ocResult ocOCDAnimationBuilderSetKey(ocOCDAnimationBuilder* pBuilder, ocUInt32 frame, ocUInt32 boneIndex, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale)
+{
+    if (pBuilder == NULL || frame >= pBuilder->frameCount || boneIndex >= pBuilder->boneCount) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocOCDStoreTransform(pBuilder->pKeys + (frame*pBuilder->boneCount + boneIndex)*10, position, rotation, scale);
+    return OC_SUCCESS;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Compression
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Compressed OCD files have the following layout after the header:
+//   [8 bytes]  Uncompressed size of everything after the header.
+//   [4 bytes]  Chunk size. Every chunk except the last decompresses to exactly this many bytes.
+//   [4 bytes]  Chunk count.
+//   [8 bytes per chunk] Compressed size (4 bytes) and flags (4 bytes) of each chunk.
+//   [?]        The data of each chunk, tightly packed in order.
+#define OC_OCD_COMPRESSED_HEADER_SIZE   16
+#define OC_OCD_CHUNK_FLAG_STORED        0x00000001  // <-- The chunk is not compressed.
+
+struct ocOCDChunk
+{
+    const ocUInt8* pSrc;
+    ocSizeT srcSize;
+    ocUInt8* pDst;
+    ocSizeT dstSize;    // <-- When compressing this is the capacity of pDst, and then the compressed size once the chunk is done.
+    ocUInt32 flags;
+    ocResult result;
+};
+
+OC_PRIVATE void ocOCDCompressChunkJobProc(void* pUserData)
+{
+    ocOCDChunk* pChunk = (ocOCDChunk*)pUserData;
+    ocAssert(pChunk != NULL);
+
+    ocSizeT compressedSize;
+    pChunk->result = ocLZCompress(pChunk->pSrc, pChunk->srcSize, pChunk->pDst, pChunk->dstSize, &compressedSize);
+    if (pChunk->result != OC_SUCCESS) {
+        return;
+    }
+
+    if (compressedSize < pChunk->srcSize) {
+        pChunk->dstSize = compressedSize;
+        pChunk->flags = 0;
+    } else {
+        // Didn't get any smaller so store it as-is. Saves time when decompressing.
+        memcpy(pChunk->pDst, pChunk->pSrc, pChunk->srcSize);
+        pChunk->dstSize = pChunk->srcSize;
+        pChunk->flags = OC_OCD_CHUNK_FLAG_STORED;
+    }
+}
+
+OC_PRIVATE void ocOCDDecompressChunkJobProc(void* pUserData)
+{
+    ocOCDChunk* pChunk = (ocOCDChunk*)pUserData;
+    ocAssert(pChunk != NULL);
+
+    if ((pChunk->flags & OC_OCD_CHUNK_FLAG_STORED) != 0) {
+        if (pChunk->srcSize != pChunk->dstSize) {
+            pChunk->result = OC_CORRUPT_FILE;
+            return;
+        }
+
+        memcpy(pChunk->pDst, pChunk->pSrc, pChunk->srcSize);
+        pChunk->result = OC_SUCCESS;
+    } else {
+        pChunk->result = ocLZDecompress(pChunk->pSrc, pChunk->srcSize, pChunk->pDst, pChunk->dstSize);
+    }
+}
+
+// Runs a job for each chunk, returning the result of the first chunk that failed.
+OC_PRIVATE ocResult ocOCDProcessChunks(ocJobQueue* pJobQueue, ocJobProc proc, ocOCDChunk* pChunks, ocUInt32 chunkCount)
+{
+    ocAssert(proc != NULL);
+
+    if (pJobQueue != NULL && chunkCount > 1) {
+        ocUInt32 counter = 0;
+        for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+            if (ocJobQueueSubmit(pJobQueue, proc, &pChunks[iChunk], &counter) != OC_SUCCESS) {
+                proc(&pChunks[iChunk]);
+            }
+        }
+
+        ocJobQueueWaitForCounter(pJobQueue, &counter);
+    } else {
+        for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+            proc(&pChunks[iChunk]);
+        }
+    }
+
+    for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+        if (pChunks[iChunk].result != OC_SUCCESS) {
+            return pChunks[iChunk].result;
+        }
+    }
+
+    return OC_SUCCESS;
+}
+
+ocBool32 ocOCDIsCompressed(const void* pData, ocSizeT dataSize)
+{
+    if (pData == NULL || dataSize < OC_OCD_HEADER_SIZE) {
+        return OC_FALSE;
+    }
+
+    ocUInt32 fourcc = *((const ocUInt32*)pData + 0);
+    ocUInt32 type   = *((const ocUInt32*)pData + 1);
+    return fourcc == OC_OCD_FOURCC && (type & OC_OCD_TYPE_FLAG_COMPRESSED) != 0;
+}
+
+ocResult ocOCDCompress(const void* pOCDData, ocSizeT ocdDataSize, ocJobQueue* pJobQueue, void** ppCompressedData, ocSizeT* pCompressedDataSize)
+{
+    if (ppCompressedData == NULL || pCompressedDataSize == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppCompressedData = NULL;
+    *pCompressedDataSize = 0;
+
+    if (pOCDData == NULL || ocdDataSize < OC_OCD_HEADER_SIZE) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocUInt32 fourcc = *((const ocUInt32*)pOCDData + 0);
+    ocUInt32 type   = *((const ocUInt32*)pOCDData + 1);
+    if (fourcc != OC_OCD_FOURCC) {
+        return OC_CORRUPT_FILE;
+    }
+
+    if ((type & OC_OCD_TYPE_FLAG_COMPRESSED) != 0 || type == OC_OCD_TYPE_ID_PACKAGE) {
+        return OC_INVALID_ARGS;
+    }
+
+    const ocUInt8* pBody = (const ocUInt8*)pOCDData + OC_OCD_HEADER_SIZE;
+    ocSizeT bodySize = ocdDataSize - OC_OCD_HEADER_SIZE;
+    if ((bodySize / OC_OCD_COMPRESSION_CHUNK_SIZE) >= 0xFFFFFFFF) {
+        return OC_TOO_LARGE;
+    }
+
+    ocUInt32 chunkCount = (ocUInt32)((bodySize + OC_OCD_COMPRESSION_CHUNK_SIZE - 1) / OC_OCD_COMPRESSION_CHUNK_SIZE);
+    ocSizeT chunkCapacity = ocLZCompressBound(OC_OCD_COMPRESSION_CHUNK_SIZE);
+
+    // Each chunk is compressed into it's own worst case sized region of a temporary buffer and then packed together at the end.
+    ocOCDChunk* pChunks = (ocOCDChunk*)ocCalloc(ocMax(chunkCount, 1U), sizeof(*pChunks));
+    if (pChunks == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocUInt8* pTemp = (ocUInt8*)ocMalloc(ocMax(chunkCount, 1U) * chunkCapacity);
+    if (pTemp == NULL) {
+        ocFree(pChunks);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+        ocSizeT offset = (ocSizeT)iChunk * OC_OCD_COMPRESSION_CHUNK_SIZE;
+        pChunks[iChunk].pSrc    = pBody + offset;
+        pChunks[iChunk].srcSize = ocMin(bodySize - offset, (ocSizeT)OC_OCD_COMPRESSION_CHUNK_SIZE);
+        pChunks[iChunk].pDst    = pTemp + (iChunk * chunkCapacity);
+        pChunks[iChunk].dstSize = chunkCapacity;
+    }
+
+    ocResult result = ocOCDProcessChunks(pJobQueue, ocOCDCompressChunkJobProc, pChunks, chunkCount);
+    if (result != OC_SUCCESS) {
+        goto done;
+    }
+
+    {
+        ocSizeT compressedDataSize = OC_OCD_HEADER_SIZE + OC_OCD_COMPRESSED_HEADER_SIZE + ((ocSizeT)chunkCount * 8);
+        for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+            compressedDataSize += pChunks[iChunk].dstSize;
+        }
+
+        ocUInt8* pCompressedData = (ocUInt8*)ocMalloc(compressedDataSize);
+        if (pCompressedData == NULL) {
+            result = OC_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        *(ocUInt32*)(pCompressedData + 0)  = OC_OCD_FOURCC;
+        *(ocUInt32*)(pCompressedData + 4)  = type | OC_OCD_TYPE_FLAG_COMPRESSED;
+        *(ocUInt64*)(pCompressedData + 8)  = bodySize;
+        *(ocUInt32*)(pCompressedData + 16) = OC_OCD_COMPRESSION_CHUNK_SIZE;
+        *(ocUInt32*)(pCompressedData + 20) = chunkCount;
+
+        ocUInt8* pChunkInfo = pCompressedData + OC_OCD_HEADER_SIZE + OC_OCD_COMPRESSED_HEADER_SIZE;
+        ocUInt8* pChunkData = pChunkInfo + ((ocSizeT)chunkCount * 8);
+        for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+            *(ocUInt32*)(pChunkInfo + (iChunk*8) + 0) = (ocUInt32)pChunks[iChunk].dstSize;
+            *(ocUInt32*)(pChunkInfo + (iChunk*8) + 4) = pChunks[iChunk].flags;
+
+            memcpy(pChunkData, pChunks[iChunk].pDst, pChunks[iChunk].dstSize);
+            pChunkData += pChunks[iChunk].dstSize;
+        }
+
+        *ppCompressedData = pCompressedData;
+        *pCompressedDataSize = compressedDataSize;
+    }
+
+done:
+    ocFree(pTemp);
+    ocFree(pChunks);
+    return result;
+}
+
+ocResult ocOCDDecompress(const void* pData, ocSizeT dataSize, ocJobQueue* pJobQueue, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    if (ppOCDData == NULL || pOCDDataSize == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppOCDData = NULL;
+    *pOCDDataSize = 0;
+
+    if (!ocOCDIsCompressed(pData, dataSize)) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (dataSize < OC_OCD_HEADER_SIZE + OC_OCD_COMPRESSED_HEADER_SIZE) {
+        return OC_CORRUPT_FILE;
+    }
+
+    const ocUInt8* pRunningData = (const ocUInt8*)pData;
+    ocUInt32 type       = *(const ocUInt32*)(pRunningData + 4);
+    ocUInt64 bodySize   = *(const ocUInt64*)(pRunningData + 8);
+    ocUInt32 chunkSize  = *(const ocUInt32*)(pRunningData + 16);
+    ocUInt32 chunkCount = *(const ocUInt32*)(pRunningData + 20);
+
+    if (chunkSize == 0 || (bodySize / chunkSize) + ((bodySize % chunkSize) != 0) != chunkCount) {
+        return OC_CORRUPT_FILE;
+    }
+
+    if (bodySize > SIZE_MAX - OC_OCD_HEADER_SIZE) {
+        return OC_TOO_LARGE;
+    }
+
+    ocUInt64 chunkDataOffset = OC_OCD_HEADER_SIZE + OC_OCD_COMPRESSED_HEADER_SIZE + ((ocUInt64)chunkCount * 8);
+    if (chunkDataOffset > dataSize) {
+        return OC_CORRUPT_FILE;
+    }
+
+    ocSizeT ocdDataSize = (ocSizeT)bodySize + OC_OCD_HEADER_SIZE;
+    ocUInt8* pOCDData = (ocUInt8*)ocMalloc(ocdDataSize);
+    if (pOCDData == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocOCDChunk* pChunks = (ocOCDChunk*)ocCalloc(ocMax(chunkCount, 1U), sizeof(*pChunks));
+    if (pChunks == NULL) {
+        ocFree(pOCDData);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // The header is the same as the uncompressed file, just without the compression flag.
+    *(ocUInt32*)(pOCDData + 0) = OC_OCD_FOURCC;
+    *(ocUInt32*)(pOCDData + 4) = type & ~OC_OCD_TYPE_FLAG_COMPRESSED;
+
+    ocResult result = OC_SUCCESS;
+    const ocUInt8* pChunkInfo = pRunningData + OC_OCD_HEADER_SIZE + OC_OCD_COMPRESSED_HEADER_SIZE;
+    ocUInt64 srcOffset = chunkDataOffset;
+    for (ocUInt32 iChunk = 0; iChunk < chunkCount; ++iChunk) {
+        ocUInt32 compressedSize = *(const ocUInt32*)(pChunkInfo + (iChunk*8) + 0);
+        ocUInt32 flags          = *(const ocUInt32*)(pChunkInfo + (iChunk*8) + 4);
+        if (compressedSize > dataSize - srcOffset) {
+            result = OC_CORRUPT_FILE;
+            goto done;
+        }
+
+        // Each chunk is decompressed straight into it's final position.
+        ocUInt64 dstOffset = (ocUInt64)iChunk * chunkSize;
+        pChunks[iChunk].pSrc    = pRunningData + srcOffset;
+        pChunks[iChunk].srcSize = compressedSize;
+        pChunks[iChunk].pDst    = pOCDData + OC_OCD_HEADER_SIZE + dstOffset;
+        pChunks[iChunk].dstSize = (ocSizeT)ocMin(bodySize - dstOffset, (ocUInt64)chunkSize);
+        pChunks[iChunk].flags   = flags;
+
+        srcOffset += compressedSize;
+    }
+
+    result = ocOCDProcessChunks(pJobQueue, ocOCDDecompressChunkJobProc, pChunks, chunkCount);
+    if (result != OC_SUCCESS) {
+        goto done;
+    }
+
+    *ppOCDData = pOCDData;
+    *pOCDDataSize = ocdDataSize;
+
+done:
+    if (result != OC_SUCCESS) {
+        ocFree(pOCDData);
+    }
+
+    ocFree(pChunks);
+    return result;
+}
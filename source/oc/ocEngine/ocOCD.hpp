@@ -2,14 +2,29 @@
 
 // This file contains helpers and utilities for working with OCD files.
 
-#define OC_OCD_FOURCC           0x2044434f /*'OCD ' LE*/
-#define OC_OCD_TYPE_ID_IMAGE    0x31474d49 /*'IMG1' LE*/
-#define OC_OCD_TYPE_ID_SCENE    0x314e4353 /*'SCN1' LE*/
+#define OC_OCD_FOURCC             0x2044434f /*'OCD ' LE*/
+#define OC_OCD_TYPE_ID_IMAGE      0x31474d49 /*'IMG1' LE*/
+#define OC_OCD_TYPE_ID_SCENE      0x314e4353 /*'SCN1' LE*/
+#define OC_OCD_TYPE_ID_PACKAGE    0x314b4150 /*'PAK1' LE*/
+#define OC_OCD_TYPE_ID_SKELETON   0x314c4b53 /*'SKL1' LE*/
+#define OC_OCD_TYPE_ID_ANIMATION  0x314d4e41 /*'ANM1' LE*/
 
 #define OC_OCD_HEADER_SIZE      8   // FourCC + Type.
 
+// Set on the type in the header when everything after the header is compressed. See ocOCDCompress().
+#define OC_OCD_TYPE_FLAG_COMPRESSED     0x80000000
+
+// The uncompressed size of each chunk of a compressed OCD file. Chunks are compressed independently so they can be decompressed in
+// parallel. Smaller chunks give more parallelism at the expense of compression ratio.
+#define OC_OCD_COMPRESSION_CHUNK_SIZE   (256*1024)
+
+#define OC_OCD_RENDER_BUFFER_SIZE   (64*1024)   // The size of the write buffer used by builders when rendering to an unbuffered writer.
+
 #define OC_OCD_SCENE_SUBRESOURCE_FLAG_IS_INTERNAL   0x0000000000000001ULL
 
+// The largest difference from the first key, in any component, for an animated channel to be stored as a constant.
+#define OC_OCD_ANIMATION_CONSTANT_TOLERANCE         0.00001f
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -143,7 +158,6 @@ struct ocOCDSceneBuilder
     ocStack<ocOCDSceneBuilderComponent> components;
 
     ocOCDDataBlock subresourceBlock;
-    ocOCDDataBlock objectBlock;
     ocOCDDataBlock componentBlock;
     ocOCDDataBlock componentDataBlock;
     ocOCDDataBlock subresourceDataBlock;
@@ -163,6 +177,9 @@ ocResult ocOCDSceneBuilderInit(ocOCDSceneBuilder* pBuilder);
 ocResult ocOCDSceneBuilderUninit(ocOCDSceneBuilder* pBuilder);
 
 // Outputs the OCD file to the given writer.
+//
+// The file is streamed to the writer in a single pass. If the writer is not buffered a write buffer is set on it for the duration
+// of the call.
 ocResult ocOCDSceneBuilderRender(ocOCDSceneBuilder* pBuilder, ocStreamWriter* pWriter);
 
 // Adds a subresource by it's path.
@@ -194,4 +211,99 @@ ocResult ocOCDSceneBuilderEndMeshComponent(ocOCDSceneBuilder* pBuilder);
 // Adds a group to the current mesh component.
 ocResult ocOCDSceneBuilderMeshComponentAddGroup(ocOCDSceneBuilder* pBuilder, const char* materialPath, ocGraphicsPrimitiveType primitiveType, ocGraphicsVertexFormat vertexFormat, ocUInt32 vertexCount, float* pVertexData, ocGraphicsIndexFormat indexFormat, ocUInt32 indexCount, void* pIndexData);
 ocResult ocOCDSceneBuilderMeshComponentAddGroup(ocOCDSceneBuilder* pBuilder, const char* materialPath, ocGraphicsPrimitiveType primitiveType, ocGraphicsVertexFormat vertexFormat, ocUInt32 vertexCount, float* pVertexData, ocUInt32 indexCount, ocUInt32* pIndexData);
-ocResult ocOCDSceneBuilderMeshComponentAddGroup(ocOCDSceneBuilder* pBuilder, const char* materialPath, ocGraphicsPrimitiveType primitiveType, ocGraphicsVertexFormat vertexFormat, ocUInt32 vertexCount, float* pVertexData, ocUInt32 indexCount, ocUInt16* pIndexData);
\ No newline at end of file
+ocResult ocOCDSceneBuilderMeshComponentAddGroup(ocOCDSceneBuilder* pBuilder, const char* materialPath, ocGraphicsPrimitiveType primitiveType, ocGraphicsVertexFormat vertexFormat, ocUInt32 vertexCount, float* pVertexData, ocUInt32 indexCount, ocUInt16* pIndexData);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ocOCDSkeletonBuilder
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct ocOCDSkeletonBuilderBone
+{
+    ocUInt64 nameOffset;            // <-- Relative to stringDataBlock.
+    ocUInt32 parentIndex;
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+};
+
+struct ocOCDSkeletonBuilder
+{
+    ocStack<ocOCDSkeletonBuilderBone> bones;
+    ocOCDDataBlock stringDataBlock;
+};
+
+// Initializes a skeleton builder.
+ocResult ocOCDSkeletonBuilderInit(ocOCDSkeletonBuilder* pBuilder);
+
+// Uninitializes a skeleton builder.
+ocResult ocOCDSkeletonBuilderUninit(ocOCDSkeletonBuilder* pBuilder);
+
+// Outputs the OCD file to the given writer. The inverse bind matrices are calculated from the bind pose.
+ocResult ocOCDSkeletonBuilderRender(ocOCDSkeletonBuilder* pBuilder, ocStreamWriter* pWriter);
+
+// Adds a bone. The transform is the bind pose of the bone relative to it's parent.
+//
+// The parent must have already been added. Use OC_SKELETON_BONE_NONE for root bones.
+ocResult ocOCDSkeletonBuilderAddBone(ocOCDSkeletonBuilder* pBuilder, const char* name, ocUInt32 parentIndex, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale, ocUInt32* pIndex);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ocOCDAnimationBuilder
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct ocOCDAnimationBuilder
+{
+    ocUInt32 boneCount;
+    ocUInt32 frameCount;
+    float sampleRate;
+    float* pKeys;                   // <-- 10 floats for each bone of each frame: position, rotation and scale.
+};
+
+// Initializes an animation builder. Every key starts at the identity transform.
+ocResult ocOCDAnimationBuilderInit(ocUInt32 boneCount, ocUInt32 frameCount, float sampleRate, ocOCDAnimationBuilder* pBuilder);
+
+// Uninitializes an animation builder.
+ocResult ocOCDAnimationBuilderUninit(ocOCDAnimationBuilder* pBuilder);
+
+// Outputs the OCD file to the given writer.
+//
+// Channels that don't change by more than OC_OCD_ANIMATION_CONSTANT_TOLERANCE are stored as constants. Everything else is quantized
+// to 16 bits. See ocAnimationClip for the details.
+ocResult ocOCDAnimationBuilderRender(ocOCDAnimationBuilder* pBuilder, ocStreamWriter* pWriter);
+
+// Sets the transform of a bone at a frame, relative to it's parent.
+ocResult ocOCDAnimationBuilderSetKey(ocOCDAnimationBuilder* pBuilder, ocUInt32 frame, ocUInt32 boneIndex, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Compression
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Determines whether or not the given OCD data is compressed.
+ocBool32 ocOCDIsCompressed(const void* pData, ocSizeT dataSize);
+
+// Compresses OCD data.
+//
+// Everything after the header is split into chunks of OC_OCD_COMPRESSION_CHUNK_SIZE bytes which are compressed independently with
+// ocLZCompress(). A chunk that does not get any smaller is stored as-is. pJobQueue is used to compress the chunks in parallel and
+// can be NULL. Packages cannot be compressed because their files are already compressed individually.
+//
+// The compressed data can be larger than the original when the data does not compress well. It's up to the caller to decide whether
+// or not to keep it. Free the returned data with ocFree().
+ocResult ocOCDCompress(const void* pOCDData, ocSizeT ocdDataSize, ocJobQueue* pJobQueue, void** ppCompressedData, ocSizeT* pCompressedDataSize);
+
+// Decompresses OCD data that was compressed with ocOCDCompress().
+//
+// The output is a single allocation that's identical to the original OCD data, with each chunk decompressed straight into it's final
+// position. pJobQueue is used to decompress the chunks in parallel and can be NULL. Free the returned data with ocFree().
+ocResult ocOCDDecompress(const void* pData, ocSizeT dataSize, ocJobQueue* pJobQueue, void** ppOCDData, ocSizeT* pOCDDataSize);
\ No newline at end of file
@@ -0,0 +1,628 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_PACKAGE_HEADER_SIZE  32  // Not including the OCD header.
+
+// Paths in packages always use forward slashes and never start with a slash or "./". Lookups are normalized the same way so that
+// the caller doesn't need to care about it.
+OC_PRIVATE const char* ocPackageSkipPathPrefix(const char* path)
+{
+    for (;;) {
+        if (path[0] == '/' || path[0] == '\\') {
+            path += 1;
+        } else if (path[0] == '.' && (path[1] == '/' || path[1] == '\\')) {
+            path += 2;
+        } else {
+            break;
+        }
+    }
+
+    return path;
+}
+
+OC_INLINE char ocPackageNormalizePathChar(char c)
+{
+    return (c == '\\') ? '/' : c;
+}
+
+OC_PRIVATE ocBool32 ocPackagePathEqual(const char* entryPath, ocUInt32 entryPathLength, const char* path)
+{
+    for (ocUInt32 i = 0; i < entryPathLength; ++i) {
+        if (entryPath[i] != ocPackageNormalizePathChar(path[i])) {
+            return OC_FALSE;    // <-- This also handles the case when path is shorter than entryPath.
+        }
+    }
+
+    return path[entryPathLength] == '\0';
+}
+
+ocUInt64 ocPackageHashPath(const char* path)
+{
+    if (path == NULL) {
+        return 0;
+    }
+
+    path = ocPackageSkipPathPrefix(path);
+
+    ocUInt64 hash = OC_HASH_FNV1A64_SEED;
+    for (ocSizeT i = 0; path[i] != '\0'; ++i) {
+        char c = ocPackageNormalizePathChar(path[i]);
+        hash = ocHashFNV1a64(&c, 1, hash);
+    }
+
+    return hash;
+}
+
+
+#ifdef OC_WIN32
+OC_PRIVATE ocResult ocPackageMap__Win32(const char* absolutePath, ocPackage* pPackage)
+{
+    pPackage->hFile = CreateFileA(absolutePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (pPackage->hFile == INVALID_HANDLE_VALUE) {
+        return OC_DOES_NOT_EXIST;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(pPackage->hFile, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(pPackage->hFile);
+        return OC_INVALID_ARCHIVE;
+    }
+
+    if ((ocUInt64)fileSize.QuadPart > (ocUInt64)SIZE_MAX) {
+        CloseHandle(pPackage->hFile);
+        return OC_TOO_LARGE;
+    }
+
+    pPackage->hFileMapping = CreateFileMappingA(pPackage->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (pPackage->hFileMapping == NULL) {
+        CloseHandle(pPackage->hFile);
+        return OC_ERROR;
+    }
+
+    pPackage->pFileData = (const ocUInt8*)MapViewOfFile(pPackage->hFileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (pPackage->pFileData == NULL) {
+        CloseHandle(pPackage->hFileMapping);
+        CloseHandle(pPackage->hFile);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pPackage->fileSize = (ocUInt64)fileSize.QuadPart;
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocPackageUnmap__Win32(ocPackage* pPackage)
+{
+    UnmapViewOfFile(pPackage->pFileData);
+    CloseHandle(pPackage->hFileMapping);
+    CloseHandle(pPackage->hFile);
+}
+
+OC_PRIVATE void ocPackagePrefetch__Win32(ocPackage* pPackage, ocUInt64 offset, ocUInt64 size)
+{
+    // PrefetchVirtualMemory() is not available on everything we target. FILE_FLAG_RANDOM_ACCESS is used when opening the file which
+    // is the best we can do for now.
+    (void)pPackage;
+    (void)offset;
+    (void)size;
+}
+#endif
+
+#ifdef OC_POSIX
+OC_PRIVATE ocResult ocPackageMap__Posix(const char* absolutePath, ocPackage* pPackage)
+{
+    pPackage->fd = open(absolutePath, O_RDONLY);
+    if (pPackage->fd == -1) {
+        return OC_DOES_NOT_EXIST;
+    }
+
+    struct stat info;
+    if (fstat(pPackage->fd, &info) != 0 || info.st_size == 0) {
+        close(pPackage->fd);
+        return OC_INVALID_ARCHIVE;
+    }
+
+    if ((ocUInt64)info.st_size > (ocUInt64)SIZE_MAX) {
+        close(pPackage->fd);
+        return OC_TOO_LARGE;
+    }
+
+    void* pFileData = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, pPackage->fd, 0);
+    if (pFileData == MAP_FAILED) {
+        close(pPackage->fd);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // Access to entries is random. The table of contents and string data is handled explicitly in ocPackageOpen().
+    madvise(pFileData, (size_t)info.st_size, MADV_RANDOM);
+
+    pPackage->pFileData = (const ocUInt8*)pFileData;
+    pPackage->fileSize  = (ocUInt64)info.st_size;
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocPackageUnmap__Posix(ocPackage* pPackage)
+{
+    munmap((void*)pPackage->pFileData, (size_t)pPackage->fileSize);
+    close(pPackage->fd);
+}
+
+OC_PRIVATE void ocPackagePrefetch__Posix(ocPackage* pPackage, ocUInt64 offset, ocUInt64 size)
+{
+    // madvise() requires a page aligned address.
+    ocUInt64 pageSize = (ocUInt64)sysconf(_SC_PAGESIZE);
+    ocUInt64 alignedOffset = offset & ~(pageSize - 1);
+
+    madvise((void*)(pPackage->pFileData + alignedOffset), (size_t)(size + (offset - alignedOffset)), MADV_WILLNEED);
+}
+#endif
+
+OC_PRIVATE void ocPackagePrefetch(ocPackage* pPackage, ocUInt64 offset, ocUInt64 size)
+{
+    if (size == 0) {
+        return;
+    }
+
+#ifdef OC_WIN32
+    ocPackagePrefetch__Win32(pPackage, offset, size);
+#endif
+#ifdef OC_POSIX
+    ocPackagePrefetch__Posix(pPackage, offset, size);
+#endif
+}
+
+ocResult ocPackageOpen(const char* absolutePath, ocPackage* pPackage)
+{
+    if (pPackage == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pPackage);
+
+    if (absolutePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (strcpy_s(pPackage->absolutePath, sizeof(pPackage->absolutePath), absolutePath) != 0) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    ocResult result;
+#ifdef OC_WIN32
+    result = ocPackageMap__Win32(absolutePath, pPackage);
+#endif
+#ifdef OC_POSIX
+    result = ocPackageMap__Posix(absolutePath, pPackage);
+#endif
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // Header.
+    const ocUInt8* pData = pPackage->pFileData;
+    if (pPackage->fileSize < OC_OCD_HEADER_SIZE + OC_PACKAGE_HEADER_SIZE) {
+        result = OC_INVALID_ARCHIVE;
+        goto on_error;
+    }
+
+    if (*(const ocUInt32*)(pData + 0) != OC_OCD_FOURCC || *(const ocUInt32*)(pData + 4) != OC_OCD_TYPE_ID_PACKAGE) {
+        result = OC_INVALID_ARCHIVE;
+        goto on_error;
+    }
+
+    {
+        ocUInt32 entryCount    = *(const ocUInt32*)(pData + OC_OCD_HEADER_SIZE + 0);
+        ocUInt32 dataAlignment = *(const ocUInt32*)(pData + OC_OCD_HEADER_SIZE + 4);
+        ocUInt64 entriesOffset = *(const ocUInt64*)(pData + OC_OCD_HEADER_SIZE + 8);
+        ocUInt64 stringsOffset = *(const ocUInt64*)(pData + OC_OCD_HEADER_SIZE + 16);
+        ocUInt64 stringsSize   = *(const ocUInt64*)(pData + OC_OCD_HEADER_SIZE + 24);
+
+        ocUInt64 entriesSize = (ocUInt64)entryCount * sizeof(ocPackageEntry);
+        if (entriesOffset > pPackage->fileSize || entriesSize > pPackage->fileSize - entriesOffset || (entriesOffset & 0x7) != 0) {
+            result = OC_INVALID_ARCHIVE;
+            goto on_error;
+        }
+        if (stringsOffset > pPackage->fileSize || stringsSize > pPackage->fileSize - stringsOffset) {
+            result = OC_INVALID_ARCHIVE;
+            goto on_error;
+        }
+
+        pPackage->entryCount    = entryCount;
+        pPackage->dataAlignment = dataAlignment;
+        pPackage->pEntries      = (const ocPackageEntry*)(pData + entriesOffset);
+        pPackage->pStrings      = (const char*)(pData + stringsOffset);
+
+        // The table of contents and strings are needed for every lookup so get them paged in straight away.
+        ocPackagePrefetch(pPackage, entriesOffset, entriesSize);
+        ocPackagePrefetch(pPackage, stringsOffset, stringsSize);
+
+        // Validate every entry up front so we don't need to worry about it when reading.
+        for (ocUInt32 iEntry = 0; iEntry < entryCount; ++iEntry) {
+            const ocPackageEntry* pEntry = &pPackage->pEntries[iEntry];
+            if (pEntry->dataOffset > pPackage->fileSize || pEntry->dataSize > pPackage->fileSize - pEntry->dataOffset) {
+                result = OC_INVALID_ARCHIVE;
+                goto on_error;
+            }
+            if (pEntry->pathOffset >= stringsSize || pEntry->pathLength >= stringsSize - pEntry->pathOffset || pPackage->pStrings[pEntry->pathOffset + pEntry->pathLength] != '\0') {
+                result = OC_INVALID_ARCHIVE;
+                goto on_error;
+            }
+            if (!ocIsBitSet(pEntry->flags, OC_PACKAGE_ENTRY_FLAG_COMPRESSED) && pEntry->dataSize != pEntry->uncompressedSize) {
+                result = OC_INVALID_ARCHIVE;
+                goto on_error;
+            }
+            if (iEntry > 0 && pEntry->pathHash < pPackage->pEntries[iEntry-1].pathHash) {
+                result = OC_INVALID_ARCHIVE;    // Not sorted.
+                goto on_error;
+            }
+        }
+    }
+
+    return OC_SUCCESS;
+
+on_error:
+#ifdef OC_WIN32
+    ocPackageUnmap__Win32(pPackage);
+#endif
+#ifdef OC_POSIX
+    ocPackageUnmap__Posix(pPackage);
+#endif
+    ocZeroObject(pPackage);
+    return result;
+}
+
+void ocPackageClose(ocPackage* pPackage)
+{
+    if (pPackage == NULL || pPackage->pFileData == NULL) {
+        return;
+    }
+
+#ifdef OC_WIN32
+    ocPackageUnmap__Win32(pPackage);
+#endif
+#ifdef OC_POSIX
+    ocPackageUnmap__Posix(pPackage);
+#endif
+}
+
+const ocPackageEntry* ocPackageFindEntry(ocPackage* pPackage, const char* path)
+{
+    if (pPackage == NULL || path == NULL) {
+        return NULL;
+    }
+
+    path = ocPackageSkipPathPrefix(path);
+    ocUInt64 hash = ocPackageHashPath(path);
+
+    // Lower bound.
+    ocUInt32 lo = 0;
+    ocUInt32 hi = pPackage->entryCount;
+    while (lo < hi) {
+        ocUInt32 mid = lo + (hi - lo)/2;
+        if (pPackage->pEntries[mid].pathHash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // There may be multiple entries with the same hash.
+    for (ocUInt32 iEntry = lo; iEntry < pPackage->entryCount && pPackage->pEntries[iEntry].pathHash == hash; ++iEntry) {
+        const ocPackageEntry* pEntry = &pPackage->pEntries[iEntry];
+        if (ocPackagePathEqual(pPackage->pStrings + pEntry->pathOffset, pEntry->pathLength, path)) {
+            return pEntry;
+        }
+    }
+
+    return NULL;
+}
+
+const char* ocPackageGetEntryPath(ocPackage* pPackage, const ocPackageEntry* pEntry)
+{
+    if (pPackage == NULL || pEntry == NULL) {
+        return NULL;
+    }
+
+    return pPackage->pStrings + pEntry->pathOffset;
+}
+
+const void* ocPackageGetEntryData(ocPackage* pPackage, const ocPackageEntry* pEntry)
+{
+    if (pPackage == NULL || pEntry == NULL) {
+        return NULL;
+    }
+
+    return pPackage->pFileData + pEntry->dataOffset;
+}
+
+ocResult ocPackageReadEntry(ocPackage* pPackage, const ocPackageEntry* pEntry, void* pDst, ocSizeT dstSize)
+{
+    if (pPackage == NULL || pEntry == NULL || pDst == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (dstSize < pEntry->uncompressedSize) {
+        return OC_INVALID_ARGS;
+    }
+
+    const void* pEntryData = pPackage->pFileData + pEntry->dataOffset;
+    if (ocIsBitSet(pEntry->flags, OC_PACKAGE_ENTRY_FLAG_COMPRESSED)) {
+        return ocLZDecompress(pEntryData, (ocSizeT)pEntry->dataSize, pDst, (ocSizeT)pEntry->uncompressedSize);
+    } else {
+        ocCopyMemory(pDst, pEntryData, (ocSizeT)pEntry->dataSize);
+        return OC_SUCCESS;
+    }
+}
+
+void ocPackagePrefetchEntry(ocPackage* pPackage, const ocPackageEntry* pEntry)
+{
+    if (pPackage == NULL || pEntry == NULL) {
+        return;
+    }
+
+    ocPackagePrefetch(pPackage, pEntry->dataOffset, pEntry->dataSize);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ocPackageBuilder
+//
+///////////////////////////////////////////////////////////////////////////////
+
+OC_PRIVATE int ocPackageBuilderEntryCompare(const void* a, const void* b)
+{
+    const ocPackageBuilderEntry* pEntryA = (const ocPackageBuilderEntry*)a;
+    const ocPackageBuilderEntry* pEntryB = (const ocPackageBuilderEntry*)b;
+
+    if (pEntryA->pathHash < pEntryB->pathHash) return -1;
+    if (pEntryA->pathHash > pEntryB->pathHash) return +1;
+    return strcmp(pEntryA->path, pEntryB->path);
+}
+
+OC_PRIVATE ocResult ocPackageBuilderWritePadding(ocStreamWriter* pWriter, ocUInt64* pRunningOffset, ocUInt64 alignment)
+{
+    static const ocUInt8 zeros[256] = {0};
+
+    ocUInt64 paddingSize = ocAlign(*pRunningOffset, alignment) - *pRunningOffset;
+    while (paddingSize > 0) {
+        ocSizeT bytesToWrite = (ocSizeT)ocMin(paddingSize, sizeof(zeros));
+        ocResult result = ocStreamWriterWrite(pWriter, zeros, bytesToWrite, NULL);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        paddingSize     -= bytesToWrite;
+        *pRunningOffset += bytesToWrite;
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocPackageBuilderInit(ocUInt32 dataAlignment, ocPackageBuilder* pBuilder)
+{
+    if (pBuilder == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pBuilder);
+
+    if (dataAlignment == 0) {
+        dataAlignment = OC_PACKAGE_DEFAULT_ALIGNMENT;
+    }
+
+    // Must be a power of 2 and at least 64-bit aligned to keep consistent with the rest of the OCD format.
+    if ((dataAlignment & (dataAlignment - 1)) != 0 || dataAlignment < 8) {
+        return OC_INVALID_ARGS;
+    }
+
+    pBuilder->dataAlignment = dataAlignment;
+    ocStackInit(&pBuilder->entries);
+
+    return OC_SUCCESS;
+}
+
+ocResult ocPackageBuilderUninit(ocPackageBuilder* pBuilder)
+{
+    if (pBuilder == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    for (ocSizeT iEntry = 0; iEntry < pBuilder->entries.count; ++iEntry) {
+        ocFreeString(pBuilder->entries.pItems[iEntry].path);
+        ocFreeString(pBuilder->entries.pItems[iEntry].sourceAbsolutePath);
+    }
+
+    ocStackUninit(&pBuilder->entries);
+    return OC_SUCCESS;
+}
+
+ocResult ocPackageBuilderAddFile(ocPackageBuilder* pBuilder, const char* path, const char* sourceAbsolutePath, ocUInt64 lastModifiedTime, ocUInt32 flags)
+{
+    if (pBuilder == NULL || path == NULL || sourceAbsolutePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocPackageBuilderEntry entry;
+    entry.path = ocMakeString(ocPackageSkipPathPrefix(path));
+    if (entry.path == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocPathToForwardSlashes(entry.path);
+
+    if (entry.path[0] == '\0') {
+        ocFreeString(entry.path);
+        return OC_INVALID_ARGS;
+    }
+
+    entry.sourceAbsolutePath = ocMakeString(sourceAbsolutePath);
+    if (entry.sourceAbsolutePath == NULL) {
+        ocFreeString(entry.path);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    entry.pathHash = ocPackageHashPath(entry.path);
+    entry.lastModifiedTime = lastModifiedTime;
+    entry.flags = flags & OC_PACKAGE_ENTRY_FLAG_COMPRESSED;
+
+    ocResult result = ocStackPush(&pBuilder->entries, entry);
+    if (result != OC_SUCCESS) {
+        ocFreeString(entry.sourceAbsolutePath);
+        ocFreeString(entry.path);
+        return result;
+    }
+
+    return OC_SUCCESS;
+}
+
+ocResult ocPackageBuilderRender(ocPackageBuilder* pBuilder, ocStreamWriter* pWriter)
+{
+    if (pBuilder == NULL || pWriter == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (pBuilder->entries.count > 0xFFFFFFFF) {
+        return OC_TOO_LARGE;
+    }
+
+    ocResult result = OC_SUCCESS;
+    ocUInt32 entryCount = (ocUInt32)pBuilder->entries.count;
+
+    // The table of contents is sorted so lookups can be done with a binary search.
+    if (entryCount > 0) {
+        qsort(pBuilder->entries.pItems, entryCount, sizeof(ocPackageBuilderEntry), ocPackageBuilderEntryCompare);
+    }
+
+    for (ocUInt32 iEntry = 1; iEntry < entryCount; ++iEntry) {
+        if (ocPackageBuilderEntryCompare(&pBuilder->entries.pItems[iEntry-1], &pBuilder->entries.pItems[iEntry]) == 0) {
+            return OC_ALREADY_EXISTS;   // Duplicate path.
+        }
+    }
+
+    ocPackageEntry* pEntries = (ocPackageEntry*)ocCalloc(ocMax(entryCount, 1), sizeof(*pEntries));
+    if (pEntries == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // The string data comes straight after the table of contents. Paths are padded to keep the data after it 64-bit aligned.
+    ocUInt64 entriesOffset = OC_OCD_HEADER_SIZE + OC_PACKAGE_HEADER_SIZE;
+    ocUInt64 stringsOffset = entriesOffset + ((ocUInt64)entryCount * sizeof(ocPackageEntry));
+    ocUInt64 stringsSize   = 0;
+    for (ocUInt32 iEntry = 0; iEntry < entryCount; ++iEntry) {
+        ocSizeT pathLength = strlen(pBuilder->entries.pItems[iEntry].path);
+
+        pEntries[iEntry].pathHash         = pBuilder->entries.pItems[iEntry].pathHash;
+        pEntries[iEntry].pathOffset       = stringsSize;
+        pEntries[iEntry].pathLength       = (ocUInt32)pathLength;
+        pEntries[iEntry].lastModifiedTime = pBuilder->entries.pItems[iEntry].lastModifiedTime;
+
+        stringsSize += pathLength + 1;
+    }
+    stringsSize = ocAlign(stringsSize, 8);
+
+    ocUInt64 runningOffset = 0;
+
+    // Header.
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, OC_OCD_FOURCC);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, OC_OCD_TYPE_ID_PACKAGE);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, entryCount);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt32>(pWriter, pBuilder->dataAlignment);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt64>(pWriter, entriesOffset);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt64>(pWriter, stringsOffset);
+    if (result != OC_SUCCESS) goto done;
+    result = ocStreamWriterWrite<ocUInt64>(pWriter, stringsSize);
+    if (result != OC_SUCCESS) goto done;
+    runningOffset = entriesOffset;
+
+    // The table of contents is not complete yet because we don't know the sizes of compressed entries. It's written again at the end.
+    result = ocStreamWriterWrite(pWriter, pEntries, (ocSizeT)(stringsOffset - entriesOffset), NULL);
+    if (result != OC_SUCCESS) goto done;
+    runningOffset = stringsOffset;
+
+    // Strings.
+    for (ocUInt32 iEntry = 0; iEntry < entryCount; ++iEntry) {
+        result = ocStreamWriterWrite(pWriter, pBuilder->entries.pItems[iEntry].path, pEntries[iEntry].pathLength + 1, NULL);
+        if (result != OC_SUCCESS) goto done;
+        runningOffset += pEntries[iEntry].pathLength + 1;
+    }
+
+    result = ocPackageBuilderWritePadding(pWriter, &runningOffset, 8);
+    if (result != OC_SUCCESS) goto done;
+
+    // Data.
+    for (ocUInt32 iEntry = 0; iEntry < entryCount; ++iEntry) {
+        ocPackageBuilderEntry* pBuilderEntry = &pBuilder->entries.pItems[iEntry];
+
+        void* pFileData;
+        ocSizeT fileSize;
+        result = ocOpenAndReadFile(pBuilderEntry->sourceAbsolutePath, &pFileData, &fileSize);
+        if (result != OC_SUCCESS) goto done;
+
+        const void* pEntryData = pFileData;
+        ocSizeT entryDataSize = fileSize;
+        void* pCompressedData = NULL;
+
+        if (ocIsBitSet(pBuilderEntry->flags, OC_PACKAGE_ENTRY_FLAG_COMPRESSED) && fileSize > 0) {
+            ocSizeT compressedCapacity = ocLZCompressBound(fileSize);
+            pCompressedData = ocMalloc(compressedCapacity);
+            if (pCompressedData == NULL) {
+                ocFree(pFileData);
+                result = OC_OUT_OF_MEMORY;
+                goto done;
+            }
+
+            ocSizeT compressedSize;
+            result = ocLZCompress(pFileData, fileSize, pCompressedData, compressedCapacity, &compressedSize);
+            if (result != OC_SUCCESS) {
+                ocFree(pCompressedData);
+                ocFree(pFileData);
+                goto done;
+            }
+
+            // Only keep the compressed version if it's actually smaller.
+            if (compressedSize < fileSize) {
+                pEntryData    = pCompressedData;
+                entryDataSize = compressedSize;
+                pEntries[iEntry].flags |= OC_PACKAGE_ENTRY_FLAG_COMPRESSED;
+            }
+        }
+
+        result = ocPackageBuilderWritePadding(pWriter, &runningOffset, pBuilder->dataAlignment);
+        if (result == OC_SUCCESS) {
+            pEntries[iEntry].dataOffset       = runningOffset;
+            pEntries[iEntry].dataSize         = entryDataSize;
+            pEntries[iEntry].uncompressedSize = fileSize;
+
+            if (entryDataSize > 0) {
+                result = ocStreamWriterWrite(pWriter, pEntryData, entryDataSize, NULL);
+                runningOffset += entryDataSize;
+            }
+        }
+
+        ocFree(pCompressedData);
+        ocFree(pFileData);
+
+        if (result != OC_SUCCESS) goto done;
+    }
+
+    result = ocPackageBuilderWritePadding(pWriter, &runningOffset, 8);
+    if (result != OC_SUCCESS) goto done;
+
+    // Now go back and write the complete table of contents.
+    result = ocStreamWriterSeek(pWriter, (ocInt64)entriesOffset, ocSeekOrigin_Start);
+    if (result != OC_SUCCESS) goto done;
+
+    result = ocStreamWriterWrite(pWriter, pEntries, (ocSizeT)(stringsOffset - entriesOffset), NULL);
+    if (result != OC_SUCCESS) goto done;
+
+    result = ocStreamWriterSeek(pWriter, (ocInt64)runningOffset, ocSeekOrigin_Start);
+
+done:
+    ocFree(pEntries);
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Packages are OCD files of type 'PAK1'. They're used for shipping large numbers of files as a single file so that we don't need
+// to hit the operating system with an open() and stat() for every individual asset. See docs/OCDFileFormat.txt for the layout.
+//
+// A package is memory mapped when it's opened. Uncompressed entries are read directly out of the mapping. Compressed entries are
+// decompressed into a separate buffer when they are opened.
+
+#define OC_PACKAGE_ENTRY_FLAG_COMPRESSED    0x00000001
+
+#define OC_PACKAGE_DEFAULT_ALIGNMENT        64
+#define OC_PACKAGE_EXTENSION                "ocpak"
+
+// Maps directly to the entries in the table of contents.
+struct ocPackageEntry
+{
+    ocUInt64 pathHash;
+    ocUInt64 pathOffset;        // Relative to the string data.
+    ocUInt64 dataOffset;        // Relative to the start of the file.
+    ocUInt64 dataSize;          // The size of the data as it's stored in the file.
+    ocUInt64 uncompressedSize;
+    ocUInt64 lastModifiedTime;
+    ocUInt32 flags;
+    ocUInt32 pathLength;        // Not including the null terminator.
+};
+
+struct ocPackage
+{
+    char absolutePath[OC_MAX_PATH];
+    ocUInt32 entryCount;
+    ocUInt32 dataAlignment;
+    const ocPackageEntry* pEntries;     // Sorted by hash, and then by path.
+    const char* pStrings;
+    const ocUInt8* pFileData;
+    ocUInt64 fileSize;
+
+#ifdef OC_WIN32
+    HANDLE hFile;
+    HANDLE hFileMapping;
+#endif
+#ifdef OC_POSIX
+    int fd;
+#endif
+};
+
+// Opens a package.
+ocResult ocPackageOpen(const char* absolutePath, ocPackage* pPackage);
+
+// Closes a package.
+//
+// This will invalidate any pointers returned by ocPackageGetEntryData(), including those of files opened with ocFileOpen().
+void ocPackageClose(ocPackage* pPackage);
+
+// Hashes a path the same way paths are hashed in the table of contents.
+ocUInt64 ocPackageHashPath(const char* path);
+
+// Finds an entry by it's path. The path should be relative to the root of the package. Returns NULL if the entry does not exist.
+//
+// This is a binary search on the hash, so it does not touch any string data unless there's a hash match.
+const ocPackageEntry* ocPackageFindEntry(ocPackage* pPackage, const char* path);
+
+// Retrieves the path of the given entry.
+const char* ocPackageGetEntryPath(ocPackage* pPackage, const ocPackageEntry* pEntry);
+
+// Retrieves a pointer to the data of the given entry, as it's stored in the package. For compressed entries this is the compressed data.
+const void* ocPackageGetEntryData(ocPackage* pPackage, const ocPackageEntry* pEntry);
+
+// Reads an entry, decompressing it if necessary. dstSize must be at least pEntry->uncompressedSize.
+ocResult ocPackageReadEntry(ocPackage* pPackage, const ocPackageEntry* pEntry, void* pDst, ocSizeT dstSize);
+
+// Hints to the operating system that the data of the given entry is about to be read so that it can start paging it in.
+void ocPackagePrefetchEntry(ocPackage* pPackage, const ocPackageEntry* pEntry);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ocPackageBuilder
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct ocPackageBuilderEntry
+{
+    char* path;
+    char* sourceAbsolutePath;
+    ocUInt64 pathHash;
+    ocUInt64 lastModifiedTime;
+    ocUInt32 flags;
+};
+
+struct ocPackageBuilder
+{
+    ocUInt32 dataAlignment;
+    ocStack<ocPackageBuilderEntry> entries;
+};
+
+// Initializes a package builder.
+//
+// Every entry will be aligned to dataAlignment bytes relative to the start of the file. Set this to the page size if you want to
+// be able to map individual entries. Set to 0 to use OC_PACKAGE_DEFAULT_ALIGNMENT.
+ocResult ocPackageBuilderInit(ocUInt32 dataAlignment, ocPackageBuilder* pBuilder);
+
+// Uninitializes a package builder.
+ocResult ocPackageBuilderUninit(ocPackageBuilder* pBuilder);
+
+// Adds a file to the package.
+//
+// The file is not read until ocPackageBuilderRender() is called. Set OC_PACKAGE_ENTRY_FLAG_COMPRESSED in flags to compress the
+// entry. Compression will be disabled for the entry if it does not make it any smaller.
+ocResult ocPackageBuilderAddFile(ocPackageBuilder* pBuilder, const char* path, const char* sourceAbsolutePath, ocUInt64 lastModifiedTime, ocUInt32 flags);
+
+// Outputs the package to the given writer. The writer must be positioned at the start of the file and must support seeking.
+ocResult ocPackageBuilderRender(ocPackageBuilder* pBuilder, ocStreamWriter* pWriter);
\ No newline at end of file
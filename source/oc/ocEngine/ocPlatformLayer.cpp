@@ -890,7 +890,7 @@ void ocTimerInit_Linux(ocTimer* pTimer)
     ocAssert(pTimer != NULL);
 
     struct timespec newTime;
-    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &newTime);
+    clock_gettime(CLOCK_MONOTONIC, &newTime);
 
     pTimer->counter = (newTime.tv_sec * 1000000000LL) + newTime.tv_nsec;
 }
@@ -900,7 +900,7 @@ double ocTimerTick_Linux(ocTimer* pTimer)
     ocAssert(pTimer != NULL);
 
     struct timespec newTime;
-    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &newTime);
+    clock_gettime(CLOCK_MONOTONIC, &newTime);
 
     uint64_t newTimeCounter = (newTime.tv_sec * 1000000000LL) + newTime.tv_nsec;
     uint64_t oldTimeCounter = pTimer->counter;
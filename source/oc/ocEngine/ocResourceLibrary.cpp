@@ -1,6 +1,9 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
-ocResult ocResourceLibraryInit(ocResourceLoader* pLoader, ocGraphicsContext* pGraphics, ocResourceLibrary* pLibrary)
+OC_PRIVATE void ocResourceLibraryFreeResource(ocResourceLibrary* pLibrary, ocResource* pResource);
+OC_PRIVATE void ocResourceLibraryDisableHotReload(ocResourceLibrary* pLibrary);
+
+ocResult ocResourceLibraryInit(ocResourceLoader* pLoader, ocGraphicsContext* pGraphics, ocDerivedDataCache* pCache, ocResourceLibrary* pLibrary)
 {
     if (pLibrary == NULL) {
         return OC_INVALID_ARGS;
@@ -14,6 +17,24 @@ ocResult ocResourceLibraryInit(ocResourceLoader* pLoader, ocGraphicsContext* pGr
 
     pLibrary->pLoader = pLoader;
     pLibrary->pGraphics = pGraphics;
+    pLibrary->pCache = pCache;
+
+    if (!ocMutexInit(&pLibrary->lock)) {
+        return OC_ERROR;
+    }
+
+    ocResult result = ocStackInit(&pLibrary->resources);
+    if (result != OC_SUCCESS) {
+        ocMutexUninit(&pLibrary->lock);
+        return result;
+    }
+
+    pLibrary->stats.types[ocResourceType_Image].budgetInBytes = OC_RESOURCE_LIBRARY_DEFAULT_IMAGE_BUDGET;
+    pLibrary->stats.types[ocResourceType_Material].budgetInBytes = OC_RESOURCE_LIBRARY_DEFAULT_MATERIAL_BUDGET;
+    pLibrary->stats.types[ocResourceType_Scene].budgetInBytes = OC_RESOURCE_LIBRARY_DEFAULT_SCENE_BUDGET;
+    pLibrary->stats.types[ocResourceType_Sound].budgetInBytes = OC_RESOURCE_LIBRARY_DEFAULT_SOUND_BUDGET;
+    pLibrary->stats.types[ocResourceType_Skeleton].budgetInBytes = OC_RESOURCE_LIBRARY_DEFAULT_SKELETON_BUDGET;
+    pLibrary->stats.types[ocResourceType_Animation].budgetInBytes = OC_RESOURCE_LIBRARY_DEFAULT_ANIMATION_BUDGET;
 
     return OC_SUCCESS;
 }
@@ -23,6 +44,17 @@ void ocResourceLibraryUninit(ocResourceLibrary* pLibrary)
     if (pLibrary == NULL) {
         return;
     }
+
+    ocResourceLibraryDisableHotReload(pLibrary);
+
+    // Anything still in memory at this point is either unused or has been leaked. Either way it needs to be freed while the graphics
+    // context is still alive.
+    for (size_t i = 0; i < pLibrary->resources.count; ++i) {
+        ocResourceLibraryFreeResource(pLibrary, pLibrary->resources.pItems[i]);
+    }
+
+    ocStackUninit(&pLibrary->resources);
+    ocMutexUninit(&pLibrary->lock);
 }
 
 
@@ -44,232 +76,1624 @@ OC_PRIVATE ocResource* ocAllocResource(ocResourceType type, size_t payloadSize,
     pResource->type = type;
     pResource->pAbsolutePath = (const char*)pResource->_pPayload;
     pResource->referenceCount = 1;
+    pResource->cpuSizeInBytes = sizeof(*pResource) + pathLen + payloadSize;
 
     return pResource;
 }
 
-OC_PRIVATE ocResult ocResourceLibraryLoad_Image(ocResourceLibrary* pLibrary, const char* absolutePath, ocResource** ppResource)
+// Frees a resource and everything it owns. The resource must have already been removed from the library.
+OC_PRIVATE void ocResourceLibraryFreeResource(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pResource != NULL);
+
+    switch (pResource->type)
+    {
+        case ocResourceType_Image:
+        {
+            ocGraphicsDeleteImage(pLibrary->pGraphics, pResource->image.pGraphicsImage);
+        } break;
+
+        case ocResourceType_Material:
+        {
+            ocResourceLoaderUnloadMaterial(pLibrary->pLoader, &pResource->material);
+        } break;
+
+        case ocResourceType_Scene:
+        {
+            ocResourceLoaderUnloadScene(pLibrary->pLoader, &pResource->scene);
+        } break;
+
+        case ocResourceType_Sound:
+        {
+            ocResourceLoaderUnloadSound(pLibrary->pLoader, &pResource->sound);
+        } break;
+
+        case ocResourceType_Skeleton:
+        {
+            ocResourceLoaderUnloadSkeleton(pLibrary->pLoader, &pResource->skeleton);
+        } break;
+
+        case ocResourceType_Animation:
+        {
+            ocResourceLoaderUnloadAnimation(pLibrary->pLoader, &pResource->animation);
+        } break;
+
+        case ocResourceType_Unknown:
+        default: break;
+    }
+
+    ocFree(pResource);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Residency
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Every resource in memory is kept in a list sorted by absolute path so that loading a resource that's already in memory just returns
+// another reference to it. When a resource's reference count drops to 0 it's moved to the front of the unused list rather than being
+// freed. Loading it again takes it back off the list. When a resource type goes over budget, unused resources of that type are evicted
+// from the back of the list which means the least recently used are evicted first.
+//
+// Everything in this section requires the library's lock to be held.
+
+// Finds the index of the resource with the given absolute path. When the resource is not in memory, pIndex receives the index at which it
+// would be inserted.
+OC_PRIVATE ocBool32 ocResourceLibraryFindResident(ocResourceLibrary* pLibrary, const char* absolutePath, size_t* pIndex)
 {
     ocAssert(pLibrary != NULL);
     ocAssert(absolutePath != NULL);
-    ocAssert(ppResource != NULL);
+    ocAssert(pIndex != NULL);
+
+    size_t lo = 0;
+    size_t hi = pLibrary->resources.count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo)/2;
+        int cmp = strcmp(pLibrary->resources.pItems[mid]->pAbsolutePath, absolutePath);
+        if (cmp == 0) {
+            *pIndex = mid;
+            return OC_TRUE;
+        }
+
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
 
-    ocImageData data;
-    ocResult result = ocResourceLoaderLoadImage(pLibrary->pLoader, absolutePath, &data);
+    *pIndex = lo;
+    return OC_FALSE;
+}
+
+OC_PRIVATE ocResult ocResourceLibraryInsertResident(ocResourceLibrary* pLibrary, ocResource* pResource, size_t index)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pResource != NULL);
+    ocAssert(index <= pLibrary->resources.count);
+
+    // Pushing grows the list by one. Everything after the insertion point is then moved up to make room.
+    ocResult result = ocStackPush(&pLibrary->resources, pResource);
     if (result != OC_SUCCESS) {
         return result;
     }
 
+    ocResource** ppItems = pLibrary->resources.pItems;
+    memmove(ppItems + index + 1, ppItems + index, (pLibrary->resources.count - 1 - index) * sizeof(*ppItems));
+    ppItems[index] = pResource;
 
-    // Generate mipmaps if necessary.
-    ocBool32 freeImageData = OC_FALSE;
-    ocSizeT imageDataSize  = (ocSizeT)data.imageDataSize;
-    void* pImageData       = data.pImageData;
-    ocUInt32 mipmapCount   = data.mipmapCount;
-    ocMipmapInfo pMipmaps[32];
-    if (mipmapCount == 1) {
-        // Generate mipmaps.
-        ocUInt32 baseWidth  = data.pMipmaps[0].width;
-        ocUInt32 baseHeight = data.pMipmaps[0].height;
-        ocGetMipmapCount(baseWidth, baseHeight, &mipmapCount);
-        ocGetTotalMipmapDataSize(baseWidth, baseHeight, 4, sizeof(uintptr_t), &imageDataSize);
-
-        pImageData = ocMalloc(imageDataSize);
-        if (pImageData == NULL) {
-            ocResourceLoaderUnloadImage(pLibrary->pLoader, &data);
-            return OC_OUT_OF_MEMORY;
-        }
+    ocResourceLibraryTypeStats* pTypeStats = &pLibrary->stats.types[pResource->type];
+    pTypeStats->residentCount  += 1;
+    pTypeStats->cpuSizeInBytes += pResource->cpuSizeInBytes;
+    pTypeStats->gpuSizeInBytes += pResource->gpuSizeInBytes;
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocResourceLibraryRemoveResident(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pResource != NULL);
+
+    size_t index;
+    if (!ocResourceLibraryFindResident(pLibrary, pResource->pAbsolutePath, &index)) {
+        ocAssert(OC_FALSE);
+        return;
+    }
+
+    ocResource** ppItems = pLibrary->resources.pItems;
+    memmove(ppItems + index, ppItems + index + 1, (pLibrary->resources.count - 1 - index) * sizeof(*ppItems));
+    pLibrary->resources.count -= 1;
+
+    ocResourceLibraryTypeStats* pTypeStats = &pLibrary->stats.types[pResource->type];
+    pTypeStats->residentCount  -= 1;
+    pTypeStats->cpuSizeInBytes -= pResource->cpuSizeInBytes;
+    pTypeStats->gpuSizeInBytes -= pResource->gpuSizeInBytes;
+}
+
+// Adds a resource to the front of the unused list.
+OC_PRIVATE void ocResourceLibraryLinkUnused(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pResource != NULL);
+    ocAssert(pResource->referenceCount == 0);
 
-        freeImageData = OC_TRUE;
-        ocGenerateMipmaps(baseWidth, baseHeight, 4, sizeof(uintptr_t), data.pImageData, pImageData, pMipmaps);
+    pResource->pPrevUnused = NULL;
+    pResource->pNextUnused = pLibrary->pFirstUnused;
+    if (pLibrary->pFirstUnused != NULL) {
+        pLibrary->pFirstUnused->pPrevUnused = pResource;
     } else {
-        // Use pre-generated mipmaps.
-        memcpy(pMipmaps, data.pMipmaps, mipmapCount * sizeof(ocMipmapInfo));
+        pLibrary->pLastUnused = pResource;
     }
-                
+    pLibrary->pFirstUnused = pResource;
 
-    ocGraphicsImageDesc desc;
-    desc.usage         = OC_GRAPHICS_IMAGE_USAGE_SHADER_INPUT;
-    desc.format        = data.format;
-    desc.mipLevels     = mipmapCount;
-    desc.pMipmaps      = pMipmaps;
-    desc.imageDataSize = imageDataSize;
-    desc.pImageData    = pImageData;
+    ocResourceLibraryTypeStats* pTypeStats = &pLibrary->stats.types[pResource->type];
+    pTypeStats->unusedCount       += 1;
+    pTypeStats->unusedSizeInBytes += pResource->cpuSizeInBytes + pResource->gpuSizeInBytes;
+}
 
-    ocGraphicsImage* pGraphicsImage;
-    result = ocGraphicsCreateImage(pLibrary->pGraphics, &desc, &pGraphicsImage);
-    if (result != OC_SUCCESS) {
-        if (freeImageData) {
-            ocFree(pImageData);
-        }
+OC_PRIVATE void ocResourceLibraryUnlinkUnused(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pResource != NULL);
+    ocAssert(pResource->referenceCount == 0);
 
-        ocResourceLoaderUnloadImage(pLibrary->pLoader, &data);
-        return result;
+    if (pResource->pPrevUnused != NULL) {
+        pResource->pPrevUnused->pNextUnused = pResource->pNextUnused;
+    } else {
+        pLibrary->pFirstUnused = pResource->pNextUnused;
     }
 
-    if (freeImageData) {
-        ocFree(pImageData);
+    if (pResource->pNextUnused != NULL) {
+        pResource->pNextUnused->pPrevUnused = pResource->pPrevUnused;
+    } else {
+        pLibrary->pLastUnused = pResource->pPrevUnused;
     }
 
-    ocResource* pResource = ocAllocResource(ocResourceType_Image, 0, absolutePath);
-    if (pResource == NULL) {
-        ocResourceLoaderUnloadImage(pLibrary->pLoader, &data);
-        return OC_OUT_OF_MEMORY;
+    pResource->pPrevUnused = NULL;
+    pResource->pNextUnused = NULL;
+
+    ocResourceLibraryTypeStats* pTypeStats = &pLibrary->stats.types[pResource->type];
+    pTypeStats->unusedCount       -= 1;
+    pTypeStats->unusedSizeInBytes -= pResource->cpuSizeInBytes + pResource->gpuSizeInBytes;
+}
+
+// Adds a reference to a resource that's in memory, taking it off the unused list if necessary.
+OC_PRIVATE void ocResourceLibraryAcquire(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pResource != NULL);
+
+    if (pResource->referenceCount == 0) {
+        ocResourceLibraryUnlinkUnused(pLibrary, pResource);
     }
 
-    pResource->image.pGraphicsImage = pGraphicsImage;
+    pResource->referenceCount += 1;
+}
+
+// Evicts unused resources of the given type, least recently used first, until the type is within budget or there's nothing left to evict.
+OC_PRIVATE void ocResourceLibraryEnforceBudget(ocResourceLibrary* pLibrary, ocResourceType type)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(type < ocResourceType_Count);
 
-    ocResourceLoaderUnloadImage(pLibrary->pLoader, &data);
+    ocResourceLibraryTypeStats* pTypeStats = &pLibrary->stats.types[type];
 
-    *ppResource = pResource;
-    return result;
+    ocResource* pResource = pLibrary->pLastUnused;
+    while (pResource != NULL && pTypeStats->unusedCount > 0 && (pTypeStats->cpuSizeInBytes + pTypeStats->gpuSizeInBytes) > pTypeStats->budgetInBytes) {
+        ocResource* pPrevResource = pResource->pPrevUnused;
+        if (pResource->type == type) {
+            ocResourceLibraryUnlinkUnused(pLibrary, pResource);
+            ocResourceLibraryRemoveResident(pLibrary, pResource);
+            ocResourceLibraryFreeResource(pLibrary, pResource);
+            pLibrary->stats.evictionCount += 1;
+        }
+
+        pResource = pPrevResource;
+    }
 }
 
-OC_PRIVATE ocResult ocResourceLibraryLoad_Scene(ocResourceLibrary* pLibrary, const char* absolutePath, ocResource** ppResource)
+// Starts watching the file of a resource for changes if hot reloading is enabled. Failing to watch a file is not an error - it just
+// means the resource won't be reloaded when it changes. This is the case for every resource loaded from a package. Materials are never
+// watched since they're identified by the path of their library followed by their name, which is not a file.
+OC_PRIVATE void ocResourceLibraryWatchResource(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pResource != NULL);
+
+    if (!pLibrary->isHotReloadEnabled || pResource->type == ocResourceType_Material) {
+        return;
+    }
+
+    char directoryPath[OC_MAX_PATH];
+    if (ocPathRemoveFileName(directoryPath, sizeof(directoryPath), pResource->pAbsolutePath) > 0) {
+        ocFileWatcherWatchDirectory(&pLibrary->watcher, directoryPath);
+    }
+}
+
+// Adds a newly created resource to the library. If the same resource was put into memory by another thread in the meantime, the new one
+// is freed and ppResource receives a reference to the existing one instead.
+OC_PRIVATE ocResult ocResourceLibraryRegister(ocResourceLibrary* pLibrary, ocResource** ppResource)
 {
     ocAssert(pLibrary != NULL);
-    ocAssert(absolutePath != NULL);
     ocAssert(ppResource != NULL);
+    ocAssert(*ppResource != NULL);
 
-    ocSceneData sceneData;
-    ocResult result = ocResourceLoaderLoadScene(pLibrary->pLoader, absolutePath, &sceneData);
-    if (result != OC_SUCCESS) {
-        return result;
+    ocResource* pResource = *ppResource;
+    ocResource* pExistingResource = NULL;
+    ocResult result = OC_SUCCESS;
+
+    ocMutexLock(&pLibrary->lock);
+    pLibrary->stats.missCount += 1;
+
+    size_t index;
+    if (ocResourceLibraryFindResident(pLibrary, pResource->pAbsolutePath, &index)) {
+        pExistingResource = pLibrary->resources.pItems[index];
+        ocResourceLibraryAcquire(pLibrary, pExistingResource);
+    } else {
+        result = ocResourceLibraryInsertResident(pLibrary, pResource, index);
+        if (result == OC_SUCCESS) {
+            ocResourceLibraryWatchResource(pLibrary, pResource);
+            ocResourceLibraryEnforceBudget(pLibrary, pResource->type);
+        }
     }
+    ocMutexUnlock(&pLibrary->lock);
 
-    ocResource* pResource = ocAllocResource(ocResourceType_Scene, 0, absolutePath);
-    if (pResource == NULL) {
-        ocResourceLoaderUnloadScene(pLibrary->pLoader, &sceneData);
-        return OC_OUT_OF_MEMORY;
+    if (pExistingResource != NULL) {
+        ocResourceLibraryFreeResource(pLibrary, pResource);
+        *ppResource = pExistingResource;
+    } else if (result != OC_SUCCESS) {
+        ocResourceLibraryFreeResource(pLibrary, pResource);
+        *ppResource = NULL;
     }
 
-    pResource->scene = sceneData;
+    return result;
+}
 
-    *ppResource = pResource;
-    return OC_SUCCESS;
+// Loading is done in stages so that groups of resources can be loaded efficiently. Each file is resolved first, then the data of every
+// file is read with a single batch of asynchronous reads, and then each resource is created from the data that was read.
+//
+// Everything up to and including decoding is independent for each resource so it's done on the job queue. Only the final step, which
+// creates graphics objects, needs to happen on the calling thread.
+struct ocResourceLibraryLoadItem
+{
+    ocResourceLibrary* pLibrary;
+    ocFileInfo fileInfo;            // <-- The file that's actually loaded, which may be the .ocd file rather than the source asset.
+    ocResourceType type;
+    ocBool32 isOCD;
+    ocUInt32 converterVersion;      // <-- 0 if there is no converter for the resource type, in which case it's loaded from it's path.
+    ocUInt32 duplicateOf;           // <-- 1 + the index of an earlier item for the same file, or 0 if this is not a duplicate.
+    ocResource* pResidentResource;  // <-- Set when the resource is already in memory, in which case nothing needs to be loaded.
+    void* pFileData;
+    ocSizeT fileDataSize;
+    ocResult result;
+
+    // Decoded data, ready for creating the resource.
+    union
+    {
+        struct
+        {
+            ocImageData data;
+            void* pImageData;       // <-- Either data.pImageData, or the data with generated mipmaps.
+            ocSizeT imageDataSize;
+            ocUInt32 mipmapCount;
+            ocMipmapInfo pMipmaps[32];
+        } image;
+
+        ocMaterialData material;
+        ocSceneData scene;
+        ocSoundData sound;
+        ocSkeleton skeleton;
+        ocAnimationClip animation;
+    };
+};
+
+// Sounds don't have a converter, but are still loaded from the file's data so streamed sounds can keep it. Source assets with a
+// streaming converter are read straight from their file when they're cooked so they're not read here.
+OC_INLINE ocBool32 ocResourceLibraryItemNeedsFileData(const ocResourceLibraryLoadItem* pItem)
+{
+    return pItem->isOCD || (pItem->converterVersion != 0 && !ocIsStreamingConverter(pItem->type)) || pItem->type == ocResourceType_Sound;
 }
 
-ocResult ocResourceLibraryLoad(ocResourceLibrary* pLibrary, const char* filePath, ocResource** ppResource)
+// Reads the entire content of the file of each item that needs it. Items that have already failed are skipped. The result of each item is
+// updated to reflect the result of it's read.
+//
+// Free pFileData with ocFree().
+OC_PRIVATE void ocResourceLibraryReadFiles(ocResourceLibrary* pLibrary, ocResourceLibraryLoadItem* pItems, ocUInt32 itemCount)
 {
-    if (ppResource == NULL) {
-        return OC_INVALID_ARGS;
+    ocAssert(pLibrary != NULL);
+    ocAssert(pItems != NULL);
+
+    ocFileReadRequest* pRequests = (ocFileReadRequest*)ocCalloc(ocMax(itemCount, 1), sizeof(*pRequests));
+    ocUInt32* pRequestItems = (ocUInt32*)ocMalloc(ocMax(itemCount, 1) * sizeof(*pRequestItems));
+    if (pRequests == NULL || pRequestItems == NULL) {
+        ocFree(pRequests);
+        ocFree(pRequestItems);
+        for (ocUInt32 iItem = 0; iItem < itemCount; ++iItem) {
+            if (pItems[iItem].result == OC_SUCCESS) {
+                pItems[iItem].result = OC_OUT_OF_MEMORY;
+            }
+        }
+        return;
     }
 
-    *ppResource = NULL;
+    ocUInt32 requestCount = 0;
+    for (ocUInt32 iItem = 0; iItem < itemCount; ++iItem) {
+        ocResourceLibraryLoadItem* pItem = &pItems[iItem];
+        if (pItem->result != OC_SUCCESS || !ocResourceLibraryItemNeedsFileData(pItem)) {
+            continue;
+        }
 
-    if (pLibrary == NULL || filePath == NULL) {
-        return OC_INVALID_ARGS;
+        if (pItem->fileInfo.sizeInBytes > SIZE_MAX) {
+            pItem->result = OC_TOO_LARGE;
+            continue;
+        }
+
+        pItem->fileDataSize = (ocSizeT)pItem->fileInfo.sizeInBytes;
+        pItem->pFileData = ocMalloc(ocMax(pItem->fileDataSize, 1));
+        if (pItem->pFileData == NULL) {
+            pItem->result = OC_OUT_OF_MEMORY;
+            continue;
+        }
+
+        ocFileReadRequest* pRequest = &pRequests[requestCount];
+        pRequest->path   = pItem->fileInfo.absolutePath;
+        pRequest->offset = 0;
+        pRequest->size   = pItem->fileDataSize;
+        pRequest->pDst   = pItem->pFileData;
+        pRequestItems[requestCount] = iItem;
+        requestCount += 1;
     }
 
-    // So this is how resources work in the engine... Each resource file (.png, .obj, etc.) is, optionally, associated with a corresponding
-    // .ocd file. This .ocd file is located in the same location and named exactly the same, only with the ".ocd" extension appended to the
-    // end. For example, "my_texture.png" can have a "my_texture.png.ocd" file with it.
-    //
-    // There are a few reasons for the .ocd file. The first is that it is a format that's optimized for use by the engine. The second is that
-    // it provides a way of associating engine-specific metadata with the resource. Now here's an important detail - each .ocd file contains
-    // _all_ of the data of the resource which means it's able to work without the original asset.
-    //
-    // When loading an asset, we first need to check if there's a .ocd file associated with it. If so, we need to load it up. However, there's
-    // a chance the original source asset ("my_texture.png" as per the example above) has been updated. In this case the .ocd file needs to be
-    // updated to reflect the changes.
+    ocFileReadBatch batch;
+    ocResult result = ocFileSystemSubmitReads(pLibrary->pLoader->pFS, pRequests, requestCount, &batch);
+    if (result == OC_SUCCESS) {
+        ocFileSystemWaitForReads(&batch);
+    }
 
-    // If it's an .ocd file just load it directly without looking at the original source asset.
-    ocFileInfo fileInfoSrc;
-    ocBool32 hasSrc = ocGetFileInfo(pLibrary->pLoader->pFS, filePath, &fileInfoSrc) == OC_SUCCESS;
+    for (ocUInt32 iRequest = 0; iRequest < requestCount; ++iRequest) {
+        ocResourceLibraryLoadItem* pItem = &pItems[pRequestItems[iRequest]];
+        if (result == OC_SUCCESS) {
+            pItem->result = pRequests[iRequest].result;
 
-    ocFileInfo fileInfoOCD;
-    ocZeroObject(&fileInfoOCD);
-    ocBool32 hasOCD = OC_FALSE;
-    if (!ocPathExtensionEqual(filePath, "ocd")) {
-        char filePathOCD[OC_MAX_PATH];
-        if (ocPathAppendExtension(filePathOCD, sizeof(filePathOCD), filePath, "ocd")) {
-            hasOCD = ocGetFileInfo(pLibrary->pLoader->pFS, filePathOCD, &fileInfoOCD) == OC_SUCCESS;
+            // The file may have been truncated since it's size was retrieved.
+            pItem->fileDataSize = pRequests[iRequest].bytesRead;
+        } else {
+            pItem->result = result;
+        }
+
+        if (pItem->result != OC_SUCCESS) {
+            ocFree(pItem->pFileData);
+            pItem->pFileData = NULL;
+            pItem->fileDataSize = 0;
         }
     }
 
-    if (!hasSrc && !hasOCD) {
-        return OC_DOES_NOT_EXIST;
+    ocFree(pRequests);
+    ocFree(pRequestItems);
+}
+
+OC_PRIVATE ocUInt32 ocResourceTypeToOCDTypeID(ocResourceType type)
+{
+    switch (type)
+    {
+        case ocResourceType_Image: return OC_OCD_TYPE_ID_IMAGE;
+        case ocResourceType_Scene: return OC_OCD_TYPE_ID_SCENE;
+        case ocResourceType_Skeleton: return OC_OCD_TYPE_ID_SKELETON;
+        case ocResourceType_Animation: return OC_OCD_TYPE_ID_ANIMATION;
+        default: return 0;
     }
-    if (!hasSrc) {
-        fileInfoSrc = fileInfoOCD;
+}
+
+// Retrieves the OCD data of a source asset, taking it from the derived data cache if possible. When the asset needs to be converted,
+// the result is added to the cache from a worker thread so the next load can skip the conversion.
+//
+// The source asset needs to be read in it's entirety regardless of whether or not it's in the cache because the key is based on it's
+// content. This is still much faster than converting it. The reader must be at the start of the asset. When it needs to be converted
+// the reader is seeked back to the start, so assets that are read from a file are read twice on a cache miss rather than being held
+// in memory.
+//
+// Free the returned data with ocFree().
+OC_PRIVATE ocResult ocResourceLibraryCook(ocResourceLibrary* pLibrary, const char* absolutePath, ocResourceType type, ocStreamReader* pReader, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(absolutePath != NULL);
+    ocAssert(pReader != NULL);
+    ocAssert(ppOCDData != NULL);
+    ocAssert(pOCDDataSize != NULL);
+
+    *ppOCDData = NULL;
+    *pOCDDataSize = 0;
+
+    ocUInt32 converterVersion = ocResourceLoaderGetConverterVersion(type);
+    if (converterVersion == 0) {
+        return OC_UNSUPPORTED_RESOURCE_TYPE;
     }
 
-    // TODO: Reference count and return early based on the absolute path in fileInfoSrc.
-    //   1) Check if a resource with the same name has already been loaded. If so, increment the reference count and return early.
-    //   2) If the resource has not already been loaded, add it to a list, sorted by absolute path.
-    
+    ocResult result;
+    ocUInt64 key = 0;
+    if (pLibrary->pCache != NULL) {
+        result = ocDerivedDataCacheMakeKey(pReader, ocResourceTypeToOCDTypeID(type), converterVersion, &key);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
 
-    ocBool32 isOCDOutOfDate = (hasSrc && hasOCD) && (fileInfoSrc.lastModifiedTime > fileInfoOCD.lastModifiedTime);
+        result = ocDerivedDataCacheLoad(pLibrary->pCache, key, ppOCDData, pOCDDataSize);
+        if (result == OC_SUCCESS) {
+            return OC_SUCCESS;
+        }
 
-    // Here is where we actually load the asset. The file path we load from depends on whether or not we have an up-to-date OCD file.
-    ocResourceType resourceType;
-    ocResult result = ocResourceLoaderDetermineResourceType(pLibrary->pLoader, fileInfoSrc.absolutePath, &resourceType);
+        result = ocStreamReaderSeek(pReader, 0, ocSeekOrigin_Start);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    result = ocResourceLoaderConvertToOCD(pLibrary->pLoader, absolutePath, pReader, ppOCDData, pOCDDataSize);
     if (result != OC_SUCCESS) {
         return result;
     }
 
-    const char* absolutePath = (!isOCDOutOfDate && hasOCD) ? fileInfoOCD.absolutePath : fileInfoSrc.absolutePath;
-    switch (resourceType)
-    {
-        case ocResourceType_Image:
-        {
-            result = ocResourceLibraryLoad_Image(pLibrary, absolutePath, ppResource);
-        } break;
+    // The cache takes ownership of the data it's given so it needs a copy. A failure here is not fatal - it just means the asset
+    // will be converted again next time.
+    if (pLibrary->pCache != NULL) {
+        void* pCacheData = ocMalloc(*pOCDDataSize);
+        if (pCacheData != NULL) {
+            ocCopyMemory(pCacheData, *ppOCDData, *pOCDDataSize);
+            ocDerivedDataCacheStoreAsync(pLibrary->pCache, key, pCacheData, *pOCDDataSize);
+        }
+    }
 
-        case ocResourceType_Scene:
-        {
-            result = ocResourceLibraryLoad_Scene(pLibrary, absolutePath, ppResource);
-        } break;
+    return OC_SUCCESS;
+}
 
-        case ocResourceType_Unknown:
-        default:
-        {
-            result = OC_UNKNOWN_RESOURCE_TYPE;
-        } break;
+// Cooks the source asset of an item. The asset is taken from the data that was read by ocResourceLibraryReadFiles() if there is any,
+// otherwise it's streamed from it's file.
+OC_PRIVATE ocResult ocResourceLibraryCookItem(ocResourceLibraryLoadItem* pItem, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    ocAssert(pItem != NULL);
+
+    ocResourceLibrary* pLibrary = pItem->pLibrary;
+
+    ocStreamReader reader;
+    ocResult result;
+    if (pItem->pFileData != NULL) {
+        result = ocStreamReaderInit(pItem->pFileData, pItem->fileDataSize, &reader);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        result = ocResourceLibraryCook(pLibrary, pItem->fileInfo.absolutePath, pItem->type, &reader, ppOCDData, pOCDDataSize);
+
+        ocStreamReaderUninit(&reader);
+        return result;
     }
 
+    ocFile file;
+    result = ocFileOpen(pLibrary->pLoader->pFS, pItem->fileInfo.absolutePath, OC_READ, &file);
     if (result != OC_SUCCESS) {
         return result;
     }
 
-    return OC_SUCCESS;
+    result = ocStreamReaderInit(&file, &reader);
+    if (result != OC_SUCCESS) {
+        ocFileClose(&file);
+        return result;
+    }
+
+    ocStreamReaderSetBufferSize(&reader, OC_RESOURCE_LOADER_READ_BUFFER_SIZE);  // <-- Not fatal if this fails.
+
+    result = ocResourceLibraryCook(pLibrary, pItem->fileInfo.absolutePath, pItem->type, &reader, ppOCDData, pOCDDataSize);
+
+    ocStreamReaderUninit(&reader);
+    ocFileClose(&file);
+    return result;
 }
 
-void ocResourceLibraryUnload(ocResourceLibrary* pLibrary, ocResource* pResource)
+// pOCDData can be NULL, in which case the image is loaded from it's path. This is thread-safe.
+OC_PRIVATE ocResult ocResourceLibraryPrepare_Image(ocResourceLibraryLoadItem* pItem, const void* pOCDData, ocSizeT ocdDataSize)
 {
-    if (pLibrary == NULL || pResource == NULL) {
-        return;
+    ocAssert(pItem != NULL);
+
+    ocResourceLoader* pLoader = pItem->pLibrary->pLoader;
+
+    ocImageData* pData = &pItem->image.data;
+    ocResult result;
+    if (pOCDData != NULL) {
+        result = ocResourceLoaderLoadImageFromOCD(pLoader, pOCDData, ocdDataSize, pData);
+    } else {
+        result = ocResourceLoaderLoadImage(pLoader, pItem->fileInfo.absolutePath, pData);
     }
 
-    if (ocAtomicDecrement(&pResource->referenceCount) > 0) {
-        return;
+    if (result != OC_SUCCESS) {
+        return result;
     }
 
-    switch (pResource->type)
-    {
-        case ocResourceType_Image:
-        {
-            ocGraphicsDeleteImage(pLibrary->pGraphics, pResource->image.pGraphicsImage);
-        } break;
 
-        case ocResourceType_Scene:
-        {
-            ocResourceLoaderUnloadScene(pLibrary->pLoader, &pResource->scene);
-        } break;
+    // Generate mipmaps if necessary.
+    pItem->image.imageDataSize = (ocSizeT)pData->imageDataSize;
+    pItem->image.pImageData    = pData->pImageData;
+    pItem->image.mipmapCount   = pData->mipmapCount;
+    if (pItem->image.mipmapCount == 1) {
+        // Generate mipmaps.
+        ocUInt32 baseWidth  = pData->pMipmaps[0].width;
+        ocUInt32 baseHeight = pData->pMipmaps[0].height;
+        ocGetMipmapCount(baseWidth, baseHeight, &pItem->image.mipmapCount);
+        ocGetTotalMipmapDataSize(baseWidth, baseHeight, 4, sizeof(uintptr_t), &pItem->image.imageDataSize);
 
-        case ocResourceType_Unknown:
-        default: break;
+        pItem->image.pImageData = ocMalloc(pItem->image.imageDataSize);
+        if (pItem->image.pImageData == NULL) {
+            ocResourceLoaderUnloadImage(pLoader, pData);
+            return OC_OUT_OF_MEMORY;
+        }
+
+        ocGenerateMipmaps(baseWidth, baseHeight, 4, sizeof(uintptr_t), pData->pImageData, pItem->image.pImageData, pItem->image.pMipmaps);
+    } else {
+        // Use pre-generated mipmaps.
+        memcpy(pItem->image.pMipmaps, pData->pMipmaps, pItem->image.mipmapCount * sizeof(ocMipmapInfo));
     }
 
-    ocFree(pResource);
+    return OC_SUCCESS;
 }
 
-ocResult ocResourceLibrarySyncOCD(ocResourceLibrary* pLibrary, const char* filePath)
+OC_PRIVATE void ocResourceLibraryUnprepare_Image(ocResourceLibraryLoadItem* pItem)
 {
-    if (pLibrary == NULL || filePath == NULL) {
-        return OC_INVALID_ARGS;
+    ocAssert(pItem != NULL);
+
+    if (pItem->image.pImageData != pItem->image.data.pImageData) {
+        ocFree(pItem->image.pImageData);
     }
 
-    // TODO: Implement me.
+    ocResourceLoaderUnloadImage(pItem->pLibrary->pLoader, &pItem->image.data);
+}
+
+// Creates the graphics image of a prepared item. The prepared data is released whether or not this succeeds.
+OC_PRIVATE ocResult ocResourceLibraryCreateGraphicsImage(ocResourceLibraryLoadItem* pItem, ocGraphicsImage** ppGraphicsImage, ocUInt64* pSizeInBytes)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(ppGraphicsImage != NULL);
+    ocAssert(pSizeInBytes != NULL);
+
+    ocGraphicsImageDesc desc;
+    desc.usage         = OC_GRAPHICS_IMAGE_USAGE_SHADER_INPUT;
+    desc.format        = pItem->image.data.format;
+    desc.mipLevels     = pItem->image.mipmapCount;
+    desc.pMipmaps      = pItem->image.pMipmaps;
+    desc.imageDataSize = pItem->image.imageDataSize;
+    desc.pImageData    = pItem->image.pImageData;
+
+    ocResult result = ocGraphicsCreateImage(pItem->pLibrary->pGraphics, &desc, ppGraphicsImage);
+    ocResourceLibraryUnprepare_Image(pItem);
+
+    *pSizeInBytes = desc.imageDataSize;
+    return result;
+}
+
+OC_PRIVATE ocResult ocResourceLibraryCreate_Image(ocResourceLibraryLoadItem* pItem, ocResource** ppResource)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(ppResource != NULL);
+
+    ocResourceLibrary* pLibrary = pItem->pLibrary;
+
+    ocGraphicsImage* pGraphicsImage;
+    ocUInt64 imageSizeInBytes;
+    ocResult result = ocResourceLibraryCreateGraphicsImage(pItem, &pGraphicsImage, &imageSizeInBytes);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocResource* pResource = ocAllocResource(ocResourceType_Image, 0, pItem->fileInfo.absolutePath);
+    if (pResource == NULL) {
+        ocGraphicsDeleteImage(pLibrary->pGraphics, pGraphicsImage);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pResource->image.pGraphicsImage = pGraphicsImage;
+    pResource->gpuSizeInBytes = imageSizeInBytes;
+
+    *ppResource = pResource;
+    return OC_SUCCESS;
+}
+
+// Materials are always loaded from their library. This is thread-safe.
+OC_PRIVATE ocResult ocResourceLibraryPrepare_Material(ocResourceLibraryLoadItem* pItem)
+{
+    ocAssert(pItem != NULL);
+
+    return ocResourceLoaderLoadMaterial(pItem->pLibrary->pLoader, pItem->fileInfo.absolutePath, &pItem->material);
+}
+
+OC_PRIVATE ocResult ocResourceLibraryCreate_Material(ocResourceLibraryLoadItem* pItem, ocResource** ppResource)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(ppResource != NULL);
+
+    ocResource* pResource = ocAllocResource(ocResourceType_Material, 0, pItem->fileInfo.absolutePath);
+    if (pResource == NULL) {
+        ocResourceLoaderUnloadMaterial(pItem->pLibrary->pLoader, &pItem->material);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pResource->material = pItem->material;
+    if (pItem->material.diffuseMapPath != NULL) {
+        pResource->cpuSizeInBytes += strlen(pItem->material.diffuseMapPath) + 1;
+    }
+
+    *ppResource = pResource;
+    return OC_SUCCESS;
+}
+
+// pOCDData can be NULL, in which case the scene is loaded from it's path. Otherwise the scene takes ownership of it, even when this
+// fails, since scenes are large and copying them is expensive. This is thread-safe.
+OC_PRIVATE ocResult ocResourceLibraryPrepare_Scene(ocResourceLibraryLoadItem* pItem, void* pOCDData, ocSizeT ocdDataSize)
+{
+    ocAssert(pItem != NULL);
+
+    ocResourceLoader* pLoader = pItem->pLibrary->pLoader;
+
+    if (pOCDData != NULL) {
+        return ocResourceLoaderLoadSceneFromOCDInPlace(pLoader, pOCDData, ocdDataSize, &pItem->scene);
+    } else {
+        return ocResourceLoaderLoadScene(pLoader, pItem->fileInfo.absolutePath, &pItem->scene);
+    }
+}
+
+OC_PRIVATE ocResult ocResourceLibraryCreate_Scene(ocResourceLibraryLoadItem* pItem, ocResource** ppResource)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(ppResource != NULL);
+
+    ocResource* pResource = ocAllocResource(ocResourceType_Scene, 0, pItem->fileInfo.absolutePath);
+    if (pResource == NULL) {
+        ocResourceLoaderUnloadScene(pItem->pLibrary->pLoader, &pItem->scene);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pResource->scene = pItem->scene;
+    pResource->cpuSizeInBytes += pItem->scene.payloadSize;
+
+    *ppResource = pResource;
+    return OC_SUCCESS;
+}
+
+// Takes ownership of the file data. This is thread-safe.
+OC_PRIVATE ocResult ocResourceLibraryPrepare_Sound(ocResourceLibraryLoadItem* pItem, void* pFileData, ocSizeT fileDataSize)
+{
+    ocAssert(pItem != NULL);
+
+    return ocResourceLoaderLoadSoundInPlace(pItem->pLibrary->pLoader, pItem->fileInfo.absolutePath, pFileData, fileDataSize, &pItem->sound);
+}
+
+OC_PRIVATE ocResult ocResourceLibraryCreate_Sound(ocResourceLibraryLoadItem* pItem, ocResource** ppResource)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(ppResource != NULL);
+
+    ocResource* pResource = ocAllocResource(ocResourceType_Sound, 0, pItem->fileInfo.absolutePath);
+    if (pResource == NULL) {
+        ocResourceLoaderUnloadSound(pItem->pLibrary->pLoader, &pItem->sound);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pResource->sound = pItem->sound;
+    pResource->cpuSizeInBytes += pItem->sound.encodedDataSize + pItem->sound.buffer.frameCount*pItem->sound.buffer.channels*sizeof(float);
+
+    *ppResource = pResource;
+    return OC_SUCCESS;
+}
+
+// Skeletons and animations only exist as .ocd files. They take ownership of the data. This is thread-safe.
+OC_PRIVATE ocResult ocResourceLibraryPrepare_Skeleton(ocResourceLibraryLoadItem* pItem, void* pOCDData, ocSizeT ocdDataSize)
+{
+    ocAssert(pItem != NULL);
+
+    return ocResourceLoaderLoadSkeletonFromOCDInPlace(pItem->pLibrary->pLoader, pOCDData, ocdDataSize, &pItem->skeleton);
+}
+
+OC_PRIVATE ocResult ocResourceLibraryCreate_Skeleton(ocResourceLibraryLoadItem* pItem, ocResource** ppResource)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(ppResource != NULL);
+
+    ocResource* pResource = ocAllocResource(ocResourceType_Skeleton, 0, pItem->fileInfo.absolutePath);
+    if (pResource == NULL) {
+        ocResourceLoaderUnloadSkeleton(pItem->pLibrary->pLoader, &pItem->skeleton);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pResource->skeleton = pItem->skeleton;
+    pResource->cpuSizeInBytes += pItem->skeleton.payloadSize;
+
+    *ppResource = pResource;
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocResourceLibraryPrepare_Animation(ocResourceLibraryLoadItem* pItem, void* pOCDData, ocSizeT ocdDataSize)
+{
+    ocAssert(pItem != NULL);
+
+    return ocResourceLoaderLoadAnimationFromOCDInPlace(pItem->pLibrary->pLoader, pOCDData, ocdDataSize, &pItem->animation);
+}
+
+OC_PRIVATE ocResult ocResourceLibraryCreate_Animation(ocResourceLibraryLoadItem* pItem, ocResource** ppResource)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(ppResource != NULL);
+
+    ocResource* pResource = ocAllocResource(ocResourceType_Animation, 0, pItem->fileInfo.absolutePath);
+    if (pResource == NULL) {
+        ocResourceLoaderUnloadAnimation(pItem->pLibrary->pLoader, &pItem->animation);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pResource->animation = pItem->animation;
+    pResource->cpuSizeInBytes += pItem->animation.payloadSize;
+
+    *ppResource = pResource;
+    return OC_SUCCESS;
+}
+
+// Materials don't have a file of their own. Their path is the path of their library followed by their name, such as "materials.mtl/wood",
+// so they're resolved through the library. The absolute path of the item is the absolute path of the library followed by the name so
+// that each material is a separate resource.
+OC_PRIVATE ocResult ocResourceLibraryResolve_Material(ocResourceLibrary* pLibrary, const char* filePath, ocResourceLibraryLoadItem* pItem)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(filePath != NULL);
+    ocAssert(pItem != NULL);
+
+    char libraryPath[OC_MAX_PATH];
+    if (ocPathRemoveFileName(libraryPath, sizeof(libraryPath), filePath) == 0 || !ocPathExtensionEqual(libraryPath, "mtl")) {
+        return OC_DOES_NOT_EXIST;
+    }
+
+    ocFileInfo fileInfoLibrary;
+    if (ocGetFileInfo(pLibrary->pLoader->pFS, libraryPath, &fileInfoLibrary) != OC_SUCCESS) {
+        return OC_DOES_NOT_EXIST;
+    }
+
+    pItem->fileInfo = fileInfoLibrary;
+    if (ocPathAppend(pItem->fileInfo.absolutePath, sizeof(pItem->fileInfo.absolutePath), fileInfoLibrary.absolutePath, ocPathFileName(filePath)) == 0) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    pItem->type = ocResourceType_Material;
+    pItem->isOCD = OC_FALSE;
+    pItem->converterVersion = 0;    // <-- Nothing is read up front. The library is read when the item is prepared.
+
+    return OC_SUCCESS;
+}
+
+// Determines which file to load for the given path and what type of resource it is.
+OC_PRIVATE ocResult ocResourceLibraryResolve(ocResourceLibrary* pLibrary, const char* filePath, ocResourceLibraryLoadItem* pItem)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(filePath != NULL);
+    ocAssert(pItem != NULL);
+
+    // So this is how resources work in the engine... Each resource file (.png, .obj, etc.) is converted to an .ocd file before it's
+    // loaded. The .ocd format is optimized for use by the engine and contains _all_ of the data of the resource which means it's able to
+    // work without the original asset.
+    //
+    // Converting is slow so the results are stored in the derived data cache. Items in the cache are keyed by the content of the source
+    // asset and the version of the converter. We never look at timestamps because they change when files are copied or checked out of
+    // version control, and they don't necessarily change when the content changes (restoring an old file, for example). When an asset is
+    // not in the cache it's converted in memory and then written to the cache from a worker thread so we don't stall on the write.
+    //
+    // A resource file can also have a corresponding .ocd file located next to it, named the same but with the ".ocd" extension appended
+    // to the end. For example, "my_texture.png" can have a "my_texture.png.ocd" file with it. These are used when the source asset does
+    // not exist which is how assets are shipped. When the source asset exists it always takes priority because there's no way of knowing
+    // if the .ocd file is up to date.
+    ocFileInfo fileInfoSrc;
+    ocBool32 hasSrc = ocGetFileInfo(pLibrary->pLoader->pFS, filePath, &fileInfoSrc) == OC_SUCCESS;
+
+    ocFileInfo fileInfoOCD;
+    ocZeroObject(&fileInfoOCD);
+    ocBool32 hasOCD = OC_FALSE;
+    if (!hasSrc && !ocPathExtensionEqual(filePath, "ocd")) {
+        char filePathOCD[OC_MAX_PATH];
+        if (ocPathAppendExtension(filePathOCD, sizeof(filePathOCD), filePath, "ocd")) {
+            hasOCD = ocGetFileInfo(pLibrary->pLoader->pFS, filePathOCD, &fileInfoOCD) == OC_SUCCESS;
+        }
+    }
+
+    if (!hasSrc && !hasOCD) {
+        return ocResourceLibraryResolve_Material(pLibrary, filePath, pItem);
+    }
+
+    pItem->fileInfo = (hasSrc) ? fileInfoSrc : fileInfoOCD;
+
+    ocResult result = ocResourceLoaderDetermineResourceType(pLibrary->pLoader, pItem->fileInfo.absolutePath, &pItem->type);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // .ocd files are loaded directly. Otherwise the source asset needs to be cooked. Formats we don't have a converter for fall back to
+    // being loaded directly from the source asset so their data doesn't need to be read up front.
+    pItem->isOCD = ocPathExtensionEqual(pItem->fileInfo.absolutePath, "ocd");
+    if (!pItem->isOCD) {
+        pItem->converterVersion = ocResourceLoaderGetConverterVersion(pItem->type);
+    }
+
+    return OC_SUCCESS;
+}
+
+// Turns the data that was read by ocResourceLibraryReadFiles() into data that's ready for creating the resource. This takes ownership of
+// the file data and is run on the job queue.
+OC_PRIVATE void ocResourceLibraryPrepareItem(void* pUserData)
+{
+    ocResourceLibraryLoadItem* pItem = (ocResourceLibraryLoadItem*)pUserData;
+    ocAssert(pItem != NULL);
+
+    // Sounds are not cooked.
+    if (pItem->type == ocResourceType_Sound) {
+        pItem->result = ocResourceLibraryPrepare_Sound(pItem, pItem->pFileData, pItem->fileDataSize);
+        pItem->pFileData = NULL;
+        pItem->fileDataSize = 0;
+        return;
+    }
+
+    // Here is where we get the OCD data. If we're loading an .ocd file directly it's just the file data. Otherwise we need to cook the
+    // source asset.
+    ocResult result = OC_SUCCESS;
+    void* pOCDData = NULL;
+    ocSizeT ocdDataSize = 0;
+    if (pItem->isOCD) {
+        pOCDData = pItem->pFileData;
+        ocdDataSize = pItem->fileDataSize;
+    } else if (pItem->converterVersion != 0) {
+        result = ocResourceLibraryCookItem(pItem, &pOCDData, &ocdDataSize);
+        ocFree(pItem->pFileData);
+    }
+
+    pItem->pFileData = NULL;
+    pItem->fileDataSize = 0;
+
+    if (result != OC_SUCCESS) {
+        pItem->result = result;
+        return;
+    }
+
+    switch (pItem->type)
+    {
+        case ocResourceType_Image:
+        {
+            result = ocResourceLibraryPrepare_Image(pItem, pOCDData, ocdDataSize);
+        } break;
+
+        case ocResourceType_Material:
+        {
+            result = ocResourceLibraryPrepare_Material(pItem);
+        } break;
+
+        case ocResourceType_Scene:
+        {
+            result = ocResourceLibraryPrepare_Scene(pItem, pOCDData, ocdDataSize);
+            pOCDData = NULL;
+        } break;
+
+        case ocResourceType_Skeleton:
+        {
+            result = ocResourceLibraryPrepare_Skeleton(pItem, pOCDData, ocdDataSize);
+            pOCDData = NULL;
+        } break;
+
+        case ocResourceType_Animation:
+        {
+            result = ocResourceLibraryPrepare_Animation(pItem, pOCDData, ocdDataSize);
+            pOCDData = NULL;
+        } break;
+
+        case ocResourceType_Unknown:
+        default:
+        {
+            result = OC_UNKNOWN_RESOURCE_TYPE;
+        } break;
+    }
+
+    ocFree(pOCDData);
+    pItem->result = result;
+}
+
+// Creates the resource from a prepared item. This must be called from the thread that owns the graphics context.
+OC_PRIVATE ocResult ocResourceLibraryCreateItem(ocResourceLibraryLoadItem* pItem, ocResource** ppResource)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(ppResource != NULL);
+
+    switch (pItem->type)
+    {
+        case ocResourceType_Image: return ocResourceLibraryCreate_Image(pItem, ppResource);
+        case ocResourceType_Material: return ocResourceLibraryCreate_Material(pItem, ppResource);
+        case ocResourceType_Scene: return ocResourceLibraryCreate_Scene(pItem, ppResource);
+        case ocResourceType_Sound: return ocResourceLibraryCreate_Sound(pItem, ppResource);
+        case ocResourceType_Skeleton: return ocResourceLibraryCreate_Skeleton(pItem, ppResource);
+        case ocResourceType_Animation: return ocResourceLibraryCreate_Animation(pItem, ppResource);
+        default: return OC_UNKNOWN_RESOURCE_TYPE;
+    }
+}
+
+ocResult ocResourceLibraryLoad(ocResourceLibrary* pLibrary, const char* filePath, ocResource** ppResource)
+{
+    if (ppResource == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppResource = NULL;
+
+    if (pLibrary == NULL || filePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    return ocResourceLibraryLoadMultiple(pLibrary, 1, &filePath, ppResource, NULL);
+}
+
+ocResult ocResourceLibraryLoadMultiple(ocResourceLibrary* pLibrary, ocUInt32 count, const char** ppFilePaths, ocResource** ppResources, ocResult* pResults)
+{
+    if (ppResources == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    for (ocUInt32 i = 0; i < count; ++i) {
+        ppResources[i] = NULL;
+    }
+
+    if (pLibrary == NULL || (ppFilePaths == NULL && count > 0)) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocResourceLibraryLoadItem* pItems = (ocResourceLibraryLoadItem*)ocCalloc(ocMax(count, 1), sizeof(*pItems));
+    if (pItems == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    for (ocUInt32 i = 0; i < count; ++i) {
+        pItems[i].pLibrary = pLibrary;
+
+        if (ppFilePaths[i] == NULL) {
+            pItems[i].result = OC_INVALID_ARGS;
+            continue;
+        }
+
+        pItems[i].result = ocResourceLibraryResolve(pLibrary, ppFilePaths[i], &pItems[i]);
+        if (pItems[i].result != OC_SUCCESS) {
+            continue;
+        }
+
+        // If the resource is already in memory we just take a reference to it. The reference is taken now so it can't be evicted while
+        // the rest of the group is loading. These are also marked as failed for now so they're skipped by the later stages.
+        ocMutexLock(&pLibrary->lock);
+        size_t index;
+        if (ocResourceLibraryFindResident(pLibrary, pItems[i].fileInfo.absolutePath, &index)) {
+            pItems[i].pResidentResource = pLibrary->resources.pItems[index];
+            pItems[i].result = OC_ALREADY_EXISTS;
+            ocResourceLibraryAcquire(pLibrary, pItems[i].pResidentResource);
+            pLibrary->stats.hitCount += 1;
+        }
+        ocMutexUnlock(&pLibrary->lock);
+
+        if (pItems[i].pResidentResource != NULL) {
+            continue;
+        }
+
+        // The same file can be requested more than once, possibly through different relative paths. It's only loaded once and then
+        // shared. Duplicates are marked as failed for now so they're skipped by the read and prepare stages.
+        for (ocUInt32 j = 0; j < i; ++j) {
+            if (pItems[j].result == OC_SUCCESS && ocPathEqual(pItems[j].fileInfo.absolutePath, pItems[i].fileInfo.absolutePath)) {
+                pItems[i].duplicateOf = j + 1;
+                pItems[i].result = OC_ALREADY_EXISTS;
+                break;
+            }
+        }
+    }
+
+    // All files are read at the same time so many small reads don't each have to wait on the disk.
+    ocResourceLibraryReadFiles(pLibrary, pItems, count);
+
+    // Cooking and decoding is done in parallel.
+    ocJobQueue* pJobQueue = pLibrary->pLoader->pJobQueue;
+    ocUInt32 jobCounter = 0;
+    for (ocUInt32 i = 0; i < count; ++i) {
+        if (pItems[i].result != OC_SUCCESS) {
+            continue;
+        }
+
+        if (pJobQueue == NULL || ocJobQueueSubmit(pJobQueue, ocResourceLibraryPrepareItem, &pItems[i], &jobCounter) != OC_SUCCESS) {
+            ocResourceLibraryPrepareItem(&pItems[i]);
+        }
+    }
+
+    if (pJobQueue != NULL) {
+        ocJobQueueWaitForCounter(pJobQueue, &jobCounter);
+    }
+
+    ocResult result = OC_SUCCESS;
+    for (ocUInt32 i = 0; i < count; ++i) {
+        if (pItems[i].pResidentResource != NULL) {
+            ppResources[i] = pItems[i].pResidentResource;
+            pItems[i].result = OC_SUCCESS;
+        } else if (pItems[i].result == OC_SUCCESS) {
+            pItems[i].result = ocResourceLibraryCreateItem(&pItems[i], &ppResources[i]);
+            if (pItems[i].result == OC_SUCCESS) {
+                pItems[i].result = ocResourceLibraryRegister(pLibrary, &ppResources[i]);
+            }
+        } else if (pItems[i].duplicateOf != 0) {
+            // Duplicates always refer to an earlier item so it's already been created at this point.
+            ocUInt32 original = pItems[i].duplicateOf - 1;
+            pItems[i].result = pItems[original].result;
+            if (pItems[i].result == OC_SUCCESS) {
+                ppResources[i] = ppResources[original];
+
+                ocMutexLock(&pLibrary->lock);
+                ocResourceLibraryAcquire(pLibrary, ppResources[i]);
+                ocMutexUnlock(&pLibrary->lock);
+            }
+        }
+
+        if (pResults != NULL) {
+            pResults[i] = pItems[i].result;
+        }
+
+        if (pItems[i].result != OC_SUCCESS && result == OC_SUCCESS) {
+            result = pItems[i].result;
+        }
+    }
+
+    ocFree(pItems);
+    return result;
+}
+
+void ocResourceLibraryUnload(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    if (pLibrary == NULL || pResource == NULL) {
+        return;
+    }
+
+    // The resource is not freed here. It's kept in memory in case it's needed again and is only freed when it's type goes over budget.
+    ocMutexLock(&pLibrary->lock);
+    ocAssert(pResource->referenceCount > 0);
+
+    pResource->referenceCount -= 1;
+    if (pResource->referenceCount == 0) {
+        ocResourceLibraryLinkUnused(pLibrary, pResource);
+        ocResourceLibraryEnforceBudget(pLibrary, pResource->type);
+    }
+    ocMutexUnlock(&pLibrary->lock);
+}
+
+void ocResourceLibraryAddReference(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    if (pLibrary == NULL || pResource == NULL) {
+        return;
+    }
+
+    ocMutexLock(&pLibrary->lock);
+    ocAssert(pResource->referenceCount > 0);
+
+    ocResourceLibraryAcquire(pLibrary, pResource);
+    ocMutexUnlock(&pLibrary->lock);
+}
+
+ocResult ocResourceLibrarySetBudget(ocResourceLibrary* pLibrary, ocResourceType type, ocUInt64 budgetInBytes)
+{
+    if (pLibrary == NULL || type >= ocResourceType_Count) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocMutexLock(&pLibrary->lock);
+    pLibrary->stats.types[type].budgetInBytes = budgetInBytes;
+    ocResourceLibraryEnforceBudget(pLibrary, type);
+    ocMutexUnlock(&pLibrary->lock);
+
+    return OC_SUCCESS;
+}
+
+void ocResourceLibraryEvictUnused(ocResourceLibrary* pLibrary)
+{
+    if (pLibrary == NULL) {
+        return;
+    }
+
+    ocMutexLock(&pLibrary->lock);
+    while (pLibrary->pLastUnused != NULL) {
+        ocResource* pResource = pLibrary->pLastUnused;
+        ocResourceLibraryUnlinkUnused(pLibrary, pResource);
+        ocResourceLibraryRemoveResident(pLibrary, pResource);
+        ocResourceLibraryFreeResource(pLibrary, pResource);
+        pLibrary->stats.evictionCount += 1;
+    }
+    ocMutexUnlock(&pLibrary->lock);
+}
+
+ocResult ocResourceLibraryGetStats(ocResourceLibrary* pLibrary, ocResourceLibraryStats* pStats)
+{
+    if (pStats == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pStats);
+
+    if (pLibrary == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocMutexLock(&pLibrary->lock);
+    *pStats = pLibrary->stats;
+    ocMutexUnlock(&pLibrary->lock);
+
+    return OC_SUCCESS;
+}
+
+ocResult ocResourceLibrarySyncOCD(ocResourceLibrary* pLibrary, const char* filePath)
+{
+    if (pLibrary == NULL || filePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    // .ocd files have nothing to synchronize with.
+    if (ocPathExtensionEqual(filePath, "ocd")) {
+        return OC_SUCCESS;
+    }
+
+    ocFileInfo fileInfoSrc;
+    ocResult result = ocGetFileInfo(pLibrary->pLoader->pFS, filePath, &fileInfoSrc);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocResourceType resourceType;
+    result = ocResourceLoaderDetermineResourceType(pLibrary->pLoader, fileInfoSrc.absolutePath, &resourceType);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    char filePathOCD[OC_MAX_PATH];
+    if (ocPathAppendExtension(filePathOCD, sizeof(filePathOCD), fileInfoSrc.absolutePath, "ocd") == 0) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    ocResourceLibraryLoadItem item;
+    ocZeroObject(&item);
+    item.fileInfo = fileInfoSrc;
+    item.type = resourceType;
+    item.converterVersion = ocResourceLoaderGetConverterVersion(resourceType);
+    if (item.converterVersion == 0) {
+        return OC_UNSUPPORTED_RESOURCE_TYPE;
+    }
+
+    ocResourceLibraryReadFiles(pLibrary, &item, 1);
+    if (item.result != OC_SUCCESS) {
+        return item.result;
+    }
+
+    void* pOCDData;
+    ocSizeT ocdDataSize;
+    item.pLibrary = pLibrary;
+    result = ocResourceLibraryCookItem(&item, &pOCDData, &ocdDataSize);
+    ocFree(item.pFileData);
+
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocOpenAndWriteFile(filePathOCD, pOCDData, ocdDataSize);
+
+    ocFree(pOCDData);
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Hot Reloading
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// When the file of a resource changes it's loaded again on the job queue using the same stages as a normal load. The new data is then
+// swapped into the existing resource object by ocResourceLibraryUpdate(), which means anything referring to the resource sees the new
+// data without needing to do anything.
+struct ocResourceLibraryReload
+{
+    ocResource* pResource;          // <-- A reference is held for the duration of the reload so it can't be evicted.
+    ocResourceLibraryLoadItem item;
+    ocUInt32 jobCounter;            // <-- Atomic. 0 when the job has finished.
+    ocBool32 isOutOfDate;           // <-- Set when the file changes again while it's being reloaded.
+};
+
+OC_PRIVATE void ocResourceLibraryReloadJob(void* pUserData)
+{
+    ocResourceLibraryReload* pReload = (ocResourceLibraryReload*)pUserData;
+    ocAssert(pReload != NULL);
+
+    ocResourceLibraryLoadItem* pItem = &pReload->item;
+    ocResourceLibraryReadFiles(pItem->pLibrary, pItem, 1);
+    if (pItem->result == OC_SUCCESS) {
+        ocResourceLibraryPrepareItem(pItem);
+    }
+}
+
+OC_PRIVATE void ocResourceLibraryStartReload(ocResourceLibrary* pLibrary, ocResourceLibraryReload* pReload)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pReload != NULL);
+
+    ocResource* pResource = pReload->pResource;
+    pReload->isOutOfDate = OC_FALSE;
+
+    // The resource is always reloaded from the same file it was originally loaded from.
+    ocResourceLibraryLoadItem* pItem = &pReload->item;
+    ocZeroObject(pItem);
+    pItem->pLibrary = pLibrary;
+    pItem->type = pResource->type;
+    pItem->isOCD = ocPathExtensionEqual(pResource->pAbsolutePath, "ocd");
+    if (!pItem->isOCD) {
+        pItem->converterVersion = ocResourceLoaderGetConverterVersion(pItem->type);
+    }
+
+    // This can fail if the file has been deleted. It's reported when the reload is finished.
+    pItem->result = ocGetFileInfo(pLibrary->pLoader->pFS, pResource->pAbsolutePath, &pItem->fileInfo);
+    if (pItem->result != OC_SUCCESS) {
+        return;
+    }
+
+    ocJobQueue* pJobQueue = pLibrary->pLoader->pJobQueue;
+    if (pJobQueue == NULL || ocJobQueueSubmit(pJobQueue, ocResourceLibraryReloadJob, pReload, &pReload->jobCounter) != OC_SUCCESS) {
+        ocResourceLibraryReloadJob(pReload);
+    }
+}
+
+// Releases the data of an item that was prepared but is never going to be used to create a resource.
+OC_PRIVATE void ocResourceLibraryDiscardItem(ocResourceLibraryLoadItem* pItem)
+{
+    ocAssert(pItem != NULL);
+
+    if (pItem->result != OC_SUCCESS) {
+        return;
+    }
+
+    switch (pItem->type)
+    {
+        case ocResourceType_Image:
+        {
+            ocResourceLibraryUnprepare_Image(pItem);
+        } break;
+
+        case ocResourceType_Material:
+        {
+            ocResourceLoaderUnloadMaterial(pItem->pLibrary->pLoader, &pItem->material);
+        } break;
+
+        case ocResourceType_Scene:
+        {
+            ocResourceLoaderUnloadScene(pItem->pLibrary->pLoader, &pItem->scene);
+        } break;
+
+        case ocResourceType_Sound:
+        {
+            ocResourceLoaderUnloadSound(pItem->pLibrary->pLoader, &pItem->sound);
+        } break;
+
+        case ocResourceType_Skeleton:
+        {
+            ocResourceLoaderUnloadSkeleton(pItem->pLibrary->pLoader, &pItem->skeleton);
+        } break;
+
+        case ocResourceType_Animation:
+        {
+            ocResourceLoaderUnloadAnimation(pItem->pLibrary->pLoader, &pItem->animation);
+        } break;
+
+        default: break;
+    }
+}
+
+// Retrieves a mesh group of a scene object. Groups are numbered across every mesh component of the object, in order. The vertex and index
+// data of the description point into the scene's payload.
+OC_PRIVATE ocResult ocResourceLibraryGetSceneMeshGroup(const ocSceneData* pScene, ocUInt32 objectIndex, ocUInt32 groupIndex, ocGraphicsMeshDesc* pDesc)
+{
+    ocAssert(pScene != NULL);
+    ocAssert(pDesc != NULL);
+
+    if (objectIndex >= pScene->objectCount) {
+        return OC_DOES_NOT_EXIST;
+    }
+
+    const ocSceneObject* pSceneObject = &pScene->pObjects[objectIndex];
+    const ocSceneObjectComponent* pComponents = (const ocSceneObjectComponent*)(pScene->pPayload + pSceneObject->componentsOffset);
+    for (ocUInt32 iComponent = 0; iComponent < pSceneObject->componentCount; ++iComponent) {
+        if (pComponents[iComponent].type != OC_COMPONENT_TYPE_MESH) {
+            continue;
+        }
+
+        // Same layout as the one read by ocWorld when it instantiates the scene.
+        ocUInt8* pComponentData = pScene->pPayload + pComponents[iComponent].dataOffset;
+        ocUInt32 groupCount = *(ocUInt32*)(pComponentData + 0);
+        if (groupIndex >= groupCount) {
+            groupIndex -= groupCount;
+            continue;
+        }
+
+        ocUInt8* pVertexData = pComponentData + *(ocUInt64*)(pComponentData + 16);
+        ocUInt8* pIndexData  = pComponentData + *(ocUInt64*)(pComponentData + 32);
+
+        const ocOCDSceneBuilderMeshGroup* pGroup = &((const ocOCDSceneBuilderMeshGroup*)(pComponentData + 40))[groupIndex];
+        pDesc->primitiveType = (ocGraphicsPrimitiveType)pGroup->primitiveType;
+        pDesc->vertexFormat  = (ocGraphicsVertexFormat)pGroup->vertexFormat;
+        pDesc->vertexCount   = pGroup->vertexCount;
+        pDesc->pVertices     = pVertexData + pGroup->vertexDataOffset;
+        pDesc->indexFormat   = (ocGraphicsIndexFormat)pGroup->indexFormat;
+        pDesc->indexCount    = pGroup->indexCount;
+        pDesc->pIndices      = pIndexData + pGroup->indexDataOffset;
+        return OC_SUCCESS;
+    }
+
+    return OC_DOES_NOT_EXIST;
+}
+
+// Replaces the contents of every mesh that was instantiated from a scene with the same group of the new version of the scene. Meshes whose
+// group no longer exists keep their old contents.
+OC_PRIVATE void ocResourceLibraryReloadSceneMeshes(ocResourceLibrary* pLibrary, ocResource* pResource)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pResource != NULL);
+
+    ocEngineContext* pEngine = pLibrary->pLoader->pFS->pEngine;
+
+    ocUInt32 missingCount = 0;
+    for (size_t iMesh = 0; iMesh < pLibrary->sceneMeshes.count; ++iMesh) {
+        ocResourceLibrarySceneMesh* pSceneMesh = &pLibrary->sceneMeshes.pItems[iMesh];
+        if (pSceneMesh->pResource != pResource) {
+            continue;
+        }
+
+        ocGraphicsMeshDesc desc;
+        if (ocResourceLibraryGetSceneMeshGroup(&pResource->scene, pSceneMesh->objectIndex, pSceneMesh->groupIndex, &desc) != OC_SUCCESS) {
+            missingCount += 1;
+            continue;
+        }
+
+        ocGraphicsMesh* pNewMesh;
+        ocResult result = ocGraphicsCreateMesh(pLibrary->pGraphics, &desc, &pNewMesh);
+        if (result != OC_SUCCESS) {
+            ocWarningf(pEngine, "Failed to reload a mesh of %s (%d).", pResource->pAbsolutePath, result);
+            continue;
+        }
+
+        ocGraphicsReplaceMesh(pLibrary->pGraphics, pSceneMesh->pMesh, pNewMesh);
+    }
+
+    if (missingCount > 0) {
+        ocWarningf(pEngine, "%u meshes instantiated from %s no longer exist and keep their previous data. Instantiate the scene again to see the changes.", missingCount, pResource->pAbsolutePath);
+    }
+}
+
+// Swaps the reloaded data into the resource. This must be called from the thread that owns the graphics context, between frames.
+OC_PRIVATE void ocResourceLibraryFinishReload(ocResourceLibrary* pLibrary, ocResourceLibraryReload* pReload)
+{
+    ocAssert(pLibrary != NULL);
+    ocAssert(pReload != NULL);
+
+    ocResource* pResource = pReload->pResource;
+    ocResourceLibraryLoadItem* pItem = &pReload->item;
+    ocEngineContext* pEngine = pLibrary->pLoader->pFS->pEngine;
+
+    ocResult result = pItem->result;
+    ocUInt64 newCPUSizeInBytes = pResource->cpuSizeInBytes;
+    ocUInt64 newGPUSizeInBytes = pResource->gpuSizeInBytes;
+    if (result == OC_SUCCESS) {
+        switch (pResource->type)
+        {
+            case ocResourceType_Image:
+            {
+                ocGraphicsImage* pGraphicsImage;
+                result = ocResourceLibraryCreateGraphicsImage(pItem, &pGraphicsImage, &newGPUSizeInBytes);
+                if (result == OC_SUCCESS) {
+                    ocGraphicsReplaceImage(pLibrary->pGraphics, pResource->image.pGraphicsImage, pGraphicsImage);
+                }
+            } break;
+
+            case ocResourceType_Scene:
+            {
+                newCPUSizeInBytes = newCPUSizeInBytes - pResource->scene.payloadSize + pItem->scene.payloadSize;
+                ocResourceLoaderUnloadScene(pLibrary->pLoader, &pResource->scene);
+                pResource->scene = pItem->scene;
+                ocResourceLibraryReloadSceneMeshes(pLibrary, pResource);
+            } break;
+
+            default: break;
+        }
+    }
+
+    if (result != OC_SUCCESS) {
+        ocWarningf(pEngine, "Failed to reload %s. The previous version will continue to be used.", pResource->pAbsolutePath);
+        return;
+    }
+
+    ocMutexLock(&pLibrary->lock);
+    ocResourceLibraryTypeStats* pTypeStats = &pLibrary->stats.types[pResource->type];
+    pTypeStats->cpuSizeInBytes = pTypeStats->cpuSizeInBytes - pResource->cpuSizeInBytes + newCPUSizeInBytes;
+    pTypeStats->gpuSizeInBytes = pTypeStats->gpuSizeInBytes - pResource->gpuSizeInBytes + newGPUSizeInBytes;
+    pResource->cpuSizeInBytes = newCPUSizeInBytes;
+    pResource->gpuSizeInBytes = newGPUSizeInBytes;
+    ocMutexUnlock(&pLibrary->lock);
+
+    ocLogf(pEngine, "Reloaded %s", pResource->pAbsolutePath);
+}
+
+OC_PRIVATE void ocResourceLibraryOnFileChanged(void* pUserData, const char* absolutePath)
+{
+    ocResourceLibrary* pLibrary = (ocResourceLibrary*)pUserData;
+    ocAssert(pLibrary != NULL);
+    ocAssert(absolutePath != NULL);
+
+    // A resource is only reloaded once at a time. If it changes again while it's being reloaded it's reloaded again afterwards.
+    for (size_t iReload = 0; iReload < pLibrary->reloads.count; ++iReload) {
+        if (strcmp(pLibrary->reloads.pItems[iReload]->pResource->pAbsolutePath, absolutePath) == 0) {
+            pLibrary->reloads.pItems[iReload]->isOutOfDate = OC_TRUE;
+            return;
+        }
+    }
+
+    // Most changes will be to files in the same directory as a resource, but not of a resource that's in memory.
+    ocResource* pResource = NULL;
+    ocBool32 isIgnored = OC_FALSE;
+    ocMutexLock(&pLibrary->lock);
+    size_t index;
+    if (ocResourceLibraryFindResident(pLibrary, absolutePath, &index)) {
+        pResource = pLibrary->resources.pItems[index];
+        if (pResource->type == ocResourceType_Sound || pResource->type == ocResourceType_Skeleton || pResource->type == ocResourceType_Animation) {
+            pResource = NULL;   // <-- Voices and animated characters read the data directly so it can't be swapped out.
+            isIgnored = OC_TRUE;
+        } else {
+            ocResourceLibraryAcquire(pLibrary, pResource);
+        }
+    }
+    ocMutexUnlock(&pLibrary->lock);
+
+    if (isIgnored) {
+        ocLogf(pLibrary->pLoader->pFS->pEngine, "%s changed but sounds, skeletons and animations are not hot reloaded. Load it again to see the changes.", absolutePath);
+    }
+
+    if (pResource == NULL) {
+        return;
+    }
+
+    ocResourceLibraryReload* pReload = (ocResourceLibraryReload*)ocCalloc(1, sizeof(*pReload));
+    if (pReload == NULL) {
+        ocResourceLibraryUnload(pLibrary, pResource);
+        return;
+    }
+
+    pReload->pResource = pResource;
+    if (ocStackPush(&pLibrary->reloads, pReload) != OC_SUCCESS) {
+        ocFree(pReload);
+        ocResourceLibraryUnload(pLibrary, pResource);
+        return;
+    }
+
+    ocResourceLibraryStartReload(pLibrary, pReload);
+}
+
+ocResult ocResourceLibraryEnableHotReload(ocResourceLibrary* pLibrary)
+{
+    if (pLibrary == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (pLibrary->isHotReloadEnabled) {
+        return OC_SUCCESS;
+    }
+
+    ocResult result = ocFileWatcherInit(pLibrary->pLoader->pFS, &pLibrary->watcher);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocStackInit(&pLibrary->reloads);
+    ocStackInit(&pLibrary->sceneMeshes);
+
+    // Resources that are already in memory need to be watched as well.
+    ocMutexLock(&pLibrary->lock);
+    pLibrary->isHotReloadEnabled = OC_TRUE;
+    for (size_t i = 0; i < pLibrary->resources.count; ++i) {
+        ocResourceLibraryWatchResource(pLibrary, pLibrary->resources.pItems[i]);
+    }
+    ocMutexUnlock(&pLibrary->lock);
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocResourceLibraryDisableHotReload(ocResourceLibrary* pLibrary)
+{
+    ocAssert(pLibrary != NULL);
+
+    if (!pLibrary->isHotReloadEnabled) {
+        return;
+    }
+
+    // Reloads that are still in progress need to finish before their data can be released.
+    for (size_t iReload = 0; iReload < pLibrary->reloads.count; ++iReload) {
+        ocResourceLibraryReload* pReload = pLibrary->reloads.pItems[iReload];
+        if (pLibrary->pLoader->pJobQueue != NULL) {
+            ocJobQueueWaitForCounter(pLibrary->pLoader->pJobQueue, &pReload->jobCounter);
+        }
+
+        ocResourceLibraryDiscardItem(&pReload->item);
+        ocResourceLibraryUnload(pLibrary, pReload->pResource);
+        ocFree(pReload);
+    }
+
+    // The references held for instantiated scenes are released last since reloads can be replacing their meshes.
+    for (size_t iMesh = 0; iMesh < pLibrary->sceneMeshes.count; ++iMesh) {
+        ocResourceLibraryUnload(pLibrary, pLibrary->sceneMeshes.pItems[iMesh].pResource);
+    }
+
+    ocStackUninit(&pLibrary->sceneMeshes);
+    ocStackUninit(&pLibrary->reloads);
+    ocFileWatcherUninit(&pLibrary->watcher);
+    pLibrary->isHotReloadEnabled = OC_FALSE;
+}
+
+void ocResourceLibraryUpdate(ocResourceLibrary* pLibrary)
+{
+    if (pLibrary == NULL || !pLibrary->isHotReloadEnabled) {
+        return;
+    }
+
+    ocFileWatcherPoll(&pLibrary->watcher, ocResourceLibraryOnFileChanged, pLibrary);
+
+    // Finished reloads are removed by moving the last one into their slot, so this needs to iterate backwards.
+    for (size_t iReload = pLibrary->reloads.count; iReload > 0; --iReload) {
+        ocResourceLibraryReload* pReload = pLibrary->reloads.pItems[iReload-1];
+        if (ocAtomicLoad(&pReload->jobCounter) != 0) {
+            continue;
+        }
+
+        // There's no point swapping in data that's already stale.
+        if (pReload->isOutOfDate) {
+            ocResourceLibraryDiscardItem(&pReload->item);
+            ocResourceLibraryStartReload(pLibrary, pReload);
+            continue;
+        }
+
+        ocResourceLibraryFinishReload(pLibrary, pReload);
+
+        pLibrary->reloads.pItems[iReload-1] = pLibrary->reloads.pItems[pLibrary->reloads.count-1];
+        pLibrary->reloads.count -= 1;
+
+        ocResourceLibraryUnload(pLibrary, pReload->pResource);
+        ocFree(pReload);
+    }
+}
+
+ocResult ocResourceLibraryTrackSceneMesh(ocResourceLibrary* pLibrary, ocResource* pSceneResource, ocUInt32 objectIndex, ocUInt32 groupIndex, ocGraphicsMesh* pMesh)
+{
+    if (pLibrary == NULL || pSceneResource == NULL || pSceneResource->type != ocResourceType_Scene || pMesh == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    if (!pLibrary->isHotReloadEnabled) {
+        return OC_SUCCESS;
+    }
+
+    ocResourceLibrarySceneMesh sceneMesh;
+    sceneMesh.pResource   = pSceneResource;
+    sceneMesh.objectIndex = objectIndex;
+    sceneMesh.groupIndex  = groupIndex;
+    sceneMesh.pMesh       = pMesh;
+    ocResult result = ocStackPush(&pLibrary->sceneMeshes, sceneMesh);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocMutexLock(&pLibrary->lock);
+    ocResourceLibraryAcquire(pLibrary, pSceneResource);
+    ocMutexUnlock(&pLibrary->lock);
+
     return OC_SUCCESS;
 }
\ No newline at end of file
@@ -1,10 +1,27 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+// The default budgets for each type of resource. Resources that are no longer referenced are kept in memory so they can be reused
+// without being loaded again, but only while the total size of their type is within it's budget.
+#define OC_RESOURCE_LIBRARY_DEFAULT_IMAGE_BUDGET      (256*1024*1024ULL)
+#define OC_RESOURCE_LIBRARY_DEFAULT_MATERIAL_BUDGET   (1*1024*1024ULL)
+#define OC_RESOURCE_LIBRARY_DEFAULT_SCENE_BUDGET      (128*1024*1024ULL)
+#define OC_RESOURCE_LIBRARY_DEFAULT_SOUND_BUDGET      (64*1024*1024ULL)
+#define OC_RESOURCE_LIBRARY_DEFAULT_SKELETON_BUDGET   (4*1024*1024ULL)
+#define OC_RESOURCE_LIBRARY_DEFAULT_ANIMATION_BUDGET  (64*1024*1024ULL)
+
 struct ocResource
 {
     ocResourceType type;
     const char* pAbsolutePath;
-    ocUInt32 referenceCount;
+    ocUInt32 referenceCount;    // <-- Protected by the library's lock. Do not modify this directly.
+
+    // The amount of memory used by the resource. The CPU size includes the resource object itself.
+    ocUInt64 cpuSizeInBytes;
+    ocUInt64 gpuSizeInBytes;
+
+    // [Internal Use Only] The links in the library's list of unused resources. Only valid while the reference count is 0.
+    ocResource* pPrevUnused;
+    ocResource* pNextUnused;
 
     union
     {
@@ -13,7 +30,11 @@ struct ocResource
             ocGraphicsImage* pGraphicsImage;
         } image;
 
+        ocMaterialData material;
         ocSceneData scene;
+        ocSoundData sound;  // <-- Play with ocAudioPlaySound().
+        ocSkeleton skeleton;
+        ocAnimationClip animation;
     };
 
     // [Internal Use Only] A single allocation for dynamically sized data.
@@ -25,24 +46,128 @@ struct ocResource
     char _pPayload[1];
 };
 
+struct ocResourceLibraryTypeStats
+{
+    ocUInt32 residentCount;         // <-- The number of resources in memory, including unused ones.
+    ocUInt32 unusedCount;           // <-- The number of resources in memory that have no references.
+    ocUInt64 cpuSizeInBytes;        // <-- The CPU memory used by every resource in memory.
+    ocUInt64 gpuSizeInBytes;        // <-- The GPU memory used by every resource in memory.
+    ocUInt64 unusedSizeInBytes;     // <-- The CPU and GPU memory used by unused resources. This is what can be evicted.
+    ocUInt64 budgetInBytes;
+};
+
+struct ocResourceLibraryStats
+{
+    ocResourceLibraryTypeStats types[ocResourceType_Count];
+    ocUInt64 hitCount;              // <-- The number of loads that were satisfied by a resource that was already in memory.
+    ocUInt64 missCount;             // <-- The number of loads that had to load the resource from the file system.
+    ocUInt64 evictionCount;         // <-- The number of unused resources that have been freed to stay within budget.
+};
+
+struct ocResourceLibraryReload;
+
+// A graphics mesh that was created from a mesh group of a scene resource. See ocResourceLibraryTrackSceneMesh().
+struct ocResourceLibrarySceneMesh
+{
+    ocResource* pResource;          // <-- A reference is held so the scene stays in memory, and therefore watched, while it's instantiated.
+    ocUInt32 objectIndex;
+    ocUInt32 groupIndex;            // <-- Counted across every mesh component of the object, in order.
+    ocGraphicsMesh* pMesh;
+};
+
 struct ocResourceLibrary
 {
     ocResourceLoader* pLoader;
     ocGraphicsContext* pGraphics;
+    ocDerivedDataCache* pCache;
+
+    ocMutex lock;
+    ocStack<ocResource*> resources;     // <-- Every resource in memory, sorted by absolute path.
+    ocResource* pFirstUnused;           // <-- The most recently used resource with no references.
+    ocResource* pLastUnused;            // <-- The least recently used resource with no references. This is the first to be evicted.
+    ocResourceLibraryStats stats;
+
+    // Hot reloading. Only accessed from the thread that owns the graphics context.
+    ocBool32 isHotReloadEnabled;
+    ocFileWatcher watcher;
+    ocStack<ocResourceLibraryReload*> reloads;  // <-- Reloads that are in progress.
+    ocStack<ocResourceLibrarySceneMesh> sceneMeshes;
 };
 
-//
-ocResult ocResourceLibraryInit(ocResourceLoader* pLoader, ocGraphicsContext* pGraphics, ocResourceLibrary* pLibrary);
+// pCache can be NULL, in which case source assets will be converted every time they're loaded.
+ocResult ocResourceLibraryInit(ocResourceLoader* pLoader, ocGraphicsContext* pGraphics, ocDerivedDataCache* pCache, ocResourceLibrary* pLibrary);
 
-//
+// Uninitializes the library, freeing every resource that's still in memory.
 void ocResourceLibraryUninit(ocResourceLibrary* pLibrary);
 
 
 // Loads a resource from the file system.
+//
+// If the resource is already in memory, including when it's been unloaded but not yet evicted, a new reference to it is returned
+// and the file is not read again. Otherwise the file is read, and source assets are cooked or taken from the derived data cache.
 ocResult ocResourceLibraryLoad(ocResourceLibrary* pLibrary, const char* filePath, ocResource** ppResource);
 
+// Loads a group of resources from the file system.
+//
+// This is faster than loading each resource individually. The files are read with a single batch of asynchronous reads, and they're
+// cooked and decoded in parallel on the job queue. Every file is read into memory before any resource is created so avoid very large
+// groups. A file that's requested more than once is only loaded once, and each request receives a reference to the same resource.
+//
+// ppResources receives a resource for each file, or NULL if the file failed to load. pResults can be NULL. When non-NULL, it receives
+// the result for each file. The return value is the result of the first file that failed to load, or OC_SUCCESS.
+ocResult ocResourceLibraryLoadMultiple(ocResourceLibrary* pLibrary, ocUInt32 count, const char** ppFilePaths, ocResource** ppResources, ocResult* pResults);
+
 // Unloads a resource.
+//
+// When the last reference is released the resource is kept in memory in case it's loaded again. Unused resources are evicted in least
+// recently used order when their type goes over budget.
 void ocResourceLibraryUnload(ocResourceLibrary* pLibrary, ocResource* pResource);
 
+
+// Adds a reference to a resource that the caller already holds a reference to. Release it with ocResourceLibraryUnload(). This is used
+// by things that outlive the caller's own reference, such as voices that are playing a sound.
+void ocResourceLibraryAddReference(ocResourceLibrary* pLibrary, ocResource* pResource);
+
+// Sets the memory budget for a type of resource, evicting unused resources if it's now over budget. Resources that are still referenced
+// are never evicted so the budget can be exceeded while they're in use. A budget of 0 frees resources as soon as they're unloaded.
+ocResult ocResourceLibrarySetBudget(ocResourceLibrary* pLibrary, ocResourceType type, ocUInt64 budgetInBytes);
+
+// Evicts every unused resource regardless of budgets.
+void ocResourceLibraryEvictUnused(ocResourceLibrary* pLibrary);
+
+// Retrieves a snapshot of the library's memory usage.
+ocResult ocResourceLibraryGetStats(ocResourceLibrary* pLibrary, ocResourceLibraryStats* pStats);
+
+
+// Enables hot reloading.
+//
+// When enabled, the file of every resource in memory is watched for changes. When a file changes it's loaded again in the background and
+// then swapped into the existing resource object by ocResourceLibraryUpdate(). Anything holding a reference to the resource, including
+// it's graphics image, sees the new data without needing to do anything. The meshes of scenes that have already been instantiated are
+// replaced as well, but changes to their objects and other components are only seen when the scene is instantiated again. Sounds are
+// not reloaded because voices that are playing them read their data directly. Skeletons and animations are not reloaded because animated
+// characters refer to them directly. A message is logged when a change to one of these is ignored. Materials are not watched at all.
+//
+// Returns OC_FEATURE_NOT_SUPPORTED if file watching is not supported on the current platform.
+ocResult ocResourceLibraryEnableHotReload(ocResourceLibrary* pLibrary);
+
+// Processes file changes and swaps in resources that have finished reloading. Does nothing if hot reloading is not enabled.
+//
+// This must be called from the thread that owns the graphics context at a point where the GPU is not using any resources, which is
+// between frames. This is done by ocStep() so you should not normally need to call this directly.
+void ocResourceLibraryUpdate(ocResourceLibrary* pLibrary);
+
+// Tracks a graphics mesh that was created from a mesh group of a scene resource so that it's contents are replaced when the scene is hot
+// reloaded. Groups are numbered across every mesh component of the object, in order. Does nothing if hot reloading is not enabled. This is
+// done by ocWorld when it instantiates a scene.
+//
+// The mesh must not be deleted until hot reloading is disabled, which also happens when the library is uninitialized. This must be
+// called from the thread that owns the graphics context.
+ocResult ocResourceLibraryTrackSceneMesh(ocResourceLibrary* pLibrary, ocResource* pSceneResource, ocUInt32 objectIndex, ocUInt32 groupIndex, ocGraphicsMesh* pMesh);
+
+
 // Synchronizes or creates the .ocd file associated with a resource.
+//
+// The .ocd file is written next to the source asset. It's only used when the source asset is not available, such as in a build that
+// only ships .ocd files. When the source asset is available the derived data cache is used instead.
 ocResult ocResourceLibrarySyncOCD(ocResourceLibrary* pLibrary, const char* filePath);
\ No newline at end of file
@@ -56,8 +56,35 @@ OC_PRIVATE ocResult ocMallocAndReadEntireStreamReader(ocStreamReader* pReader, v
     return OC_SUCCESS;
 }
 
+// Decompresses OCD data if it's compressed. When it is, *ppData is replaced with the decompressed data and the original data is freed,
+// including when decompression fails. pJobQueue is used to decompress the chunks in parallel and can be NULL.
+OC_PRIVATE ocResult ocDecompressOCDIfNecessary(ocJobQueue* pJobQueue, void** ppData, ocUInt64* pDataSize)
+{
+    ocAssert(ppData != NULL);
+    ocAssert(pDataSize != NULL);
+
+    if (!ocOCDIsCompressed(*ppData, (ocSizeT)*pDataSize)) {
+        return OC_SUCCESS;
+    }
+
+    void* pOCDData;
+    ocSizeT ocdDataSize;
+    ocResult result = ocOCDDecompress(*ppData, (ocSizeT)*pDataSize, pJobQueue, &pOCDData, &ocdDataSize);
+    ocFree(*ppData);
+
+    if (result != OC_SUCCESS) {
+        *ppData = NULL;
+        *pDataSize = 0;
+        return result;
+    }
+
+    *ppData = pOCDData;
+    *pDataSize = ocdDataSize;
+    return OC_SUCCESS;
+}
 
-ocResult ocResourceLoaderInit(ocFileSystem* pFS, ocResourceLoader* pLoader)
+
+ocResult ocResourceLoaderInit(ocFileSystem* pFS, ocJobQueue* pJobQueue, ocResourceLoader* pLoader)
 {
     if (pLoader == NULL || pFS == NULL) {
         return OC_INVALID_ARGS;
@@ -65,6 +92,7 @@ ocResult ocResourceLoaderInit(ocFileSystem* pFS, ocResourceLoader* pLoader)
 
     ocZeroObject(pLoader);
     pLoader->pFS = pFS;
+    pLoader->pJobQueue = pJobQueue;
 
     return OC_SUCCESS;
 }
@@ -102,10 +130,12 @@ OC_PRIVATE ocResult ocResourceLoaderDetermineOCDResourceType(ocResourceLoader* p
         return OC_CORRUPT_FILE;
     }
 
-    switch (ids[1])
+    switch (ids[1] & ~OC_OCD_TYPE_FLAG_COMPRESSED)
     {
         case OC_OCD_TYPE_ID_IMAGE: *pType = ocResourceType_Image; return OC_SUCCESS;
         case OC_OCD_TYPE_ID_SCENE: *pType = ocResourceType_Scene; return OC_SUCCESS;
+        case OC_OCD_TYPE_ID_SKELETON: *pType = ocResourceType_Skeleton; return OC_SUCCESS;
+        case OC_OCD_TYPE_ID_ANIMATION: *pType = ocResourceType_Animation; return OC_SUCCESS;
         default: return OC_UNKNOWN_RESOURCE_TYPE;
     }
 }
@@ -130,7 +160,8 @@ ocResult ocResourceLoaderDetermineResourceType(ocResourceLoader* pLoader, const
     // Images.
     if (_stricmp(ext, "png") == 0 ||
         _stricmp(ext, "tga") == 0 ||
-        _stricmp(ext, "jpg") == 0) {
+        _stricmp(ext, "jpg") == 0 ||
+        _stricmp(ext, "jpeg") == 0) {
         *pType = ocResourceType_Image;
         return OC_SUCCESS;
     }
@@ -161,6 +192,12 @@ ocResult ocResourceLoaderDetermineResourceType(ocResourceLoader* pLoader, const
         return OC_SUCCESS;
     }
 
+    // Sounds.
+    if (ocAudioEncodingFromPath(filePath) != ocAudioEncoding_Unknown) {
+        *pType = ocResourceType_Sound;
+        return OC_SUCCESS;
+    }
+
     return OC_UNKNOWN_RESOURCE_TYPE;
 }
 
@@ -182,6 +219,13 @@ OC_PRIVATE ocResult ocConvertToOCD_SimpleImage(ocImageFormat format, ocUInt32 wi
         return result;
     }
 
+    // The full mipmap chain is generated here so it doesn't need to be done at load time.
+    result = ocOCDImageBuilderGenerateMipmaps(&builder);
+    if (result != OC_SUCCESS) {
+        ocOCDImageBuilderUninit(&builder);
+        return result;
+    }
+
     result = ocOCDImageBuilderRender(&builder, pOCDWriter);
 
     ocOCDImageBuilderUninit(&builder);
@@ -189,7 +233,7 @@ OC_PRIVATE ocResult ocConvertToOCD_SimpleImage(ocImageFormat format, ocUInt32 wi
 }
 
 
-OC_PRIVATE ocResult ocLoadImage_OCD(ocStreamReader* pReader, ocImageData* pData)
+OC_PRIVATE ocResult ocLoadImage_OCD(ocStreamReader* pReader, ocJobQueue* pJobQueue, ocImageData* pData)
 {
     ocAssert(pReader != NULL);
     ocAssert(pData != NULL);
@@ -200,6 +244,11 @@ OC_PRIVATE ocResult ocLoadImage_OCD(ocStreamReader* pReader, ocImageData* pData)
         return result;
     }
 
+    result = ocDecompressOCDIfNecessary(pJobQueue, (void**)&pData->pPayload, &fileSize);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
     if (!ocCheckOCDHeader(pData->pPayload, fileSize, OC_OCD_TYPE_ID_IMAGE)) {
         ocFree(pData->pPayload);
         return OC_CORRUPT_FILE;
@@ -218,19 +267,22 @@ OC_PRIVATE ocResult ocLoadImage_Raw(ocImageFormat format, ocUInt32 width, ocUInt
 {
     // We convert the image data to an OCD file, and then load the image via the OCD loading pipeline. Inefficient, but keeps all image loading
     // on the same code path.
-    void* pDataOCD;
-    ocSizeT dataSizeOCD;
     ocStreamWriter writerOCD;
-    ocResult result = ocStreamWriterInit(&pDataOCD, &dataSizeOCD, &writerOCD);
+    ocResult result = ocStreamWriterInitChunked(0, &writerOCD);
     if (result != OC_SUCCESS) {
         return result;
     }
 
+    void* pDataOCD = NULL;
+    ocSizeT dataSizeOCD = 0;
     result = ocConvertToOCD_SimpleImage(format, width, height, pImageData, &writerOCD);
+    if (result == OC_SUCCESS) {
+        result = ocStreamWriterTakeChunkedData(&writerOCD, &pDataOCD, &dataSizeOCD);
+    }
+
     ocStreamWriterUninit(&writerOCD);   // <-- Don't need this anymore. Data will be in pDataOCD, which needs to be ocFree()'d by us.
 
     if (result != OC_SUCCESS) {
-        ocFree(pDataOCD);
         return result;
     }
 
@@ -242,7 +294,7 @@ OC_PRIVATE ocResult ocLoadImage_Raw(ocImageFormat format, ocUInt32 width, ocUInt
         return result;
     }
 
-    result = ocLoadImage_OCD(&readerOCD, pData);
+    result = ocLoadImage_OCD(&readerOCD, NULL, pData);
     
     ocStreamReaderUninit(&readerOCD);
     ocFree(pDataOCD);
@@ -279,22 +331,57 @@ OC_PRIVATE int oc__stbi_eof(void* user)
     return ocStreamReaderAtEnd(pReader);
 }
 
-OC_PRIVATE ocResult ocLoadImage_STB(ocStreamReader* pReader, ocImageData* pData)
+// Free the returned data with stbi_image_free().
+OC_PRIVATE stbi_uc* ocDecodeImage_STB(ocStreamReader* pReader, int* pWidth, int* pHeight)
 {
     ocAssert(pReader != NULL);
-    ocAssert(pData != NULL);
+    ocAssert(pWidth != NULL);
+    ocAssert(pHeight != NULL);
 
     // The engine expects upside-down images because of OpenGL and Vulkan.
     stbi_set_flip_vertically_on_load(1);
 
+    // When the data is already in memory it can be decoded in-place rather than being copied through the callbacks.
+    const void* pDirectData;
+    ocSizeT directDataSize;
+    if (ocStreamReaderGetDirectData(pReader, &pDirectData, &directDataSize) == OC_SUCCESS) {
+        return stbi_load_from_memory((const stbi_uc*)pDirectData, (int)directDataSize, pWidth, pHeight, NULL, 4);
+    }
+
     stbi_io_callbacks cb;
     cb.read = oc__stbi_read;
     cb.skip = oc__stbi_skip;
     cb.eof  = oc__stbi_eof;
 
+    return stbi_load_from_callbacks(&cb, pReader, pWidth, pHeight, NULL, 4); // Always want RGBA images.
+}
+
+OC_PRIVATE ocResult ocConvertToOCD_STB(ocStreamReader* pReader, ocStreamWriter* pOCDWriter)
+{
+    ocAssert(pReader != NULL);
+    ocAssert(pOCDWriter != NULL);
+
+    int imageWidth;
+    int imageHeight;
+    stbi_uc* pImageData = ocDecodeImage_STB(pReader, &imageWidth, &imageHeight);
+    if (pImageData == NULL) {
+        return OC_FAILED_TO_LOAD_RESOURCE;
+    }
+
+    ocResult result = ocConvertToOCD_SimpleImage(ocImageFormat_R8G8B8A8, imageWidth, imageHeight, pImageData, pOCDWriter);
+    stbi_image_free(pImageData);
+
+    return result;
+}
+
+OC_PRIVATE ocResult ocLoadImage_STB(ocStreamReader* pReader, ocImageData* pData)
+{
+    ocAssert(pReader != NULL);
+    ocAssert(pData != NULL);
+
     int imageWidth;
     int imageHeight;
-    stbi_uc* pImageData = stbi_load_from_callbacks(&cb, pReader, &imageWidth, &imageHeight, NULL, 4); // Always want RGBA images.
+    stbi_uc* pImageData = ocDecodeImage_STB(pReader, &imageWidth, &imageHeight);
     if (pImageData == NULL) {
         return OC_FAILED_TO_LOAD_RESOURCE;
     }
@@ -326,12 +413,16 @@ ocResult ocResourceLoaderLoadImage(ocResourceLoader* pLoader, const char* filePa
         return result;
     }
 
+    // stb_image pulls data through it's callbacks in small pieces so the reader is buffered. This does nothing for files in a
+    // package, which are decoded straight from memory.
+    ocStreamReaderSetBufferSize(&reader, OC_RESOURCE_LOADER_READ_BUFFER_SIZE);  // <-- Not fatal if this fails.
+
 
     // We use a trial and error system for loading different file formats. If one fails, we just fall through to the
     // next sub-loader and try again. The exception is .ocd files which is the native file format for the engine. When
     // a file with this extension is specified, it will _not_ fall through to the next sub-loaders.
     if (ocPathExtensionEqual(filePath, "ocd")) {
-        result = ocLoadImage_OCD(&reader, pData);
+        result = ocLoadImage_OCD(&reader, pLoader->pJobQueue, pData);
     } else {
         result = OC_FAILED_TO_LOAD_RESOURCE;
 
@@ -362,6 +453,25 @@ ocResult ocResourceLoaderLoadImage(ocResourceLoader* pLoader, const char* filePa
     return result;
 }
 
+ocResult ocResourceLoaderLoadImageFromOCD(ocResourceLoader* pLoader, const void* pOCDData, ocSizeT ocdDataSize, ocImageData* pData)
+{
+    if (pData == NULL) return OC_INVALID_ARGS;
+    ocZeroObject(pData);
+
+    if (pLoader == NULL || pOCDData == NULL) return OC_INVALID_ARGS;
+
+    ocStreamReader reader;
+    ocResult result = ocStreamReaderInit(pOCDData, ocdDataSize, &reader);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocLoadImage_OCD(&reader, pLoader->pJobQueue, pData);
+
+    ocStreamReaderUninit(&reader);
+    return result;
+}
+
 void ocResourceLoaderUnloadImage(ocResourceLoader* pLoader, ocImageData* pData)
 {
     if (pLoader == NULL || pData == NULL) {
@@ -375,177 +485,257 @@ void ocResourceLoaderUnloadImage(ocResourceLoader* pLoader, ocImageData* pData)
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-// Scenes
+// Materials
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-OC_PRIVATE ocResult ocLoadScene_OCD(ocStreamReader* pReader, ocSceneData* pData)
+OC_INLINE ocBool32 ocIsMTLWhitespace(char c)
 {
-    ocAssert(pReader != NULL);
-    ocAssert(pData != NULL);
+    return c == ' ' || c == '\t';
+}
 
-    // Loading an OCD file is very simple because the file format nicely maps to our data structures.
-    ocUInt64 fileSize;
-    ocResult result = ocMallocAndReadEntireStreamReader(pReader, (void**)&pData->pPayload, &fileSize);
-    if (result != OC_SUCCESS) {
-        return result;
+// Copies the arguments of a statement into a null terminated buffer so they can be parsed with the standard library. Returns false if
+// they don't fit, in which case the statement is ignored.
+OC_PRIVATE ocBool32 ocCopyMTLArgs(char* pArgsOut, size_t argsOutSize, const char* pArgs, const char* pArgsEnd)
+{
+    size_t argsLen = (size_t)(pArgsEnd - pArgs);
+    if (argsLen >= argsOutSize) {
+        return OC_FALSE;
     }
 
-    if (!ocCheckOCDHeader(pData->pPayload, fileSize, OC_OCD_TYPE_ID_SCENE)) {
-        ocFree(pData->pPayload);
-        return OC_CORRUPT_FILE;
-    }
+    ocCopyMemory(pArgsOut, pArgs, argsLen);
+    pArgsOut[argsLen] = '\0';
+    return OC_TRUE;
+}
 
+// Finds the statements of the material with the given name in the text of a .mtl library and applies them to pData.
+OC_PRIVATE ocResult ocParseMTLMaterial(const char* pText, const char* pTextEnd, const char* name, const char* libraryPath, ocMaterialData* pData)
+{
+    ocAssert(pText != NULL);
+    ocAssert(name != NULL);
+    ocAssert(libraryPath != NULL);
+    ocAssert(pData != NULL);
 
-    // Retrieve the subresource and object counts and offsets for convenience.
-    pData->subresourceCount = *(ocUInt32*)(pData->pPayload + OC_OCD_HEADER_SIZE + 0);
-    pData->objectCount      = *(ocUInt32*)(pData->pPayload + OC_OCD_HEADER_SIZE + 4);
+    size_t nameLen = strlen(name);
+    ocBool32 isInMaterial = OC_FALSE;
+    ocBool32 isFound = OC_FALSE;
 
-    ocUInt64 subresourcesOffset = *(ocUInt64*)(pData->pPayload + OC_OCD_HEADER_SIZE + 8);
-    ocUInt64 objectsOffset      = *(ocUInt64*)(pData->pPayload + OC_OCD_HEADER_SIZE + 16);
+    const char* pLine = pText;
+    while (pLine < pTextEnd) {
+        const char* pLineEnd = pLine;
+        while (pLineEnd < pTextEnd && pLineEnd[0] != '\n' && pLineEnd[0] != '\r') {
+            pLineEnd += 1;
+        }
 
-    pData->pSubresources = (ocSceneSubresource*)(pData->pPayload + subresourcesOffset);
-    pData->pObjects      =      (ocSceneObject*)(pData->pPayload + objectsOffset);
-    
-    return OC_SUCCESS;
-}
+        const char* pNextLine = pLineEnd;
+        while (pNextLine < pTextEnd && (pNextLine[0] == '\n' || pNextLine[0] == '\r')) {
+            pNextLine += 1;
+        }
 
+        while (pLine < pLineEnd && ocIsMTLWhitespace(pLine[0])) {
+            pLine += 1;
+        }
+        while (pLineEnd > pLine && ocIsMTLWhitespace(pLineEnd[-1])) {
+            pLineEnd -= 1;
+        }
 
-OC_PRIVATE size_t oc__miniobj_read(void* userData, void* bufferOut, size_t bytesToRead)
-{
-    size_t bytesRead;
-    ocResult result = ocStreamReaderRead((ocStreamReader*)userData, bufferOut, bytesToRead, &bytesRead);
-    if (result != OC_SUCCESS) {
-        return 0;
+        const char* pKeywordEnd = pLine;
+        while (pKeywordEnd < pLineEnd && !ocIsMTLWhitespace(pKeywordEnd[0])) {
+            pKeywordEnd += 1;
+        }
+
+        const char* pArgs = pKeywordEnd;
+        while (pArgs < pLineEnd && ocIsMTLWhitespace(pArgs[0])) {
+            pArgs += 1;
+        }
+
+        size_t keywordLen = (size_t)(pKeywordEnd - pLine);
+        char args[OC_MAX_PATH];
+
+        // Material names run to the end of the line, the same as they do in usemtl statements.
+        if (keywordLen == 6 && strncmp(pLine, "newmtl", 6) == 0) {
+            if (isInMaterial) {
+                break;  // <-- The end of the material we're looking for.
+            }
+
+            isInMaterial = (size_t)(pLineEnd - pArgs) == nameLen && strncmp(pArgs, name, nameLen) == 0;
+            isFound = isFound || isInMaterial;
+        } else if (isInMaterial) {
+            if (keywordLen == 2 && strncmp(pLine, "Kd", 2) == 0) {
+                if (ocCopyMTLArgs(args, sizeof(args), pArgs, pLineEnd)) {
+                    char* pNext = args;
+                    for (int i = 0; i < 3; ++i) {
+                        pData->diffuseColor[i] = strtof(pNext, &pNext);
+                    }
+                }
+            } else if (keywordLen == 1 && pLine[0] == 'd') {
+                if (ocCopyMTLArgs(args, sizeof(args), pArgs, pLineEnd)) {
+                    pData->diffuseColor[3] = strtof(args, NULL);
+                }
+            } else if (keywordLen == 6 && strncmp(pLine, "map_Kd", 6) == 0) {
+                // Options such as "-s 2 2 1" come before the file name so the file name is the last argument.
+                const char* pFileName = pLineEnd;
+                while (pFileName > pArgs && !ocIsMTLWhitespace(pFileName[-1])) {
+                    pFileName -= 1;
+                }
+
+                char directoryPath[OC_MAX_PATH];
+                char mapPath[OC_MAX_PATH];
+                if (ocCopyMTLArgs(args, sizeof(args), pFileName, pLineEnd) && ocPathRemoveFileName(directoryPath, sizeof(directoryPath), libraryPath) > 0 &&
+                    ocPathAppend(mapPath, sizeof(mapPath), directoryPath, args) > 0) {
+                    ocFreeString(pData->diffuseMapPath);
+                    pData->diffuseMapPath = ocMakeString(mapPath);
+                    if (pData->diffuseMapPath == NULL) {
+                        return OC_OUT_OF_MEMORY;
+                    }
+                }
+            }
+        }
+
+        pLine = pNextLine;
     }
 
-    return bytesRead;
+    return (isFound) ? OC_SUCCESS : OC_DOES_NOT_EXIST;
 }
 
-OC_PRIVATE ocBool32 oc__miniobj_seek_to_start(void* userData)
+ocResult ocResourceLoaderLoadMaterial(ocResourceLoader* pLoader, const char* filePath, ocMaterialData* pData)
 {
-    return ocStreamReaderSeek((ocStreamReader*)userData, 0, ocSeekOrigin_Start) == OC_SUCCESS;
-}
+    if (pData == NULL) {
+        return OC_INVALID_ARGS;
+    }
 
-OC_PRIVATE ocResult ocConvertToOCD_OBJ(ocStreamReader* pOBJReader, ocStreamWriter* pOCDWriter)
-{
-    ocAssert(pOBJReader != NULL);
-    ocAssert(pOCDWriter != NULL);
+    ocZeroObject(pData);
 
-    miniobj* obj = miniobj_load(oc__miniobj_read, oc__miniobj_seek_to_start, pOBJReader);
-    if (obj == NULL) {
-        return OC_FAILED_TO_LOAD_RESOURCE;
+    if (pLoader == NULL || filePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    char libraryPath[OC_MAX_PATH];
+    if (ocPathRemoveFileName(libraryPath, sizeof(libraryPath), filePath) == 0 || !ocPathExtensionEqual(libraryPath, "mtl")) {
+        return OC_UNSUPPORTED_RESOURCE_TYPE;
     }
 
-    // We use a scene builder to convert OBJ to OCD.
-    ocOCDSceneBuilder builder;
-    ocResult result = ocOCDSceneBuilderInit(&builder);
+    ocFile file;
+    ocResult result = ocFileOpen(pLoader->pFS, libraryPath, OC_READ, &file);
     if (result != OC_SUCCESS) {
-        miniobj_delete(obj);
         return result;
     }
 
-    result = ocOCDSceneBuilderBeginObject(&builder, "mesh", glm::vec3(0, 0, 0), glm::quat(1, 0, 0, 0), glm::vec3(1, 1, 1));
+    ocStreamReader reader;
+    result = ocStreamReaderInit(&file, &reader);
     if (result != OC_SUCCESS) {
-        goto done;
+        ocFileClose(&file);
+        return result;
     }
-    {
-        // The object has a single mesh component, with a group for each material.
-        result = ocOCDSceneBuilderBeginMeshComponent(&builder);
-        if (result != OC_SUCCESS) {
-            goto done;
-        }
-        {
-            for (ocUInt32 iMaterial = 0; iMaterial < obj->materialCount; ++iMaterial) {
-                miniobj_material* pMaterial = &obj->pMaterials[iMaterial];
-                
-                ocUInt32 vertexCount;
-                float* pVertexData;
-                ocUInt32 indexCount;
-                ocUInt32* pIndexData;
-                miniobj_interleave_p3t2n3_material(obj, iMaterial, &vertexCount, &pVertexData, &indexCount, &pIndexData);
-
-                // TODO: With the material, might want to first find the full library/name path.
-
-                result = ocOCDSceneBuilderMeshComponentAddGroup(&builder, pMaterial->name, ocGraphicsPrimitiveType_Triangle, ocGraphicsVertexFormat_P3T2N3, vertexCount, pVertexData, indexCount, pIndexData);
-                if (result != OC_SUCCESS) {
-                    miniobj_free(pVertexData);
-                    miniobj_free(pIndexData);
-                    goto done;
-                }
 
-                miniobj_free(pVertexData);
-                miniobj_free(pIndexData);
-            }
-        }
-        result = ocOCDSceneBuilderEndMeshComponent(&builder);
-        if (result != OC_SUCCESS) {
-            goto done;
-        }
-    }
-    result = ocOCDSceneBuilderEndObject(&builder);
+    void* pText;
+    ocUInt64 textSize;
+    result = ocMallocAndReadEntireStreamReader(&reader, &pText, &textSize);
+
+    ocStreamReaderUninit(&reader);
+    ocFileClose(&file);
+
     if (result != OC_SUCCESS) {
-        goto done;
+        return result;
     }
 
-    result = ocOCDSceneBuilderRender(&builder, pOCDWriter);
+    pData->diffuseColor[0] = 1;
+    pData->diffuseColor[1] = 1;
+    pData->diffuseColor[2] = 1;
+    pData->diffuseColor[3] = 1;
+
+    result = ocParseMTLMaterial((const char*)pText, (const char*)pText + textSize, ocPathFileName(filePath), libraryPath, pData);
+    ocFree(pText);
+
     if (result != OC_SUCCESS) {
-        goto done;
+        ocResourceLoaderUnloadMaterial(pLoader, pData);
+        return result;
     }
 
-    result = OC_SUCCESS;
+    return OC_SUCCESS;
+}
 
-done:
-    ocOCDSceneBuilderUninit(&builder);
-    miniobj_delete(obj);
-    return result;
+void ocResourceLoaderUnloadMaterial(ocResourceLoader* pLoader, ocMaterialData* pData)
+{
+    if (pLoader == NULL || pData == NULL) {
+        return;
+    }
+
+    ocFreeString(pData->diffuseMapPath);
+    ocZeroObject(pData);
 }
 
-OC_PRIVATE ocResult ocLoadScene_OBJ(ocStreamReader* pReader, ocSceneData* pData)
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Scenes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Takes ownership of pPayload, freeing it if the data is invalid.
+OC_PRIVATE ocResult ocLoadScene_OCDPayload(ocUInt8* pPayload, ocUInt64 payloadSize, ocSceneData* pData)
 {
-    ocAssert(pReader != NULL);
+    ocAssert(pPayload != NULL);
     ocAssert(pData != NULL);
 
-    // Loading an OBJ file is a bit unintuitive. We actually convert it to an in-memory OCD file first, and then simply load the resulting OCD. The
-    // reason for this design is that loading scene resources is complicated, and I want all types to be loaded through the same code path for safety
-    // and maintainability (that code path being the OCD loading routine). In addition, all scene resource types need to be convertible to OCD anyway
-    // which makes this design choice good for the sake of code reuse.
+    if (!ocCheckOCDHeader(pPayload, payloadSize, OC_OCD_TYPE_ID_SCENE)) {
+        ocFree(pPayload);
+        return OC_CORRUPT_FILE;
+    }
 
-    // A stream writer is the where the OCD file is output.
-    void* pDataOCD;
-    ocSizeT dataSizeOCD;
-    ocStreamWriter writerOCD;
-    ocResult result = ocStreamWriterInit(&pDataOCD, &dataSizeOCD, &writerOCD);
+    pData->pPayload = pPayload;
+    pData->payloadSize = payloadSize;
+
+    // Retrieve the subresource and object counts and offsets for convenience.
+    pData->subresourceCount = *(ocUInt32*)(pData->pPayload + OC_OCD_HEADER_SIZE + 0);
+    pData->objectCount      = *(ocUInt32*)(pData->pPayload + OC_OCD_HEADER_SIZE + 4);
+
+    ocUInt64 subresourcesOffset = *(ocUInt64*)(pData->pPayload + OC_OCD_HEADER_SIZE + 8);
+    ocUInt64 objectsOffset      = *(ocUInt64*)(pData->pPayload + OC_OCD_HEADER_SIZE + 16);
+
+    pData->pSubresources = (ocSceneSubresource*)(pData->pPayload + subresourcesOffset);
+    pData->pObjects      =      (ocSceneObject*)(pData->pPayload + objectsOffset);
+    
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocLoadScene_OCD(ocStreamReader* pReader, ocJobQueue* pJobQueue, ocSceneData* pData)
+{
+    ocAssert(pReader != NULL);
+    ocAssert(pData != NULL);
+
+    // Loading an OCD file is very simple because the file format nicely maps to our data structures.
+    void* pPayload;
+    ocUInt64 fileSize;
+    ocResult result = ocMallocAndReadEntireStreamReader(pReader, &pPayload, &fileSize);
     if (result != OC_SUCCESS) {
         return result;
     }
 
-    // Convert the OBJ file to an OCD file. pReader is the OBJ file, writerOCD is the OCD file.
-    result = ocConvertToOCD_OBJ(pReader, &writerOCD);
+    result = ocDecompressOCDIfNecessary(pJobQueue, &pPayload, &fileSize);
     if (result != OC_SUCCESS) {
-        ocStreamWriterUninit(&writerOCD);
-        ocFree(pDataOCD);
         return result;
     }
 
+    return ocLoadScene_OCDPayload((ocUInt8*)pPayload, fileSize, pData);
+}
 
-    // The stream writer is no longer needed. At this point, pDataOCD contains the raw OCD data (which needs to be ocFree()'d by us).
-    ocStreamWriterUninit(&writerOCD);
-
+OC_PRIVATE ocResult ocLoadScene_OBJ(ocStreamReader* pReader, ocJobQueue* pJobQueue, ocSceneData* pData)
+{
+    ocAssert(pReader != NULL);
+    ocAssert(pData != NULL);
 
-    // Now we just load the OCD file like normal.
-    ocStreamReader readerOCD;
-    result = ocStreamReaderInit(pDataOCD, dataSizeOCD, &readerOCD);
+    // OBJ files are converted to OCD and then loaded like any other OCD file so that every scene goes through the same code path. The
+    // converted data becomes the payload as-is so the geometry is never copied more than once.
+    void* pOCDData;
+    ocSizeT ocdDataSize;
+    ocResult result = ocConvertOBJToOCD(pReader, pJobQueue, &pOCDData, &ocdDataSize);
     if (result != OC_SUCCESS) {
-        ocFree(pDataOCD);
         return result;
     }
 
-    result = ocLoadScene_OCD(&readerOCD, pData);
-    
-    ocStreamReaderUninit(&readerOCD);
-    ocFree(pDataOCD);
-    return result;
+    return ocLoadScene_OCDPayload((ocUInt8*)pOCDData, ocdDataSize, pData);
 }
 
 
@@ -579,13 +769,13 @@ ocResult ocResourceLoaderLoadScene(ocResourceLoader* pLoader, const char* filePa
     // next sub-loader and try again. The exception is .ocd files which is the native file format for the engine. When
     // a file with this extension is specified, it will _not_ fall through to the next sub-loaders.
     if (ocPathExtensionEqual(filePath, "ocd")) {
-        result = ocLoadScene_OCD(&reader, pData);
+        result = ocLoadScene_OCD(&reader, pLoader->pJobQueue, pData);
     } else {
         result = OC_FAILED_TO_LOAD_RESOURCE;
 
         // OBJ.
         if (result != OC_SUCCESS && ocPathExtensionEqual(filePath, "obj")) {
-            result = ocLoadScene_OBJ(&reader, pData);
+            result = ocLoadScene_OBJ(&reader, pLoader->pJobQueue, pData);
         }
 
 #if 0
@@ -606,6 +796,53 @@ ocResult ocResourceLoaderLoadScene(ocResourceLoader* pLoader, const char* filePa
     return result;
 }
 
+ocResult ocResourceLoaderLoadSceneFromOCD(ocResourceLoader* pLoader, const void* pOCDData, ocSizeT ocdDataSize, ocSceneData* pData)
+{
+    if (pData == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pData);
+
+    if (pLoader == NULL || pOCDData == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocStreamReader reader;
+    ocResult result = ocStreamReaderInit(pOCDData, ocdDataSize, &reader);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocLoadScene_OCD(&reader, pLoader->pJobQueue, pData);
+
+    ocStreamReaderUninit(&reader);
+    return result;
+}
+
+ocResult ocResourceLoaderLoadSceneFromOCDInPlace(ocResourceLoader* pLoader, void* pOCDData, ocSizeT ocdDataSize, ocSceneData* pData)
+{
+    if (pData == NULL) {
+        ocFree(pOCDData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pData);
+
+    if (pLoader == NULL || pOCDData == NULL) {
+        ocFree(pOCDData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocUInt64 payloadSize = ocdDataSize;
+    ocResult result = ocDecompressOCDIfNecessary(pLoader->pJobQueue, &pOCDData, &payloadSize);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    return ocLoadScene_OCDPayload((ocUInt8*)pOCDData, payloadSize, pData);
+}
+
 void ocResourceLoaderUnloadScene(ocResourceLoader* pLoader, ocSceneData* pData)
 {
     if (pLoader == NULL || pData == NULL) {
@@ -615,3 +852,384 @@ void ocResourceLoaderUnloadScene(ocResourceLoader* pLoader, ocSceneData* pData)
     ocFree(pData->pPayload);
 }
 
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Conversion
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocResourceType ocGetConvertibleResourceType(const char* filePath)
+{
+    if (filePath == NULL) {
+        return ocResourceType_Unknown;
+    }
+
+    // Only formats supported by stb_image can be converted at the moment.
+    if (ocPathExtensionEqual(filePath, "png") || ocPathExtensionEqual(filePath, "tga") || ocPathExtensionEqual(filePath, "jpg") ||
+        ocPathExtensionEqual(filePath, "jpeg")) {
+        return ocResourceType_Image;
+    }
+
+    if (ocPathExtensionEqual(filePath, "obj")) {
+        return ocResourceType_Scene;
+    }
+
+    return ocResourceType_Unknown;
+}
+
+ocUInt32 ocResourceLoaderGetConverterVersion(ocResourceType type)
+{
+    switch (type)
+    {
+        case ocResourceType_Image: return OC_RESOURCE_CONVERTER_VERSION_IMAGE;
+        case ocResourceType_Scene: return OC_RESOURCE_CONVERTER_VERSION_SCENE;
+        default: return 0;
+    }
+}
+
+ocResult ocConvertToOCD(const char* filePath, const void* pSourceData, ocSizeT sourceDataSize, ocJobQueue* pJobQueue, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    if (ppOCDData == NULL || pOCDDataSize == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppOCDData = NULL;
+    *pOCDDataSize = 0;
+
+    if (filePath == NULL || pSourceData == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocStreamReader reader;
+    ocResult result = ocStreamReaderInit(pSourceData, sourceDataSize, &reader);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocConvertToOCD(filePath, &reader, pJobQueue, ppOCDData, pOCDDataSize);
+
+    ocStreamReaderUninit(&reader);
+    return result;
+}
+
+ocResult ocConvertToOCD(const char* filePath, ocStreamReader* pReader, ocJobQueue* pJobQueue, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    if (ppOCDData == NULL || pOCDDataSize == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    *ppOCDData = NULL;
+    *pOCDDataSize = 0;
+
+    if (filePath == NULL || pReader == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    // .ocd files are already converted.
+    if (ocPathExtensionEqual(filePath, "ocd")) {
+        return OC_INVALID_OPERATION;
+    }
+
+    ocResourceType type = ocGetConvertibleResourceType(filePath);
+    if (type == ocResourceType_Unknown) {
+        return OC_UNSUPPORTED_RESOURCE_TYPE;
+    }
+
+    // The OBJ converter allocates it's output at it's final size so it's returned directly rather than going through a stream writer.
+    if (type == ocResourceType_Scene) {
+        return ocConvertOBJToOCD(pReader, pJobQueue, ppOCDData, pOCDDataSize);
+    }
+
+    // Converted data is written to a chunked writer so it's never moved while it's being written, and is then copied once to a buffer
+    // of the exact size.
+    ocStreamWriter writer;
+    ocResult result = ocStreamWriterInitChunked(0, &writer);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    switch (type)
+    {
+        case ocResourceType_Image:
+        {
+            result = ocConvertToOCD_STB(pReader, &writer);
+        } break;
+
+        default:
+        {
+            result = OC_UNSUPPORTED_RESOURCE_TYPE;
+        } break;
+    }
+
+    if (result == OC_SUCCESS) {
+        result = ocStreamWriterTakeChunkedData(&writer, ppOCDData, pOCDDataSize);  // <-- Needs to be ocFree()'d by the caller.
+    }
+
+    ocStreamWriterUninit(&writer);
+    return result;
+}
+
+ocBool32 ocIsStreamingConverter(ocResourceType type)
+{
+    return type == ocResourceType_Scene;
+}
+
+ocResult ocResourceLoaderConvertToOCD(ocResourceLoader* pLoader, const char* filePath, const void* pSourceData, ocSizeT sourceDataSize, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    if (pLoader == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    return ocConvertToOCD(filePath, pSourceData, sourceDataSize, pLoader->pJobQueue, ppOCDData, pOCDDataSize);
+}
+
+ocResult ocResourceLoaderConvertToOCD(ocResourceLoader* pLoader, const char* filePath, ocStreamReader* pReader, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    if (pLoader == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    return ocConvertToOCD(filePath, pReader, pLoader->pJobQueue, ppOCDData, pOCDDataSize);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Sounds
+//
+///////////////////////////////////////////////////////////////////////////////
+
+ocResult ocResourceLoaderLoadSoundInPlace(ocResourceLoader* pLoader, const char* filePath, void* pFileData, ocSizeT fileDataSize, ocSoundData* pData)
+{
+    if (pData == NULL) {
+        ocFree(pFileData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pData);
+
+    if (pLoader == NULL || filePath == NULL || pFileData == NULL) {
+        ocFree(pFileData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocAudioEncoding encoding = ocAudioEncodingFromPath(filePath);
+
+    // Only the header is parsed here. This is enough to know the length of the sound, which determines whether or not it's streamed.
+    ocAudioDecoder decoder;
+    ocResult result = ocAudioDecoderInit(encoding, pFileData, fileDataSize, &decoder);
+    if (result != OC_SUCCESS) {
+        ocFree(pFileData);
+        return result;
+    }
+
+    ocUInt32 channels   = decoder.channels;
+    ocUInt32 sampleRate = decoder.sampleRate;
+    ocBool32 isStreamed = decoder.frameCount >= (ocUInt64)sampleRate * OC_SOUND_STREAMING_THRESHOLD;
+    ocAudioDecoderUninit(&decoder);
+
+    if (channels > 2) {
+        ocFree(pFileData);
+        return OC_FEATURE_NOT_SUPPORTED;    // <-- The mixer only supports mono and stereo.
+    }
+
+    pData->encoding = encoding;
+    pData->buffer.channels   = channels;
+    pData->buffer.sampleRate = sampleRate;
+
+    if (isStreamed) {
+        pData->pEncodedData    = pFileData;
+        pData->encodedDataSize = fileDataSize;
+        return OC_SUCCESS;
+    }
+
+    float* pFrames;
+    result = ocAudioDecodeAll(encoding, pFileData, fileDataSize, &pFrames, &pData->buffer.frameCount, &pData->buffer.channels, &pData->buffer.sampleRate);
+    ocFree(pFileData);
+
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    if (pData->buffer.frameCount == 0) {
+        ocFree(pFrames);
+        return OC_CORRUPT_FILE;
+    }
+
+    pData->buffer.pFrames = pFrames;
+    return OC_SUCCESS;
+}
+
+void ocResourceLoaderUnloadSound(ocResourceLoader* pLoader, ocSoundData* pData)
+{
+    if (pLoader == NULL || pData == NULL) {
+        return;
+    }
+
+    ocFree((void*)pData->buffer.pFrames);
+    ocFree(pData->pEncodedData);
+    ocZeroObject(pData);
+}
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Skeletons and Animations
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Reads and decompresses the entire content of an .ocd file. Free the returned data with ocFree().
+OC_PRIVATE ocResult ocResourceLoaderReadOCDFile(ocResourceLoader* pLoader, const char* filePath, void** ppOCDData, ocUInt64* pOCDDataSize)
+{
+    ocAssert(pLoader != NULL);
+    ocAssert(filePath != NULL);
+
+    *ppOCDData = NULL;
+    *pOCDDataSize = 0;
+
+    if (!ocPathExtensionEqual(filePath, "ocd")) {
+        return OC_UNSUPPORTED_RESOURCE_TYPE;
+    }
+
+    ocFile file;
+    ocResult result = ocFileOpen(pLoader->pFS, filePath, OC_READ, &file);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocStreamReader reader;
+    result = ocStreamReaderInit(&file, &reader);
+    if (result != OC_SUCCESS) {
+        ocFileClose(&file);
+        return result;
+    }
+
+    result = ocMallocAndReadEntireStreamReader(&reader, ppOCDData, pOCDDataSize);
+
+    ocStreamReaderUninit(&reader);
+    ocFileClose(&file);
+
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    return ocDecompressOCDIfNecessary(pLoader->pJobQueue, ppOCDData, pOCDDataSize);
+}
+
+ocResult ocResourceLoaderLoadSkeleton(ocResourceLoader* pLoader, const char* filePath, ocSkeleton* pSkeleton)
+{
+    if (pSkeleton == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pSkeleton);
+
+    if (pLoader == NULL || filePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    void* pOCDData;
+    ocUInt64 ocdDataSize;
+    ocResult result = ocResourceLoaderReadOCDFile(pLoader, filePath, &pOCDData, &ocdDataSize);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    return ocSkeletonInit(pOCDData, (ocSizeT)ocdDataSize, pSkeleton);
+}
+
+ocResult ocResourceLoaderLoadSkeletonFromOCDInPlace(ocResourceLoader* pLoader, void* pOCDData, ocSizeT ocdDataSize, ocSkeleton* pSkeleton)
+{
+    if (pSkeleton == NULL) {
+        ocFree(pOCDData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pSkeleton);
+
+    if (pLoader == NULL || pOCDData == NULL) {
+        ocFree(pOCDData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocUInt64 payloadSize = ocdDataSize;
+    ocResult result = ocDecompressOCDIfNecessary(pLoader->pJobQueue, &pOCDData, &payloadSize);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    return ocSkeletonInit(pOCDData, (ocSizeT)payloadSize, pSkeleton);
+}
+
+void ocResourceLoaderUnloadSkeleton(ocResourceLoader* pLoader, ocSkeleton* pSkeleton)
+{
+    if (pLoader == NULL || pSkeleton == NULL) {
+        return;
+    }
+
+    ocSkeletonUninit(pSkeleton);
+    ocZeroObject(pSkeleton);
+}
+
+
+ocResult ocResourceLoaderLoadAnimation(ocResourceLoader* pLoader, const char* filePath, ocAnimationClip* pClip)
+{
+    if (pClip == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pClip);
+
+    if (pLoader == NULL || filePath == NULL) {
+        return OC_INVALID_ARGS;
+    }
+
+    void* pOCDData;
+    ocUInt64 ocdDataSize;
+    ocResult result = ocResourceLoaderReadOCDFile(pLoader, filePath, &pOCDData, &ocdDataSize);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    return ocAnimationClipInit(pOCDData, (ocSizeT)ocdDataSize, pClip);
+}
+
+ocResult ocResourceLoaderLoadAnimationFromOCDInPlace(ocResourceLoader* pLoader, void* pOCDData, ocSizeT ocdDataSize, ocAnimationClip* pClip)
+{
+    if (pClip == NULL) {
+        ocFree(pOCDData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocZeroObject(pClip);
+
+    if (pLoader == NULL || pOCDData == NULL) {
+        ocFree(pOCDData);
+        return OC_INVALID_ARGS;
+    }
+
+    ocUInt64 payloadSize = ocdDataSize;
+    ocResult result = ocDecompressOCDIfNecessary(pLoader->pJobQueue, &pOCDData, &payloadSize);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    return ocAnimationClipInit(pOCDData, (ocSizeT)payloadSize, pClip);
+}
+
+void ocResourceLoaderUnloadAnimation(ocResourceLoader* pLoader, ocAnimationClip* pClip)
+{
+    if (pLoader == NULL || pClip == NULL) {
+        return;
+    }
+
+    ocAnimationClipUninit(pClip);
+    ocZeroObject(pClip);
+}
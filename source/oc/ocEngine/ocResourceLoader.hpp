@@ -1,20 +1,30 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+#define OC_RESOURCE_LOADER_READ_BUFFER_SIZE (64*1024)   // The size of the read buffer used for loose files that are decoded in small pieces.
+
 enum ocResourceType
 {
     ocResourceType_Unknown,
     ocResourceType_Image,
     ocResourceType_Material,
-    ocResourceType_Scene
+    ocResourceType_Scene,
+    ocResourceType_Sound,
+    ocResourceType_Skeleton,
+    ocResourceType_Animation,
+
+    ocResourceType_Count    // <-- Not a real type. The number of resource types.
 };
 
 struct ocResourceLoader
 {
     ocFileSystem* pFS;
+    ocJobQueue* pJobQueue;
 };
 
 // Initializes the resource loader.
-ocResult ocResourceLoaderInit(ocFileSystem* pFS, ocResourceLoader* pLoader);
+//
+// pJobQueue is used by converters that can split up their work, and can be NULL.
+ocResult ocResourceLoaderInit(ocFileSystem* pFS, ocJobQueue* pJobQueue, ocResourceLoader* pLoader);
 
 // Uninitializes the resource loader.
 void ocResourceLoaderUninit(ocResourceLoader* pLoader);
@@ -26,6 +36,40 @@ void ocResourceLoaderUninit(ocResourceLoader* pLoader);
 ocResult ocResourceLoaderDetermineResourceType(ocResourceLoader* pLoader, const char* filePath, ocResourceType* pType);
 
 
+// Converter versions. These are part of the key of cooked files in the derived data cache, so the relevant version needs to be
+// incremented whenever a change is made that affects the output of a converter.
+#define OC_RESOURCE_CONVERTER_VERSION_IMAGE     2
+#define OC_RESOURCE_CONVERTER_VERSION_SCENE     3
+
+// Retrieves the version of the converter for the given resource type. Returns 0 if the resource type cannot be converted to OCD.
+ocUInt32 ocResourceLoaderGetConverterVersion(ocResourceType type);
+
+// Retrieves the type of resource a source asset will be converted to based on it's extension. Returns ocResourceType_Unknown if
+// there's no converter for the format.
+ocResourceType ocGetConvertibleResourceType(const char* filePath);
+
+// Converts the data of a source asset such as a .png or .obj file to OCD. The file path is only used to determine the format of
+// the source data. Returns OC_UNSUPPORTED_RESOURCE_TYPE if there's no converter for the format.
+//
+// This does not depend on any engine state and is safe to call from multiple threads at the same time. pJobQueue is used by converters
+// that can split up their work and can be NULL. Pass NULL when calling this from a job that's already running on the queue.
+//
+// Free the returned data with ocFree().
+ocResult ocConvertToOCD(const char* filePath, const void* pSourceData, ocSizeT sourceDataSize, ocJobQueue* pJobQueue, void** ppOCDData, ocSizeT* pOCDDataSize);
+
+// The same as above, except the source data is read from a stream. Converters that work in a single streaming pass, such as the OBJ
+// converter, never hold the entire source asset in memory when given a reader over a file.
+ocResult ocConvertToOCD(const char* filePath, ocStreamReader* pReader, ocJobQueue* pJobQueue, void** ppOCDData, ocSizeT* pOCDDataSize);
+
+// Determines whether or not the converter for the given resource type reads it's source in a single streaming pass, in which case
+// there's nothing to gain by reading the whole file into memory before converting it.
+ocBool32 ocIsStreamingConverter(ocResourceType type);
+
+// Same as ocConvertToOCD(), using the loader's job queue.
+ocResult ocResourceLoaderConvertToOCD(ocResourceLoader* pLoader, const char* filePath, const void* pSourceData, ocSizeT sourceDataSize, void** ppOCDData, ocSizeT* pOCDDataSize);
+ocResult ocResourceLoaderConvertToOCD(ocResourceLoader* pLoader, const char* filePath, ocStreamReader* pReader, void** ppOCDData, ocSizeT* pOCDDataSize);
+
+
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -49,12 +93,39 @@ struct ocImageData
 // Loads an image.
 ocResult ocResourceLoaderLoadImage(ocResourceLoader* pLoader, const char* filePath, ocImageData* pData);
 
+// Loads an image from OCD data that's already in memory. The data is copied so it can be freed after this returns.
+ocResult ocResourceLoaderLoadImageFromOCD(ocResourceLoader* pLoader, const void* pOCDData, ocSizeT ocdDataSize, ocImageData* pData);
+
 // Unloads an image.
 void ocResourceLoaderUnloadImage(ocResourceLoader* pLoader, ocImageData* pData);
 
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// Materials
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Materials are read from Wavefront .mtl libraries. A material is referenced by the path of it's library followed by it's name, the
+// same way files inside an archive are referenced, such as "materials.mtl/wood". This is the path the OBJ converter records for the
+// material of each mesh group. Materials are not converted to OCD since they're tiny.
+struct ocMaterialData
+{
+    float diffuseColor[4];      // <-- From Kd and d. Opaque white if the material doesn't set them.
+    ocString diffuseMapPath;    // <-- From map_Kd, made absolute. NULL if the material doesn't have a diffuse map.
+};
+
+// Loads a material. Returns OC_DOES_NOT_EXIST if the library doesn't define a material with the given name.
+ocResult ocResourceLoaderLoadMaterial(ocResourceLoader* pLoader, const char* filePath, ocMaterialData* pData);
+
+// Unloads a material.
+void ocResourceLoaderUnloadMaterial(ocResourceLoader* pLoader, ocMaterialData* pData);
+
+
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // Scenes
@@ -122,10 +193,87 @@ struct ocSceneData
 
     // Dynamically allocated data as a single allocation. This is the entire raw OCD file data verbatim.
     ocUInt8* pPayload;
+    ocUInt64 payloadSize;
 };
 
 // Loads a scene.
 ocResult ocResourceLoaderLoadScene(ocResourceLoader* pLoader, const char* filePath, ocSceneData* pData);
 
+// Loads a scene from OCD data that's already in memory. The data is copied so it can be freed after this returns.
+ocResult ocResourceLoaderLoadSceneFromOCD(ocResourceLoader* pLoader, const void* pOCDData, ocSizeT ocdDataSize, ocSceneData* pData);
+
+// Same as ocResourceLoaderLoadSceneFromOCD(), except the scene takes ownership of the data instead of copying it. Scenes can be very
+// large so this should be used whenever the data is not needed afterwards.
+//
+// pOCDData must have been allocated with ocMalloc(). It is freed with ocFree() if this fails.
+ocResult ocResourceLoaderLoadSceneFromOCDInPlace(ocResourceLoader* pLoader, void* pOCDData, ocSizeT ocdDataSize, ocSceneData* pData);
+
 // Unloads a scene.
 void ocResourceLoaderUnloadScene(ocResourceLoader* pLoader, ocSceneData* pData);
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Sounds
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Sounds at least this long are streamed rather than decoded up front. In seconds.
+#define OC_SOUND_STREAMING_THRESHOLD    10
+
+// Sounds are not converted to OCD. Short sounds are decoded to f32 when they're loaded so they can be played by any number of voices at no
+// extra cost. Long sounds such as music would take too much memory when decoded so their encoded data is kept instead, and each voice
+// playing one decodes it in the background with an ocAudioStream.
+struct ocSoundData
+{
+    ocAudioBuffer buffer;           // <-- The decoded frames. Only the format is set when the sound is streamed.
+    ocAudioEncoding encoding;
+    void* pEncodedData;             // <-- The file data of a streamed sound, or NULL if the sound has been decoded.
+    ocSizeT encodedDataSize;
+};
+
+// Loads a sound from the data of a .ogg, .flac or .wav file. The file path is only used to determine the format.
+//
+// The sound takes ownership of pFileData, which must have been allocated with ocMalloc(). It's freed with ocFree() if this fails or the
+// sound is decoded.
+ocResult ocResourceLoaderLoadSoundInPlace(ocResourceLoader* pLoader, const char* filePath, void* pFileData, ocSizeT fileDataSize, ocSoundData* pData);
+
+// Unloads a sound.
+void ocResourceLoaderUnloadSound(ocResourceLoader* pLoader, ocSoundData* pData);
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Skeletons and Animations
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Skeletons and animation clips only exist as OCD files. They're mapped in place, so the loaded data is the file data. See ocSkeleton and
+// ocAnimationClip.
+
+// Loads a skeleton.
+ocResult ocResourceLoaderLoadSkeleton(ocResourceLoader* pLoader, const char* filePath, ocSkeleton* pSkeleton);
+
+// Loads a skeleton from OCD data that's already in memory, taking ownership of it.
+//
+// pOCDData must have been allocated with ocMalloc(). It is freed with ocFree() if this fails.
+ocResult ocResourceLoaderLoadSkeletonFromOCDInPlace(ocResourceLoader* pLoader, void* pOCDData, ocSizeT ocdDataSize, ocSkeleton* pSkeleton);
+
+// Unloads a skeleton.
+void ocResourceLoaderUnloadSkeleton(ocResourceLoader* pLoader, ocSkeleton* pSkeleton);
+
+
+// Loads an animation clip.
+ocResult ocResourceLoaderLoadAnimation(ocResourceLoader* pLoader, const char* filePath, ocAnimationClip* pClip);
+
+// Loads an animation clip from OCD data that's already in memory, taking ownership of it.
+//
+// pOCDData must have been allocated with ocMalloc(). It is freed with ocFree() if this fails.
+ocResult ocResourceLoaderLoadAnimationFromOCDInPlace(ocResourceLoader* pLoader, void* pOCDData, ocSizeT ocdDataSize, ocAnimationClip* pClip);
+
+// Unloads an animation clip.
+void ocResourceLoaderUnloadAnimation(ocResourceLoader* pLoader, ocAnimationClip* pClip);
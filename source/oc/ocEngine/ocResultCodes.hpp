@@ -19,9 +19,12 @@ typedef int ocResult;
 #define OC_INVALID_FRAMEBUFFER                  -1026
 #define OC_SHADER_ERROR                         -1027
 #define OC_FAILED_TO_COMPILE_SHADER             -1028
+#define OC_TOO_MANY_IMAGES                      -1029
 
 // Audio
 #define OC_FAILED_TO_INIT_AUDIO                 -2048
+#define OC_TOO_MANY_VOICES                      -2049
+#define OC_TOO_MANY_STREAMS                     -2050
 
 // File System.
 #define OC_DOES_NOT_EXIST                       -3072
@@ -183,19 +183,223 @@ ocResult ocStreamReaderInit(ocStreamReader_OnReadProc onRead, ocStreamReader_OnS
 ocResult ocStreamReaderUninit(ocStreamReader* pReader)
 {
     if (pReader == NULL) return OC_INVALID_ARGS;
+
+    ocFree(pReader->pReadBuffer);
+    pReader->pReadBuffer = NULL;
+    pReader->readBufferSize = 0;
+
     return OC_SUCCESS;
 }
 
+ocResult ocStreamReaderGetDirectData(ocStreamReader* pReader, const void** ppData, ocSizeT* pDataSize)
+{
+    if (ppData != NULL) *ppData = NULL;
+    if (pDataSize != NULL) *pDataSize = 0;
+
+    if (pReader == NULL || ppData == NULL || pDataSize == NULL) return OC_INVALID_ARGS;
+
+    if (pReader->onRead == ocStreamReader_OnRead_Memory) {
+        *ppData    = pReader->memory.pData + pReader->memory.currentPos;
+        *pDataSize = pReader->memory.dataSize - pReader->memory.currentPos;
+        return OC_SUCCESS;
+    }
+
+    if (pReader->onRead == ocStreamReader_OnRead_File) {
+        // Only files in a mounted package have their data in memory. ocFileGetData() fails for everything else.
+        const void* pFileData;
+        ocUInt64 fileSize;
+        if (ocFileGetData(pReader->pFile, &pFileData, &fileSize) == OC_SUCCESS) {
+            ocUInt64 filePos;
+            ocResult result = ocFileTell(pReader->pFile, &filePos);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+
+            *ppData    = (const ocUInt8*)pFileData + filePos;
+            *pDataSize = (ocSizeT)(fileSize - filePos);
+            return OC_SUCCESS;
+        }
+    }
+
+    return OC_FEATURE_NOT_SUPPORTED;
+}
+
+ocResult ocStreamReaderSetBufferSize(ocStreamReader* pReader, ocSizeT bufferSize)
+{
+    if (pReader == NULL) return OC_INVALID_ARGS;
+
+    const void* pDirectData;
+    ocSizeT directDataSize;
+    if (ocStreamReaderGetDirectData(pReader, &pDirectData, &directDataSize) == OC_SUCCESS) {
+        return OC_SUCCESS;  // <-- Not buffered. See the documentation.
+    }
+
+    if (pReader->readBufferSize == bufferSize) {
+        return OC_SUCCESS;
+    }
+
+    // Anything left in the old buffer needs to be given back to the underlying stream by seeking back over it.
+    ocSizeT bytesRemainingInBuffer = pReader->readBufferDataSize - pReader->readBufferPos;
+    if (bytesRemainingInBuffer > 0) {
+        if (pReader->onSeek == NULL) {
+            return OC_INVALID_OPERATION;
+        }
+
+        ocResult result = pReader->onSeek(pReader->pUserData, -(ocInt64)bytesRemainingInBuffer, ocSeekOrigin_Current);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    ocUInt8* pNewBuffer = NULL;
+    if (bufferSize > 0) {
+        pNewBuffer = (ocUInt8*)ocMalloc(bufferSize);
+        if (pNewBuffer == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+    }
+
+    ocFree(pReader->pReadBuffer);
+    pReader->pReadBuffer = pNewBuffer;
+    pReader->readBufferSize = bufferSize;
+    pReader->readBufferPos = 0;
+    pReader->readBufferDataSize = 0;
+
+    return OC_SUCCESS;
+}
+
+// Moves whatever is left in the read buffer to the start and fills the rest from the underlying stream.
+OC_PRIVATE ocResult ocStreamReader_FillBuffer(ocStreamReader* pReader)
+{
+    ocAssert(pReader != NULL);
+    ocAssert(pReader->readBufferSize > 0);
+
+    ocSizeT bytesRemainingInBuffer = pReader->readBufferDataSize - pReader->readBufferPos;
+    if (bytesRemainingInBuffer > 0 && pReader->readBufferPos > 0) {
+        ocMoveMemory(pReader->pReadBuffer, pReader->pReadBuffer + pReader->readBufferPos, bytesRemainingInBuffer);
+    }
+
+    pReader->readBufferPos = 0;
+    pReader->readBufferDataSize = bytesRemainingInBuffer;
+
+    ocSizeT bytesRead = 0;
+    ocResult result = pReader->onRead(pReader->pUserData, pReader->pReadBuffer + bytesRemainingInBuffer, pReader->readBufferSize - bytesRemainingInBuffer, &bytesRead);
+    pReader->readBufferDataSize += bytesRead;
+
+    return result;
+}
 
 ocResult ocStreamReaderRead(ocStreamReader* pReader, void* pDataOut, ocSizeT bytesToRead, ocSizeT* pBytesRead)
 {
+    if (pBytesRead) *pBytesRead = 0;
+
     if (pReader == NULL) return OC_INVALID_ARGS;
 
     if (pReader->onRead == NULL) {
         return OC_FEATURE_NOT_SUPPORTED;
     }
 
-    return pReader->onRead(pReader->pUserData, pDataOut, bytesToRead, pBytesRead);
+    if (pReader->readBufferSize == 0) {
+        return pReader->onRead(pReader->pUserData, pDataOut, bytesToRead, pBytesRead);
+    }
+
+    // Buffered.
+    ocUInt8* pRunningDataOut = (ocUInt8*)pDataOut;
+    ocSizeT totalBytesRead = 0;
+    ocResult result = OC_SUCCESS;
+    while (totalBytesRead < bytesToRead) {
+        ocSizeT bytesRemaining = bytesToRead - totalBytesRead;
+
+        // Whatever's in the buffer is used first.
+        ocSizeT bytesAvailable = pReader->readBufferDataSize - pReader->readBufferPos;
+        if (bytesAvailable > 0) {
+            ocSizeT bytesToCopy = (bytesRemaining < bytesAvailable) ? bytesRemaining : bytesAvailable;
+            ocCopyMemory(pRunningDataOut, pReader->pReadBuffer + pReader->readBufferPos, bytesToCopy);
+            pReader->readBufferPos += bytesToCopy;
+            pRunningDataOut += bytesToCopy;
+            totalBytesRead += bytesToCopy;
+            continue;
+        }
+
+        // The buffer is empty. Large reads go straight to the output buffer.
+        pReader->readBufferPos = 0;
+        pReader->readBufferDataSize = 0;
+
+        if (bytesRemaining >= pReader->readBufferSize) {
+            ocSizeT bytesRead = 0;
+            result = pReader->onRead(pReader->pUserData, pRunningDataOut, bytesRemaining, &bytesRead);
+            totalBytesRead += bytesRead;
+            break;
+        }
+
+        result = ocStreamReader_FillBuffer(pReader);
+        if (pReader->readBufferDataSize == 0) {
+            break;  // <-- At the end or failed.
+        }
+    }
+
+    if (pBytesRead) *pBytesRead = totalBytesRead;
+
+    // Partial reads are successful, the same as they would be without buffering.
+    if (totalBytesRead > 0 && result == OC_AT_END_OF_FILE) {
+        result = OC_SUCCESS;
+    }
+
+    return result;
+}
+
+ocResult ocStreamReaderPeek(ocStreamReader* pReader, ocSizeT bytesToPeek, const void** ppData)
+{
+    if (ppData != NULL) *ppData = NULL;
+
+    if (pReader == NULL || ppData == NULL) return OC_INVALID_ARGS;
+
+    const void* pDirectData;
+    ocSizeT directDataSize;
+    if (ocStreamReaderGetDirectData(pReader, &pDirectData, &directDataSize) == OC_SUCCESS) {
+        if (bytesToPeek > directDataSize) {
+            return OC_AT_END_OF_FILE;
+        }
+
+        *ppData = pDirectData;
+        return OC_SUCCESS;
+    }
+
+    if (bytesToPeek > pReader->readBufferSize) {
+        return OC_INVALID_ARGS;  // <-- Too big for the read buffer, or the reader isn't buffered.
+    }
+
+    if (pReader->readBufferDataSize - pReader->readBufferPos < bytesToPeek) {
+        ocStreamReader_FillBuffer(pReader);
+        if (pReader->readBufferDataSize - pReader->readBufferPos < bytesToPeek) {
+            return OC_AT_END_OF_FILE;
+        }
+    }
+
+    *ppData = pReader->pReadBuffer + pReader->readBufferPos;
+    return OC_SUCCESS;
+}
+
+ocResult ocStreamReaderAcquire(ocStreamReader* pReader, ocSizeT bytesToAcquire, const void** ppData)
+{
+    ocResult result = ocStreamReaderPeek(pReader, bytesToAcquire, ppData);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    if (pReader->readBufferSize > 0) {
+        pReader->readBufferPos += bytesToAcquire;
+        return OC_SUCCESS;
+    }
+
+    // Direct data. The underlying stream needs to be moved forward.
+    result = pReader->onSeek(pReader->pUserData, (ocInt64)bytesToAcquire, ocSeekOrigin_Current);
+    if (result != OC_SUCCESS) {
+        *ppData = NULL;
+        return result;
+    }
+
+    return OC_SUCCESS;
 }
 
 ocResult ocStreamReaderSeek(ocStreamReader* pReader, ocInt64 bytesToSeek, ocSeekOrigin origin)
@@ -206,7 +410,26 @@ ocResult ocStreamReaderSeek(ocStreamReader* pReader, ocInt64 bytesToSeek, ocSeek
         return OC_FEATURE_NOT_SUPPORTED;
     }
 
-    return pReader->onSeek(pReader->pUserData, bytesToSeek, origin);
+    ocSizeT bytesRemainingInBuffer = pReader->readBufferDataSize - pReader->readBufferPos;
+    if (origin == ocSeekOrigin_Current) {
+        // Short seeks that stay inside the buffer don't need to touch the underlying stream.
+        if (bytesToSeek >= -(ocInt64)pReader->readBufferPos && bytesToSeek <= (ocInt64)bytesRemainingInBuffer) {
+            pReader->readBufferPos = (ocSizeT)((ocInt64)pReader->readBufferPos + bytesToSeek);
+            return OC_SUCCESS;
+        }
+
+        // The underlying stream is ahead of the reader by however much is left in the buffer.
+        bytesToSeek -= (ocInt64)bytesRemainingInBuffer;
+    }
+
+    ocResult result = pReader->onSeek(pReader->pUserData, bytesToSeek, origin);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    pReader->readBufferPos = 0;
+    pReader->readBufferDataSize = 0;
+    return OC_SUCCESS;
 }
 
 ocResult ocStreamReaderTell(ocStreamReader* pReader, ocUInt64* pPos)
@@ -217,7 +440,13 @@ ocResult ocStreamReaderTell(ocStreamReader* pReader, ocUInt64* pPos)
         return OC_FEATURE_NOT_SUPPORTED;
     }
 
-    return pReader->onTell(pReader->pUserData, pPos);
+    ocResult result = pReader->onTell(pReader->pUserData, pPos);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    *pPos -= pReader->readBufferDataSize - pReader->readBufferPos;  // <-- The underlying stream is ahead of the reader.
+    return OC_SUCCESS;
 }
 
 ocResult ocStreamReaderSize(ocStreamReader* pReader, ocUInt64* pSize)
@@ -255,6 +484,10 @@ ocBool32 ocStreamReaderAtEnd(ocStreamReader* pReader)
 {
     if (pReader == NULL) return OC_TRUE;
 
+    if (pReader->readBufferPos < pReader->readBufferDataSize) {
+        return OC_FALSE;
+    }
+
     if (pReader->onAtEnd == NULL) {
         return OC_TRUE;
     }
@@ -13,6 +13,13 @@ struct ocStreamReader
     ocStreamReader_OnAtEndProc onAtEnd;
     void* pUserData;
 
+    // Optional read buffer. Reads are served from here, and the buffer is refilled with one large read from onRead when it runs
+    // out. See ocStreamReaderSetBufferSize().
+    ocUInt8* pReadBuffer;
+    ocSizeT readBufferSize;
+    ocSizeT readBufferPos;
+    ocSizeT readBufferDataSize;
+
     union
     {
         ocFile* pFile;
@@ -33,9 +40,30 @@ ocResult ocStreamReaderInit(ocStreamReader_OnReadProc onRead, ocStreamReader_OnS
 //
 ocResult ocStreamReaderUninit(ocStreamReader* pReader);
 
+// Sets the size of the read buffer. Set to 0, which is the default, to disable buffering.
+//
+// Buffering is most useful for readers that have a high per-call cost, such as file readers, when there are lots of small reads.
+// Reads that are at least as large as the buffer bypass it. Readers that already have direct access to their data, which are
+// memory readers and files served from a mounted package, are never buffered because there's nothing to gain.
+ocResult ocStreamReaderSetBufferSize(ocStreamReader* pReader, ocSizeT bufferSize);
+
 //
 ocResult ocStreamReaderRead(ocStreamReader* pReader, void* pDataOut, ocSizeT bytesToRead, ocSizeT* pBytesRead);
 
+// Retrieves a pointer to the next bytesToPeek bytes without moving the read position.
+//
+// For readers with direct access to their data this points straight into the source data and no copy is made. Otherwise the
+// data is loaded into the read buffer which means bytesToPeek cannot be larger than the buffer size. Returns OC_AT_END_OF_FILE if
+// there are fewer than bytesToPeek bytes remaining. The pointer is valid until the next operation on the reader.
+ocResult ocStreamReaderPeek(ocStreamReader* pReader, ocSizeT bytesToPeek, const void** ppData);
+
+// The same as ocStreamReaderPeek(), except the read position is moved past the returned data.
+ocResult ocStreamReaderAcquire(ocStreamReader* pReader, ocSizeT bytesToAcquire, const void** ppData);
+
+// Retrieves a pointer to all of the remaining data for readers with direct access to their data. Returns OC_FEATURE_NOT_SUPPORTED
+// for other readers. The read position is not moved.
+ocResult ocStreamReaderGetDirectData(ocStreamReader* pReader, const void** ppData, ocSizeT* pDataSize);
+
 //
 ocResult ocStreamReaderSeek(ocStreamReader* pReader, ocInt64 bytesToSeek, ocSeekOrigin origin);
 
@@ -74,7 +74,7 @@ OC_PRIVATE ocResult ocStreamWriter_OnWrite_Memory(void* pUserData, const void* p
     pWriter->memory.currentPos += bytesToWrite;
 
     if (pWriter->memory.dataSize  < pWriter->memory.currentPos) {
-        pWriter->memory.dataSize += pWriter->memory.currentPos;
+        pWriter->memory.dataSize = pWriter->memory.currentPos;
     }
     
     if (pBytesWritten) *pBytesWritten = bytesToWrite;
@@ -86,27 +86,27 @@ OC_PRIVATE ocResult ocStreamWriter_OnWrite_Memory(void* pUserData, const void* p
     return OC_SUCCESS;
 }
 
-OC_PRIVATE ocResult ocStreamWriter_OnSeek_Memory(void* pUserData, ocInt64 bytesToSeek, ocSeekOrigin origin)
+// Seeking is the same for the memory and chunked writers.
+OC_PRIVATE ocResult ocStreamWriter_SeekInMemory(ocSizeT* pCurrentPos, ocSizeT dataSize, ocInt64 bytesToSeek, ocSeekOrigin origin)
 {
-    ocStreamWriter* pWriter = (ocStreamWriter*)pUserData;
-    ocAssert(pWriter != NULL);
+    ocAssert(pCurrentPos != NULL);
 
     switch (origin)
     {
         case ocSeekOrigin_Current:
         {
             if (bytesToSeek > 0) {
-                if (pWriter->memory.currentPos + bytesToSeek > pWriter->memory.dataSize) {
+                if (*pCurrentPos + bytesToSeek > dataSize) {
                     return OC_INVALID_ARGS;  // Seeking too far forward.
                 }
 
-                pWriter->memory.currentPos += (ocSizeT)bytesToSeek;
+                *pCurrentPos += (ocSizeT)bytesToSeek;
             } else {
-                if (pWriter->memory.currentPos + bytesToSeek < 0) {
+                if ((ocInt64)*pCurrentPos + bytesToSeek < 0) {
                     return OC_INVALID_ARGS;  // Seeking too far backwards.
                 }
 
-                pWriter->memory.currentPos -= (ocSizeT)(-bytesToSeek);
+                *pCurrentPos -= (ocSizeT)(-bytesToSeek);
             }
         } break;
 
@@ -115,11 +115,11 @@ OC_PRIVATE ocResult ocStreamWriter_OnSeek_Memory(void* pUserData, ocInt64 bytesT
             if (bytesToSeek < 0) {
                 return OC_INVALID_ARGS;  // Does not make sense to use a negative seek when seeking from the start.
             }
-            if (bytesToSeek > (ocInt64)pWriter->memory.dataSize) {
+            if (bytesToSeek > (ocInt64)dataSize) {
                 return OC_INVALID_ARGS;  // Seeking too far.
             }
 
-            pWriter->memory.currentPos = (ocSizeT)bytesToSeek;
+            *pCurrentPos = (ocSizeT)bytesToSeek;
         } break;
 
         case ocSeekOrigin_End:
@@ -129,17 +129,25 @@ OC_PRIVATE ocResult ocStreamWriter_OnSeek_Memory(void* pUserData, ocInt64 bytesT
                 bytesToSeek = -bytesToSeek;
             }
 
-            if (bytesToSeek > (ocInt64)pWriter->memory.dataSize) {
+            if (bytesToSeek > (ocInt64)dataSize) {
                 return OC_INVALID_ARGS;  // Seeking too far.
             }
 
-            pWriter->memory.currentPos = pWriter->memory.dataSize - (ocSizeT)bytesToSeek;
+            *pCurrentPos = dataSize - (ocSizeT)bytesToSeek;
         } break;
     }
 
     return OC_SUCCESS;
 }
 
+OC_PRIVATE ocResult ocStreamWriter_OnSeek_Memory(void* pUserData, ocInt64 bytesToSeek, ocSeekOrigin origin)
+{
+    ocStreamWriter* pWriter = (ocStreamWriter*)pUserData;
+    ocAssert(pWriter != NULL);
+
+    return ocStreamWriter_SeekInMemory(&pWriter->memory.currentPos, pWriter->memory.dataSize, bytesToSeek, origin);
+}
+
 OC_PRIVATE ocResult ocStreamWriter_OnTell_Memory(void* pUserData, ocUInt64* pPos)
 {
     ocStreamWriter* pWriter = (ocStreamWriter*)pUserData;
@@ -177,6 +185,128 @@ ocResult ocStreamWriterInit(void** ppData, size_t* pDataSize, ocStreamWriter* pW
 }
 
 
+OC_PRIVATE ocResult ocStreamWriter_OnWrite_Chunked(void* pUserData, const void* pData, ocSizeT bytesToWrite, ocSizeT* pBytesWritten)
+{
+    ocStreamWriter* pWriter = (ocStreamWriter*)pUserData;
+    ocAssert(pWriter != NULL);
+
+    if (pBytesWritten) *pBytesWritten = 0;
+
+    ocSizeT chunkSize = pWriter->chunked.chunkSize;
+
+    // Allocate any new chunks we need. Only the list of chunk pointers is ever reallocated. The chunks themselves never move.
+    ocSizeT requiredChunkCount = (pWriter->chunked.currentPos + bytesToWrite + chunkSize-1) / chunkSize;
+    if (requiredChunkCount > pWriter->chunked.chunkCapacity) {
+        ocSizeT newChunkCapacity = (pWriter->chunked.chunkCapacity == 0) ? 16 : pWriter->chunked.chunkCapacity*2;
+        if (newChunkCapacity < requiredChunkCount) {
+            newChunkCapacity = requiredChunkCount;
+        }
+
+        ocUInt8** ppNewChunks = (ocUInt8**)ocRealloc(pWriter->chunked.ppChunks, sizeof(*ppNewChunks) * newChunkCapacity);
+        if (ppNewChunks == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+
+        pWriter->chunked.ppChunks = ppNewChunks;
+        pWriter->chunked.chunkCapacity = newChunkCapacity;
+    }
+
+    while (pWriter->chunked.chunkCount < requiredChunkCount) {
+        ocUInt8* pChunk = (ocUInt8*)ocMalloc(chunkSize);
+        if (pChunk == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+
+        pWriter->chunked.ppChunks[pWriter->chunked.chunkCount] = pChunk;
+        pWriter->chunked.chunkCount += 1;
+    }
+
+    // A single write can span multiple chunks.
+    const ocUInt8* pRunningData = (const ocUInt8*)pData;
+    ocSizeT bytesRemaining = bytesToWrite;
+    while (bytesRemaining > 0) {
+        ocSizeT iChunk = pWriter->chunked.currentPos / chunkSize;
+        ocSizeT chunkOffset = pWriter->chunked.currentPos % chunkSize;
+
+        ocSizeT bytesToCopy = chunkSize - chunkOffset;
+        if (bytesToCopy > bytesRemaining) {
+            bytesToCopy = bytesRemaining;
+        }
+
+        ocCopyMemory(pWriter->chunked.ppChunks[iChunk] + chunkOffset, pRunningData, bytesToCopy);
+        pWriter->chunked.currentPos += bytesToCopy;
+        pRunningData += bytesToCopy;
+        bytesRemaining -= bytesToCopy;
+    }
+
+    if (pWriter->chunked.dataSize < pWriter->chunked.currentPos) {
+        pWriter->chunked.dataSize = pWriter->chunked.currentPos;
+    }
+
+    if (pBytesWritten) *pBytesWritten = bytesToWrite;
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocStreamWriter_OnSeek_Chunked(void* pUserData, ocInt64 bytesToSeek, ocSeekOrigin origin)
+{
+    ocStreamWriter* pWriter = (ocStreamWriter*)pUserData;
+    ocAssert(pWriter != NULL);
+
+    return ocStreamWriter_SeekInMemory(&pWriter->chunked.currentPos, pWriter->chunked.dataSize, bytesToSeek, origin);
+}
+
+OC_PRIVATE ocResult ocStreamWriter_OnTell_Chunked(void* pUserData, ocUInt64* pPos)
+{
+    ocStreamWriter* pWriter = (ocStreamWriter*)pUserData;
+    ocAssert(pWriter != NULL);
+
+    *pPos = pWriter->chunked.currentPos;
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocStreamWriter_OnSize_Chunked(void* pUserData, ocUInt64* pSize)
+{
+    ocStreamWriter* pWriter = (ocStreamWriter*)pUserData;
+    ocAssert(pWriter != NULL);
+
+    *pSize = pWriter->chunked.dataSize;
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocStreamWriter_FreeChunks(ocStreamWriter* pWriter)
+{
+    ocAssert(pWriter != NULL);
+    ocAssert(pWriter->onWrite == ocStreamWriter_OnWrite_Chunked);
+
+    for (ocSizeT iChunk = 0; iChunk < pWriter->chunked.chunkCount; ++iChunk) {
+        ocFree(pWriter->chunked.ppChunks[iChunk]);
+    }
+
+    ocFree(pWriter->chunked.ppChunks);
+    pWriter->chunked.ppChunks = NULL;
+    pWriter->chunked.chunkCount = 0;
+    pWriter->chunked.chunkCapacity = 0;
+    pWriter->chunked.dataSize = 0;
+    pWriter->chunked.currentPos = 0;
+}
+
+ocResult ocStreamWriterInitChunked(ocSizeT chunkSize, ocStreamWriter* pWriter)
+{
+    ocResult result = ocStreamWriterInit(ocStreamWriter_OnWrite_Chunked, ocStreamWriter_OnSeek_Chunked, ocStreamWriter_OnTell_Chunked, ocStreamWriter_OnSize_Chunked, (void*)pWriter, pWriter);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    if (chunkSize == 0) {
+        chunkSize = OC_STREAM_WRITER_DEFAULT_CHUNK_SIZE;
+    }
+
+    pWriter->chunked.chunkSize = chunkSize;
+
+    return OC_SUCCESS;
+}
+
+
 ocResult ocStreamWriterInit(ocStreamWriter_OnWriteProc onWrite, ocStreamWriter_OnSeekProc onSeek, ocStreamWriter_OnTellProc onTell, ocStreamWriter_OnSizeProc onSize, void* pUserData, ocStreamWriter* pWriter)
 {
     if (pWriter == NULL || onWrite == NULL || onSeek == NULL || onTell == NULL || onSize == NULL) return OC_INVALID_ARGS;
@@ -194,6 +324,66 @@ ocResult ocStreamWriterInit(ocStreamWriter_OnWriteProc onWrite, ocStreamWriter_O
 ocResult ocStreamWriterUninit(ocStreamWriter* pWriter)
 {
     if (pWriter == NULL) return OC_INVALID_ARGS;
+
+    ocResult result = ocStreamWriterFlush(pWriter);
+
+    ocFree(pWriter->pWriteBuffer);
+    pWriter->pWriteBuffer = NULL;
+    pWriter->writeBufferSize = 0;
+    pWriter->writeBufferPos = 0;
+
+    if (pWriter->onWrite == ocStreamWriter_OnWrite_Chunked) {
+        ocStreamWriter_FreeChunks(pWriter);
+    }
+
+    return result;
+}
+
+ocResult ocStreamWriterSetBufferSize(ocStreamWriter* pWriter, ocSizeT bufferSize)
+{
+    if (pWriter == NULL) return OC_INVALID_ARGS;
+
+    ocResult result = ocStreamWriterFlush(pWriter);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    if (pWriter->writeBufferSize == bufferSize) {
+        return OC_SUCCESS;
+    }
+
+    ocUInt8* pNewBuffer = NULL;
+    if (bufferSize > 0) {
+        pNewBuffer = (ocUInt8*)ocMalloc(bufferSize);
+        if (pNewBuffer == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+    }
+
+    ocFree(pWriter->pWriteBuffer);
+    pWriter->pWriteBuffer = pNewBuffer;
+    pWriter->writeBufferSize = bufferSize;
+    pWriter->writeBufferPos = 0;
+
+    return OC_SUCCESS;
+}
+
+ocResult ocStreamWriterFlush(ocStreamWriter* pWriter)
+{
+    if (pWriter == NULL) return OC_INVALID_ARGS;
+
+    if (pWriter->writeBufferPos == 0) {
+        return OC_SUCCESS;
+    }
+
+    // The buffered data is kept if the write fails.
+    ocAssert(pWriter->onWrite != NULL);
+    ocResult result = pWriter->onWrite(pWriter->pUserData, pWriter->pWriteBuffer, pWriter->writeBufferPos, NULL);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    pWriter->writeBufferPos = 0;
     return OC_SUCCESS;
 }
 
@@ -202,6 +392,27 @@ ocResult ocStreamWriterWrite(ocStreamWriter* pWriter, const void* pData, ocSizeT
     if (pWriter == NULL || pData == NULL) return OC_INVALID_ARGS;
 
     ocAssert(pWriter->onWrite != NULL);
+
+    if (pWriter->writeBufferSize > 0) {
+        if (bytesToWrite > pWriter->writeBufferSize - pWriter->writeBufferPos) {
+            if (pBytesWritten) *pBytesWritten = 0;
+
+            ocResult result = ocStreamWriterFlush(pWriter);
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+        }
+
+        // Writes that are at least as big as the buffer go straight through. Everything else is buffered.
+        if (bytesToWrite < pWriter->writeBufferSize) {
+            ocCopyMemory(pWriter->pWriteBuffer + pWriter->writeBufferPos, pData, bytesToWrite);
+            pWriter->writeBufferPos += bytesToWrite;
+
+            if (pBytesWritten) *pBytesWritten = bytesToWrite;
+            return OC_SUCCESS;
+        }
+    }
+
     return pWriter->onWrite(pWriter->pUserData, pData, bytesToWrite, pBytesWritten);
 }
 
@@ -214,17 +425,121 @@ ocResult ocStreamWriterWriteString(ocStreamWriter* pWriter, const char* str)
 ocResult ocStreamWriterSeek(ocStreamWriter* pWriter, ocInt64 bytesToSeek, ocSeekOrigin origin)
 {
     if (pWriter == NULL || pWriter->onSeek == NULL) return OC_INVALID_ARGS;
+
+    ocResult result = ocStreamWriterFlush(pWriter);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
     return pWriter->onSeek(pWriter->pUserData, bytesToSeek, origin);
 }
 
 ocResult ocStreamWriterTell(ocStreamWriter* pWriter, ocUInt64* pPos)
 {
     if (pWriter == NULL || pWriter->onTell == NULL || pPos == NULL) return OC_INVALID_ARGS;
-    return pWriter->onTell(pWriter->pUserData, pPos);
+
+    ocResult result = pWriter->onTell(pWriter->pUserData, pPos);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    *pPos += pWriter->writeBufferPos;   // <-- Buffered data has not been passed to the underlying stream yet.
+    return OC_SUCCESS;
 }
 
 ocResult ocStreamWriterSize(ocStreamWriter* pWriter, ocUInt64* pSize)
 {
     if (pWriter == NULL || pWriter->onSize == NULL || pSize == NULL) return OC_INVALID_ARGS;
+
+    ocResult result = ocStreamWriterFlush(pWriter);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
     return pWriter->onSize(pWriter->pUserData, pSize);
 }
+
+
+ocResult ocStreamWriterTakeChunkedData(ocStreamWriter* pWriter, void** ppData, ocSizeT* pDataSize)
+{
+    if (ppData != NULL) *ppData = NULL;
+    if (pDataSize != NULL) *pDataSize = 0;
+
+    if (pWriter == NULL || ppData == NULL || pDataSize == NULL || pWriter->onWrite != ocStreamWriter_OnWrite_Chunked) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocResult result = ocStreamWriterFlush(pWriter);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocSizeT dataSize = pWriter->chunked.dataSize;
+    if (dataSize == 0) {
+        ocStreamWriter_FreeChunks(pWriter);
+        return OC_SUCCESS;
+    }
+
+    void* pData;
+    if (dataSize <= pWriter->chunked.chunkSize) {
+        // Everything is in the first chunk so it can be returned as-is, without a copy.
+        pData = ocRealloc(pWriter->chunked.ppChunks[0], dataSize);
+        if (pData == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+
+        pWriter->chunked.ppChunks[0] = NULL;
+    } else {
+        pData = ocMalloc(dataSize);
+        if (pData == NULL) {
+            return OC_OUT_OF_MEMORY;
+        }
+
+        for (ocSizeT iChunk = 0; iChunk < pWriter->chunked.chunkCount; ++iChunk) {
+            ocSizeT chunkOffset = iChunk * pWriter->chunked.chunkSize;
+            ocSizeT chunkDataSize = dataSize - chunkOffset;
+            if (chunkDataSize > pWriter->chunked.chunkSize) {
+                chunkDataSize = pWriter->chunked.chunkSize;
+            }
+
+            ocCopyMemory((ocUInt8*)pData + chunkOffset, pWriter->chunked.ppChunks[iChunk], chunkDataSize);
+        }
+    }
+
+    ocStreamWriter_FreeChunks(pWriter);
+
+    *ppData = pData;
+    *pDataSize = dataSize;
+    return OC_SUCCESS;
+}
+
+ocResult ocStreamWriterWriteChunkedData(ocStreamWriter* pWriter, ocStreamWriter* pOtherWriter)
+{
+    if (pWriter == NULL || pOtherWriter == NULL || pWriter->onWrite != ocStreamWriter_OnWrite_Chunked) {
+        return OC_INVALID_ARGS;
+    }
+
+    ocResult result = ocStreamWriterFlush(pWriter);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (ocSizeT iChunk = 0; iChunk < pWriter->chunked.chunkCount; ++iChunk) {
+        ocSizeT chunkOffset = iChunk * pWriter->chunked.chunkSize;
+        if (chunkOffset >= pWriter->chunked.dataSize) {
+            break;  // <-- Chunks past the end can exist if the writer was seeked backwards.
+        }
+
+        ocSizeT chunkDataSize = pWriter->chunked.dataSize - chunkOffset;
+        if (chunkDataSize > pWriter->chunked.chunkSize) {
+            chunkDataSize = pWriter->chunked.chunkSize;
+        }
+
+        result = ocStreamWriterWrite(pOtherWriter, pWriter->chunked.ppChunks[iChunk], chunkDataSize, NULL);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    return OC_SUCCESS;
+}
\ No newline at end of file
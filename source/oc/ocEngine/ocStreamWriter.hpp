@@ -1,5 +1,7 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+#define OC_STREAM_WRITER_DEFAULT_CHUNK_SIZE (1024*1024)
+
 typedef ocResult (* ocStreamWriter_OnWriteProc) (void* pUserData, const void* pData, ocSizeT bytesToWrite, ocSizeT* pBytesWritten);
 typedef ocResult (* ocStreamWriter_OnSeekProc)  (void* pUserData, ocInt64 bytesToSeek, ocSeekOrigin origin);
 typedef ocResult (* ocStreamWriter_OnTellProc)  (void* pUserData, ocUInt64* pPos);
@@ -13,6 +15,12 @@ struct ocStreamWriter
     ocStreamWriter_OnSizeProc  onSize;
     void* pUserData;
 
+    // Optional write buffer. Small writes are copied here and passed to onWrite in one go when the buffer fills up or the writer is
+    // flushed. See ocStreamWriterSetBufferSize().
+    ocUInt8* pWriteBuffer;
+    ocSizeT writeBufferSize;
+    ocSizeT writeBufferPos;
+
     union
     {
         ocFile* pFile;
@@ -26,6 +34,15 @@ struct ocStreamWriter
             ocSizeT dataSize;
             ocSizeT currentPos;
         } memory;
+        struct
+        {
+            ocUInt8** ppChunks;
+            ocSizeT chunkCount;
+            ocSizeT chunkCapacity;  // <-- The capacity of ppChunks, not the size of each chunk.
+            ocSizeT chunkSize;
+            ocSizeT dataSize;
+            ocSizeT currentPos;
+        } chunked;
     };
 };
 
@@ -38,18 +55,43 @@ ocResult ocStreamWriterInit(ocFile* pFile, ocStreamWriter* pWriter);
 // the writer will _not_ free the data.
 ocResult ocStreamWriterInit(void** ppData, size_t* pDataSize, ocStreamWriter* pWriter);
 
+// Initializes a writer that outputs data to a list of fixed size chunks which are allocated as they're needed.
 //
-ocResult ocStreamWriterInit(ocStreamWriter_OnWriteProc onWrite, ocStreamWriter_OnSeekProc onSeek, ocStreamWriter_OnTellProc onTell, ocStreamWriter_OnSizeProc onSize, void* pUserData, ocStreamWriter* pWriter);
+// Unlike the memory writer above, data is never moved once it's been written which makes this the better choice for large outputs.
+// The downside is that the data is not contiguous. Use ocStreamWriterTakeChunkedData() to retrieve it as a single buffer, or
+// ocStreamWriterWriteChunkedData() to pass it on to another writer. The chunks are owned by the writer and are freed when it's
+// uninitialized. Pass 0 for chunkSize to use the default of OC_STREAM_WRITER_DEFAULT_CHUNK_SIZE.
+ocResult ocStreamWriterInitChunked(ocSizeT chunkSize, ocStreamWriter* pWriter);
 
 //
+ocResult ocStreamWriterInit(ocStreamWriter_OnWriteProc onWrite, ocStreamWriter_OnSeekProc onSeek, ocStreamWriter_OnTellProc onTell, ocStreamWriter_OnSizeProc onSize, void* pUserData, ocStreamWriter* pWriter);
+
+// Uninitializes the writer. Any buffered data is flushed first.
 ocResult ocStreamWriterUninit(ocStreamWriter* pWriter);
 
+// Sets the size of the write buffer. Set to 0, which is the default, to disable buffering.
+//
+// Buffering is most useful for writers that have a high per-call cost, such as file writers, when there are lots of small writes.
+// Writes that are at least as large as the buffer bypass it. Anything already in the buffer is flushed before it's resized. Note
+// that with the memory writer the output variables are not updated until the buffer is flushed.
+ocResult ocStreamWriterSetBufferSize(ocStreamWriter* pWriter, ocSizeT bufferSize);
+
+// Passes any buffered data on to the underlying stream.
+ocResult ocStreamWriterFlush(ocStreamWriter* pWriter);
+
 //
 ocResult ocStreamWriterWrite(ocStreamWriter* pWriter, const void* pData, ocSizeT bytesToWrite, ocSizeT* pBytesWritten);
 ocResult ocStreamWriterWriteString(ocStreamWriter* pWriter, const char* str);
 
 template <typename T> ocResult ocStreamWriterWrite(ocStreamWriter* pWriter, T value)
 {
+    // Fast path. If the value fits in the write buffer just copy it straight in.
+    if (pWriter != NULL && pWriter->writeBufferSize - pWriter->writeBufferPos >= sizeof(value)) {
+        ocCopyMemory(pWriter->pWriteBuffer + pWriter->writeBufferPos, &value, sizeof(value));
+        pWriter->writeBufferPos += sizeof(value);
+        return OC_SUCCESS;
+    }
+
     return ocStreamWriterWrite(pWriter, &value, sizeof(value), NULL);
 }
 
@@ -60,4 +102,13 @@ ocResult ocStreamWriterSeek(ocStreamWriter* pWriter, ocInt64 bytesToSeek, ocSeek
 ocResult ocStreamWriterTell(ocStreamWriter* pWriter, ocUInt64* pPos);
 
 //
-ocResult ocStreamWriterSize(ocStreamWriter* pWriter, ocUInt64* pSize);
\ No newline at end of file
+ocResult ocStreamWriterSize(ocStreamWriter* pWriter, ocUInt64* pSize);
+
+
+// Allocates a single buffer containing everything written to a chunked writer and returns it. The writer is left empty.
+//
+// When the data fits in a single chunk the chunk itself is returned rather than copied. Free the returned data with ocFree().
+ocResult ocStreamWriterTakeChunkedData(ocStreamWriter* pWriter, void** ppData, ocSizeT* pDataSize);
+
+// Writes everything written to a chunked writer to another writer.
+ocResult ocStreamWriterWriteChunkedData(ocStreamWriter* pWriter, ocStreamWriter* pOtherWriter);
\ No newline at end of file
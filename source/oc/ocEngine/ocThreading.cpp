@@ -79,6 +79,19 @@ bool ocSemaphoreRelease__Win32(ocSemaphore* pSemaphore)
 {
     return ReleaseSemaphore(*pSemaphore, 1, NULL) != 0;
 }
+
+
+ocUInt32 ocGetLogicalProcessorCount__Win32()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (ocUInt32)info.dwNumberOfProcessors;
+}
+
+void ocYieldThread__Win32()
+{
+    SwitchToThread();
+}
 #endif  // Win32
 
 
@@ -139,6 +152,22 @@ bool ocSemaphoreRelease__Posix(ocSemaphore* pSemaphore)
 {
     return sem_post(pSemaphore) != -1;
 }
+
+
+ocUInt32 ocGetLogicalProcessorCount__Posix()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1) {
+        return 1;
+    }
+
+    return (ocUInt32)count;
+}
+
+void ocYieldThread__Posix()
+{
+    sched_yield();
+}
 #endif  // Posix
 
 
@@ -274,3 +303,35 @@ bool ocSemaphoreRelease(ocSemaphore* pSemaphore)
     return ocSemaphoreRelease__Posix(pSemaphore);
 #endif
 }
+
+
+
+//// Misc ////
+
+ocUInt32 ocGetLogicalProcessorCount()
+{
+    ocUInt32 count = 1;
+
+#ifdef OC_THREADING_WIN32
+    count = ocGetLogicalProcessorCount__Win32();
+#endif
+#ifdef OC_THREADING_POSIX
+    count = ocGetLogicalProcessorCount__Posix();
+#endif
+
+    if (count == 0) {
+        count = 1;
+    }
+
+    return count;
+}
+
+void ocYieldThread()
+{
+#ifdef OC_THREADING_WIN32
+    ocYieldThread__Win32();
+#endif
+#ifdef OC_THREADING_POSIX
+    ocYieldThread__Posix();
+#endif
+}
\ No newline at end of file
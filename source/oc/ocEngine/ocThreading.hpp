@@ -58,4 +58,13 @@ void ocSemaphoreUninit(ocSemaphore* pSemaphore);
 bool ocSemaphoreWait(ocSemaphore* pSemaphore);
 
 // Releases the given semaphore and increments it's counter by one upon returning.
-bool ocSemaphoreRelease(ocSemaphore* pSemaphore);
\ No newline at end of file
+bool ocSemaphoreRelease(ocSemaphore* pSemaphore);
+
+
+//// Misc ////
+
+// Retrieves the number of logical processors on the system. This will always return at least 1.
+ocUInt32 ocGetLogicalProcessorCount();
+
+// Gives up the remainder of the calling thread's time slice.
+void ocYieldThread();
\ No newline at end of file
@@ -29,7 +29,7 @@ ocResult ocWorldInit(ocEngineContext* pEngine, ocWorld* pWorld)
     }
 
     // Physics.
-    result = ocDynamicsWorldInit(&pWorld->dynamicsWorld);
+    result = ocDynamicsWorldInit(&pEngine->jobQueue, &pWorld->dynamicsWorld);
     if (result != OC_SUCCESS) {
         ocAudioWorldUninit(&pWorld->audioWorld);
         ocGraphicsWorldUninit(&pWorld->graphicsWorld);
@@ -70,6 +70,32 @@ void ocWorldDeleteRT(ocWorld* pWorld, ocGraphicsRT* pRT)
 }
 
 
+OC_PRIVATE void ocWorldSetObjectAbsoluteTransformFromComponent(ocWorld* pWorld, ocWorldObject* pObject, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation, const glm::vec3 &absoluteScale, ocComponent* pSourceComponent);
+
+// Moves every object with an awake body to where the body ended up. This walks the body arrays directly rather than going through each
+// object's components, and doesn't push the transform back to the body it came from. Static and sleeping bodies never move on their own,
+// and awake bodies are always at the front of the arrays, so resting objects cost nothing here. Bodies that were added to the dynamics world
+// directly rather than through a component have no user data and are skipped.
+OC_PRIVATE void ocWorldSyncDynamicsBodies(ocWorld* pWorld)
+{
+    ocAssert(pWorld != NULL);
+
+    ocDynamicsWorld* pDynamicsWorld = &pWorld->dynamicsWorld;
+    for (ocUInt32 iBody = 0; iBody < pDynamicsWorld->awakeBodyCount; ++iBody) {
+        ocDynamicsBodyComponent* pComponent = (ocDynamicsBodyComponent*)pDynamicsWorld->pDescs[iBody].pUserData;
+        if (pComponent == NULL) {
+            continue;
+        }
+
+        ocWorldObject* pObject = pComponent->pObject;
+
+        ocWorldSetObjectAbsoluteTransformFromComponent(pWorld, pObject,
+            glm::vec3(pDynamicsWorld->pPositionX[iBody], pDynamicsWorld->pPositionY[iBody], pDynamicsWorld->pPositionZ[iBody]),
+            glm::quat(pDynamicsWorld->pRotationW[iBody], pDynamicsWorld->pRotationX[iBody], pDynamicsWorld->pRotationY[iBody], pDynamicsWorld->pRotationZ[iBody]),
+            glm::vec3(pObject->absoluteScale), pComponent);
+    }
+}
+
 void ocWorldStep(ocWorld* pWorld, double dt)
 {
     if (pWorld == NULL) {
@@ -77,7 +103,22 @@ void ocWorldStep(ocWorld* pWorld, double dt)
     }
     
     ocDynamicsWorldStep(&pWorld->dynamicsWorld, dt);
+    ocWorldSyncDynamicsBodies(pWorld);
     ocGraphicsWorldStep(&pWorld->graphicsWorld, dt);
+
+    if (pWorld->pActiveCamera != NULL) {
+        ocAudioWorldSetListener(&pWorld->audioWorld, glm::vec3(pWorld->pActiveCamera->position), pWorld->pActiveCamera->rotation);
+    }
+    ocAudioWorldStep(&pWorld->audioWorld, dt);
+}
+
+void ocWorldSetActiveCamera(ocWorld* pWorld, ocCamera* pCamera)
+{
+    if (pWorld == NULL) {
+        return;
+    }
+
+    pWorld->pActiveCamera = pCamera;
 }
 
 void ocWorldDraw(ocWorld* pWorld)
@@ -108,10 +149,179 @@ OC_PRIVATE ocBool32 ocWorld_DoesSceneResourceHaveSingleParent(ocResource* pScene
     return OC_TRUE;
 }
 
-OC_PRIVATE ocResult ocWorldCreateObjectFromResource_Scene(ocWorld* pWorld, ocResource* pSceneResource, ocResourceLibrary* pResourceLibrary, ocWorldObject** ppObject)
+// A subresource that's been loaded for a scene that's being instantiated. Subresources are shared between every scene that references
+// them, including nested scenes.
+struct ocWorldSceneSubresource
+{
+    const char* path;       // <-- Points into the payload of the first scene that referenced it.
+    ocResource* pResource;  // <-- NULL if it failed to load.
+};
+
+// Retrieves the path of a subresource of a scene. Returns NULL if the subresource does not exist or is stored inside the scene itself.
+OC_PRIVATE const char* ocWorldGetSceneSubresourcePath(ocResource* pSceneResource, ocUInt32 subresourceIndex)
+{
+    ocAssert(pSceneResource != NULL);
+
+    if (subresourceIndex >= pSceneResource->scene.subresourceCount) {
+        return NULL;
+    }
+
+    ocSceneSubresource* pSubresource = &pSceneResource->scene.pSubresources[subresourceIndex];
+    if ((pSubresource->flags & OC_OCD_SCENE_SUBRESOURCE_FLAG_IS_INTERNAL) != 0) {
+        return NULL;
+    }
+
+    return (const char*)pSceneResource->scene.pPayload + pSubresource->pathOffset;
+}
+
+OC_PRIVATE ocWorldSceneSubresource* ocWorldFindSceneSubresource(ocStack<ocWorldSceneSubresource>* pSubresources, const char* path)
+{
+    ocAssert(pSubresources != NULL);
+    ocAssert(path != NULL);
+
+    for (ocSizeT iSubresource = 0; iSubresource < pSubresources->count; ++iSubresource) {
+        if (strcmp(pSubresources->pItems[iSubresource].path, path) == 0) {
+            return &pSubresources->pItems[iSubresource];
+        }
+    }
+
+    return NULL;
+}
+
+// Adds a subresource to the list if it hasn't already been seen. The new item has not been loaded yet.
+OC_PRIVATE ocResult ocWorldAddSceneSubresource(ocResource* pSceneResource, ocUInt32 subresourceIndex, ocStack<ocWorldSceneSubresource>* pSubresources)
+{
+    ocAssert(pSceneResource != NULL);
+    ocAssert(pSubresources != NULL);
+
+    const char* path = ocWorldGetSceneSubresourcePath(pSceneResource, subresourceIndex);
+    if (path == NULL || ocWorldFindSceneSubresource(pSubresources, path) != NULL) {
+        return OC_SUCCESS;
+    }
+
+    ocWorldSceneSubresource subresource;
+    subresource.path      = path;
+    subresource.pResource = NULL;
+    return ocStackPush(pSubresources, subresource);
+}
+
+// Adds every subresource referenced by the components of the given scene that hasn't already been seen to the list. These are the nested
+// scenes of scene components and the materials of mesh groups. Subresources that nothing references are not gathered since loading them
+// would be wasted work.
+OC_PRIVATE ocResult ocWorldGatherSceneSubresources(ocResource* pSceneResource, ocStack<ocWorldSceneSubresource>* pSubresources)
+{
+    ocAssert(pSceneResource != NULL);
+    ocAssert(pSubresources != NULL);
+
+    for (ocUInt32 iObject = 0; iObject < pSceneResource->scene.objectCount; ++iObject) {
+        ocSceneObject* pSceneObject = &pSceneResource->scene.pObjects[iObject];
+        ocSceneObjectComponent* pSceneObjectComponents = (ocSceneObjectComponent*)(pSceneResource->scene.pPayload + pSceneObject->componentsOffset);
+        for (ocUInt32 iComponent = 0; iComponent < pSceneObject->componentCount; ++iComponent) {
+            ocUInt8* pComponentData = pSceneResource->scene.pPayload + pSceneObjectComponents[iComponent].dataOffset;
+
+            ocResult result = OC_SUCCESS;
+            switch (pSceneObjectComponents[iComponent].type)
+            {
+                case OC_COMPONENT_TYPE_SCENE:
+                {
+                    result = ocWorldAddSceneSubresource(pSceneResource, *(ocUInt32*)pComponentData, pSubresources);
+                } break;
+
+                case OC_COMPONENT_TYPE_MESH:
+                {
+                    ocUInt32 groupCount = *(ocUInt32*)(pComponentData + 0);
+                    ocOCDSceneBuilderMeshGroup* pGroups = (ocOCDSceneBuilderMeshGroup*)(pComponentData + 40);
+                    for (ocUInt32 iGroup = 0; iGroup < groupCount && result == OC_SUCCESS; ++iGroup) {
+                        result = ocWorldAddSceneSubresource(pSceneResource, pGroups[iGroup].materialSubresourceIndex, pSubresources);
+                    }
+                } break;
+
+                default: break;
+            }
+
+            if (result != OC_SUCCESS) {
+                return result;
+            }
+        }
+    }
+
+    return OC_SUCCESS;
+}
+
+// Loads every nested scene and material of a scene, including those of the scenes nested inside it, before anything is instantiated.
+// Each level of nesting is loaded with a single call to ocResourceLibraryLoadMultiple() so everything on that level is read and decoded
+// in parallel rather than one file at a time.
+OC_PRIVATE ocResult ocWorldLoadSceneSubresources(ocResourceLibrary* pResourceLibrary, ocResource* pSceneResource, ocStack<ocWorldSceneSubresource>* pSubresources)
+{
+    ocAssert(pResourceLibrary != NULL);
+    ocAssert(pSceneResource != NULL);
+    ocAssert(pSubresources != NULL);
+
+    // The first level is the root scene. After that it's every scene that was loaded on the previous level. Subresources that have
+    // already been seen are not loaded again which also stops scenes that include themselves from looping forever.
+    ocSizeT prevLevelBegin = 0;
+    ocSizeT prevLevelEnd   = 0;
+    for (ocUInt32 iLevel = 0; iLevel < OC_MAX_SCENE_NESTING_DEPTH; ++iLevel) {
+        ocSizeT levelBegin = pSubresources->count;
+
+        ocResult result = OC_SUCCESS;
+        if (iLevel == 0) {
+            result = ocWorldGatherSceneSubresources(pSceneResource, pSubresources);
+        } else {
+            for (ocSizeT iSubresource = prevLevelBegin; iSubresource < prevLevelEnd; ++iSubresource) {
+                ocResource* pResource = pSubresources->pItems[iSubresource].pResource;
+                if (pResource != NULL && pResource->type == ocResourceType_Scene) {
+                    result = ocWorldGatherSceneSubresources(pResource, pSubresources);
+                    if (result != OC_SUCCESS) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        ocUInt32 levelCount = (ocUInt32)(pSubresources->count - levelBegin);
+        if (levelCount == 0) {
+            break;
+        }
+
+        const char** ppPaths = (const char**)ocMalloc(levelCount * sizeof(*ppPaths));
+        ocResource** ppResources = (ocResource**)ocMalloc(levelCount * sizeof(*ppResources));
+        if (ppPaths == NULL || ppResources == NULL) {
+            ocFree(ppPaths);
+            ocFree(ppResources);
+            return OC_OUT_OF_MEMORY;
+        }
+
+        for (ocUInt32 i = 0; i < levelCount; ++i) {
+            ppPaths[i] = pSubresources->pItems[levelBegin + i].path;
+        }
+
+        // A subresource failing to load is not an error here. It's dealt with by whatever references it when it's instantiated.
+        ocResourceLibraryLoadMultiple(pResourceLibrary, levelCount, ppPaths, ppResources, NULL);
+
+        for (ocUInt32 i = 0; i < levelCount; ++i) {
+            pSubresources->pItems[levelBegin + i].pResource = ppResources[i];
+        }
+
+        ocFree(ppPaths);
+        ocFree(ppResources);
+
+        prevLevelBegin = levelBegin;
+        prevLevelEnd   = pSubresources->count;
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocWorldInstantiateScene(ocWorld* pWorld, ocResource* pSceneResource, ocResourceLibrary* pResourceLibrary, ocStack<ocWorldSceneSubresource>* pSubresources, ocUInt32 depth, ocWorldObject** ppObject)
 {
     ocAssert(pWorld != NULL);
     ocAssert(pSceneResource != NULL);
+    ocAssert(pSubresources != NULL);
     ocAssert(ppObject != NULL);
 
     ocBool32 isExplicitRootRequired = OC_FALSE;
@@ -182,7 +392,8 @@ OC_PRIVATE ocResult ocWorldCreateObjectFromResource_Scene(ocWorld* pWorld, ocRes
             glm::vec3(pSceneObject->absoluteScaleX,    pSceneObject->absoluteScaleY,    pSceneObject->absoluteScaleZ));
 
 
-        // Components.
+        // Components. Mesh groups are numbered across every mesh component of the object so they can be found again for hot reloading.
+        ocUInt32 meshGroupIndex = 0;
         ocSceneObjectComponent* pSceneObjectComponents = (ocSceneObjectComponent*)(pSceneResource->scene.pPayload + pSceneObject->componentsOffset);
         for (ocUInt32 iComponent = 0; iComponent < pSceneObject->componentCount; ++iComponent) {
             ocSceneObjectComponent* pSceneObjectComponent = &pSceneObjectComponents[iComponent];
@@ -193,7 +404,37 @@ OC_PRIVATE ocResult ocWorldCreateObjectFromResource_Scene(ocWorld* pWorld, ocRes
             switch (pSceneObjectComponent->type) {
                 case OC_COMPONENT_TYPE_SCENE:
                 {
-                    // This is a sub-resource that needs to be loaded in.
+                    // Nested scenes have already been loaded by ocWorldLoadSceneSubresources(). They're instantiated as a child of
+                    // the object, relative to it.
+                    ocUInt32 subresourceIndex = *(ocUInt32*)(pComponentData + 0);
+                    const char* subresourcePath = ocWorldGetSceneSubresourcePath(pSceneResource, subresourceIndex);
+                    if (subresourcePath == NULL) {
+                        ocWarningf(pWorld->pEngine, "Scene component of \"%s\" refers to an invalid subresource.", pSceneResource->pAbsolutePath);
+                        break;
+                    }
+
+                    ocWorldSceneSubresource* pSubresource = ocWorldFindSceneSubresource(pSubresources, subresourcePath);
+                    if (pSubresource == NULL || pSubresource->pResource == NULL || pSubresource->pResource->type != ocResourceType_Scene) {
+                        ocWarningf(pWorld->pEngine, "Failed to load scene \"%s\".", subresourcePath);
+                        break;
+                    }
+
+                    if (depth + 1 >= OC_MAX_SCENE_NESTING_DEPTH) {
+                        ocWarningf(pWorld->pEngine, "Scene \"%s\" is nested too deeply. Does it include itself?", subresourcePath);
+                        break;
+                    }
+
+                    ocWorldObject* pNestedObject;
+                    ocResult result = ocWorldInstantiateScene(pWorld, pSubresource->pResource, pResourceLibrary, pSubresources, depth + 1, &pNestedObject);
+                    if (result != OC_SUCCESS) {
+                        return result;  // Need better recovery than this.
+                    }
+
+                    ocWorldObjectAppendChild(pWorldObject, pNestedObject);
+                    ocWorldObjectSetAbsoluteTransform(pNestedObject,
+                        ocMakeAbsolutePosition(glm::vec3(pNestedObject->absolutePosition), glm::vec3(pWorldObject->absolutePosition)),
+                        ocMakeAbsoluteRotation(pNestedObject->absoluteRotation, pWorldObject->absoluteRotation),
+                        ocMakeAbsoluteScale(glm::vec3(pNestedObject->absoluteScale), glm::vec3(pWorldObject->absoluteScale)));
                 } break;
 
                 case OC_COMPONENT_TYPE_MESH:
@@ -227,6 +468,10 @@ OC_PRIVATE ocResult ocWorldCreateObjectFromResource_Scene(ocWorld* pWorld, ocRes
                             return result;  // Need better recovery than this.
                         }
 
+                        // Failing to track the mesh only means it won't be hot reloaded.
+                        ocResourceLibraryTrackSceneMesh(pResourceLibrary, pSceneResource, (ocUInt32)iObject, meshGroupIndex, pMesh);
+                        meshGroupIndex += 1;
+
                         ocComponent* pComponent = ocWorldObjectAddComponent(pWorldObject, OC_COMPONENT_TYPE_MESH);
                         if (pComponent == NULL) {
                             return OC_ERROR;
@@ -258,6 +503,40 @@ OC_PRIVATE ocResult ocWorldCreateObjectFromResource_Scene(ocWorld* pWorld, ocRes
     return OC_SUCCESS;
 }
 
+OC_PRIVATE ocResult ocWorldCreateObjectFromResource_Scene(ocWorld* pWorld, ocResource* pSceneResource, ocResourceLibrary* pResourceLibrary, ocWorldObject** ppObject)
+{
+    ocAssert(pWorld != NULL);
+    ocAssert(pSceneResource != NULL);
+    ocAssert(ppObject != NULL);
+
+    ocStack<ocWorldSceneSubresource> subresources;
+    ocResult result = ocStackInit(&subresources);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // Every dependency is loaded up front so that nothing is instantiated until everything it needs is ready.
+    if (pResourceLibrary != NULL) {
+        result = ocWorldLoadSceneSubresources(pResourceLibrary, pSceneResource, &subresources);
+    }
+
+    if (result == OC_SUCCESS) {
+        result = ocWorldInstantiateScene(pWorld, pSceneResource, pResourceLibrary, &subresources, 0, ppObject);
+    }
+
+    // The instantiated objects don't hold on to their subresources. Everything they need from the nested scenes has been copied into the
+    // world and the graphics system by now, and materials can't be attached to meshes yet. Released materials stay in memory within the
+    // material budget so instantiating the scene again doesn't need to read their libraries again.
+    for (ocSizeT iSubresource = 0; iSubresource < subresources.count; ++iSubresource) {
+        if (subresources.pItems[iSubresource].pResource != NULL) {
+            ocResourceLibraryUnload(pResourceLibrary, subresources.pItems[iSubresource].pResource);
+        }
+    }
+
+    ocStackUninit(&subresources);
+    return result;
+}
+
 ocResult ocWorldCreateObjectFromResource(ocWorld* pWorld, ocResource* pResource, ocResourceLibrary* pResourceLibrary, ocWorldObject** ppObject)
 {
     if (ppObject == NULL) {
@@ -288,9 +567,12 @@ OC_PRIVATE void ocWorldDeleteObjectRecursive(ocWorld* pWorld, ocWorldObject* pOb
         return;
     }
 
-    // Children first.
-    for (ocWorldObject* pChild = pObject->pFirstChild; pChild != NULL; pChild = pChild->pNextSibling) {
+    // Children first. Children can be in their own allocation, such as the root of a nested scene, so the next sibling needs to be
+    // retrieved before the child is deleted.
+    for (ocWorldObject* pChild = pObject->pFirstChild; pChild != NULL; ) {
+        ocWorldObject* pNextChild = pChild->pNextSibling;
         ocWorldDeleteObjectRecursive(pWorld, pChild);
+        pChild = pNextChild;
     }
 
     ocWorldObjectUninit(pObject);
@@ -332,20 +614,62 @@ ocResult ocWorldInsertObject(ocWorld* pWorld, ocWorldObject* pObject)
             {
                 ocMeshComponent* pMeshComponent = OC_MESH_COMPONENT(pObject->ppComponents[iComponent]);
                 ocAssert(pMeshComponent->pMeshObject == NULL);  // <-- You've done something wrong if the mesh object is not null at this point.
-                ocGraphicsWorldCreateMeshObject(&pWorld->graphicsWorld, pMeshComponent->pMesh, &pMeshComponent->pMeshObject);
+
+                ocResult result;
+                if (pMeshComponent->pSkeleton != NULL) {
+                    result = ocGraphicsWorldCreateSkinnedMeshObject(&pWorld->graphicsWorld, pMeshComponent->pMesh, pMeshComponent->pSkeleton, &pMeshComponent->pMeshObject);
+                } else {
+                    result = ocGraphicsWorldCreateMeshObject(&pWorld->graphicsWorld, pMeshComponent->pMesh, &pMeshComponent->pMeshObject);
+                }
+
+                if (result != OC_SUCCESS) {
+                    pMeshComponent->pMeshObject = NULL;
+                    ocWorldRemoveObject(pWorld, pObject);   // <-- Deletes whatever was created for the components before this one.
+                    return result;
+                }
+
                 ocGraphicsWorldSetObjectTransform(&pWorld->graphicsWorld, pMeshComponent->pMeshObject, pObject->absolutePosition, pObject->absoluteRotation, pObject->absoluteScale);
             } break;
 
             case OC_COMPONENT_TYPE_PARTICLE_SYSTEM:
             {
+                ocParticleSystemComponent* pParticleComponent = OC_PARTICLE_SYSTEM_COMPONENT(pObject->ppComponents[iComponent]);
+                ocAssert(pParticleComponent->pParticleObject == NULL);
+                if (ocGraphicsWorldCreateParticleSystemObject(&pWorld->graphicsWorld, &pParticleComponent->desc, &pParticleComponent->pParticleObject) == OC_SUCCESS) {
+                    ocGraphicsWorldSetObjectTransform(&pWorld->graphicsWorld, pParticleComponent->pParticleObject, pObject->absolutePosition, pObject->absoluteRotation, pObject->absoluteScale);
+                }
             } break;
 
             case OC_COMPONENT_TYPE_LIGHT:
             {
+                ocLightComponent* pLightComponent = OC_LIGHT_COMPONENT(pObject->ppComponents[iComponent]);
+                ocAssert(pLightComponent->pLightObject == NULL);
+                if (ocGraphicsWorldCreateLightObject(&pWorld->graphicsWorld, &pLightComponent->desc, &pLightComponent->pLightObject) == OC_SUCCESS) {
+                    ocGraphicsWorldSetObjectTransform(&pWorld->graphicsWorld, pLightComponent->pLightObject, pObject->absolutePosition, pObject->absoluteRotation, pObject->absoluteScale);
+                }
             } break;
 
             case OC_COMPONENT_TYPE_DYNAMICS_BODY:
             {
+                ocDynamicsBodyComponent* pBodyComponent = OC_DYNAMICS_BODY_COMPONENT(pObject->ppComponents[iComponent]);
+                ocAssert(pBodyComponent->bodyID == OC_DYNAMICS_BODY_NONE);
+
+                ocDynamicsBodyDesc desc = pBodyComponent->desc;
+                desc.pUserData = pBodyComponent;
+                ocDynamicsWorldCreateBody(&pWorld->dynamicsWorld, &desc, glm::vec3(pObject->absolutePosition), pObject->absoluteRotation, &pBodyComponent->bodyID);
+            } break;
+
+            case OC_COMPONENT_TYPE_AUDIO_EMITTER:
+            {
+                ocAudioEmitterComponent* pEmitterComponent = OC_AUDIO_EMITTER_COMPONENT(pObject->ppComponents[iComponent]);
+                ocAssert(pEmitterComponent->emitterID == OC_AUDIO_EMITTER_NONE);
+                if (pEmitterComponent->desc.pSound != NULL) {
+                    ocResult result = ocAudioWorldCreateEmitter(&pWorld->audioWorld, &pEmitterComponent->desc, glm::vec3(pObject->absolutePosition), &pEmitterComponent->emitterID);
+                    if (result != OC_SUCCESS) {
+                        ocWorldRemoveObject(pWorld, pObject);   // <-- The emitter ID is left as OC_AUDIO_EMITTER_NONE on failure.
+                        return result;
+                    }
+                }
             } break;
 
             default:
@@ -355,9 +679,13 @@ ocResult ocWorldInsertObject(ocWorld* pWorld, ocWorldObject* pObject)
         }
     }
 
-    // Children last.
+    // Children last. If one of them fails, everything inserted so far is removed again.
     for (ocWorldObject* pChild = pObject->pFirstChild; pChild != NULL; pChild = pChild->pNextSibling) {
-        ocWorldInsertObject(pWorld, pChild);
+        ocResult result = ocWorldInsertObject(pWorld, pChild);
+        if (result != OC_SUCCESS) {
+            ocWorldRemoveObject(pWorld, pObject);
+            return result;
+        }
     }
 
     pObject->isInWorld = OC_TRUE;
@@ -394,14 +722,38 @@ ocResult ocWorldRemoveObject(ocWorld* pWorld, ocWorldObject* pObject)
 
             case OC_COMPONENT_TYPE_PARTICLE_SYSTEM:
             {
+                ocParticleSystemComponent* pParticleComponent = OC_PARTICLE_SYSTEM_COMPONENT(pObject->ppComponents[iComponent]);
+                if (pParticleComponent->pParticleObject != NULL) {
+                    ocGraphicsWorldDeleteObject(&pWorld->graphicsWorld, pParticleComponent->pParticleObject);
+                    pParticleComponent->pParticleObject = NULL;
+                }
             } break;
 
             case OC_COMPONENT_TYPE_LIGHT:
             {
+                ocLightComponent* pLightComponent = OC_LIGHT_COMPONENT(pObject->ppComponents[iComponent]);
+                if (pLightComponent->pLightObject != NULL) {
+                    ocGraphicsWorldDeleteObject(&pWorld->graphicsWorld, pLightComponent->pLightObject);
+                    pLightComponent->pLightObject = NULL;
+                }
             } break;
 
             case OC_COMPONENT_TYPE_DYNAMICS_BODY:
             {
+                ocDynamicsBodyComponent* pBodyComponent = OC_DYNAMICS_BODY_COMPONENT(pObject->ppComponents[iComponent]);
+                if (pBodyComponent->bodyID != OC_DYNAMICS_BODY_NONE) {
+                    ocDynamicsWorldDeleteBody(&pWorld->dynamicsWorld, pBodyComponent->bodyID);
+                    pBodyComponent->bodyID = OC_DYNAMICS_BODY_NONE;
+                }
+            } break;
+
+            case OC_COMPONENT_TYPE_AUDIO_EMITTER:
+            {
+                ocAudioEmitterComponent* pEmitterComponent = OC_AUDIO_EMITTER_COMPONENT(pObject->ppComponents[iComponent]);
+                if (pEmitterComponent->emitterID != OC_AUDIO_EMITTER_NONE) {
+                    ocAudioWorldDeleteEmitter(&pWorld->audioWorld, pEmitterComponent->emitterID);
+                    pEmitterComponent->emitterID = OC_AUDIO_EMITTER_NONE;
+                }
             } break;
 
             default:
@@ -417,11 +769,11 @@ ocResult ocWorldRemoveObject(ocWorld* pWorld, ocWorldObject* pObject)
 }
 
 
-void ocWorldSetObjectAbsoluteTransform(ocWorld* pWorld, ocWorldObject* pObject, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation, const glm::vec3 &absoluteScale)
+// pSourceComponent is the component the transform came from, which is not updated. Can be NULL.
+OC_PRIVATE void ocWorldSetObjectAbsoluteTransformFromComponent(ocWorld* pWorld, ocWorldObject* pObject, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation, const glm::vec3 &absoluteScale, ocComponent* pSourceComponent)
 {
-    if (pWorld == NULL || pObject == NULL) {
-        return;
-    }
+    ocAssert(pWorld != NULL);
+    ocAssert(pObject != NULL);
 
     // We update the transforms of the children first, because they need to know the previous transform of the parent
     // object so they can be transformed correctly.
@@ -442,7 +794,7 @@ void ocWorldSetObjectAbsoluteTransform(ocWorld* pWorld, ocWorldObject* pObject,
                 childAbsoluteScale = ocMakeAbsoluteScale(ocWorldObjectGetRelativeScale(pChild), absoluteScale);
             }
 
-            ocWorldSetObjectAbsoluteTransform(pWorld, pChild, childAbsolutePosition, childAbsoluteRotation, childAbsoluteScale);
+            ocWorldSetObjectAbsoluteTransformFromComponent(pWorld, pChild, childAbsolutePosition, childAbsoluteRotation, childAbsoluteScale, NULL);
         }
     }
 
@@ -464,16 +816,45 @@ void ocWorldSetObjectAbsoluteTransform(ocWorld* pWorld, ocWorldObject* pObject,
 
                 case OC_COMPONENT_TYPE_PARTICLE_SYSTEM:
                 {
+                    ocParticleSystemComponent* pParticleComponent = OC_PARTICLE_SYSTEM_COMPONENT(pObject->ppComponents[iComponent]);
+                    if (pParticleComponent->pParticleObject != NULL) {
+                        ocGraphicsWorldSetObjectTransform(&pWorld->graphicsWorld, pParticleComponent->pParticleObject, absolutePosition, absoluteRotation, absoluteScale);
+                    }
                 } break;
 
                 case OC_COMPONENT_TYPE_LIGHT:
                 {
+                    ocLightComponent* pLightComponent = OC_LIGHT_COMPONENT(pObject->ppComponents[iComponent]);
+                    if (pLightComponent->pLightObject != NULL) {
+                        ocGraphicsWorldSetObjectTransform(&pWorld->graphicsWorld, pLightComponent->pLightObject, absolutePosition, absoluteRotation, absoluteScale);
+                    }
                 } break;
 
                 case OC_COMPONENT_TYPE_DYNAMICS_BODY:
                 {
+                    ocDynamicsBodyComponent* pBodyComponent = OC_DYNAMICS_BODY_COMPONENT(pObject->ppComponents[iComponent]);
+                    if (pBodyComponent->bodyID != OC_DYNAMICS_BODY_NONE && pBodyComponent != pSourceComponent) {
+                        ocDynamicsWorldSetBodyTransform(&pWorld->dynamicsWorld, pBodyComponent->bodyID, absolutePosition, absoluteRotation);
+                    }
+                } break;
+
+                case OC_COMPONENT_TYPE_AUDIO_EMITTER:
+                {
+                    ocAudioEmitterComponent* pEmitterComponent = OC_AUDIO_EMITTER_COMPONENT(pObject->ppComponents[iComponent]);
+                    if (pEmitterComponent->emitterID != OC_AUDIO_EMITTER_NONE) {
+                        ocAudioWorldSetEmitterPosition(&pWorld->audioWorld, pEmitterComponent->emitterID, absolutePosition);
+                    }
                 } break;
             }
         }
     }
+}
+
+void ocWorldSetObjectAbsoluteTransform(ocWorld* pWorld, ocWorldObject* pObject, const glm::vec3 &absolutePosition, const glm::quat &absoluteRotation, const glm::vec3 &absoluteScale)
+{
+    if (pWorld == NULL || pObject == NULL) {
+        return;
+    }
+
+    ocWorldSetObjectAbsoluteTransformFromComponent(pWorld, pObject, absolutePosition, absoluteRotation, absoluteScale, NULL);
 }
\ No newline at end of file
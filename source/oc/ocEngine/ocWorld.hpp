@@ -1,11 +1,15 @@
 // Copyright (C) 2018 David Reid. See included LICENSE file.
 
+// The maximum depth of scenes nested inside other scenes.
+#define OC_MAX_SCENE_NESTING_DEPTH  16
+
 struct ocWorld
 {
     ocEngineContext* pEngine;
     ocGraphicsWorld graphicsWorld;
     ocAudioWorld audioWorld;
     ocDynamicsWorld dynamicsWorld;
+    ocCamera* pActiveCamera;        // <-- Used as the audio listener. Can be NULL.
 };
 
 //
@@ -25,6 +29,10 @@ void ocWorldDeleteRT(ocWorld* pWorld, ocGraphicsRT* pRT);
 //
 void ocWorldStep(ocWorld* pWorld, double dt);
 
+// Sets the camera the world is being viewed from. This is what's used as the listener for positional audio. The camera is not copied
+// and must remain valid until it's replaced or the world is uninitialized. Can be NULL.
+void ocWorldSetActiveCamera(ocWorld* pWorld, ocCamera* pCamera);
+
 // Draws the world, but does _not_ present it to the game windows. Window presentation needs to be done at a higher level.
 void ocWorldDraw(ocWorld* pWorld);
 
@@ -37,7 +45,8 @@ void ocWorldDraw(ocWorld* pWorld);
 // When using this function, you should not change the object hierarchy as this will cause ocWorldDeleteObject() to not
 // work correctly.
 //
-// This will recursively load relevant sub-resources via the pResourceLibrary object.
+// This will load relevant sub-resources, including nested scenes, via the pResourceLibrary object. Every sub-resource is loaded before
+// anything is instantiated, with each level of nesting loaded in parallel. A nested scene that fails to load is skipped with a warning.
 ocResult ocWorldCreateObjectFromResource(ocWorld* pWorld, ocResource* pResource, ocResourceLibrary* pResourceLibrary, ocWorldObject** ppObject);
 
 // Recursively deletes the given object.
@@ -228,6 +228,7 @@ int ocInitAndRun(int argc, char** argv)
     /* Camera. */
     ocCameraInitPerspective(90, 640.0f/480.0f, 0.01f, 1000.0f, &g_Game.camera);
     ocCameraSetPosition(&g_Game.camera, glm::vec3(0, 0, 4));
+    ocWorldSetActiveCamera(&g_Game.world, &g_Game.camera);
 
     // TESTING (Image)
     {
@@ -261,8 +262,6 @@ int ocInitAndRun(int argc, char** argv)
         if (result != OC_SUCCESS) {
             return result;
         }
-
-        g_Game.world.graphicsWorld.pCurrentImage = g_Game.pImage;
 #endif
 
 #if 0
@@ -283,16 +282,12 @@ int ocInitAndRun(int argc, char** argv)
         if (result != OC_SUCCESS) {
             return result;
         }
-
-        g_Game.world.graphicsWorld.pCurrentImage = g_Game.pImage;
 #endif
 
         result = ocResourceLibraryLoad(&g_Game.engine.resourceLibrary, "happy_smiley_face.png", &g_Game.pImageResource);
         if (result != OC_SUCCESS) {
             return result;
         }
-
-        g_Game.world.graphicsWorld.pCurrentImage = g_Game.pImageResource->image.pGraphicsImage;
     }
 
 
@@ -346,6 +341,7 @@ int ocInitAndRun(int argc, char** argv)
 
         ocComponentMeshSetMesh(OC_MESH_COMPONENT(pComponent), g_Game.pMesh);
         ocWorldInsertObject(&g_Game.world, &g_Game.object);
+        ocGraphicsWorldSetObjectImage(&g_Game.world.graphicsWorld, OC_MESH_COMPONENT(pComponent)->pMeshObject, g_Game.pImageResource->image.pGraphicsImage);
         ocWorldObjectSetAbsolutePosition(&g_Game.object, glm::vec3(0.2f, 0, 0));
         ocWorldObjectSetAbsoluteScale(&g_Game.object, glm::vec3(0.5f, 0.5f, 0.5f));
     }
@@ -435,6 +431,13 @@ int ocInitAndRun(int argc, char** argv)
             }
 
             ocWorldInsertObject(&g_Game.world, &object);
+
+            // Materials are not hooked up yet so every mesh is textured with the test image.
+            for (ocUInt16 iComponent = 0; iComponent < object.componentCount; ++iComponent) {
+                if (object.ppComponents[iComponent]->type == OC_COMPONENT_TYPE_MESH) {
+                    ocGraphicsWorldSetObjectImage(&g_Game.world.graphicsWorld, OC_MESH_COMPONENT(object.ppComponents[iComponent])->pMeshObject, g_Game.pImageResource->image.pGraphicsImage);
+                }
+            }
         }
     }
 
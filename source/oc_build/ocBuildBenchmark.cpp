@@ -0,0 +1,2053 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_BUILD_BENCHMARK_STREAM_BUFFER_SIZE   (64*1024)
+
+OC_PRIVATE void ocBuildBenchmarkPrintThroughput(const char* name, ocResult result, ocUInt64 bytesProcessed, double seconds)
+{
+    if (result != OC_SUCCESS) {
+        printf("  %-44s failed (%d)\n", name, result);
+        return;
+    }
+
+    printf("  %-44s %10.1f MB/s\n", name, (bytesProcessed / (1024.0*1024.0)) / seconds);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Streams
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// The file benchmarks go through stdio rather than ocFile because there's no file system outside of the engine.
+OC_PRIVATE ocResult ocBuildBenchmark_OnWrite_FILE(void* pUserData, const void* pData, ocSizeT bytesToWrite, ocSizeT* pBytesWritten)
+{
+    return ocFWrite((FILE*)pUserData, bytesToWrite, pData, pBytesWritten);
+}
+
+OC_PRIVATE ocResult ocBuildBenchmark_OnRead_FILE(void* pUserData, void* pDataOut, ocSizeT bytesToRead, ocSizeT* pBytesRead)
+{
+    ocResult result = ocFRead((FILE*)pUserData, bytesToRead, pDataOut, pBytesRead);
+    if (result != OC_SUCCESS && feof((FILE*)pUserData)) {
+        return OC_AT_END_OF_FILE;
+    }
+
+    return result;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmark_OnSeek_FILE(void* pUserData, ocInt64 bytesToSeek, ocSeekOrigin origin)
+{
+    int stdioOrigin = SEEK_CUR;
+    if (origin == ocSeekOrigin_Start) {
+        stdioOrigin = SEEK_SET;
+    } else if (origin == ocSeekOrigin_End) {
+        stdioOrigin = SEEK_END;
+    }
+
+    return ocFSeek((FILE*)pUserData, bytesToSeek, stdioOrigin);
+}
+
+OC_PRIVATE ocResult ocBuildBenchmark_OnTell_FILE(void* pUserData, ocUInt64* pPos)
+{
+    return ocFTell((FILE*)pUserData, pPos);
+}
+
+OC_PRIVATE ocResult ocBuildBenchmark_OnSize_FILE(void* pUserData, ocUInt64* pSize)
+{
+    (void)pUserData;
+    (void)pSize;
+    return OC_FEATURE_NOT_SUPPORTED;    // <-- Not needed.
+}
+
+OC_PRIVATE ocBool32 ocBuildBenchmark_OnAtEnd_FILE(void* pUserData)
+{
+    return feof((FILE*)pUserData) != 0;
+}
+
+
+OC_PRIVATE ocResult ocBuildBenchmarkStreams_Write(ocStreamWriter* pWriter, ocUInt64 size, double* pSeconds)
+{
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    ocUInt64 valueCount = size / sizeof(ocUInt32);
+    for (ocUInt64 iValue = 0; iValue < valueCount; ++iValue) {
+        ocResult result = ocStreamWriterWrite<ocUInt32>(pWriter, (ocUInt32)iValue);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    ocResult result = ocStreamWriterFlush(pWriter);
+    *pSeconds = ocTimerTick(&timer);
+
+    return result;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkStreams_Read(ocStreamReader* pReader, ocUInt64 size, ocBool32 useAcquire, double* pSeconds)
+{
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    // The values are summed and checked so the reads can't be optimized out.
+    ocUInt64 valueCount = size / sizeof(ocUInt32);
+    ocUInt64 sum = 0;
+    for (ocUInt64 iValue = 0; iValue < valueCount; ++iValue) {
+        ocUInt32 value;
+        ocResult result;
+        if (useAcquire) {
+            const void* pValue;
+            result = ocStreamReaderAcquire(pReader, sizeof(value), &pValue);
+            if (result == OC_SUCCESS) {
+                ocCopyMemory(&value, pValue, sizeof(value));
+            }
+        } else {
+            result = ocStreamReaderRead(pReader, &value, sizeof(value), NULL);
+        }
+
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        sum += value;
+    }
+
+    *pSeconds = ocTimerTick(&timer);
+
+    if (sum != (valueCount * (valueCount-1)) / 2) {
+        return OC_CORRUPT_FILE;
+    }
+
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkStreams(ocUInt64 size)
+{
+    ocResult result;
+    double seconds;
+
+    printf("Stream writers (%u MB, 4 byte writes):\n", (unsigned int)(size / (1024*1024)));
+
+    // Memory writer. This is the baseline, and reallocates as it grows.
+    {
+        void* pData;
+        ocSizeT dataSize;
+        ocStreamWriter writer;
+        ocStreamWriterInit(&pData, &dataSize, &writer);
+        result = ocBuildBenchmarkStreams_Write(&writer, size, &seconds);
+        ocStreamWriterUninit(&writer);
+        ocFree(pData);
+
+        ocBuildBenchmarkPrintThroughput("Memory", result, size, seconds);
+    }
+
+    // Chunked writer.
+    {
+        ocStreamWriter writer;
+        ocStreamWriterInitChunked(0, &writer);
+        result = ocBuildBenchmarkStreams_Write(&writer, size, &seconds);
+        ocStreamWriterUninit(&writer);
+
+        ocBuildBenchmarkPrintThroughput("Chunked", result, size, seconds);
+    }
+
+    // Chunked writer with a write buffer, which is what takes the inlined fast path.
+    {
+        ocStreamWriter writer;
+        ocStreamWriterInitChunked(0, &writer);
+        ocStreamWriterSetBufferSize(&writer, OC_BUILD_BENCHMARK_STREAM_BUFFER_SIZE);
+        result = ocBuildBenchmarkStreams_Write(&writer, size, &seconds);
+        ocStreamWriterUninit(&writer);
+
+        ocBuildBenchmarkPrintThroughput("Chunked (buffered)", result, size, seconds);
+    }
+
+    // Files. The same file is reused for the read benchmarks.
+    FILE* pFile = tmpfile();
+    if (pFile == NULL) {
+        printf("Failed to create temporary file.\n");
+        return OC_ERROR;
+    }
+
+    {
+        ocStreamWriter writer;
+        ocStreamWriterInit(ocBuildBenchmark_OnWrite_FILE, ocBuildBenchmark_OnSeek_FILE, ocBuildBenchmark_OnTell_FILE, ocBuildBenchmark_OnSize_FILE, pFile, &writer);
+        result = ocBuildBenchmarkStreams_Write(&writer, size, &seconds);
+        ocStreamWriterUninit(&writer);
+
+        ocBuildBenchmarkPrintThroughput("File", result, size, seconds);
+    }
+
+    ocFSeek(pFile, 0, SEEK_SET);
+    {
+        ocStreamWriter writer;
+        ocStreamWriterInit(ocBuildBenchmark_OnWrite_FILE, ocBuildBenchmark_OnSeek_FILE, ocBuildBenchmark_OnTell_FILE, ocBuildBenchmark_OnSize_FILE, pFile, &writer);
+        ocStreamWriterSetBufferSize(&writer, OC_BUILD_BENCHMARK_STREAM_BUFFER_SIZE);
+        result = ocBuildBenchmarkStreams_Write(&writer, size, &seconds);
+        ocStreamWriterUninit(&writer);
+
+        ocBuildBenchmarkPrintThroughput("File (buffered)", result, size, seconds);
+    }
+
+
+    printf("Stream readers (%u MB, 4 byte reads):\n", (unsigned int)(size / (1024*1024)));
+
+    ocFSeek(pFile, 0, SEEK_SET);
+    {
+        ocStreamReader reader;
+        ocStreamReaderInit(ocBuildBenchmark_OnRead_FILE, ocBuildBenchmark_OnSeek_FILE, ocBuildBenchmark_OnTell_FILE, ocBuildBenchmark_OnAtEnd_FILE, pFile, &reader);
+        result = ocBuildBenchmarkStreams_Read(&reader, size, OC_FALSE, &seconds);
+        ocStreamReaderUninit(&reader);
+
+        ocBuildBenchmarkPrintThroughput("File", result, size, seconds);
+    }
+
+    ocFSeek(pFile, 0, SEEK_SET);
+    {
+        ocStreamReader reader;
+        ocStreamReaderInit(ocBuildBenchmark_OnRead_FILE, ocBuildBenchmark_OnSeek_FILE, ocBuildBenchmark_OnTell_FILE, ocBuildBenchmark_OnAtEnd_FILE, pFile, &reader);
+        ocStreamReaderSetBufferSize(&reader, OC_BUILD_BENCHMARK_STREAM_BUFFER_SIZE);
+        result = ocBuildBenchmarkStreams_Read(&reader, size, OC_FALSE, &seconds);
+        ocStreamReaderUninit(&reader);
+
+        ocBuildBenchmarkPrintThroughput("File (buffered)", result, size, seconds);
+    }
+
+    ocFSeek(pFile, 0, SEEK_SET);
+    {
+        ocStreamReader reader;
+        ocStreamReaderInit(ocBuildBenchmark_OnRead_FILE, ocBuildBenchmark_OnSeek_FILE, ocBuildBenchmark_OnTell_FILE, ocBuildBenchmark_OnAtEnd_FILE, pFile, &reader);
+        ocStreamReaderSetBufferSize(&reader, OC_BUILD_BENCHMARK_STREAM_BUFFER_SIZE);
+        result = ocBuildBenchmarkStreams_Read(&reader, size, OC_TRUE, &seconds);
+        ocStreamReaderUninit(&reader);
+
+        ocBuildBenchmarkPrintThroughput("File (buffered, acquire)", result, size, seconds);
+    }
+
+    // Memory. The file is loaded in one go with a large read, which bypasses the buffer.
+    void* pData = ocMalloc((ocSizeT)size);
+    if (pData == NULL) {
+        ocFClose(pFile);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocFSeek(pFile, 0, SEEK_SET);
+    result = ocFRead(pFile, (ocSizeT)size, pData, NULL);
+    ocFClose(pFile);
+
+    if (result != OC_SUCCESS) {
+        ocFree(pData);
+        return result;
+    }
+
+    {
+        ocStreamReader reader;
+        ocStreamReaderInit(pData, (ocSizeT)size, &reader);
+        result = ocBuildBenchmarkStreams_Read(&reader, size, OC_FALSE, &seconds);
+        ocStreamReaderUninit(&reader);
+
+        ocBuildBenchmarkPrintThroughput("Memory", result, size, seconds);
+    }
+
+    {
+        ocStreamReader reader;
+        ocStreamReaderInit(pData, (ocSizeT)size, &reader);
+        result = ocBuildBenchmarkStreams_Read(&reader, size, OC_TRUE, &seconds);
+        ocStreamReaderUninit(&reader);
+
+        ocBuildBenchmarkPrintThroughput("Memory (acquire)", result, size, seconds);
+    }
+
+    ocFree(pData);
+    return OC_SUCCESS;
+}
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Audio Mixer
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_BUILD_BENCHMARK_AUDIO_SAMPLE_RATE    48000
+#define OC_BUILD_BENCHMARK_AUDIO_PERIOD_SIZE    480     // <-- 10ms, which is a typical callback size.
+#define OC_BUILD_BENCHMARK_AUDIO_PERIOD_COUNT   1000    // <-- 10 seconds of audio.
+
+OC_PRIVATE ocResult ocBuildBenchmarkAudioMixer_Run(const char* name, const ocAudioBuffer* pBuffer, ocUInt32 voiceCount, ocUInt32 maxRealVoices)
+{
+    ocAudioMixer mixer;
+    ocResult result = ocAudioMixerInit(OC_BUILD_BENCHMARK_AUDIO_SAMPLE_RATE, voiceCount, maxRealVoices, &mixer);
+    if (result != OC_SUCCESS) {
+        printf("  %-44s failed (%d)\n", name, result);
+        return result;
+    }
+
+    // The voices are spread across the stereo field and given a mix of priorities so that virtualization has something to choose between.
+    for (ocUInt32 iVoice = 0; iVoice < voiceCount; ++iVoice) {
+        ocAudioVoiceParams params = ocAudioVoiceParamsInit();
+        params.gain     = 0.5f / voiceCount * (1 + (iVoice % 7));
+        params.pan      = ((iVoice % 16) / 7.5f) - 1;
+        params.priority = iVoice % 4;
+        params.looping  = OC_TRUE;
+
+        ocAudioVoiceID voiceID;
+        result = ocAudioMixerPlay(&mixer, pBuffer, &params, &voiceID);
+        if (result != OC_SUCCESS) {
+            ocAudioMixerUninit(&mixer);
+            printf("  %-44s failed (%d)\n", name, result);
+            return result;
+        }
+    }
+
+    float output[OC_BUILD_BENCHMARK_AUDIO_PERIOD_SIZE * OC_AUDIO_MIXER_CHANNELS];
+
+    // The first period is not timed. It's where the play commands are processed.
+    ocAudioMixerRead(&mixer, output, OC_BUILD_BENCHMARK_AUDIO_PERIOD_SIZE);
+
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    for (ocUInt32 iPeriod = 0; iPeriod < OC_BUILD_BENCHMARK_AUDIO_PERIOD_COUNT; ++iPeriod) {
+        ocAudioMixerRead(&mixer, output, OC_BUILD_BENCHMARK_AUDIO_PERIOD_SIZE);
+    }
+
+    double seconds = ocTimerTick(&timer);
+    ocUInt32 realVoiceCount = mixer.realVoiceCount;
+
+    ocAudioMixerUninit(&mixer);
+
+    // Milliseconds of voice audio mixed per millisecond. This is how many voices could be mixed in real time on one core.
+    double audioMilliseconds = (OC_BUILD_BENCHMARK_AUDIO_PERIOD_COUNT * OC_BUILD_BENCHMARK_AUDIO_PERIOD_SIZE * 1000.0) / OC_BUILD_BENCHMARK_AUDIO_SAMPLE_RATE;
+    double voicesPerMillisecond = (realVoiceCount * audioMilliseconds) / (seconds * 1000);
+
+    printf("  %-44s %10.1f voices/ms (%u real, %.3f ms per period)\n", name, voicesPerMillisecond, realVoiceCount, (seconds * 1000) / OC_BUILD_BENCHMARK_AUDIO_PERIOD_COUNT);
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkAudioMixer()
+{
+    // One second of noise. The content doesn't matter to the mixer, but it shouldn't be silent or denormal.
+    const ocUInt32 frameCount = OC_BUILD_BENCHMARK_AUDIO_SAMPLE_RATE;
+    float* pSamples = (float*)ocMalloc(frameCount * 2 * sizeof(float));
+    if (pSamples == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocUInt32 seed = 0x12345678;
+    for (ocUInt32 iSample = 0; iSample < frameCount * 2; ++iSample) {
+        seed = seed*1664525 + 1013904223;
+        pSamples[iSample] = ((seed >> 8) / 8388608.0f) - 1;
+    }
+
+    ocAudioBuffer mono;
+    mono.pFrames    = pSamples;
+    mono.frameCount = frameCount;
+    mono.channels   = 1;
+    mono.sampleRate = OC_BUILD_BENCHMARK_AUDIO_SAMPLE_RATE;
+
+    ocAudioBuffer stereo = mono;
+    stereo.channels = 2;
+
+    ocAudioBuffer monoResampled = mono;
+    monoResampled.sampleRate = 44100;
+
+    printf("Audio mixer (%u Hz, %u frame periods):\n", OC_BUILD_BENCHMARK_AUDIO_SAMPLE_RATE, OC_BUILD_BENCHMARK_AUDIO_PERIOD_SIZE);
+
+    ocBuildBenchmarkAudioMixer_Run("Mono, 64 voices",                     &mono,          64,   64);
+    ocBuildBenchmarkAudioMixer_Run("Mono, 256 voices",                    &mono,          256,  256);
+    ocBuildBenchmarkAudioMixer_Run("Stereo, 64 voices",                   &stereo,        64,   64);
+    ocBuildBenchmarkAudioMixer_Run("Mono (resampled), 64 voices",         &monoResampled, 64,   64);
+    ocBuildBenchmarkAudioMixer_Run("Mono, 1024 voices (64 real)",         &mono,          1024, 64);
+
+    ocFree(pSamples);
+    return OC_SUCCESS;
+}
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Audio Render
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_BUILD_BENCHMARK_AUDIO_RENDER_SECONDS         30
+#define OC_BUILD_BENCHMARK_AUDIO_RENDER_STEP_RATE       60      // <-- Game steps per second. Not a multiple of the period rate on purpose.
+#define OC_BUILD_BENCHMARK_AUDIO_RENDER_EMITTERS        512
+#define OC_BUILD_BENCHMARK_AUDIO_RENDER_ONE_SHOTS       32      // <-- One-shot emitters are recycled in a ring of this size.
+
+OC_PRIVATE int ocBuildBenchmarkAudioRender_CompareDouble(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+// Emitters orbit the origin at different radii and speeds. Some are always out of range and some cross in and out of it, which exercises
+// culling, and the orbits are fast enough to produce Doppler shifts.
+OC_PRIVATE glm::vec3 ocBuildBenchmarkAudioRender_EmitterPosition(ocUInt32 iEmitter, double time)
+{
+    float radius = 2.0f + (float)((iEmitter * 37) % 150);
+    float speed  = 0.1f + (float)(iEmitter % 11) * 0.15f;
+    float angle  = (float)(iEmitter * 0.618 + time * speed);
+    float height = (float)((iEmitter % 5) * 2) - 4;
+    return glm::vec3(cosf(angle) * radius, height, sinf(angle) * radius);
+}
+
+// Writes interleaved stereo f32 frames to a WAV file.
+OC_PRIVATE ocResult ocBuildBenchmarkAudioRender_WriteWAV(const char* filePath, const float* pFrames, ocUInt32 frameCount, ocUInt32 sampleRate)
+{
+    FILE* pFile;
+    ocResult result = ocFOpen(filePath, "wb", &pFile);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // IEEE float data requires the extended format chunk and a fact chunk. Everything is little endian.
+    ocUInt32 dataSize = frameCount * OC_AUDIO_MIXER_CHANNELS * sizeof(float);
+    ocUInt8 header[58];
+    ocUInt32 riffSize           = sizeof(header) - 8 + dataSize;
+    ocUInt32 fmtSize            = 18;
+    ocUInt16 formatTag          = 3;    // <-- WAVE_FORMAT_IEEE_FLOAT
+    ocUInt16 channels           = OC_AUDIO_MIXER_CHANNELS;
+    ocUInt32 bytesPerSecond     = sampleRate * OC_AUDIO_MIXER_CHANNELS * sizeof(float);
+    ocUInt16 blockAlign         = OC_AUDIO_MIXER_CHANNELS * sizeof(float);
+    ocUInt16 bitsPerSample      = 32;
+    ocUInt16 extraSize          = 0;
+    ocUInt32 factSize           = 4;
+
+    ocCopyMemory(header +  0, "RIFF", 4);
+    ocCopyMemory(header +  4, &riffSize, 4);
+    ocCopyMemory(header +  8, "WAVE", 4);
+    ocCopyMemory(header + 12, "fmt ", 4);
+    ocCopyMemory(header + 16, &fmtSize, 4);
+    ocCopyMemory(header + 20, &formatTag, 2);
+    ocCopyMemory(header + 22, &channels, 2);
+    ocCopyMemory(header + 24, &sampleRate, 4);
+    ocCopyMemory(header + 28, &bytesPerSecond, 4);
+    ocCopyMemory(header + 32, &blockAlign, 2);
+    ocCopyMemory(header + 34, &bitsPerSample, 2);
+    ocCopyMemory(header + 36, &extraSize, 2);
+    ocCopyMemory(header + 38, "fact", 4);
+    ocCopyMemory(header + 42, &factSize, 4);
+    ocCopyMemory(header + 46, &frameCount, 4);
+    ocCopyMemory(header + 50, "data", 4);
+    ocCopyMemory(header + 54, &dataSize, 4);
+
+    result = ocFWrite(pFile, sizeof(header), header, NULL);
+    if (result == OC_SUCCESS) {
+        result = ocFWrite(pFile, dataSize, pFrames, NULL);
+    }
+
+    ocFClose(pFile);
+    return result;
+}
+
+// Renders a scene through the audio world and the mixer as fast as possible, timing each period the same way the device's callback would
+// be timed. The game thread's work is done in between periods on the same thread, so the output is identical from run to run and the
+// checksum can be used to detect changes in the mixer's output.
+OC_PRIVATE ocResult ocBuildBenchmarkAudioRender(int argc, char** argv)
+{
+    ocUInt32 emitterCount = OC_BUILD_BENCHMARK_AUDIO_RENDER_EMITTERS;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-emitters") != NULL) {
+        emitterCount = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-emitters"));
+    }
+
+    ocUInt32 maxRealVoices = OC_AUDIO_DEFAULT_MAX_REAL_VOICES;
+    if (ocCmdLineGetValue(argc, argv, "--audio-real-voices") != NULL) {
+        maxRealVoices = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--audio-real-voices"));
+    }
+
+    const char* outputPath = ocCmdLineGetValue(argc, argv, "--benchmark-output");     // <-- Optional. The output is always kept in memory.
+    const char* maxLoadStr = ocCmdLineGetValue(argc, argv, "--benchmark-max-load");   // <-- Optional. A percentage of the period.
+
+    const ocUInt32 sampleRate  = OC_BUILD_BENCHMARK_AUDIO_SAMPLE_RATE;
+    const ocUInt32 periodSize  = OC_BUILD_BENCHMARK_AUDIO_PERIOD_SIZE;
+    const ocUInt32 periodCount = (OC_BUILD_BENCHMARK_AUDIO_RENDER_SECONDS * sampleRate) / periodSize;
+    const ocUInt32 frameCount  = periodCount * periodSize;
+    const double stepTime      = 1.0 / OC_BUILD_BENCHMARK_AUDIO_RENDER_STEP_RATE;
+
+    // Sounds. The looping sound is one second of noise, and the one-shot is a quarter of a second of a decaying tone.
+    const ocUInt32 loopFrameCount    = sampleRate;
+    const ocUInt32 oneShotFrameCount = sampleRate / 4;
+    float* pSamples = (float*)ocMalloc((loopFrameCount + oneShotFrameCount) * sizeof(float));
+    float* pOutput  = (float*)ocMalloc((ocSizeT)frameCount * OC_AUDIO_MIXER_CHANNELS * sizeof(float));
+    double* pTimes  = (double*)ocMalloc(periodCount * sizeof(double));
+    if (pSamples == NULL || pOutput == NULL || pTimes == NULL) {
+        ocFree(pSamples);
+        ocFree(pOutput);
+        ocFree(pTimes);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocUInt32 seed = 0x12345678;
+    for (ocUInt32 iFrame = 0; iFrame < loopFrameCount; ++iFrame) {
+        seed = seed*1664525 + 1013904223;
+        pSamples[iFrame] = ((seed >> 8) / 8388608.0f) - 1;
+    }
+    for (ocUInt32 iFrame = 0; iFrame < oneShotFrameCount; ++iFrame) {
+        float t = (float)iFrame / sampleRate;
+        pSamples[loopFrameCount + iFrame] = sinf(t * 440 * 2 * 3.14159265f) * (1 - (float)iFrame / oneShotFrameCount);
+    }
+
+    // The world only needs resources for their sound data, so these are set up by hand rather than going through a resource library.
+    ocResource loopSound;
+    ocZeroObject(&loopSound);
+    loopSound.type = ocResourceType_Sound;
+    loopSound.sound.buffer.pFrames    = pSamples;
+    loopSound.sound.buffer.frameCount = loopFrameCount;
+    loopSound.sound.buffer.channels   = 1;
+    loopSound.sound.buffer.sampleRate = 44100;  // <-- Forces resampling for the looping voices, which is the worst case.
+
+    ocResource oneShotSound;
+    ocZeroObject(&oneShotSound);
+    oneShotSound.type = ocResourceType_Sound;
+    oneShotSound.sound.buffer.pFrames    = pSamples + loopFrameCount;
+    oneShotSound.sound.buffer.frameCount = oneShotFrameCount;
+    oneShotSound.sound.buffer.channels   = 1;
+    oneShotSound.sound.buffer.sampleRate = sampleRate;
+
+    ocAudioContext audio;
+    ocResult result = ocAudioInitOffline(sampleRate, OC_AUDIO_DEFAULT_MAX_VOICES, maxRealVoices, &audio);
+    if (result != OC_SUCCESS) {
+        printf("Failed to initialize audio (%d).\n", result);
+        ocFree(pSamples);
+        ocFree(pOutput);
+        ocFree(pTimes);
+        return result;
+    }
+
+    ocAudioWorld world;
+    result = ocAudioWorldInit(&audio, &world);
+    if (result != OC_SUCCESS) {
+        printf("Failed to initialize audio world (%d).\n", result);
+        ocAudioUninit(&audio);
+        ocFree(pSamples);
+        ocFree(pOutput);
+        ocFree(pTimes);
+        return result;
+    }
+
+    ocAudioEmitterID* pLoopEmitters = (ocAudioEmitterID*)ocMalloc(ocMax(emitterCount, 1) * sizeof(ocAudioEmitterID));
+    ocAudioEmitterID oneShotEmitters[OC_BUILD_BENCHMARK_AUDIO_RENDER_ONE_SHOTS];
+    for (ocUInt32 iOneShot = 0; iOneShot < ocCountOf(oneShotEmitters); ++iOneShot) {
+        oneShotEmitters[iOneShot] = OC_AUDIO_EMITTER_NONE;
+    }
+
+    for (ocUInt32 iEmitter = 0; pLoopEmitters != NULL && iEmitter < emitterCount; ++iEmitter) {
+        ocAudioEmitterDesc desc;
+        desc.pSound          = &loopSound;
+        desc.params          = ocAudioVoiceParamsInit();
+        desc.params.gain     = 0.25f;
+        desc.params.priority = iEmitter % 4;
+        desc.params.looping  = OC_TRUE;
+        desc.minDistance     = 1;
+        desc.maxDistance     = 100;
+
+        result = ocAudioWorldCreateEmitter(&world, &desc, ocBuildBenchmarkAudioRender_EmitterPosition(iEmitter, 0), &pLoopEmitters[iEmitter]);
+        if (result != OC_SUCCESS) {
+            break;
+        }
+    }
+
+    if (pLoopEmitters == NULL || result != OC_SUCCESS) {
+        printf("Failed to create emitters (%d).\n", (pLoopEmitters == NULL) ? OC_OUT_OF_MEMORY : result);
+        ocAudioWorldUninit(&world);
+        ocAudioUninit(&audio);
+        ocFree(pLoopEmitters);
+        ocFree(pSamples);
+        ocFree(pOutput);
+        ocFree(pTimes);
+        return (pLoopEmitters == NULL) ? OC_OUT_OF_MEMORY : result;
+    }
+
+    ocUInt64 realVoiceSum    = 0;
+    ocUInt64 virtualVoiceSum = 0;
+    ocUInt32 maxRealVoiceCount    = 0;
+    ocUInt32 maxVirtualVoiceCount = 0;
+    ocUInt32 stepCount = 0;
+    double stepSeconds = 0;
+
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    for (ocUInt32 iPeriod = 0; iPeriod < periodCount; ++iPeriod) {
+        // Game steps that are due before this period starts. The listener walks along the X axis while slowly turning.
+        double periodStartTime = (double)iPeriod * periodSize / sampleRate;
+        while (stepCount * stepTime <= periodStartTime) {
+            double time = stepCount * stepTime;
+
+            ocTimerTick(&timer);
+
+            glm::vec3 listenerPosition = glm::vec3((float)(time * 2) - 30, 0, 0);
+            glm::quat listenerRotation = glm::angleAxis((float)(time * 0.2), glm::vec3(0, 1, 0));
+            ocAudioWorldSetListener(&world, listenerPosition, listenerRotation);
+
+            for (ocUInt32 iEmitter = 0; iEmitter < emitterCount; ++iEmitter) {
+                ocAudioWorldSetEmitterPosition(&world, pLoopEmitters[iEmitter], ocBuildBenchmarkAudioRender_EmitterPosition(iEmitter, time));
+            }
+
+            // A new one-shot every few steps near the listener, replacing the oldest one.
+            if ((stepCount % 4) == 0) {
+                ocUInt32 iOneShot = (stepCount / 4) % ocCountOf(oneShotEmitters);
+                if (oneShotEmitters[iOneShot] != OC_AUDIO_EMITTER_NONE) {
+                    ocAudioWorldDeleteEmitter(&world, oneShotEmitters[iOneShot]);
+                }
+
+                ocAudioEmitterDesc desc;
+                desc.pSound          = &oneShotSound;
+                desc.params          = ocAudioVoiceParamsInit();
+                desc.params.priority = 4;
+                desc.minDistance     = 1;
+                desc.maxDistance     = 50;
+                ocAudioWorldCreateEmitter(&world, &desc, listenerPosition + ocBuildBenchmarkAudioRender_EmitterPosition(stepCount, 0) * 0.25f, &oneShotEmitters[iOneShot]);
+            }
+
+            ocAudioUpdate(&audio);  // <-- Done by ocStep() in the engine.
+            ocAudioWorldStep(&world, stepTime);
+            stepSeconds += ocTimerTick(&timer);
+            stepCount += 1;
+        }
+
+        ocTimerTick(&timer);
+        ocAudioRenderOffline(&audio, pOutput + (ocSizeT)iPeriod*periodSize*OC_AUDIO_MIXER_CHANNELS, periodSize);
+        pTimes[iPeriod] = ocTimerTick(&timer);
+
+        ocUInt32 realVoiceCount    = audio.mixer.realVoiceCount;
+        ocUInt32 virtualVoiceCount = audio.mixer.virtualVoiceCount;
+        realVoiceSum    += realVoiceCount;
+        virtualVoiceSum += virtualVoiceCount;
+        maxRealVoiceCount    = ocMax(maxRealVoiceCount,    realVoiceCount);
+        maxVirtualVoiceCount = ocMax(maxVirtualVoiceCount, virtualVoiceCount);
+    }
+
+    ocUInt32 underrunCount = audio.mixer.underrunCount;
+
+    ocAudioWorldUninit(&world);
+    ocAudioUninit(&audio);
+
+    // FNV-1a over the raw output. Any change to the mixer's output changes this.
+    ocUInt32 checksum = 2166136261U;
+    const ocUInt8* pOutputBytes = (const ocUInt8*)pOutput;
+    for (ocSizeT iByte = 0; iByte < (ocSizeT)frameCount * OC_AUDIO_MIXER_CHANNELS * sizeof(float); ++iByte) {
+        checksum = (checksum ^ pOutputBytes[iByte]) * 16777619U;
+    }
+
+    double totalSeconds = 0;
+    for (ocUInt32 iPeriod = 0; iPeriod < periodCount; ++iPeriod) {
+        totalSeconds += pTimes[iPeriod];
+    }
+
+    qsort(pTimes, periodCount, sizeof(double), ocBuildBenchmarkAudioRender_CompareDouble);
+
+    double periodMilliseconds = (periodSize * 1000.0) / sampleRate;
+    double p50 = pTimes[(periodCount - 1) * 50 / 100] * 1000;
+    double p90 = pTimes[(periodCount - 1) * 90 / 100] * 1000;
+    double p99 = pTimes[(periodCount - 1) * 99 / 100] * 1000;
+    double p100 = pTimes[periodCount - 1] * 1000;
+    double load = (p99 / periodMilliseconds) * 100;
+
+    printf("Audio render (%u Hz, %u frame periods, %u seconds, %u emitters, %u real voices):\n", sampleRate, periodSize, OC_BUILD_BENCHMARK_AUDIO_RENDER_SECONDS, emitterCount, maxRealVoices);
+    printf("  %-44s %10.1fx real time\n", "Speed", OC_BUILD_BENCHMARK_AUDIO_RENDER_SECONDS / (totalSeconds + stepSeconds));
+    printf("  %-44s %10.3f ms\n", "Callback p50", p50);
+    printf("  %-44s %10.3f ms\n", "Callback p90", p90);
+    printf("  %-44s %10.3f ms\n", "Callback p99", p99);
+    printf("  %-44s %10.3f ms\n", "Callback max", p100);
+    printf("  %-44s %10.1f %% (p99 load %.1f %% of %.3f ms)\n", "Headroom", 100 - load, load, periodMilliseconds);
+    printf("  %-44s %10.3f ms\n", "Game step average", (stepSeconds * 1000) / ocMax(stepCount, 1));
+    printf("  %-44s %10.1f (max %u)\n", "Real voices average", (double)realVoiceSum / periodCount, maxRealVoiceCount);
+    printf("  %-44s %10.1f (max %u)\n", "Virtual voices average", (double)virtualVoiceSum / periodCount, maxVirtualVoiceCount);
+    printf("  %-44s %10u\n", "Underruns", underrunCount);
+    printf("  %-44s   %08X\n", "Output checksum", checksum);
+
+    result = OC_SUCCESS;
+    if (outputPath != NULL) {
+        result = ocBuildBenchmarkAudioRender_WriteWAV(outputPath, pOutput, frameCount, sampleRate);
+        if (result != OC_SUCCESS) {
+            printf("Failed to write %s (%d).\n", outputPath, result);
+        }
+    }
+
+    // CI uses this to fail the build when the callback gets too slow.
+    if (result == OC_SUCCESS && maxLoadStr != NULL && load > atof(maxLoadStr)) {
+        printf("p99 load of %.1f %% exceeds the maximum of %s %%.\n", load, maxLoadStr);
+        result = OC_ERROR;
+    }
+
+    ocFree(pLoopEmitters);
+    ocFree(pSamples);
+    ocFree(pOutput);
+    ocFree(pTimes);
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Raycast
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_BUILD_BENCHMARK_RAYCAST_GRID_SIZE        512             // <-- Quads along each side of the terrain, with two triangles each.
+#define OC_BUILD_BENCHMARK_RAYCAST_RAY_COUNT        (1024*1024)
+#define OC_BUILD_BENCHMARK_RAYCAST_SWEEP_DIVISOR    16              // <-- There are this many times fewer sweeps than rays.
+
+OC_PRIVATE float ocBuildBenchmarkRaycast_TerrainHeight(float x, float z)
+{
+    return sinf(x*0.05f)*8 + cosf(z*0.037f)*6 + sinf((x + z)*0.21f)*1.5f;
+}
+
+OC_PRIVATE float ocBuildBenchmarkRaycast_Random(ocUInt32* pSeed)
+{
+    *pSeed = (*pSeed)*1664525 + 1013904223;
+    return (*pSeed >> 8) / 16777216.0f;
+}
+
+// The terrain is put into the data of an OCD mesh component, which is where the triangle mesh is created from. This is the same path
+// that level geometry takes when it's loaded.
+OC_PRIVATE ocResult ocBuildBenchmarkRaycast_BuildTerrain(ocUInt32 gridSize, ocOCDSceneBuilder* pBuilder, const void** ppMeshComponentData)
+{
+    const ocUInt32 vertexSize  = 8;     // <-- ocGraphicsVertexFormat_P3T2N3.
+    const ocUInt32 vertexCount = (gridSize + 1) * (gridSize + 1);
+    const ocUInt32 indexCount  = gridSize * gridSize * 6;
+
+    float* pVertices = (float*)ocMalloc(vertexCount * vertexSize * sizeof(float));
+    ocUInt32* pIndices = (ocUInt32*)ocMalloc(indexCount * sizeof(ocUInt32));
+    if (pVertices == NULL || pIndices == NULL) {
+        ocFree(pVertices);
+        ocFree(pIndices);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    for (ocUInt32 z = 0; z <= gridSize; ++z) {
+        for (ocUInt32 x = 0; x <= gridSize; ++x) {
+            float* pVertex = pVertices + (z*(gridSize + 1) + x)*vertexSize;
+            pVertex[0] = (float)x;
+            pVertex[1] = ocBuildBenchmarkRaycast_TerrainHeight((float)x, (float)z);
+            pVertex[2] = (float)z;
+            pVertex[3] = (float)x / gridSize;
+            pVertex[4] = (float)z / gridSize;
+            pVertex[5] = 0;
+            pVertex[6] = 1;
+            pVertex[7] = 0;
+        }
+    }
+
+    ocUInt32* pIndex = pIndices;
+    for (ocUInt32 z = 0; z < gridSize; ++z) {
+        for (ocUInt32 x = 0; x < gridSize; ++x) {
+            ocUInt32 i0 = z*(gridSize + 1) + x;
+            ocUInt32 i1 = i0 + 1;
+            ocUInt32 i2 = i0 + (gridSize + 1);
+            ocUInt32 i3 = i2 + 1;
+            *pIndex++ = i0; *pIndex++ = i2; *pIndex++ = i1;
+            *pIndex++ = i1; *pIndex++ = i2; *pIndex++ = i3;
+        }
+    }
+
+    ocResult result = ocOCDSceneBuilderInit(pBuilder);
+    if (result != OC_SUCCESS) {
+        ocFree(pVertices);
+        ocFree(pIndices);
+        return result;
+    }
+
+    result = ocOCDSceneBuilderBeginObject(pBuilder, "Terrain", glm::vec3(0, 0, 0), glm::quat(1, 0, 0, 0), glm::vec3(1, 1, 1));
+    if (result == OC_SUCCESS) {
+        result = ocOCDSceneBuilderBeginMeshComponent(pBuilder);
+        if (result == OC_SUCCESS) {
+            result = ocOCDSceneBuilderMeshComponentAddGroup(pBuilder, "engine/materials/default.ocmat", ocGraphicsPrimitiveType_Triangle, ocGraphicsVertexFormat_P3T2N3, vertexCount, pVertices, indexCount, pIndices);
+            ocOCDSceneBuilderEndMeshComponent(pBuilder);
+        }
+        ocOCDSceneBuilderEndObject(pBuilder);
+    }
+
+    ocFree(pVertices);
+    ocFree(pIndices);
+
+    if (result != OC_SUCCESS || pBuilder->components.count == 0) {
+        ocOCDSceneBuilderUninit(pBuilder);
+        return (result != OC_SUCCESS) ? result : OC_ERROR;
+    }
+
+    *ppMeshComponentData = (const ocUInt8*)pBuilder->componentDataBlock.pData + pBuilder->components.pItems[0].dataOffset;
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE void ocBuildBenchmarkRaycast_PrintHits(const char* name, ocResult result, ocUInt32 count, const ocDynamicsHit* pHits, double seconds)
+{
+    if (result != OC_SUCCESS) {
+        printf("  %-44s failed (%d)\n", name, result);
+        return;
+    }
+
+    ocUInt32 hitCount = 0;
+    for (ocUInt32 iHit = 0; iHit < count; ++iHit) {
+        if (pHits[iHit].bodyID != OC_DYNAMICS_BODY_NONE) {
+            hitCount += 1;
+        }
+    }
+
+    printf("  %-44s %10.2f M/s (%.1f %% hit)\n", name, (count / 1000000.0) / seconds, (hitCount * 100.0) / ocMax(count, 1));
+}
+
+// Runs every query against a world with one static terrain body. Each batch is run once before it's timed so that the query tree is
+// built and the memory is warm.
+OC_PRIVATE ocResult ocBuildBenchmarkRaycast_Run(const char* name, ocJobQueue* pJobQueue, const ocTriangleMesh* pMesh, const ocDynamicsRay* pRays, const ocDynamicsRay* pGrazingRays, ocUInt32 rayCount, const ocDynamicsSweep* pSweeps, ocUInt32 sweepCount, ocDynamicsHit* pHits)
+{
+    ocDynamicsWorld world;
+    ocResult result = ocDynamicsWorldInit(pJobQueue, &world);
+    if (result != OC_SUCCESS) {
+        printf("  %-44s failed (%d)\n", name, result);
+        return result;
+    }
+
+    ocDynamicsBodyDesc desc = ocDynamicsBodyDescInit();
+    desc.type  = ocDynamicsBodyType_Static;
+    desc.shape = ocCollisionShapeTriangleMesh(pMesh);
+
+    ocDynamicsBodyID bodyID;
+    result = ocDynamicsWorldCreateBody(&world, &desc, glm::vec3(0, 0, 0), glm::quat(1, 0, 0, 0), &bodyID);
+    if (result != OC_SUCCESS) {
+        ocDynamicsWorldUninit(&world);
+        printf("  %-44s failed (%d)\n", name, result);
+        return result;
+    }
+
+    char label[256];
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    snprintf(label, sizeof(label), "Rays (downwards), %s", name);
+    ocDynamicsWorldRaycast(&world, pRays, rayCount, pHits);
+    ocTimerTick(&timer);
+    result = ocDynamicsWorldRaycast(&world, pRays, rayCount, pHits);
+    ocBuildBenchmarkRaycast_PrintHits(label, result, rayCount, pHits, ocTimerTick(&timer));
+
+    snprintf(label, sizeof(label), "Rays (grazing), %s", name);
+    ocDynamicsWorldRaycast(&world, pGrazingRays, rayCount, pHits);
+    ocTimerTick(&timer);
+    result = ocDynamicsWorldRaycast(&world, pGrazingRays, rayCount, pHits);
+    ocBuildBenchmarkRaycast_PrintHits(label, result, rayCount, pHits, ocTimerTick(&timer));
+
+    snprintf(label, sizeof(label), "Sphere sweeps, %s", name);
+    ocDynamicsWorldSweep(&world, pSweeps, sweepCount, pHits);
+    ocTimerTick(&timer);
+    result = ocDynamicsWorldSweep(&world, pSweeps, sweepCount, pHits);
+    ocBuildBenchmarkRaycast_PrintHits(label, result, sweepCount, pHits, ocTimerTick(&timer));
+
+    ocDynamicsWorldUninit(&world);
+    return result;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkRaycast(int argc, char** argv)
+{
+    ocUInt32 gridSize = OC_BUILD_BENCHMARK_RAYCAST_GRID_SIZE;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-grid") != NULL) {
+        gridSize = ocMax((ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-grid")), 1U);
+    }
+
+    ocUInt32 rayCount = OC_BUILD_BENCHMARK_RAYCAST_RAY_COUNT;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-rays") != NULL) {
+        rayCount = ocMax((ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-rays")), 1U);
+    }
+
+    // One core is left for the calling thread, which also runs jobs while it waits. The same as the engine.
+    ocUInt32 threadCount = ocMax(ocGetLogicalProcessorCount(), 2U) - 1;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-threads") != NULL) {
+        threadCount = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-threads"));
+    }
+
+    ocUInt32 sweepCount = ocMax(rayCount / OC_BUILD_BENCHMARK_RAYCAST_SWEEP_DIVISOR, 1U);
+
+    ocDynamicsRay* pRays         = (ocDynamicsRay*)ocMalloc(rayCount * sizeof(ocDynamicsRay));
+    ocDynamicsRay* pGrazingRays  = (ocDynamicsRay*)ocMalloc(rayCount * sizeof(ocDynamicsRay));
+    ocDynamicsSweep* pSweeps     = (ocDynamicsSweep*)ocMalloc(sweepCount * sizeof(ocDynamicsSweep));
+    ocDynamicsHit* pHits         = (ocDynamicsHit*)ocMalloc(rayCount * sizeof(ocDynamicsHit));
+    if (pRays == NULL || pGrazingRays == NULL || pSweeps == NULL || pHits == NULL) {
+        ocFree(pRays);
+        ocFree(pGrazingRays);
+        ocFree(pSweeps);
+        ocFree(pHits);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    // Downward rays are what most gameplay queries look like, such as finding the ground under a character. Grazing rays skim the
+    // surface from the side and pass through far more of the tree, which is the worst case, such as line of sight checks.
+    const float size = (float)gridSize;
+    ocUInt32 seed = 0x12345678;
+    for (ocUInt32 iRay = 0; iRay < rayCount; ++iRay) {
+        glm::vec3 origin    = glm::vec3(ocBuildBenchmarkRaycast_Random(&seed)*size, 40, ocBuildBenchmarkRaycast_Random(&seed)*size);
+        glm::vec3 direction = glm::vec3(ocBuildBenchmarkRaycast_Random(&seed) - 0.5f, -1, ocBuildBenchmarkRaycast_Random(&seed) - 0.5f);
+        pRays[iRay] = ocDynamicsRayInit(origin, direction, 100);
+
+        float angle = ocBuildBenchmarkRaycast_Random(&seed) * 6.2831853f;
+        origin    = glm::vec3(ocBuildBenchmarkRaycast_Random(&seed)*size, 0, ocBuildBenchmarkRaycast_Random(&seed)*size);
+        origin.y  = ocBuildBenchmarkRaycast_TerrainHeight(origin.x, origin.z) + 2;
+        direction = glm::vec3(cosf(angle), (ocBuildBenchmarkRaycast_Random(&seed) - 0.5f) * 0.1f, sinf(angle));
+        pGrazingRays[iRay] = ocDynamicsRayInit(origin, direction, size * 0.25f);
+    }
+
+    for (ocUInt32 iSweep = 0; iSweep < sweepCount; ++iSweep) {
+        glm::vec3 origin    = glm::vec3(ocBuildBenchmarkRaycast_Random(&seed)*size, 40, ocBuildBenchmarkRaycast_Random(&seed)*size);
+        glm::vec3 direction = glm::vec3(ocBuildBenchmarkRaycast_Random(&seed) - 0.5f, -1, ocBuildBenchmarkRaycast_Random(&seed) - 0.5f);
+        pSweeps[iSweep] = ocDynamicsSweepInit(ocCollisionShapeSphere(0.5f), origin, glm::quat(1, 0, 0, 0), direction, 100);
+    }
+
+    ocOCDSceneBuilder builder;
+    const void* pMeshComponentData;
+    ocResult result = ocBuildBenchmarkRaycast_BuildTerrain(gridSize, &builder, &pMeshComponentData);
+    if (result != OC_SUCCESS) {
+        printf("Failed to build terrain (%d).\n", result);
+        ocFree(pRays);
+        ocFree(pGrazingRays);
+        ocFree(pSweeps);
+        ocFree(pHits);
+        return result;
+    }
+
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    ocTriangleMesh mesh;
+    result = ocTriangleMeshInitFromOCD(pMeshComponentData, &mesh);
+    double meshSeconds = ocTimerTick(&timer);
+
+    ocOCDSceneBuilderUninit(&builder);
+
+    if (result != OC_SUCCESS) {
+        printf("Failed to create triangle mesh (%d).\n", result);
+        ocFree(pRays);
+        ocFree(pGrazingRays);
+        ocFree(pSweeps);
+        ocFree(pHits);
+        return result;
+    }
+
+    printf("Raycast (%u triangles, %u rays, %u sweeps, %u threads):\n", mesh.triangleCount, rayCount, sweepCount, threadCount + 1);
+    printf("  %-44s %10.1f ms (%u nodes, %u leaves)\n", "Mesh build", meshSeconds * 1000, (ocUInt32)mesh.bvh.nodes.count, mesh.bvh.leafCount);
+
+    result = ocBuildBenchmarkRaycast_Run("1 thread", NULL, &mesh, pRays, pGrazingRays, rayCount, pSweeps, sweepCount, pHits);
+
+    if (result == OC_SUCCESS && threadCount > 0) {
+        ocJobQueue jobQueue;
+        result = ocJobQueueInit(threadCount, &jobQueue);
+        if (result == OC_SUCCESS) {
+            char name[64];
+            snprintf(name, sizeof(name), "%u threads", threadCount + 1);
+            result = ocBuildBenchmarkRaycast_Run(name, &jobQueue, &mesh, pRays, pGrazingRays, rayCount, pSweeps, sweepCount, pHits);
+            ocJobQueueUninit(&jobQueue);
+        } else {
+            printf("Failed to initialize job queue (%d).\n", result);
+        }
+    }
+
+    ocTriangleMeshUninit(&mesh);
+    ocFree(pRays);
+    ocFree(pGrazingRays);
+    ocFree(pSweeps);
+    ocFree(pHits);
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Dynamics
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_BUILD_BENCHMARK_DYNAMICS_BODY_COUNT      100000
+#define OC_BUILD_BENCHMARK_DYNAMICS_ACTIVE_COUNT    1000    // <-- Spheres dropped onto the resting bodies.
+#define OC_BUILD_BENCHMARK_DYNAMICS_DT              (1.0/60)
+#define OC_BUILD_BENCHMARK_DYNAMICS_MAX_SETTLE      600     // <-- The most steps to wait for everything to fall asleep.
+#define OC_BUILD_BENCHMARK_DYNAMICS_ACTIVE_STEPS    180
+#define OC_BUILD_BENCHMARK_DYNAMICS_AWAKE_STEPS     10      // <-- Steps with sleeping disabled. Kept short since every body is simulated.
+
+OC_PRIVATE void ocBuildBenchmarkDynamics_PrintSteps(const char* name, ocUInt32 stepCount, double seconds, ocUInt64 awakeBodySum)
+{
+    printf("  %-44s %10.3f ms/step (%u steps, %.0f awake bodies on average)\n", name, (seconds * 1000) / ocMax(stepCount, 1U), stepCount, (double)awakeBodySum / ocMax(stepCount, 1U));
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkDynamics(int argc, char** argv)
+{
+    ocUInt32 bodyCount = OC_BUILD_BENCHMARK_DYNAMICS_BODY_COUNT;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-bodies") != NULL) {
+        bodyCount = ocMax((ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-bodies")), 1U);
+    }
+
+    ocUInt32 activeCount = OC_BUILD_BENCHMARK_DYNAMICS_ACTIVE_COUNT;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-active") != NULL) {
+        activeCount = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-active"));
+    }
+
+    ocUInt32 threadCount = ocMax(ocGetLogicalProcessorCount(), 2U) - 1;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-threads") != NULL) {
+        threadCount = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-threads"));
+    }
+
+    ocJobQueue jobQueue;
+    ocJobQueue* pJobQueue = NULL;
+    if (threadCount > 0) {
+        ocResult result = ocJobQueueInit(threadCount, &jobQueue);
+        if (result != OC_SUCCESS) {
+            printf("Failed to initialize job queue (%d).\n", result);
+            return result;
+        }
+
+        pJobQueue = &jobQueue;
+    }
+
+    ocDynamicsWorld world;
+    ocResult result = ocDynamicsWorldInit(pJobQueue, &world);
+    if (result != OC_SUCCESS) {
+        printf("Failed to initialize dynamics world (%d).\n", result);
+        if (pJobQueue != NULL) {
+            ocJobQueueUninit(pJobQueue);
+        }
+        return result;
+    }
+
+    printf("Dynamics (%u resting bodies, %u dropped, %u threads):\n", bodyCount, activeCount, threadCount + 1);
+
+    // The debris is a grid of small boxes and spheres lying on one big static box, each exactly touching the ground so they settle
+    // straight away. They're far enough apart that each one is it's own island, which is the common case for open levels.
+    const ocUInt32 gridSize = (ocUInt32)ceil(sqrt((double)bodyCount));
+    const float spacing = 1.0f;
+    const float halfSize = gridSize * spacing * 0.5f;
+
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    ocDynamicsBodyDesc desc = ocDynamicsBodyDescInit();
+    desc.type  = ocDynamicsBodyType_Static;
+    desc.shape = ocCollisionShapeBox(glm::vec3(halfSize + 2, 1, halfSize + 2));
+
+    ocDynamicsBodyID bodyID;
+    result = ocDynamicsWorldCreateBody(&world, &desc, glm::vec3(0, -1, 0), glm::quat(1, 0, 0, 0), &bodyID);
+
+    ocDynamicsBodyDesc boxDesc = ocDynamicsBodyDescInit();
+    boxDesc.shape = ocCollisionShapeBox(glm::vec3(0.25f, 0.25f, 0.25f));
+
+    ocDynamicsBodyDesc sphereDesc = ocDynamicsBodyDescInit();
+    sphereDesc.shape = ocCollisionShapeSphere(0.25f);
+
+    for (ocUInt32 iBody = 0; iBody < bodyCount && result == OC_SUCCESS; ++iBody) {
+        glm::vec3 position = glm::vec3((iBody % gridSize) * spacing - halfSize, 0.25f, (iBody / gridSize) * spacing - halfSize);
+        result = ocDynamicsWorldCreateBody(&world, ((iBody % 3) == 0) ? &sphereDesc : &boxDesc, position, glm::quat(1, 0, 0, 0), &bodyID);
+    }
+
+    if (result != OC_SUCCESS) {
+        printf("Failed to create bodies (%d).\n", result);
+        ocDynamicsWorldUninit(&world);
+        if (pJobQueue != NULL) {
+            ocJobQueueUninit(pJobQueue);
+        }
+        return result;
+    }
+
+    printf("  %-44s %10.1f ms\n", "Create bodies", ocTimerTick(&timer) * 1000);
+
+    // Settling. Everything starts awake and is simulated until it's all asleep.
+    ocUInt32 stepCount = 0;
+    ocUInt64 awakeBodySum = 0;
+    ocTimerTick(&timer);
+    while (world.awakeBodyCount > 0 && stepCount < OC_BUILD_BENCHMARK_DYNAMICS_MAX_SETTLE) {
+        awakeBodySum += world.awakeBodyCount;
+        ocDynamicsWorldStep(&world, OC_BUILD_BENCHMARK_DYNAMICS_DT);
+        stepCount += 1;
+    }
+    ocBuildBenchmarkDynamics_PrintSteps("Settle until asleep", stepCount, ocTimerTick(&timer), awakeBodySum);
+
+    if (world.awakeBodyCount > 0) {
+        printf("  %u bodies are still awake after %u steps.\n", world.awakeBodyCount, stepCount);
+    }
+
+    // Everything at rest, which should cost next to nothing no matter how many bodies there are.
+    ocTimerTick(&timer);
+    for (ocUInt32 iStep = 0; iStep < 60; ++iStep) {
+        ocDynamicsWorldStep(&world, OC_BUILD_BENCHMARK_DYNAMICS_DT);
+    }
+    ocBuildBenchmarkDynamics_PrintSteps("Everything asleep", 60, ocTimerTick(&timer), 0);
+
+    // Spheres are dropped from different heights all over the grid so that bodies keep being woken and put back to sleep.
+    ocUInt32 seed = 0x12345678;
+    ocDynamicsBodyDesc dropDesc = ocDynamicsBodyDescInit();
+    dropDesc.shape       = ocCollisionShapeSphere(0.4f);
+    dropDesc.restitution = 0.3f;
+    for (ocUInt32 iDrop = 0; iDrop < activeCount && result == OC_SUCCESS; ++iDrop) {
+        glm::vec3 position = glm::vec3((ocBuildBenchmarkRaycast_Random(&seed) - 0.5f) * halfSize * 2, 1 + ocBuildBenchmarkRaycast_Random(&seed) * 10, (ocBuildBenchmarkRaycast_Random(&seed) - 0.5f) * halfSize * 2);
+        result = ocDynamicsWorldCreateBody(&world, &dropDesc, position, glm::quat(1, 0, 0, 0), &bodyID);
+    }
+
+    if (result == OC_SUCCESS) {
+        awakeBodySum = 0;
+        ocTimerTick(&timer);
+        for (ocUInt32 iStep = 0; iStep < OC_BUILD_BENCHMARK_DYNAMICS_ACTIVE_STEPS; ++iStep) {
+            awakeBodySum += world.awakeBodyCount;
+            ocDynamicsWorldStep(&world, OC_BUILD_BENCHMARK_DYNAMICS_DT);
+        }
+        ocBuildBenchmarkDynamics_PrintSteps("Dropped spheres", OC_BUILD_BENCHMARK_DYNAMICS_ACTIVE_STEPS, ocTimerTick(&timer), awakeBodySum);
+
+        // The same world with every body simulated, for comparison.
+        ocDynamicsWorldEnableSleeping(&world, OC_FALSE);
+        awakeBodySum = 0;
+        ocTimerTick(&timer);
+        for (ocUInt32 iStep = 0; iStep < OC_BUILD_BENCHMARK_DYNAMICS_AWAKE_STEPS; ++iStep) {
+            awakeBodySum += world.awakeBodyCount;
+            ocDynamicsWorldStep(&world, OC_BUILD_BENCHMARK_DYNAMICS_DT);
+        }
+        ocBuildBenchmarkDynamics_PrintSteps("Sleeping disabled", OC_BUILD_BENCHMARK_DYNAMICS_AWAKE_STEPS, ocTimerTick(&timer), awakeBodySum);
+    } else {
+        printf("Failed to create bodies (%d).\n", result);
+    }
+
+    ocDynamicsWorldUninit(&world);
+    if (pJobQueue != NULL) {
+        ocJobQueueUninit(pJobQueue);
+    }
+
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Math
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_BUILD_BENCHMARK_MATH_TRANSFORM_COUNT     65536
+#define OC_BUILD_BENCHMARK_MATH_PASSES              100
+
+#define OC_BUILD_BENCHMARK_MATH_KERNEL_MAKE_MAT4        0
+#define OC_BUILD_BENCHMARK_MATH_KERNEL_QUAT_MULTIPLY    1
+#define OC_BUILD_BENCHMARK_MATH_KERNEL_ABSOLUTE         2
+#define OC_BUILD_BENCHMARK_MATH_KERNEL_INVERSE_AFFINE   3
+#define OC_BUILD_BENCHMARK_MATH_KERNEL_COUNT            4
+
+// The same transforms are stored both as arrays of glm types, which is what the glm path works on, and as structures of arrays for the
+// batched functions.
+struct ocBuildBenchmarkMathData
+{
+    ocUInt32 count;
+
+    glm::vec3* pPositions;
+    glm::quat* pRotations;
+    glm::vec3* pScales;
+    glm::vec3* pParentPositions;
+    glm::quat* pParentRotations;
+    glm::vec3* pParentScales;
+    glm::mat4* pMatrices;           // <-- The input to the inverse, built from the transforms up front.
+
+    glm::vec3* pResultPositions;
+    glm::quat* pResultRotations;
+    glm::vec3* pResultScales;
+    glm::mat4* pResultMatrices;
+
+    ocTransformArray transforms;
+    ocTransformArray parents;
+    ocTransformArray resultTransforms;
+    glm::mat4* pBatchedMatrices;
+};
+
+// The arrays are padded so they don't all start at the same offset within a page, which would make loads from one array falsely depend on
+// stores to another.
+#define OC_BUILD_BENCHMARK_MATH_ARRAY_PADDING       16
+
+OC_PRIVATE float* ocBuildBenchmarkMath_CarveFloats(float** ppNext, ocUInt32 count)
+{
+    float* pFloats = *ppNext;
+    *ppNext += count + OC_BUILD_BENCHMARK_MATH_ARRAY_PADDING;
+    return pFloats;
+}
+
+OC_PRIVATE void ocBuildBenchmarkMath_CarveTransforms(float** ppNext, ocUInt32 count, ocTransformArray* pTransforms)
+{
+    pTransforms->position.pX = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->position.pY = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->position.pZ = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->rotation.pX = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->rotation.pY = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->rotation.pZ = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->rotation.pW = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->scale.pX    = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->scale.pY    = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+    pTransforms->scale.pZ    = ocBuildBenchmarkMath_CarveFloats(ppNext, count);
+}
+
+OC_PRIVATE void ocBuildBenchmarkMath_RandomTransform(ocUInt32* pSeed, glm::vec3* pPosition, glm::quat* pRotation, glm::vec3* pScale)
+{
+    *pPosition = glm::vec3(ocBuildBenchmarkRaycast_Random(pSeed), ocBuildBenchmarkRaycast_Random(pSeed), ocBuildBenchmarkRaycast_Random(pSeed)) * 200.0f - 100.0f;
+    *pRotation = glm::normalize(glm::quat(ocBuildBenchmarkRaycast_Random(pSeed) - 0.5f, ocBuildBenchmarkRaycast_Random(pSeed) - 0.5f, ocBuildBenchmarkRaycast_Random(pSeed) - 0.5f, ocBuildBenchmarkRaycast_Random(pSeed) - 0.5f));
+    *pScale    = glm::vec3(ocBuildBenchmarkRaycast_Random(pSeed), ocBuildBenchmarkRaycast_Random(pSeed), ocBuildBenchmarkRaycast_Random(pSeed)) * 1.5f + 0.5f;
+}
+
+OC_PRIVATE void ocBuildBenchmarkMath_StoreTransform(ocTransformArray* pTransforms, ocUInt32 index, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale)
+{
+    pTransforms->position.pX[index] = position.x;
+    pTransforms->position.pY[index] = position.y;
+    pTransforms->position.pZ[index] = position.z;
+    pTransforms->rotation.pX[index] = rotation.x;
+    pTransforms->rotation.pY[index] = rotation.y;
+    pTransforms->rotation.pZ[index] = rotation.z;
+    pTransforms->rotation.pW[index] = rotation.w;
+    pTransforms->scale.pX[index]    = scale.x;
+    pTransforms->scale.pY[index]    = scale.y;
+    pTransforms->scale.pZ[index]    = scale.z;
+}
+
+OC_PRIVATE void ocBuildBenchmarkMath_RunGLM(ocBuildBenchmarkMathData* pData, ocUInt32 kernel)
+{
+    switch (kernel)
+    {
+        case OC_BUILD_BENCHMARK_MATH_KERNEL_MAKE_MAT4:
+        {
+            for (ocUInt32 i = 0; i < pData->count; ++i) {
+                pData->pResultMatrices[i] = ocMakeMat4(pData->pPositions[i], pData->pRotations[i], pData->pScales[i]);
+            }
+        } break;
+
+        case OC_BUILD_BENCHMARK_MATH_KERNEL_QUAT_MULTIPLY:
+        {
+            for (ocUInt32 i = 0; i < pData->count; ++i) {
+                pData->pResultRotations[i] = pData->pParentRotations[i] * pData->pRotations[i];
+            }
+        } break;
+
+        case OC_BUILD_BENCHMARK_MATH_KERNEL_ABSOLUTE:
+        {
+            for (ocUInt32 i = 0; i < pData->count; ++i) {
+                pData->pResultPositions[i] = ocMakeAbsolutePosition(pData->pPositions[i], pData->pParentPositions[i]);
+                pData->pResultRotations[i] = ocMakeAbsoluteRotation(pData->pRotations[i], pData->pParentRotations[i]);
+                pData->pResultScales[i]    = ocMakeAbsoluteScale(pData->pScales[i], pData->pParentScales[i]);
+            }
+        } break;
+
+        case OC_BUILD_BENCHMARK_MATH_KERNEL_INVERSE_AFFINE:
+        {
+            for (ocUInt32 i = 0; i < pData->count; ++i) {
+                pData->pResultMatrices[i] = glm::affineInverse(pData->pMatrices[i]);
+            }
+        } break;
+
+        default: break;
+    }
+}
+
+OC_PRIVATE void ocBuildBenchmarkMath_RunBatched(ocBuildBenchmarkMathData* pData, ocUInt32 kernel)
+{
+    switch (kernel)
+    {
+        case OC_BUILD_BENCHMARK_MATH_KERNEL_MAKE_MAT4:      ocMakeMat4Array(&pData->transforms, pData->count, pData->pBatchedMatrices); break;
+        case OC_BUILD_BENCHMARK_MATH_KERNEL_QUAT_MULTIPLY:  ocQuatMultiplyArray(&pData->parents.rotation, &pData->transforms.rotation, pData->count, &pData->resultTransforms.rotation); break;
+        case OC_BUILD_BENCHMARK_MATH_KERNEL_ABSOLUTE:       ocMakeAbsoluteTransformArray(&pData->transforms, &pData->parents, pData->count, &pData->resultTransforms); break;
+        case OC_BUILD_BENCHMARK_MATH_KERNEL_INVERSE_AFFINE: ocInverseAffineMat4Array(pData->pMatrices, pData->count, pData->pBatchedMatrices); break;
+        default: break;
+    }
+}
+
+// The largest difference between the results of the glm path and the batched path. Both paths need to have been run.
+OC_PRIVATE float ocBuildBenchmarkMath_MaxError(const ocBuildBenchmarkMathData* pData, ocUInt32 kernel)
+{
+    float maxError = 0;
+    for (ocUInt32 i = 0; i < pData->count; ++i) {
+        if (kernel == OC_BUILD_BENCHMARK_MATH_KERNEL_MAKE_MAT4 || kernel == OC_BUILD_BENCHMARK_MATH_KERNEL_INVERSE_AFFINE) {
+            for (int iColumn = 0; iColumn < 4; ++iColumn) {
+                for (int iRow = 0; iRow < 4; ++iRow) {
+                    maxError = ocMax(maxError, fabsf(pData->pResultMatrices[i][iColumn][iRow] - pData->pBatchedMatrices[i][iColumn][iRow]));
+                }
+            }
+        } else {
+            const ocTransformArray* pResult = &pData->resultTransforms;
+            maxError = ocMax(maxError, fabsf(pData->pResultRotations[i].x - pResult->rotation.pX[i]));
+            maxError = ocMax(maxError, fabsf(pData->pResultRotations[i].y - pResult->rotation.pY[i]));
+            maxError = ocMax(maxError, fabsf(pData->pResultRotations[i].z - pResult->rotation.pZ[i]));
+            maxError = ocMax(maxError, fabsf(pData->pResultRotations[i].w - pResult->rotation.pW[i]));
+
+            if (kernel == OC_BUILD_BENCHMARK_MATH_KERNEL_ABSOLUTE) {
+                maxError = ocMax(maxError, fabsf(pData->pResultPositions[i].x - pResult->position.pX[i]));
+                maxError = ocMax(maxError, fabsf(pData->pResultPositions[i].y - pResult->position.pY[i]));
+                maxError = ocMax(maxError, fabsf(pData->pResultPositions[i].z - pResult->position.pZ[i]));
+                maxError = ocMax(maxError, fabsf(pData->pResultScales[i].x - pResult->scale.pX[i]));
+                maxError = ocMax(maxError, fabsf(pData->pResultScales[i].y - pResult->scale.pY[i]));
+                maxError = ocMax(maxError, fabsf(pData->pResultScales[i].z - pResult->scale.pZ[i]));
+            }
+        }
+    }
+
+    return maxError;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkMath(int argc, char** argv)
+{
+    ocUInt32 count = OC_BUILD_BENCHMARK_MATH_TRANSFORM_COUNT;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-transforms") != NULL) {
+        count = ocMax((ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-transforms")), 1U);
+    }
+
+    // Everything is carved out of a single allocation.
+    ocSizeT sizePerTransform = sizeof(glm::mat4)*3 + sizeof(glm::quat)*3 + sizeof(glm::vec3)*6 + sizeof(float)*10*3;
+    void* pMemory = ocMalloc(sizePerTransform*count + sizeof(float)*10*3*OC_BUILD_BENCHMARK_MATH_ARRAY_PADDING);
+    if (pMemory == NULL) {
+        printf("Out of memory.\n");
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocBuildBenchmarkMathData data;
+    data.count = count;
+    data.pMatrices          = (glm::mat4*)pMemory;
+    data.pResultMatrices    = data.pMatrices + count;
+    data.pBatchedMatrices   = data.pResultMatrices + count;
+    data.pRotations         = (glm::quat*)(data.pBatchedMatrices + count);
+    data.pParentRotations   = data.pRotations + count;
+    data.pResultRotations   = data.pParentRotations + count;
+    data.pPositions         = (glm::vec3*)(data.pResultRotations + count);
+    data.pScales            = data.pPositions + count;
+    data.pParentPositions   = data.pScales + count;
+    data.pParentScales      = data.pParentPositions + count;
+    data.pResultPositions   = data.pParentScales + count;
+    data.pResultScales      = data.pResultPositions + count;
+
+    float* pNextFloat = (float*)(data.pResultScales + count);
+    ocBuildBenchmarkMath_CarveTransforms(&pNextFloat, count, &data.transforms);
+    ocBuildBenchmarkMath_CarveTransforms(&pNextFloat, count, &data.parents);
+    ocBuildBenchmarkMath_CarveTransforms(&pNextFloat, count, &data.resultTransforms);
+
+    ocUInt32 seed = 0x12345678;
+    for (ocUInt32 i = 0; i < count; ++i) {
+        ocBuildBenchmarkMath_RandomTransform(&seed, &data.pPositions[i], &data.pRotations[i], &data.pScales[i]);
+        ocBuildBenchmarkMath_RandomTransform(&seed, &data.pParentPositions[i], &data.pParentRotations[i], &data.pParentScales[i]);
+        ocBuildBenchmarkMath_StoreTransform(&data.transforms, i, data.pPositions[i], data.pRotations[i], data.pScales[i]);
+        ocBuildBenchmarkMath_StoreTransform(&data.parents, i, data.pParentPositions[i], data.pParentRotations[i], data.pParentScales[i]);
+        data.pMatrices[i] = ocMakeMat4(data.pPositions[i], data.pRotations[i], data.pScales[i]);
+    }
+
+    const char* kernelNames[OC_BUILD_BENCHMARK_MATH_KERNEL_COUNT] = {
+        "ocMakeMat4Array",
+        "ocQuatMultiplyArray",
+        "ocMakeAbsoluteTransformArray",
+        "ocInverseAffineMat4Array"
+    };
+
+    const char* levelNames[3] = {
+        "scalar",
+        "SSE2",
+        "AVX2"
+    };
+
+    ocSIMDLevel supportedLevel = ocGetSupportedSIMDLevel();
+    ocSIMDLevel originalLevel  = ocGetSIMDLevel();
+
+    printf("Batched transforms (%u transforms, %u passes, up to %s):\n", count, OC_BUILD_BENCHMARK_MATH_PASSES, levelNames[supportedLevel]);
+
+    ocTimer timer;
+    ocTimerInit(&timer);
+    for (ocUInt32 kernel = 0; kernel < OC_BUILD_BENCHMARK_MATH_KERNEL_COUNT; ++kernel) {
+        char name[64];
+
+        ocTimerTick(&timer);
+        for (ocUInt32 iPass = 0; iPass < OC_BUILD_BENCHMARK_MATH_PASSES; ++iPass) {
+            ocBuildBenchmarkMath_RunGLM(&data, kernel);
+        }
+        double glmSeconds = ocTimerTick(&timer);
+
+        snprintf(name, sizeof(name), "%s (glm)", kernelNames[kernel]);
+        printf("  %-44s %10.1f M/s\n", name, ((double)count * OC_BUILD_BENCHMARK_MATH_PASSES / 1000000) / glmSeconds);
+
+        for (int level = ocSIMDLevel_None; level <= (int)supportedLevel; ++level) {
+            ocSetSIMDLevel((ocSIMDLevel)level);
+
+            ocTimerTick(&timer);
+            for (ocUInt32 iPass = 0; iPass < OC_BUILD_BENCHMARK_MATH_PASSES; ++iPass) {
+                ocBuildBenchmarkMath_RunBatched(&data, kernel);
+            }
+            double seconds = ocTimerTick(&timer);
+
+            snprintf(name, sizeof(name), "%s (%s)", kernelNames[kernel], levelNames[level]);
+            printf("  %-44s %10.1f M/s %6.2fx  (max error %g)\n", name, ((double)count * OC_BUILD_BENCHMARK_MATH_PASSES / 1000000) / seconds, glmSeconds / seconds, ocBuildBenchmarkMath_MaxError(&data, kernel));
+        }
+    }
+
+    ocSetSIMDLevel(originalLevel);
+    ocFree(pMemory);
+
+    return OC_SUCCESS;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Animation
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_BUILD_BENCHMARK_ANIMATION_CHARACTER_COUNT    500
+#define OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT         64
+#define OC_BUILD_BENCHMARK_ANIMATION_CHAIN_LENGTH       16      // <-- Bones in each limb hanging off the root.
+#define OC_BUILD_BENCHMARK_ANIMATION_CLIP_COUNT         4
+#define OC_BUILD_BENCHMARK_ANIMATION_FRAME_COUNT        61      // <-- Two seconds, with the last frame matching the first so the clips loop.
+#define OC_BUILD_BENCHMARK_ANIMATION_SAMPLE_RATE        30
+#define OC_BUILD_BENCHMARK_ANIMATION_STEPS              120
+#define OC_BUILD_BENCHMARK_ANIMATION_DT                 (1.0f/60)
+
+// The parent of each bone of the synthetic skeleton. The root has a number of limbs, each of which is a chain.
+OC_PRIVATE ocUInt32 ocBuildBenchmarkAnimation_Parent(ocUInt32 iBone)
+{
+    if (iBone == 0) {
+        return OC_SKELETON_BONE_NONE;
+    }
+
+    return ((iBone - 1) % OC_BUILD_BENCHMARK_ANIMATION_CHAIN_LENGTH == 0) ? 0 : iBone - 1;
+}
+
+// Renders an OCD file to memory and gives it to the initialization routine of the skeleton or clip, which takes ownership of it. This is
+// the same as loading it from a file.
+OC_PRIVATE ocResult ocBuildBenchmarkAnimation_BuildSkeleton(ocSkeleton* pSkeleton, ocSizeT* pFileSize)
+{
+    ocOCDSkeletonBuilder builder;
+    ocResult result = ocOCDSkeletonBuilderInit(&builder);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (ocUInt32 iBone = 0; iBone < OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT && result == OC_SUCCESS; ++iBone) {
+        char name[32];
+        snprintf(name, sizeof(name), "Bone%u", iBone);
+
+        ocUInt32 boneIndex;
+        result = ocOCDSkeletonBuilderAddBone(&builder, name, ocBuildBenchmarkAnimation_Parent(iBone), glm::vec3(0, (iBone == 0) ? 1.0f : 0.1f, 0), glm::quat(1, 0, 0, 0), glm::vec3(1, 1, 1), &boneIndex);
+    }
+
+    void* pData = NULL;
+    size_t dataSize = 0;
+    if (result == OC_SUCCESS) {
+        ocStreamWriter writer;
+        result = ocStreamWriterInit(&pData, &dataSize, &writer);
+        if (result == OC_SUCCESS) {
+            result = ocOCDSkeletonBuilderRender(&builder, &writer);
+            ocStreamWriterUninit(&writer);
+        }
+    }
+
+    ocOCDSkeletonBuilderUninit(&builder);
+
+    if (result != OC_SUCCESS) {
+        ocFree(pData);
+        return result;
+    }
+
+    *pFileSize = dataSize;
+    return ocSkeletonInit(pData, dataSize, pSkeleton);
+}
+
+// Each clip swings every limb about a different axis, with the root moving forward and bobbing up and down. Every fourth bone is held
+// still, and scale is never animated, which is typical of real clips and is where most of the compression comes from.
+OC_PRIVATE ocResult ocBuildBenchmarkAnimation_BuildClip(ocUInt32 iClip, ocAnimationClip* pClip, ocSizeT* pFileSize)
+{
+    ocOCDAnimationBuilder builder;
+    ocResult result = ocOCDAnimationBuilderInit(OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT, OC_BUILD_BENCHMARK_ANIMATION_FRAME_COUNT, OC_BUILD_BENCHMARK_ANIMATION_SAMPLE_RATE, &builder);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    const float twoPi = 6.28318530718f;
+    for (ocUInt32 iFrame = 0; iFrame < OC_BUILD_BENCHMARK_ANIMATION_FRAME_COUNT && result == OC_SUCCESS; ++iFrame) {
+        float phase = twoPi * iFrame / (OC_BUILD_BENCHMARK_ANIMATION_FRAME_COUNT - 1);
+
+        for (ocUInt32 iBone = 0; iBone < OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT && result == OC_SUCCESS; ++iBone) {
+            glm::vec3 position = glm::vec3(0, (iBone == 0) ? 1.0f : 0.1f, 0);
+            glm::quat rotation = glm::quat(1, 0, 0, 0);
+
+            if (iBone == 0) {
+                position += glm::vec3(0, 0.05f * sinf(phase * 2), 0.5f * iFrame / (OC_BUILD_BENCHMARK_ANIMATION_FRAME_COUNT - 1));
+            } else if ((iBone % 4) != 0) {
+                ocUInt32 iLimb = (iBone - 1) / OC_BUILD_BENCHMARK_ANIMATION_CHAIN_LENGTH;
+                glm::vec3 axis = glm::normalize(glm::vec3((float)((iLimb + iClip) % 3), 1.0f, (float)(iClip % 2)));
+                rotation = glm::angleAxis(0.3f * sinf(phase + iBone * 0.2f + iClip), axis);
+            }
+
+            result = ocOCDAnimationBuilderSetKey(&builder, iFrame, iBone, position, rotation, glm::vec3(1, 1, 1));
+        }
+    }
+
+    void* pData = NULL;
+    size_t dataSize = 0;
+    if (result == OC_SUCCESS) {
+        ocStreamWriter writer;
+        result = ocStreamWriterInit(&pData, &dataSize, &writer);
+        if (result == OC_SUCCESS) {
+            result = ocOCDAnimationBuilderRender(&builder, &writer);
+            ocStreamWriterUninit(&writer);
+        }
+    }
+
+    ocOCDAnimationBuilderUninit(&builder);
+
+    if (result != OC_SUCCESS) {
+        ocFree(pData);
+        return result;
+    }
+
+    *pFileSize = dataSize;
+    return ocAnimationClipInit(pData, dataSize, pClip);
+}
+
+// Creates a crowd and times stepping it. Every character plays a clip on it's first layer. When layerCount is 2, every character also
+// blends in a second clip, which is what transitions between clips look like.
+OC_PRIVATE ocResult ocBuildBenchmarkAnimation_Run(const char* name, ocJobQueue* pJobQueue, const ocSkeleton* pSkeleton, const ocAnimationClip* pClips, ocUInt32 characterCount, ocUInt32 layerCount, glm::mat4* pPalettes)
+{
+    ocAnimationWorld world;
+    ocResult result = ocAnimationWorldInit(pJobQueue, &world);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (ocUInt32 iCharacter = 0; iCharacter < characterCount && result == OC_SUCCESS; ++iCharacter) {
+        ocAnimationCharacter* pCharacter;
+        result = ocAnimationWorldCreateCharacter(&world, pSkeleton, &pCharacter);
+        if (result != OC_SUCCESS) {
+            break;
+        }
+
+        // Characters are spread out over the clips and their times so they're not all in lock step.
+        for (ocUInt32 iLayer = 0; iLayer < layerCount && result == OC_SUCCESS; ++iLayer) {
+            const ocAnimationClip* pClip = &pClips[(iCharacter + iLayer) % OC_BUILD_BENCHMARK_ANIMATION_CLIP_COUNT];
+            result = ocAnimationCharacterSetLayer(pCharacter, iLayer, pClip, (iLayer == 0) ? 1.0f : 0.5f, 0.8f + (iCharacter % 5) * 0.1f, OC_TRUE);
+            ocAnimationCharacterSetLayerTime(pCharacter, iLayer, pClip->duration * (iCharacter % 16) / 16);
+        }
+    }
+
+    if (result == OC_SUCCESS) {
+        // The first step is not timed so that the memory is warm.
+        ocAnimationWorldStep(&world, OC_BUILD_BENCHMARK_ANIMATION_DT, pPalettes);
+
+        ocTimer timer;
+        ocTimerInit(&timer);
+        for (ocUInt32 iStep = 0; iStep < OC_BUILD_BENCHMARK_ANIMATION_STEPS; ++iStep) {
+            ocAnimationWorldStep(&world, OC_BUILD_BENCHMARK_ANIMATION_DT, pPalettes);
+        }
+        double seconds = ocTimerTick(&timer);
+
+        double msPerStep = (seconds * 1000) / OC_BUILD_BENCHMARK_ANIMATION_STEPS;
+        printf("  %-44s %10.3f ms/step %8.2f us/character\n", name, msPerStep, (msPerStep * 1000) / characterCount);
+    }
+
+    ocAnimationWorldUninit(&world);
+    return result;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkAnimation(int argc, char** argv)
+{
+    ocUInt32 characterCount = OC_BUILD_BENCHMARK_ANIMATION_CHARACTER_COUNT;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-characters") != NULL) {
+        characterCount = ocMax((ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-characters")), 1U);
+    }
+
+    ocUInt32 threadCount = ocMax(ocGetLogicalProcessorCount(), 2U) - 1;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-threads") != NULL) {
+        threadCount = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-threads"));
+    }
+
+    ocSkeleton skeleton;
+    ocSizeT skeletonFileSize;
+    ocResult result = ocBuildBenchmarkAnimation_BuildSkeleton(&skeleton, &skeletonFileSize);
+    if (result != OC_SUCCESS) {
+        printf("Failed to build skeleton (%d).\n", result);
+        return result;
+    }
+
+    ocAnimationClip clips[OC_BUILD_BENCHMARK_ANIMATION_CLIP_COUNT];
+    ocSizeT clipFileSize = 0;
+    ocUInt32 clipCount = 0;
+    for (; clipCount < OC_BUILD_BENCHMARK_ANIMATION_CLIP_COUNT; ++clipCount) {
+        ocSizeT fileSize;
+        result = ocBuildBenchmarkAnimation_BuildClip(clipCount, &clips[clipCount], &fileSize);
+        if (result != OC_SUCCESS) {
+            printf("Failed to build clip (%d).\n", result);
+            break;
+        }
+
+        clipFileSize += fileSize;
+    }
+
+    // The palettes of the single threaded run are kept so they can be compared with the results of the job queue.
+    glm::mat4* pPalettes = NULL;
+    if (result == OC_SUCCESS) {
+        pPalettes = (glm::mat4*)ocMalloc(sizeof(glm::mat4) * OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT * characterCount * 2);
+        if (pPalettes == NULL) {
+            printf("Out of memory.\n");
+            result = OC_OUT_OF_MEMORY;
+        }
+    }
+
+    ocJobQueue jobQueue;
+    ocJobQueue* pJobQueue = NULL;
+    if (result == OC_SUCCESS && threadCount > 0) {
+        result = ocJobQueueInit(threadCount, &jobQueue);
+        if (result != OC_SUCCESS) {
+            printf("Failed to initialize job queue (%d).\n", result);
+        } else {
+            pJobQueue = &jobQueue;
+        }
+    }
+
+    if (result == OC_SUCCESS) {
+        // The size the clips would be if every channel of every bone was stored as floats.
+        ocSizeT rawClipSize = sizeof(float) * 10 * OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT * OC_BUILD_BENCHMARK_ANIMATION_FRAME_COUNT * OC_BUILD_BENCHMARK_ANIMATION_CLIP_COUNT;
+
+        printf("Animation (%u characters, %u bones, %u clips, %u threads):\n", characterCount, OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT, OC_BUILD_BENCHMARK_ANIMATION_CLIP_COUNT, threadCount + 1);
+        printf("  %-44s %10.1f KB\n", "Skeleton file", skeletonFileSize / 1024.0);
+        printf("  %-44s %10.1f KB (%.1fx smaller than raw keys)\n", "Clip files", clipFileSize / 1024.0, (double)rawClipSize / clipFileSize);
+        printf("  %-44s %10u / %u / %u\n", "Rotation / position / scale tracks per clip", clips[0].rotations.trackCount, clips[0].positions.trackCount, clips[0].scales.trackCount);
+
+        glm::mat4* pQueuePalettes = pPalettes + OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT * characterCount;
+        for (ocUInt32 layerCount = 1; layerCount <= 2 && result == OC_SUCCESS; ++layerCount) {
+            char name[64];
+            snprintf(name, sizeof(name), "%u layer%s, 1 thread", layerCount, (layerCount > 1) ? "s" : "");
+            result = ocBuildBenchmarkAnimation_Run(name, NULL, &skeleton, clips, characterCount, layerCount, pPalettes);
+
+            if (result == OC_SUCCESS && pJobQueue != NULL) {
+                snprintf(name, sizeof(name), "%u layer%s, job queue", layerCount, (layerCount > 1) ? "s" : "");
+                result = ocBuildBenchmarkAnimation_Run(name, pJobQueue, &skeleton, clips, characterCount, layerCount, pQueuePalettes);
+
+                // Characters are independent so the job queue should give exactly the same results.
+                if (result == OC_SUCCESS && memcmp(pPalettes, pQueuePalettes, sizeof(glm::mat4) * OC_BUILD_BENCHMARK_ANIMATION_BONE_COUNT * characterCount) != 0) {
+                    printf("  The palettes of the job queue do not match the palettes of the single threaded run.\n");
+                    result = OC_ERROR;
+                }
+            }
+        }
+
+        if (result != OC_SUCCESS) {
+            printf("Failed to run animation benchmark (%d).\n", result);
+        }
+    }
+
+    if (pJobQueue != NULL) {
+        ocJobQueueUninit(pJobQueue);
+    }
+
+    ocFree(pPalettes);
+    for (ocUInt32 iClip = 0; iClip < clipCount; ++iClip) {
+        ocAnimationClipUninit(&clips[iClip]);
+    }
+    ocSkeletonUninit(&skeleton);
+
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Particles
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_BUILD_BENCHMARK_PARTICLES_COUNT              1000000
+#define OC_BUILD_BENCHMARK_PARTICLES_EMITTER_COUNT      64
+#define OC_BUILD_BENCHMARK_PARTICLES_STEPS              120
+#define OC_BUILD_BENCHMARK_PARTICLES_DT                 (1.0f/60)
+
+// A smoke-like effect. Particles live for much longer than the benchmark runs so that the pools stay full and every step updates the
+// same number of particles.
+OC_PRIVATE ocParticleEmitterDesc ocBuildBenchmarkParticles_Desc(ocUInt32 maxParticles)
+{
+    ocParticleEmitterDesc desc = ocParticleEmitterDescInit();
+    desc.maxParticles = maxParticles;
+    desc.spawnRate    = 0;
+    desc.lifetimeMin  = 30;
+    desc.lifetimeMax  = 60;
+    desc.spread       = 0.5f;
+    desc.spawnRadius  = 0.5f;
+    desc.gravity      = glm::vec3(0, 0.5f, 0);
+    desc.drag         = 0.1f;
+
+    desc.colorCurve = ocParticleCurveInit(glm::vec4(1.0f, 0.8f, 0.4f, 0.0f));
+    ocParticleCurveAddKey(&desc.colorCurve, 0.1f, glm::vec4(1.0f, 0.6f, 0.2f, 1.0f));
+    ocParticleCurveAddKey(&desc.colorCurve, 0.5f, glm::vec4(0.3f, 0.3f, 0.3f, 0.5f));
+    ocParticleCurveAddKey(&desc.colorCurve, 1.0f, glm::vec4(0.2f, 0.2f, 0.2f, 0.0f));
+
+    desc.sizeCurve = ocParticleCurveInit(glm::vec4(0.1f, 0, 0, 0));
+    ocParticleCurveAddKey(&desc.sizeCurve, 1.0f, glm::vec4(1.0f, 0, 0, 0));
+
+    return desc;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkParticles_Run(const char* name, ocJobQueue* pJobQueue, ocUInt32 particleCount, ocUInt32 emitterCount, ocParticleInstance* pInstances)
+{
+    ocParticleWorld world;
+    ocResult result = ocParticleWorldInit(pJobQueue, &world);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    // The particles are spread evenly over the emitters, with the remainder going to the first emitter.
+    ocParticleEmitterDesc desc = ocBuildBenchmarkParticles_Desc(particleCount / emitterCount);
+    for (ocUInt32 iEmitter = 0; iEmitter < emitterCount && result == OC_SUCCESS; ++iEmitter) {
+        ocUInt32 maxParticles = desc.maxParticles;
+        if (iEmitter == 0) {
+            desc.maxParticles += particleCount % emitterCount;
+        }
+
+        ocParticleEmitter* pEmitter;
+        result = ocParticleWorldCreateEmitter(&world, &desc, glm::vec3((float)(iEmitter % 8) * 4, 0, (float)(iEmitter / 8) * 4), glm::quat(1, 0, 0, 0), &pEmitter);
+        if (result == OC_SUCCESS) {
+            ocParticleEmitterSetEmitting(pEmitter, OC_FALSE);
+            ocParticleEmitterBurst(pEmitter, desc.maxParticles);
+        }
+
+        desc.maxParticles = maxParticles;
+    }
+
+    if (result == OC_SUCCESS) {
+        // The first step spawns every particle and is not timed.
+        ocParticleWorldStep(&world, OC_BUILD_BENCHMARK_PARTICLES_DT, pInstances);
+
+        ocTimer timer;
+        ocTimerInit(&timer);
+        for (ocUInt32 iStep = 0; iStep < OC_BUILD_BENCHMARK_PARTICLES_STEPS; ++iStep) {
+            ocParticleWorldStep(&world, OC_BUILD_BENCHMARK_PARTICLES_DT, pInstances);
+        }
+        double seconds = ocTimerTick(&timer);
+
+        double msPerStep = (seconds * 1000) / OC_BUILD_BENCHMARK_PARTICLES_STEPS;
+        printf("  %-44s %10.3f ms/step %8.2f M particles/ms\n", name, msPerStep, ((double)particleCount / 1000000) / msPerStep);
+    }
+
+    ocParticleWorldUninit(&world);
+    return result;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkParticles(int argc, char** argv)
+{
+    ocUInt32 particleCount = OC_BUILD_BENCHMARK_PARTICLES_COUNT;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-particles") != NULL) {
+        particleCount = ocMax((ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-particles")), 1U);
+    }
+
+    ocUInt32 emitterCount = OC_BUILD_BENCHMARK_PARTICLES_EMITTER_COUNT;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-emitters") != NULL) {
+        emitterCount = ocMax((ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-emitters")), 1U);
+    }
+    emitterCount = ocMin(emitterCount, particleCount);
+
+    ocUInt32 threadCount = ocMax(ocGetLogicalProcessorCount(), 2U) - 1;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-threads") != NULL) {
+        threadCount = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-threads"));
+    }
+
+    // The instances of the single threaded run are kept so they can be compared with the other runs.
+    ocResult result = OC_SUCCESS;
+    ocParticleInstance* pInstances = (ocParticleInstance*)ocMalloc(sizeof(ocParticleInstance) * particleCount * 2);
+    if (pInstances == NULL) {
+        printf("Out of memory.\n");
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocJobQueue jobQueue;
+    ocJobQueue* pJobQueue = NULL;
+    if (threadCount > 0) {
+        result = ocJobQueueInit(threadCount, &jobQueue);
+        if (result != OC_SUCCESS) {
+            printf("Failed to initialize job queue (%d).\n", result);
+        } else {
+            pJobQueue = &jobQueue;
+        }
+    }
+
+    if (result == OC_SUCCESS) {
+        const char* levelNames[3] = {
+            "scalar",
+            "SSE2",
+            "AVX2"
+        };
+
+        ocSIMDLevel supportedLevel = ocGetSupportedSIMDLevel();
+        ocSIMDLevel originalLevel  = ocGetSIMDLevel();
+
+        printf("Particles (%u particles, %u emitters, %u threads, up to %s):\n", particleCount, emitterCount, threadCount + 1, levelNames[supportedLevel]);
+
+        // Every SIMD level is run on a single thread, and then the best one is run on the job queue. The particles of each run are
+        // spawned with the same random sequence and every kernel gives exactly the same results, so the instances should all match.
+        ocParticleInstance* pOtherInstances = pInstances + particleCount;
+        for (int level = ocSIMDLevel_None; level <= (int)supportedLevel && result == OC_SUCCESS; ++level) {
+            ocSetSIMDLevel((ocSIMDLevel)level);
+
+            char name[64];
+            snprintf(name, sizeof(name), "%s, 1 thread", levelNames[level]);
+            result = ocBuildBenchmarkParticles_Run(name, NULL, particleCount, emitterCount, (level == ocSIMDLevel_None) ? pInstances : pOtherInstances);
+
+            if (result == OC_SUCCESS && level != ocSIMDLevel_None && memcmp(pInstances, pOtherInstances, sizeof(ocParticleInstance) * particleCount) != 0) {
+                printf("  The instances of %s do not match the instances of the scalar run.\n", levelNames[level]);
+                result = OC_ERROR;
+            }
+        }
+
+        if (result == OC_SUCCESS && pJobQueue != NULL) {
+            char name[64];
+            snprintf(name, sizeof(name), "%s, job queue", levelNames[supportedLevel]);
+            result = ocBuildBenchmarkParticles_Run(name, pJobQueue, particleCount, emitterCount, pOtherInstances);
+
+            if (result == OC_SUCCESS && memcmp(pInstances, pOtherInstances, sizeof(ocParticleInstance) * particleCount) != 0) {
+                printf("  The instances of the job queue do not match the instances of the single threaded run.\n");
+                result = OC_ERROR;
+            }
+        }
+
+        if (result != OC_SUCCESS) {
+            printf("Failed to run particle benchmark (%d).\n", result);
+        }
+
+        ocSetSIMDLevel(originalLevel);
+    }
+
+    if (pJobQueue != NULL) {
+        ocJobQueueUninit(pJobQueue);
+    }
+
+    ocFree(pInstances);
+    return result;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Light Clusters
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_LIGHT_COUNT   512
+#define OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_BUILDS        200
+#define OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_SIZE_X        1920
+#define OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_SIZE_Y        1080
+
+OC_PRIVATE float ocBuildBenchmarkLightClusters_Random(ocUInt32* pSeed)
+{
+    *pSeed = (*pSeed)*1664525 + 1013904223;
+    return (*pSeed >> 8) / 16777216.0f;
+}
+
+// The result of a run, which is what gets written to the GPU.
+struct ocBuildBenchmarkLightClustersResult
+{
+    ocLightClusterRange ranges[OC_LIGHT_CLUSTER_COUNT];
+    ocStack<ocUInt32> indices;
+};
+
+OC_PRIVATE ocResult ocBuildBenchmarkLightClusters_Run(const char* name, ocJobQueue* pJobQueue, const glm::vec4* pSpheres, ocUInt32 lightCount, ocBuildBenchmarkLightClustersResult* pResult)
+{
+    // The grid is too big for the stack.
+    ocLightClusterGrid* pGrid = (ocLightClusterGrid*)ocMalloc(sizeof(*pGrid));
+    if (pGrid == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocResult result = ocLightClusterGridInit(pJobQueue, pGrid);
+    if (result != OC_SUCCESS) {
+        ocFree(pGrid);
+        return result;
+    }
+
+    float aspect = (float)OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_SIZE_X / OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_SIZE_Y;
+    ocLightClusterGridSetView(pGrid, glm::perspective(glm::radians(90.0f), aspect, 0.1f, 1000.0f), OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_SIZE_X, OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_SIZE_Y);
+
+    // The first build grows the internal buffers and is not timed.
+    result = ocLightClusterGridBuild(pGrid, pSpheres, lightCount);
+    if (result == OC_SUCCESS) {
+        ocTimer timer;
+        ocTimerInit(&timer);
+        for (ocUInt32 iBuild = 0; iBuild < OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_BUILDS && result == OC_SUCCESS; ++iBuild) {
+            result = ocLightClusterGridBuild(pGrid, pSpheres, lightCount);
+        }
+        double seconds = ocTimerTick(&timer);
+
+        if (result == OC_SUCCESS) {
+            ocUInt32 indexCount = ocLightClusterGridGetIndexCount(pGrid);
+            result = ocStackResize(&pResult->indices, indexCount);
+            if (result == OC_SUCCESS) {
+                ocLightClusterGridWrite(pGrid, pResult->ranges, pResult->indices.pItems);
+
+                double msPerBuild = (seconds * 1000) / OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_BUILDS;
+                printf("  %-44s %10.3f ms/build %8.2f lights/cluster\n", name, msPerBuild, (double)indexCount / OC_LIGHT_CLUSTER_COUNT);
+            }
+        }
+    }
+
+    ocLightClusterGridUninit(pGrid);
+    ocFree(pGrid);
+    return result;
+}
+
+OC_PRIVATE ocBool32 ocBuildBenchmarkLightClusters_Compare(const ocBuildBenchmarkLightClustersResult* pA, const ocBuildBenchmarkLightClustersResult* pB)
+{
+    return memcmp(pA->ranges, pB->ranges, sizeof(pA->ranges)) == 0 &&
+           pA->indices.count == pB->indices.count &&
+           memcmp(pA->indices.pItems, pB->indices.pItems, sizeof(ocUInt32) * pA->indices.count) == 0;
+}
+
+OC_PRIVATE ocResult ocBuildBenchmarkLightClusters(int argc, char** argv)
+{
+    ocUInt32 lightCount = OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_LIGHT_COUNT;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-lights") != NULL) {
+        lightCount = ocMax((ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-lights")), 1U);
+    }
+
+    ocUInt32 threadCount = ocMax(ocGetLogicalProcessorCount(), 2U) - 1;
+    if (ocCmdLineGetValue(argc, argv, "--benchmark-threads") != NULL) {
+        threadCount = (ocUInt32)atoi(ocCmdLineGetValue(argc, argv, "--benchmark-threads"));
+    }
+
+    // The results are on the heap because the ranges of every cluster don't fit on the stack comfortably. The first one is the scalar
+    // run, which the others are compared with.
+    ocResult result = OC_SUCCESS;
+    glm::vec4* pSpheres = (glm::vec4*)ocMalloc(sizeof(glm::vec4) * lightCount);
+    ocBuildBenchmarkLightClustersResult* pResults = (ocBuildBenchmarkLightClustersResult*)ocMalloc(sizeof(ocBuildBenchmarkLightClustersResult) * 2);
+    if (pSpheres == NULL || pResults == NULL) {
+        printf("Out of memory.\n");
+        ocFree(pSpheres);
+        ocFree(pResults);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocStackInit(&pResults[0].indices);
+    ocStackInit(&pResults[1].indices);
+
+    // Point lights scattered through the view frustum in view space, looking down -Z. Most are in the first 100 units, which is where
+    // the slices are thinnest, with a few further out. The radius is what a typical level's point lights would use.
+    float aspect = (float)OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_SIZE_X / OC_BUILD_BENCHMARK_LIGHT_CLUSTERS_SIZE_Y;
+    ocUInt32 seed = 1;
+    for (ocUInt32 iLight = 0; iLight < lightCount; ++iLight) {
+        float t = ocBuildBenchmarkLightClusters_Random(&seed);
+        float depth = 0.5f + t*t*200;
+        // The field of view is 90 degrees, so the half height of the frustum at a depth is the depth.
+        float x = (ocBuildBenchmarkLightClusters_Random(&seed)*2 - 1) * depth * aspect;
+        float y = (ocBuildBenchmarkLightClusters_Random(&seed)*2 - 1) * depth;
+        float radius = 1 + ocBuildBenchmarkLightClusters_Random(&seed)*9;
+        pSpheres[iLight] = glm::vec4(x, y, -depth, radius);
+    }
+
+    ocJobQueue jobQueue;
+    ocJobQueue* pJobQueue = NULL;
+    if (threadCount > 0) {
+        result = ocJobQueueInit(threadCount, &jobQueue);
+        if (result != OC_SUCCESS) {
+            printf("Failed to initialize job queue (%d).\n", result);
+        } else {
+            pJobQueue = &jobQueue;
+        }
+    }
+
+    if (result == OC_SUCCESS) {
+        const char* levelNames[3] = {
+            "scalar",
+            "SSE2",
+            "AVX2"
+        };
+
+        ocSIMDLevel supportedLevel = ocGetSupportedSIMDLevel();
+        ocSIMDLevel originalLevel  = ocGetSIMDLevel();
+
+        printf("Light clusters (%u point lights, %u clusters, %u threads, up to %s):\n", lightCount, OC_LIGHT_CLUSTER_COUNT, threadCount + 1, levelNames[supportedLevel]);
+
+        // Every SIMD level is run on a single thread, and then the best one is run on the job queue. Each level tests the same spheres
+        // against the same bounds and emits the indices of a cluster in the same order, so the lists should match the scalar run exactly.
+        for (int level = ocSIMDLevel_None; level <= (int)supportedLevel && result == OC_SUCCESS; ++level) {
+            ocSetSIMDLevel((ocSIMDLevel)level);
+
+            char name[64];
+            snprintf(name, sizeof(name), "%s, 1 thread", levelNames[level]);
+            result = ocBuildBenchmarkLightClusters_Run(name, NULL, pSpheres, lightCount, (level == ocSIMDLevel_None) ? &pResults[0] : &pResults[1]);
+
+            if (result == OC_SUCCESS && level != ocSIMDLevel_None && !ocBuildBenchmarkLightClusters_Compare(&pResults[0], &pResults[1])) {
+                printf("  The clusters of %s do not match the clusters of the scalar run.\n", levelNames[level]);
+                result = OC_ERROR;
+            }
+        }
+
+        if (result == OC_SUCCESS && pJobQueue != NULL) {
+            char name[64];
+            snprintf(name, sizeof(name), "%s, job queue", levelNames[supportedLevel]);
+            result = ocBuildBenchmarkLightClusters_Run(name, pJobQueue, pSpheres, lightCount, &pResults[1]);
+
+            if (result == OC_SUCCESS && !ocBuildBenchmarkLightClusters_Compare(&pResults[0], &pResults[1])) {
+                printf("  The clusters of the job queue do not match the clusters of the single threaded run.\n");
+                result = OC_ERROR;
+            }
+        }
+
+        if (result != OC_SUCCESS) {
+            printf("Failed to run light cluster benchmark (%d).\n", result);
+        }
+
+        ocSetSIMDLevel(originalLevel);
+    }
+
+    if (pJobQueue != NULL) {
+        ocJobQueueUninit(pJobQueue);
+    }
+
+    ocStackUninit(&pResults[0].indices);
+    ocStackUninit(&pResults[1].indices);
+    ocFree(pResults);
+    ocFree(pSpheres);
+    return result;
+}
+
+
+ocResult ocBuildBenchmark(int argc, char** argv)
+{
+    const char* name = ocCmdLineGetValue(argc, argv, "--benchmark");
+    if (name == NULL) {
+        printf("Usage: oc_build --benchmark <name> [--benchmark-size <megabytes>]\n");
+        return OC_INVALID_ARGS;
+    }
+
+    ocUInt64 size = 0;
+    const char* sizeStr = ocCmdLineGetValue(argc, argv, "--benchmark-size");
+    if (sizeStr != NULL) {
+        size = (ocUInt64)atoi(sizeStr) * 1024 * 1024;
+    }
+
+    if (strcmp(name, "streams") == 0) {
+        return ocBuildBenchmarkStreams((size > 0) ? size : 256*1024*1024);
+    }
+
+    if (strcmp(name, "audio-mixer") == 0) {
+        return ocBuildBenchmarkAudioMixer();
+    }
+
+    if (strcmp(name, "audio-render") == 0) {
+        return ocBuildBenchmarkAudioRender(argc, argv);
+    }
+
+    if (strcmp(name, "raycast") == 0) {
+        return ocBuildBenchmarkRaycast(argc, argv);
+    }
+
+    if (strcmp(name, "dynamics") == 0) {
+        return ocBuildBenchmarkDynamics(argc, argv);
+    }
+
+    if (strcmp(name, "math") == 0) {
+        return ocBuildBenchmarkMath(argc, argv);
+    }
+
+    if (strcmp(name, "animation") == 0) {
+        return ocBuildBenchmarkAnimation(argc, argv);
+    }
+
+    if (strcmp(name, "particles") == 0) {
+        return ocBuildBenchmarkParticles(argc, argv);
+    }
+
+    if (strcmp(name, "light-clusters") == 0) {
+        return ocBuildBenchmarkLightClusters(argc, argv);
+    }
+
+    printf("Unknown benchmark: %s\n", name);
+    return OC_INVALID_ARGS;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Runs a micro-benchmark and prints the results.
+//
+// Usage: oc_build --benchmark <name> [--benchmark-size <megabytes>]
+//
+// Available benchmarks:
+//   streams - Throughput of the stream readers and writers with and without buffering, using 4 byte reads and writes, which is
+//             the worst case and also the most common case when writing OCD files. Includes the memory and chunked writers, and
+//             zero-copy reads with ocStreamReaderAcquire(). Defaults to 256MB.
+//   audio-mixer - Voices mixed per millisecond by ocAudioMixer, which is the number of voices that could be mixed in real time on a
+//             single core. Covers mono and stereo voices, resampling, and virtualization with more voices than can be mixed. The size
+//             is ignored.
+//   audio-render - Renders 30 seconds of a scene of moving emitters through ocAudioWorld and the mixer without a sound card, faster than
+//             real time. Prints the percentiles of the time taken by each callback, the headroom left in the period, voice counts, and a
+//             checksum of the output. The size is ignored. Options:
+//               --benchmark-emitters <count>   The number of looping emitters. Defaults to 512.
+//               --audio-real-voices <count>    The number of voices that are mixed at the same time. Defaults to 64.
+//               --benchmark-output <path>      Writes the output to a WAV file. Otherwise it's only kept in memory.
+//               --benchmark-max-load <percent> Fails if the p99 callback time is more than this percentage of the period. For CI.
+//   raycast - Rays and sphere sweeps per second through ocDynamicsWorld against a large static triangle mesh, which is a procedural
+//             terrain that's loaded from the data of an OCD mesh component. Runs on one thread and then across a job queue. Also prints
+//             the time taken to create the mesh. The size is ignored. Options:
+//               --benchmark-grid <count>       The number of quads along each side of the terrain. Defaults to 512, which is 524288 triangles.
+//               --benchmark-rays <count>       The number of rays. There are 16 times fewer sweeps. Defaults to 1048576.
+//               --benchmark-threads <count>    The number of worker threads. Defaults to one less than the number of cores.
+//   dynamics - Step times of ocDynamicsWorld with a large number of resting bodies, which is what the debris of an open level looks like.
+//             Times how long it takes for everything to settle and fall asleep, steps with everything asleep, steps with spheres dropped
+//             onto the debris which keep waking bodies up, and a few steps with sleeping disabled for comparison. The size is ignored.
+//             Options:
+//               --benchmark-bodies <count>     The number of resting bodies. Defaults to 100000.
+//               --benchmark-active <count>     The number of spheres dropped onto them. Defaults to 1000.
+//               --benchmark-threads <count>    The number of worker threads. Defaults to one less than the number of cores.
+//   math - Transforms per second through the batched transform functions in ocMath, compared to doing the same thing one transform at a
+//             time with glm. Runs every SIMD level the CPU supports and prints the largest difference from the glm results. The size is
+//             ignored. Options:
+//               --benchmark-transforms <count> The number of transforms. Defaults to 65536.
+//   animation - Step times of ocAnimationWorld with a crowd of characters sharing a 64 bone skeleton, playing one clip each and then
+//             blending two clips each. Runs on one thread and then across a job queue, and checks that both give the same palettes.
+//             Also prints the size of the compressed clips. The size is ignored. Options:
+//               --benchmark-characters <count> The number of characters. Defaults to 500.
+//               --benchmark-threads <count>    The number of worker threads. Defaults to one less than the number of cores.
+//   particles - Million particle updates per millisecond through ocParticleWorld, with smoke emitters whose pools are kept full. Runs
+//             every SIMD level the CPU supports on one thread and then the best one across a job queue, and checks that every run gives
+//             the same instances. The size is ignored. Options:
+//               --benchmark-particles <count>  The total number of particles. Defaults to 1000000.
+//               --benchmark-emitters <count>   The number of emitters the particles are spread over. Defaults to 64.
+//               --benchmark-threads <count>    The number of worker threads. Defaults to one less than the number of cores.
+//   light-clusters - Milliseconds per build of ocLightClusterGrid with a 1920x1080 perspective view and point lights scattered through
+//             the frustum. Runs every SIMD level of the cluster binning the CPU supports on one thread and then the best one across a job
+//             queue, and checks that every run gives the same cluster lists as the scalar run. The size is ignored. Options:
+//               --benchmark-lights <count>     The number of point lights. Defaults to 512.
+//               --benchmark-threads <count>    The number of worker threads. Defaults to one less than the number of cores.
+ocResult ocBuildBenchmark(int argc, char** argv);
\ No newline at end of file
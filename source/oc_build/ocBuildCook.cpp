@@ -0,0 +1,523 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_BUILD_COOK_MANIFEST_FILE_NAME    "ocCook.manifest"
+
+struct ocBuildCookManifestEntry
+{
+    ocUInt64 key;
+    char* relativePath;
+};
+
+struct ocBuildCookItem
+{
+    char* sourcePath;       // Absolute.
+    char* relativePath;     // Relative to the input directory.
+    char* outputPath;       // Absolute.
+    ocResourceType type;
+    ocBool32 hasPreviousKey;
+    ocUInt64 previousKey;
+    ocBool32 force;
+    ocBool32 compress;
+
+    // These are set by the job.
+    ocResult result;
+    ocBool32 skipped;
+    ocUInt64 key;
+    ocUInt64 sourceSize;
+    ocUInt64 outputSize;
+    double seconds;
+};
+
+struct ocBuildCookReport
+{
+    const char* name;
+    ocUInt32 convertedCount;
+    ocUInt32 skippedCount;
+    ocUInt32 failedCount;
+    ocUInt64 sourceSize;
+    ocUInt64 outputSize;
+    double seconds;
+};
+
+OC_PRIVATE int ocBuildCookManifestEntryCompare(const void* a, const void* b)
+{
+    return strcmp(((const ocBuildCookManifestEntry*)a)->relativePath, ((const ocBuildCookManifestEntry*)b)->relativePath);
+}
+
+// The manifest is a text file with one line per output: "<16 hex digit key> <path relative to the input directory>".
+OC_PRIVATE ocResult ocBuildCookLoadManifest(const char* manifestPath, ocStack<ocBuildCookManifestEntry>* pEntries)
+{
+    char* pText;
+    ocResult result = ocOpenAndReadTextFile(manifestPath, &pText, NULL);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    char* pLine = pText;
+    while (pLine[0] != '\0') {
+        char* pLineEnd = pLine;
+        while (pLineEnd[0] != '\0' && pLineEnd[0] != '\n' && pLineEnd[0] != '\r') {
+            pLineEnd += 1;
+        }
+
+        char* pNextLine = pLineEnd;
+        while (pNextLine[0] == '\n' || pNextLine[0] == '\r') {
+            pNextLine += 1;
+        }
+
+        pLineEnd[0] = '\0';
+
+        char* pPath;
+        ocBuildCookManifestEntry entry;
+        entry.key = (ocUInt64)strtoull(pLine, &pPath, 16);
+        if (pPath != pLine && pPath[0] == ' ' && pPath[1] != '\0') {
+            entry.relativePath = ocMakeString(pPath + 1);
+            if (entry.relativePath != NULL) {
+                ocStackPush(pEntries, entry);
+            }
+        }
+
+        pLine = pNextLine;
+    }
+
+    ocFree(pText);
+
+    qsort(pEntries->pItems, pEntries->count, sizeof(*pEntries->pItems), ocBuildCookManifestEntryCompare);
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocBuildCookSaveManifest(const char* manifestPath, ocBuildCookItem* pItems, size_t itemCount)
+{
+    // Written to a temporary file first so that a cook that's interrupted doesn't leave behind a broken manifest.
+    char tempPath[OC_MAX_PATH];
+    if (ocPathAppendExtension(tempPath, sizeof(tempPath), manifestPath, "tmp") == 0) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    FILE* pFile;
+    ocResult result = ocFOpen(tempPath, "wb", &pFile);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (size_t iItem = 0; iItem < itemCount; ++iItem) {
+        const ocBuildCookItem* pItem = &pItems[iItem];
+        if (pItem->result != OC_SUCCESS) {
+            continue;   // <-- Failed items are left out so they're tried again next time.
+        }
+
+        fprintf(pFile, "%016llx %s\n", (unsigned long long)pItem->key, pItem->relativePath);
+    }
+
+    ocFClose(pFile);
+
+    return ocMoveFile(tempPath, manifestPath);
+}
+
+OC_PRIVATE ocResult ocBuildCookGetFileSize(const char* filePath, ocUInt64* pSize)
+{
+    FILE* pFile;
+    ocResult result = ocFOpen(filePath, "rb", &pFile);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocFSeek(pFile, 0, SEEK_END);
+    if (result == OC_SUCCESS) {
+        result = ocFTell(pFile, pSize);
+    }
+
+    ocFClose(pFile);
+    return result;
+}
+
+// Source assets are streamed through stdio rather than ocFile because there's no file system outside of the engine.
+OC_PRIVATE ocResult ocBuildCook_OnRead_FILE(void* pUserData, void* pDataOut, ocSizeT bytesToRead, ocSizeT* pBytesRead)
+{
+    ocResult result = ocFRead((FILE*)pUserData, bytesToRead, pDataOut, pBytesRead);
+    if (result != OC_SUCCESS && feof((FILE*)pUserData)) {
+        return OC_AT_END_OF_FILE;
+    }
+
+    return result;
+}
+
+OC_PRIVATE ocResult ocBuildCook_OnSeek_FILE(void* pUserData, ocInt64 bytesToSeek, ocSeekOrigin origin)
+{
+    int stdioOrigin = SEEK_CUR;
+    if (origin == ocSeekOrigin_Start) {
+        stdioOrigin = SEEK_SET;
+    } else if (origin == ocSeekOrigin_End) {
+        stdioOrigin = SEEK_END;
+    }
+
+    return ocFSeek((FILE*)pUserData, bytesToSeek, stdioOrigin);
+}
+
+OC_PRIVATE ocResult ocBuildCook_OnTell_FILE(void* pUserData, ocUInt64* pPos)
+{
+    return ocFTell((FILE*)pUserData, pPos);
+}
+
+OC_PRIVATE ocBool32 ocBuildCook_OnAtEnd_FILE(void* pUserData)
+{
+    return feof((FILE*)pUserData) != 0;
+}
+
+// Streams the source asset of an item through the converter. The stream is read twice, once for the key and again for the conversion,
+// so the source asset never needs to be in memory in it's entirety. Returns OC_SUCCESS without any data when the item can be skipped.
+OC_PRIVATE ocResult ocBuildCookItemFromFile(ocBuildCookItem* pItem, FILE* pFile, void** ppOCDData, ocSizeT* pOCDDataSize)
+{
+    ocAssert(pItem != NULL);
+    ocAssert(pFile != NULL);
+
+    *ppOCDData = NULL;
+    *pOCDDataSize = 0;
+
+    ocStreamReader reader;
+    ocResult result = ocStreamReaderInit(ocBuildCook_OnRead_FILE, ocBuildCook_OnSeek_FILE, ocBuildCook_OnTell_FILE, ocBuildCook_OnAtEnd_FILE, pFile, &reader);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    ocStreamReaderSetBufferSize(&reader, OC_RESOURCE_LOADER_READ_BUFFER_SIZE);  // <-- Not fatal if this fails.
+
+    // The key is the same one the engine uses for the derived data cache. The compression flag is included so that switching
+    // compression on or off cooks everything again.
+    ocUInt32 typeID = ocResourceTypeToOCDTypeID(pItem->type);
+    if (pItem->compress) {
+        typeID |= OC_OCD_TYPE_FLAG_COMPRESSED;
+    }
+
+    result = ocDerivedDataCacheMakeKey(&reader, typeID, ocResourceLoaderGetConverterVersion(pItem->type), &pItem->key);
+    if (result == OC_SUCCESS) {
+        result = ocStreamReaderTell(&reader, &pItem->sourceSize);   // <-- The key is calculated all the way to the end.
+    }
+
+    if (result != OC_SUCCESS) {
+        ocStreamReaderUninit(&reader);
+        return result;
+    }
+
+    if (!pItem->force && pItem->hasPreviousKey && pItem->previousKey == pItem->key) {
+        if (ocBuildCookGetFileSize(pItem->outputPath, &pItem->outputSize) == OC_SUCCESS) {
+            ocStreamReaderUninit(&reader);
+            pItem->skipped = OC_TRUE;
+            return OC_SUCCESS;
+        }
+    }
+
+    result = ocStreamReaderSeek(&reader, 0, ocSeekOrigin_Start);
+    if (result == OC_SUCCESS) {
+        result = ocConvertToOCD(pItem->sourcePath, &reader, NULL, ppOCDData, pOCDDataSize);  // <-- Items are already converted in parallel.
+    }
+
+    ocStreamReaderUninit(&reader);
+    return result;
+}
+
+OC_PRIVATE void ocBuildCookJob(void* pUserData)
+{
+    ocBuildCookItem* pItem = (ocBuildCookItem*)pUserData;
+    ocAssert(pItem != NULL);
+
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    FILE* pFile;
+    pItem->result = ocFOpen(pItem->sourcePath, "rb", &pFile);
+    if (pItem->result != OC_SUCCESS) {
+        pItem->seconds = ocTimerTick(&timer);
+        return;
+    }
+
+    void* pOCDData;
+    ocSizeT ocdDataSize;
+    pItem->result = ocBuildCookItemFromFile(pItem, pFile, &pOCDData, &ocdDataSize);
+    ocFClose(pFile);
+
+    if (pItem->skipped) {
+        pItem->seconds = ocTimerTick(&timer);
+        return;
+    }
+
+    // The compressed data is only kept if it's actually smaller. The engine loads either.
+    if (pItem->result == OC_SUCCESS && pItem->compress) {
+        void* pCompressedData;
+        ocSizeT compressedDataSize;
+        pItem->result = ocOCDCompress(pOCDData, ocdDataSize, NULL, &pCompressedData, &compressedDataSize);
+        if (pItem->result == OC_SUCCESS) {
+            if (compressedDataSize < ocdDataSize) {
+                ocFree(pOCDData);
+                pOCDData = pCompressedData;
+                ocdDataSize = compressedDataSize;
+            } else {
+                ocFree(pCompressedData);
+            }
+        } else {
+            ocFree(pOCDData);
+        }
+    }
+
+    if (pItem->result == OC_SUCCESS) {
+        pItem->result = ocOpenAndWriteFile(pItem->outputPath, pOCDData, ocdDataSize);
+        pItem->outputSize = ocdDataSize;
+        ocFree(pOCDData);
+    }
+
+    pItem->seconds = ocTimerTick(&timer);
+}
+
+OC_PRIVATE ocResult ocBuildCookAddDirectory(ocStack<ocBuildCookItem>* pItems, drfs_context* pFS, const char* rootDirectory, const char* directory, const char* outputDirectory)
+{
+    drfs_iterator iterator;
+    if (!drfs_begin(pFS, directory, &iterator)) {
+        return OC_SUCCESS;  // <-- Empty directory.
+    }
+
+    ocResult result = OC_SUCCESS;
+    do {
+        if ((iterator.info.attributes & DRFS_FILE_ATTRIBUTE_DIRECTORY) != 0) {
+            result = ocBuildCookAddDirectory(pItems, pFS, rootDirectory, iterator.info.absolutePath, outputDirectory);
+            if (result != OC_SUCCESS) {
+                break;
+            }
+
+            continue;
+        }
+
+        ocResourceType type = ocGetConvertibleResourceType(iterator.info.absolutePath);
+        if (type == ocResourceType_Unknown) {
+            continue;
+        }
+
+        char relativePath[OC_MAX_PATH];
+        ocPathToRelative(relativePath, sizeof(relativePath), iterator.info.absolutePath, rootDirectory);
+
+        char outputPath[OC_MAX_PATH];
+        ocPathAppend(outputPath, sizeof(outputPath), outputDirectory, relativePath);
+        if (ocPathAppendExtension(outputPath, sizeof(outputPath), outputPath, "ocd") == 0) {     // In-place append.
+            printf("Path too long: %s\n", iterator.info.absolutePath);
+            result = OC_PATH_TOO_LONG;
+            break;
+        }
+
+        ocBuildCookItem item;
+        ocZeroObject(&item);
+        item.sourcePath   = ocMakeString(iterator.info.absolutePath);
+        item.relativePath = ocMakeString(relativePath);
+        item.outputPath   = ocMakeString(outputPath);
+        item.type         = type;
+        if (item.sourcePath == NULL || item.relativePath == NULL || item.outputPath == NULL) {
+            ocFreeString(item.sourcePath);
+            ocFreeString(item.relativePath);
+            ocFreeString(item.outputPath);
+            result = OC_OUT_OF_MEMORY;
+            break;
+        }
+
+        result = ocStackPush(pItems, item);
+        if (result != OC_SUCCESS) {
+            break;
+        }
+    } while (drfs_next(pFS, &iterator));
+
+    drfs_end(pFS, &iterator);
+    return result;
+}
+
+OC_PRIVATE void ocBuildCookPrintReport(const ocBuildCookReport* pReport)
+{
+    ocUInt32 processedCount = pReport->convertedCount + pReport->skippedCount + pReport->failedCount;
+    printf("  %-8s %6u converted, %6u skipped, %6u failed | %10.2f MB in, %10.2f MB out | %8.3f sec (%.3f ms/asset)\n",
+        pReport->name,
+        pReport->convertedCount,
+        pReport->skippedCount,
+        pReport->failedCount,
+        pReport->sourceSize / (1024.0*1024.0),
+        pReport->outputSize / (1024.0*1024.0),
+        pReport->seconds,
+        (processedCount > 0) ? (pReport->seconds*1000 / processedCount) : 0.0);
+}
+
+ocResult ocBuildCook(int argc, char** argv)
+{
+    const char* inputDirectory  = ocCmdLineGetValue(argc, argv, "--cook");
+    const char* outputDirectory = ocCmdLineGetValue(argc, argv, "--cook-output");
+    if (inputDirectory == NULL) {
+        printf("Usage: oc_build --cook <input directory> [--cook-output <output directory>] [--cook-force] [--cook-compress] [--threads <count>]\n");
+        return OC_INVALID_ARGS;
+    }
+
+    if (outputDirectory == NULL) {
+        outputDirectory = inputDirectory;
+    }
+
+    ocBool32 force = ocCmdLineIsSet(argc, argv, "--cook-force");
+    ocBool32 compress = ocCmdLineIsSet(argc, argv, "--cook-compress");
+
+    ocUInt32 threadCount = ocGetLogicalProcessorCount();
+    const char* threadCountStr = ocCmdLineGetValue(argc, argv, "--threads");
+    if (threadCountStr != NULL) {
+        threadCount = (ocUInt32)atoi(threadCountStr);
+    }
+
+    ocString currentDirectory = ocGetCurrentDirectory();
+    char rootDirectory[OC_MAX_PATH];
+    char outputRootDirectory[OC_MAX_PATH];
+    ocBuildPackageMakeAbsolutePath(rootDirectory, sizeof(rootDirectory), inputDirectory, currentDirectory);
+    ocBuildPackageMakeAbsolutePath(outputRootDirectory, sizeof(outputRootDirectory), outputDirectory, currentDirectory);
+    ocFreeString(currentDirectory);
+
+    if (!ocIsDirectory(rootDirectory)) {
+        printf("%s is not a directory.\n", rootDirectory);
+        return OC_NOT_DIRECTORY;
+    }
+
+    char manifestPath[OC_MAX_PATH];
+    ocPathAppend(manifestPath, sizeof(manifestPath), outputRootDirectory, OC_BUILD_COOK_MANIFEST_FILE_NAME);
+
+    printf("Cooking: %s -> %s\n", rootDirectory, outputRootDirectory);
+
+    ocTimer timer;
+    ocTimerInit(&timer);
+
+    double scanTime = 0;
+    double cookTime = 0;
+
+    // Gather everything up front. Directories are created here on the main thread so the jobs don't race each other to create them.
+    ocStack<ocBuildCookItem> items;
+    ocStackInit(&items);
+
+    ocStack<ocBuildCookManifestEntry> manifest;
+    ocStackInit(&manifest);
+
+    ocResult result;
+    drfs_context fs;
+    if (drfs_init(&fs) != drfs_success) {
+        result = OC_ERROR;
+        goto done;
+    }
+
+    result = ocBuildCookAddDirectory(&items, &fs, rootDirectory, rootDirectory, outputRootDirectory);
+    drfs_uninit(&fs);
+
+    if (result != OC_SUCCESS) {
+        goto done;
+    }
+
+    if (!force) {
+        ocBuildCookLoadManifest(manifestPath, &manifest);  // <-- Not an error if this fails. Everything will just be cooked.
+    }
+
+    for (size_t iItem = 0; iItem < items.count; ++iItem) {
+        ocBuildCookItem* pItem = &items.pItems[iItem];
+        pItem->force = force;
+        pItem->compress = compress;
+
+        ocBuildCookManifestEntry key;
+        key.relativePath = pItem->relativePath;
+        ocBuildCookManifestEntry* pEntry = (ocBuildCookManifestEntry*)bsearch(&key, manifest.pItems, manifest.count, sizeof(*manifest.pItems), ocBuildCookManifestEntryCompare);
+        if (pEntry != NULL) {
+            pItem->hasPreviousKey = OC_TRUE;
+            pItem->previousKey = pEntry->key;
+        }
+
+        char outputFolder[OC_MAX_PATH];
+        ocPathRemoveFileName(outputFolder, sizeof(outputFolder), pItem->outputPath);
+        if (!ocIsDirectory(outputFolder)) {
+            result = ocCreateDirectoryRecursive(outputFolder);
+            if (result != OC_SUCCESS) {
+                printf("Failed to create directory %s.\n", outputFolder);
+                goto done;
+            }
+        }
+    }
+
+    scanTime = ocTimerTick(&timer);
+    printf("Found %u assets in %.3f sec. Cooking with %u threads...\n", (unsigned int)items.count, scanTime, threadCount);
+
+    // The main thread helps out while it waits for the jobs to complete.
+    {
+        ocJobQueue jobQueue;
+        result = ocJobQueueInit((threadCount > 0) ? threadCount-1 : 0, &jobQueue);
+        if (result != OC_SUCCESS) {
+            goto done;
+        }
+
+        ocUInt32 counter = 0;
+        for (size_t iItem = 0; iItem < items.count; ++iItem) {
+            result = ocJobQueueSubmit(&jobQueue, ocBuildCookJob, &items.pItems[iItem], &counter);
+            if (result != OC_SUCCESS) {
+                break;
+            }
+        }
+
+        ocJobQueueWaitForCounter(&jobQueue, &counter);
+        ocJobQueueUninit(&jobQueue);
+
+        if (result != OC_SUCCESS) {
+            goto done;
+        }
+    }
+
+    cookTime = ocTimerTick(&timer);
+
+    // Report.
+    {
+        ocBuildCookReport reports[2];
+        ocZeroMemory(reports, sizeof(reports));
+        reports[0].name = "Images";
+        reports[1].name = "Scenes";
+
+        ocUInt32 failedCount = 0;
+        for (size_t iItem = 0; iItem < items.count; ++iItem) {
+            ocBuildCookItem* pItem = &items.pItems[iItem];
+            ocBuildCookReport* pReport = (pItem->type == ocResourceType_Image) ? &reports[0] : &reports[1];
+
+            if (pItem->result != OC_SUCCESS) {
+                printf("Failed to cook %s (%d).\n", pItem->sourcePath, pItem->result);
+                pReport->failedCount += 1;
+                failedCount += 1;
+            } else if (pItem->skipped) {
+                pReport->skippedCount += 1;
+            } else {
+                pReport->convertedCount += 1;
+            }
+
+            pReport->sourceSize += pItem->sourceSize;
+            pReport->outputSize += pItem->outputSize;
+            pReport->seconds    += pItem->seconds;
+        }
+
+        printf("Cook report (seconds are summed across threads):\n");
+        for (size_t iReport = 0; iReport < ocCountOf(reports); ++iReport) {
+            ocBuildCookPrintReport(&reports[iReport]);
+        }
+        printf("Total: %u assets in %.3f sec (scan %.3f sec, cook %.3f sec).\n", (unsigned int)items.count, scanTime + cookTime, scanTime, cookTime);
+
+        if (failedCount > 0) {
+            result = OC_ERROR;
+        }
+    }
+
+    // The manifest is saved even if some assets failed so the ones that succeeded don't need to be cooked again.
+    if (ocBuildCookSaveManifest(manifestPath, items.pItems, items.count) != OC_SUCCESS) {
+        printf("Failed to save %s.\n", manifestPath);
+    }
+
+done:
+    for (size_t iItem = 0; iItem < items.count; ++iItem) {
+        ocFreeString(items.pItems[iItem].sourcePath);
+        ocFreeString(items.pItems[iItem].relativePath);
+        ocFreeString(items.pItems[iItem].outputPath);
+    }
+    ocStackUninit(&items);
+
+    for (size_t iEntry = 0; iEntry < manifest.count; ++iEntry) {
+        ocFreeString(manifest.pItems[iEntry].relativePath);
+    }
+    ocStackUninit(&manifest);
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Converts every source asset in a directory to OCD.
+//
+// Usage: oc_build --cook <input directory> [--cook-output <output directory>] [--cook-force] [--cook-compress] [--threads <count>]
+//
+// Each asset is written to "<relative path>.ocd" in the output directory, which defaults to the input directory so the .ocd files
+// sit next to their source assets. Assets are converted in parallel with the same converters the engine uses at run time.
+//
+// A manifest containing the content hash of the source of every output is kept in the output directory. An asset is skipped when
+// it's output exists and the manifest says it was produced from the same content with the same converter version. Use --cook-force
+// to convert everything regardless.
+//
+// Use --cook-compress to write compressed OCD files. This trades a little CPU time at load time for less disk I/O, which is worth
+// it when assets are loaded over a network or from slow media. Files that don't get any smaller are written uncompressed.
+ocResult ocBuildCook(int argc, char** argv);
\ No newline at end of file
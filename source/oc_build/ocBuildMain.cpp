@@ -58,6 +58,9 @@ struct ocBuildRenderPass
 #include "ocBuildShaders.hpp"
 #include "ocBuildPipelines.hpp"
 #include "ocBuildMaterials.hpp"
+#include "ocBuildPackage.hpp"
+#include "ocBuildCook.hpp"
+#include "ocBuildBenchmark.hpp"
 
 struct ocBuildGraphicsContext
 {
@@ -70,6 +73,9 @@ struct ocBuildGraphicsContext
 #include "ocBuildShaders.cpp"
 #include "ocBuildPipelines.cpp"
 #include "ocBuildMaterials.cpp"
+#include "ocBuildPackage.cpp"
+#include "ocBuildCook.cpp"
+#include "ocBuildBenchmark.cpp"
 
 
 
@@ -149,6 +155,19 @@ int main(int argc, char** argv)
 
     int result = 0;
 
+    // Packaging, cooking and benchmarking are separate modes which are run on their own rather than as part of the normal pre-build step.
+    if (ocCmdLineIsSet(argc, argv, "--package")) {
+        return (ocBuildPackage(argc, argv) == OC_SUCCESS) ? 0 : -1;
+    }
+
+    if (ocCmdLineIsSet(argc, argv, "--cook")) {
+        return (ocBuildCook(argc, argv) == OC_SUCCESS) ? 0 : -1;
+    }
+
+    if (ocCmdLineIsSet(argc, argv, "--benchmark")) {
+        return (ocBuildBenchmark(argc, argv) == OC_SUCCESS) ? 0 : -1;
+    }
+
     // Graphics.
     result = ocBuildGraphics(argc, argv);
     if (result != 0) {
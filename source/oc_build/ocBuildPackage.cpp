@@ -0,0 +1,181 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+#define OC_BUILD_PACKAGE_WRITE_BUFFER_SIZE  (1024*1024)
+
+// The package builder needs to be able to seek back to the start of the file so we can't use ocOpenAndWriteFile() here.
+OC_PRIVATE ocResult ocBuildPackage_OnWrite(void* pUserData, const void* pData, ocSizeT bytesToWrite, ocSizeT* pBytesWritten)
+{
+    return ocFWrite((FILE*)pUserData, bytesToWrite, pData, pBytesWritten);
+}
+
+OC_PRIVATE ocResult ocBuildPackage_OnSeek(void* pUserData, ocInt64 bytesToSeek, ocSeekOrigin origin)
+{
+    int stdioOrigin = SEEK_CUR;
+    if (origin == ocSeekOrigin_Start) {
+        stdioOrigin = SEEK_SET;
+    } else if (origin == ocSeekOrigin_End) {
+        stdioOrigin = SEEK_END;
+    }
+
+    return ocFSeek((FILE*)pUserData, bytesToSeek, stdioOrigin);
+}
+
+OC_PRIVATE ocResult ocBuildPackage_OnTell(void* pUserData, ocUInt64* pPos)
+{
+    return ocFTell((FILE*)pUserData, pPos);
+}
+
+OC_PRIVATE ocResult ocBuildPackage_OnSize(void* pUserData, ocUInt64* pSize)
+{
+    FILE* pFile = (FILE*)pUserData;
+
+    ocUInt64 pos;
+    ocResult result = ocFTell(pFile, &pos);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocFSeek(pFile, 0, SEEK_END);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    result = ocFTell(pFile, pSize);
+    ocFSeek(pFile, (ocInt64)pos, SEEK_SET);
+
+    return result;
+}
+
+OC_PRIVATE void ocBuildPackageMakeAbsolutePath(char* pathOut, size_t pathOutSize, const char* path, const char* currentDirectory)
+{
+    if (ocPathIsAbsolute(path)) {
+        ocPathClean(pathOut, pathOutSize, path);
+    } else {
+        ocPathToAbsolute(pathOut, pathOutSize, path, currentDirectory);
+    }
+
+    ocPathToForwardSlashes(pathOut);
+}
+
+OC_PRIVATE ocResult ocBuildPackageAddDirectory(ocPackageBuilder* pBuilder, drfs_context* pFS, const char* rootDirectory, const char* directory, const char* outputAbsolutePath, ocUInt32 flags)
+{
+    drfs_iterator iterator;
+    if (!drfs_begin(pFS, directory, &iterator)) {
+        return OC_SUCCESS;  // <-- Empty directory.
+    }
+
+    ocResult result = OC_SUCCESS;
+    do {
+        if ((iterator.info.attributes & DRFS_FILE_ATTRIBUTE_DIRECTORY) != 0) {
+            result = ocBuildPackageAddDirectory(pBuilder, pFS, rootDirectory, iterator.info.absolutePath, outputAbsolutePath, flags);
+            if (result != OC_SUCCESS) {
+                break;
+            }
+
+            continue;
+        }
+
+        // Don't include the package in itself, or any other packages for that matter.
+        if (ocPathEqual(iterator.info.absolutePath, outputAbsolutePath) || ocPathExtensionEqual(iterator.info.absolutePath, OC_PACKAGE_EXTENSION)) {
+            continue;
+        }
+
+        char relativePath[OC_MAX_PATH];
+        ocPathToRelative(relativePath, sizeof(relativePath), iterator.info.absolutePath, rootDirectory);
+
+        result = ocPackageBuilderAddFile(pBuilder, relativePath, iterator.info.absolutePath, iterator.info.lastModifiedTime, flags);
+        if (result != OC_SUCCESS) {
+            printf("Failed to add %s to package.\n", iterator.info.absolutePath);
+            break;
+        }
+    } while (drfs_next(pFS, &iterator));
+
+    drfs_end(pFS, &iterator);
+    return result;
+}
+
+ocResult ocBuildPackage(int argc, char** argv)
+{
+    const char* inputDirectory = ocCmdLineGetValue(argc, argv, "--package");
+    const char* outputPath     = ocCmdLineGetValue(argc, argv, "--package-output");
+    if (inputDirectory == NULL || outputPath == NULL) {
+        printf("Usage: oc_build --package <input directory> --package-output <output file> [--package-compress] [--package-alignment <bytes>]\n");
+        return OC_INVALID_ARGS;
+    }
+
+    ocUInt32 flags = 0;
+    if (ocCmdLineIsSet(argc, argv, "--package-compress")) {
+        flags |= OC_PACKAGE_ENTRY_FLAG_COMPRESSED;
+    }
+
+    ocUInt32 dataAlignment = OC_PACKAGE_DEFAULT_ALIGNMENT;
+    const char* alignmentStr = ocCmdLineGetValue(argc, argv, "--package-alignment");
+    if (alignmentStr != NULL) {
+        dataAlignment = (ocUInt32)atoi(alignmentStr);
+    }
+
+    // Everything is done in terms of absolute paths so we can compute the path of each file relative to the input directory.
+    ocString currentDirectory = ocGetCurrentDirectory();
+    char rootDirectory[OC_MAX_PATH];
+    char outputAbsolutePath[OC_MAX_PATH];
+    ocBuildPackageMakeAbsolutePath(rootDirectory, sizeof(rootDirectory), inputDirectory, currentDirectory);
+    ocBuildPackageMakeAbsolutePath(outputAbsolutePath, sizeof(outputAbsolutePath), outputPath, currentDirectory);
+    ocFreeString(currentDirectory);
+
+    if (!ocIsDirectory(rootDirectory)) {
+        printf("%s is not a directory.\n", rootDirectory);
+        return OC_NOT_DIRECTORY;
+    }
+
+    ocPackageBuilder builder;
+    ocResult result = ocPackageBuilderInit(dataAlignment, &builder);
+    if (result != OC_SUCCESS) {
+        printf("Invalid package alignment: %s\n", alignmentStr);
+        return result;
+    }
+
+    drfs_context fs;
+    if (drfs_init(&fs) != drfs_success) {
+        ocPackageBuilderUninit(&builder);
+        return OC_ERROR;
+    }
+
+    printf("Packaging: %s -> %s\n", rootDirectory, outputAbsolutePath);
+
+    result = ocBuildPackageAddDirectory(&builder, &fs, rootDirectory, rootDirectory, outputAbsolutePath, flags);
+    drfs_uninit(&fs);
+
+    if (result != OC_SUCCESS) {
+        ocPackageBuilderUninit(&builder);
+        return result;
+    }
+
+    FILE* pFile;
+    result = ocFOpen(outputAbsolutePath, "wb", &pFile);
+    if (result != OC_SUCCESS) {
+        printf("Failed to open %s for writing.\n", outputAbsolutePath);
+        ocPackageBuilderUninit(&builder);
+        return result;
+    }
+
+    ocStreamWriter writer;
+    ocStreamWriterInit(ocBuildPackage_OnWrite, ocBuildPackage_OnSeek, ocBuildPackage_OnTell, ocBuildPackage_OnSize, pFile, &writer);
+    ocStreamWriterSetBufferSize(&writer, OC_BUILD_PACKAGE_WRITE_BUFFER_SIZE);  // <-- Paths and padding are written in small pieces.
+
+    result = ocPackageBuilderRender(&builder, &writer);
+    if (result == OC_SUCCESS) {
+        result = ocStreamWriterFlush(&writer);
+    }
+
+    if (result != OC_SUCCESS) {
+        printf("Failed to write package %s.\n", outputAbsolutePath);
+    } else {
+        printf("Packaged %u files.\n", (unsigned int)builder.entries.count);
+    }
+
+    ocStreamWriterUninit(&writer);
+    ocFClose(pFile);
+    ocPackageBuilderUninit(&builder);
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+// Copyright (C) 2018 David Reid. See included LICENSE file.
+
+// Packs a directory into a package ('PAK1' OCD file).
+//
+// Usage: oc_build --package <input directory> --package-output <output file> [--package-compress] [--package-alignment <bytes>]
+//
+// Every file in the input directory, including sub-directories, is added to the package with a path relative to the input directory.
+// Returns an error if _any_ file fails to be added.
+ocResult ocBuildPackage(int argc, char** argv);
@@ -35,14 +35,79 @@ ocResult ocBuildShadersContextUninit(ocBuildShadersContext* pContext)
 #define OC_BUILD_GLSLANG_PATH  "build/oc_build/bin/glslangValidator"
 #endif
 
-#define OC_BUILD_SHADERS_INDIR_OLD "source/oc/ocEngine/Graphics/_Pipelines/Shaders"
+#define OC_BUILD_SHADERS_INDIR_OLD      "source/oc/ocEngine/Graphics/_Pipelines/Shaders"
+#define OC_BUILD_SHADER_PIPELINES_INDIR "source/oc/ocEngine/Graphics/_Pipelines"
 
-#define OC_BUILD_MCPP_CMD(infile, outdir, options, cmd) \
-    snprintf(cmd, sizeof(cmd), "%s %s/%s -o %s/%s/%s -P -k %s", OC_BUILD_MCPP_PATH, OC_BUILD_SHADERS_INDIR_OLD, infile, OC_BUILD_INTERMEDIATE_DIRECTORY, outdir, infile, options)
+#define OC_BUILD_MCPP_CMD(infile, outfile, outdir, options, cmd) \
+    snprintf(cmd, sizeof(cmd), "%s %s/%s -o %s/%s/%s -P -k %s", OC_BUILD_MCPP_PATH, OC_BUILD_SHADERS_INDIR_OLD, infile, OC_BUILD_INTERMEDIATE_DIRECTORY, outdir, outfile, options)
 
 #define OC_BUILD_GLSLANG_CMD_VULKAN(infile, outdir, options, cmd) \
     snprintf(cmd, sizeof(cmd), "%s %s \"%s/vulkan/%s\" -o \"%s/vulkan/%s.spv\"", OC_BUILD_GLSLANG_PATH, options, OC_BUILD_INTERMEDIATE_DIRECTORY, infile, OC_BUILD_INTERMEDIATE_DIRECTORY, infile)
 
+#define OC_BUILD_GLSLANG_OPTIONS_VULKAN     "-V"
+#define OC_BUILD_SHADER_PREFIX_VULKAN       "#version 450\n\n"
+
+#define OC_BUILD_SHADERS_MANIFEST_PATH      OC_BUILD_INTERMEDIATE_DIRECTORY "/vulkan/ocShaders.manifest"
+#define OC_BUILD_SHADERS_MAX_INCLUDE_DEPTH  32
+
+// The maximum number of variants a single pipeline can expand to. This is only here to catch a runaway keyword matrix.
+#define OC_BUILD_PIPELINE_MAX_VARIANTS      256
+#define OC_BUILD_PIPELINE_MAX_KEYWORDS      16
+
+// These must match the names of the ocGraphicsVertexFormat and ocGraphicsPrimitiveType enums because the generated code refers to them
+// by name.
+const char* g_ocBuildVertexFormatNames[]  = {"P3T2N3", "P3T2N3T3B3", "P3T2N3J4W4"};
+const char* g_ocBuildPrimitiveTypeNames[] = {"Point", "Line", "Triangle"};
+
+struct ocBuildShader
+{
+    char* relativePath;             // Relative to the shader directory.
+    char* variantPath;              // The path of the intermediate files, relative to the intermediate directory. Also determines the variable name.
+    char* defines;                  // Extra preprocessor options for the variant, such as "-DOC_VERTEX_FORMAT_P3T2N3". Can be an empty string.
+    ocBool32 force;
+    ocBool32 hasPreviousKeys;
+    ocUInt64 previousDependencyKey;
+    ocUInt64 previousPreprocessedKey;
+
+    // These are set by the job.
+    ocResult result;
+    ocBool32 isUpToDate;            // <-- Nothing was run because neither the shader nor anything it includes has changed.
+    ocBool32 isUnchanged;           // <-- Preprocessed, but not compiled because the preprocessed source has not changed.
+    ocUInt64 dependencyKey;         // <-- Hash of the source, every file it includes and the compiler options.
+    ocUInt64 preprocessedKey;       // <-- Hash of the preprocessed source and the compiler options.
+
+    // These are set by code generation.
+    ocUInt64 codeHash;
+    size_t codeSize;
+    const char* pAliasOf;           // <-- The variant path of an earlier shader with identical code, or NULL if the code is unique.
+};
+
+// A keyword that's enabled for a variant. The name is appended to the file name of the variant and the define is passed to the preprocessor.
+struct ocBuildShaderKeyword
+{
+    const char* name;
+    const char* define;
+};
+
+// A single entry in the generated pipeline variant table.
+struct ocBuildPipelineVariant
+{
+    char* pipelineName;
+    char* keywords;                 // <-- Space separated keywords, not including the vertex format. Empty for the base variant.
+    ocUInt32 vertexFormat;          // <-- Index into g_ocBuildVertexFormatNames.
+    ocUInt32 primitiveMask;         // <-- A bit for each supported primitive type, indexed by g_ocBuildPrimitiveTypeNames.
+    ocUInt32 warmUpMask;            // <-- A bit for each primitive type whose pipeline is created at startup. Always a subset of primitiveMask.
+    const char* vertexShaderVariantPath;    // <-- Owned by the shader.
+    const char* fragmentShaderVariantPath;  // <-- Owned by the shader.
+};
+
+struct ocBuildShaderManifestEntry
+{
+    ocUInt64 dependencyKey;
+    ocUInt64 preprocessedKey;
+    char* variantPath;
+};
+
 const char* ocBuildGetShaderStageStringFromFilePath(const char* filePath)
 {
     if (ocPathExtensionEqual(filePath, "vert")) {
@@ -67,71 +132,742 @@ const char* ocBuildGetShaderStageStringFromFilePath(const char* filePath)
     return "GENERIC";
 }
 
-ocResult ocBuildCompileShader_Vulkan(const char* filePath)
+OC_PRIVATE ocBool32 ocBuildIsShaderFile(const char* filePath)
 {
-    char cmd[4096];
-    int systemResult;
+    return strcmp(ocBuildGetShaderStageStringFromFilePath(filePath), "GENERIC") != 0;
+}
 
-    char inputFilePath[OC_MAX_PATH];
-    snprintf(inputFilePath, sizeof(inputFilePath), "%s/%s", OC_BUILD_SHADERS_INDIR_OLD, filePath);
+OC_PRIVATE void ocBuildGetShaderPreprocessorOptions_Vulkan(char* dst, size_t dstSize, const ocBuildShader* pShader)
+{
+    snprintf(dst, dstSize,
+        "-DVULKAN -D__VERSION__=%s -DSHADER_STAGE_%s %s",
+        "450",
+        ocBuildGetShaderStageStringFromFilePath(pShader->relativePath),
+        pShader->defines);
+}
 
-    char intermediateFilePath[OC_MAX_PATH];
-    snprintf(intermediateFilePath, sizeof(intermediateFilePath), "%s%s", OC_BUILD_INTERMEDIATE_DIRECTORY "/vulkan/", filePath);
+// Everything that affects the output other than the source goes into the keys so that changing a compiler option or switching
+// compilers rebuilds everything.
+OC_PRIVATE ocUInt64 ocBuildHashShaderOptions_Vulkan(const char* preprocessorOptions)
+{
+    ocUInt64 hash = OC_HASH_FNV1A64_SEED;
+    hash = ocHashFNV1a64(OC_BUILD_MCPP_PATH,                  strlen(OC_BUILD_MCPP_PATH),                  hash);
+    hash = ocHashFNV1a64(preprocessorOptions,                 strlen(preprocessorOptions),                 hash);
+    hash = ocHashFNV1a64(OC_BUILD_SHADER_PREFIX_VULKAN,       strlen(OC_BUILD_SHADER_PREFIX_VULKAN),       hash);
+    hash = ocHashFNV1a64(OC_BUILD_GLSLANG_PATH,               strlen(OC_BUILD_GLSLANG_PATH),               hash);
+    hash = ocHashFNV1a64(OC_BUILD_GLSLANG_OPTIONS_VULKAN,     strlen(OC_BUILD_GLSLANG_OPTIONS_VULKAN),     hash);
+    return hash;
+}
 
+// Hashes a file and, recursively, every file it includes. Includes are resolved relative to the including file, which is what the
+// preprocessor does for quoted includes. An include that cannot be found is hashed by name - the preprocessor will report the error.
+//
+// This is done without running the preprocessor so it's cheap enough to do for every shader on every build. It can see includes
+// that are disabled by the preprocessor, which only means a shader is preprocessed when it didn't strictly need to be.
+OC_PRIVATE ocResult ocBuildHashShaderDependencies(const char* filePath, ocUInt32 depth, ocStack<char*>* pVisited, ocUInt64* pHash)
+{
+    ocAssert(filePath != NULL);
+    ocAssert(pVisited != NULL);
+    ocAssert(pHash != NULL);
 
-    ocCreateDirectoryRecursive(OC_BUILD_INTERMEDIATE_DIRECTORY "/vulkan");
+    if (depth > OC_BUILD_SHADERS_MAX_INCLUDE_DEPTH) {
+        printf("%s: error: Includes are nested too deeply.\n", filePath);
+        return OC_ERROR;
+    }
 
-    // Preprocess.
-    char options[1024];
-    snprintf(options, sizeof(options),
-        "-DVULKAN -D__VERSION__=%s -DSHADER_STAGE_%s",
-        "450",
-        ocBuildGetShaderStageStringFromFilePath(filePath));
+    // Each file only needs to be hashed once, which also takes care of include cycles.
+    for (size_t iVisited = 0; iVisited < pVisited->count; ++iVisited) {
+        if (ocPathEqual(pVisited->pItems[iVisited], filePath)) {
+            return OC_SUCCESS;
+        }
+    }
+
+    char* visitedPath = ocMakeString(filePath);
+    if (visitedPath == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    ocResult result = ocStackPush(pVisited, visitedPath);
+    if (result != OC_SUCCESS) {
+        ocFreeString(visitedPath);
+        return result;
+    }
 
-    OC_BUILD_MCPP_CMD(filePath, "vulkan", options, cmd);
-    systemResult = ocSystem(cmd);
-    if (systemResult != 0) {
+    *pHash = ocHashFNV1a64(filePath, strlen(filePath), *pHash);
+
+    char* pText;
+    size_t textSize;
+    if (ocOpenAndReadTextFile(filePath, &pText, &textSize) != OC_SUCCESS) {
+        return OC_SUCCESS;  // <-- Missing include. The path has already been hashed.
+    }
+
+    *pHash = ocHashFNV1a64(pText, textSize, *pHash);
+
+    char directory[OC_MAX_PATH];
+    ocPathRemoveFileName(directory, sizeof(directory), filePath);
+
+    const char* pLine = pText;
+    while (pLine[0] != '\0' && result == OC_SUCCESS) {
+        const char* pRunningText = pLine;
+        while (pRunningText[0] == ' ' || pRunningText[0] == '\t') {
+            pRunningText += 1;
+        }
+
+        if (pRunningText[0] == '#') {
+            pRunningText += 1;
+            while (pRunningText[0] == ' ' || pRunningText[0] == '\t') {
+                pRunningText += 1;
+            }
+
+            if (strncmp(pRunningText, "include", 7) == 0) {
+                pRunningText += 7;
+                while (pRunningText[0] == ' ' || pRunningText[0] == '\t') {
+                    pRunningText += 1;
+                }
+
+                char closer = (pRunningText[0] == '"') ? '"' : ((pRunningText[0] == '<') ? '>' : '\0');
+                if (closer != '\0') {
+                    const char* pNameBeg = pRunningText + 1;
+                    const char* pNameEnd = pNameBeg;
+                    while (pNameEnd[0] != '\0' && pNameEnd[0] != '\n' && pNameEnd[0] != closer) {
+                        pNameEnd += 1;
+                    }
+
+                    char includeName[OC_MAX_PATH];
+                    if (pNameEnd[0] == closer && (size_t)(pNameEnd - pNameBeg) < sizeof(includeName)) {
+                        memcpy(includeName, pNameBeg, pNameEnd - pNameBeg);
+                        includeName[pNameEnd - pNameBeg] = '\0';
+
+                        char includePath[OC_MAX_PATH];
+                        if (ocPathAppendAndClean(includePath, sizeof(includePath), directory, includeName) == 0) {
+                            result = OC_PATH_TOO_LONG;
+                        } else {
+                            result = ocBuildHashShaderDependencies(includePath, depth + 1, pVisited, pHash);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Next line.
+        while (pLine[0] != '\0' && pLine[0] != '\n') {
+            pLine += 1;
+        }
+        if (pLine[0] == '\n') {
+            pLine += 1;
+        }
+    }
+
+    ocFree(pText);
+    return result;
+}
+
+OC_PRIVATE ocBool32 ocBuildShaderOutputExists(const char* filePath)
+{
+    char outputFilePath[OC_MAX_PATH];
+    snprintf(outputFilePath, sizeof(outputFilePath), "%s/vulkan/%s.spv", OC_BUILD_INTERMEDIATE_DIRECTORY, filePath);
+
+    FILE* pFile;
+    if (ocFOpen(outputFilePath, "rb", &pFile) != OC_SUCCESS) {
+        return OC_FALSE;
+    }
+
+    ocFClose(pFile);
+    return OC_TRUE;
+}
+
+OC_PRIVATE ocResult ocBuildPreprocessShader_Vulkan(const char* filePath, const char* variantPath, const char* preprocessorOptions, ocUInt64 optionsHash, ocUInt64* pPreprocessedKey)
+{
+    char cmd[4096];
+
+    char intermediateFilePath[OC_MAX_PATH];
+    snprintf(intermediateFilePath, sizeof(intermediateFilePath), "%s%s", OC_BUILD_INTERMEDIATE_DIRECTORY "/vulkan/", variantPath);
+
+    OC_BUILD_MCPP_CMD(filePath, variantPath, "vulkan", preprocessorOptions, cmd);
+    if (ocSystem(cmd) != 0) {
         return OC_FAILED_TO_COMPILE_SHADER;
     }
 
-    // Compile.
-    snprintf(options, sizeof(options), "-V");
+    ocResult result = ocBuildPrependStringToFile(intermediateFilePath, OC_BUILD_SHADER_PREFIX_VULKAN);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
 
-    char prefix[1024];
-    snprintf(prefix, sizeof(prefix),
-        "#version 450\n"
-        "\n");
+    void* pPreprocessedData;
+    size_t preprocessedDataSize;
+    result = ocOpenAndReadFile(intermediateFilePath, &pPreprocessedData, &preprocessedDataSize);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
 
-    ocBuildPrependStringToFile(intermediateFilePath, prefix);
-    OC_BUILD_GLSLANG_CMD_VULKAN(filePath, "vulkan", options, cmd);
-    systemResult = ocSystem(cmd);
-    if (systemResult != 0) {
+    *pPreprocessedKey = ocHashFNV1a64(pPreprocessedData, preprocessedDataSize, optionsHash);
+
+    ocFree(pPreprocessedData);
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocBuildCompileShader_Vulkan(const char* filePath)
+{
+    char cmd[4096];
+    OC_BUILD_GLSLANG_CMD_VULKAN(filePath, "vulkan", OC_BUILD_GLSLANG_OPTIONS_VULKAN, cmd);
+    if (ocSystem(cmd) != 0) {
         return OC_FAILED_TO_COMPILE_SHADER;
     }
 
     return OC_SUCCESS;
 }
 
-ocResult ocBuildCompileShader(const char* filePath)
+// Compiles a single shader. This is run on the job queue. The preprocessor and compiler are separate processes so each job
+// spends most of it's time waiting on them, which is what lets them run in parallel.
+OC_PRIVATE void ocBuildCompileShaderJob(void* pUserData)
 {
-    ocResult result = OC_SUCCESS;
+    ocBuildShader* pShader = (ocBuildShader*)pUserData;
+    ocAssert(pShader != NULL);
+
+    char preprocessorOptions[1024];
+    ocBuildGetShaderPreprocessorOptions_Vulkan(preprocessorOptions, sizeof(preprocessorOptions), pShader);
+
+    ocUInt64 optionsHash = ocBuildHashShaderOptions_Vulkan(preprocessorOptions);
+
+    // The first check is against the source and everything it includes, which avoids running anything at all.
+    char inputFilePath[OC_MAX_PATH];
+    snprintf(inputFilePath, sizeof(inputFilePath), "%s/%s", OC_BUILD_SHADERS_INDIR_OLD, pShader->relativePath);
+
+    ocStack<char*> visited;
+    ocStackInit(&visited);
+
+    pShader->dependencyKey = optionsHash;
+    pShader->result = ocBuildHashShaderDependencies(inputFilePath, 0, &visited, &pShader->dependencyKey);
+
+    for (size_t iVisited = 0; iVisited < visited.count; ++iVisited) {
+        ocFreeString(visited.pItems[iVisited]);
+    }
+    ocStackUninit(&visited);
+
+    if (pShader->result != OC_SUCCESS) {
+        return;
+    }
+
+    ocBool32 hasOutput = ocBuildShaderOutputExists(pShader->variantPath);
+    if (!pShader->force && pShader->hasPreviousKeys && hasOutput && pShader->previousDependencyKey == pShader->dependencyKey) {
+        pShader->preprocessedKey = pShader->previousPreprocessedKey;
+        pShader->isUpToDate = OC_TRUE;
+        return;
+    }
+
+    // The second check is against the preprocessed source. This catches changes that don't affect the output, such as an edit to
+    // an include that's not used by this shader's stage, or to a comment.
+    pShader->result = ocBuildPreprocessShader_Vulkan(pShader->relativePath, pShader->variantPath, preprocessorOptions, optionsHash, &pShader->preprocessedKey);
+    if (pShader->result != OC_SUCCESS) {
+        printf("Failed to preprocess Vulkan shader %s.\n\n", pShader->variantPath);
+        return;
+    }
 
-    printf("Compiling Shader: %s\n", filePath);
+    if (!pShader->force && pShader->hasPreviousKeys && hasOutput && pShader->previousPreprocessedKey == pShader->preprocessedKey) {
+        pShader->isUnchanged = OC_TRUE;
+        return;
+    }
+
+    printf("Compiling Shader: %s\n", pShader->variantPath);
+
+    pShader->result = ocBuildCompileShader_Vulkan(pShader->variantPath);
+    if (pShader->result != OC_SUCCESS) {
+        printf("Failed to compile Vulkan shader %s.\n\n", pShader->variantPath);
+        return;
+    }
+}
 
-    result = ocBuildCompileShader_Vulkan(filePath);
+
+OC_PRIVATE int ocBuildShaderCompare(const void* a, const void* b)
+{
+    return strcmp(((const ocBuildShader*)a)->variantPath, ((const ocBuildShader*)b)->variantPath);
+}
+
+OC_PRIVATE int ocBuildShaderManifestEntryCompare(const void* a, const void* b)
+{
+    return strcmp(((const ocBuildShaderManifestEntry*)a)->variantPath, ((const ocBuildShaderManifestEntry*)b)->variantPath);
+}
+
+// The manifest is a text file with one line per shader variant: "<16 hex digit dependency key> <16 hex digit preprocessed key> <variant path>".
+OC_PRIVATE ocResult ocBuildShadersLoadManifest(const char* manifestPath, ocStack<ocBuildShaderManifestEntry>* pEntries)
+{
+    char* pText;
+    ocResult result = ocOpenAndReadTextFile(manifestPath, &pText, NULL);
     if (result != OC_SUCCESS) {
-        printf("Failed to compile Vulkan shader %s.\n\n", filePath);
         return result;
     }
 
+    char* pLine = pText;
+    while (pLine[0] != '\0') {
+        char* pLineEnd = pLine;
+        while (pLineEnd[0] != '\0' && pLineEnd[0] != '\n' && pLineEnd[0] != '\r') {
+            pLineEnd += 1;
+        }
+
+        char* pNextLine = pLineEnd;
+        while (pNextLine[0] == '\n' || pNextLine[0] == '\r') {
+            pNextLine += 1;
+        }
+
+        pLineEnd[0] = '\0';
+
+        char* pPreprocessedKey;
+        char* pPath;
+        ocBuildShaderManifestEntry entry;
+        entry.dependencyKey   = (ocUInt64)strtoull(pLine, &pPreprocessedKey, 16);
+        entry.preprocessedKey = (ocUInt64)strtoull(pPreprocessedKey, &pPath, 16);
+        if (pPreprocessedKey != pLine && pPath != pPreprocessedKey && pPath[0] == ' ' && pPath[1] != '\0') {
+            entry.variantPath = ocMakeString(pPath + 1);
+            if (entry.variantPath != NULL) {
+                ocStackPush(pEntries, entry);
+            }
+        }
+
+        pLine = pNextLine;
+    }
+
+    ocFree(pText);
+
+    qsort(pEntries->pItems, pEntries->count, sizeof(*pEntries->pItems), ocBuildShaderManifestEntryCompare);
+    return OC_SUCCESS;
+}
+
+OC_PRIVATE ocResult ocBuildShadersSaveManifest(const char* manifestPath, ocBuildShader* pShaders, size_t shaderCount)
+{
+    // Written to a temporary file first so that a build that's interrupted doesn't leave behind a broken manifest.
+    char tempPath[OC_MAX_PATH];
+    if (ocPathAppendExtension(tempPath, sizeof(tempPath), manifestPath, "tmp") == 0) {
+        return OC_PATH_TOO_LONG;
+    }
+
+    FILE* pFile;
+    ocResult result = ocFOpen(tempPath, "wb", &pFile);
+    if (result != OC_SUCCESS) {
+        return result;
+    }
+
+    for (size_t iShader = 0; iShader < shaderCount; ++iShader) {
+        const ocBuildShader* pShader = &pShaders[iShader];
+        if (pShader->result != OC_SUCCESS) {
+            continue;   // <-- Failed shaders are left out so they're compiled again next time.
+        }
+
+        fprintf(pFile, "%016llx %016llx %s\n", (unsigned long long)pShader->dependencyKey, (unsigned long long)pShader->preprocessedKey, pShader->variantPath);
+    }
+
+    ocFClose(pFile);
+
+    return ocMoveFile(tempPath, manifestPath);
+}
+
+OC_PRIVATE ocResult ocBuildShadersAddDirectory(ocStack<char*>* pSourceFiles, drfs_context* pFS, const char* rootDirectory, const char* directory)
+{
+    drfs_iterator iterator;
+    if (!drfs_begin(pFS, directory, &iterator)) {
+        return OC_SUCCESS;  // <-- Empty directory.
+    }
+
+    ocResult result = OC_SUCCESS;
+    do {
+        if ((iterator.info.attributes & DRFS_FILE_ATTRIBUTE_DIRECTORY) != 0) {
+            result = ocBuildShadersAddDirectory(pSourceFiles, pFS, rootDirectory, iterator.info.absolutePath);
+            if (result != OC_SUCCESS) {
+                break;
+            }
+
+            continue;
+        }
+
+        // Only files with a shader stage extension are compiled. Everything else, such as the .glsl files in lib, is only ever included.
+        if (!ocBuildIsShaderFile(iterator.info.absolutePath)) {
+            continue;
+        }
+
+        char relativePath[OC_MAX_PATH];
+        ocPathToRelative(relativePath, sizeof(relativePath), iterator.info.absolutePath, rootDirectory);
+        ocPathToForwardSlashes(relativePath);
+
+        char* sourceFile = ocMakeString(relativePath);
+        if (sourceFile == NULL) {
+            result = OC_OUT_OF_MEMORY;
+            break;
+        }
+
+        result = ocStackPush(pSourceFiles, sourceFile);
+        if (result != OC_SUCCESS) {
+            ocFreeString(sourceFile);
+            break;
+        }
+    } while (drfs_next(pFS, &iterator));
+
+    drfs_end(pFS, &iterator);
     return result;
 }
 
+// Adds a variant of a shader, unless an identical variant has already been added by another pipeline. The file name of the variant is
+// the file name of the shader with the name of each keyword appended. This keeps the variants of a shader next to each other in the
+// intermediate directory and gives each one a unique variable name.
+OC_PRIVATE ocResult ocBuildShadersAddVariant(ocStack<ocBuildShader>* pShaders, const char* relativePath, const ocBuildShaderKeyword* pKeywords, ocUInt32 keywordCount, const char** ppVariantPath)
+{
+    ocAssert(pShaders != NULL);
+    ocAssert(relativePath != NULL);
+    ocAssert(ppVariantPath != NULL);
+
+    char basePath[OC_MAX_PATH];
+    ocPathRemoveExtension(basePath, sizeof(basePath), relativePath);
+
+    ocString variantPath = ocMakeString(basePath);
+    ocString defines = ocMakeString("");
+    for (ocUInt32 iKeyword = 0; iKeyword < keywordCount; ++iKeyword) {
+        variantPath = ocAppendStringf(variantPath, "_%s", pKeywords[iKeyword].name);
+        defines = ocAppendStringf(defines, "%s-D%s", (iKeyword > 0) ? " " : "", pKeywords[iKeyword].define);
+    }
+    variantPath = ocAppendStringf(variantPath, ".%s", ocPathExtension(relativePath));
+
+    if (variantPath == NULL || defines == NULL) {
+        ocFreeString(variantPath);
+        ocFreeString(defines);
+        return OC_OUT_OF_MEMORY;
+    }
+
+    for (size_t iShader = 0; iShader < pShaders->count; ++iShader) {
+        if (strcmp(pShaders->pItems[iShader].variantPath, variantPath) == 0) {
+            *ppVariantPath = pShaders->pItems[iShader].variantPath;
+            ocFreeString(variantPath);
+            ocFreeString(defines);
+            return OC_SUCCESS;
+        }
+    }
+
+    ocBuildShader shader;
+    ocZeroObject(&shader);
+    shader.relativePath = ocMakeString(relativePath);
+    shader.variantPath  = variantPath;
+    shader.defines      = defines;
+
+    ocResult result = (shader.relativePath != NULL) ? ocStackPush(pShaders, shader) : OC_OUT_OF_MEMORY;
+    if (result != OC_SUCCESS) {
+        ocFreeString(shader.relativePath);
+        ocFreeString(shader.variantPath);
+        ocFreeString(shader.defines);
+        return result;
+    }
+
+    *ppVariantPath = variantPath;   // <-- The string is owned by the shader so it remains valid when the stack grows.
+    return OC_SUCCESS;
+}
 
-ocResult ocBuildGenerateShaderCCode_Vulkan(ocBuildShadersContext* pContext, const char* filePath)
+OC_PRIVATE ocBool32 ocBuildIsValidShaderKeyword(const char* keyword)
 {
+    if ((keyword[0] >= '0' && keyword[0] <= '9')) {
+        return OC_FALSE;
+    }
+
+    for (const char* pChar = keyword; pChar[0] != '\0'; ++pChar) {
+        if (!((pChar[0] >= 'a' && pChar[0] <= 'z') || (pChar[0] >= 'A' && pChar[0] <= 'Z') || (pChar[0] >= '0' && pChar[0] <= '9') || pChar[0] == '_')) {
+            return OC_FALSE;
+        }
+    }
+
+    return OC_TRUE;
+}
+
+OC_PRIVATE ocResult ocBuildGetIndexFromNameArray(const char* pAbsolutePath, struct json_array_s* pArray, const char** ppNames, ocUInt32 nameCount, const char* pWhat, ocUInt32* pMask)
+{
+    *pMask = 0;
+
+    for (json_array_element_s* pElement = pArray->start; pElement != NULL; pElement = pElement->next) {
+        const char* pName = ocJSONGetStringFromValue(pElement->value);
+        if (pName == NULL) {
+            printf("%s: error: Expecting a string for the %s.\n", pAbsolutePath, pWhat);
+            return OC_ERROR;
+        }
+
+        ocUInt32 iName;
+        for (iName = 0; iName < nameCount; ++iName) {
+            if (strcmp(ppNames[iName], pName) == 0) {
+                break;
+            }
+        }
+
+        if (iName == nameCount) {
+            printf("%s: error: Unknown %s: %s\n", pAbsolutePath, pWhat, pName);
+            return OC_ERROR;
+        }
+
+        *pMask |= (1 << iName);
+    }
+
+    return OC_SUCCESS;
+}
+
+// Expands a pipeline into a variant for each combination of vertex format and keywords, and adds the shader variants each one needs.
+//
+// "Keywords" is an array of groups. Each group is an array of mutually exclusive keywords, one of which is enabled in each variant. An
+// empty string means none of the keywords in the group are enabled. For example, [["", "ALPHA_TEST"], ["", "FOG_LINEAR", "FOG_EXP"]]
+// expands to 6 variants for each vertex format. Keywords are for features that change the structure of a shader. Anything that can be
+// expressed as a constant should use a specialization constant instead, which does not require a separate variant.
+//
+// Primitive types are not part of the matrix. They're passed to the shaders as a specialization constant when the pipeline is created.
+//
+// "WarmUp" lists the primitive types whose pipelines are created when the engine starts. The others are created the first time they're
+// used which can cause a hitch, so list anything that's drawn in the first few frames. When omitted, every primitive type is warmed up.
+OC_PRIVATE ocResult ocBuildExpandPipeline(const char* pAbsolutePath, struct json_object_s* pObject, ocStack<char*>* pSourceFiles, ocStack<ocBuildShader>* pShaders, ocStack<ocBuildPipelineVariant>* pVariants)
+{
+    const char* pName = NULL;
+    const char* pVertexShader = NULL;
+    const char* pFragmentShader = NULL;
+    struct json_array_s* pVertexFormats = NULL;
+    struct json_array_s* pPrimitives = NULL;
+    struct json_array_s* pWarmUp = NULL;
+    struct json_array_s* pKeywordGroups = NULL;
+
+    for (json_object_element_s* pElement = pObject->start; pElement != NULL; pElement = pElement->next) {
+        if (strcmp(pElement->name->string, "Name") == 0) {
+            pName = ocJSONGetStringFromValue(pElement->value);
+        } else if (strcmp(pElement->name->string, "VertexShader") == 0) {
+            pVertexShader = ocJSONGetStringFromValue(pElement->value);
+        } else if (strcmp(pElement->name->string, "FragmentShader") == 0) {
+            pFragmentShader = ocJSONGetStringFromValue(pElement->value);
+        } else if (strcmp(pElement->name->string, "VertexFormats") == 0 || strcmp(pElement->name->string, "Primitives") == 0 || strcmp(pElement->name->string, "WarmUp") == 0 || strcmp(pElement->name->string, "Keywords") == 0) {
+            if (pElement->value->type != json_type_array) {
+                printf("%s: error: Expecting an array for %s\n", pAbsolutePath, pElement->name->string);
+                return OC_ERROR;
+            }
+
+            struct json_array_s* pArray = (struct json_array_s*)pElement->value->payload;
+            if (pElement->name->string[0] == 'V') {
+                pVertexFormats = pArray;
+            } else if (pElement->name->string[0] == 'P') {
+                pPrimitives = pArray;
+            } else if (pElement->name->string[0] == 'W') {
+                pWarmUp = pArray;
+            } else {
+                pKeywordGroups = pArray;
+            }
+        }
+
+        // Everything else, such as "SupportMSAA", is used when the pipeline is created at run time.
+    }
+
+    if (pName == NULL || pVertexShader == NULL || pFragmentShader == NULL) {
+        printf("%s: error: Pipelines require a Name, VertexShader and FragmentShader.\n", pAbsolutePath);
+        return OC_ERROR;
+    }
+
+    const char* ppShaders[2] = {pVertexShader, pFragmentShader};
+    for (int iShader = 0; iShader < 2; ++iShader) {
+        ocBool32 found = OC_FALSE;
+        for (size_t iSourceFile = 0; iSourceFile < pSourceFiles->count; ++iSourceFile) {
+            if (ocPathEqual(pSourceFiles->pItems[iSourceFile], ppShaders[iShader])) {
+                found = OC_TRUE;
+                break;
+            }
+        }
+
+        if (!found) {
+            printf("%s: error: Shader not found: %s\n", pAbsolutePath, ppShaders[iShader]);
+            return OC_ERROR;
+        }
+    }
+
+    // Pipelines that don't list their vertex formats or primitives use the ones that are used by most meshes.
+    ocUInt32 vertexFormatMask = (1 << 0);
+    if (pVertexFormats != NULL) {
+        ocResult result = ocBuildGetIndexFromNameArray(pAbsolutePath, pVertexFormats, g_ocBuildVertexFormatNames, ocCountOf(g_ocBuildVertexFormatNames), "vertex format", &vertexFormatMask);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    ocUInt32 primitiveMask = (1 << 2);
+    if (pPrimitives != NULL) {
+        ocResult result = ocBuildGetIndexFromNameArray(pAbsolutePath, pPrimitives, g_ocBuildPrimitiveTypeNames, ocCountOf(g_ocBuildPrimitiveTypeNames), "primitive type", &primitiveMask);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+    }
+
+    ocUInt32 warmUpMask = primitiveMask;
+    if (pWarmUp != NULL) {
+        ocResult result = ocBuildGetIndexFromNameArray(pAbsolutePath, pWarmUp, g_ocBuildPrimitiveTypeNames, ocCountOf(g_ocBuildPrimitiveTypeNames), "primitive type", &warmUpMask);
+        if (result != OC_SUCCESS) {
+            return result;
+        }
+
+        if ((warmUpMask & ~primitiveMask) != 0) {
+            printf("%s: error: WarmUp can only contain primitive types listed in Primitives.\n", pAbsolutePath);
+            return OC_ERROR;
+        }
+    }
+
+    struct json_array_s* pGroups[OC_BUILD_PIPELINE_MAX_KEYWORDS];
+    ocUInt32 groupCount = 0;
+    ocUInt32 variantsPerFormat = 1;
+    if (pKeywordGroups != NULL) {
+        for (json_array_element_s* pGroupElement = pKeywordGroups->start; pGroupElement != NULL; pGroupElement = pGroupElement->next) {
+            if (pGroupElement->value->type != json_type_array || ((struct json_array_s*)pGroupElement->value->payload)->length == 0) {
+                printf("%s: error: Expecting a non-empty array for each group of keywords.\n", pAbsolutePath);
+                return OC_ERROR;
+            }
+
+            struct json_array_s* pGroup = (struct json_array_s*)pGroupElement->value->payload;
+            for (json_array_element_s* pElement = pGroup->start; pElement != NULL; pElement = pElement->next) {
+                const char* pKeyword = ocJSONGetStringFromValue(pElement->value);
+                if (pKeyword == NULL || !ocBuildIsValidShaderKeyword(pKeyword)) {
+                    printf("%s: error: Keywords must be strings made up of letters, digits and underscores.\n", pAbsolutePath);
+                    return OC_ERROR;
+                }
+            }
+
+            variantsPerFormat *= (ocUInt32)pGroup->length;
+            if (groupCount == OC_BUILD_PIPELINE_MAX_KEYWORDS || variantsPerFormat > OC_BUILD_PIPELINE_MAX_VARIANTS) {
+                printf("%s: error: %s has too many keywords.\n", pAbsolutePath, pName);
+                return OC_ERROR;
+            }
+
+            pGroups[groupCount++] = pGroup;
+        }
+    }
+
+    for (ocUInt32 iFormat = 0; iFormat < ocCountOf(g_ocBuildVertexFormatNames); ++iFormat) {
+        if ((vertexFormatMask & (1 << iFormat)) == 0) {
+            continue;
+        }
+
+        char vertexFormatDefine[64];
+        snprintf(vertexFormatDefine, sizeof(vertexFormatDefine), "OC_VERTEX_FORMAT_%s", g_ocBuildVertexFormatNames[iFormat]);
+
+        for (ocUInt32 iVariant = 0; iVariant < variantsPerFormat; ++iVariant) {
+            ocBuildShaderKeyword keywords[1 + OC_BUILD_PIPELINE_MAX_KEYWORDS];
+            keywords[0].name   = g_ocBuildVertexFormatNames[iFormat];
+            keywords[0].define = vertexFormatDefine;
+            ocUInt32 keywordCount = 1;
+
+            ocBuildPipelineVariant variant;
+            ocZeroObject(&variant);
+            variant.pipelineName  = ocMakeString(pName);
+            variant.keywords      = ocMakeString("");
+            variant.vertexFormat  = iFormat;
+            variant.primitiveMask = primitiveMask;
+            variant.warmUpMask    = warmUpMask;
+
+            // The variant index is treated as a mixed radix number with a digit for each group.
+            ocUInt32 remainder = iVariant;
+            for (ocUInt32 iGroup = 0; iGroup < groupCount; ++iGroup) {
+                ocUInt32 iKeyword = remainder % (ocUInt32)pGroups[iGroup]->length;
+                remainder /= (ocUInt32)pGroups[iGroup]->length;
+
+                json_array_element_s* pElement = pGroups[iGroup]->start;
+                for (ocUInt32 i = 0; i < iKeyword; ++i) {
+                    pElement = pElement->next;
+                }
+
+                const char* pKeyword = ocJSONGetStringFromValue(pElement->value);
+                if (pKeyword[0] != '\0') {
+                    keywords[keywordCount].name   = pKeyword;
+                    keywords[keywordCount].define = pKeyword;
+                    keywordCount += 1;
+
+                    variant.keywords = ocAppendStringf(variant.keywords, "%s%s", (variant.keywords != NULL && variant.keywords[0] != '\0') ? " " : "", pKeyword);
+                }
+            }
+
+            ocResult result = OC_SUCCESS;
+            if (variant.pipelineName == NULL || variant.keywords == NULL) {
+                result = OC_OUT_OF_MEMORY;
+            }
+            if (result == OC_SUCCESS) {
+                result = ocBuildShadersAddVariant(pShaders, pVertexShader, keywords, keywordCount, &variant.vertexShaderVariantPath);
+            }
+            if (result == OC_SUCCESS) {
+                result = ocBuildShadersAddVariant(pShaders, pFragmentShader, keywords, keywordCount, &variant.fragmentShaderVariantPath);
+            }
+            if (result == OC_SUCCESS) {
+                result = ocStackPush(pVariants, variant);
+            }
+
+            if (result != OC_SUCCESS) {
+                ocFreeString(variant.pipelineName);
+                ocFreeString(variant.keywords);
+                return result;
+            }
+        }
+    }
+
+    return OC_SUCCESS;
+}
+
+// Loads every pipeline in the pipelines directory and expands them. The root element of a pipeline file can be an object or an array of objects.
+OC_PRIVATE ocResult ocBuildShadersLoadPipelines(const char* directory, ocStack<char*>* pSourceFiles, ocStack<ocBuildShader>* pShaders, ocStack<ocBuildPipelineVariant>* pVariants, ocUInt32* pPipelineCount)
+{
+    drfs_context fs;
+    if (drfs_init(&fs) != drfs_success) {
+        return OC_ERROR;
+    }
+
+    ocBool32 hasErrors = OC_FALSE;
+
+    drfs_iterator iterator;
+    if (drfs_begin(&fs, directory, &iterator)) {
+        do {
+            if ((iterator.info.attributes & DRFS_FILE_ATTRIBUTE_DIRECTORY) != 0 || !ocPathExtensionEqual(iterator.info.absolutePath, "json")) {
+                continue;
+            }
+
+            struct json_parse_result_s parseResult;
+            struct json_value_s* pJSONRoot = ocJSONLoadFile(iterator.info.absolutePath, &parseResult);
+            if (pJSONRoot == NULL) {
+                ocPrintJSONParseError(iterator.info.absolutePath, &parseResult);
+                hasErrors = OC_TRUE;
+                continue;
+            }
+
+            if (pJSONRoot->type == json_type_object) {
+                if (ocBuildExpandPipeline(iterator.info.absolutePath, (struct json_object_s*)pJSONRoot->payload, pSourceFiles, pShaders, pVariants) == OC_SUCCESS) {
+                    *pPipelineCount += 1;
+                } else {
+                    hasErrors = OC_TRUE;
+                }
+            } else if (pJSONRoot->type == json_type_array) {
+                for (json_array_element_s* pElement = ((struct json_array_s*)pJSONRoot->payload)->start; pElement != NULL; pElement = pElement->next) {
+                    if (pElement->value->type == json_type_object && ocBuildExpandPipeline(iterator.info.absolutePath, (struct json_object_s*)pElement->value->payload, pSourceFiles, pShaders, pVariants) == OC_SUCCESS) {
+                        *pPipelineCount += 1;
+                    } else {
+                        hasErrors = OC_TRUE;
+                    }
+                }
+            } else {
+                printf("%s: error: The root element in a pipeline must be an array or an object.\n", iterator.info.absolutePath);
+                hasErrors = OC_TRUE;
+            }
+
+            free(pJSONRoot);
+        } while (drfs_next(&fs, &iterator));
+    }
+    drfs_end(&fs, &iterator);
+
+    drfs_uninit(&fs);
+
+    if (hasErrors) {
+        return OC_ERROR;
+    }
+
+    return OC_SUCCESS;
+}
+
+
+// Generates the C code for a shader variant.
+//
+// Variants often compile to identical SPIR-V, such as when a keyword is only used by one stage. Each shader is compared against those
+// before it, and a duplicate is emitted as an alias of the first shader with the same code instead of as a copy.
+ocResult ocBuildGenerateShaderCCode_Vulkan(ocBuildShadersContext* pContext, ocBuildShader* pShaders, size_t shaderIndex, ocBool32* pIsDuplicate)
+{
+    ocBuildShader* pShader = &pShaders[shaderIndex];
+    *pIsDuplicate = OC_FALSE;
+
     char inputFilePath[OC_MAX_PATH];
-    snprintf(inputFilePath, sizeof(inputFilePath), "%s/vulkan/%s.spv", OC_BUILD_INTERMEDIATE_DIRECTORY, filePath);
+    snprintf(inputFilePath, sizeof(inputFilePath), "%s/vulkan/%s.spv", OC_BUILD_INTERMEDIATE_DIRECTORY, pShader->variantPath);
 
     void* pInputFileData;
     size_t inputFileSize;
@@ -140,12 +876,48 @@ ocResult ocBuildGenerateShaderCCode_Vulkan(ocBuildShadersContext* pContext, cons
         return result;
     }
 
+    pShader->codeSize = inputFileSize;
+    pShader->codeHash = ocHashFNV1a64(pInputFileData, inputFileSize);
+
     char variableName[256];
-    ocBuildGetShaderVariableNameFromFileName(variableName, sizeof(variableName), filePath);
+    ocBuildGetShaderVariableNameFromFileName(variableName, sizeof(variableName), pShader->variantPath);
+
+    for (size_t iOtherShader = 0; iOtherShader < shaderIndex; ++iOtherShader) {
+        const ocBuildShader* pOtherShader = &pShaders[iOtherShader];
+        if (pOtherShader->pAliasOf != NULL || pOtherShader->codeSize != pShader->codeSize || pOtherShader->codeHash != pShader->codeHash) {
+            continue;
+        }
+
+        // The hashes match, but the code is compared to be sure.
+        char otherFilePath[OC_MAX_PATH];
+        snprintf(otherFilePath, sizeof(otherFilePath), "%s/vulkan/%s.spv", OC_BUILD_INTERMEDIATE_DIRECTORY, pOtherShader->variantPath);
+
+        void* pOtherFileData;
+        size_t otherFileSize;
+        if (ocOpenAndReadFile(otherFilePath, &pOtherFileData, &otherFileSize) != OC_SUCCESS) {
+            continue;
+        }
+
+        ocBool32 isIdentical = (otherFileSize == inputFileSize && memcmp(pOtherFileData, pInputFileData, inputFileSize) == 0);
+        ocFree(pOtherFileData);
+
+        if (isIdentical) {
+            char otherVariableName[256];
+            ocBuildGetShaderVariableNameFromFileName(otherVariableName, sizeof(otherVariableName), pOtherShader->variantPath);
+
+            pShader->pAliasOf = pOtherShader->variantPath;
+            pContext->pOutputFileData_Vulkan = ocAppendStringf(pContext->pOutputFileData_Vulkan, "#define %s %s\n\n", variableName, otherVariableName);
+
+            *pIsDuplicate = OC_TRUE;
+            ocFree(pInputFileData);
+            return OC_SUCCESS;
+        }
+    }
 
     // For now we output the file data as a C-style string.
     char* pOutputData = ocBuildBufferToCArray((const unsigned char*)pInputFileData, inputFileSize, variableName);
     if (pOutputData == NULL) {
+        ocFree(pInputFileData);
         return OC_ERROR;
     }
 
@@ -157,72 +929,301 @@ ocResult ocBuildGenerateShaderCCode_Vulkan(ocBuildShadersContext* pContext, cons
     return OC_SUCCESS;
 }
 
-ocResult ocBuildGenerateShaderCCode(ocBuildShadersContext* pContext, const char* filePath)
+ocResult ocBuildGenerateShaderCCode(ocBuildShadersContext* pContext, ocBuildShader* pShaders, size_t shaderIndex, ocBool32* pIsDuplicate)
 {
     ocResult result = OC_SUCCESS;
 
-    result = ocBuildGenerateShaderCCode_Vulkan(pContext, filePath);
+    result = ocBuildGenerateShaderCCode_Vulkan(pContext, pShaders, shaderIndex, pIsDuplicate);
     if (result != OC_SUCCESS) {
-        printf("Failed to generate C code for Vulkan shader %s\n", filePath);
+        printf("Failed to generate C code for Vulkan shader %s\n", pShaders[shaderIndex].variantPath);
         return result;
     }
 
     return result;
 }
 
+// Converts a mask of primitive types to a C expression made up of ocGraphicsPrimitiveType bits.
+OC_PRIVATE void ocBuildGetPrimitiveMaskExpression(ocUInt32 mask, char* pExpressionOut, size_t expressionOutSize)
+{
+    pExpressionOut[0] = '\0';
+    for (ocUInt32 iPrimitive = 0; iPrimitive < ocCountOf(g_ocBuildPrimitiveTypeNames); ++iPrimitive) {
+        if ((mask & (1 << iPrimitive)) != 0) {
+            char bit[64];
+            snprintf(bit, sizeof(bit), "%s(1 << ocGraphicsPrimitiveType_%s)", (pExpressionOut[0] != '\0') ? " | " : "", g_ocBuildPrimitiveTypeNames[iPrimitive]);
+            strcat_s(pExpressionOut, expressionOutSize, bit);
+        }
+    }
+
+    if (pExpressionOut[0] == '\0') {
+        strcat_s(pExpressionOut, expressionOutSize, "0");
+    }
+}
+
+// Generates the table the engine uses to look up the shaders of a pipeline variant. See ocvkPipelineVariant.
+ocResult ocBuildGeneratePipelineVariantTable_Vulkan(ocBuildShadersContext* pContext, const ocBuildPipelineVariant* pVariants, size_t variantCount)
+{
+    ocString output = ocAppendString(pContext->pOutputFileData_Vulkan, "static const ocvkPipelineVariant g_ocPipelineVariants[] = {\n");
+
+    for (size_t iVariant = 0; iVariant < variantCount; ++iVariant) {
+        const ocBuildPipelineVariant* pVariant = &pVariants[iVariant];
+
+        char vertexVariableName[256];
+        ocBuildGetShaderVariableNameFromFileName(vertexVariableName, sizeof(vertexVariableName), pVariant->vertexShaderVariantPath);
+
+        char fragmentVariableName[256];
+        ocBuildGetShaderVariableNameFromFileName(fragmentVariableName, sizeof(fragmentVariableName), pVariant->fragmentShaderVariantPath);
+
+        char primitiveMask[256];
+        ocBuildGetPrimitiveMaskExpression(pVariant->primitiveMask, primitiveMask, sizeof(primitiveMask));
+
+        char warmUpMask[256];
+        ocBuildGetPrimitiveMaskExpression(pVariant->warmUpMask, warmUpMask, sizeof(warmUpMask));
+
+        output = ocAppendStringf(output, "    {\"%s\", \"%s\", ocGraphicsVertexFormat_%s, %s, %s, %s, sizeof(%s), %s, sizeof(%s)},\n",
+            pVariant->pipelineName,
+            pVariant->keywords,
+            g_ocBuildVertexFormatNames[pVariant->vertexFormat],
+            primitiveMask,
+            warmUpMask,
+            vertexVariableName, vertexVariableName,
+            fragmentVariableName, fragmentVariableName);
+    }
+
+    output = ocAppendString(output, "};\n\n");
+    if (output == NULL) {
+        return OC_OUT_OF_MEMORY;
+    }
+
+    pContext->pOutputFileData_Vulkan = output;
+    return OC_SUCCESS;
+}
+
 ocResult ocBuildCompileShaders(int argc, char** argv)
 {
-    (void)argc;
-    (void)argv;
+    ocBool32 force = ocCmdLineIsSet(argc, argv, "--shaders-force");
 
-    ocBool32 hasError = OC_FALSE;
-    ocResult result = OC_SUCCESS;
+    ocUInt32 threadCount = ocGetLogicalProcessorCount();
+    const char* threadCountStr = ocCmdLineGetValue(argc, argv, "--threads");
+    if (threadCountStr != NULL) {
+        threadCount = (ocUInt32)atoi(threadCountStr);
+    }
+
+    ocTimer timer;
+    ocTimerInit(&timer);
 
     ocBuildShadersContext context;
-    result = ocBuildShadersContextInit(&context);
+    ocResult result = ocBuildShadersContextInit(&context);
     if (result != OC_SUCCESS) {
         return result;
     }
 
+    ocStack<char*> sourceFiles;
+    ocStackInit(&sourceFiles);
+
+    ocStack<ocBuildShader> shaders;
+    ocStackInit(&shaders);
+
+    ocStack<ocBuildPipelineVariant> variants;
+    ocStackInit(&variants);
+
+    ocStack<ocBuildShaderManifestEntry> manifest;
+    ocStackInit(&manifest);
+
+    ocUInt32 pipelineCount = 0;
+    ocUInt32 compiledCount = 0;
+    ocUInt32 upToDateCount = 0;
+    ocUInt32 failedCount = 0;
+    ocUInt32 duplicateCount = 0;
+
+    // Shaders are discovered by their extension.
+    ocString currentDirectory = ocGetCurrentDirectory();
+    char rootDirectory[OC_MAX_PATH];
+    ocPathAppendAndClean(rootDirectory, sizeof(rootDirectory), currentDirectory, OC_BUILD_SHADERS_INDIR_OLD);
+    ocPathToForwardSlashes(rootDirectory);
+
+    char pipelinesDirectory[OC_MAX_PATH];
+    ocPathAppendAndClean(pipelinesDirectory, sizeof(pipelinesDirectory), currentDirectory, OC_BUILD_SHADER_PIPELINES_INDIR);
+    ocPathToForwardSlashes(pipelinesDirectory);
+    ocFreeString(currentDirectory);
+
+    drfs_context fs;
+    if (drfs_init(&fs) != drfs_success) {
+        result = OC_ERROR;
+        goto done;
+    }
+
+    result = ocBuildShadersAddDirectory(&sourceFiles, &fs, rootDirectory, rootDirectory);
+    drfs_uninit(&fs);
 
-    result = ocBuildCompileShader("ocShader_Default.vert");
     if (result != OC_SUCCESS) {
-        hasError = OC_TRUE;
+        goto done;
     }
 
-    result = ocBuildCompileShader("ocShader_Default.frag");
+    // Each pipeline is expanded into the shader variants it needs.
+    result = ocBuildShadersLoadPipelines(pipelinesDirectory, &sourceFiles, &shaders, &variants, &pipelineCount);
     if (result != OC_SUCCESS) {
-        hasError = OC_TRUE;
+        goto done;
     }
 
+    if (pipelineCount == 0) {
+        printf("%s: error: No pipelines found.\n", pipelinesDirectory);
+        result = OC_ERROR;
+        goto done;
+    }
 
-    if (hasError) {
-        return OC_ERROR;
+    // Shaders that aren't used by any pipeline are still compiled, without any keywords, so that errors in them are reported.
+    for (size_t iSourceFile = 0; iSourceFile < sourceFiles.count; ++iSourceFile) {
+        ocBool32 isReferenced = OC_FALSE;
+        for (size_t iShader = 0; iShader < shaders.count; ++iShader) {
+            if (strcmp(shaders.pItems[iShader].relativePath, sourceFiles.pItems[iSourceFile]) == 0) {
+                isReferenced = OC_TRUE;
+                break;
+            }
+        }
+
+        if (!isReferenced) {
+            const char* variantPath;
+            result = ocBuildShadersAddVariant(&shaders, sourceFiles.pItems[iSourceFile], NULL, 0, &variantPath);
+            if (result != OC_SUCCESS) {
+                goto done;
+            }
+        }
+    }
+
+    // Sorted so the generated code doesn't change depending on the order the file system returns files in.
+    qsort(shaders.pItems, shaders.count, sizeof(*shaders.pItems), ocBuildShaderCompare);
+
+    if (!force) {
+        ocBuildShadersLoadManifest(OC_BUILD_SHADERS_MANIFEST_PATH, &manifest);  // <-- Not an error if this fails. Everything will just be compiled.
+    }
+
+    // Directories are created here on the main thread so the jobs don't race each other to create them.
+    ocCreateDirectoryRecursive(OC_BUILD_INTERMEDIATE_DIRECTORY "/vulkan");
+
+    for (size_t iShader = 0; iShader < shaders.count; ++iShader) {
+        ocBuildShader* pShader = &shaders.pItems[iShader];
+        pShader->force = force;
+
+        ocBuildShaderManifestEntry key;
+        key.variantPath = pShader->variantPath;
+        ocBuildShaderManifestEntry* pEntry = (ocBuildShaderManifestEntry*)bsearch(&key, manifest.pItems, manifest.count, sizeof(*manifest.pItems), ocBuildShaderManifestEntryCompare);
+        if (pEntry != NULL) {
+            pShader->hasPreviousKeys = OC_TRUE;
+            pShader->previousDependencyKey = pEntry->dependencyKey;
+            pShader->previousPreprocessedKey = pEntry->preprocessedKey;
+        }
+
+        char intermediateFolder[OC_MAX_PATH];
+        snprintf(intermediateFolder, sizeof(intermediateFolder), "%s/vulkan/%s", OC_BUILD_INTERMEDIATE_DIRECTORY, pShader->variantPath);
+        ocPathRemoveFileNameInPlace(intermediateFolder);
+        if (!ocIsDirectory(intermediateFolder)) {
+            result = ocCreateDirectoryRecursive(intermediateFolder);
+            if (result != OC_SUCCESS) {
+                printf("Failed to create directory %s.\n", intermediateFolder);
+                goto done;
+            }
+        }
+    }
+
+    // Compile. The main thread helps out while it waits for the jobs to complete.
+    {
+        ocJobQueue jobQueue;
+        result = ocJobQueueInit((threadCount > 0) ? threadCount-1 : 0, &jobQueue);
+        if (result != OC_SUCCESS) {
+            goto done;
+        }
+
+        ocUInt32 counter = 0;
+        for (size_t iShader = 0; iShader < shaders.count; ++iShader) {
+            result = ocJobQueueSubmit(&jobQueue, ocBuildCompileShaderJob, &shaders.pItems[iShader], &counter);
+            if (result != OC_SUCCESS) {
+                break;
+            }
+        }
+
+        ocJobQueueWaitForCounter(&jobQueue, &counter);
+        ocJobQueueUninit(&jobQueue);
+
+        if (result != OC_SUCCESS) {
+            goto done;
+        }
+    }
+
+    for (size_t iShader = 0; iShader < shaders.count; ++iShader) {
+        const ocBuildShader* pShader = &shaders.pItems[iShader];
+        if (pShader->result != OC_SUCCESS) {
+            failedCount += 1;
+        } else if (pShader->isUpToDate || pShader->isUnchanged) {
+            upToDateCount += 1;
+        } else {
+            compiledCount += 1;
+        }
+    }
+
+    printf("Shaders: %u compiled, %u up to date, %u failed in %.3f sec with %u threads.\n", compiledCount, upToDateCount, failedCount, ocTimerTick(&timer), threadCount);
+
+    // The manifest is saved even if some shaders failed so the ones that succeeded don't need to be compiled again.
+    if (ocBuildShadersSaveManifest(OC_BUILD_SHADERS_MANIFEST_PATH, shaders.pItems, shaders.count) != OC_SUCCESS) {
+        printf("Failed to save %s.\n", OC_BUILD_SHADERS_MANIFEST_PATH);
+    }
+
+    if (failedCount > 0) {
+        result = OC_ERROR;
+        goto done;
     }
 
 
     // At this point, all shaders have been compiled and are sitting in the intermediary directory. We now need to iterate over each one and
-    // generate the appropriate C code.
-    result = ocBuildGenerateShaderCCode(&context, "ocShader_Default.vert");
-    if (result != OC_SUCCESS) {
-        return result;
+    // generate the appropriate C code. This is always done for every shader because the generated file is rebuilt from scratch each time.
+    for (size_t iShader = 0; iShader < shaders.count; ++iShader) {
+        ocBool32 isDuplicate;
+        result = ocBuildGenerateShaderCCode(&context, shaders.pItems, iShader, &isDuplicate);
+        if (result != OC_SUCCESS) {
+            goto done;
+        }
+
+        if (isDuplicate) {
+            duplicateCount += 1;
+        }
     }
 
-    result = ocBuildGenerateShaderCCode(&context, "ocShader_Default.frag");
+    result = ocBuildGeneratePipelineVariantTable_Vulkan(&context, variants.pItems, variants.count);
     if (result != OC_SUCCESS) {
-        return result;
+        goto done;
     }
 
+    printf("Pipelines: %u pipelines expanded to %u variants using %u shaders, %u of which are duplicates.\n", pipelineCount, (ocUInt32)variants.count, (ocUInt32)shaders.count, duplicateCount);
+
 
     // At this point we should have the contents of the auto-generated files in memory, so now we need to dump it to an actual file.
     result = ocBuildAppendStringToFile(OC_BUILD_INTERMEDIATE_DIRECTORY "/vulkan/ocGraphics_Vulkan_Autogen.cpp", context.pOutputFileData_Vulkan);
-    if (result != OC_SUCCESS) {
-        return result;
+
+done:
+    for (size_t iSourceFile = 0; iSourceFile < sourceFiles.count; ++iSourceFile) {
+        ocFreeString(sourceFiles.pItems[iSourceFile]);
     }
+    ocStackUninit(&sourceFiles);
 
+    for (size_t iShader = 0; iShader < shaders.count; ++iShader) {
+        ocFreeString(shaders.pItems[iShader].relativePath);
+        ocFreeString(shaders.pItems[iShader].variantPath);
+        ocFreeString(shaders.pItems[iShader].defines);
+    }
+    ocStackUninit(&shaders);
+
+    for (size_t iVariant = 0; iVariant < variants.count; ++iVariant) {
+        ocFreeString(variants.pItems[iVariant].pipelineName);
+        ocFreeString(variants.pItems[iVariant].keywords);
+    }
+    ocStackUninit(&variants);
+
+    for (size_t iEntry = 0; iEntry < manifest.count; ++iEntry) {
+        ocFreeString(manifest.pItems[iEntry].variantPath);
+    }
+    ocStackUninit(&manifest);
 
     ocBuildShadersContextUninit(&context);
-    return OC_SUCCESS;
+    return result;
 }
 
 
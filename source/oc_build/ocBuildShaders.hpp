@@ -2,10 +2,26 @@
 
 // Compiles all shaders.
 //
+// Each pipeline in the pipelines directory is expanded into a variant for each vertex format it supports and each combination of
+// it's keywords, and the shaders of each variant are compiled with OC_VERTEX_FORMAT_<format> and the keywords defined. Variants that
+// need the same shader with the same defines share it, and variants that compile to identical SPIR-V share the same code in the
+// generated file. A table of every variant, g_ocPipelineVariants, is generated for the engine to look up pipelines at run time. The
+// table includes the primitive types listed in each pipeline's "WarmUp" array, which the engine creates pipelines for at startup.
+//
+// Files in the shader directory with a shader stage extension (.vert, .frag, etc.) that are not used by any pipeline are compiled
+// without any keywords. Shaders are compiled in parallel with up to one preprocessor or compiler process per thread. Use --threads <count> to change the number of threads,
+// which defaults to the number of logical processors.
+//
+// A manifest in the intermediate directory records two keys for each shader variant. The first is a hash of the source, every file it
+// includes and the compiler options, which lets an unchanged shader be skipped without running anything. The second is a hash
+// of the preprocessed source and the compiler options, which lets the compiler be skipped when a change does not affect the
+// preprocessed output. Use --shaders-force to compile everything regardless.
+//
 // Returns an error if _any_ shader fails to compile.
 ocResult ocBuildCompileShaders(int argc, char** argv);
 
 // Retrieves the name of the variable that's used for the given file name.
 //
-// The name of the in-code variable is derived from the name of the shader's file.
+// The name of the in-code variable is derived from the name of the shader's file. For variants this is the name of the variant's
+// intermediate file, which has the name of each of it's keywords appended.
 ocResult ocBuildGetShaderVariableNameFromFileName(char* dst, size_t dstSize, const char* shaderFileName);
\ No newline at end of file